@@ -21,6 +21,7 @@ Technology is prohibited.
 
 #include "SpriteAnimation.h"
 #include <sol/sol.hpp>
+#include "LuaConfig.h"
 
 /*!****************************************************************
 \brief
@@ -272,17 +273,18 @@ void RenderAnimationControllerUI(AnimationController& controller);
 *******************************************************************/
 class LuaManagerAlpha {
 public:
-    sol::state lua; //!< Lua state for scripting
+    std::shared_ptr<sol::state> luaState; //!< Executed script, shared through LuaStateCache
+    sol::state& lua; //!< Lua state for scripting
 
     /*!****************************************************************
     \brief
-        Constructor that loads a Lua script file.
+        Constructor that loads a Lua script file. The file is only
+        executed again once it has changed on disk.
     \param luaFilePath
         Path to the Lua script file to load.
     *******************************************************************/
-    LuaManagerAlpha(const std::string& luaFilePath) {
-        lua.open_libraries(sol::lib::base);
-        lua.script_file(luaFilePath);
+    LuaManagerAlpha(const std::string& luaFilePath)
+        : luaState(LuaStateCache::GetInstance().Acquire(luaFilePath)), lua(*luaState) {
     }
 
     /*!****************************************************************
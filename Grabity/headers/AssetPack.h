@@ -0,0 +1,150 @@
+/*!****************************************************************
+\file: AssetPack.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Single-file archive of the Assets directory. The pack starts
+        with a header that points at a table of contents listing every
+        file by its path, where its bytes are, its original size and a
+        hash of its content. Entries that shrink enough are stored LZ4
+        block compressed, everything else is stored as is.
+
+        A mounted pack is memory-mapped once, so reading a stored entry
+        is a pointer into the mapping instead of an open/read/close.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "MappedFile.h"
+
+class AssetPack {
+public:
+    static constexpr uint32_t Magic = 0x4B415047; // "GPAK"
+    static constexpr uint32_t Version = 1;
+    static constexpr const char* Extension = ".pak";
+
+    /**
+     * \brief Packs every file under a directory into one archive.
+     * \param rootDirectory The directory to pack, e.g. "Assets". Entry paths keep it as a prefix.
+     * \param packPath The path of the archive to write.
+     * \return The number of files packed, or -1 if the archive could not be written.
+     */
+    static int Build(const std::string& rootDirectory, const std::string& packPath);
+
+    /**
+     * \brief Normalizes a path the way entries are stored: forward slashes, no leading "./".
+     * \param path The path to normalize.
+     * \return The normalized path.
+     */
+    static std::string NormalizePath(std::string path);
+
+    /**
+     * \brief Hashes file content.
+     * \param data The bytes to hash.
+     * \param size The number of bytes.
+     * \return The 64-bit FNV-1a hash.
+     */
+    static uint64_t HashContent(const unsigned char* data, size_t size);
+
+    /**
+     * \brief Compresses a buffer in the LZ4 block format.
+     * \param source The bytes to compress.
+     * \param size The number of bytes.
+     * \param compressed Receives the compressed block.
+     */
+    static void CompressBlock(const unsigned char* source, size_t size, std::vector<unsigned char>& compressed);
+
+    /**
+     * \brief Decompresses an LZ4 block of known original size.
+     * \param source The compressed block.
+     * \param sourceSize The size of the compressed block.
+     * \param destination Receives exactly destinationSize bytes.
+     * \param destinationSize The original size.
+     * \return True if the block was valid and decoded to exactly destinationSize bytes.
+     */
+    static bool DecompressBlock(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize);
+
+    /**
+     * \brief Memory-maps an archive and indexes its table of contents.
+     * \param packPath The path of the archive.
+     * \return True if the archive was mapped and is valid, false otherwise.
+     */
+    bool Open(const std::string& packPath);
+
+    /**
+     * \brief Unmaps the archive. Pointers returned by Find become invalid.
+     */
+    void Close();
+
+    /**
+     * \brief Checks if an archive is open.
+     * \return True if open, false otherwise.
+     */
+    bool IsOpen() const { return header != nullptr; }
+
+    /**
+     * \brief Retrieves the number of entries in the archive.
+     * \return The entry count.
+     */
+    size_t GetEntryCount() const { return header ? header->entryCount : 0; }
+
+    /**
+     * \brief Where an entry's bytes are in the mapping.
+     */
+    struct EntryView {
+        const unsigned char* data = nullptr;    // Stored bytes, compressed if storedSize != size
+        uint64_t storedSize = 0;
+        uint64_t size = 0;                      // Original size
+        uint64_t hash = 0;                      // FNV-1a of the original bytes
+    };
+
+    /**
+     * \brief Looks up an entry by path.
+     * \param path The normalized path of the file, e.g. "Assets/Textures/Player.png".
+     * \param entry Receives the entry.
+     * \return True if the archive contains the file, false otherwise.
+     */
+    bool Find(const std::string& path, EntryView& entry) const;
+
+    /**
+     * \brief Produces the original bytes of an entry, decompressing it if needed.
+     * \param entry The entry returned by Find.
+     * \param content Receives the bytes.
+     * \return True if the entry decoded and matched its hash, false otherwise.
+     */
+    static bool Extract(const EntryView& entry, std::vector<unsigned char>& content);
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t nameBytes;         // Size of the name table that follows the entries
+        uint64_t tocOffset;         // Entries, then names, at the end of the file
+        uint64_t reserved;
+    };
+
+    struct Entry {
+        uint32_t nameOffset;        // Into the name table
+        uint32_t nameLength;
+        uint64_t dataOffset;        // From the start of the file
+        uint64_t storedSize;
+        uint64_t size;
+        uint64_t hash;
+    };
+
+    static_assert(sizeof(Header) == 32, "Pack header layout changed");
+    static_assert(sizeof(Entry) == 40, "Pack entry layout changed");
+
+    MappedFile file;
+    const Header* header = nullptr;
+    const Entry* entries = nullptr;
+    const char* names = nullptr;
+    std::unordered_map<std::string_view, uint32_t> entryIndex; // Path -> entry index
+};
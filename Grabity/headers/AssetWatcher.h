@@ -0,0 +1,151 @@
+/*!****************************************************************
+\file: AssetWatcher.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Watches asset directories for added, modified and removed
+        files so the editor does not have to list them every frame.
+        On Linux the directories are watched with inotify. Elsewhere,
+        or if a watch cannot be created, the directory is listed again
+        on a timer and compared with the previous listing.
+
+        Changes are debounced: a batch is only reported once the
+        directory has been quiet for a short while, so a file that is
+        still being written by an image editor is reloaded once.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+class AssetWatcher {
+public:
+    enum class ChangeType {
+        ADDED = 0,
+        MODIFIED,
+        REMOVED
+    };
+
+    /**
+     * \brief One file that changed in a watched directory.
+     */
+    struct FileChange {
+        std::string path;   // Same form as Utilities::getAssetFiles, e.g. "Assets/Textures/Player.png"
+        ChangeType type;
+    };
+
+    using ChangeCallback = std::function<void(const std::vector<FileChange>&)>;
+
+    /**
+     * \brief Retrieves the watcher instance.
+     * \return Reference to the watcher.
+     */
+    static AssetWatcher& GetInstance();
+
+    AssetWatcher();
+
+    /**
+     * \brief Removes every watch and closes the inotify instance.
+     */
+    ~AssetWatcher();
+
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    /**
+     * \brief Starts watching the files directly inside a directory. Files without an
+     *        extension are ignored, like Utilities::getAssetFiles does.
+     * \param directory The directory to watch, e.g. "Assets/Textures/".
+     * \param callback Called from Update with each debounced batch of changes.
+     */
+    void Watch(const std::string& directory, ChangeCallback callback);
+
+    /**
+     * \brief Stops watching every directory.
+     */
+    void Clear();
+
+    /**
+     * \brief Collects pending file events and reports the batches that have settled.
+     *        Call once per frame from the main thread.
+     * \param deltaTime The time since the last call, in seconds.
+     */
+    void Update(double deltaTime);
+
+    /**
+     * \brief Sets how often directories without a native watch are listed again.
+     * \param seconds The interval in seconds.
+     */
+    void SetPollInterval(double seconds) { pollInterval = seconds; }
+
+    /**
+     * \brief Sets how long a directory has to be quiet before its changes are reported.
+     * \param seconds The delay in seconds.
+     */
+    void SetDebounce(double seconds) { debounce = seconds; }
+
+    /**
+     * \brief Sets whether directories watched from now on use native file events when available.
+     * \param enabled False to poll every directory, e.g. to test the fallback on Linux.
+     */
+    void SetNativeWatches(bool enabled) { useNative = enabled; }
+
+    /**
+     * \brief Checks if a directory is watched with native file events instead of polling.
+     * \param directory The directory passed to Watch.
+     * \return True if the directory has a native watch, false otherwise.
+     */
+    bool IsNative(const std::string& directory) const;
+
+private:
+    using FileStamp = std::pair<std::filesystem::file_time_type, uintmax_t>; // Modification time and size
+
+    struct WatchedDirectory {
+        std::string directory;
+        ChangeCallback callback;
+        std::unordered_map<std::string, FileStamp> files;       // Listing as of the last report
+        std::unordered_map<std::string, FileStamp> listing;     // Listing as of the last poll
+        std::unordered_set<std::string> pending;                // Paths seen changing, not reported yet
+        double quietTime = 0.0;                                 // Time since the last change was seen
+        int watchDescriptor = -1;                               // inotify watch, -1 when polled
+    };
+
+    /**
+     * \brief Lists the files of a directory the same way Utilities::getAssetFiles does.
+     * \param directory The directory to list.
+     * \return The files with their modification time and size.
+     */
+    static std::unordered_map<std::string, FileStamp> ListFiles(const std::string& directory);
+
+    /**
+     * \brief Lists a polled directory again and records the differences as pending changes.
+     * \param watched The directory to compare.
+     */
+    void Rescan(WatchedDirectory& watched);
+
+    /**
+     * \brief Compares the pending paths of a directory with its last listing and reports them.
+     *        A file that was created and deleted again before this point is not reported.
+     * \param watched The directory to report.
+     */
+    void Flush(WatchedDirectory& watched);
+
+    /**
+     * \brief Reads every queued inotify event without blocking.
+     */
+    void ReadNativeEvents();
+
+    std::vector<WatchedDirectory> directories;
+    int inotifyHandle = -1;
+    double pollInterval = 1.0;
+    double pollTimer = 0.0;
+    double debounce = 0.25;
+    bool useNative = true;
+};
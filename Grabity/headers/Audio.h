@@ -1,10 +1,10 @@
 /*!****************************************************************
 \file: Audio.h
 \author: Johny Yong Jun Siang, j.yong, 2301301
-\brief: Declares the Audio class for managing audio assets using the FMOD library.
+\brief: Declares the Audio class for managing audio assets through the AudioBackend.
 		Includes audio data with its type (background music,looping sound effects, or non-looping sound effects), 
-		priority for audio, andadata like name and file path. It provides functionality to access audio properties and the FMOD::Sound
-		object, allowing straightforward integration with audio systems.
+		priority for audio, andadata like name and file path. It provides functionality to access audio properties and the backend
+		sound, allowing straightforward integration with audio systems.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -12,7 +12,7 @@ without the prior written consent of DigiPen Institute of
 Technology is prohibited.
 *******************************************************************!*/
 #pragma once
-#include "fmod.hpp"
+#include "AudioBackend.h"
 #include <string>
 
 enum class AudioType {
@@ -22,10 +22,12 @@ enum class AudioType {
 };
 
 class Audio {
-	FMOD::Sound* audio;
+	AudioBackend::SoundID audio;
 	std::string name;
+	std::string path;
 	AudioType audioType;
 	int priority;
+	AudioBackend::LoadMode loadMode;
 
 public:
 	/**
@@ -34,8 +36,9 @@ public:
 	 * @param filePath The file path to the audio file.
 	 * @param type The type of the audio (e.g., music, sound effect).
 	 * @param priority The priority level of the audio (higher priority is handled first).
+	 * @param mode How the sound is held while loaded: decoded, compressed or streamed from the file.
 	 */
-	Audio(const std::string& audioName, const std::string& filePath, AudioType type, int priority);
+	Audio(const std::string& audioName, const std::string& filePath, AudioType type, int priority, AudioBackend::LoadMode mode);
 
 	/**
 	 * @brief Destructor for the Audio object. Cleans up resources if necessary.
@@ -43,10 +46,33 @@ public:
 	~Audio();
 
 	/**
-	 * @brief Retrieves the FMOD::Sound object associated with this Audio.
-	 * @return A pointer to the FMOD::Sound object.
+	 * @brief Loads the sound from its file through the backend, if it is not loaded.
+	 * @return True if the sound is loaded.
 	 */
-	FMOD::Sound* GetAudio() const;
+	bool Load();
+
+	/**
+	 * @brief Releases the backend sound. Its properties are kept so it can be loaded again.
+	 */
+	void Unload();
+
+	/**
+	 * @brief Checks if the backend sound is loaded.
+	 * @return True if the sound is loaded.
+	 */
+	bool IsLoaded() const;
+
+	/**
+	 * @brief Retrieves the file the audio is loaded from.
+	 * @return The file path.
+	 */
+	const std::string& GetFilePath() const;
+
+	/**
+	 * @brief Retrieves the backend sound associated with this Audio.
+	 * @return The sound, AudioBackend::InvalidID if it failed to load.
+	 */
+	AudioBackend::SoundID GetAudio() const;
 
 	/**
 	 * @brief Retrieves the type of the audio.
@@ -65,4 +91,18 @@ public:
 	 * @return A string containing the name of the audio.
 	 */
 	std::string GetAudioName() const;
+
+	/**
+	 * @brief Retrieves how the sound is held while loaded.
+	 * @return The load mode.
+	 */
+	AudioBackend::LoadMode GetLoadMode() const;
+
+	/**
+	 * @brief Retrieves the load mode of an audio type with none set in sounds.lua.
+	 *        Music is streamed, sound effects are decoded so they start without delay.
+	 * @param type The type of the audio.
+	 * @return The load mode.
+	 */
+	static AudioBackend::LoadMode GetDefaultLoadMode(AudioType type);
 };
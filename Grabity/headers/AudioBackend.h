@@ -0,0 +1,237 @@
+/*!****************************************************************
+\file: AudioBackend.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the AudioBackend interface the AudioManager plays
+        sounds through. Sounds and channels are plain IDs, so nothing
+        outside the backend sees FMOD. Two backends exist: FMOD for
+        the game, and a software mixer that renders to no device at
+        all or to a WAV file, for machines without FMOD and for
+        repeatable audio measurements.
+
+        The backend is picked by the optional Audio.Backend table in
+        config.lua, e.g. Audio = { Backend = { Type = "wav", Output =
+        "mix.wav" } }. Type is "fmod" (the default), "null" or "wav".
+        Builds defined with _NO_FMOD only have the software mixer.
+
+        Each sound is loaded in one of three modes: decoded to PCM in
+        memory, kept in memory in its file format and decoded as it
+        plays, or streamed from its file through the
+        StreamingBufferManager. sounds.lua picks the mode per asset.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class AudioBackend {
+public:
+    using SoundID = uint32_t;
+    using ChannelID = uint32_t;
+    static constexpr uint32_t InvalidID = 0;
+    static constexpr float LowPassOff = 20000.0f;   // Cutoff at which the low-pass filter is removed
+
+    /**
+     * @brief How a sound is held while it is loaded.
+     */
+    enum class LoadMode {
+        DECOMPRESSED = 0,   // Decoded to PCM when loaded: no decoding while playing, the most memory
+        COMPRESSED,         // Kept in its file format and decoded while playing
+        STREAMED            // Read from its file while playing, only a small buffer in memory
+    };
+
+    /**
+     * @brief The memory a sound takes.
+     */
+    struct SoundMemory {
+        size_t resident = 0;    // Bytes held for the sound in its load mode
+        size_t decoded = 0;     // Bytes it would take decoded to PCM
+    };
+
+    virtual ~AudioBackend() = default;
+
+    /**
+     * @brief Reads a load mode from its name in sounds.lua.
+     * @param name "decompressed", "compressed" or "streamed".
+     * @param fallback The mode for an empty or unknown name.
+     * @return The load mode.
+     */
+    static LoadMode ParseLoadMode(const std::string& name, LoadMode fallback);
+
+    /**
+     * @brief Retrieves the name of a load mode as written in sounds.lua.
+     * @param mode The load mode.
+     * @return The name.
+     */
+    static const char* GetLoadModeName(LoadMode mode);
+
+    /**
+     * @brief Names the format of a sound file from its first bytes, for telling why a sound did not load.
+     * @param data The start of the file.
+     * @param size The bytes available.
+     * @return "WAV", "OGG", "MP3", "FLAC" or "unknown".
+     */
+    static const char* GetFileFormatName(const void* data, size_t size);
+
+    /**
+     * @brief Creates a backend by name.
+     * @param type "fmod", "null" or "wav". Unknown names and "fmod" in a _NO_FMOD build fall back to "null".
+     * @param outputPath The WAV file the "wav" backend writes to.
+     * @return The backend, not yet initialised.
+     */
+    static std::unique_ptr<AudioBackend> Create(const std::string& type, const std::string& outputPath);
+
+    /**
+     * @brief Starts the backend.
+     * @param maxChannels The most channels that may play at once.
+     * @return True on success.
+     */
+    virtual bool Init(int maxChannels) = 0;
+
+    /**
+     * @brief Stops every channel and releases the backend. Sounds have to be released first.
+     */
+    virtual void Release() = 0;
+
+    /**
+     * @brief Advances the backend once per frame.
+     */
+    virtual void Update() = 0;
+
+    /**
+     * @brief Retrieves the backend name for logs and the editor.
+     * @return The name.
+     */
+    virtual const char* GetName() const = 0;
+
+    /**
+     * @brief Creates a sound from an encoded audio file in memory. Safe to call from worker threads.
+     * @param data The file contents, which do not have to outlive the call.
+     * @param size The size of the file in bytes.
+     * @param loop True if channels of this sound loop.
+     * @param mode DECOMPRESSED or COMPRESSED.
+     * @return The sound, or InvalidID if it could not be decoded.
+     */
+    virtual SoundID CreateSound(const void* data, size_t size, bool loop, LoadMode mode) = 0;
+
+    /**
+     * @brief Creates a sound that is streamed from its file while it plays. Safe to call from worker threads.
+     * @param path The path of the file, opened through the StreamingBufferManager.
+     * @param loop True if channels of this sound loop.
+     * @return The sound, or InvalidID if the file is missing or could not be decoded.
+     */
+    virtual SoundID CreateStream(const std::string& path, bool loop) = 0;
+
+    /**
+     * @brief Releases a sound. Channels still playing it are stopped.
+     * @param sound The sound.
+     */
+    virtual void ReleaseSound(SoundID sound) = 0;
+
+    /**
+     * @brief Retrieves the memory a sound takes in its load mode, and decoded to PCM.
+     * @param sound The sound.
+     * @return The sizes in bytes, 0 for an unknown sound.
+     */
+    virtual SoundMemory GetSoundMemory(SoundID sound) const = 0;
+
+    /**
+     * @brief Starts a channel playing a sound.
+     * @param sound The sound.
+     * @param paused True to start the channel paused.
+     * @return The channel, or InvalidID if the sound is unknown or no channel was free.
+     */
+    virtual ChannelID Play(SoundID sound, bool paused) = 0;
+
+    /**
+     * @brief Stops a channel. The ID stays invalid afterwards.
+     * @param channel The channel.
+     */
+    virtual void Stop(ChannelID channel) = 0;
+
+    /**
+     * @brief Checks if a channel is still playing, paused channels included.
+     * @param channel The channel.
+     * @return False once the channel finished, was stopped or stolen.
+     */
+    virtual bool IsPlaying(ChannelID channel) const = 0;
+
+    /**
+     * @brief Retrieves the sound a channel plays.
+     * @param channel The channel.
+     * @return The sound, or InvalidID if the channel is not playing.
+     */
+    virtual SoundID GetSound(ChannelID channel) const = 0;
+
+    virtual void SetPaused(ChannelID channel, bool paused) = 0;
+    virtual bool IsPaused(ChannelID channel) const = 0;
+    virtual void SetVolume(ChannelID channel, float volume) = 0;
+    virtual float GetVolume(ChannelID channel) const = 0;
+    virtual void SetMute(ChannelID channel, bool mute) = 0;
+
+    /**
+     * @brief Sets how important a channel is when channels run out, 0 is the most important.
+     * @param channel The channel.
+     * @param priority The priority, 0 to 256.
+     */
+    virtual void SetPriority(ChannelID channel, int priority) = 0;
+
+    virtual void SetLooping(ChannelID channel, bool loop) = 0;
+
+    /**
+     * @brief Retrieves the playback position of a channel.
+     * @param channel The channel.
+     * @return The position in milliseconds.
+     */
+    virtual unsigned int GetPosition(ChannelID channel) const = 0;
+
+    /**
+     * @brief Moves the playback position of a channel.
+     * @param channel The channel.
+     * @param milliseconds The position in milliseconds.
+     */
+    virtual void SetPosition(ChannelID channel, unsigned int milliseconds) = 0;
+
+    /**
+     * @brief Sets the cutoff of the channel's low-pass filter. LowPassOff or higher removes the filter.
+     * @param channel The channel.
+     * @param cutoff The cutoff frequency in Hz.
+     */
+    virtual void SetLowPass(ChannelID channel, float cutoff) = 0;
+
+    /**
+     * @brief Retrieves the cutoff of the channel's low-pass filter.
+     * @param channel The channel.
+     * @return The cutoff frequency in Hz, LowPassOff if there is no filter.
+     */
+    virtual float GetLowPass(ChannelID channel) const = 0;
+
+    /**
+     * @brief Ramps the channel's fade gain, applied on top of its volume, linearly from its current
+     *        value to a target. The ramp runs on the mixer's sample clock, so it takes the same time
+     *        however often the game updates.
+     * @param channel The channel.
+     * @param target The fade gain to reach, 0 to 1.
+     * @param seconds The length of the ramp, 0 to jump straight to the target.
+     * @param stopAtEnd True to stop the channel on the sample the ramp ends.
+     */
+    virtual void FadeTo(ChannelID channel, float target, float seconds, bool stopAtEnd) = 0;
+
+    /**
+     * @brief Retrieves the current fade gain of a channel.
+     * @param channel The channel.
+     * @return The fade gain, 1 for a channel that was never faded.
+     */
+    virtual float GetFade(ChannelID channel) const = 0;
+
+    /**
+     * @brief Retrieves how many channels are playing.
+     * @return The number of channels.
+     */
+    virtual int GetChannelsPlaying() const = 0;
+};
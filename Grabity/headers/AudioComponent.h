@@ -20,7 +20,7 @@ Technology is prohibited.
 
 class AudioComponent : public Component {
 private:
-    FMOD::Channel* currentChannel = nullptr; ///< The FMOD channel currently playing the audio.
+    AudioBackend::ChannelID currentChannel = AudioBackend::InvalidID; ///< The channel currently playing the audio.
     std::vector<int> audioClipIDs; ///< Stores the IDs of audio clips associated with this component.
 
 public:
@@ -1,10 +1,11 @@
 /*!****************************************************************
 \file: AudioManager.h
 \author: Johny Yong Jun Siang, j.yong, 2301301
-\brief: Declares the AudioManager class, which manages audio playbackand system initialization using the FMOD library. This class
+\brief: Declares the AudioManager class, which manages audio playbackand system initialization through an AudioBackend, FMOD by default. This class
         handles background music (BGM) and sound effects (SFX) through volume control, audio channel management, and basic audio operations
         such as play, pause, resume, and stop. It uses a singleton pattern to ensure only one audio system instance exists. The class also
-        provides functionality to list active audio channels and update audio volumes.
+        provides functionality to list active audio channels and update audio volumes. Gameplay posts play, stop, volume and fade
+        commands to a lock-free queue that Update carries out, and fades are ramped by the backend on its sample clock.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -14,30 +15,52 @@ Technology is prohibited.
 
 #pragma once
 #include <map>
-#include <fmod.hpp>
 #include <string>
 #include <vector>
+#include <chrono>
+#include <memory>
 #include "Assetmanager.h"
+#include "AudioBackend.h"
+#include "VoiceManager.h"
+#include "SpscQueue.h"
+#include "Vector2.h"
 
 //Forward declarations
 class Audio;
 
+// The backend ramps the volume itself; this only tracks when the channel is done
 struct FadeOutInfo {
-    FMOD::Channel* channel;
+    AudioBackend::ChannelID channel;
     float fadeDuration;    // Total time to fade out
-    float elapsedTime;     // Time passed since the fade started
-    float initialVolume;   // Starting volume
+    float elapsedTime;     // Real time passed since the fade started
 };
 
-struct FadeInInfo {
-    FMOD::Channel* channel;
-    float fadeDuration;    // Total time to fade in
-    float elapsedTime;     // Time passed since fade started
-    float targetVolume;    // Final volume after fade-in
+// Work posted by gameplay and carried out by the audio stage at the start of Update
+struct AudioCommand {
+    enum class Type {
+        PLAY = 0,
+        PLAY_AT,
+        STOP,
+        SET_VOLUME,
+        FADE_OUT,
+        FADE_IN
+    };
+
+    Type type = Type::PLAY;
+    int audioID = -1;
+    float volume = 0.0f;    // SET_VOLUME volume, or FADE_IN target volume
+    float duration = 0.0f;  // Fade length in seconds
+    Vector2 position;       // Where a PLAY_AT sound comes from
+};
+
+struct ManagedVoice {
+    VoiceManager::VoiceHandle voice = VoiceManager::InvalidVoice;
+    int audioID = -1;
+    float attenuation = 1.0f;   // Distance attenuation, 1 for sounds without a position
 };
 
 struct LowPassTransition {
-    FMOD::Channel* channel = nullptr;
+    AudioBackend::ChannelID channel = AudioBackend::InvalidID;
     float startFrequency = 0.f;
     float targetFrequency = 0.f;
     float elapsed = 0.f;
@@ -45,12 +68,19 @@ struct LowPassTransition {
     bool active = false;
 };
 
+// Memory held by the loaded sounds in their load modes, against all of them decoded to PCM
+struct AudioMemoryReport {
+    int sounds[3] = { 0, 0, 0 };    // Sounds per AudioBackend::LoadMode
+    size_t residentBytes = 0;       // Held by the sounds as loaded
+    size_t decodedBytes = 0;        // Would be held with every sound decoded
+    size_t streamBufferBytes = 0;   // Read buffers of the StreamingBufferManager
+};
+
 
 class AudioManager {
-    FMOD::System* audioSystem;
+    std::unique_ptr<AudioBackend> backend;
     
-    std::map<int, std::vector<FMOD::Channel*>> audioChannels;
-    std::vector<FadeInInfo> fadingInChannels;
+    std::map<int, std::vector<AudioBackend::ChannelID>> audioChannels;
 
 
     float bgmVolume;
@@ -69,10 +99,70 @@ class AudioManager {
     int queuedBGM = -1;
     float queuedBGMDelay = 0.0f;
 
+    VoiceManager voiceManager;
+    std::map<AudioBackend::ChannelID, ManagedVoice> managedVoices;   // SFX channels admitted by the voice manager
+    std::chrono::steady_clock::time_point lastUpdate;
+    Vector2 listenerPosition;
+    float rolloffMinDistance = 800.0f;      // Full volume up to this distance from the listener
+    float rolloffMaxDistance = 2400.0f;     // Silent, and so virtual, from this distance on
+
+    /**
+     * @brief Asks the voice manager for a voice and stops the voices it steals for it.
+     * @param audioID The ID of the SFX to play.
+     * @param audio The SFX to play.
+     * @param attenuation Distance attenuation of the new voice.
+     * @param voiceOut Receives the admitted voice.
+     * @return True if the SFX may play, false if it was suppressed or rejected.
+     */
+    bool AdmitVoice(int audioID, const Audio* audio, float attenuation, VoiceManager::VoiceHandle& voiceOut);
+
+    /**
+     * @brief Remembers which voice a newly started SFX channel belongs to.
+     * @param channel The channel that was started.
+     * @param voice The voice admitted for it.
+     * @param audioID The ID of the SFX.
+     * @param attenuation Distance attenuation of the voice.
+     */
+    void TrackVoice(AudioBackend::ChannelID channel, VoiceManager::VoiceHandle voice, int audioID, float attenuation);
+
+    /**
+     * @brief Retrieves the final volume of an SFX channel from the SFX volume, its raw volume and its attenuation.
+     * @param channel The channel.
+     * @param audioID The ID of the SFX.
+     * @return The volume to set on the channel.
+     */
+    float GetSFXChannelVolume(AudioBackend::ChannelID channel, int audioID);
+
+    /**
+     * @brief Advances the voice clock and mutes or unmutes channels that became virtual or real.
+     * @param deltaTime The real time since the last update, in seconds.
+     */
+    void UpdateVoices(float deltaTime);
+
+    SpscQueue<AudioCommand, 256> commands;    // Posted by the game thread, drained by Update
+    uint64_t droppedCommands = 0;
+
+    /**
+     * @brief Queues a command for the next Update, dropping it if the queue is full.
+     * @param command The command.
+     */
+    void Post(const AudioCommand& command);
+
+    /**
+     * @brief Carries out every queued command in the order it was posted.
+     */
+    void ProcessCommands();
+
+    /**
+     * @brief Retrieves the channels playing an audio ID, the BGM channel included.
+     * @param audioID The ID of the audio.
+     * @return The channels.
+     */
+    std::vector<AudioBackend::ChannelID> GetChannels(int audioID) const;
+
 public:
-    FMOD::Channel* bgmChannel;
+    AudioBackend::ChannelID bgmChannel;
     std::vector<FadeOutInfo> fadingOutChannels;
-    FMOD::DSP* lowPassDSP = nullptr;
     LowPassTransition lpTransition;
     std::map<int, float> sfxRawVolumes; // Raw volume set per audioID
     float bgmRawOverride = -1.0f;  // -1 means no override
@@ -96,7 +186,7 @@ public:
     void operator=(AudioManager const&) = delete;
 
     /**
-     * @brief Initializes the FMOD audio system with a specified maximum number of channels.
+     * @brief Initializes the audio backend named in config.lua, FMOD by default, with a specified maximum number of channels.
      * @param maxChannels The maximum number of audio channels the system can handle (default is 100).
      */
     void InitSystem(int maxChannels = 100);
@@ -107,10 +197,10 @@ public:
     void ReleaseSystem();
     
     /**
-     * @brief Retrieves the FMOD audio system.
-     * @return A pointer to the FMOD::System object.
+     * @brief Retrieves the audio backend that sounds and channels are played through.
+     * @return A reference to the backend.
      */
-    FMOD::System* GetSystem() const;
+    AudioBackend& GetBackend() const;
 
     /**
      * @brief Retrieves the map of all audio objects currently loaded in the system.
@@ -130,6 +220,12 @@ public:
      */
     float GetSFXVolume() const { return sfxVolume; };
 
+    /**
+     * @brief Retrieves the master volume that scales BGM and SFX.
+     * @return The master volume.
+     */
+    float GetMasterVolume() const { return masterVolume; }
+
     void SetMasterVolume(float vol);
 
     /**
@@ -162,7 +258,7 @@ public:
      * @param audioID The ID of the audio to play.
      * @param channelOut A pointer to a channel that will store the audio playback channel.
      */
-    void PlayAudio(int audioID, FMOD::Channel** channelOut);
+    void PlayAudio(int audioID, AudioBackend::ChannelID* channelOut);
 
     /**
      * @brief Plays an audio based on the given audio ID.
@@ -172,6 +268,92 @@ public:
 
     void PlayAudioImmediately(int audioID);
 
+    /**
+     * @brief Plays an SFX at a position in the world. It gets quieter away from the listener and
+     *        becomes virtual when out of range.
+     * @param audioID The ID of the SFX to play.
+     * @param position Where the sound comes from.
+     */
+    void PlayAudioAt(int audioID, const Vector2& position);
+
+    /**
+     * @brief Sets where positional SFX are heard from, usually the player.
+     * @param position The listener position.
+     */
+    void SetListenerPosition(const Vector2& position) { listenerPosition = position; }
+
+    /**
+     * @brief Sets the maximum instances, steal policy and retrigger cooldown of one SFX.
+     * @param audioID The ID of the SFX.
+     * @param limits The limits.
+     */
+    void SetVoiceLimits(int audioID, const VoiceManager::Limits& limits) { voiceManager.SetLimits(audioID, limits); }
+
+    /**
+     * @brief Retrieves the voice counters for the editor.
+     * @return The voice statistics.
+     */
+    VoiceManager::Stats GetVoiceStats() const { return voiceManager.GetStats(); }
+
+    /**
+     * @brief Clears the voice counters.
+     */
+    void ResetVoiceStats() { voiceManager.ResetStats(); }
+
+    /**
+     * @brief Queues an audio to play on the next Update. Unlike PlayAudio, it never touches the backend,
+     *        so gameplay can call it freely; commands run in the order they were posted.
+     * @param audioID The ID of the audio to play.
+     */
+    void PostPlay(int audioID);
+
+    /**
+     * @brief Queues an SFX to play at a position in the world on the next Update.
+     * @param audioID The ID of the SFX to play.
+     * @param position Where the sound comes from.
+     */
+    void PostPlayAt(int audioID, const Vector2& position);
+
+    /**
+     * @brief Queues stopping an audio on the next Update.
+     * @param audioID The ID of the audio to stop.
+     */
+    void PostStop(int audioID);
+
+    /**
+     * @brief Queues setting the volume of an audio on the next Update.
+     * @param audioID The ID of the audio.
+     * @param volume The desired volume level.
+     */
+    void PostChannelVolume(int audioID, float volume);
+
+    /**
+     * @brief Queues fading out and stopping every channel of an audio on the next Update.
+     * @param audioID The ID of the audio.
+     * @param duration The duration (in seconds) of the fade.
+     */
+    void PostFadeOut(int audioID, float duration);
+
+    /**
+     * @brief Queues fading in every channel of an audio on the next Update.
+     * @param audioID The ID of the audio.
+     * @param duration The duration (in seconds) of the fade.
+     * @param targetVolume The volume reached at the end of the fade.
+     */
+    void PostFadeIn(int audioID, float duration, float targetVolume);
+
+    /**
+     * @brief Retrieves how many posted commands were dropped because the queue was full.
+     * @return The number of dropped commands.
+     */
+    uint64_t GetDroppedCommands() const { return droppedCommands; }
+
+    /**
+     * @brief Adds up the memory the loaded sounds take, for the editor and the startup log.
+     * @return The report.
+     */
+    AudioMemoryReport GetMemoryReport() const;
+
     /**
      * @brief Resumes the audio playback for a specific audio ID.
      * @param audioID The ID of the audio to resume.
@@ -197,7 +379,8 @@ public:
     void ResumeAllAudio();
 
     /**
-     * @brief Updates the audio system, including volume adjustments and channel management.
+     * @brief Updates the audio system: carries out posted commands, then advances fades and filter
+     *        transitions by the real time since the last update, so they last as long at any frame rate.
      */
     void Update();
     /**
@@ -207,14 +390,21 @@ public:
      */
     bool IsPlaying(int audioID);
 
+    /**
+     * @brief Counts the channels playing an audio ID, the BGM channel included.
+     * @param audioID The ID of the audio.
+     * @return The number of channels playing it; the sound cannot be released while it is above zero.
+     */
+    int GetPlayingChannelCount(int audioID) const;
+
     //M5
     /**
      * @brief Gradually fades out the volume of the specified audio channel over a given duration.
-     *        Once the fade-out is complete, the audio will be stopped.
-     * @param channel A pointer to the FMOD audio channel to fade out.
+     *        The backend ramps the volume sample by sample and stops the audio when the fade ends.
+     * @param channel The audio channel to fade out.
      * @param duration The duration (in seconds) over which the fade-out occurs.
      */
-    void FadeOutAudio(FMOD::Channel* channel, float duration);
+    void FadeOutAudio(AudioBackend::ChannelID channel, float duration);
     /**
      * @brief Cleans up audio channels that are no longer in use, removing inactive or stopped channels.
      *        This helps optimize performance by releasing unused resources.
@@ -222,12 +412,12 @@ public:
     void CleanUpChannels();
     /**
      * @brief Gradually fades in the volume of the specified audio channel over a given duration.
-     *        The volume starts from zero and reaches the specified target volume.
-     * @param channel A pointer to the FMOD audio channel to fade in.
+     *        The volume starts from zero and reaches the specified target volume, ramped sample by sample.
+     * @param channel The audio channel to fade in.
      * @param duration The duration (in seconds) over which the fade-in occurs.
      * @param targetVolume The final volume level to reach after the fade-in is complete.
      */
-    void FadeInAudio(FMOD::Channel* channel, float duration, float targetVolume);
+    void FadeInAudio(AudioBackend::ChannelID channel, float duration, float targetVolume);
     /**
      * @brief Sets the volume of a specific audio channel associated with the given audio ID.
      * @param audioID The ID of the audio whose volume is to be adjusted.
@@ -237,24 +427,24 @@ public:
 
     /**
      * @brief Applies a smooth low-pass filter to the specified audio channel over a given duration.
-     * @param channel The FMOD channel to which the low-pass filter will be applied.
+     * @param channel The channel to which the low-pass filter will be applied.
      * @param targetFrequency The target cutoff frequency (in Hz) for the low-pass filter.
      * @param duration The duration (in seconds) over which the low-pass filter will be applied smoothly.
      */
-    void ApplyLowPassFilterSmooth(FMOD::Channel* channel, float targetFrequency, float duration);
+    void ApplyLowPassFilterSmooth(AudioBackend::ChannelID channel, float targetFrequency, float duration);
 
     /**
      * @brief Immediately removes the low-pass filter from the specified audio channel.
-     * @param channel The FMOD channel from which the low-pass filter will be removed.
+     * @param channel The channel from which the low-pass filter will be removed.
      */
-    void RemoveLowPassFilter(FMOD::Channel* channel);
+    void RemoveLowPassFilter(AudioBackend::ChannelID channel);
 
     /**
      * @brief Smoothly removes the low-pass filter from the specified audio channel over a given duration.
-     * @param channel The FMOD channel from which the low-pass filter will be removed.
+     * @param channel The channel from which the low-pass filter will be removed.
      * @param duration The duration (in seconds) over which the low-pass filter will be smoothly removed.
      */
-    void RemoveLowPassFilterSmooth(FMOD::Channel* channel, float duration);
+    void RemoveLowPassFilterSmooth(AudioBackend::ChannelID channel, float duration);
     /**
      * @brief Stops all audio
      */
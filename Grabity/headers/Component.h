@@ -45,7 +45,9 @@ enum TypeOfComponent {
     //WIP
     SPLITTING,
     VIDEO,
-    VFX_FOLLOW
+    VFX_FOLLOW,
+
+    COMPONENT_COUNT // Number of component types, keep last
 };
 
 class Component {
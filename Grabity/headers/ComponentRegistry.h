@@ -0,0 +1,119 @@
+/*!****************************************************************
+\file: ComponentRegistry.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Table-driven registry of the components that can be loaded
+        from Lua. Each component registers the name of its Lua
+        sub-table, a create function (construct, Deserialize and add to
+        the object) and an optional reset function used by
+        RestartScene. Loading an object only visits the sub-tables the
+        object actually has, instead of probing every component type.
+        The built-in components are registered in BuiltInComponents.cpp.
+
+        Saving still goes through the virtual Component::Serialize.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "Component.h"
+
+class GameObject;
+
+class ComponentRegistry {
+public:
+    /**
+     * \brief Loads a component of an object from its Lua table.
+     * \param object The object being loaded.
+     * \param luaFilePath The path of the Lua file.
+     * \param tableName The object's table in the Lua file.
+     */
+    using LoadFunction = std::function<void(GameObject* object, const std::string& luaFilePath, const std::string& tableName)>;
+
+    struct Entry {
+        std::string tableName;  // Sub-table name in the object's Lua table, e.g. "Transform"
+        TypeOfComponent type;
+        LoadFunction create;    // Constructs, deserializes and adds the component
+        LoadFunction reset;     // Restores an existing component on restart, may be empty
+    };
+
+    /**
+     * \brief Retrieves the registry, registering the built-in components on first use.
+     * \return Reference to the registry.
+     */
+    static ComponentRegistry& GetInstance();
+
+    ComponentRegistry(const ComponentRegistry&) = delete;
+    ComponentRegistry& operator=(const ComponentRegistry&) = delete;
+
+    /**
+     * \brief Registers a component type. Components are created in registration order, so a
+     *        component must be registered after the components its constructor looks up.
+     * \param tableName The name of the component's Lua sub-table.
+     * \param type The component type.
+     * \param create Constructs, deserializes and adds the component.
+     * \param reset Restores an existing component on restart, may be empty.
+     */
+    void Register(const std::string& tableName, TypeOfComponent type, LoadFunction create, LoadFunction reset = nullptr);
+
+    /**
+     * \brief Finds a component by its Lua sub-table name.
+     * \param tableName The sub-table name.
+     * \return The entry, or nullptr if no component uses the table.
+     */
+    const Entry* Find(const std::string& tableName) const;
+
+    /**
+     * \brief Finds a component by its type.
+     * \param type The component type.
+     * \return The entry, or nullptr if the type cannot be loaded from Lua.
+     */
+    const Entry* Find(TypeOfComponent type) const;
+
+    /**
+     * \brief Maps the sub-tables of an object to components, in registration order.
+     *        Tables that are not component tables (e.g. "Name") are skipped.
+     * \param tableNames The sub-tables present in the object's Lua table.
+     * \return The entries of the components to load.
+     */
+    std::vector<const Entry*> GetEntriesFor(const std::vector<std::string>& tableNames) const;
+
+    /**
+     * \brief Retrieves every registered component.
+     * \return The entries in registration order.
+     */
+    const std::vector<Entry>& GetEntries() const { return entries; }
+
+    /**
+     * \brief Whether a component type is saved to and loaded from Lua.
+     * \param type The component type.
+     * \return False for the components that are only created at runtime.
+     */
+    static bool IsSavedToLua(TypeOfComponent type);
+
+    /**
+     * \brief Checks that every component type saved to Lua loads back through the registry:
+     *        Find(type) gives an entry whose table name finds the same entry.
+     * \return The types that do not round-trip, empty when the registry is complete.
+     */
+    std::vector<TypeOfComponent> GetUnregisteredTypes() const;
+
+private:
+    /**
+     * \brief Creates the registry and registers the built-in components.
+     */
+    ComponentRegistry();
+
+    /**
+     * \brief Registers every component the engine ships with. Defined in BuiltInComponents.cpp.
+     */
+    void RegisterBuiltInComponents();
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, size_t> tableLookup; // Sub-table name -> index in entries
+};
@@ -0,0 +1,371 @@
+/*!****************************************************************
+\file: CookedScene.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Binary cooked form of Lua scene and prefab files. The baker
+        executes a Lua file once and flattens its object tables into a
+        versioned binary image (string table, object records, table
+        records and typed fields). The loader memory-maps that image and
+        answers LuaManager reads from it without a Lua state.
+
+        Lua stays the authoring format. A cooked file is only used while
+        it is newer than its Lua source.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <type_traits>
+#include <cstdint>
+#include "MappedFile.h"
+
+class CookedScene {
+public:
+    static constexpr uint32_t Magic = 0x4E435347; // "GSCN"
+    static constexpr uint32_t Version = 1;
+    static constexpr const char* Extension = ".cooked";
+
+    enum class FieldType : uint32_t {
+        NUMBER = 0,
+        STRING,
+        BOOLEAN
+    };
+
+    /**
+     * \brief Builds the path of the cooked file that belongs to a Lua file.
+     * \param luaFilePath The path to the Lua file.
+     * \return The Lua path with its extension replaced by ".cooked".
+     */
+    static std::string GetCookedPath(const std::string& luaFilePath);
+
+    /**
+     * \brief Checks if a Lua file has a cooked file that is at least as new as the source.
+     * \param luaFilePath The path to the Lua file.
+     * \return True if the cooked file can be used instead of the Lua file.
+     */
+    static bool IsUpToDate(const std::string& luaFilePath);
+
+    /**
+     * \brief Executes a Lua file and writes its object tables as a cooked file.
+     *        Only two levels are flattened (object.field and object.table.field),
+     *        which is every shape LuaManager reads. Deeper tables are skipped.
+     * \param luaFilePath The path to the Lua source file.
+     * \param cookedFilePath The path of the cooked file to write.
+     * \return True if the file was baked, false otherwise.
+     */
+    static bool Bake(const std::string& luaFilePath, const std::string& cookedFilePath);
+
+    /**
+     * \brief Executes a Lua file in a private state and lays out its object tables as a cooked image.
+     *        Safe to call from any thread.
+     * \param luaFilePath The path to the Lua source file.
+     * \return The image, or std::nullopt if the file could not be executed.
+     */
+    static std::optional<std::vector<unsigned char>> BakeImage(const std::string& luaFilePath);
+
+    /**
+     * \brief Bakes every Lua file in a directory next to its source.
+     * \param directory The directory containing Lua scenes or prefabs.
+     * \return The number of files baked.
+     */
+    static int BakeDirectory(const std::string& directory);
+
+    /**
+     * \brief Collects object tables and lays them out as a cooked image in memory.
+     *        Bake feeds it from an executed Lua file, world snapshots from a LuaSceneWriter.
+     */
+    class Builder;
+
+    /**
+     * \brief Extracts the id from an object table name the same way
+     *        LuaManager::extractNamesWithParentIDs does.
+     * \param objectTable The name of the object table, e.g. "Player_3".
+     * \return The id, or -1 if the name has no numeric suffix.
+     */
+    static int ParseObjectID(const std::string& objectTable);
+
+    /**
+     * \brief Memory-maps a cooked file and indexes its object records.
+     * \param cookedFilePath The path of the cooked file.
+     * \return True if the file was mapped and has a valid header, false otherwise.
+     */
+    bool Load(const std::string& cookedFilePath);
+
+    /**
+     * \brief Takes ownership of a cooked image built in memory and indexes its object records.
+     * \param image The bytes produced by Builder::Finish.
+     * \return True if the image has a valid header, false otherwise.
+     */
+    bool LoadFromMemory(std::vector<unsigned char> image);
+
+    /**
+     * \brief Retrieves the size of the loaded image.
+     * \return The size in bytes, 0 if nothing is loaded.
+     */
+    size_t GetSizeBytes() const { return header ? (file.IsOpen() ? file.GetSize() : memory.size()) : 0; }
+
+    /**
+     * \brief Retrieves the number of object tables in the file.
+     * \return The object count.
+     */
+    size_t GetObjectCount() const { return header ? header->objectCount : 0; }
+
+    /**
+     * \brief Retrieves the Lua global name of an object table.
+     * \param index The object index.
+     * \return The table name, e.g. "Player_3".
+     */
+    std::string_view GetObjectTableName(size_t index) const { return GetString(objects[index].name); }
+
+    /**
+     * \brief Retrieves the id encoded in an object table name.
+     * \param index The object index.
+     * \return The id, or -1 if the name has no numeric suffix.
+     */
+    int GetObjectID(size_t index) const { return objects[index].id; }
+
+    /**
+     * \brief Retrieves the parent id stored in an object's Name table.
+     * \param index The object index.
+     * \return The parent id, or -1 if the object has no parent.
+     */
+    int GetParentID(size_t index) const { return objects[index].parentID; }
+
+    /**
+     * \brief Checks if an object table contains a sub-table.
+     * \param objectTable The name of the object table.
+     * \param subTable The name of the sub-table to check.
+     * \return True if the sub-table exists, false otherwise.
+     */
+    bool HasTable(const std::string& objectTable, const std::string& subTable) const;
+
+    /**
+     * \brief Lists the sub-tables of an object table.
+     * \param objectTable The name of the object table.
+     * \return The sub-table names, in file order. Empty if the object does not exist.
+     */
+    std::vector<std::string> GetTableNames(const std::string& objectTable) const;
+
+    /**
+     * \brief Collects the string values of every field whose key starts with a prefix,
+     *        across all objects, e.g. the texture names behind "SpritePathName".
+     * \param keyPrefix The start of the keys to match.
+     * \return The distinct values, in file order.
+     */
+    std::vector<std::string> GetStringValues(std::string_view keyPrefix) const;
+
+    /**
+     * \brief Reads a value using the same table/key path as LuaManager::LuaRead.
+     * \tparam T The type of the value to retrieve.
+     * \param objectTable The name of the object table.
+     * \param keys Either { field } or { subTable, field }.
+     * \return The value, or std::nullopt if the path does not exist or has another type.
+     */
+    template<typename T>
+    std::optional<T> Read(const std::string& objectTable, const std::vector<std::string>& keys) const;
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t stringCount;
+        uint32_t objectCount;
+        uint32_t tableCount;
+        uint32_t fieldCount;
+        uint32_t stringBytes;
+        uint32_t reserved;
+    };
+
+    struct StringRecord {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct ObjectRecord {
+        uint32_t name;          // String index of the global table name
+        int32_t id;
+        int32_t parentID;
+        uint32_t firstTable;
+        uint32_t tableCount;
+        uint32_t reserved;
+    };
+
+    struct TableRecord {
+        uint32_t name;          // String index, "" for fields stored directly on the object
+        uint32_t firstField;
+        uint32_t fieldCount;
+        uint32_t reserved;
+    };
+
+    struct FieldRecord {
+        uint32_t key;           // String index
+        FieldType type;
+        union {
+            double number;
+            uint32_t stringIndex;
+            uint32_t boolean;
+        };
+    };
+
+    static_assert(sizeof(Header) == 32, "Cooked header layout changed");
+    static_assert(sizeof(ObjectRecord) == 24, "Cooked object layout changed");
+    static_assert(sizeof(TableRecord) == 16, "Cooked table layout changed");
+    static_assert(sizeof(FieldRecord) == 16, "Cooked field layout changed");
+
+    /**
+     * \brief Retrieves a string from the string table.
+     * \param index The string index.
+     * \return A view into the mapped string bytes.
+     */
+    std::string_view GetString(uint32_t index) const {
+        return std::string_view(stringBytes + strings[index].offset, strings[index].length);
+    }
+
+    /**
+     * \brief Finds a table of an object by name.
+     * \param objectTable The name of the object table.
+     * \param tableName The name of the sub-table, "" for fields on the object itself.
+     * \return The table record, or nullptr if not found.
+     */
+    const TableRecord* FindTable(const std::string& objectTable, std::string_view tableName) const;
+
+    /**
+     * \brief Resolves a LuaRead style key path to a field.
+     * \param objectTable The name of the object table.
+     * \param keys Either { field } or { subTable, field }.
+     * \return The field record, or nullptr if not found.
+     */
+    const FieldRecord* FindField(const std::string& objectTable, const std::vector<std::string>& keys) const;
+
+    /**
+     * \brief Validates an image and points the record arrays into it.
+     * \param base The first byte of the image.
+     * \param size The size of the image.
+     * \param sourceName The file name used in log messages.
+     * \return True if the image is valid, false otherwise.
+     */
+    bool Index(const unsigned char* base, size_t size, const std::string& sourceName);
+
+    MappedFile file;
+    std::vector<unsigned char> memory; // Owns the image when it was built in memory instead of mapped
+    const Header* header = nullptr;
+    const StringRecord* strings = nullptr;
+    const ObjectRecord* objects = nullptr;
+    const TableRecord* tables = nullptr;
+    const FieldRecord* fields = nullptr;
+    const char* stringBytes = nullptr;
+    std::unordered_map<std::string_view, uint32_t> objectIndex; // Table name -> object index
+};
+
+/**
+ * \brief Collects object tables and lays them out as a cooked image in memory.
+ *        Bake feeds it from an executed Lua file, world snapshots from a LuaSceneWriter.
+ */
+class CookedScene::Builder {
+public:
+    Builder();
+
+    /**
+     * \brief Starts a new object table. Its id is taken from the numeric suffix of the name.
+     * \param objectTable The Lua global name of the object table, e.g. "Player_3".
+     * \param parentID The parent id stored in the object's Name table, -1 for none.
+     */
+    void BeginObject(const std::string& objectTable, int parentID);
+
+    /**
+     * \brief Starts a sub-table of the current object. Fields added before the first
+     *        BeginTable are stored directly on the object.
+     * \param tableName The name of the sub-table.
+     */
+    void BeginTable(const std::string& tableName);
+
+    /**
+     * \brief Adds a number field to the current table.
+     * \param key The field name.
+     * \param value The value.
+     */
+    void AddNumber(const std::string& key, double value);
+
+    /**
+     * \brief Adds a string field to the current table.
+     * \param key The field name.
+     * \param value The value.
+     */
+    void AddString(const std::string& key, const std::string& value);
+
+    /**
+     * \brief Adds a boolean field to the current table.
+     * \param key The field name.
+     * \param value The value.
+     */
+    void AddBoolean(const std::string& key, bool value);
+
+    /**
+     * \brief Lays out everything added so far as a cooked image.
+     * \return The bytes of the image, the same bytes Bake writes to disk.
+     */
+    std::vector<unsigned char> Finish();
+
+private:
+    /**
+     * \brief Adds a string to the string table once.
+     * \param value The string to add.
+     * \return The index of the string.
+     */
+    uint32_t Intern(const std::string& value);
+
+    /**
+     * \brief Appends a field to the current table, opening the object-level table if needed.
+     * \param field The field record with its key already interned.
+     */
+    void AddField(const FieldRecord& field);
+
+    /**
+     * \brief Removes the object-level table of the current object if it stayed empty.
+     */
+    void DropEmptyObjectTable();
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringLookup;
+    std::vector<ObjectRecord> objectRecords;
+    std::vector<TableRecord> tableRecords;
+    std::vector<FieldRecord> fieldRecords;
+};
+
+/**
+ * \brief Reads a value using the same table/key path as LuaManager::LuaRead.
+ * \tparam T The type of the value to retrieve.
+ * \param objectTable The name of the object table.
+ * \param keys Either { field } or { subTable, field }.
+ * \return The value, or std::nullopt if the path does not exist or has another type.
+ */
+template<typename T>
+std::optional<T> CookedScene::Read(const std::string& objectTable, const std::vector<std::string>& keys) const {
+    const FieldRecord* field = FindField(objectTable, keys);
+    if (!field) {
+        return std::nullopt;
+    }
+
+    if constexpr (std::is_same_v<T, std::string>) {
+        if (field->type == FieldType::STRING) {
+            return std::string(GetString(field->stringIndex));
+        }
+    }
+    else if constexpr (std::is_same_v<T, bool>) {
+        if (field->type == FieldType::BOOLEAN) {
+            return field->boolean != 0;
+        }
+    }
+    else if constexpr (std::is_arithmetic_v<T>) {
+        if (field->type == FieldType::NUMBER) {
+            return static_cast<T>(field->number);
+        }
+    }
+    return std::nullopt;
+}
@@ -1,9 +1,12 @@
 /*!****************************************************************
 \file: DespawnManager.h
 \author: Lee Yu Jie Brandon, l.yujiebrandon, 2301232
-\brief: Singleton manager for scheduling game objects to be automatically 
-        despawned after a specified time delay. Handles tracking and 
+\co-author: Goh Jun Jie, g.junjie, 2301293
+\brief: Singleton manager for scheduling game objects to be automatically
+        despawned after a specified time delay. Handles tracking and
         cleanup of objects marked for delayed removal from the game.
+        The delays are timers on the TimerService, so pending
+        despawns cost nothing per frame until they expire.
 
 Copyright (C) 2025 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -13,26 +16,27 @@ Technology is prohibited.
 
 
 #pragma once
+#include <unordered_map>
 #include <vector>
-#include <utility>
 #include "GameObject.h"
-#include "Engine.h"
+#include "TimerService.h"
 
 class DespawnManager {
 private:
-    struct DespawnEntry {
-        GameObject* object;
-        float timeRemaining;
-    };
+    // The timer of each object waiting to be despawned
+    std::unordered_map<GameObject*, TimerService::Handle> pendingDespawns;
+    TimerService::ChannelID channel;
 
-    std::vector<DespawnEntry> pendingDespawns;
+    // Private constructor for singleton, registers the despawn channel
+    DespawnManager();
 
-    // Private constructor for singleton
-    DespawnManager() = default;
     // Delete copy constructor and assignment operator
     DespawnManager(const DespawnManager&) = delete;
     DespawnManager& operator=(const DespawnManager&) = delete;
 
+    // Despawns the objects whose timers expired in one tick
+    void DespawnExpired(const std::vector<uint64_t>& payloads);
+
 public:
     // Singleton access
     static DespawnManager& GetInstance() {
@@ -40,30 +44,13 @@ public:
         return instance;
     }
 
-    // Schedule a game object to be despawned after the specified delay
-    static void ScheduleDespawn(GameObject* obj, float delay) {
-        DespawnEntry entry;
-        entry.object = obj;
-        entry.timeRemaining = delay;
-        GetInstance().pendingDespawns.push_back(entry);
-    }
-
-    // Update method to be called each frame
-    void Update() {
-        float deltaTime = static_cast<float>(Engine::GetInstance().fixedDT);
+    // Schedule a game object to be despawned after the specified delay.
+    // Scheduling an object again replaces its earlier delay.
+    static void ScheduleDespawn(GameObject* obj, float delay);
 
-        // Update all timers and despawn as needed
-        auto it = pendingDespawns.begin();
-        while (it != pendingDespawns.end()) {
-            it->timeRemaining -= deltaTime;
+    // Forget an object's pending despawn, called when it is despawned some other way
+    void Cancel(GameObject* obj);
 
-            if (it->timeRemaining <= 0.0f) {
-                GameObjectFactory::GetInstance().Despawn(it->object);
-                it = pendingDespawns.erase(it);
-            }
-            else {
-                ++it;
-            }
-        }
-    }
-};
\ No newline at end of file
+    // Number of objects waiting to be despawned
+    size_t GetPendingCount() const { return pendingDespawns.size(); }
+};
@@ -0,0 +1,332 @@
+/*!****************************************************************
+\file: EventBus.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the EventBus, which carries gameplay notifications
+        from whoever raises them to whoever listens. An event is any
+        copyable struct with a default constructor and a static
+        constexpr EventBus::Phase phase, the point in the frame its
+        subscribers hear about it.
+
+        Each event type has its own queue. Posting only copies the
+        event into the queue, so it is cheap and can be done from any
+        thread: the queue is a fixed ring that producers claim slots
+        in with one compare-and-swap, and a full ring spills into an
+        overflow list behind a lock rather than losing the event.
+        The main thread dispatches a phase by emptying the queues of
+        its types and handing each batch to every subscriber in turn.
+        Events posted by subscribers during a dispatch are delivered
+        in the same phase, in a further round.
+
+        Subscribing, unsubscribing and dispatching are main thread
+        only. Events from one thread arrive in the order they were
+        posted, unless the ring overflowed.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+#include <vector>
+
+class EventBus {
+public:
+    /**
+     * \brief The points in the frame where events are dispatched.
+     */
+    enum class Phase {
+        FRAME_START = 0,        // Before the game flow, where scene changes happen
+        AFTER_GAME_OBJECTS,     // Once the components have updated, before collision
+        END_OF_FRAME,           // After every system, for events raised on worker threads
+        COUNT
+    };
+
+    static constexpr size_t MaxEventTypes = 64;
+    static constexpr size_t QueueCapacity = 1024;   // Per event type, before posts overflow
+    static constexpr int MaxRounds = 8;             // Rounds of events posted while dispatching
+
+    /**
+     * \brief Refers to one subscriber. Stays safe to unsubscribe more than once.
+     */
+    struct Subscription {
+        uint32_t type = UINT32_MAX;
+        uint32_t id = 0;
+    };
+
+    /**
+     * \brief Counters for one event type, for the editor.
+     */
+    struct ChannelStats {
+        const char* name = nullptr;
+        Phase phase = Phase::FRAME_START;
+        size_t subscribers = 0;
+        size_t queued = 0;          // Posted and not yet dispatched
+        uint64_t dispatched = 0;    // Events handed to subscribers
+        uint64_t batches = 0;       // Dispatches that had events
+        uint64_t overflowed = 0;    // Posts that found the ring full
+    };
+
+    /**
+     * \brief Retrieves the event bus instance.
+     * \return Reference to the event bus.
+     */
+    static EventBus& GetInstance();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * \brief Adds a subscriber for an event type. Main thread only.
+     * \param handler Called with every event of the type, at the type's phase.
+     * \return The subscription, for unsubscribing.
+     */
+    template <typename Event>
+    Subscription Subscribe(std::function<void(const Event&)> handler) {
+        return GetChannel<Event>().Add(std::move(handler));
+    }
+
+    /**
+     * \brief Removes a subscriber. Main thread only, and safe from inside a handler.
+     * \param subscription The subscriber. Cleared so it refers to nothing.
+     */
+    void Unsubscribe(Subscription& subscription);
+
+    /**
+     * \brief Queues an event for its phase. Safe from any thread.
+     * \param event The event.
+     */
+    template <typename Event>
+    void Post(const Event& event) {
+        GetChannel<Event>().Push(event);
+    }
+
+    /**
+     * \brief Hands the queued events of a phase to their subscribers. Main thread only.
+     * \param phase The phase.
+     * \return The number of events dispatched.
+     */
+    size_t Dispatch(Phase phase);
+
+    /**
+     * \brief Retrieves the counters of every event type used so far.
+     * \return The counters, in the order the types were first used.
+     */
+    std::vector<ChannelStats> GetStats() const;
+
+private:
+    /**
+     * \brief The queue and subscribers of one event type.
+     */
+    class ChannelBase {
+    public:
+        virtual ~ChannelBase() = default;
+        virtual size_t Deliver() = 0;
+        virtual void Remove(uint32_t id) = 0;
+        virtual void FillStats(ChannelStats& stats) const = 0;
+
+        Phase phase = Phase::FRAME_START;
+        uint32_t type = UINT32_MAX;
+    };
+
+    template <typename Event>
+    class Channel : public ChannelBase {
+    public:
+        Channel() : cells(new Cell[QueueCapacity]) {
+            static_assert((QueueCapacity & (QueueCapacity - 1)) == 0, "EventBus queue capacity must be a power of two");
+            for (size_t index = 0; index < QueueCapacity; ++index) {
+                cells[index].sequence.store(index, std::memory_order_relaxed);
+            }
+            phase = Event::phase;
+            type = EventBus::GetInstance().Register(this);
+        }
+
+        Subscription Add(std::function<void(const Event&)> handler) {
+            // Not into subscribers while delivering, which would move the handler that is running
+            (delivering ? added : subscribers).push_back(Subscriber{ nextID, true, std::move(handler) });
+            return Subscription{ type, nextID++ };
+        }
+
+        void Remove(uint32_t id) override {
+            for (size_t index = 0; index < added.size(); ++index) {
+                if (added[index].id == id) {
+                    added.erase(added.begin() + static_cast<std::ptrdiff_t>(index));
+                    return;
+                }
+            }
+            for (size_t index = 0; index < subscribers.size(); ++index) {
+                if (subscribers[index].id != id) {
+                    continue;
+                }
+                if (delivering) {
+                    // The handler may be the one running, so it is only dropped once the batch is done
+                    subscribers[index].active = false;
+                    removedWhileDelivering = true;
+                }
+                else {
+                    subscribers.erase(subscribers.begin() + static_cast<std::ptrdiff_t>(index));
+                }
+                return;
+            }
+        }
+
+        void Push(const Event& event) {
+            size_t position = enqueuePosition.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells[position & (QueueCapacity - 1)];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                if (difference == 0) {
+                    // The cell is free for this position; claim it before anyone else does
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.event = event;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return;
+                    }
+                }
+                else if (difference < 0) {
+                    // A lap behind: the ring is full until the next dispatch
+                    std::lock_guard<std::mutex> lock(overflowMutex);
+                    overflow.push_back(event);
+                    hasOverflow.store(true, std::memory_order_release);
+                    overflowed.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                else {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        size_t Deliver() override {
+            batch.clear();
+            for (;;) {
+                Cell& cell = cells[dequeuePosition & (QueueCapacity - 1)];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence != dequeuePosition + 1) {
+                    break;  // Empty, or claimed by a producer that has not finished writing
+                }
+                batch.push_back(std::move(cell.event));
+                cell.sequence.store(dequeuePosition + QueueCapacity, std::memory_order_release);
+                ++dequeuePosition;
+            }
+            if (hasOverflow.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(overflowMutex);
+                batch.insert(batch.end(), overflow.begin(), overflow.end());
+                overflow.clear();
+                hasOverflow.store(false, std::memory_order_relaxed);
+            }
+            if (batch.empty()) {
+                return 0;
+            }
+
+            // Handlers may post more of this type, which lands in the queue for the next round.
+            // Subscribers added by a handler hear from the next batch on.
+            std::vector<Event> handing;
+            handing.swap(batch);
+            delivering = true;
+            for (size_t index = 0; index < subscribers.size(); ++index) {
+                for (const Event& event : handing) {
+                    if (!subscribers[index].active) {
+                        break;
+                    }
+                    subscribers[index].handler(event);
+                }
+            }
+            delivering = false;
+            if (removedWhileDelivering) {
+                removedWhileDelivering = false;
+                for (size_t index = subscribers.size(); index-- > 0;) {
+                    if (!subscribers[index].active) {
+                        subscribers.erase(subscribers.begin() + static_cast<std::ptrdiff_t>(index));
+                    }
+                }
+            }
+            for (Subscriber& subscriber : added) {
+                subscribers.push_back(std::move(subscriber));
+            }
+            added.clear();
+
+            const size_t delivered = handing.size();
+            dispatched += delivered;
+            ++batches;
+            handing.clear();
+            if (batch.empty()) {
+                batch.swap(handing);   // Keep the capacity
+            }
+            return delivered;
+        }
+
+        void FillStats(ChannelStats& stats) const override {
+            stats.name = typeid(Event).name();
+            stats.phase = phase;
+            stats.subscribers = subscribers.size() + added.size();
+            stats.queued = enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition;
+            stats.dispatched = dispatched;
+            stats.batches = batches;
+            stats.overflowed = overflowed.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{ 0 };  // Position + 1 once written, position + capacity once read
+            Event event{};
+        };
+
+        struct Subscriber {
+            uint32_t id = 0;
+            bool active = true;
+            std::function<void(const Event&)> handler;
+        };
+
+        // The position producers claim on its own cache line, away from the consumer's
+        std::unique_ptr<Cell[]> cells;
+        alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+        alignas(64) size_t dequeuePosition = 0;
+
+        std::mutex overflowMutex;
+        std::vector<Event> overflow;
+        std::atomic<bool> hasOverflow{ false };
+        std::atomic<uint64_t> overflowed{ 0 };
+
+        std::vector<Subscriber> subscribers;
+        std::vector<Subscriber> added;          // Subscribed by a handler while delivering
+        std::vector<Event> batch;
+        uint32_t nextID = 1;
+        bool delivering = false;
+        bool removedWhileDelivering = false;
+        uint64_t dispatched = 0;
+        uint64_t batches = 0;
+    };
+
+    EventBus() = default;
+    ~EventBus() = default;
+
+    /**
+     * \brief Retrieves the channel of an event type, creating it the first time.
+     * \return The channel, which lives as long as the program.
+     */
+    template <typename Event>
+    Channel<Event>& GetChannel() {
+        static Channel<Event> channel;
+        return channel;
+    }
+
+    /**
+     * \brief Records a new channel so dispatching finds it.
+     * \param channel The channel.
+     * \return The channel's type number.
+     */
+    uint32_t Register(ChannelBase* channel);
+
+    std::array<std::atomic<ChannelBase*>, MaxEventTypes> channels{};
+    std::atomic<uint32_t> channelCount{ 0 };
+    std::mutex registerMutex;
+};
@@ -0,0 +1,169 @@
+/*!****************************************************************
+\file: EventScheduler.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the EventScheduler, a queue of events due at a
+        time on a simulation clock. The clock only moves when the
+        owner advances it by fixed steps, so it stops while the game
+        is paused and runs the same however fast frames come. Each
+        step dispatches the events that fell due within it, earliest
+        first and in the order they were scheduled when they are due
+        together, with how far into the step they were due.
+
+        Nothing here reads the wall clock, so the same schedule and
+        the same steps always dispatch the same events on the same
+        steps. The dispatch log records that for comparing runs.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+template <typename Event>
+class EventScheduler {
+public:
+    /**
+     * \brief One event that was dispatched.
+     */
+    struct Dispatch {
+        uint64_t sequence = 0;  // Order the event was scheduled in
+        uint64_t step = 0;      // The step that dispatched it, counting from 1
+        double due = 0.0;       // When it was due, in seconds on the clock
+        double lateness = 0.0;  // Seconds from when it was due to the end of its step
+    };
+
+    /**
+     * \brief An event that has not been dispatched.
+     */
+    struct Pending {
+        Event event;
+        double due = 0.0;
+        uint64_t sequence = 0;
+    };
+
+    /**
+     * \brief Schedules an event. Events due before the clock's time go out on the next step.
+     * \param due When the event is due, in seconds on the clock.
+     * \param event The event.
+     * \return The event's sequence number.
+     */
+    uint64_t Schedule(double due, const Event& event) {
+        pending.push_back(Pending{ event, due, nextSequence });
+        std::push_heap(pending.begin(), pending.end(), Later());
+        return nextSequence++;
+    }
+
+    /**
+     * \brief Moves the clock on by whole steps, dispatching the events due in each step.
+     *        Events scheduled while dispatching that are due within the step go out in it too.
+     * \param stepSeconds The length of one step.
+     * \param steps The number of steps.
+     * \param dispatch Called with each event and its lateness in seconds.
+     */
+    void Advance(double stepSeconds, int steps, const std::function<void(const Event&, double)>& dispatch) {
+        for (int index = 0; index < steps; ++index) {
+            ++step;
+            if (stepSeconds != lastStepSeconds) {
+                stepBase = step - 1;
+                timeBase = time;
+                lastStepSeconds = stepSeconds;
+            }
+            // Counted from the steps rather than summed, so long runs do not drift
+            time = timeBase + static_cast<double>(step - stepBase) * stepSeconds;
+            // Slack for due times that are a whole number of steps but not exact in binary
+            const double limit = time + stepSeconds * 1e-6;
+            while (!pending.empty() && pending.front().due <= limit) {
+                std::pop_heap(pending.begin(), pending.end(), Later());
+                Pending next = std::move(pending.back());
+                pending.pop_back();
+
+                Dispatch record;
+                record.sequence = next.sequence;
+                record.step = step;
+                record.due = next.due;
+                record.lateness = std::max(0.0, time - next.due);
+                log.push_back(record);
+                if (dispatch) {
+                    dispatch(next.event, record.lateness);
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Removes every event that has not been dispatched.
+     */
+    void Clear() { pending.clear(); }
+
+    /**
+     * \brief Removes every event, and sets the clock, step count, sequence numbers and log back to zero.
+     */
+    void Reset() {
+        pending.clear();
+        log.clear();
+        time = 0.0;
+        timeBase = 0.0;
+        step = 0;
+        stepBase = 0;
+        lastStepSeconds = 0.0;
+        nextSequence = 0;
+    }
+
+    /**
+     * \brief Retrieves the events that have not been dispatched, earliest first.
+     * \return A copy of the events.
+     */
+    std::vector<Pending> GetPending() const {
+        std::vector<Pending> sorted = pending;
+        std::sort(sorted.begin(), sorted.end(), [](const Pending& a, const Pending& b) { return Later()(b, a); });
+        return sorted;
+    }
+
+    /**
+     * \brief Retrieves the number of events that have not been dispatched.
+     * \return The count.
+     */
+    size_t GetPendingCount() const { return pending.size(); }
+
+    /**
+     * \brief Retrieves the clock's time.
+     * \return Seconds on the clock, the end of the last step.
+     */
+    double GetTime() const { return time; }
+
+    /**
+     * \brief Retrieves the number of steps since the last Reset.
+     * \return The step count.
+     */
+    uint64_t GetStep() const { return step; }
+
+    /**
+     * \brief Retrieves every dispatch since the last Reset, in the order they happened.
+     * \return The log.
+     */
+    const std::vector<Dispatch>& GetLog() const { return log; }
+
+private:
+    /**
+     * \brief Orders the heap so the earliest event, and of those the first scheduled, is on top.
+     */
+    struct Later {
+        bool operator()(const Pending& a, const Pending& b) const {
+            return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+        }
+    };
+
+    std::vector<Pending> pending;   // Heap ordered by Later
+    std::vector<Dispatch> log;
+    double time = 0.0;
+    double timeBase = 0.0;          // Clock time when the step length last changed
+    uint64_t step = 0;
+    uint64_t stepBase = 0;          // Step count when the step length last changed
+    double lastStepSeconds = 0.0;
+    uint64_t nextSequence = 0;
+};
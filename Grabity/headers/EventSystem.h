@@ -1,11 +1,14 @@
 /*!****************************************************************
 \file: EventSystem.h
 \author: Ridhwan Afandi (mohamedridhwan.b)
+\co-author: Goh Jun Jie, g.junjie, 2301293
 \brief  Contains the declaration of the EventSystem class, which
-        manages game events via GameEventComponent on a separate thread.
-        The worker thread starts automatically upon instantiation and
-        continuously processes events in the background. This file also
-        provides functions to add, save, and load events.
+        manages game events via GameEventComponent. Spawn events are
+        scheduled on a simulation clock that only runs in the game
+        scene while it is not paused, and are dispatched on the main
+        thread once per fixed step from Update. This file also
+        provides functions to add, save, and load events. Enemy
+        deaths arrive as EnemyKilledEvents on the EventBus.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -15,14 +18,12 @@ Technology is prohibited.
 #pragma once
 #ifndef _EVENT_SYSTEM_H_
 #include <queue>
-#include <chrono>
-#include <thread>
-#include <mutex>
-#include <condition_variable>
 #include "Engine.h"
 #include "ImGuiConsole.h"
 #include "GameObjectFactory.h"
 #include "GameEventComponent.h"
+#include "EventScheduler.h"
+#include "GameplayEvents.h"
 
 // Comparator for priority queue (earliest event has the highest priority)
 struct EventCompare {
@@ -48,7 +49,15 @@ public:
     static void ShutDown();
 
     /**
-     * @brief Adds a game event to the event queue.
+     * @brief Moves the simulation clock on by this frame's fixed steps and spawns the
+     *        waves that fell due. The clock stands still outside the game scene and
+     *        while the game is paused. Called once per frame on the main thread.
+     */
+    void Update();
+
+    /**
+     * @brief Adds a game event to the event queue. A spawn event is due when the game
+     *        timer, counting down from Engine::maxTime, reaches its startTime.
      *
      * @param event The GameEventComponent to be added to the event queue.
      */
@@ -87,11 +96,13 @@ public:
     void ClearMissions();
 
     /**
-     * @brief Adds a death event for a specified GameObject.
+     * @brief Finds the kind of enemy a GameObject is, for counting it towards missions.
      *
-     * @param GO The GameObject that has died.
+     * @param name The GameObject's name.
+     * @param type Set to the enemy's type.
+     * @return True if the name is of an enemy that missions count.
      */
-    void AddDeathEvent(const GameObject& GO);
+    static bool GetEnemyType(const std::string& name, EnemyType& type);
 
     /**
      * @brief Retrieves the win condition state.
@@ -100,7 +111,12 @@ public:
      */
     bool GetWinCondition() { return WinCondition; }
 
-    void SetWinCondition(bool state) { WinCondition = state; }
+    /**
+     * @brief Sets the win condition. Winning posts a MissionsCompletedEvent.
+     *
+     * @param state True if the level is won.
+     */
+    void SetWinCondition(bool state);
     /**
      * @brief Retrieves the event queue.
      *
@@ -108,6 +124,20 @@ public:
      */
     const std::priority_queue<GameEventComponent, std::vector<GameEventComponent>, EventCompare> GetEventQueue();
 
+    /**
+     * @brief Retrieves the simulation clock.
+     *
+     * @return Seconds of unpaused game time since the events were loaded.
+     */
+    double GetSimulationTime() const { return scheduler.GetTime(); }
+
+    /**
+     * @brief Retrieves every wave dispatched since the events were loaded, for comparing runs.
+     *
+     * @return The dispatch log.
+     */
+    const std::vector<EventScheduler<GameEventComponent>::Dispatch>& GetDispatchLog() const { return scheduler.GetLog(); }
+
     /**
      * @brief Retrieves the mission vector.
      *
@@ -121,14 +151,24 @@ private:
     ~EventSystem();
 private:
     static inline EventSystem* evtSystem_Instance = nullptr;
-    std::priority_queue<GameEventComponent, std::vector<GameEventComponent>, EventCompare> eventQueue;
+    EventScheduler<GameEventComponent> scheduler;
 	std::vector <GameMissionComponent> missionVector;
-    std::mutex queueMutex;
-    std::condition_variable cv;
 	bool WinCondition = false;
-    bool running = true;
-    std::thread workerThread;
+    EventBus::Subscription enemyKilledSubscription;
+
+    /**
+     * @brief Counts a death towards the missions for its enemy type, and wins the level
+     *        once every mission is complete.
+     *
+     * @param event The death.
+     */
+    void OnEnemyKilled(const EnemyKilledEvent& event);
 
-    void ProcessEvents();
+    /**
+     * @brief Spawns the enemies of a wave on the side of the level away from the player.
+     *
+     * @param event The spawn event.
+     */
+    void SpawnWave(const GameEventComponent& event);
 };
 #endif // _EVENT_SYSTEM_H_
\ No newline at end of file
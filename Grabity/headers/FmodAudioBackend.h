@@ -0,0 +1,104 @@
+/*!****************************************************************
+\file: FmodAudioBackend.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the FMOD implementation of AudioBackend. Sound and
+        channel IDs map to FMOD sounds and channels; channels that
+        finished are forgotten on Update. FMOD channel handles turn
+        invalid when FMOD steals or reuses the channel, which reads
+        as "not playing".
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#ifndef _NO_FMOD
+#include "AudioBackend.h"
+#include <fmod.hpp>
+#include <unordered_map>
+#include <mutex>
+
+class FmodAudioBackend : public AudioBackend {
+public:
+    bool Init(int maxChannels) override;
+    void Release() override;
+    void Update() override;
+    const char* GetName() const override { return "FMOD"; }
+
+    SoundID CreateSound(const void* data, size_t size, bool loop, LoadMode mode) override;
+    SoundID CreateStream(const std::string& path, bool loop) override;
+    void ReleaseSound(SoundID sound) override;
+    SoundMemory GetSoundMemory(SoundID sound) const override;
+
+    ChannelID Play(SoundID sound, bool paused) override;
+    void Stop(ChannelID channel) override;
+    bool IsPlaying(ChannelID channel) const override;
+    SoundID GetSound(ChannelID channel) const override;
+    void SetPaused(ChannelID channel, bool paused) override;
+    bool IsPaused(ChannelID channel) const override;
+    void SetVolume(ChannelID channel, float volume) override;
+    float GetVolume(ChannelID channel) const override;
+    void SetMute(ChannelID channel, bool mute) override;
+    void SetPriority(ChannelID channel, int priority) override;
+    void SetLooping(ChannelID channel, bool loop) override;
+    unsigned int GetPosition(ChannelID channel) const override;
+    void SetPosition(ChannelID channel, unsigned int milliseconds) override;
+    void SetLowPass(ChannelID channel, float cutoff) override;
+    float GetLowPass(ChannelID channel) const override;
+    void FadeTo(ChannelID channel, float target, float seconds, bool stopAtEnd) override;
+    float GetFade(ChannelID channel) const override;
+    int GetChannelsPlaying() const override;
+
+private:
+    struct PlayingChannel {
+        FMOD::Channel* channel = nullptr;
+        SoundID sound = InvalidID;
+        FMOD::DSP* lowPass = nullptr;   // Created on first use, released with the channel
+        float fadeFrom = 1.0f;          // Fade gain at fadeStart
+        float fadeTarget = 1.0f;        // Fade gain from fadeEnd on
+        unsigned long long fadeStart = 0;   // Parent DSP clock of the ramp's fade points
+        unsigned long long fadeEnd = 0;
+        bool stopAtFadeEnd = false;
+    };
+
+    /**
+     * @brief Retrieves the fade gain of a channel at a parent DSP clock.
+     * @param playing The channel.
+     * @param clock The parent DSP clock.
+     * @return The fade gain.
+     */
+    static float GetFadeAt(const PlayingChannel& playing, unsigned long long clock);
+
+    /**
+     * @brief Adds a created sound and works out the memory it takes.
+     * @param sound The FMOD sound.
+     * @param mode The mode it was loaded in.
+     * @param fileSize The size of its file.
+     * @return Its ID.
+     */
+    SoundID AddSound(FMOD::Sound* sound, LoadMode mode, size_t fileSize);
+
+    /**
+     * @brief Retrieves the FMOD channel of an ID.
+     * @param channel The channel ID.
+     * @return The FMOD channel, or nullptr if unknown.
+     */
+    FMOD::Channel* Find(ChannelID channel) const;
+
+    /**
+     * @brief Forgets a channel and releases its low-pass filter.
+     * @param it The channel to forget.
+     */
+    void Forget(std::unordered_map<ChannelID, PlayingChannel>::iterator it);
+
+    FMOD::System* system = nullptr;
+    int outputRate = 48000;     // Samples per second of the DSP clock
+    mutable std::mutex soundMutex;      // Sounds are created by startup worker threads
+    std::unordered_map<SoundID, FMOD::Sound*> sounds;
+    std::unordered_map<SoundID, SoundMemory> soundMemory;   // Worked out once, when the sound is created
+    std::unordered_map<ChannelID, PlayingChannel> channels;
+    SoundID nextSound = 1;
+    ChannelID nextChannel = 1;
+};
+#endif // !_NO_FMOD
@@ -15,6 +15,7 @@ Technology is prohibited.
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 #include <ft2build.h>
 #include FT_FREETYPE_H 
 
@@ -58,6 +59,40 @@ public:
     *******************************************************************!*/
     void LoadFont(std::string fontPath, FT_UInt pixelSize);
 
+    /*!****************************************************************
+    \brief
+        Rasterizes the first 128 ASCII glyphs of a font into memory
+        without touching OpenGL, so it can run on a worker thread.
+        UploadGlyphs has to be called afterwards on the thread that
+        owns the OpenGL context.
+
+    \param fontPath
+        The file path to the font file.
+
+    \param pixelSize
+        The size of the font in pixels.
+
+    \return
+        True if the font was rasterized, false otherwise.
+    *******************************************************************!*/
+    bool RasterizeFont(const std::string& fontPath, FT_UInt pixelSize);
+
+    /*!****************************************************************
+    \brief
+        Creates a texture for every glyph rasterized by RasterizeFont
+        and releases the bitmaps.
+    *******************************************************************!*/
+    void UploadGlyphs();
+
+    /*!****************************************************************
+    \brief
+        Checks if rasterized glyphs are waiting for UploadGlyphs.
+
+    \return
+        True if glyphs are waiting, false otherwise.
+    *******************************************************************!*/
+    bool HasPendingGlyphs() const { return !pendingGlyphs.empty(); }
+
     /*!****************************************************************
     \brief
         Renders a string of text using the specified shader, position,
@@ -91,5 +126,18 @@ public:
 
     std::unordered_map<char, Character> const& GetCharacterDictionary() { return characters; };
 private:
+    // A glyph bitmap rasterized by FreeType that has not been uploaded yet
+    struct RasterizedGlyph
+    {
+        char character = 0;
+        unsigned int width = 0;
+        unsigned int rows = 0;
+        int left = 0;
+        int top = 0;
+        unsigned int advance = 0;
+        std::vector<unsigned char> pixels;   // Tightly packed rows
+    };
+
     std::unordered_map<char, Character> characters; // Map of characters and their glyph information
+    std::vector<RasterizedGlyph> pendingGlyphs;     // Rasterized glyphs waiting for UploadGlyphs
 };
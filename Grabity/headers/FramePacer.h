@@ -0,0 +1,166 @@
+/*!****************************************************************
+\file: FramePacer.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the FramePacer, which holds the main loop to the
+        target frame rate. Frames are due on a fixed schedule rather
+        than a fixed time after the last one finished, so a slow frame
+        does not push every later one back.
+
+        Waiting for the next frame sleeps through most of the time
+        left and spins only for the end of it. How late the OS wakes a
+        sleeping thread varies by machine and by load, so the pacer
+        measures every sleep and keeps an estimate of the overshoot,
+        its average plus two standard deviations. It stops sleeping
+        once less than that estimate is left. On Windows the sleeps
+        use a high-resolution waitable timer, or a 1 ms system timer
+        period where that is not available.
+
+        While the window is in the background the sleep can be handed
+        to a function that also wakes for window events, and a wait
+        can be cut short, so the loop picks up the moment the window
+        comes back.
+
+        The length of the last frames is kept for the editor: the
+        average, the jitter (their standard deviation), the worst,
+        and how much of the wait was spent sleeping and spinning.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using SleepFunction = void(*)(double milliseconds);
+
+    static constexpr size_t HistorySize = 240;      // Frames the stats cover
+
+    /**
+     * \brief Pacing over the last HistorySize frames, in milliseconds.
+     */
+    struct Stats {
+        double targetFrameTime = 0.0;   // 0 when the frame rate is not limited
+        double averageFrameTime = 0.0;
+        double jitter = 0.0;            // Standard deviation of the frame time
+        double worstFrameTime = 0.0;
+        double averageLateness = 0.0;   // From when a frame was due to when the wait returned
+        double worstLateness = 0.0;
+        double averageSleep = 0.0;      // Per frame
+        double averageSpin = 0.0;       // Per frame
+        double sleepOvershoot = 0.0;    // The current estimate
+        uint64_t missedFrames = 0;      // Frames that finished after the next was due, since ResetStats
+        size_t frames = 0;              // Frames the averages cover
+    };
+
+    /**
+     * \brief Retrieves the frame pacer instance.
+     * \return Reference to the frame pacer.
+     */
+    static FramePacer& GetInstance();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * \brief Sets the frame rate to hold the loop to. The schedule starts again from the next frame.
+     * \param framesPerSecond The target, 0 or less for no limit.
+     */
+    void SetTargetFrameRate(double framesPerSecond);
+
+    /**
+     * \brief Retrieves the frame rate the loop is held to.
+     * \return The target, 0 when there is no limit.
+     */
+    double GetTargetFrameRate() const { return targetFrameRate; }
+
+    /**
+     * \brief Waits until the next frame is due, then returns. Called once at the end of every frame.
+     */
+    void WaitForNextFrame();
+
+    /**
+     * \brief Sets what sleeps while waiting. Its sleeps may end early and are not learnt from.
+     * \param function Sleeps for up to the milliseconds given, nullptr for the OS sleep.
+     */
+    void SetSleepFunction(SleepFunction function) { sleepFunction = function; }
+
+    /**
+     * \brief Ends the current wait at once, or the next one if none is under way. Main thread
+     *        only, e.g. from a window callback run by the sleep function.
+     */
+    void Interrupt() { interrupted = true; }
+
+    /**
+     * \brief Retrieves the pacing over the last frames.
+     * \return A copy of the stats.
+     */
+    Stats GetStats() const;
+
+    /**
+     * \brief Forgets the frame history and the missed frame count. The overshoot estimate is kept.
+     */
+    void ResetStats();
+
+private:
+    /**
+     * \brief What one frame's wait did, in milliseconds.
+     */
+    struct FrameRecord {
+        double frameTime = 0.0;
+        double lateness = 0.0;
+        double sleep = 0.0;
+        double spin = 0.0;
+    };
+
+    FramePacer();
+    ~FramePacer();
+
+    /**
+     * \brief Sleeps for about the time given and learns from how long it took.
+     * \param milliseconds The time to sleep.
+     */
+    void SleepFor(double milliseconds);
+
+    /**
+     * \brief Adds how late one sleep woke up to the overshoot estimate.
+     * \param overshoot Milliseconds past the time asked for.
+     */
+    void LearnOvershoot(double overshoot);
+
+    /**
+     * \brief Lowers the overshoot estimate after a wait it kept from sleeping.
+     */
+    void DecayOvershoot();
+
+    double targetFrameRate = 0.0;
+    Clock::duration period{ 0 };
+    Clock::time_point deadline{};           // When the next frame is due
+    Clock::time_point lastFrameEnd{};
+    bool scheduled = false;                 // False until the first frame after the target changes
+    bool started = false;                   // False until the first frame ends
+    bool interrupted = false;
+    SleepFunction sleepFunction = nullptr;
+
+    // Overshoot average and variance, exponentially weighted so the estimate follows changes in load
+    double overshootMean = 1.0;
+    double overshootVariance = 0.25;
+    static constexpr double OvershootWeight = 0.1;  // About the last 10 sleeps count most
+    static constexpr double MinSpin = 0.1;          // Milliseconds always left for the spin
+    static constexpr double MinSleep = 1.0;         // Milliseconds a wait has to pass up to count as kept from sleeping
+
+    std::array<FrameRecord, HistorySize> history{};
+    size_t historyCount = 0;
+    size_t historyNext = 0;
+    uint64_t missedFrames = 0;
+
+#ifdef _WIN32
+    void* waitableTimer = nullptr;          // High-resolution timer, null where the OS lacks them
+    bool raisedTimerResolution = false;     // timeBeginPeriod(1) was called as the fallback
+#endif // _WIN32
+};
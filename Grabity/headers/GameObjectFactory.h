@@ -108,6 +108,20 @@ public:
      */
     void SerializeAllGameObjects(const std::string& newFileName);
 
+    /**
+     * @brief Serializes all GameObjects and writes only the objects that changed since the
+     *        last save of the file. Falls back to a full save when there is nothing to diff against.
+     * @param newFileName The name of the file to serialize to.
+     */
+    void SaveChangedGameObjects(const std::string& newFileName);
+
+    /**
+     * @brief Serializes all GameObjects through the LuaSceneWriter active for a path.
+     *        Used by SerializeAllGameObjects and by world snapshots, which never write a file.
+     * @param newFileName The path the active LuaSceneWriter was opened with.
+     */
+    void WriteAllGameObjects(const std::string& newFileName);
+
     /**
      * @brief Serializes a GameObject hierarchy, including the parent object and its children, to a specified file.
      * @param newFileName The name of the file to serialize to.
@@ -0,0 +1,34 @@
+/*!****************************************************************
+\file: GameplayEvents.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the gameplay notifications carried by the EventBus.
+        Each event names the frame phase its subscribers hear about
+        it in.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include "EventBus.h"
+#include "GameEventComponent.h"
+
+/**
+ * \brief An enemy that counts towards missions died. Heard once the components have
+ *        updated, so every death of the frame is counted before collision runs.
+ */
+struct EnemyKilledEvent {
+    static constexpr EventBus::Phase phase = EventBus::Phase::AFTER_GAME_OBJECTS;
+
+    EnemyType enemyType = EnemyType::Light;
+    int objectID = -1;
+};
+
+/**
+ * \brief Every mission of the level is complete. Heard at the start of the next frame,
+ *        where the game flow changes scenes.
+ */
+struct MissionsCompletedEvent {
+    static constexpr EventBus::Phase phase = EventBus::Phase::FRAME_START;
+};
@@ -1,8 +1,26 @@
 /*!****************************************************************
 \file: InterruptionHandler.h
 \author: Jeremy Lim Ting Jie, jeremytingjie.lim, 2301370
+\co-author: Goh Jun Jie, g.junjie, 2301293
 \brief: Header file for InterruptionHandler that declares the functions
 
+        In the background the engine saves power. Unfocused, the loop
+        runs at a lower frame rate; minimised, it runs slower still and
+        draws nothing. Whether the game and its audio keep going is a
+        policy read from config.lua, where every key of a table given
+        must be set:
+
+            Background = {
+                Unfocused = { Framerate = 15, Simulation = "Pause",
+                              Audio = "Pause", Minimise = true },
+                Minimised = { Framerate = 5 }
+            }
+
+        Simulation is "Pause" or "Run", Audio is "Pause", "Mute" or
+        "Keep", and Minimise minimises the window when it loses focus.
+        While throttled the loop sleeps in glfwWaitEventsTimeout, so
+        getting focus back wakes it at once.
+
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
 without the prior written consent of DigiPen Institute of
@@ -23,6 +41,32 @@ Technology is prohibited.
  */
 class InterruptionHandler {
 public:
+    /**
+     * @brief How much of the window the player can see.
+     */
+    enum class WindowState {
+        FOCUSED = 0,
+        UNFOCUSED,
+        MINIMISED
+    };
+
+    /**
+     * @brief What the engine keeps doing in the background.
+     */
+    struct BackgroundPolicy {
+        enum class Audio {
+            PAUSE = 0,
+            MUTE,
+            KEEP
+        };
+
+        int unfocusedFrameRate = 15;
+        int minimisedFrameRate = 5;
+        bool pauseSimulation = true;
+        Audio audio = Audio::PAUSE;
+        bool minimiseOnFocusLoss = true;
+    };
+
     /**
      * @brief Initializes the interruption handler and sets GLFW callbacks for window focus and iconification events.
      *
@@ -30,6 +74,34 @@ public:
      */
     static void Init(GLFWwindow* window);
 
+    /**
+     * @brief Replaces the background policy. Takes effect the next time the window leaves the foreground.
+     *
+     * @param policy The policy.
+     */
+    static void SetBackgroundPolicy(const BackgroundPolicy& policy);
+
+    /**
+     * @brief Retrieves the background policy.
+     *
+     * @return The policy.
+     */
+    static const BackgroundPolicy& GetBackgroundPolicy();
+
+    /**
+     * @brief Retrieves whether the window is focused, unfocused or minimised.
+     *
+     * @return The window's state.
+     */
+    static WindowState GetWindowState();
+
+    /**
+     * @brief Checks if the frame should be drawn. Nothing is drawn while minimised.
+     *
+     * @return False while the window is minimised.
+     */
+    static bool ShouldRender();
+
     /**
      * @brief Callback function to handle window focus events.
      *
@@ -84,6 +156,19 @@ public:
      */
     static void RestoreInputState();
 
+private:
+    /**
+     * @brief Reads the background policy from config.lua, keeping the defaults for tables that are not there.
+     */
+    static void LoadBackgroundPolicy();
+
+    /**
+     * @brief Moves the window to a new state, throttling the loop and applying the background policy
+     *        when it leaves the foreground and undoing both when it returns.
+     *
+     * @param state The new state.
+     */
+    static void ChangeWindowState(WindowState state);
 }; 
 // Static variables for tracking the state of audio and window iconification.
 static bool isAudioPaused = false;
@@ -0,0 +1,248 @@
+/*!****************************************************************
+\file: JobSystem.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the JobSystem, the engine's pool of worker threads
+        for spreading frame work over the cores. Each worker owns a
+        deque of jobs: it pushes and pops its own work at the back,
+        and an idle worker steals from the front of another's deque.
+
+        Jobs report to an optional Counter, which is the number of
+        its jobs not yet finished. Waiting on a counter runs other
+        jobs instead of blocking, and a job can be held back until a
+        counter reaches zero. Jobs that touch OpenGL or GLFW are
+        queued for the main thread, which runs them once per frame
+        and while it waits.
+
+        A profiler hook, when set, is told the name, thread and time
+        of every job, which is what the frame timeline is built from.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+    struct Job;
+
+public:
+    enum class Affinity {
+        ANY_THREAD = 0,     // Runs on whichever thread takes it first
+        MAIN_THREAD         // Runs on the thread that called Init, e.g. OpenGL work
+    };
+
+    /**
+     * \brief Counts the jobs of a group that have not finished. Must outlive its jobs.
+     */
+    class Counter {
+    public:
+        /**
+         * \brief Checks if every job counted has finished.
+         * \return True once the count is zero.
+         */
+        bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+        /**
+         * \brief Retrieves the number of jobs that have not finished.
+         * \return The count.
+         */
+        int GetPending() const { return pending.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+        std::atomic<int> pending{ 0 };
+        std::mutex waitingMutex;        // Guards waiting against the count reaching zero
+        std::vector<Job*> waiting;      // Jobs held back until the count is zero
+    };
+
+    /**
+     * \brief When and where one job ran, passed to the profiler hook.
+     */
+    struct JobTiming {
+        const char* name = nullptr;
+        int thread = 0;     // 0 is the main thread, workers count from 1, -1 is any other thread
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    /**
+     * \brief Counters since Init or the last ResetStats.
+     */
+    struct Stats {
+        uint64_t jobs = 0;              // Jobs run
+        uint64_t mainThreadJobs = 0;    // Of those, jobs pinned to the main thread
+        uint64_t steals = 0;            // Jobs taken from another worker's deque
+    };
+
+    /**
+     * \brief Retrieves the job system instance.
+     * \return Reference to the job system.
+     */
+    static JobSystem& GetInstance();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * \brief Starts the worker threads. The calling thread becomes the main thread.
+     * \param workerCount Worker threads to start. 0 uses one less than the hardware threads, at least one.
+     */
+    void Init(unsigned int workerCount = 0);
+
+    /**
+     * \brief Stops the worker threads after the jobs they are running. Jobs still queued are dropped.
+     */
+    void Shutdown();
+
+    /**
+     * \brief Retrieves the number of worker threads.
+     * \return The worker count, 0 before Init.
+     */
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+    /**
+     * \brief Queues a job. Without workers, jobs that may run anywhere run straight away.
+     * \param job The work to do.
+     * \param counter Counted up now and down when the job finishes, may be nullptr.
+     * \param affinity Where the job may run.
+     * \param name Shown by the profiler, must outlive the job.
+     */
+    void Run(std::function<void()> job, Counter* counter = nullptr, Affinity affinity = Affinity::ANY_THREAD, const char* name = "Job");
+
+    /**
+     * \brief Queues a job once every job of another counter has finished.
+     * \param dependency The counter to wait for. It must not be counted up again until the job is queued.
+     * \param job The work to do.
+     * \param counter Counted up now and down when the job finishes, may be nullptr.
+     * \param affinity Where the job may run.
+     * \param name Shown by the profiler, must outlive the job.
+     */
+    void RunAfter(Counter& dependency, std::function<void()> job, Counter* counter = nullptr,
+        Affinity affinity = Affinity::ANY_THREAD, const char* name = "Job");
+
+    /**
+     * \brief Runs other jobs until every job of a counter has finished.
+     * \param counter The counter.
+     */
+    void Wait(Counter& counter);
+
+    /**
+     * \brief Splits an index range into chunks, runs them in parallel and waits for all of them.
+     *        The calling thread runs chunks too.
+     * \param begin The first index.
+     * \param end One past the last index.
+     * \param grain The most indices in one chunk. 0 picks a few chunks per thread.
+     * \param body Called with the first and one past the last index of each chunk.
+     * \param name Shown by the profiler.
+     */
+    void ParallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body, const char* name = "ParallelFor");
+
+    /**
+     * \brief Runs the jobs queued for the main thread. Called once per frame from the main thread.
+     * \return The number of jobs run.
+     */
+    int RunMainThreadJobs();
+
+    /**
+     * \brief Checks if the calling thread is the one that called Init.
+     * \return True on the main thread.
+     */
+    bool IsMainThread() const { return std::this_thread::get_id() == mainThread; }
+
+    /**
+     * \brief Retrieves which thread the caller is, numbered as in JobTiming.
+     * \return 0 on the main thread, 1 and up on workers, -1 on any other thread.
+     */
+    int GetThreadIndex() const;
+
+    /**
+     * \brief Sets the function told about every job as it finishes, or clears it. Only set it while
+     *        no jobs are running; the hook is called from every thread.
+     * \param hook The profiler hook, or nullptr.
+     */
+    void SetProfilerHook(std::function<void(const JobTiming&)> hook);
+
+    /**
+     * \brief Retrieves the counters.
+     * \return A copy of the counters.
+     */
+    Stats GetStats() const;
+
+    /**
+     * \brief Clears the counters.
+     */
+    void ResetStats();
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    /**
+     * \brief One worker's jobs. The owner uses the back, thieves the front.
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job*> jobs;
+    };
+
+    /**
+     * \brief Queues a job that is ready to run.
+     * \param job The job.
+     */
+    void Schedule(Job* job);
+
+    /**
+     * \brief Runs a job, counts its counter down and releases the jobs waiting on it.
+     * \param job The job, deleted afterwards.
+     */
+    void Execute(Job* job);
+
+    /**
+     * \brief Takes a job for the calling thread: its own first, then stolen from the others.
+     * \return The job, or nullptr if every deque is empty.
+     */
+    Job* TakeJob();
+
+    /**
+     * \brief Takes one job queued for the main thread.
+     * \return The job, or nullptr if there is none.
+     */
+    Job* TakeMainThreadJob();
+
+    /**
+     * \brief The loop each worker thread runs until Shutdown.
+     * \param index The worker's index.
+     */
+    void WorkerLoop(unsigned int index);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<unsigned int> nextQueue{ 0 };   // Round-robin queue for jobs from outside the workers
+    std::thread::id mainThread = std::this_thread::get_id();
+
+    std::mutex mainMutex;
+    std::deque<Job*> mainJobs;
+
+    // Idle workers sleep until a job is queued
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<int> queuedJobs{ 0 };
+    std::atomic<int> sleepingWorkers{ 0 };
+    std::atomic<bool> stopping{ false };
+
+    std::function<void(const JobTiming&)> profilerHook;
+    std::atomic<uint64_t> jobsRun{ 0 };
+    std::atomic<uint64_t> mainThreadJobsRun{ 0 };
+    std::atomic<uint64_t> steals{ 0 };
+};
@@ -0,0 +1,125 @@
+/*!****************************************************************
+\file: LuaBytecodeCache.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: On-disk cache of precompiled Lua chunks. Each Lua file can have
+        a ".luac" file next to it holding the output of lua_dump and a
+        hash of the source it was compiled from. Loading a file uses the
+        bytecode while the hash matches and compiles the source (and
+        refreshes the cache) otherwise.
+
+        The cook step compiles every Lua file under a directory ahead of
+        time so that the first run of a build does not pay for parsing.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <cstdint>
+
+#define SOL_ALL_SAFETIES_ON 1
+#include <sol/sol.hpp>
+
+class LuaBytecodeCache {
+public:
+    static constexpr uint32_t Magic = 0x43424C47; // "GLBC"
+    static constexpr uint32_t Version = 1;
+    static constexpr const char* Extension = ".luac";
+
+    /**
+     * \brief Timing of the most recent RunFile call on a thread.
+     */
+    struct LoadStats {
+        std::string filePath;
+        bool fromBytecode = false;  // True if the chunk was loaded from the cache
+        double loadSeconds = 0.0;   // Time spent turning the file into a function
+        double compileSeconds = 0.0; // Time compiling the source took when the cache was written
+    };
+
+    /**
+     * \brief Builds the path of the bytecode file that belongs to a Lua file.
+     * \param luaFilePath The path to the Lua file.
+     * \return The Lua path with its extension replaced by ".luac".
+     */
+    static std::string GetBytecodePath(const std::string& luaFilePath);
+
+    /**
+     * \brief Loads a Lua file into a state, from bytecode if the cache matches the source,
+     *        and executes it. A stale or missing cache is rewritten from the source.
+     * \param lua The state to execute the file in.
+     * \param luaFilePath The path to the Lua file.
+     * \return True if the file was loaded and executed without errors, false otherwise.
+     */
+    static bool RunFile(sol::state& lua, const std::string& luaFilePath);
+
+    /**
+     * \brief Compiles a Lua file and writes its bytecode file, without executing it.
+     * \param luaFilePath The path to the Lua file.
+     * \return True if the bytecode file was written, false otherwise.
+     */
+    static bool Cook(const std::string& luaFilePath);
+
+    /**
+     * \brief Compiles every Lua file in a directory and its sub-directories.
+     * \param directory The directory to cook, e.g. "Assets/Lua".
+     * \return The number of files compiled.
+     */
+    static int CookDirectory(const std::string& directory);
+
+    /**
+     * \brief Retrieves the timing of the most recent RunFile call on this thread.
+     * \return The load statistics. filePath is empty if nothing was loaded since the last clear.
+     */
+    static const LoadStats& GetLastLoadStats() { return lastLoadStats; }
+
+    /**
+     * \brief Forgets the timing of the most recent RunFile call on this thread.
+     */
+    static void ClearLastLoadStats() { lastLoadStats = LoadStats(); }
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t luaVersion;        // LUA_VERSION_NUM, bytecode is not portable across Lua versions
+        uint32_t bytecodeSize;
+        uint64_t sourceHash;        // FNV-1a of the source bytes
+        uint64_t sourceSize;
+        uint64_t compileMicroseconds;
+    };
+
+    static_assert(sizeof(Header) == 40, "Bytecode header layout changed");
+
+    /**
+     * \brief Hashes the bytes of a Lua source file.
+     * \param data The source bytes.
+     * \param size The number of bytes.
+     * \return The 64-bit FNV-1a hash.
+     */
+    static uint64_t HashSource(const char* data, size_t size);
+
+    /**
+     * \brief Compiles source text without executing it.
+     * \param lua The state to compile in.
+     * \param luaFilePath The path to the Lua file, used for the chunk name.
+     * \param source The source text.
+     * \param chunk Receives the compiled function.
+     * \param compileSeconds Receives the time the compilation took.
+     * \return True if the source compiled, false otherwise.
+     */
+    static bool Compile(sol::state& lua, const std::string& luaFilePath, const std::string& source, sol::protected_function& chunk, double& compileSeconds);
+
+    /**
+     * \brief Dumps a compiled chunk and replaces the bytecode file of a Lua file with it.
+     * \param luaFilePath The path to the Lua file.
+     * \param source The source text the chunk was compiled from.
+     * \param chunk The compiled function.
+     * \param compileSeconds The time the compilation took, kept to report the time saved.
+     * \return True if the bytecode file was written, false otherwise.
+     */
+    static bool Store(const std::string& luaFilePath, const std::string& source, const sol::protected_function& chunk, double compileSeconds);
+
+    static thread_local LoadStats lastLoadStats;
+};
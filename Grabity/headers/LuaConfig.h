@@ -20,7 +20,13 @@ Technology is prohibited.
 #include <fstream>
 #include <vector>
 #include <variant>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <filesystem>
+#include "CookedScene.h"
 
 #define SOL_ALL_SAFETIES_ON 1
 #include <sol/sol.hpp>
@@ -32,11 +38,202 @@ namespace LuaUtilities {
     //void LoadSceneFromLua(const std::string& loadFilePath);
 }
 
+/**
+ * \brief Keeps executed Lua files alive between LuaManager instances.
+ *
+ * Config reads, component deserialization, animation controllers and audio lookups
+ * all open short-lived LuaManagers on the same handful of files. The cache keeps one
+ * executed sol::state per path and hands it out again until the file changes on disk
+ * (modification time or size) or is explicitly invalidated by a save.
+ *
+ * sol::state is not thread-safe and startup graph workers and the ScenePreloader read
+ * scenes too, so every thread owns its own cache. Invalidate also bumps a global generation so that the
+ * other threads drop their entries even if the file timestamp did not move.
+ */
+class LuaStateCache {
+public:
+    /**
+     * \brief Retrieves the cache of the calling thread.
+     * \return Reference to the cache.
+     */
+    static LuaStateCache& GetInstance();
+
+    /**
+     * \brief Returns the executed state of a file, running the file only if it is not
+     *        cached yet or has changed since it was cached.
+     * \param luaFilePath The path to the Lua file.
+     * \return Shared pointer to the Lua state. Missing files get a fresh, uncached state.
+     */
+    std::shared_ptr<sol::state> Acquire(const std::string& luaFilePath);
+
+    /**
+     * \brief Drops a file from the caches of all threads. Call after writing the file.
+     * \param luaFilePath The path to the Lua file.
+     */
+    static void Invalidate(const std::string& luaFilePath);
+
+    /**
+     * \brief Drops every cached state of the calling thread.
+     */
+    void Clear();
+
+    /**
+     * \brief Creates a new Lua state with the base library opened and counts it.
+     * \return Shared pointer to the new state.
+     */
+    static std::shared_ptr<sol::state> CreateState();
+
+    /**
+     * \brief Retrieves the number of Lua states created since startup, on all threads.
+     * \return The number of states created.
+     */
+    static unsigned long long GetStatesCreated() { return statesCreated.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Retrieves the number of Acquire calls answered from a cached state, on all threads.
+     * \return The number of cache hits.
+     */
+    static unsigned long long GetCacheHits() { return cacheHits.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Retrieves the number of Acquire calls that had to execute their file, on all threads.
+     * \return The number of cache misses.
+     */
+    static unsigned long long GetCacheMisses() { return cacheMisses.load(std::memory_order_relaxed); }
+
+private:
+    LuaStateCache() = default;
+
+    struct Entry {
+        std::shared_ptr<sol::state> lua;
+        std::filesystem::file_time_type writeTime;
+        std::uintmax_t fileSize = 0;
+        unsigned long long generation = 0;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+
+    static std::atomic<unsigned long long> statesCreated;
+    static std::atomic<unsigned long long> cacheHits;
+    static std::atomic<unsigned long long> cacheMisses;
+    static std::atomic<unsigned long long> generation;
+};
+
+/**
+ * \brief Parses a Lua scene file once and shares the result with every LuaManager
+ *        opened on the same path while the context is alive.
+ *
+ * Scene loading opens one LuaManager per component, and each of those used to create
+ * its own sol::state and execute the whole file again. While a context is active those
+ * LuaManagers reuse its state, and TableExists is answered from a per-object index of
+ * sub-tables built when the file is parsed.
+ *
+ * If the file has an up-to-date cooked image (see CookedScene) the context maps that
+ * instead, and LuaManagers opened on the path read from it without executing any Lua.
+ *
+ * Contexts nest per thread. The innermost context for a path wins.
+ */
+class LuaSceneContext {
+public:
+    /**
+     * \brief Parses the Lua file and indexes the sub-tables of every object table.
+     * \param luaFilePath The path to the Lua file to parse.
+     */
+    explicit LuaSceneContext(const std::string& luaFilePath);
+
+    /**
+     * \brief Serves reads for a path from a cooked image that is already in memory,
+     *        e.g. a world snapshot. Neither the file nor Lua is touched.
+     * \param luaFilePath The path LuaManagers will be opened with.
+     * \param image The cooked image to read from.
+     */
+    LuaSceneContext(const std::string& luaFilePath, std::shared_ptr<const CookedScene> image);
+
+    /**
+     * \brief Removes the context from the active context chain of this thread.
+     */
+    ~LuaSceneContext();
+
+    LuaSceneContext(const LuaSceneContext&) = delete;
+    LuaSceneContext& operator=(const LuaSceneContext&) = delete;
+
+    /**
+     * \brief Finds the innermost active context of this thread for a file.
+     * \param luaFilePath The path to the Lua file.
+     * \return The context, or nullptr if the file is not being loaded through one.
+     */
+    static LuaSceneContext* Find(const std::string& luaFilePath);
+
+    /**
+     * \brief Checks if an object table contains a sub-table, using the pre-built index.
+     * \param objectTable The name of the object table.
+     * \param subTable The name of the sub-table to check.
+     * \return True if the sub-table exists, false otherwise.
+     */
+    bool HasTable(const std::string& objectTable, const std::string& subTable) const;
+
+    /**
+     * \brief Lists the sub-tables of an object table, using the pre-built index.
+     * \param objectTable The name of the object table.
+     * \return The sub-table names. Empty if the object does not exist.
+     */
+    std::vector<std::string> GetTableNames(const std::string& objectTable) const;
+
+    /**
+     * \brief Retrieves the shared Lua state the file was executed in.
+     * \return Shared pointer to the Lua state.
+     */
+    const std::shared_ptr<sol::state>& GetState() const { return lua; }
+
+    /**
+     * \brief Retrieves the cooked image the context was loaded from.
+     * \return The cooked scene, or nullptr if the Lua source was executed.
+     */
+    const CookedScene* GetCookedScene() const { return cooked.get(); }
+
+    /**
+     * \brief Retrieves the path of the parsed file.
+     * \return The file path.
+     */
+    const std::string& GetFilePath() const { return filePath; }
+
+private:
+    std::shared_ptr<sol::state> lua;
+    std::shared_ptr<const CookedScene> cooked;
+    std::string filePath;
+    std::unordered_map<std::string, std::unordered_set<std::string>> subTables; // object table -> sub-table names
+    LuaSceneContext* previous;
+
+    static thread_local LuaSceneContext* active;
+};
+
+class LuaSceneWriter;
+
 class LuaManager {
 public: 
     using LuaValue = std::variant<int, float, double, std::string, bool>;
     using LuaValueContainer = std::vector<LuaValue>;
 
+    /**
+     * \brief How float and double values are written by LuaWrite.
+     */
+    enum class NumberFormat {
+        ROUND_TRIP, // Shortest text that reads back to the same bits (default)
+        FIXED_2     // Two decimals, the format scenes were saved with before
+    };
+
+    /**
+     * \brief Selects how float and double values are written from now on.
+     * \param format The number format to use.
+     */
+    static void SetNumberFormat(NumberFormat format) { numberFormat = format; }
+
+    /**
+     * \brief Retrieves how float and double values are currently written.
+     * \return The number format in use.
+     */
+    static NumberFormat GetNumberFormat() { return numberFormat; }
+
 public:
     LuaManager(const std::string& luaFilePath);
 
@@ -308,16 +505,38 @@ public:
   */
     std::unordered_map<int, std::pair<std::string, int>>  extractNamesWithParentIDs();
 private:
-    sol::state lua;
+    std::shared_ptr<sol::state> luaState; // Shared from an active LuaSceneContext or LuaStateCache
+    sol::state& lua;
     std::string currentLuaFilePath;
     std::vector<std::string> fileContent; 
+    bool fileContentLoaded = false;
+    const CookedScene* cooked = nullptr; // Set while reading through a cooked LuaSceneContext
+    LuaSceneWriter* writer = nullptr;    // Set while a LuaSceneWriter collects writes for the file
+
+    /**
+     * \brief Returns the Lua state of the active LuaSceneContext for a file, or the cached
+     *        state of the file from LuaStateCache.
+     * \param luaFilePath The path to the Lua file.
+     * \return Shared pointer to the Lua state.
+     */
+    static std::shared_ptr<sol::state> AcquireState(const std::string& luaFilePath);
+
+    /**
+     * \brief Reads the file into fileContent the first time it is needed for writing.
+     *        Read-only users never pay for the line-by-line copy of the file.
+     */
+    void LoadFileContent();
 
     /**
      * \brief Determines the Lua type for a value and appends it to the entry string.
      * \param entry The string to which the type information will be appended.
      * \param value The Lua value whose type is to be determined.
      */
-    void FindType(std::string& entry, const LuaValue& value);
+    static void FindType(std::string& entry, const LuaValue& value);
+
+    static NumberFormat numberFormat;
+
+    friend class LuaSceneWriter;
 
     /**
      * \brief Reads the content of a Lua file into a vector of strings.
@@ -342,6 +561,142 @@ private:
  */
 std::string trimWhitespace(const std::string& str);
 
+/**
+ * \brief Collects every LuaManager::LuaWrite made to one file in memory and writes the
+ *        whole file in a single pass on Commit.
+ *
+ * Without a writer each component Serialize opens a LuaManager, which executes the file,
+ * re-reads it, scans it line by line and rewrites it, so saving a scene grows with the
+ * square of its size. While a writer is active on the current thread, LuaManagers opened
+ * on its path skip loading the file and forward LuaWrite here. Commit streams the tables
+ * through a buffered writer into a temporary file and renames it over the target, so an
+ * interrupted save never leaves a half written scene.
+ */
+class LuaSceneWriter {
+public:
+    /**
+     * \brief Starts collecting writes for a file.
+     * \param luaFilePath The path of the Lua file to produce.
+     * \param headerComment The first line of the file.
+     */
+    LuaSceneWriter(const std::string& luaFilePath, const std::string& headerComment = "-- Lua Level file");
+
+    /**
+     * \brief Stops collecting writes. Anything not committed is discarded.
+     */
+    ~LuaSceneWriter();
+
+    LuaSceneWriter(const LuaSceneWriter&) = delete;
+    LuaSceneWriter& operator=(const LuaSceneWriter&) = delete;
+
+    /**
+     * \brief Finds the innermost active writer of this thread for a file.
+     * \param luaFilePath The path to the Lua file.
+     * \return The writer, or nullptr if the file is not being saved through one.
+     */
+    static LuaSceneWriter* Find(const std::string& luaFilePath);
+
+    /**
+     * \brief Records values in a nested table, with the same update-or-add rules as LuaManager::LuaWrite.
+     * \param tableName The name of the main table.
+     * \param values A container of values to write.
+     * \param keys A vector of keys corresponding to the values.
+     * \param nestedTableName The name of the nested table to update or create.
+     */
+    void Write(const std::string& tableName, const LuaManager::LuaValueContainer& values, const std::vector<std::string>& keys, const std::string& nestedTableName);
+
+    /**
+     * \brief Writes all collected tables to the file and replaces it atomically.
+     * \return True if the file was written, false otherwise.
+     */
+    bool Commit();
+
+    /**
+     * \brief Writes only the tables that changed since the last save of this file.
+     *
+     * Every save through a writer remembers a hash of each rendered table. When the file
+     * is still the one that save produced, changed and new tables are appended to it as a
+     * journal and removed tables are assigned nil; Lua runs the file top to bottom, so the
+     * later assignments replace the earlier ones. Once the journal grows past half the size
+     * of the base file, or the file was changed by anything else, a full Commit is done.
+     * \return True if the file is up to date, false otherwise.
+     */
+    bool CommitChanges();
+
+    /**
+     * \brief Retrieves the number of bytes written by the last Commit or CommitChanges.
+     * \return The number of bytes written to the file.
+     */
+    size_t GetBytesWritten() const { return bytesWritten; }
+
+    /**
+     * \brief Retrieves the number of tables written by the last Commit or CommitChanges.
+     * \return The table count, including removed tables written as nil.
+     */
+    size_t GetTablesWritten() const { return tablesWritten; }
+
+    /**
+     * \brief Lays out all collected tables as a cooked image instead of Lua text.
+     * \return The image, ready for CookedScene::LoadFromMemory.
+     */
+    std::vector<unsigned char> BuildCookedImage() const;
+
+private:
+    struct NestedTable {
+        std::string name;
+        std::vector<std::pair<std::string, LuaManager::LuaValue>> entries;
+    };
+
+    struct MainTable {
+        std::string name;
+        std::vector<NestedTable> nestedTables;
+    };
+
+    /**
+     * \brief What the last save through a writer left in a file.
+     */
+    struct SaveState {
+        std::unordered_map<std::string, uint64_t> tableHashes; // Main table name -> hash of its rendered text
+        size_t baseBytes = 0;                                   // Size of the last full Commit
+        size_t journalBytes = 0;                                // Bytes appended by CommitChanges since then
+        std::filesystem::file_time_type writeTime;
+        uintmax_t fileSize = 0;
+    };
+
+    /**
+     * \brief Appends a main table in the layout LuaManager::LuaWrite produces.
+     * \param buffer The text to append to.
+     * \param mainTable The table to render.
+     */
+    static void RenderTable(std::string& buffer, const MainTable& mainTable);
+
+    /**
+     * \brief Hashes the rendered text of a table.
+     * \param text The rendered table.
+     * \return The 64-bit FNV-1a hash.
+     */
+    static uint64_t HashTable(const std::string& text);
+
+    /**
+     * \brief Records the size and modification time the file has after a save.
+     * \param state The save state to update.
+     * \return True if the file could be inspected, false otherwise.
+     */
+    bool StampSaveState(SaveState& state) const;
+
+    std::string filePath;
+    std::string header;
+    std::vector<MainTable> tables;                       // In first-write order
+    std::unordered_map<std::string, size_t> tableLookup; // Main table name -> index in tables
+    size_t bytesWritten = 0;
+    size_t tablesWritten = 0;
+    LuaSceneWriter* previous;
+
+    static thread_local LuaSceneWriter* active;
+    static std::unordered_map<std::string, SaveState> saveStates; // File path -> last save through a writer
+    static std::mutex saveStateMutex;
+};
+
 
 //==============================================DEFINITIONS====================================================
 
@@ -612,6 +967,15 @@ T LuaManager::LuaReadFromSplitting(const std::string& tableName, const std::stri
  */
 template<typename T>
 T LuaManager::LuaRead(const std::string& tableName, const std::vector<std::string>& keys) {
+    if (cooked) {
+        std::optional<T> result = cooked->Read<T>(tableName, keys);
+        if (result) {
+            return result.value();
+        }
+        ImGuiConsole::Cout("Runtime error: Key '%s' not found or invalid type in cooked table '%s'", keys.empty() ? "" : keys.back().c_str(), tableName.c_str());
+        return T();
+    }
+
     try {
         // Start with the base table
         sol::table currentTable = lua[tableName];
@@ -673,6 +1037,12 @@ T LuaManager::LuaRead(const std::string& tableName, const std::vector<std::strin
  * \param nestedTableName The name of the nested table to update or create.
  */
 inline void LuaManager::LuaWrite(const std::string& tableName, const LuaValueContainer& values, const std::vector<std::string>& keys, const std::string& nestedTableName) {
+    if (writer) {
+        writer->Write(tableName, values, keys, nestedTableName);
+        return;
+    }
+
+    LoadFileContent();
     if (fileContent.empty()) {
 		ImGuiConsole::Cout("No Lua file content loaded.");
         return;
@@ -684,43 +1054,50 @@ inline void LuaManager::LuaWrite(const std::string& tableName, const LuaValueCon
     auto nestedTableIt = fileContent.end(); // Position of the nested table
 
     size_t braceCounter = 0; // Counter for curly braces
+    const std::string mainTableStart = tableName + " = {";
+    const std::string mainTableRemoved = tableName + " = nil";
+    const std::string nestedTableStart = nestedTableName + " = {";
 
-    // First pass: Look for the main table
+    // First pass: look for the main table. Lua runs the file top to bottom, so when a
+    // journal appended by LuaSceneWriter::CommitChanges redefines the table, the last
+    // definition is the one that loads and the one to edit
     for (auto it = fileContent.begin(); it != fileContent.end(); ++it) {
-        std::string& line = *it;
-
         // Trim whitespace from the line
-        std::string trimmedLine = trimWhitespace(line);
-
-        // Check for the main table
-        if (trimmedLine.find(tableName + " = {") != std::string::npos) {
-            insideTable = true;
-            mainTableIt = it; // Remember the position of the main table
-            braceCounter++; // Increment for the opening brace
-            //ImGuiConsole::Cout("Found main table: " << tableName); // Debugging line
+        std::string trimmedLine = trimWhitespace(*it);
+
+        if (!insideTable) {
+            if (trimmedLine == mainTableStart) {
+                insideTable = true;
+                insideNestedTable = false;
+                mainTableIt = it; // Remember the position of the main table
+                nestedTableIt = fileContent.end();
+                braceCounter = 0;
+            }
+            else if (trimmedLine == mainTableRemoved) {
+                // Removed by a journal, a write creates it again at the end
+                insideNestedTable = false;
+                mainTableIt = fileContent.end();
+                nestedTableIt = fileContent.end();
+                continue;
+            }
+            else {
+                continue;
+            }
         }
 
-        // If we are inside the main table, check for the nested table
-        if (insideTable) {
-            // Check for existing nested table
-            std::string searchString = nestedTableName + " = {";
-            //ImGuiConsole::Cout("Checking for nested table: " << searchString); // Debugging line
-            if (trimmedLine == searchString) { // Check for exact match
-                insideNestedTable = true;
-                nestedTableIt = it; // Remember the position of the nested table
-                //ImGuiConsole::Cout("Found nested table: " << nestedTableName); // Debugging line
-            }
+        // Check for the nested table, one level inside the main table
+        if (braceCounter == 1 && trimmedLine == nestedTableStart) {
+            insideNestedTable = true;
+            nestedTableIt = it; // Remember the position of the nested table
+        }
 
-            // Update brace counter
-            braceCounter += std::count(trimmedLine.begin(), trimmedLine.end(), '{'); // Count opening braces
-            braceCounter -= std::count(trimmedLine.begin(), trimmedLine.end(), '}'); // Count closing braces
+        // Update brace counter
+        braceCounter += std::count(trimmedLine.begin(), trimmedLine.end(), '{'); // Count opening braces
+        braceCounter -= std::count(trimmedLine.begin(), trimmedLine.end(), '}'); // Count closing braces
 
-            // If the brace counter goes back to zero, we've found the end of the main table
-            if (braceCounter == 0) {
-                insideTable = false; // End of the main table
-                //ImGuiConsole::Cout("End of main table detected for: " << tableName); // Debugging line
-                break; // Exit loop after processing the main table
-            }
+        // If the brace counter goes back to zero, we've found the end of the main table
+        if (braceCounter == 0) {
+            insideTable = false;
         }
     }
 
@@ -746,8 +1123,8 @@ inline void LuaManager::LuaWrite(const std::string& tableName, const LuaValueCon
                         break; // End of the nested table
                     }
 
-                    // Check for existing keys to update
-                    if (entryIt->find(keyName + " = ") != std::string::npos) {
+                    // Check for existing keys to update, "scaleX" must not match "localScaleX"
+                    if (trimWhitespace(*entryIt).rfind(keyName + " = ", 0) == 0) {
                         *entryIt = updatedEntry; // Update existing entry
                         keyFound = true;
                         //ImGuiConsole::Cout("Updated existing entry in nested table: " << updatedEntry); // Debugging line
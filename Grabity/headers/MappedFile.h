@@ -0,0 +1,81 @@
+/*!****************************************************************
+\file: MappedFile.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Read-only memory-mapped view of a file. Used by binary asset
+        formats that are read in place instead of being parsed into
+        separate buffers.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <cstddef>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * \brief Unmaps the file if it is still open.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * \brief Transfers ownership of a mapping.
+     * \param other The mapping to move from. It is left closed.
+     */
+    MappedFile(MappedFile&& other) noexcept;
+
+    /**
+     * \brief Transfers ownership of a mapping, closing the current one first.
+     * \param other The mapping to move from. It is left closed.
+     * \return Reference to this mapping.
+     */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * \brief Maps the whole file read-only.
+     * \param filePath The path of the file to map.
+     * \return True if the file was mapped, false otherwise. Empty files cannot be mapped.
+     */
+    bool Open(const std::string& filePath);
+
+    /**
+     * \brief Unmaps the file and releases its handles.
+     */
+    void Close();
+
+    /**
+     * \brief Checks if a file is currently mapped.
+     * \return True if mapped, false otherwise.
+     */
+    bool IsOpen() const { return data != nullptr; }
+
+    /**
+     * \brief Retrieves the start of the mapped bytes.
+     * \return Pointer to the mapped bytes, or nullptr if not mapped.
+     */
+    const unsigned char* GetData() const { return data; }
+
+    /**
+     * \brief Retrieves the size of the mapping.
+     * \return The size of the mapped file in bytes.
+     */
+    size_t GetSize() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif // _WIN32
+};
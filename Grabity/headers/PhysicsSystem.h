@@ -34,6 +34,15 @@ Technology is prohibited.
  */
 class PhysicsSystem : public System {
 public:
+    /**
+     * @brief Declares that physics moves rigid bodies and their transforms on the active layers.
+     */
+    PhysicsSystem() : System("Physics System") {
+        Reads(Resource::SCENE);
+        Writes(TypeOfComponent::RIGIDBODY);
+        Writes(TypeOfComponent::TRANSFORM);
+    }
+
     void Update() override {
         GameObjectFactory& factory = GameObjectFactory::GetInstance();
         auto gameObjects = factory.GetAllGameObjects();
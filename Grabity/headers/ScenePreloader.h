@@ -0,0 +1,122 @@
+/*!****************************************************************
+\file: ScenePreloader.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Prepares scenes on a background thread before they are loaded.
+        A preload executes the scene's Lua file in a private state (or
+        maps its cooked file), keeps the result as a cooked image in
+        memory and decodes the textures the scene names that are not
+        resident yet. When the scene is loaded later, LoadSceneFromLua
+        takes the image and uploads the decoded pixels instead of
+        parsing and decoding on the main thread.
+
+        Game objects are still created on the main thread when the scene
+        is loaded: components create OpenGL resources and register with
+        the singleton systems when they are deserialized, so there is no
+        second world to build them in and swap.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <memory>
+#include <future>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "CookedScene.h"
+#include "Texture.h"
+
+class ScenePreloader {
+public:
+    struct PreparedScene {
+        std::shared_ptr<const CookedScene> image;
+        std::vector<std::pair<std::string, Texture::DecodedImage>> textures; // Texture name -> pixels
+        std::string error; // Why the preload failed, logged by the main thread
+    };
+
+    /**
+     * \brief Retrieves the preloader instance.
+     * \return Reference to the preloader.
+     */
+    static ScenePreloader& GetInstance();
+
+    ScenePreloader(const ScenePreloader&) = delete;
+    ScenePreloader& operator=(const ScenePreloader&) = delete;
+
+    /**
+     * \brief Waits for any preload that is still running.
+     */
+    ~ScenePreloader();
+
+    /**
+     * \brief Starts preparing a scene on a background thread. Does nothing if the scene
+     *        is already being prepared or is ready. Call from the main thread after the
+     *        textures are registered, since the texture files are looked up here.
+     * \param scenePath The path to the scene's Lua file.
+     */
+    void Preload(const std::string& scenePath);
+
+    /**
+     * \brief Drops the preloads of every scene not in a set, e.g. the buttons of the scene
+     *        that was left. Preloads still running finish in the background and are freed later.
+     * \param scenePaths The scenes that can still be loaded next.
+     */
+    void Retain(const std::unordered_set<std::string>& scenePaths);
+
+    /**
+     * \brief Checks if a scene has been requested and has finished preparing.
+     * \param scenePath The path to the scene's Lua file.
+     * \return True if Take would return without waiting.
+     */
+    bool IsReady(const std::string& scenePath) const;
+
+    /**
+     * \brief Hands over a prepared scene, waiting for it if the preload is still running.
+     *        The scene is forgotten afterwards.
+     * \param scenePath The path to the scene's Lua file.
+     * \return The scene image and decoded textures. The image is nullptr if the scene was
+     *         never requested, failed, or the file changed after the preload started.
+     */
+    PreparedScene Take(const std::string& scenePath);
+
+    /**
+     * \brief Drops every prepared scene, waiting for running preloads first.
+     */
+    void Clear();
+
+private:
+    ScenePreloader() = default;
+
+    struct PendingScene {
+        std::future<PreparedScene> prepared;
+        std::filesystem::file_time_type writeTime;
+    };
+
+    /**
+     * \brief Prepares a scene. Runs on a background thread and never logs, the console
+     *        belongs to the main thread.
+     * \param scenePath The path to the scene's Lua file.
+     * \param texturePaths Files of the registered textures that are not resident, by name.
+     * \return The scene image and decoded textures, or an error.
+     */
+    static PreparedScene Prepare(const std::string& scenePath, const std::unordered_map<std::string, std::string>& texturePaths);
+
+    /**
+     * \brief Frees dropped preloads that have finished.
+     */
+    void ReleaseFinished();
+
+    /**
+     * \brief Reads the write time of a scene file.
+     * \param scenePath The path to the scene's Lua file.
+     * \return The write time, or file_time_type::min() if the file does not exist.
+     */
+    static std::filesystem::file_time_type GetWriteTime(const std::string& scenePath);
+
+    std::unordered_map<std::string, PendingScene> pending; // Only touched by the main thread
+    std::vector<std::future<PreparedScene>> dropped;       // Retained until finished, a std::async future blocks when destroyed
+};
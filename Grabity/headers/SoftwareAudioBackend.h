@@ -0,0 +1,250 @@
+/*!****************************************************************
+\file: SoftwareAudioBackend.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares a software mixer implementation of AudioBackend
+        that needs neither FMOD nor a sound device. Sounds are decoded
+        to float PCM when created, or kept as the WAV's own samples or
+        streamed from the file and converted a block at a time as they
+        play. Channels are resampled to the
+        output rate with linear interpolation and mixed with SSE where
+        available. The mix goes to a sink: nowhere, for running and
+        profiling the game headless, or a 16-bit stereo WAV file.
+
+        Update mixes as much audio as real time has passed. Render
+        mixes an exact number of frames, so tests and benchmarks get
+        the same output on every run.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include "AudioBackend.h"
+#include "StreamingBufferManager.h"
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+
+class SoftwareAudioBackend : public AudioBackend {
+public:
+    enum class Sink {
+        NONE = 0,   // Mix and discard
+        WAV_FILE    // Append the mix to a WAV file
+    };
+
+    /**
+     * @brief Counters of the mixing work done since Init.
+     */
+    struct MixStats {
+        uint64_t frames = 0;            // Output frames mixed
+        uint64_t channelFrames = 0;     // Frames summed over every audible channel
+        uint64_t microseconds = 0;      // Time spent mixing
+    };
+
+    /**
+     * @brief Creates a software mixer.
+     * @param sink Where the mix goes.
+     * @param outputPath The WAV file written by the WAV_FILE sink.
+     * @param sampleRate The output sample rate.
+     */
+    SoftwareAudioBackend(Sink sink = Sink::NONE, const std::string& outputPath = "", int sampleRate = 48000);
+    ~SoftwareAudioBackend() override;
+
+    bool Init(int maxChannels) override;
+    void Release() override;
+    void Update() override;
+    const char* GetName() const override { return sink == Sink::WAV_FILE ? "Software (WAV)" : "Software (null)"; }
+
+    SoundID CreateSound(const void* data, size_t size, bool loop, LoadMode mode) override;
+    SoundID CreateStream(const std::string& path, bool loop) override;
+    void ReleaseSound(SoundID sound) override;
+    SoundMemory GetSoundMemory(SoundID sound) const override;
+
+    ChannelID Play(SoundID sound, bool paused) override;
+    void Stop(ChannelID channel) override;
+    bool IsPlaying(ChannelID channel) const override;
+    SoundID GetSound(ChannelID channel) const override;
+    void SetPaused(ChannelID channel, bool paused) override;
+    bool IsPaused(ChannelID channel) const override;
+    void SetVolume(ChannelID channel, float volume) override;
+    float GetVolume(ChannelID channel) const override;
+    void SetMute(ChannelID channel, bool mute) override;
+    void SetPriority(ChannelID channel, int priority) override;
+    void SetLooping(ChannelID channel, bool loop) override;
+    unsigned int GetPosition(ChannelID channel) const override;
+    void SetPosition(ChannelID channel, unsigned int milliseconds) override;
+    void SetLowPass(ChannelID channel, float cutoff) override;
+    float GetLowPass(ChannelID channel) const override;
+    void FadeTo(ChannelID channel, float target, float seconds, bool stopAtEnd) override;
+    float GetFade(ChannelID channel) const override;
+    int GetChannelsPlaying() const override;
+
+    /**
+     * @brief Mixes an exact number of frames and sends them to the sink.
+     * @param frames The number of stereo frames to mix.
+     * @return The mix, interleaved stereo, valid until the next call.
+     */
+    const std::vector<float>& Render(size_t frames);
+
+    /**
+     * @brief Retrieves the output sample rate.
+     * @return The sample rate in Hz.
+     */
+    int GetSampleRate() const { return sampleRate; }
+
+    /**
+     * @brief Retrieves the mixing counters.
+     * @return A copy of the counters.
+     */
+    MixStats GetMixStats() const { return stats; }
+
+    /**
+     * @brief Decodes a WAV file to interleaved float samples.
+     * @param data The file contents.
+     * @param size The size of the file in bytes.
+     * @param samples Receives the samples.
+     * @param channels Receives the number of channels.
+     * @param sampleRate Receives the sample rate.
+     * @return False if the data is not PCM or float WAV.
+     */
+    static bool DecodeWav(const void* data, size_t size, std::vector<float>& samples, int& channels, int& sampleRate);
+
+private:
+    /**
+     * @brief Where the samples of a WAV file are and how they are stored.
+     */
+    struct WavFormat {
+        int fileChannels = 0;
+        int bits = 0;
+        bool isFloat = false;
+        int sampleRate = 0;
+        size_t dataOffset = 0;          // Offset of the data chunk's samples in the file
+        size_t dataBytes = 0;
+        size_t FrameBytes() const { return static_cast<size_t>(fileChannels) * (bits / 8); }
+    };
+
+    struct Sound {
+        LoadMode mode = LoadMode::DECOMPRESSED;
+        std::vector<float> samples;         // DECOMPRESSED: interleaved, one or two channels
+        std::vector<unsigned char> encoded; // COMPRESSED: the data chunk as stored in the file
+        std::string path;                   // STREAMED: the file, opened again for every channel
+        WavFormat format;
+        int channels = 1;
+        int sampleRate = 48000;
+        size_t frames = 0;
+        bool loop = false;
+    };
+
+    struct Channel {
+        std::shared_ptr<const Sound> sound;     // Kept alive while playing, even if released
+        std::shared_ptr<StreamingBufferManager::Stream> stream;    // Open while a streamed sound plays
+        SoundID soundID = InvalidID;
+        uint64_t position = 0;      // Source frame in 32.32 fixed point, so mixing is repeatable
+        uint64_t step = 0;          // Source frames per output frame in 32.32 fixed point
+        float volume = 1.0f;
+        float lowPassCutoff = LowPassOff;
+        float lowPassState[2] = { 0.0f, 0.0f };
+        float fade = 1.0f;          // Fade gain at the next frame
+        float fadeTarget = 1.0f;
+        float fadeStep = 0.0f;      // Fade gain change per output frame
+        size_t fadeFrames = 0;      // Output frames left in the fade ramp
+        bool stopAtFadeEnd = false;
+        int priority = 128;
+        bool paused = false;
+        bool muted = false;
+        bool loop = false;
+    };
+
+    /**
+     * @brief Resamples one channel into the voice buffer and advances it.
+     * @param channel The channel.
+     * @param frames The number of output frames.
+     * @return False once the channel reached the end of a sound that does not loop.
+     */
+    bool ResampleChannel(Channel& channel, size_t frames);
+
+    /**
+     * @brief Moves a channel's position on without mixing it, for silent channels.
+     * @param channel The channel.
+     * @param frames The number of output frames.
+     * @return False once the channel reached the end of a sound that does not loop.
+     */
+    bool SkipChannel(Channel& channel, size_t frames);
+
+    /**
+     * @brief Retrieves consecutive source frames of a channel's sound as float PCM, wrapping past
+     *        the end of a looping channel and repeating the last frame of one that does not loop.
+     * @param channel The channel.
+     * @param first The first source frame.
+     * @param count The number of frames.
+     * @return The frames, valid until the next call.
+     */
+    const float* FetchFrames(Channel& channel, size_t first, size_t count);
+
+    /**
+     * @brief Converts source frames that lie within the sound to float PCM.
+     * @param channel The channel.
+     * @param first The first source frame.
+     * @param count The number of frames.
+     * @param out Receives the frames.
+     */
+    void DecodeFrames(Channel& channel, size_t first, size_t count, float* out);
+
+    /**
+     * @brief Finds the format and data chunk of a WAV file.
+     * @param data The start of the file.
+     * @param available The bytes of the file in memory from its start.
+     * @param fileSize The size of the whole file.
+     * @param format Receives the format.
+     * @return False if the file is not PCM or float WAV, or its chunks lie beyond the bytes available.
+     */
+    static bool ParseWav(const unsigned char* data, size_t available, size_t fileSize, WavFormat& format);
+
+    /**
+     * @brief Converts WAV samples to interleaved float samples, keeping at most two channels.
+     * @param pcm The first frame.
+     * @param frames The number of frames.
+     * @param format The format of the samples.
+     * @param out Receives frames * outChannels samples.
+     * @param outChannels 1 or 2.
+     */
+    static void ConvertFrames(const unsigned char* pcm, size_t frames, const WavFormat& format, float* out, int outChannels);
+
+    /**
+     * @brief Adds a created sound.
+     * @param sound The sound.
+     * @return Its ID.
+     */
+    SoundID AddSound(std::shared_ptr<Sound> sound);
+    /**
+     * @brief Writes the WAV header, or patches its sizes once the length is known.
+     */
+    void WriteWavHeader();
+
+    Sink sink;
+    std::string outputPath;
+    int sampleRate;
+    int maxChannels = 0;
+
+    mutable std::mutex soundMutex;      // Sounds are created by startup worker threads
+    std::unordered_map<SoundID, std::shared_ptr<const Sound>> sounds;
+    SoundID nextSound = 1;
+
+    std::unordered_map<ChannelID, Channel> channels;
+    ChannelID nextChannel = 1;
+
+    std::vector<float> mixBuffer;
+    std::vector<float> voiceBuffer;
+    std::vector<float> sourceBuffer;            // Source frames converted for the channel being resampled
+    std::vector<unsigned char> streamBuffer;    // Raw samples read from a stream
+    std::vector<int16_t> outputBuffer;
+    std::ofstream wavFile;
+    uint64_t wavFrames = 0;
+
+    std::chrono::steady_clock::time_point lastUpdate;
+    double pendingFrames = 0.0;
+    MixStats stats;
+};
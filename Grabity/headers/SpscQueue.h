@@ -0,0 +1,68 @@
+/*!****************************************************************
+\file: SpscQueue.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the SpscQueue template class, a fixed-capacity ring
+        buffer for one producer thread and one consumer thread. Push
+        and pop never lock or allocate; a full queue rejects the push
+        and leaves the producer to decide what to drop.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <atomic>
+#include <array>
+#include <cstddef>
+
+// SpscQueue class: Lock-free queue between exactly one producer and one consumer
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    bool TryPush(const T& item);    // Producer only: false if the queue is full
+    bool TryPop(T& item);           // Consumer only: false if the queue is empty
+    size_t Size() const;            // Either side; exact only when the other side is idle
+    bool Empty() const { return Size() == 0; }
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+private:
+    // Head and tail on separate cache lines so the two threads do not invalidate each other
+    alignas(64) std::atomic<size_t> head{ 0 };  // Next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> tail{ 0 };  // Next slot to push, written by the producer
+    alignas(64) std::array<T, Capacity> slots{};
+};
+
+//Template definition
+
+// Producer only: copies an item into the queue, false if the queue is full
+template <typename T, size_t Capacity>
+bool SpscQueue<T, Capacity>::TryPush(const T& item) {
+    const size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail - head.load(std::memory_order_acquire) == Capacity) {
+        return false;
+    }
+    slots[currentTail & (Capacity - 1)] = item;
+    tail.store(currentTail + 1, std::memory_order_release);   // Publishes the slot to the consumer
+    return true;
+}
+
+// Consumer only: moves the oldest item out of the queue, false if the queue is empty
+template <typename T, size_t Capacity>
+bool SpscQueue<T, Capacity>::TryPop(T& item) {
+    const size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead == tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    item = slots[currentHead & (Capacity - 1)];
+    head.store(currentHead + 1, std::memory_order_release);   // Hands the slot back to the producer
+    return true;
+}
+
+// Retrieves the number of queued items
+template <typename T, size_t Capacity>
+size_t SpscQueue<T, Capacity>::Size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+}
@@ -0,0 +1,98 @@
+/*!****************************************************************
+\file: StartupGraph.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Runs engine initialisation as a small graph of named tasks.
+        Each task lists the tasks it depends on and starts as soon
+        as they have finished. Tasks that only use the CPU, such as
+        reading Lua files, loading audio or rasterising fonts, run
+        on a pool of worker threads. Tasks that touch OpenGL or GLFW
+        are pinned to the thread that calls Run, which owns the
+        context.
+
+        Every task is timed, so the startup timeline can be printed
+        to see what the first frame is waiting on.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+class StartupGraph {
+public:
+    enum class Affinity {
+        ANY_THREAD = 0,     // May run on a worker thread
+        MAIN_THREAD         // Runs on the thread that calls Run, e.g. OpenGL work
+    };
+
+    /**
+     * \brief When and where one task ran, relative to the start of Run.
+     */
+    struct TaskTiming {
+        std::string name;
+        double startMilliseconds = 0.0;
+        double endMilliseconds = 0.0;
+        int thread = 0;     // 0 is the main thread, workers count from 1
+    };
+
+    /**
+     * \brief Adds a task to the graph.
+     * \param name Unique name of the task, used by dependencies and the report.
+     * \param task The work to do.
+     * \param dependencies Names of tasks that have to finish first. They may be added later.
+     * \param affinity Where the task may run.
+     */
+    void AddTask(const std::string& name, std::function<void()> task,
+        std::vector<std::string> dependencies = {}, Affinity affinity = Affinity::ANY_THREAD);
+
+    /**
+     * \brief Runs every task, in parallel where the dependencies allow it, and returns
+     *        once all have finished. Must be called from the thread that owns the OpenGL context.
+     * \param workerCount Worker threads to start, at least one. 0 uses one less than the hardware threads.
+     * \return False if a dependency is missing or the graph has a cycle, in which case nothing runs.
+     */
+    bool Run(unsigned int workerCount = 0);
+
+    /**
+     * \brief Retrieves the timeline of the last Run, in the order the tasks started.
+     * \return The task timings.
+     */
+    const std::vector<TaskTiming>& GetTimeline() const { return timeline; }
+
+    /**
+     * \brief Retrieves how long the last Run took from start to finish.
+     * \return The wall time in milliseconds.
+     */
+    double GetTotalMilliseconds() const { return totalMilliseconds; }
+
+    /**
+     * \brief Prints the timeline of the last Run to the console.
+     * \param title Printed above the timeline.
+     */
+    void Report(const char* title) const;
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> work;
+        std::vector<std::string> dependencyNames;
+        Affinity affinity = Affinity::ANY_THREAD;
+        std::vector<size_t> dependents;     // Tasks waiting on this one
+        int remainingDependencies = 0;
+        TaskTiming timing;
+    };
+
+    /**
+     * \brief Resolves dependency names and checks that every task can eventually run.
+     * \return True if the graph is complete and acyclic, false otherwise.
+     */
+    bool Resolve();
+
+    std::vector<Task> tasks;
+    std::vector<TaskTiming> timeline;
+    double totalMilliseconds = 0.0;
+};
@@ -0,0 +1,152 @@
+/*!****************************************************************
+\file: StreamingBufferManager.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Serves the audio backends the files of streamed sounds a
+        little at a time instead of loading them whole. Loose files
+        stay open and are read through one fixed-size buffer per
+        stream; files stored uncompressed in the asset pack are read
+        straight from its mapping, so only the pages being played are
+        brought in from disk. Buffers come from a small pool that is
+        reused as streams close.
+
+        Streams are opened, read and closed from FMOD's stream thread
+        as well as the main thread. Each stream is only used by one
+        thread at a time.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+
+class StreamingBufferManager {
+public:
+    /**
+     * \brief One open file. Opaque outside the manager.
+     */
+    class Stream;
+
+    /**
+     * \brief Counters since startup or the last ResetStats, and the current buffer use.
+     */
+    struct Stats {
+        int openStreams = 0;
+        int peakStreams = 0;
+        size_t bufferBytes = 0;         // Memory held by the buffer pool, in use or free
+        uint64_t bytesRead = 0;         // Bytes handed to the backends
+        uint64_t diskBytes = 0;         // Bytes read from loose files to refill buffers
+        uint64_t refills = 0;           // Buffer refills, each one a file read
+    };
+
+    /**
+     * \brief Retrieves the streaming buffer manager instance.
+     * \return Reference to the manager.
+     */
+    static StreamingBufferManager& GetInstance();
+
+    StreamingBufferManager(const StreamingBufferManager&) = delete;
+    StreamingBufferManager& operator=(const StreamingBufferManager&) = delete;
+
+    /**
+     * \brief Opens a file for streaming, from the mounted pack or from disk.
+     * \param path The path of the file.
+     * \return The stream, or nullptr if the file does not exist.
+     */
+    Stream* Open(const std::string& path);
+
+    /**
+     * \brief Closes a stream and returns its buffer to the pool.
+     * \param stream The stream. nullptr is ignored.
+     */
+    void Close(Stream* stream);
+
+    /**
+     * \brief Opens a stream that closes itself when the last copy of the pointer goes.
+     * \param path The path of the file.
+     * \return The stream, or nullptr if the file does not exist.
+     */
+    std::shared_ptr<Stream> OpenShared(const std::string& path);
+
+    /**
+     * \brief Retrieves the size of a stream's file.
+     * \param stream The stream.
+     * \return The size in bytes.
+     */
+    uint64_t GetSize(const Stream* stream) const;
+
+    /**
+     * \brief Reads from the stream's position and advances it.
+     * \param stream The stream.
+     * \param destination Receives the bytes.
+     * \param bytes The number of bytes wanted.
+     * \return The number of bytes read, less than wanted only at the end of the file.
+     */
+    size_t Read(Stream* stream, void* destination, size_t bytes);
+
+    /**
+     * \brief Moves the stream's position.
+     * \param stream The stream.
+     * \param position The position in bytes from the start of the file.
+     * \return False if the position is past the end of the file.
+     */
+    bool Seek(Stream* stream, uint64_t position);
+
+    /**
+     * \brief Sets the size of the buffer each loose-file stream reads through. Only affects
+     *        buffers allocated afterwards.
+     * \param bytes The buffer size in bytes.
+     */
+    void SetBufferSize(size_t bytes);
+
+    /**
+     * \brief Retrieves the counters.
+     * \return A copy of the counters.
+     */
+    Stats GetStats() const;
+
+    /**
+     * \brief Clears the read counters and the peak stream count.
+     */
+    void ResetStats();
+
+private:
+    StreamingBufferManager() = default;
+    ~StreamingBufferManager();
+
+    /**
+     * \brief Takes a buffer from the pool, allocating one if the pool is empty.
+     * \return The buffer.
+     */
+    std::vector<unsigned char> AcquireBuffer();
+
+    mutable std::mutex poolMutex;   // Guards the pool and the stream counts
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    size_t bufferSize = 64 * 1024;
+    size_t pooledBytes = 0;
+    int openStreams = 0;
+    int peakStreams = 0;
+
+    std::atomic<uint64_t> bytesRead{ 0 };
+    std::atomic<uint64_t> diskBytes{ 0 };
+    std::atomic<uint64_t> refills{ 0 };
+};
+
+class StreamingBufferManager::Stream {
+    friend class StreamingBufferManager;
+
+    const unsigned char* mapped = nullptr;  // Start of the file in the pack mapping, if stored there
+    std::ifstream file;                     // Loose file, kept open while streaming
+    std::vector<unsigned char> buffer;      // Read-ahead for loose files
+    uint64_t bufferStart = 0;               // File offset of buffer[0]
+    size_t bufferFilled = 0;
+    uint64_t size = 0;
+    uint64_t position = 0;
+};
@@ -1,7 +1,11 @@
 /*!****************************************************************
 \file:      System.h
 \author:    Lee Yu Jie Brandon, l.yujiebrandon, 2301232
+\co-author: Goh Jun Jie, g.junjie, 2301293
 \brief:     Defines the abstract base class for systems in the engine.
+            Each system declares the component types and the shared
+            engine state it reads and writes, which is what the
+            SystemScheduler orders and overlaps systems by.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -9,16 +13,56 @@ without the prior written consent of DigiPen Institute of
 Technology is prohibited.
 *******************************************************************!*/
 #pragma once
+#include "Component.h"
+#include <bitset>
 
 /**
  * @class System
  * @brief Abstract base class for all engine systems.
  *
- * Systems in the engine perform specific tasks like updating physics. 
- * Each derived class must implement the `Update` function to define its behavior.
+ * Systems in the engine perform specific tasks like updating physics.
+ * Each derived class must implement the `Update` function to define its behavior,
+ * and declares in its constructor what it reads and writes.
  */
 class System {
 public:
+    /**
+     * @brief Engine state shared between systems that is not a component.
+     */
+    enum class Resource {
+        SCENE = 0,      // The set of game objects and layers. Writing it creates, destroys or loads objects
+        AUDIO,          // The AudioManager and its channels
+        CAMERA,         // The CameraManager's cameras
+        EVENTS,         // The EventSystem and its win condition
+        GAME_STATE,     // Engine flags such as pause, the timer and the cursor
+        COUNT
+    };
+
+    /**
+     * @brief What a system reads and writes. Two systems conflict, and so never run at the
+     *        same time, if either writes something the other reads or writes.
+     */
+    struct Access {
+        std::bitset<64> readComponents;     // One bit per TypeOfComponent
+        std::bitset<64> writeComponents;
+        std::bitset<static_cast<size_t>(Resource::COUNT)> readResources;
+        std::bitset<static_cast<size_t>(Resource::COUNT)> writeResources;
+        bool mainThread = false;            // Calls OpenGL or GLFW, so only runs on the main thread
+
+        /**
+         * @brief Checks if two systems may not run at the same time.
+         * @param other The other system's access.
+         * @return True if either writes what the other touches.
+         */
+        bool ConflictsWith(const Access& other) const {
+            return (writeComponents & (other.readComponents | other.writeComponents)).any()
+                || (other.writeComponents & readComponents).any()
+                || (writeResources & (other.readResources | other.writeResources)).any()
+                || (other.writeResources & readResources).any();
+        }
+    };
+
+    virtual ~System() = default;
 
     /**
      * @brief Updates the system's behavior.
@@ -27,5 +71,73 @@ public:
      * system-specific updates.
      */
     virtual void Update() = 0;
+
+    /**
+     * @brief Retrieves the name shown in the logs and the frame timeline.
+     * @return The name.
+     */
+    const char* GetName() const { return name; }
+
+    /**
+     * @brief Retrieves what the system reads and writes.
+     * @return The access.
+     */
+    const Access& GetAccess() const { return access; }
+
+protected:
+    /**
+     * @brief Creates a system that reads and writes nothing until it declares otherwise.
+     * @param systemName The name, which must outlive the system.
+     */
+    explicit System(const char* systemName = "System") : name(systemName) {}
+
+    /**
+     * @brief Declares that the system reads a component type.
+     * @param type The component type.
+     */
+    void Reads(TypeOfComponent type) { access.readComponents.set(static_cast<size_t>(type)); }
+
+    /**
+     * @brief Declares that the system writes a component type. Writing implies reading.
+     * @param type The component type.
+     */
+    void Writes(TypeOfComponent type) {
+        access.readComponents.set(static_cast<size_t>(type));
+        access.writeComponents.set(static_cast<size_t>(type));
+    }
+
+    /**
+     * @brief Declares that the system reads shared engine state.
+     * @param resource The state.
+     */
+    void Reads(Resource resource) { access.readResources.set(static_cast<size_t>(resource)); }
+
+    /**
+     * @brief Declares that the system writes shared engine state. Writing implies reading.
+     * @param resource The state.
+     */
+    void Writes(Resource resource) {
+        access.readResources.set(static_cast<size_t>(resource));
+        access.writeResources.set(static_cast<size_t>(resource));
+    }
+
+    /**
+     * @brief Declares that the system writes every component type and all shared state,
+     *        for systems that run arbitrary game code.
+     */
+    void WritesEverything() {
+        access.readComponents.set();
+        access.writeComponents.set();
+        access.readResources.set();
+        access.writeResources.set();
+    }
+
+    /**
+     * @brief Declares that the system calls OpenGL or GLFW and has to run on the main thread.
+     */
+    void RunsOnMainThread() { access.mainThread = true; }
+
 private:
+    const char* name;
+    Access access;
 };
@@ -0,0 +1,172 @@
+/*!****************************************************************
+\file: SystemScheduler.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the SystemScheduler, which runs the engine's
+        per-frame systems. Systems are added in the order the frame
+        used to run them in. Every frame the scheduler builds a
+        dependency graph from what each system declared it reads and
+        writes: a system waits for every earlier system it conflicts
+        with, and systems that do not conflict run at the same time
+        on the JobSystem's workers. Systems that call OpenGL or GLFW
+        stay on the main thread.
+
+        Serial mode runs the systems one after another on the main
+        thread in the order they were added, for debugging and for
+        comparing against the parallel schedule. It is switched on
+        from the editor or with Systems = { Scheduler = { Serial =
+        true } } in config.lua.
+
+        The start, end and thread of every system in the last frame
+        are kept for the editor's frame timeline.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include "System.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief A system made from a function, for frame stages that are not classes of their own.
+ *        Whoever creates it declares what the function reads and writes.
+ */
+class FunctionSystem : public System {
+public:
+    /**
+     * \brief Creates the system.
+     * \param systemName The name, which must outlive the system.
+     * \param function Called once per frame.
+     */
+    FunctionSystem(const char* systemName, std::function<void()> function)
+        : System(systemName), update(std::move(function)) {}
+
+    void Update() override { update(); }
+
+    using System::Reads;
+    using System::Writes;
+    using System::WritesEverything;
+    using System::RunsOnMainThread;
+
+private:
+    std::function<void()> update;
+};
+
+class SystemScheduler {
+public:
+    /**
+     * \brief When and where one system ran in the last frame.
+     */
+    struct SystemTiming {
+        const char* name = nullptr;
+        int thread = 0;                     // Numbered as in JobSystem::JobTiming
+        double start = 0.0;                 // Milliseconds after the frame's systems started
+        double end = 0.0;
+        std::vector<size_t> dependencies;   // Earlier systems it conflicts with and waited for
+    };
+
+    /**
+     * \brief Retrieves the scheduler instance.
+     * \return Reference to the scheduler.
+     */
+    static SystemScheduler& GetInstance();
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    /**
+     * \brief Adds a system the caller keeps alive. Systems run in the order they are added
+     *        wherever they conflict.
+     * \param system The system.
+     */
+    void Add(System& system);
+
+    /**
+     * \brief Adds a system the scheduler owns.
+     * \param system The system.
+     * \return The system.
+     */
+    System& Add(std::unique_ptr<System> system);
+
+    /**
+     * \brief Removes every system.
+     */
+    void Clear();
+
+    /**
+     * \brief Runs every system once and returns when all of them have finished.
+     *        Called from the main thread.
+     */
+    void Run();
+
+    /**
+     * \brief Switches between the parallel schedule and running the systems one after
+     *        another on the main thread in the order they were added.
+     * \param enable True for serial mode.
+     */
+    void SetSerial(bool enable) { serial = enable; }
+
+    /**
+     * \brief Checks if the systems run one after another.
+     * \return True in serial mode.
+     */
+    bool IsSerial() const { return serial; }
+
+    /**
+     * \brief Retrieves the timings of the last frame, one per system in the order they were added.
+     * \return The timings.
+     */
+    const std::vector<SystemTiming>& GetTimeline() const { return timeline; }
+
+    /**
+     * \brief Retrieves how long all the systems took together in the last frame.
+     * \return The time in milliseconds from the first system starting to the last finishing.
+     */
+    double GetFrameTime() const { return frameTime; }
+
+    /**
+     * \brief Checks if the last frame ran in serial mode.
+     * \return True if it did.
+     */
+    bool WasSerial() const { return lastSerial; }
+
+private:
+    SystemScheduler() = default;
+    ~SystemScheduler() = default;
+
+    /**
+     * \brief Finds the earlier systems each system conflicts with.
+     */
+    void BuildGraph();
+
+    /**
+     * \brief Runs one system and records its timing.
+     * \param index The system's index.
+     */
+    void UpdateSystem(size_t index);
+
+    /**
+     * \brief Queues a system whose dependencies have finished.
+     * \param index The system's index.
+     */
+    void Queue(size_t index);
+
+    std::vector<System*> systems;
+    std::vector<std::unique_ptr<System>> ownedSystems;
+
+    std::vector<std::vector<size_t>> dependents;        // Later systems waiting on each system
+    std::unique_ptr<std::atomic<int>[]> remaining;      // Dependencies each system still waits for
+    JobSystem::Counter* frameCounter = nullptr;         // Counts this frame's systems, set while Run waits
+
+    std::vector<SystemTiming> timeline;
+    std::chrono::steady_clock::time_point frameStart;
+    double frameTime = 0.0;
+    bool serial = false;
+    bool lastSerial = false;
+};
@@ -14,18 +14,34 @@ Technology is prohibited.
 #pragma once
 
 #include <string>
+#include <memory>
 
 class Texture
 {
 public:
+    // RGBA8 pixels decoded from an image file, flipped for OpenGL. Decoding needs no GL
+    // context, so it can run on a worker thread and be uploaded on the main thread later
+    struct PixelDeleter { void operator()(unsigned char* pixels) const; };
+    struct DecodedImage
+    {
+        std::unique_ptr<unsigned char, PixelDeleter> pixels;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Decodes an image file from the asset pack or disk; safe to call from any thread
+    static bool Decode(const std::string& path, DecodedImage& image);
+
     // Constructors & Destructor
     Texture();
     Texture(std::string codename, const std::string& path, float numFrameX = 1, float numFrameY = 1, float numframePS = 1);
+    Texture(std::string codename, const std::string& path, const DecodedImage& image, float numFrameX = 1, float numFrameY = 1, float numframePS = 1);
     Texture(const Texture& texture);
     ~Texture();
 
     // Texture Operations
     void Init(const std::string& path);
+    void Upload(const DecodedImage& image); // Replaces the pixels of this texture in place
     void Bind(unsigned int slot = 0) const;
     void Unbind() const;
 
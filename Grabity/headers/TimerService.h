@@ -0,0 +1,266 @@
+/*!****************************************************************
+\file: TimerService.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Declares the TimerService, the engine's one place for timed
+        actions such as despawns. Time is counted in ticks of the
+        fixed step and timers live in a hierarchical timing wheel:
+        four levels of 256 slots, each level covering 256 times the
+        span of the one below. A timer goes into the slot its expiry
+        falls in at the lowest level that reaches that far, and is
+        moved down a level when the level below wraps around to it.
+        Scheduling and cancelling are constant time, and a tick only
+        looks at the one slot that expires and, every 256 ticks, the
+        slot that cascades; timers that are far off cost nothing.
+
+        A timer either calls its own function or carries a number to
+        a channel. A channel is one callback registered for a kind of
+        timer; every timer of the channel that expires in a tick is
+        handed to it together, so e.g. all the despawns of a tick are
+        one call.
+
+        Timers are only touched from the main thread.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class TimerService {
+public:
+    using ChannelID = uint32_t;
+    using BatchCallback = std::function<void(const std::vector<uint64_t>& payloads)>;
+    static constexpr ChannelID NoChannel = UINT32_MAX;
+
+    /**
+     * \brief Refers to one scheduled timer. Stays safe to use after the timer expired or was
+     *        cancelled, when it simply refers to nothing.
+     */
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    /**
+     * \brief Counters since startup or the last ResetStats, and the current timers.
+     */
+    struct Stats {
+        size_t pending = 0;         // Timers waiting to expire
+        uint64_t scheduled = 0;
+        uint64_t cancelled = 0;
+        uint64_t expired = 0;
+        uint64_t cascaded = 0;      // Times a timer was moved down a level
+        uint64_t batches = 0;       // Channel callbacks made
+    };
+
+    /**
+     * \brief Retrieves the timer service instance.
+     * \return Reference to the timer service.
+     */
+    static TimerService& GetInstance();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * \brief Sets the length of one tick. Timers already scheduled keep their tick.
+     * \param seconds The fixed step in seconds.
+     */
+    void SetTickLength(double seconds);
+
+    /**
+     * \brief Retrieves the length of one tick.
+     * \return The fixed step in seconds.
+     */
+    double GetTickLength() const { return tickLength; }
+
+    /**
+     * \brief Registers a callback for a kind of timer.
+     * \param name Shown in the editor.
+     * \param callback Called with the payloads of every timer of the channel that expired in a tick.
+     * \return The channel.
+     */
+    ChannelID RegisterChannel(const std::string& name, BatchCallback callback);
+
+    /**
+     * \brief Schedules a timer that hands a payload to a channel.
+     * \param delay Seconds from now, rounded up to whole ticks, at least one.
+     * \param channel The channel.
+     * \param payload Passed to the channel's callback.
+     * \return The timer's handle.
+     */
+    Handle Schedule(double delay, ChannelID channel, uint64_t payload);
+
+    /**
+     * \brief Schedules a timer that calls a function.
+     * \param delay Seconds from now, rounded up to whole ticks, at least one.
+     * \param action Called when the timer expires.
+     * \return The timer's handle.
+     */
+    Handle Schedule(double delay, std::function<void()> action);
+
+    /**
+     * \brief Schedules a timer that hands a payload to a channel, in ticks.
+     * \param ticks Ticks from now, at least one.
+     * \param channel The channel.
+     * \param payload Passed to the channel's callback.
+     * \return The timer's handle.
+     */
+    Handle ScheduleTicks(uint64_t ticks, ChannelID channel, uint64_t payload);
+
+    /**
+     * \brief Stops a timer from expiring. A timer that already expired in the tick being
+     *        dispatched still reaches its callback.
+     * \param handle The timer. Cleared so it refers to nothing.
+     * \return True if the timer was pending.
+     */
+    bool Cancel(Handle& handle);
+
+    /**
+     * \brief Cancels every timer of a channel.
+     * \param channel The channel.
+     * \return The number of timers cancelled.
+     */
+    size_t CancelChannel(ChannelID channel);
+
+    /**
+     * \brief Checks if a timer has yet to expire.
+     * \param handle The timer.
+     * \return True while it is pending.
+     */
+    bool IsPending(Handle handle) const;
+
+    /**
+     * \brief Retrieves the time left on a timer.
+     * \param handle The timer.
+     * \return Seconds until it expires, 0 if it is not pending.
+     */
+    double GetRemaining(Handle handle) const;
+
+    /**
+     * \brief Moves time on and expires the timers that are due, one tick at a time.
+     * \param ticks The number of ticks, normally the frame's fixed steps.
+     */
+    void Advance(int ticks);
+
+    /**
+     * \brief Retrieves the number of ticks since startup.
+     * \return The tick count.
+     */
+    uint64_t GetTick() const { return currentTick; }
+
+    /**
+     * \brief Retrieves the name of a channel.
+     * \param channel The channel.
+     * \return The name, empty for an unknown channel.
+     */
+    const std::string& GetChannelName(ChannelID channel) const;
+
+    /**
+     * \brief Retrieves the counters.
+     * \return A copy of the counters.
+     */
+    Stats GetStats() const;
+
+    /**
+     * \brief Clears the counters.
+     */
+    void ResetStats();
+
+private:
+    static constexpr int LevelBits = 8;
+    static constexpr uint32_t SlotsPerLevel = 1u << LevelBits;
+    static constexpr int Levels = 4;
+    static constexpr uint32_t None = UINT32_MAX;
+
+    /**
+     * \brief One timer. Free timers are chained through next.
+     */
+    struct Timer {
+        uint64_t expires = 0;
+        uint64_t payload = 0;
+        std::function<void()> action;
+        ChannelID channel = NoChannel;
+        uint32_t prev = None;
+        uint32_t next = None;
+        uint32_t slot = None;       // Index into slots, None while the timer is free
+        uint32_t generation = 0;
+    };
+
+    /**
+     * \brief The timers in one slot, oldest first.
+     */
+    struct Slot {
+        uint32_t head = None;
+        uint32_t tail = None;
+    };
+
+    /**
+     * \brief A registered channel and the payloads expiring for it this tick.
+     */
+    struct Channel {
+        std::string name;
+        BatchCallback callback;
+        std::vector<uint64_t> batch;
+    };
+
+    TimerService() = default;
+    ~TimerService() = default;
+
+    /**
+     * \brief Takes a free timer and sets its expiry.
+     * \param ticks Ticks from now, at least one.
+     * \return The timer's index.
+     */
+    uint32_t Allocate(uint64_t ticks);
+
+    /**
+     * \brief Returns a timer to the free list, which invalidates its handles.
+     * \param index The timer.
+     */
+    void Release(uint32_t index);
+
+    /**
+     * \brief Puts a timer in the slot for its expiry.
+     * \param index The timer.
+     * \param atFront Put it before the timers already in the slot instead of after them.
+     */
+    void Insert(uint32_t index, bool atFront = false);
+
+    /**
+     * \brief Takes a timer out of its slot.
+     * \param index The timer.
+     */
+    void Unlink(uint32_t index);
+
+    /**
+     * \brief Moves the timers of an upper-level slot down to the levels below.
+     * \param level The level.
+     * \param slot The slot within the level.
+     */
+    void Cascade(int level, uint32_t slot);
+
+    /**
+     * \brief Converts a delay to ticks.
+     * \param delay Seconds.
+     * \return Ticks, at least one.
+     */
+    uint64_t ToTicks(double delay) const;
+
+    std::vector<Timer> timers;
+    uint32_t freeList = None;
+    Slot slots[Levels * SlotsPerLevel];
+    uint64_t currentTick = 0;
+    double tickLength = 1.0 / 60.0;
+
+    std::vector<Channel> channels;
+    std::vector<uint32_t> expiring;                 // Timers of the tick being dispatched
+    std::vector<std::function<void()>> actions;     // Their functions, moved out before release
+
+    Stats stats;
+};
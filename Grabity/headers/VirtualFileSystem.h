@@ -0,0 +1,186 @@
+/*!****************************************************************
+\file: VirtualFileSystem.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: One place for asset loaders to read files from. A path is
+        looked up in the mounted asset pack first and read from disk
+        otherwise, so the same loader code works with loose files in
+        the editor and with Assets.pak in a shipped build.
+
+        Every read is counted, which gives the file count, bytes and
+        time spent on file I/O during startup in either mode.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "AssetPack.h"
+
+/**
+ * \brief The bytes of one file. Either points into the mounted pack or owns a
+ *        decompressed or loose copy, and stays valid while it lives.
+ */
+class VirtualFile {
+public:
+    VirtualFile() = default;
+    VirtualFile(VirtualFile&&) noexcept = default;
+    VirtualFile& operator=(VirtualFile&&) noexcept = default;
+    VirtualFile(const VirtualFile&) = delete;
+    VirtualFile& operator=(const VirtualFile&) = delete;
+
+    /**
+     * \brief Checks if the file was found and read.
+     * \return True if the file is valid, false otherwise.
+     */
+    bool IsValid() const { return valid; }
+    explicit operator bool() const { return valid; }
+
+    /**
+     * \brief Retrieves the bytes of the file.
+     * \return Pointer to the bytes. May be nullptr for an empty file.
+     */
+    const unsigned char* GetData() const { return data; }
+
+    /**
+     * \brief Retrieves the size of the file.
+     * \return The size in bytes.
+     */
+    size_t GetSize() const { return size; }
+
+    /**
+     * \brief Checks if the file was read from the mounted pack.
+     * \return True if packed, false if loose.
+     */
+    bool IsPacked() const { return packed; }
+
+    /**
+     * \brief Copies the bytes of the file into a string, for text parsers.
+     * \return The content of the file.
+     */
+    std::string ToString() const { return std::string(reinterpret_cast<const char*>(data), size); }
+
+private:
+    friend class VirtualFileSystem;
+
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    bool valid = false;
+    bool packed = false;
+    std::vector<unsigned char> buffer;  // Decompressed pack entry or loose file
+};
+
+class VirtualFileSystem {
+public:
+    /**
+     * \brief File I/O counted since startup or the last ResetStats.
+     */
+    struct Stats {
+        uint64_t files = 0;
+        uint64_t bytes = 0;
+        uint64_t microseconds = 0;
+        uint64_t packedFiles = 0;
+    };
+
+    /**
+     * \brief Retrieves the virtual file system instance.
+     * \return Reference to the virtual file system.
+     */
+    static VirtualFileSystem& GetInstance();
+
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    /**
+     * \brief Mounts an asset pack. Files in it take precedence over loose files.
+     *        Mount before any asset is loaded and do not remount while loaders are running.
+     * \param packPath The path of the pack, e.g. "Assets.pak".
+     * \return True if the pack was mounted, false if it is missing or invalid.
+     */
+    bool Mount(const std::string& packPath);
+
+    /**
+     * \brief Unmounts the asset pack. Files are read from disk afterwards.
+     */
+    void Unmount();
+
+    /**
+     * \brief Checks if an asset pack is mounted.
+     * \return True if mounted, false otherwise.
+     */
+    bool IsMounted() const { return pack.IsOpen(); }
+
+    /**
+     * \brief Reads a file from the mounted pack or from disk.
+     * \param path The path of the file, e.g. "Assets/Textures/Player.png".
+     * \return The file. Check IsValid before using it.
+     */
+    VirtualFile Open(const std::string& path);
+
+    /**
+     * \brief Checks if a file is in the mounted pack.
+     * \param path The path of the file.
+     * \return True if packed, false otherwise.
+     */
+    bool IsPacked(const std::string& path) const;
+
+    /**
+     * \brief Checks if a file can be opened from the pack or from disk.
+     * \param path The path of the file.
+     * \return True if it exists, false otherwise.
+     */
+    bool Exists(const std::string& path) const;
+
+    /**
+     * \brief Retrieves the original size of a packed file.
+     * \param path The path of the file.
+     * \param size Receives the size.
+     * \return True if the file is in the mounted pack, false otherwise.
+     */
+    bool GetPackedSize(const std::string& path, uint64_t& size) const;
+
+    /**
+     * \brief Retrieves a packed file that is stored uncompressed, as a range of the mapping.
+     *        Nothing is read; pages come in from disk as the range is touched, which is what
+     *        streaming wants.
+     * \param path The path of the file.
+     * \param data Receives the start of the file in the mapping.
+     * \param size Receives the size.
+     * \return True if the file is in the mounted pack and stored uncompressed, false otherwise.
+     */
+    bool FindStored(const std::string& path, const unsigned char*& data, uint64_t& size) const;
+
+    /**
+     * \brief Retrieves the I/O counted so far.
+     * \return A copy of the counters.
+     */
+    Stats GetStats() const;
+
+    /**
+     * \brief Clears the I/O counters.
+     */
+    void ResetStats();
+
+private:
+    VirtualFileSystem() = default;
+
+    /**
+     * \brief Adds one read to the counters.
+     * \param bytes The size of the file.
+     * \param microseconds The time spent reading it.
+     * \param packed True if read from the pack.
+     */
+    void Record(uint64_t bytes, uint64_t microseconds, bool packed);
+
+    AssetPack pack;
+
+    // Loaders run on the startup and preload threads as well as the main thread
+    std::atomic<uint64_t> fileCount{ 0 };
+    std::atomic<uint64_t> byteCount{ 0 };
+    std::atomic<uint64_t> microsecondCount{ 0 };
+    std::atomic<uint64_t> packedCount{ 0 };
+};
@@ -0,0 +1,195 @@
+/*!****************************************************************
+\file: VoiceManager.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Decides which sound effect voices may play. Every play
+        request is checked against the sound's retrigger cooldown and
+        its maximum number of instances, stealing an existing voice
+        or rejecting the new one when the limit is reached. Of the
+        voices that are playing, only the most important and audible
+        ones stay real; the rest are made virtual so they keep their
+        place in the sound but cost nothing to mix.
+
+        The manager only keeps book, it never talks to FMOD. The
+        AudioManager applies its decisions to channels, which also
+        lets it run against no audio device at all.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+class VoiceManager {
+public:
+    using VoiceHandle = uint32_t;
+    static constexpr VoiceHandle InvalidVoice = 0;
+
+    /**
+     * \brief What happens when a sound is requested while it already plays its maximum instances.
+     */
+    enum class StealPolicy {
+        REJECT_NEW = 0,         // Keep the playing voices, drop the request
+        STEAL_OLDEST,           // Stop the voice that started first
+        STEAL_QUIETEST,         // Stop the least audible voice
+        STEAL_LOWEST_PRIORITY   // Stop the least important voice, oldest first on ties
+    };
+
+    /**
+     * \brief Limits for one sound.
+     */
+    struct Limits {
+        int maxInstances = 0;                       // 0 means unlimited
+        StealPolicy steal = StealPolicy::STEAL_OLDEST;
+        double cooldown = 0.0;                      // Minimum seconds between two starts
+    };
+
+    /**
+     * \brief The outcome of a play request.
+     */
+    struct Admission {
+        VoiceHandle voice = InvalidVoice;           // InvalidVoice if the request was dropped
+        std::vector<VoiceHandle> stolen;            // Voices the caller has to stop
+    };
+
+    /**
+     * \brief Counters since the last ResetStats, and the current voice counts.
+     */
+    struct Stats {
+        uint64_t requested = 0;
+        uint64_t started = 0;
+        uint64_t suppressed = 0;                    // Dropped by the cooldown
+        uint64_t rejected = 0;                      // Dropped by the instance limit
+        uint64_t stolen = 0;
+        uint64_t virtualised = 0;                   // Times a voice went from real to virtual
+        int playing = 0;
+        int real = 0;
+        int virtualVoices = 0;
+        int peakPlaying = 0;
+    };
+
+    /**
+     * \brief Sets the limits of a sound. Overrides the default limits.
+     * \param soundID The audio ID.
+     * \param limits The limits.
+     */
+    void SetLimits(int soundID, const Limits& limits) { soundLimits[soundID] = limits; }
+
+    /**
+     * \brief Sets the limits of sounds that have none of their own.
+     * \param limits The limits.
+     */
+    void SetDefaultLimits(const Limits& limits) { defaultLimits = limits; }
+
+    /**
+     * \brief Retrieves the limits of a sound.
+     * \param soundID The audio ID.
+     * \return The sound's limits, or the default limits if none were set.
+     */
+    Limits GetLimits(int soundID) const;
+
+    /**
+     * \brief Sets how many voices may be real at once. The rest are virtual.
+     * \param count The number of real voices.
+     */
+    void SetMaxRealVoices(int count) { maxRealVoices = count; }
+
+    /**
+     * \brief Retrieves how many voices may be real at once.
+     * \return The number of real voices.
+     */
+    int GetMaxRealVoices() const { return maxRealVoices; }
+
+    /**
+     * \brief Moves the voice clock forward. Cooldowns and voice ages use it.
+     * \param seconds The real time since the last call.
+     */
+    void Advance(double seconds) { clock += seconds; }
+
+    /**
+     * \brief Asks to start a voice of a sound.
+     * \param soundID The audio ID.
+     * \param priority The sound's priority, 0 is the most important like FMOD channels.
+     * \param audibility Volume times distance attenuation, 0 to 1.
+     * \return The new voice and any voices that were stolen for it.
+     */
+    Admission Request(int soundID, int priority, float audibility);
+
+    /**
+     * \brief Forgets a voice that finished or was stopped.
+     * \param voice The voice.
+     */
+    void Release(VoiceHandle voice);
+
+    /**
+     * \brief Forgets every voice, e.g. after all audio was stopped.
+     */
+    void ReleaseAll();
+
+    /**
+     * \brief Updates how audible a voice is after a volume or position change.
+     * \param voice The voice.
+     * \param audibility Volume times distance attenuation, 0 to 1.
+     */
+    void SetAudibility(VoiceHandle voice, float audibility);
+
+    /**
+     * \brief Ranks the playing voices and reports the ones that have to change between real and virtual.
+     * \param becameReal Receives the voices that have to be heard again.
+     * \param becameVirtual Receives the voices that have to be silenced.
+     */
+    void UpdateVirtualisation(std::vector<VoiceHandle>& becameReal, std::vector<VoiceHandle>& becameVirtual);
+
+    /**
+     * \brief Checks if a voice is currently virtual.
+     * \param voice The voice.
+     * \return True if virtual, false if real or unknown.
+     */
+    bool IsVirtual(VoiceHandle voice) const;
+
+    /**
+     * \brief Retrieves the voice counters.
+     * \return A copy of the counters.
+     */
+    Stats GetStats() const { return stats; }
+
+    /**
+     * \brief Clears the counters, keeping the current voice counts.
+     */
+    void ResetStats();
+
+private:
+    struct Voice {
+        int soundID = -1;
+        int priority = 0;
+        float audibility = 1.0f;
+        double startTime = 0.0;
+        bool isVirtual = false;
+    };
+
+    /**
+     * \brief Picks the voice of a sound to steal.
+     * \param soundID The audio ID.
+     * \param policy How to pick.
+     * \return The voice, or InvalidVoice if the sound has none playing.
+     */
+    VoiceHandle PickVictim(int soundID, StealPolicy policy) const;
+
+    /**
+     * \brief Recounts the playing, real and virtual voices.
+     */
+    void CountVoices();
+
+    Limits defaultLimits;                                            // Unlimited unless set
+    std::unordered_map<int, Limits> soundLimits;
+    std::unordered_map<VoiceHandle, Voice> voices;
+    std::unordered_map<int, std::vector<VoiceHandle>> soundVoices;  // Audio ID -> its voices, oldest first
+    std::unordered_map<int, double> lastStart;                       // Audio ID -> clock at its last start
+    VoiceHandle nextVoice = 1;
+    int maxRealVoices = 32;
+    double clock = 0.0;
+    Stats stats;
+};
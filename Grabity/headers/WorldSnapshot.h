@@ -0,0 +1,69 @@
+/*!****************************************************************
+\file: WorldSnapshot.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: In-memory image of every game object and its component state,
+        captured right after a scene finishes loading. Restarting the
+        scene restores from the image through a LuaSceneContext, so the
+        per-component reads never touch the scene file or a Lua state.
+
+        The image uses the cooked scene layout (see CookedScene) and is
+        produced by the same Serialize calls that save a scene.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <memory>
+#include <filesystem>
+#include "CookedScene.h"
+
+class WorldSnapshot {
+public:
+    /**
+     * \brief Serializes every game object of the factory into an in-memory image.
+     * \param scenePath The scene the objects were loaded from.
+     * \return True if the image was built, false otherwise.
+     */
+    bool Capture(const std::string& scenePath);
+
+    /**
+     * \brief Drops the captured image.
+     */
+    void Clear();
+
+    /**
+     * \brief Checks if the snapshot can stand in for a scene file. A snapshot goes stale
+     *        once the scene file is saved again after the capture.
+     * \param scenePath The scene about to be restarted.
+     * \return True if the snapshot belongs to the scene and is still current.
+     */
+    bool IsValidFor(const std::string& scenePath) const;
+
+    /**
+     * \brief Retrieves the path the snapshot is served under. LuaManagers opened on this
+     *        path while a LuaSceneContext holds the image read from the image.
+     * \return The snapshot path.
+     */
+    const std::string& GetSnapshotPath() const { return snapshotPath; }
+
+    /**
+     * \brief Retrieves the captured image.
+     * \return Shared pointer to the image, empty if nothing was captured.
+     */
+    const std::shared_ptr<const CookedScene>& GetImage() const { return image; }
+
+    /**
+     * \brief Retrieves the size of the captured image.
+     * \return The size in bytes.
+     */
+    size_t GetSizeBytes() const { return image ? image->GetSizeBytes() : 0; }
+
+private:
+    std::string scenePath;
+    std::string snapshotPath;
+    std::filesystem::file_time_type sceneWriteTime;
+    std::shared_ptr<const CookedScene> image;
+};
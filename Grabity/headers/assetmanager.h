@@ -27,8 +27,10 @@ Technology is prohibited.
 #include "graphicsmanager.h"
 #include "LuaConfig.h"
 #include "Audio.h"
-#include <fmod.hpp>
 #include <map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
 
 
 /**
@@ -53,6 +55,22 @@ struct FontInfo {
     std::string type;
 };
 
+/**
+ * @struct ResidencyInfo
+ * @brief One line of the asset residency report
+ */
+struct ResidencyInfo {
+    std::string name;
+    std::string type;       // "Texture", or "Audio" with its load mode
+    std::string path;
+    size_t bytes;           // GPU bytes for textures, bytes held in its load mode for audio
+    long references;        // Holders other than the asset manager, channels playing it for audio
+    bool resident;
+    bool pinned;            // Never unloaded
+    bool inScene;           // Used by the current scene
+    uint64_t lastUsed;      // Use clock value of the last GetSprite or GetAudio, higher is more recent
+};
+
 /**
  * @class AssetManager
  * @brief Singleton manager for all game assets
@@ -88,6 +106,9 @@ private:
     // Array of font objects, indexed by FontType
     Font font[Graphics::F_TOTAL];
 
+    // True while fonts are rasterized but not uploaded yet
+    bool fontsRasterized = false;
+
     // Loads all required Lua script files at startup
     void PreloadLuaFiles();
 
@@ -122,6 +143,79 @@ private:
     // Counter for tracking loaded Lua files
     int totalLuaFilesLoaded{ 0 };
 
+    // What is needed to load a texture again after it was unloaded
+    struct TextureRecord {
+        std::string path;
+        float frameX = 1.0f;
+        float frameY = 1.0f;
+        float framePS = 1.0f;
+        size_t bytes = 0;           // Size on the GPU while resident
+        uint64_t lastUsed = 0;
+        uint64_t scene = 0;         // sceneGeneration it was last recorded in
+        bool pinned = false;
+    };
+
+    // Residency of a registered audio; the Audio in audioObjects keeps what is needed to load it again
+    struct AudioRecord {
+        size_t bytes = 0;           // Held in its load mode while resident
+        uint64_t lastUsed = 0;
+        uint64_t scene = 0;         // sceneGeneration it was last recorded in
+        bool failed = false;        // The backend could not load its file the last time it tried
+    };
+
+    // Every known texture, resident or not, indexed by name
+    std::unordered_map<std::string, TextureRecord> textureRecords;
+
+    // Textures requested while each scene was current, indexed by scene path
+    std::unordered_map<std::string, std::unordered_set<std::string>> sceneTextures;
+
+    // Every registered audio's residency, indexed by audio ID
+    std::unordered_map<int, AudioRecord> audioRecords;
+
+    // Audio played while each scene was current, indexed by scene path
+    std::unordered_map<std::string, std::unordered_set<int>> sceneAudio;
+
+    // Scene whose textures and audio are kept resident
+    std::string residentScene;
+
+    // Counts BeginSceneResidency calls, so an asset is added to a scene's set once, not on every use
+    uint64_t sceneGeneration = 0;
+
+    // Logical clock for least recently used ordering of textures and audio
+    uint64_t useClock = 0;
+
+    // Bytes of texture memory resident and the budget TrimTexturesToBudget keeps to
+    size_t residentTextureBytes = 0;
+    size_t textureBudgetBytes = 256ull * 1024ull * 1024ull;
+
+    // Bytes of audio resident and the budget TrimAudioToBudget keeps to
+    size_t residentAudioBytes = 0;
+    size_t audioBudgetBytes = 64ull * 1024ull * 1024ull;
+
+    // Creates a texture, applying the frame layouts of the known animations
+    std::shared_ptr<Texture> CreateTexture(const std::string& pathName, const std::string& fileName, float frameX, float frameY, float animationFrame, const Texture::DecodedImage* decoded = nullptr);
+
+    // Makes a texture resident and updates the counters
+    void MakeResident(const std::string& name, TextureRecord& record, std::shared_ptr<Texture> texture);
+
+    // Checks if a resident texture may be unloaded
+    bool CanEvict(const std::string& name, const std::shared_ptr<Texture>& texture) const;
+
+    // Unloads a resident texture, keeping its record so it can be loaded again
+    void Evict(const std::string& name);
+
+    // Adds a texture to the current scene's set the first time the scene uses it
+    void RecordSceneTexture(const std::string& name, TextureRecord& record);
+
+    // Updates the record of an audio that has just been loaded
+    void MakeAudioResident(int id, const Audio& audio);
+
+    // Checks if a loaded audio may be unloaded
+    bool CanEvictAudio(int id, const Audio& audio) const;
+
+    // Unloads an audio, keeping it registered so it can be loaded again
+    void EvictAudio(int id);
+
 public:
 
 
@@ -143,7 +237,7 @@ public:
     * Audio
     *****************************************************/
 
-    // Map to store audio objects, indexed by their IDs.
+    // Map to store audio objects, indexed by their IDs. They stay registered while unloaded, use GetAudio to play one.
     std::map<int, Audio*> audioObjects;
 
     // Map to store audio IDs, indexed by their names.
@@ -156,15 +250,29 @@ public:
      */
     std::string GetAudioNameFromID(int audioID);
 
+    /**
+     * @brief Lists the audio the backend could not load, e.g. formats it has no decoder for
+     * @return "name (path)" of each, sorted
+     */
+    std::vector<std::string> GetFailedAudio() const;
+
+    /**
+     * @brief Gets an audio to play, loading it again if it was unloaded
+     * @param id The ID of the audio
+     * @return The audio, nullptr if the ID is unknown
+     */
+    Audio* GetAudio(int id);
+
     /**
      * @brief Load an audio file.
      * @param name The name to associate with the audio.
      * @param filePath The path to the audio file.
      * @param type The type of the audio (e.g., sound effect, music).
      * @param priority The priority of the audio.
+     * @param mode How the sound is held while loaded.
      * @return The ID of the loaded audio.
      */
-    int LoadAudio(const std::string& name, const std::string& filePath, AudioType type, int priority);
+    int LoadAudio(const std::string& name, const std::string& filePath, AudioType type, int priority, AudioBackend::LoadMode mode);
 
     /**
     * @brief Load an audio file into the asset manager
@@ -172,8 +280,17 @@ public:
     * @param fileName The name to identify the audio
     * @param audioType The type of audio (as an integer)
     * @param priority The priority level for the audio
+    * @param loadMode "decompressed", "compressed" or "streamed"; empty for the audio type's default
     */
-    void LoadAudios(const std::string& pathName, const std::string& fileName, const int& audioType, const int& priority);
+    void LoadAudios(const std::string& pathName, const std::string& fileName, const int& audioType, const int& priority, const std::string& loadMode = "");
+
+    /**
+    * @brief Reload a loaded audio from its file, keeping its ID, type, priority and load mode
+    * @param pathName The file path to the audio
+    * @param fileName The name the audio was loaded with
+    * @return True if the audio was loaded before and has been reloaded
+    */
+    bool ReloadAudio(const std::string& pathName, const std::string& fileName);
 
     /**
      * @brief Remove a sound from the asset manager
@@ -191,10 +308,10 @@ public:
      * @param id The identifier of the sprite to retrieve
      * @return Shared pointer to the requested sprite animation
      */
-    inline std::shared_ptr<Texture> GetSprite(const std::string& id) { return m_Textures[id]; }
+    std::shared_ptr<Texture> GetSprite(const std::string& id);
 
     /**
-    * @brief Gets all loaded textures
+    * @brief Gets the resident textures. Registered textures that are not loaded yet are not in it
     * @return Constant reference to the texture map
     */
     const std::unordered_map<std::string, std::shared_ptr<Texture>>& GetTextures() const { return m_Textures; }
@@ -211,14 +328,35 @@ public:
     void InitializeGraphicsAssets();
 
     /**
-     * @brief Check if a texture is already loaded
+     * @brief Rasterizes the glyphs of all fonts without touching OpenGL, so startup can
+     *        do it on a worker thread. InitializeGraphicsAssets uploads them afterwards.
+     */
+    void RasterizeFonts();
+
+    /**
+     * @brief Check if a texture is known, whether or not it is loaded. GetSprite loads it on demand
      * @param name The name of the texture to check
-     * @return true if the texture is loaded, false otherwise
+     * @return true if the texture is registered, false otherwise
      */
-    bool IsTextureLoaded(const std::string& name) const {
+    bool IsTextureRegistered(const std::string& name) const {
+        return textureRecords.find(name) != textureRecords.end();
+    }
+
+    /**
+     * @brief Check if a texture is loaded on the GPU
+     * @param name The name of the texture to check
+     * @return true if the texture is resident, false otherwise
+     */
+    bool IsTextureResident(const std::string& name) const {
         return m_Textures.find(name) != m_Textures.end();
     }
 
+    /**
+     * @brief Lists every registered texture, resident or not
+     * @return The texture names, sorted
+     */
+    std::vector<std::string> GetTextureNames() const;
+
     /**
      * @brief Remove a texture from the asset manager
      * @param name The name of the texture to remove
@@ -226,11 +364,21 @@ public:
     void UnloadTexture(const std::string& name) {
         auto it = m_Textures.find(name);
         if (it != m_Textures.end()) {
-            m_Textures.erase(it);
-            --totalTextureLoaded;
+            Evict(name);
         }
+        textureRecords.erase(name);
     }
 
+    /**
+     * @brief Make a texture known without loading it. It is loaded by the first GetSprite
+     * @param pathName The file path to the texture
+     * @param fileName The name to identify the texture
+     * @param frameX Number of frames in X direction for animation
+     * @param frameY Number of frames in Y direction for animation
+     * @param animationFrame Animation frame rate
+     */
+    void RegisterTexture(const std::string& pathName, const std::string& fileName, float frameX, float frameY, float animationFrame);
+
     /**
      * @brief Load a texture into the asset manager
      * @param pathName The file path to the texture
@@ -241,6 +389,28 @@ public:
      */
     void LoadTexture(const std::string& pathName, const std::string& fileName, const float& frameX, const float& frameY, const float& animationFrame);
 
+    /**
+     * @brief Reload a texture from its file in place, keeping the Texture object that sprites hold
+     * @param pathName The file path to the texture
+     * @param fileName The name the texture was loaded with
+     * @return True if the texture was known. If it is not resident the next GetSprite reads the new file
+     */
+    bool ReloadTexture(const std::string& pathName, const std::string& fileName);
+
+    /**
+     * @brief Lists the file of every registered texture, for loaders that run off the main thread
+     * @return Texture name to file path
+     */
+    std::unordered_map<std::string, std::string> GetTexturePaths() const;
+
+    /**
+     * @brief Makes a texture resident from pixels decoded ahead of time, e.g. by a scene preload
+     * @param name The name of the texture
+     * @param decoded The decoded pixels
+     * @return true if the texture was uploaded, false if it is unknown or already resident
+     */
+    bool AdoptDecodedTexture(const std::string& name, const Texture::DecodedImage& decoded);
+
     /**
      * @brief Remove a texture from the asset manager
      * @param textureName The name of the texture to remove
@@ -248,6 +418,83 @@ public:
     void RemoveTexture(const std::string& textureName);
 
 
+    /*****************************************************
+    * Residency
+    *****************************************************/
+
+    /**
+     * @brief Start tracking the textures and audio a scene uses. They stay resident while it is current
+     * @param scenePath The path of the scene being loaded
+     */
+    void BeginSceneResidency(const std::string& scenePath);
+
+    /**
+     * @brief Unload least recently used textures that nothing holds until the budget is met
+     * @return Number of textures unloaded
+     */
+    int TrimTexturesToBudget();
+
+    /**
+     * @brief Unload every texture that nothing holds and the current scene does not use
+     * @return Number of textures unloaded
+     */
+    int UnloadUnusedTextures();
+
+    /**
+     * @brief Set the texture memory TrimTexturesToBudget keeps to
+     * @param bytes The budget in bytes
+     */
+    void SetTextureBudget(size_t bytes) { textureBudgetBytes = bytes; }
+
+    /**
+     * @brief Gets the texture memory budget
+     * @return The budget in bytes
+     */
+    size_t GetTextureBudget() const { return textureBudgetBytes; }
+
+    /**
+     * @brief Gets the texture memory currently resident
+     * @return The resident size in bytes
+     */
+    size_t GetResidentTextureBytes() const { return residentTextureBytes; }
+
+    /**
+     * @brief Unload least recently played audio that is not playing until the budget is met
+     * @return Number of sounds unloaded
+     */
+    int TrimAudioToBudget();
+
+    /**
+     * @brief Unload every audio that is not playing and the current scene has not played
+     * @return Number of sounds unloaded
+     */
+    int UnloadUnusedAudio();
+
+    /**
+     * @brief Set the audio memory TrimAudioToBudget keeps to
+     * @param bytes The budget in bytes
+     */
+    void SetAudioBudget(size_t bytes) { audioBudgetBytes = bytes; }
+
+    /**
+     * @brief Gets the audio memory budget
+     * @return The budget in bytes
+     */
+    size_t GetAudioBudget() const { return audioBudgetBytes; }
+
+    /**
+     * @brief Gets the audio memory currently resident
+     * @return The resident size in bytes
+     */
+    size_t GetResidentAudioBytes() const { return residentAudioBytes; }
+
+    /**
+     * @brief List every known texture and audio with its size and state
+     * @return The report, largest assets first
+     */
+    std::vector<ResidencyInfo> GetResidencyReport() const;
+
+
     /*****************************************************
     * Shaders
     *****************************************************/
@@ -33,6 +33,7 @@ Technology is prohibited.
 #include <memory>
 #include "CameraManager.h"
 #include "ParticleSystem.h"
+#include "EventBus.h"
 
 class Engine {
     static std::unique_ptr<Engine> instance;
@@ -41,6 +42,8 @@ class Engine {
     GLfloat clearColor[4];
 #ifdef _IMGUI
 	std::string stateFile = "Assets/Lua/state.lua";
+	std::string autosaveFile = "Assets/Lua/autosave.lua";
+	double autosaveInterval = 30.0; // Seconds between editor autosaves
     GameObject* selectedObject = nullptr;
 #endif // _IMGUI
 
@@ -224,5 +227,36 @@ public:
     bool fadeIntoCutScene = false;
     bool isGodMode = false;
 
+private:
+    /*!****************************************************************
+    \func  RegisterSystems
+    \brief Adds the per-frame systems to the SystemScheduler with what
+           each of them reads and writes. Systems that conflict run in
+           the order they are added.
+    *******************************************************************!*/
+    void RegisterSystems();
+
+    /*!****************************************************************
+    \func  UpdateGameFlow
+    \brief Pauses and unpauses, checks for losing, and runs
+           the editor's autosave and asset reloads.
+    *******************************************************************!*/
+    void UpdateGameFlow();
+
+    /*!****************************************************************
+    \func  UpdateCamera
+    \brief Moves the player camera, or the editor camera from the mouse
+           and keyboard.
+    *******************************************************************!*/
+    void UpdateCamera();
+
+    /*!****************************************************************
+    \func  OnMissionsCompleted
+    \brief Loads the victory scene when a MissionsCompletedEvent is
+           heard, unless the game was lost or left since.
+    *******************************************************************!*/
+    void OnMissionsCompleted();
+
+    EventBus::Subscription missionsCompletedSubscription;
 };
 #endif // ENGINE_H
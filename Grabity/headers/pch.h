@@ -35,7 +35,9 @@
 #endif // _IMGUI
 
 // Fmod
+#ifndef _NO_FMOD
 #include <fmod.hpp>
+#endif // !_NO_FMOD
 //#include <fmod_errors.h> //only included when needed to fetch audio errors
 
 // FreeType
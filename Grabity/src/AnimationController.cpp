@@ -279,6 +279,7 @@ void SaveAnimationControllerToLua(const AnimationController& controller, const s
     luaFile << "}\n";
 
     luaFile.close();
+    LuaStateCache::Invalidate(filePath);
 }
 
 /*!****************************************************************
@@ -0,0 +1,424 @@
+/*!****************************************************************
+\file: AssetPack.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Single-file archive of the Assets directory. The pack starts
+        with a header that points at a table of contents listing every
+        file by its path, where its bytes are, its original size and a
+        hash of its content. Entries that shrink enough are stored LZ4
+        block compressed, everything else is stored as is.
+
+        A mounted pack is memory-mapped once, so reading a stored entry
+        is a pointer into the mapping instead of an open/read/close.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "AssetPack.h"
+#include "ImGuiConsole.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    // LZ4 block format limits
+    constexpr size_t MinMatch = 4;
+    constexpr size_t LastLiterals = 5;      // The last 5 bytes are always literals
+    constexpr size_t MatchSearchLimit = 12; // The last match starts at least 12 bytes before the end
+    constexpr size_t MaxOffset = 65535;
+    constexpr int HashBits = 16;
+
+    /**
+     * \brief Reads 4 bytes without alignment requirements.
+     * \param data The first byte.
+     * \return The bytes as an integer.
+     */
+    uint32_t Read32(const unsigned char* data) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    /**
+     * \brief Appends an LZ4 length extension for the part of a length above 15.
+     * \param out The block being written.
+     * \param length The remaining length.
+     */
+    void WriteLength(std::vector<unsigned char>& out, size_t length) {
+        while (length >= 255) {
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back(static_cast<unsigned char>(length));
+    }
+
+    /**
+     * \brief Appends one LZ4 sequence: literals followed by an optional match.
+     * \param out The block being written.
+     * \param literals The first literal byte.
+     * \param literalLength The number of literals.
+     * \param offset The distance back to the match, 0 for the final literals-only sequence.
+     * \param matchLength The match length, at least MinMatch when offset is not 0.
+     */
+    void WriteSequence(std::vector<unsigned char>& out, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        const size_t matchCode = offset ? matchLength - MinMatch : 0;
+        out.push_back(static_cast<unsigned char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (literalLength >= 15) {
+            WriteLength(out, literalLength - 15);
+        }
+        out.insert(out.end(), literals, literals + literalLength);
+        if (offset) {
+            out.push_back(static_cast<unsigned char>(offset & 0xFF));
+            out.push_back(static_cast<unsigned char>(offset >> 8));
+            if (matchCode >= 15) {
+                WriteLength(out, matchCode - 15);
+            }
+        }
+    }
+
+    /**
+     * \brief Decides if an entry is worth storing compressed.
+     * \param size The original size.
+     * \param compressedSize The compressed size.
+     * \return True if compression saves at least an eighth of the entry.
+     */
+    bool WorthCompressing(size_t size, size_t compressedSize) {
+        return compressedSize + size / 8 < size;
+    }
+}
+
+/**
+ * \brief Packs every file under a directory into one archive.
+ * \param rootDirectory The directory to pack, e.g. "Assets". Entry paths keep it as a prefix.
+ * \param packPath The path of the archive to write.
+ * \return The number of files packed, or -1 if the archive could not be written.
+ */
+int AssetPack::Build(const std::string& rootDirectory, const std::string& packPath) {
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& item : std::filesystem::recursive_directory_iterator(rootDirectory, error)) {
+        if (!item.is_regular_file()) {
+            continue;
+        }
+        const std::string extension = item.path().extension().string();
+        // Leftovers of interrupted saves and packs are not assets
+        if (extension == ".tmp" || extension == Extension) {
+            continue;
+        }
+        paths.push_back(NormalizePath(item.path().generic_string()));
+    }
+    // Sorted so that the same tree always produces the same pack
+    std::sort(paths.begin(), paths.end());
+
+    const std::string tempPath = packPath + ".tmp";
+    std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        ImGuiConsole::Cout("Error: Could not create or open the file %s", tempPath.c_str());
+        return -1;
+    }
+
+    Header packHeader{};
+    outFile.write(reinterpret_cast<const char*>(&packHeader), sizeof(Header));
+    uint64_t offset = sizeof(Header);
+
+    std::vector<Entry> packEntries;
+    std::string nameTable;
+    std::vector<unsigned char> content;
+    std::vector<unsigned char> compressed;
+    for (const std::string& path : paths) {
+        std::ifstream inFile(path, std::ios::binary | std::ios::ate);
+        if (!inFile.is_open()) {
+            continue;
+        }
+        std::streamsize size = inFile.tellg();
+        content.resize(static_cast<size_t>(std::max<std::streamsize>(size, 0)));
+        inFile.seekg(0, std::ios::beg);
+        if (size > 0 && !inFile.read(reinterpret_cast<char*>(content.data()), size)) {
+            continue;
+        }
+
+        Entry entry{};
+        entry.nameOffset = static_cast<uint32_t>(nameTable.size());
+        entry.nameLength = static_cast<uint32_t>(path.size());
+        entry.dataOffset = offset;
+        entry.size = content.size();
+        entry.hash = HashContent(content.data(), content.size());
+        nameTable += path;
+
+        CompressBlock(content.data(), content.size(), compressed);
+        const bool storeCompressed = WorthCompressing(content.size(), compressed.size());
+        const std::vector<unsigned char>& stored = storeCompressed ? compressed : content;
+        entry.storedSize = stored.size();
+        outFile.write(reinterpret_cast<const char*>(stored.data()), static_cast<std::streamsize>(stored.size()));
+        offset += stored.size();
+        packEntries.push_back(entry);
+    }
+
+    // The table of contents is read in place from the mapping, so it has to be aligned
+    const char padding[alignof(Entry)] = {};
+    const size_t paddingSize = static_cast<size_t>((alignof(Entry) - offset % alignof(Entry)) % alignof(Entry));
+    outFile.write(padding, static_cast<std::streamsize>(paddingSize));
+    offset += paddingSize;
+
+    packHeader.magic = Magic;
+    packHeader.version = Version;
+    packHeader.entryCount = static_cast<uint32_t>(packEntries.size());
+    packHeader.nameBytes = static_cast<uint32_t>(nameTable.size());
+    packHeader.tocOffset = offset;
+    outFile.write(reinterpret_cast<const char*>(packEntries.data()), static_cast<std::streamsize>(packEntries.size() * sizeof(Entry)));
+    outFile.write(nameTable.data(), static_cast<std::streamsize>(nameTable.size()));
+    outFile.seekp(0, std::ios::beg);
+    outFile.write(reinterpret_cast<const char*>(&packHeader), sizeof(Header));
+    outFile.close();
+    if (!outFile) {
+        ImGuiConsole::Cout("Error: Could not write the file %s", tempPath.c_str());
+        std::filesystem::remove(tempPath, error);
+        return -1;
+    }
+
+    std::filesystem::rename(tempPath, packPath, error);
+    if (error) {
+        // Some platforms refuse to rename over an existing file
+        std::filesystem::remove(packPath, error);
+        std::filesystem::rename(tempPath, packPath, error);
+    }
+    if (error) {
+        ImGuiConsole::Cout("Error: Could not replace the file %s", packPath.c_str());
+        return -1;
+    }
+    return static_cast<int>(packEntries.size());
+}
+
+/**
+ * \brief Normalizes a path the way entries are stored: forward slashes, no leading "./".
+ * \param path The path to normalize.
+ * \return The normalized path.
+ */
+std::string AssetPack::NormalizePath(std::string path) {
+    std::replace(path.begin(), path.end(), '\\', '/');
+    while (path.compare(0, 2, "./") == 0) {
+        path.erase(0, 2);
+    }
+    return path;
+}
+
+/**
+ * \brief Hashes file content.
+ * \param data The bytes to hash.
+ * \param size The number of bytes.
+ * \return The 64-bit FNV-1a hash.
+ */
+uint64_t AssetPack::HashContent(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * \brief Compresses a buffer in the LZ4 block format.
+ * \param source The bytes to compress.
+ * \param size The number of bytes.
+ * \param compressed Receives the compressed block.
+ */
+void AssetPack::CompressBlock(const unsigned char* source, size_t size, std::vector<unsigned char>& compressed) {
+    compressed.clear();
+    compressed.reserve(size + size / 255 + 16);
+
+    size_t anchor = 0;
+    if (size > MatchSearchLimit) {
+        // Most recent position of each 4-byte sequence, by hash
+        std::vector<uint32_t> table(size_t(1) << HashBits, UINT32_MAX);
+        const size_t searchEnd = size - MatchSearchLimit;
+        const size_t matchEnd = size - LastLiterals;
+
+        size_t position = 0;
+        while (position < searchEnd) {
+            const uint32_t sequence = Read32(source + position);
+            const uint32_t hash = (sequence * 2654435761u) >> (32 - HashBits);
+            const uint32_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(position);
+
+            if (candidate == UINT32_MAX || position - candidate > MaxOffset || Read32(source + candidate) != sequence) {
+                ++position;
+                continue;
+            }
+
+            size_t matchLength = MinMatch;
+            while (position + matchLength < matchEnd && source[candidate + matchLength] == source[position + matchLength]) {
+                ++matchLength;
+            }
+            WriteSequence(compressed, source + anchor, position - anchor, position - candidate, matchLength);
+            position += matchLength;
+            anchor = position;
+        }
+    }
+    WriteSequence(compressed, source + anchor, size - anchor, 0, 0);
+}
+
+/**
+ * \brief Decompresses an LZ4 block of known original size.
+ * \param source The compressed block.
+ * \param sourceSize The size of the compressed block.
+ * \param destination Receives exactly destinationSize bytes.
+ * \param destinationSize The original size.
+ * \return True if the block was valid and decoded to exactly destinationSize bytes.
+ */
+bool AssetPack::DecompressBlock(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize) {
+    const unsigned char* input = source;
+    const unsigned char* const inputEnd = source + sourceSize;
+    unsigned char* output = destination;
+    unsigned char* const outputEnd = destination + destinationSize;
+
+    while (input < inputEnd) {
+        const unsigned char token = *input++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            unsigned char extra;
+            do {
+                if (input >= inputEnd) {
+                    return false;
+                }
+                extra = *input++;
+                literalLength += extra;
+            } while (extra == 255);
+        }
+        if (literalLength > static_cast<size_t>(inputEnd - input) || literalLength > static_cast<size_t>(outputEnd - output)) {
+            return false;
+        }
+        std::memcpy(output, input, literalLength);
+        input += literalLength;
+        output += literalLength;
+
+        // The last sequence has no match
+        if (input == inputEnd) {
+            break;
+        }
+
+        if (inputEnd - input < 2) {
+            return false;
+        }
+        const size_t offset = static_cast<size_t>(input[0]) | (static_cast<size_t>(input[1]) << 8);
+        input += 2;
+        if (offset == 0 || offset > static_cast<size_t>(output - destination)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            unsigned char extra;
+            do {
+                if (input >= inputEnd) {
+                    return false;
+                }
+                extra = *input++;
+                matchLength += extra;
+            } while (extra == 255);
+        }
+        matchLength += MinMatch;
+        if (matchLength > static_cast<size_t>(outputEnd - output)) {
+            return false;
+        }
+
+        // Matches may overlap the bytes they produce, so they are copied forward one byte at a time
+        const unsigned char* match = output - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            output[i] = match[i];
+        }
+        output += matchLength;
+    }
+    return output == outputEnd;
+}
+
+/**
+ * \brief Memory-maps an archive and indexes its table of contents.
+ * \param packPath The path of the archive.
+ * \return True if the archive was mapped and is valid, false otherwise.
+ */
+bool AssetPack::Open(const std::string& packPath) {
+    Close();
+    if (!file.Open(packPath)) {
+        return false;
+    }
+
+    const unsigned char* base = file.GetData();
+    const size_t size = file.GetSize();
+    const Header* candidate = reinterpret_cast<const Header*>(base);
+    if (size < sizeof(Header) || candidate->magic != Magic || candidate->version != Version
+        || candidate->tocOffset > size || candidate->tocOffset % alignof(Entry) != 0
+        || (size - candidate->tocOffset) / sizeof(Entry) < candidate->entryCount
+        || size - candidate->tocOffset - candidate->entryCount * sizeof(Entry) < candidate->nameBytes) {
+        ImGuiConsole::Cout("Error: %s is not a valid asset pack", packPath.c_str());
+        file.Close();
+        return false;
+    }
+
+    header = candidate;
+    entries = reinterpret_cast<const Entry*>(base + header->tocOffset);
+    names = reinterpret_cast<const char*>(entries + header->entryCount);
+    entryIndex.reserve(header->entryCount);
+    for (uint32_t index = 0; index < header->entryCount; ++index) {
+        const Entry& entry = entries[index];
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header->nameBytes
+            || entry.dataOffset > header->tocOffset || header->tocOffset - entry.dataOffset < entry.storedSize) {
+            ImGuiConsole::Cout("Error: %s has a damaged table of contents", packPath.c_str());
+            Close();
+            return false;
+        }
+        entryIndex.emplace(std::string_view(names + entry.nameOffset, entry.nameLength), index);
+    }
+    return true;
+}
+
+/**
+ * \brief Unmaps the archive. Pointers returned by Find become invalid.
+ */
+void AssetPack::Close() {
+    entryIndex.clear();
+    header = nullptr;
+    entries = nullptr;
+    names = nullptr;
+    file.Close();
+}
+
+/**
+ * \brief Looks up an entry by path.
+ * \param path The normalized path of the file, e.g. "Assets/Textures/Player.png".
+ * \param entry Receives the entry.
+ * \return True if the archive contains the file, false otherwise.
+ */
+bool AssetPack::Find(const std::string& path, EntryView& entry) const {
+    auto it = entryIndex.find(path);
+    if (it == entryIndex.end()) {
+        return false;
+    }
+    const Entry& record = entries[it->second];
+    entry.data = file.GetData() + record.dataOffset;
+    entry.storedSize = record.storedSize;
+    entry.size = record.size;
+    entry.hash = record.hash;
+    return true;
+}
+
+/**
+ * \brief Produces the original bytes of an entry, decompressing it if needed.
+ * \param entry The entry returned by Find.
+ * \param content Receives the bytes.
+ * \return True if the entry decoded and matched its hash, false otherwise.
+ */
+bool AssetPack::Extract(const EntryView& entry, std::vector<unsigned char>& content) {
+    content.resize(static_cast<size_t>(entry.size));
+    if (entry.storedSize == entry.size) {
+        std::memcpy(content.data(), entry.data, content.size());
+    }
+    else if (!DecompressBlock(entry.data, static_cast<size_t>(entry.storedSize), content.data(), content.size())) {
+        return false;
+    }
+    return HashContent(content.data(), content.size()) == entry.hash;
+}
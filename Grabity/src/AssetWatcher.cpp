@@ -0,0 +1,291 @@
+/*!****************************************************************
+\file: AssetWatcher.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Watches asset directories for added, modified and removed
+        files so the editor does not have to list them every frame.
+        On Linux the directories are watched with inotify. Elsewhere,
+        or if a watch cannot be created, the directory is listed again
+        on a timer and compared with the previous listing.
+
+        Changes are debounced: a batch is only reported once the
+        directory has been quiet for a short while, so a file that is
+        still being written by an image editor is reloaded once.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "AssetWatcher.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif // __linux__
+
+/**
+ * \brief Retrieves the watcher instance.
+ * \return Reference to the watcher.
+ */
+AssetWatcher& AssetWatcher::GetInstance() {
+    static AssetWatcher instance;
+    return instance;
+}
+
+AssetWatcher::AssetWatcher() {
+#ifdef __linux__
+    inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#ifdef _LOGGING
+    if (inotifyHandle < 0) {
+        ImGuiConsole::Cout("inotify unavailable, asset directories will be polled");
+    }
+#endif // _LOGGING
+#endif // __linux__
+}
+
+/**
+ * \brief Removes every watch and closes the inotify instance.
+ */
+AssetWatcher::~AssetWatcher() {
+    Clear();
+#ifdef __linux__
+    if (inotifyHandle >= 0) {
+        close(inotifyHandle);
+    }
+#endif // __linux__
+}
+
+/**
+ * \brief Starts watching the files directly inside a directory. Files without an
+ *        extension are ignored, like Utilities::getAssetFiles does.
+ * \param directory The directory to watch, e.g. "Assets/Textures/".
+ * \param callback Called from Update with each debounced batch of changes.
+ */
+void AssetWatcher::Watch(const std::string& directory, ChangeCallback callback) {
+    WatchedDirectory watched;
+    watched.directory = directory;
+    watched.callback = std::move(callback);
+    watched.files = ListFiles(directory);
+    watched.listing = watched.files;
+
+#ifdef __linux__
+    if (useNative && inotifyHandle >= 0) {
+        watched.watchDescriptor = inotify_add_watch(inotifyHandle, directory.c_str(),
+            IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO);
+    }
+#endif // __linux__
+
+    directories.push_back(std::move(watched));
+}
+
+/**
+ * \brief Stops watching every directory.
+ */
+void AssetWatcher::Clear() {
+#ifdef __linux__
+    for (const WatchedDirectory& watched : directories) {
+        if (inotifyHandle >= 0 && watched.watchDescriptor >= 0) {
+            inotify_rm_watch(inotifyHandle, watched.watchDescriptor);
+        }
+    }
+#endif // __linux__
+    directories.clear();
+}
+
+/**
+ * \brief Collects pending file events and reports the batches that have settled.
+ *        Call once per frame from the main thread.
+ * \param deltaTime The time since the last call, in seconds.
+ */
+void AssetWatcher::Update(double deltaTime) {
+    ReadNativeEvents();
+
+    pollTimer += deltaTime;
+    const bool poll = pollTimer >= pollInterval;
+    if (poll) {
+        pollTimer = 0.0;
+    }
+
+    // Callbacks may call Watch, so directories is indexed instead of iterated
+    for (size_t index = 0; index < directories.size(); ++index) {
+        WatchedDirectory& watched = directories[index];
+        watched.quietTime += deltaTime;
+        if (poll && watched.watchDescriptor < 0) {
+            Rescan(watched);
+        }
+
+        // A polled directory only counts as settled once a later listing saw nothing new
+        const double settleTime = watched.watchDescriptor < 0 ? std::max(debounce, pollInterval) : debounce;
+        if (!watched.pending.empty() && watched.quietTime >= settleTime) {
+            Flush(watched);
+        }
+    }
+}
+
+/**
+ * \brief Checks if a directory is watched with native file events instead of polling.
+ * \param directory The directory passed to Watch.
+ * \return True if the directory has a native watch, false otherwise.
+ */
+bool AssetWatcher::IsNative(const std::string& directory) const {
+    for (const WatchedDirectory& watched : directories) {
+        if (watched.directory == directory) {
+            return watched.watchDescriptor >= 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief Lists the files of a directory the same way Utilities::getAssetFiles does.
+ * \param directory The directory to list.
+ * \return The files with their modification time and size.
+ */
+std::unordered_map<std::string, AssetWatcher::FileStamp> AssetWatcher::ListFiles(const std::string& directory) {
+    std::unordered_map<std::string, FileStamp> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (!entry.path().has_extension()) {
+            continue;
+        }
+        std::error_code statError;
+        auto writeTime = entry.last_write_time(statError);
+        auto size = entry.file_size(statError);
+        files[entry.path().string()] = { writeTime, statError ? 0 : size };
+    }
+    return files;
+}
+
+/**
+ * \brief Lists a polled directory again and records the differences as pending changes.
+ * \param watched The directory to compare.
+ */
+void AssetWatcher::Rescan(WatchedDirectory& watched) {
+    std::unordered_map<std::string, FileStamp> current = ListFiles(watched.directory);
+    bool changed = false;
+
+    // Compared with the previous poll, not the last report, so a finished write settles
+    for (const auto& [path, stamp] : current) {
+        auto previous = watched.listing.find(path);
+        if (previous == watched.listing.end() || previous->second != stamp) {
+            watched.pending.insert(path);
+            changed = true;
+        }
+    }
+    for (const auto& [path, stamp] : watched.listing) {
+        if (current.find(path) == current.end()) {
+            watched.pending.insert(path);
+            changed = true;
+        }
+    }
+
+    watched.listing = std::move(current);
+    if (changed) {
+        watched.quietTime = 0.0;
+    }
+}
+
+/**
+ * \brief Compares the pending paths of a directory with its last listing and reports them.
+ *        A file that was created and deleted again before this point is not reported.
+ * \param watched The directory to report.
+ */
+void AssetWatcher::Flush(WatchedDirectory& watched) {
+    std::vector<FileChange> changes;
+    changes.reserve(watched.pending.size());
+
+    for (const std::string& path : watched.pending) {
+        std::error_code error;
+        const bool exists = std::filesystem::is_regular_file(path, error);
+        auto known = watched.files.find(path);
+
+        if (!exists) {
+            if (known != watched.files.end()) {
+                watched.files.erase(known);
+                changes.push_back({ path, ChangeType::REMOVED });
+            }
+            continue;
+        }
+
+        FileStamp stamp{ std::filesystem::last_write_time(path, error), 0 };
+        stamp.second = std::filesystem::file_size(path, error);
+        if (error) {
+            stamp.second = 0;
+        }
+
+        if (known == watched.files.end()) {
+            watched.files[path] = stamp;
+            changes.push_back({ path, ChangeType::ADDED });
+        }
+        else if (known->second != stamp) {
+            known->second = stamp;
+            changes.push_back({ path, ChangeType::MODIFIED });
+        }
+    }
+    watched.pending.clear();
+
+    if (changes.empty()) {
+        return;
+    }
+
+    // Report in a stable order, callbacks rebuild index based Lua files from it
+    std::sort(changes.begin(), changes.end(),
+        [](const FileChange& left, const FileChange& right) { return left.path < right.path; });
+
+    // The callback may call Watch and move the directory, so it is called on a copy
+    ChangeCallback callback = watched.callback;
+    if (callback) {
+        callback(changes);
+    }
+}
+
+/**
+ * \brief Reads every queued inotify event without blocking.
+ */
+void AssetWatcher::ReadNativeEvents() {
+#ifdef __linux__
+    if (inotifyHandle < 0) {
+        return;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(inotifyHandle, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN means the queue is empty
+            return;
+        }
+
+        for (char* cursor = buffer; cursor < buffer + length; ) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were dropped, fall back to comparing full listings once
+                for (WatchedDirectory& watched : directories) {
+                    Rescan(watched);
+                }
+                continue;
+            }
+            if (event->len == 0 || (event->mask & IN_ISDIR)) {
+                continue;
+            }
+
+            for (WatchedDirectory& watched : directories) {
+                if (watched.watchDescriptor != event->wd) {
+                    continue;
+                }
+                std::filesystem::path path = std::filesystem::path(watched.directory) / event->name;
+                if (path.has_extension()) {
+                    watched.pending.insert(path.string());
+                    watched.quietTime = 0.0;
+                }
+                break;
+            }
+        }
+    }
+#endif // __linux__
+}
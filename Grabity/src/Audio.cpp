@@ -1,10 +1,10 @@
 /*!****************************************************************
 \file: Audio.cpp
 \author: Johny Yong Jun Siang, j.yong, 2301301
-\brief: Declares the Audio class for managing audio assets using the FMOD library.
+\brief: Declares the Audio class for managing audio assets through the AudioBackend.
 		Includes audio data with its type (background music,looping sound effects, or non-looping sound effects),
-		priority for audio, andadata like name and file path. It provides functionality to access audio properties and the FMOD::Sound
-		object, allowing straightforward integration with audio systems.
+		priority for audio, andadata like name and file path. It provides functionality to access audio properties and the backend
+		sound, allowing straightforward integration with audio systems.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -17,19 +17,48 @@ Technology is prohibited.
 #include "ImGuiConsole.h"
 #include "AudioManager.h"
 #include "Assetmanager.h"
+#include "VirtualFileSystem.h"
 /**
- * @brief Constructs an Audio object with the specified properties and loads the audio using FMOD.
+ * @brief Constructs an Audio object with the specified properties and loads the audio through the audio backend.
  * @param audioName The name of the audio file (identifier).
  * @param filePath The file path to the audio file.
  * @param type The type of the audio (e.g., NO_LOOP or looping sound effects).
  * @param audioPriority The priority level of the audio (higher priority is handled first).
+ * @param mode How the sound is held while loaded: decoded, compressed or streamed from the file.
  */
-Audio::Audio(const std::string& audioName, const std::string& filePath, AudioType type, int audioPriority)
-	: name(audioName), audioType(type), priority(audioPriority), audio(nullptr)
+Audio::Audio(const std::string& audioName, const std::string& filePath, AudioType type, int audioPriority, AudioBackend::LoadMode mode)
+	: name(audioName), path(filePath), audioType(type), priority(audioPriority), loadMode(mode), audio(AudioBackend::InvalidID)
 {
-	FMOD_MODE mode = (audioType == AudioType::NO_LOOP) ? FMOD_DEFAULT : FMOD_LOOP_NORMAL;
-	FMOD_RESULT result = AudioManager::GetInstance().GetSystem()->createSound(filePath.c_str(), mode, nullptr, &audio);
-	if (result != FMOD_OK) { 
+	Load();
+}
+/**
+ * @brief Destructor for the Audio object. Releases the backend sound if it exists.
+ */
+Audio::~Audio() {
+	Unload();
+}
+/**
+ * @brief Loads the sound from its file through the backend, if it is not loaded.
+ * @return True if the sound is loaded.
+ */
+bool Audio::Load() {
+	if (audio) {
+		return true;
+	}
+	AudioBackend& backend = AudioManager::GetInstance().GetBackend();
+	if (loadMode == AudioBackend::LoadMode::STREAMED) {
+		// Streams open the file themselves, through the StreamingBufferManager
+		audio = backend.CreateStream(path, audioType != AudioType::NO_LOOP);
+	}
+	else {
+		// Read through the virtual file system so audio can come from the asset pack.
+		// The backend copies or decodes the data, so the file does not have to outlive the sound.
+		VirtualFile file = VirtualFileSystem::GetInstance().Open(path);
+		if (file && file.GetSize() > 0) {
+			audio = backend.CreateSound(file.GetData(), file.GetSize(), audioType != AudioType::NO_LOOP, loadMode);
+		}
+	}
+	if (audio == AudioBackend::InvalidID) { 
 #ifdef _LOGGING
 		ImGuiConsole::Cout("Audio loading error: %s", name.c_str());
 #endif // _LOGGING
@@ -40,18 +69,34 @@ Audio::Audio(const std::string& audioName, const std::string& filePath, AudioTyp
 		ImGuiConsole::Cout("Audio creation success: %s", name.c_str());
 #endif // _LOGGING
 	}
+	return audio != AudioBackend::InvalidID;
 }
 /**
- * @brief Destructor for the Audio object. Releases the FMOD::Sound object if it exists.
+ * @brief Releases the backend sound. Its properties are kept so it can be loaded again.
  */
-Audio::~Audio() {
-	if (audio) { audio->release(); }
+void Audio::Unload() {
+	if (audio) { AudioManager::GetInstance().GetBackend().ReleaseSound(audio); }
+	audio = AudioBackend::InvalidID;
 }
 /**
- * @brief Retrieves the FMOD::Sound object associated with this Audio.
- * @return A pointer to the FMOD::Sound object.
+ * @brief Checks if the backend sound is loaded.
+ * @return True if the sound is loaded.
  */
-FMOD::Sound* Audio::GetAudio() const {
+bool Audio::IsLoaded() const {
+	return audio != AudioBackend::InvalidID;
+}
+/**
+ * @brief Retrieves the file the audio is loaded from.
+ * @return The file path.
+ */
+const std::string& Audio::GetFilePath() const {
+	return path;
+}
+/**
+ * @brief Retrieves the backend sound associated with this Audio.
+ * @return The sound, AudioBackend::InvalidID if it failed to load.
+ */
+AudioBackend::SoundID Audio::GetAudio() const {
 	return audio;
 }
 /**
@@ -74,4 +119,20 @@ int Audio::GetPriority() const {
  */
 std::string Audio::GetAudioName() const {
 	return name;
+}
+/**
+ * @brief Retrieves how the sound is held while loaded.
+ * @return The load mode.
+ */
+AudioBackend::LoadMode Audio::GetLoadMode() const {
+	return loadMode;
+}
+/**
+ * @brief Retrieves the load mode of an audio type with none set in sounds.lua.
+ *        Music is streamed, sound effects are decoded so they start without delay.
+ * @param type The type of the audio.
+ * @return The load mode.
+ */
+AudioBackend::LoadMode Audio::GetDefaultLoadMode(AudioType type) {
+	return type == AudioType::BGM ? AudioBackend::LoadMode::STREAMED : AudioBackend::LoadMode::DECOMPRESSED;
 }
\ No newline at end of file
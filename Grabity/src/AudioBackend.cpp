@@ -0,0 +1,86 @@
+/*!****************************************************************
+\file: AudioBackend.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Creates the AudioBackend named in config.lua: FMOD for the
+        game, or the software mixer rendering to nowhere or to a WAV
+        file. Builds defined with _NO_FMOD only have the software
+        mixer.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "AudioBackend.h"
+#include "SoftwareAudioBackend.h"
+#include "FmodAudioBackend.h"
+#include "ImGuiConsole.h"
+#include <cstring>
+
+// Creates a backend by name.
+std::unique_ptr<AudioBackend> AudioBackend::Create(const std::string& type, const std::string& outputPath) {
+    if (type == "wav") {
+        return std::make_unique<SoftwareAudioBackend>(SoftwareAudioBackend::Sink::WAV_FILE, outputPath.empty() ? "AudioMix.wav" : outputPath);
+    }
+    if (type == "null") {
+        return std::make_unique<SoftwareAudioBackend>(SoftwareAudioBackend::Sink::NONE);
+    }
+#ifndef _NO_FMOD
+    if (type.empty() || type == "fmod") {
+        return std::make_unique<FmodAudioBackend>();
+    }
+#endif // !_NO_FMOD
+    ImGuiConsole::Cout("Audio backend '%s' is not available, using the null backend", type.empty() ? "fmod" : type.c_str());
+    return std::make_unique<SoftwareAudioBackend>(SoftwareAudioBackend::Sink::NONE);
+}
+
+// Reads a load mode from its name in sounds.lua.
+AudioBackend::LoadMode AudioBackend::ParseLoadMode(const std::string& name, LoadMode fallback) {
+    if (name == "decompressed") {
+        return LoadMode::DECOMPRESSED;
+    }
+    if (name == "compressed") {
+        return LoadMode::COMPRESSED;
+    }
+    if (name == "streamed") {
+        return LoadMode::STREAMED;
+    }
+    if (!name.empty()) {
+        ImGuiConsole::Cout("Unknown audio load mode '%s', using %s", name.c_str(), GetLoadModeName(fallback));
+    }
+    return fallback;
+}
+
+// Names the format of a sound file from its first bytes.
+const char* AudioBackend::GetFileFormatName(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    if (!bytes || size < 4) {
+        return "unknown";
+    }
+    if (std::memcmp(bytes, "RIFF", 4) == 0) {
+        return "WAV";
+    }
+    if (std::memcmp(bytes, "OggS", 4) == 0) {
+        return "OGG";
+    }
+    if (std::memcmp(bytes, "fLaC", 4) == 0) {
+        return "FLAC";
+    }
+    // An ID3 tag, or straight into an MPEG frame sync
+    if (std::memcmp(bytes, "ID3", 3) == 0 || (bytes[0] == 0xFF && (bytes[1] & 0xE0) == 0xE0)) {
+        return "MP3";
+    }
+    return "unknown";
+}
+
+// Retrieves the name of a load mode as written in sounds.lua.
+const char* AudioBackend::GetLoadModeName(LoadMode mode) {
+    switch (mode) {
+    case LoadMode::COMPRESSED:
+        return "compressed";
+    case LoadMode::STREAMED:
+        return "streamed";
+    default:
+        return "decompressed";
+    }
+}
@@ -32,7 +32,7 @@ AudioComponent::AudioComponent()
  * @brief Constructor that initializes the AudioComponent with a parent GameObject.
  * @param parent The parent GameObject associated with this component.
  */
-AudioComponent::AudioComponent(GameObject* parent) : Component(parent), currentChannel(nullptr), audioClipIDs(0) {}
+AudioComponent::AudioComponent(GameObject* parent) : Component(parent), currentChannel(AudioBackend::InvalidID), audioClipIDs(0) {}
 
 /**
  * @brief Destructor for the AudioComponent. Stops any audio currently playing and clears the audio clip list.
@@ -56,12 +56,7 @@ void AudioComponent::AddAudioClip(int audioID) {
  */
 void AudioComponent::PlayAudio(int audioID) {
     if (currentChannel) {
-        bool isPlaying = false;
-        currentChannel->isPlaying(&isPlaying);
-
-        if (isPlaying) {
-            currentChannel->stop();
-        }
+        AudioManager::GetInstance().GetBackend().Stop(currentChannel);
     }
 
     AudioManager::GetInstance().PlayAudio(audioID, &currentChannel);
@@ -77,8 +72,8 @@ void AudioComponent::PlayAudio(int audioID) {
  */
 void AudioComponent::StopAudio() {
     if (currentChannel) {
-        currentChannel->stop();
-        currentChannel = nullptr;  // Clear the channel once the audio is stopped
+        AudioManager::GetInstance().GetBackend().Stop(currentChannel);
+        currentChannel = AudioBackend::InvalidID;  // Clear the channel once the audio is stopped
     }
 }
 
@@ -91,12 +86,9 @@ void AudioComponent::Update() {
     if (!GetActive()) { return; }
 
     if (currentChannel) {
-        bool isPlaying = false;
-        FMOD_RESULT result = currentChannel->isPlaying(&isPlaying);
-
         // If the channel is no longer playing, clear it
-        if (result != FMOD_OK || !isPlaying) {
-            currentChannel = nullptr;
+        if (!AudioManager::GetInstance().GetBackend().IsPlaying(currentChannel)) {
+            currentChannel = AudioBackend::InvalidID;
         }
     }
 }
@@ -157,11 +149,9 @@ std::string AudioComponent::DebugInfo() const {
 void AudioComponent::RemoveAudioClip(int audioID) {
     // Stop the audio if it's currently playing and matches the ID being removed
     if (currentChannel) {
-        bool isPlaying = false;
-        currentChannel->isPlaying(&isPlaying);
-        if (isPlaying) {
-            currentChannel->stop();
-            currentChannel = nullptr;
+        if (AudioManager::GetInstance().GetBackend().IsPlaying(currentChannel)) {
+            AudioManager::GetInstance().GetBackend().Stop(currentChannel);
+            currentChannel = AudioBackend::InvalidID;
         }
     }
 
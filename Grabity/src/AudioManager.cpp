@@ -2,7 +2,7 @@
 \file: AudioManager.h
 \author: Johny Yong Jun Siang, j.yong, 2301301
 \co-author: Lee Yu Jie Brandon, l.yujiebrandon, 2301232
-\brief: Defines functions declared in AudioManager.h, which manages audio playbackand system initialization using the FMOD library.
+\brief: Defines functions declared in AudioManager.h, which manages audio playbackand system initialization through an AudioBackend, FMOD by default.
         Handles background music (BGM) and sound effects (SFX) through volume control, audio channel management, and basic audio operations
         such as play, pause, resume, and stop. It uses a singleton pattern to ensure only one audio system instance exists. The audio manager 
         maintains a pool of active channels, lists active channels for debugging, and updates the audio system each frame
@@ -18,8 +18,11 @@ Technology is prohibited.
 #include "AudioManager.h"
 #include "Assetmanager.h"
 #include "Audio.h"
+#include "LuaConfig.h"
+#include "StreamingBufferManager.h"
 #include <chrono>
 #include <thread>
+#include <algorithm>
 #ifdef _IMGUI
 #include <iostream>
 #include "ImGuiConsole.h"
@@ -33,7 +36,7 @@ AudioManager& AudioManager::GetInstance()
 }
 
 // Constructs an AudioManager object and initializes the audio system.
-AudioManager::AudioManager() : audioSystem(nullptr), bgmChannel(nullptr), bgmVolume(1.f), sfxVolume(1.f), masterVolume(1.0f), bgmVolumeRaw(1.0f), sfxVolumeRaw(1.0f) {
+AudioManager::AudioManager() : bgmChannel(AudioBackend::InvalidID), bgmVolume(1.f), sfxVolume(1.f), masterVolume(1.0f), bgmVolumeRaw(1.0f), sfxVolumeRaw(1.0f) {
     InitSystem();
 }
 
@@ -42,18 +45,37 @@ AudioManager::~AudioManager() {
     ReleaseSystem();
 }
 
-// Initializes the FMOD audio system with a specified maximum number of channels.
+// Initializes the audio backend named in config.lua with a specified maximum number of channels.
 void AudioManager::InitSystem(int maxChannels) {
-    FMOD_RESULT result = FMOD::System_Create(&audioSystem);
-    if (result != FMOD_OK) {
-        ImGuiConsole::Cout("FMOD System creation failure");
-    }
-
-    audioSystem->init(maxChannels, FMOD_INIT_NORMAL, nullptr);
-
-    // Optional: improve real-time fade response
-    audioSystem->setSoftwareFormat(0, FMOD_SPEAKERMODE_DEFAULT, 0);
-    audioSystem->setDSPBufferSize(1024, 4); // Smaller buffer for responsiveness
+    // Created first so it is destroyed after this manager, which closes the streams still playing
+    StreamingBufferManager::GetInstance();
+
+    // Audio = { Backend = { Type = "null" } } runs the game without FMOD or a sound device
+    std::string backendType;
+    std::string backendOutput;
+    LuaManager luaManager("Assets/Lua/config.lua");
+    if (luaManager.TableExists("Audio", "Backend")) {
+        backendType = luaManager.LuaRead<std::string>("Audio", { "Backend", "Type" });
+        if (backendType == "wav") {
+            backendOutput = luaManager.LuaRead<std::string>("Audio", { "Backend", "Output" });
+        }
+    }
+
+    backend = AudioBackend::Create(backendType, backendOutput);
+    if (!backend->Init(maxChannels)) {
+        ImGuiConsole::Cout("Audio backend %s failed to start, using the null backend", backend->GetName());
+        backend = AudioBackend::Create("null", "");
+        backend->Init(maxChannels);
+    }
+    ImGuiConsole::Cout("Audio backend: %s", backend->GetName());
+
+    // A crowd of enemies hit on the same frame is heard as a few voices, not dozens
+    VoiceManager::Limits sfxLimits;
+    sfxLimits.maxInstances = 4;
+    sfxLimits.steal = VoiceManager::StealPolicy::STEAL_OLDEST;
+    sfxLimits.cooldown = 0.05;
+    voiceManager.SetDefaultLimits(sfxLimits);
+    lastUpdate = std::chrono::steady_clock::now();
 }
 
 
@@ -63,43 +85,57 @@ void AudioManager::ReleaseSystem() {
         delete audio.second;
     }
     AssetManager::GetInstance().audioObjects.clear();
-    audioSystem->close();
-    audioSystem->release();
+    managedVoices.clear();
+    voiceManager.ReleaseAll();
+    audioChannels.clear();
+    bgmChannel = AudioBackend::InvalidID;
+    if (backend) {
+        backend->Release();
+    }
 }
 
-// Retrieves the FMOD audio system.
-FMOD::System* AudioManager::GetSystem() const {
-    return audioSystem;
+// Retrieves the audio backend that sounds and channels are played through.
+AudioBackend& AudioManager::GetBackend() const {
+    return *backend;
 }
 
 // Plays an audio based on the given audio ID and stores the playback channel in the provided output.
-void AudioManager::PlayAudio(int audioID, FMOD::Channel** channelOut) {
-    std::map<int, Audio*>::iterator it = AssetManager::GetInstance().audioObjects.find(audioID);
+void AudioManager::PlayAudio(int audioID, AudioBackend::ChannelID* channelOut) {
+    // Loads the sound again if the asset manager unloaded it
+    Audio* audio = AssetManager::GetInstance().GetAudio(audioID);
 
-    if (it != AssetManager::GetInstance().audioObjects.end()) {
-        Audio* audio = it->second;
-        FMOD::Channel* channel = nullptr;
+    if (audio) {
+        AudioBackend::ChannelID channel = AudioBackend::InvalidID;
 
         if (audio->GetType() == AudioType::BGM && bgmChannel) {
             FadeOutAudio(bgmChannel, 1);
-            bgmChannel = nullptr;
+            bgmChannel = AudioBackend::InvalidID;
+        }
+
+        VoiceManager::VoiceHandle voice = VoiceManager::InvalidVoice;
+        if (audio->GetType() != AudioType::BGM && !AdmitVoice(audioID, audio, 1.0f, voice)) {
+            if (channelOut) {
+                *channelOut = AudioBackend::InvalidID;
+            }
+            return;
         }
 
         //Normal play audio
-        audioSystem->playSound(audio->GetAudio(), nullptr, false, &channel);
+        channel = backend->Play(audio->GetAudio(), false);
 
         //Setting of volume before playing
         if (channel) {
             if (audio->GetType() != AudioType::BGM) {
-                channel->setVolume(sfxVolume);
+                backend->SetVolume(channel, sfxVolume);
                 audioChannels[audioID].push_back(channel);
+                TrackVoice(channel, voice, audioID, 1.0f);
             }
             else {
-                channel->setVolume(bgmVolume);
+                backend->SetVolume(channel, bgmVolume);
                 bgmChannel = channel;
             }
 
-            channel->setPriority(audio->GetPriority());
+            backend->SetPriority(channel, audio->GetPriority());
 
             if (channelOut) {
                 *channelOut = channel;
@@ -109,18 +145,11 @@ void AudioManager::PlayAudio(int audioID, FMOD::Channel** channelOut) {
 }
 
 void AudioManager::PlayAudio(int audioID) {
-    AudioManager::GetInstance().GetSystem()->mixerSuspend();
-    AudioManager::GetInstance().GetSystem()->mixerResume();
-
-    auto it = AssetManager::GetInstance().audioObjects.find(audioID);
-    if (it != AssetManager::GetInstance().audioObjects.end()) {
-        Audio* audio = it->second;
+    Audio* audio = AssetManager::GetInstance().GetAudio(audioID);
+    if (audio) {
 
         if (audio->GetType() == AudioType::BGM && bgmChannel) {
-            FMOD::Sound* currentSound = nullptr;
-            bgmChannel->getCurrentSound(&currentSound);
-
-            if (currentSound == audio->GetAudio()) {
+            if (backend->GetSound(bgmChannel) == audio->GetAudio()) {
                 // Same BGM is already playing
                 ImGuiConsole::Cout("PlayAudio: BGM %d already playing, skipping replay.", audioID);
                 return;
@@ -138,92 +167,53 @@ void AudioManager::PlayAudio(int audioID) {
 }
 
 void AudioManager::Update() {
+    // Real time, so fades and filter sweeps last as long at 30 FPS as at 240 FPS
+    const auto now = std::chrono::steady_clock::now();
+    const float deltaTime = std::chrono::duration<float>(now - lastUpdate).count();
+    lastUpdate = now;
+
+    ProcessCommands();
     CleanUpChannels();
-    audioSystem->update();
+    UpdateVoices(deltaTime);
+    backend->Update();
 
-    float deltaTime = 1.0f / 60.0f;
     bool bgmFadeCompleted = false;
 
     // --- Fade-out logic ---
+    // The backend ramps the volume and stops the channel on the fade's last sample;
+    // the elapsed time only catches a backend that has not stopped it yet
     for (auto it = fadingOutChannels.begin(); it != fadingOutChannels.end(); ) {
         FadeOutInfo& fade = *it;
         fade.elapsedTime += deltaTime;
 
-        bool isPlaying = false;
-        fade.channel->isPlaying(&isPlaying);
-
-        if (!isPlaying) {
-            it = fadingOutChannels.erase(it);
-            continue;
-        }
-
-        float t = fade.elapsedTime / fade.fadeDuration;
-        if (t >= 1.0f) {
-            fade.channel->setVolume(0.01f);
-            fade.channel->stop();  // <-- force stop
-            it = fadingOutChannels.erase(it);
-
-            if (fade.channel == bgmChannel) {
-                bgmChannel = nullptr;
-                bgmFadeCompleted = true;
-            }
-        }
-        else {
-            float newVolume = fade.initialVolume * (1.0f - t);
-            fade.channel->setVolume(newVolume);
+        if (backend->IsPlaying(fade.channel) && fade.elapsedTime < fade.fadeDuration) {
             ++it;
-        }
-    }
-
-    // --- Fade-in logic ---
-    for (auto it = fadingInChannels.begin(); it != fadingInChannels.end(); ) {
-        FadeInInfo& fade = *it;
-        fade.elapsedTime += deltaTime;
-
-        bool isPlaying = false;
-        fade.channel->isPlaying(&isPlaying);
-
-        if (!isPlaying) {
-            it = fadingInChannels.erase(it);
             continue;
         }
 
-        float t = fade.elapsedTime / fade.fadeDuration;
-        if (t >= 1.0f) {
-            fade.channel->setVolume(fade.targetVolume);
-            fade.channel->setPaused(false); // Ensure it's unpaused at end
-            it = fadingInChannels.erase(it);
-        }
-        else {
-            float newVolume = fade.targetVolume * t;
-
-            if (newVolume > 0.01f) {
-                bool isPaused = true;
-                fade.channel->getPaused(&isPaused);
-                if (isPaused)
-                    fade.channel->setPaused(false); // Unpause gradually during fade-in
-            }
-
-            fade.channel->setVolume(newVolume);
-            ++it;
+        backend->Stop(fade.channel);
+        if (fade.channel == bgmChannel) {
+            bgmChannel = AudioBackend::InvalidID;
+            bgmFadeCompleted = true;
         }
+        it = fadingOutChannels.erase(it);
     }
 
     // --- Low-pass transition logic ---
-    if (lpTransition.active && lpTransition.channel && lowPassDSP) {
+    if (lpTransition.active && lpTransition.channel) {
         lpTransition.elapsed += deltaTime;
         float t = std::min(lpTransition.elapsed / lpTransition.duration, 1.0f);
         float interpolatedCutoff = lpTransition.startFrequency +
             (lpTransition.targetFrequency - lpTransition.startFrequency) * t;
 
-        lowPassDSP->setParameterFloat(FMOD_DSP_LOWPASS_CUTOFF, interpolatedCutoff);
+        backend->SetLowPass(lpTransition.channel, interpolatedCutoff);
 
         if (t >= 1.0f) {
             lpTransition.active = false;
 
             // If fading back to full clarity, remove DSP
             if (lpTransition.targetFrequency >= 19900.0f) {
-                lpTransition.channel->removeDSP(lowPassDSP);
+                backend->SetLowPass(lpTransition.channel, AudioBackend::LowPassOff);
 #ifdef _IMGUI
                 ImGuiConsole::Cout("Low-pass filter removed after smooth transition.");
 #endif
@@ -238,42 +228,180 @@ void AudioManager::Update() {
     }
 }
 
+// Queues an audio to play on the next Update.
+void AudioManager::PostPlay(int audioID) {
+    AudioCommand command;
+    command.type = AudioCommand::Type::PLAY;
+    command.audioID = audioID;
+    Post(command);
+}
+
+// Queues an SFX to play at a position in the world on the next Update.
+void AudioManager::PostPlayAt(int audioID, const Vector2& position) {
+    AudioCommand command;
+    command.type = AudioCommand::Type::PLAY_AT;
+    command.audioID = audioID;
+    command.position = position;
+    Post(command);
+}
+
+// Queues stopping an audio on the next Update.
+void AudioManager::PostStop(int audioID) {
+    AudioCommand command;
+    command.type = AudioCommand::Type::STOP;
+    command.audioID = audioID;
+    Post(command);
+}
+
+// Queues setting the volume of an audio on the next Update.
+void AudioManager::PostChannelVolume(int audioID, float volume) {
+    AudioCommand command;
+    command.type = AudioCommand::Type::SET_VOLUME;
+    command.audioID = audioID;
+    command.volume = volume;
+    Post(command);
+}
+
+// Queues fading out and stopping every channel of an audio on the next Update.
+void AudioManager::PostFadeOut(int audioID, float duration) {
+    AudioCommand command;
+    command.type = AudioCommand::Type::FADE_OUT;
+    command.audioID = audioID;
+    command.duration = duration;
+    Post(command);
+}
+
+// Queues fading in every channel of an audio on the next Update.
+void AudioManager::PostFadeIn(int audioID, float duration, float targetVolume) {
+    AudioCommand command;
+    command.type = AudioCommand::Type::FADE_IN;
+    command.audioID = audioID;
+    command.duration = duration;
+    command.volume = targetVolume;
+    Post(command);
+}
+
+// Adds up the memory the loaded sounds take in their load modes and decoded.
+AudioMemoryReport AudioManager::GetMemoryReport() const {
+    AudioMemoryReport report;
+    for (const auto& [id, audio] : AssetManager::GetInstance().audioObjects) {
+        if (!audio || !audio->GetAudio()) {
+            continue;
+        }
+        AudioBackend::SoundMemory memory = backend->GetSoundMemory(audio->GetAudio());
+        ++report.sounds[static_cast<int>(audio->GetLoadMode())];
+        report.residentBytes += memory.resident;
+        report.decodedBytes += memory.decoded;
+    }
+    report.streamBufferBytes = StreamingBufferManager::GetInstance().GetStats().bufferBytes;
+    return report;
+}
+
+// Queues a command for the next Update, dropping it if the queue is full.
+void AudioManager::Post(const AudioCommand& command) {
+    if (!commands.TryPush(command)) {
+        // A full queue means hundreds of sounds in one frame; losing one is better than stalling the game
+        ++droppedCommands;
+#ifdef _LOGGING
+        ImGuiConsole::Cout("Audio command queue full, dropped command for audio %d", command.audioID);
+#endif // _LOGGING
+    }
+}
+
+// Carries out every queued command in the order it was posted.
+void AudioManager::ProcessCommands() {
+    AudioCommand command;
+    while (commands.TryPop(command)) {
+        switch (command.type) {
+        case AudioCommand::Type::PLAY:
+            PlayAudio(command.audioID);
+            break;
+        case AudioCommand::Type::PLAY_AT:
+            PlayAudioAt(command.audioID, command.position);
+            break;
+        case AudioCommand::Type::STOP:
+            StopAudio(command.audioID);
+            break;
+        case AudioCommand::Type::SET_VOLUME:
+            SetChannelVolume(command.audioID, command.volume);
+            break;
+        case AudioCommand::Type::FADE_OUT:
+            for (AudioBackend::ChannelID channel : GetChannels(command.audioID)) {
+                FadeOutAudio(channel, command.duration);
+            }
+            break;
+        case AudioCommand::Type::FADE_IN:
+            for (AudioBackend::ChannelID channel : GetChannels(command.audioID)) {
+                FadeInAudio(channel, command.duration, command.volume);
+            }
+            break;
+        }
+    }
+}
+
+// Retrieves the channels playing an audio ID, the BGM channel included.
+std::vector<AudioBackend::ChannelID> AudioManager::GetChannels(int audioID) const {
+    std::vector<AudioBackend::ChannelID> channels;
+    auto audio = AssetManager::GetInstance().audioObjects.find(audioID);
+    if (bgmChannel && audio != AssetManager::GetInstance().audioObjects.end() && audio->second->GetType() == AudioType::BGM &&
+        backend->GetSound(bgmChannel) == audio->second->GetAudio()) {
+        channels.push_back(bgmChannel);
+    }
+    auto it = audioChannels.find(audioID);
+    if (it != audioChannels.end()) {
+        channels.insert(channels.end(), it->second.begin(), it->second.end());
+    }
+    return channels;
+}
+
+// Counts the channels playing an audio ID, the BGM channel included.
+int AudioManager::GetPlayingChannelCount(int audioID) const {
+    int playing = 0;
+    for (AudioBackend::ChannelID channel : GetChannels(audioID)) {
+        playing += backend->IsPlaying(channel) ? 1 : 0;
+    }
+    return playing;
+}
+
 
 void AudioManager::PlayAudioImmediately(int audioID) {
 
     ImGuiConsole::Cout("Trying Play Audio: %d", audioID);
 
-    auto it = AssetManager::GetInstance().audioObjects.find(audioID);
+    Audio* audio = AssetManager::GetInstance().GetAudio(audioID);
 
-    if (it != AssetManager::GetInstance().audioObjects.end()) {
-        Audio* audio = it->second;
-        FMOD::Channel* channel = nullptr;
+    if (audio) {
+        VoiceManager::VoiceHandle voice = VoiceManager::InvalidVoice;
+        if (audio->GetType() != AudioType::BGM && !AdmitVoice(audioID, audio, 1.0f, voice)) {
+            return;
+        }
 
         // Start the sound in a paused state
-        audioSystem->playSound(audio->GetAudio(), nullptr, true, &channel);
+        AudioBackend::ChannelID channel = backend->Play(audio->GetAudio(), true);
 
         if (channel) {
             if (audio->GetType() != AudioType::BGM) {
-                channel->setVolume(sfxVolume);
+                backend->SetVolume(channel, sfxVolume);
 
                 // Special pop-fix for IDs 30 and 31 only
                 if (audioID == 30 || audioID == 31) {
-                    channel->setPaused(true);
+                    backend->SetPaused(channel, true);
                     FadeInAudio(channel, 1.0f, 0.1f); // Fade in
                 }
                 else {
-                    channel->setPaused(false); // Standard SFX
+                    backend->SetPaused(channel, false); // Standard SFX
                 }
 
                 audioChannels[audioID].push_back(channel);
+                TrackVoice(channel, voice, audioID, 1.0f);
             }
 
             else {
-                channel->setVolume(0.0f); // Stay silent
-                channel->setMode(FMOD_LOOP_NORMAL | FMOD_2D);
-                channel->setPriority(255);
+                backend->SetVolume(channel, 0.0f); // Stay silent
+                backend->SetLooping(channel, true);
+                backend->SetPriority(channel, 255);
                 if (bgmChannel && bgmChannel != channel) {
-                    bgmChannel->stop(); // Ensure previous BGM is dead
+                    backend->Stop(bgmChannel); // Ensure previous BGM is dead
                 }
                 bgmChannel = channel;
                 //unsigned long long dspClock;
@@ -282,25 +410,116 @@ void AudioManager::PlayAudioImmediately(int audioID) {
                 FadeInAudio(bgmChannel, 1.f, bgmVolume); // Fade in
             }
 
-            channel->setPriority(audio->GetPriority());
+            backend->SetPriority(channel, audio->GetPriority());
+        }
+    }
+}
+
+// Plays an SFX at a position in the world, attenuated by its distance to the listener.
+void AudioManager::PlayAudioAt(int audioID, const Vector2& position) {
+    Audio* audio = AssetManager::GetInstance().GetAudio(audioID);
+    if (!audio) {
+        return;
+    }
+    if (audio->GetType() == AudioType::BGM) {
+        PlayAudio(audioID);
+        return;
+    }
+
+    const float distance = Vector2::Distance(listenerPosition, position);
+    const float attenuation = std::clamp((rolloffMaxDistance - distance) / (rolloffMaxDistance - rolloffMinDistance), 0.0f, 1.0f);
+
+    VoiceManager::VoiceHandle voice = VoiceManager::InvalidVoice;
+    if (!AdmitVoice(audioID, audio, attenuation, voice)) {
+        return;
+    }
+
+    AudioBackend::ChannelID channel = backend->Play(audio->GetAudio(), true);
+    if (channel) {
+        audioChannels[audioID].push_back(channel);
+        TrackVoice(channel, voice, audioID, attenuation);
+        backend->SetVolume(channel, GetSFXChannelVolume(channel, audioID));
+        backend->SetPriority(channel, audio->GetPriority());
+        backend->SetPaused(channel, false);
+    }
+    else {
+        voiceManager.Release(voice);
+    }
+}
+
+// Asks the voice manager for a voice and stops the voices it steals for it.
+bool AudioManager::AdmitVoice(int audioID, const Audio* audio, float attenuation, VoiceManager::VoiceHandle& voiceOut) {
+    const float raw = sfxRawVolumes.count(audioID) ? sfxRawVolumes[audioID] : 1.0f;
+    VoiceManager::Admission admission = voiceManager.Request(audioID, audio->GetPriority(), sfxVolume * raw * attenuation);
+
+    for (VoiceManager::VoiceHandle stolen : admission.stolen) {
+        for (auto voiceIt = managedVoices.begin(); voiceIt != managedVoices.end(); ++voiceIt) {
+            if (voiceIt->second.voice == stolen) {
+                backend->Stop(voiceIt->first);
+                managedVoices.erase(voiceIt);
+                break;
+            }
         }
     }
 
+    voiceOut = admission.voice;
+    return admission.voice != VoiceManager::InvalidVoice;
+}
+
+// Remembers which voice a newly started SFX channel belongs to.
+void AudioManager::TrackVoice(AudioBackend::ChannelID channel, VoiceManager::VoiceHandle voice, int audioID, float attenuation) {
+    if (!channel) {
+        voiceManager.Release(voice);
+        return;
+    }
+    managedVoices[channel] = { voice, audioID, attenuation };
+}
 
+// Retrieves the final volume of an SFX channel from the SFX volume, its raw volume and its attenuation.
+float AudioManager::GetSFXChannelVolume(AudioBackend::ChannelID channel, int audioID) {
+    const float raw = sfxRawVolumes.count(audioID) ? sfxRawVolumes[audioID] : 1.0f;
+    auto it = managedVoices.find(channel);
+    const float attenuation = it != managedVoices.end() ? it->second.attenuation : 1.0f;
+    return sfxVolume * raw * attenuation;
+}
+
+// Advances the voice clock and mutes or unmutes channels that became virtual or real.
+void AudioManager::UpdateVoices(float deltaTime) {
+    voiceManager.Advance(deltaTime);
+
+    for (auto& [channel, managed] : managedVoices) {
+        voiceManager.SetAudibility(managed.voice, GetSFXChannelVolume(channel, managed.audioID));
+    }
+
+    std::vector<VoiceManager::VoiceHandle> becameReal;
+    std::vector<VoiceManager::VoiceHandle> becameVirtual;
+    voiceManager.UpdateVirtualisation(becameReal, becameVirtual);
+    if (becameReal.empty() && becameVirtual.empty()) {
+        return;
+    }
+    // Muting keeps the channel's position in the sound, so it resumes in step when it becomes real again
+    for (auto& [channel, managed] : managedVoices) {
+        if (std::find(becameVirtual.begin(), becameVirtual.end(), managed.voice) != becameVirtual.end()) {
+            backend->SetMute(channel, true);
+        }
+        else if (std::find(becameReal.begin(), becameReal.end(), managed.voice) != becameReal.end()) {
+            backend->SetMute(channel, false);
+        }
+    }
 }
 
 // Pauses all audio currently being played.
 void AudioManager::PauseAllAudio() {
     //Pause the background music channel if it's playing
     if (bgmChannel) {
-        bgmChannel->setPaused(true);
+        backend->SetPaused(bgmChannel, true);
     }
 
     //Pause all other audio channels
     for (auto& pair : audioChannels) {  
-        for (FMOD::Channel* channel : pair.second) {  //Iterate over each channel in the vector
+        for (AudioBackend::ChannelID channel : pair.second) {  //Iterate over each channel in the vector
             if (channel) {
-                channel->setPaused(true);  //Pause each channel
+                backend->SetPaused(channel, true);  //Pause each channel
             }
         }
     }
@@ -311,14 +530,14 @@ void AudioManager::ResumeAllAudio()
 {
     //Pause the background music channel if it's playing
     if (bgmChannel) {
-        bgmChannel->setPaused(false);
+        backend->SetPaused(bgmChannel, false);
     }
 
     //Pause all other audio channels
     for (auto& pair : audioChannels) {
-        for (FMOD::Channel* channel : pair.second) {  //Iterate over each channel in the vector
+        for (AudioBackend::ChannelID channel : pair.second) {  //Iterate over each channel in the vector
             if (channel) {
-                channel->setPaused(false);  //Pause each channel
+                backend->SetPaused(channel, false);  //Pause each channel
             }
         }
     }
@@ -334,17 +553,17 @@ void AudioManager::PauseAudio(int audioID) {
     //Checks if it is the BGM
     if (AssetManager::GetInstance().audioObjects.find(audioID) != AssetManager::GetInstance().audioObjects.end() && AssetManager::GetInstance().audioObjects[audioID]->GetType() == AudioType::BGM) {
         if (bgmChannel) {
-            bgmChannel->setPaused(true);
+            backend->SetPaused(bgmChannel, true);
         }
     }
 
     if (it != audioChannels.end())
     {
-        for (FMOD::Channel* channel : it->second)
+        for (AudioBackend::ChannelID channel : it->second)
         {
             if (channel)
             {
-                channel->setPaused(true);
+                backend->SetPaused(channel, true);
             }
         }
     }
@@ -356,15 +575,15 @@ void AudioManager::ResumeAudio(int audioID) {
     //Checks if it is the BGM
     if (AssetManager::GetInstance().audioObjects.find(audioID) != AssetManager::GetInstance().audioObjects.end() && AssetManager::GetInstance().audioObjects[audioID]->GetType() == AudioType::BGM) {
         if (bgmChannel) {
-            bgmChannel->setPaused(false);
+            backend->SetPaused(bgmChannel, false);
         }
     }
 
     // Resume all other channels associated with this audio ID
     if (it != audioChannels.end()) {
-        for (FMOD::Channel* channel : it->second) {
+        for (AudioBackend::ChannelID channel : it->second) {
             if (channel) {
-                channel->setPaused(false);
+                backend->SetPaused(channel, false);
             }
         }
     }
@@ -376,17 +595,17 @@ void AudioManager::StopAudio(int audioID) {
     //Checks if it is the BGM
     if (AssetManager::GetInstance().audioObjects.find(audioID) != AssetManager::GetInstance().audioObjects.end() && AssetManager::GetInstance().audioObjects[audioID]->GetType() == AudioType::BGM) {
         if (bgmChannel) {
-            bgmChannel->stop();
-            bgmChannel = nullptr; // Clear the BGM channel after stopping
+            backend->Stop(bgmChannel);
+            bgmChannel = AudioBackend::InvalidID; // Clear the BGM channel after stopping
             ImGuiConsole::Cout("BGM has stopped! Restarting...\n");
         }
     }
 
     //For all others
     if (it != audioChannels.end()) {
-        for (FMOD::Channel* channel : it->second) {
+        for (AudioBackend::ChannelID channel : it->second) {
             if (channel) {
-                channel->stop();
+                backend->Stop(channel);
             }
         }
     }
@@ -397,27 +616,33 @@ void AudioManager::StopAudio(int audioID) {
 void AudioManager::StopAllAudio() {
     // Stop BGM if active
     if (bgmChannel) {
-        bgmChannel->stop();
-        bgmChannel = nullptr;
+        backend->Stop(bgmChannel);
+        bgmChannel = AudioBackend::InvalidID;
         ImGuiConsole::Cout("StopAllAudio: BGM channel stopped.");
     }
 
     // Stop all other SFX channels
     for (auto& pair : audioChannels) {
-        for (FMOD::Channel* channel : pair.second) {
+        for (AudioBackend::ChannelID channel : pair.second) {
             if (channel) {
-                channel->stop();
+                backend->Stop(channel);
             }
         }
     }
 
     // Clear the channel map
     audioChannels.clear();
+    managedVoices.clear();
+    voiceManager.ReleaseAll();
 
     // Clear any fading or low-pass transitions
     fadingOutChannels.clear();
-    fadingInChannels.clear();
-    lpTransition = { nullptr, 0.f, 0.f, 0.f, 0.f, false };
+    lpTransition = { AudioBackend::InvalidID, 0.f, 0.f, 0.f, 0.f, false };
+
+    // Sounds posted by the scene being left must not start in the next one
+    AudioCommand discarded;
+    while (commands.TryPop(discarded)) {
+    }
 
     ImGuiConsole::Cout("StopAllAudio: All channels stopped and cleared.");
 }
@@ -426,18 +651,16 @@ void AudioManager::StopAllAudio() {
 // Updates the volume settings for background music (BGM) and sound effects (SFX).
 void AudioManager::UpdateVolumes() {
     for (auto& [audioID, channels] : audioChannels) {
-        float raw = sfxRawVolumes.count(audioID) ? sfxRawVolumes[audioID] : 1.0f;
-
-        for (FMOD::Channel* channel : channels) {
+        for (AudioBackend::ChannelID channel : channels) {
             if (channel) {
-                channel->setVolume(sfxVolume * raw);  // Use global * raw
+                backend->SetVolume(channel, GetSFXChannelVolume(channel, audioID));  // Use global * raw * attenuation
             }
         }
     }
 
     if (bgmChannel) {
         float finalBGMVolume = (bgmRawOverride >= 0.0f) ? (bgmVolume * bgmRawOverride) : bgmVolume;
-        bgmChannel->setVolume(finalBGMVolume);
+        backend->SetVolume(bgmChannel, finalBGMVolume);
     }
 
 }
@@ -465,7 +688,7 @@ void AudioManager::SetBGMVolume(float vol) {
     bgmVolumeRaw = vol;
     bgmVolume = masterVolume * bgmVolumeRaw;
     if (bgmChannel) {
-        bgmChannel->setVolume(bgmVolume);
+        backend->SetVolume(bgmChannel, bgmVolume);
     }
 }
 
@@ -484,7 +707,7 @@ void AudioManager::SetSFXVolume(float vol) {
 //{
 //    bgmVolumeRaw = vol;
 //    bgmVolume = masterVolume * bgmVolumeRaw;
-//    if (bgmChannel) { bgmChannel->setVolume(bgmVolume); }
+//    if (bgmChannel) { backend->SetVolume(bgmChannel, bgmVolume); }
 //}
 //
 //// Sets the volume for sound effects (SFX).
@@ -504,60 +727,35 @@ const std::map<int, Audio*>& AudioManager::GetAudioObjects() const
 
 // Lists all currently active audio channels.
 void AudioManager::ListActiveChannels() const {
-    if (!audioSystem) {
+    if (!backend) {
         ImGuiConsole::Cout("Audio system not initialized.");
         return;
     }
 
-    int numChannelsPlaying = 0;
-    FMOD_RESULT result = audioSystem->getChannelsPlaying(&numChannelsPlaying);
-    if (result != FMOD_OK) {
-        ImGuiConsole::Cout("Failed to get the number of channels playing.");
-        return;
-    }
-
-    ImGuiConsole::Cout("Active Channels:");
+    ImGuiConsole::Cout("Active Channels (%s, %d playing):", backend->GetName(), backend->GetChannelsPlaying());
 
-    for (int i = 0; i < 100; ++i) {
-        FMOD::Channel* channel = nullptr;
-        result = audioSystem->getChannel(i, &channel);
+    auto listChannel = [this](int audioID, AudioBackend::ChannelID channel) {
+        auto audio = AssetManager::GetInstance().audioObjects.find(audioID);
+        const std::string name = audio != AssetManager::GetInstance().audioObjects.end() ? audio->second->GetAudioName() : "unknown";
+        if (backend->IsPlaying(channel)) {
+            ImGuiConsole::Cout("Channel %u: Playing sound \"%s\" at %u ms%s", channel, name.c_str(), backend->GetPosition(channel),
+                backend->IsPaused(channel) ? " (paused)" : "");
+        }
+        else {
+            ImGuiConsole::Cout("Channel %u is not playing", channel);
+        }
+    };
 
-        if (result == FMOD_OK && channel) {
-            bool isPlaying = false;
-            result = channel->isPlaying(&isPlaying);
-
-            if (result == FMOD_OK && isPlaying) {
-                FMOD::Sound* sound = nullptr;
-                result = channel->getCurrentSound(&sound);
-
-                if (result == FMOD_OK && sound) {
-                    char soundName[256];
-                    unsigned int length = 0;
-
-                    result = sound->getName(soundName, sizeof(soundName));
-                    if (result == FMOD_OK) {
-                        result = sound->getLength(&length, FMOD_TIMEUNIT_MS);
-                        if (result == FMOD_OK) {
-							ImGuiConsole::Cout("Channel %d: Playing sound \"%s\" with length %d ms", i, soundName, length);
-                        }
-                        else {
-							ImGuiConsole::Cout("Failed to get length of sound on channel %d", i);
-                        }
-                    }
-                    else {
-						ImGuiConsole::Cout("Failed to get name of sound on channel %d", i);
-                    }
-                }
-                else {
-					ImGuiConsole::Cout("No sound assigned to channel %d", i);
-                }
-            }
-            else {
-				ImGuiConsole::Cout("Channel %d is not playing", i);
+    if (bgmChannel) {
+        for (const auto& [audioID, audio] : AssetManager::GetInstance().audioObjects) {
+            if (audio && audio->GetType() == AudioType::BGM && audio->GetAudio() == backend->GetSound(bgmChannel)) {
+                listChannel(audioID, bgmChannel);
             }
         }
-        else {
-			ImGuiConsole::Cout("Failed to retrieve channel %d", i);
+    }
+    for (const auto& [audioID, channels] : audioChannels) {
+        for (AudioBackend::ChannelID channel : channels) {
+            listChannel(audioID, channel);
         }
     }
 }
@@ -582,8 +780,7 @@ bool AudioManager::IsPlaying(int audioID) {
         AssetManager::GetInstance().audioObjects[audioID]->GetType() == AudioType::BGM) {
         
         if (bgmChannel) {
-            bool isPlaying = false;
-            bgmChannel->isPlaying(&isPlaying);
+            bool isPlaying = backend->IsPlaying(bgmChannel);
             return isPlaying;
         }
         return false;
@@ -592,29 +789,31 @@ bool AudioManager::IsPlaying(int audioID) {
     // If checking SFX
     auto it = audioChannels.find(audioID);
     if (it != audioChannels.end()) {
-        for (FMOD::Channel* channel : it->second) {
-            bool isPlaying = false;
-            channel->isPlaying(&isPlaying);
+        for (AudioBackend::ChannelID channel : it->second) {
+            bool isPlaying = backend->IsPlaying(channel);
             if (isPlaying) return true;  // If any channel is playing this sound, return true
         }
     }
     return false;
 }
 
-void AudioManager::FadeOutAudio(FMOD::Channel* channel, float duration) {
+void AudioManager::FadeOutAudio(AudioBackend::ChannelID channel, float duration) {
     if (channel) {
-        float currentVolume = 1.0f;
-        FMOD_RESULT result = channel->getVolume(&currentVolume);
-        if (result != FMOD_OK) {
-            ImGuiConsole::Cout("FadeOutAudio: Failed to get volume of channel, error code: %d", result);
+        if (!backend->IsPlaying(channel)) {
+            ImGuiConsole::Cout("FadeOutAudio: Channel is no longer playing.");
             return;
         }
+        float currentVolume = backend->GetVolume(channel) * backend->GetFade(channel);
 
-        fadingOutChannels.push_back({ channel, duration, 0.0f, currentVolume });
+        // Fades from wherever a fade-in or earlier fade-out got to
+        backend->FadeTo(channel, 0.0f, duration, true);
+        fadingOutChannels.erase(std::remove_if(fadingOutChannels.begin(), fadingOutChannels.end(),
+            [channel](const FadeOutInfo& fade) { return fade.channel == channel; }), fadingOutChannels.end());
+        fadingOutChannels.push_back({ channel, duration, 0.0f });
         ImGuiConsole::Cout("FadeOutAudio: Started fading out channel with initial volume %.2f over %.2f seconds.", currentVolume, duration);
     }
     else {
-        ImGuiConsole::Cout("FadeOutAudio: Attempted to fade out a nullptr channel.");
+        ImGuiConsole::Cout("FadeOutAudio: Attempted to fade out an invalid channel.");
     }
 }
 
@@ -623,14 +822,19 @@ void AudioManager::CleanUpChannels() {
         auto& channelList = it->second;
 
         for (auto channelIt = channelList.begin(); channelIt != channelList.end(); ) {
-            FMOD::Channel* channel = *channelIt;
+            AudioBackend::ChannelID channel = *channelIt;
             bool isPlaying = false;
 
             if (channel) {
-                channel->isPlaying(&isPlaying);
+                isPlaying = backend->IsPlaying(channel);
             }
 
             if (!isPlaying) {
+                auto managed = managedVoices.find(channel);
+                if (managed != managedVoices.end()) {
+                    voiceManager.Release(managed->second.voice);
+                    managedVoices.erase(managed);
+                }
                 channelIt = channelList.erase(channelIt);
             }
             else {
@@ -647,16 +851,18 @@ void AudioManager::CleanUpChannels() {
     }
 }
 
-void AudioManager::FadeInAudio(FMOD::Channel* channel, float duration, float targetVolume) {
+void AudioManager::FadeInAudio(AudioBackend::ChannelID channel, float duration, float targetVolume) {
     if (channel) {
-        channel->setVolume(0.0f);
-        channel->setPaused(true); // Start fully paused
-        fadingInChannels.push_back({ channel, duration, 0.0f, targetVolume });
+        // The ramp starts from silence on the first sample, so unpausing straight away does not pop
+        backend->SetVolume(channel, targetVolume);
+        backend->FadeTo(channel, 0.0f, 0.0f, false);
+        backend->FadeTo(channel, 1.0f, duration, false);
+        backend->SetPaused(channel, false);
 
         ImGuiConsole::Cout("FadeInAudio: Started fading in channel to volume %.2f over %.2f seconds.", targetVolume, duration);
     }
     else {
-        ImGuiConsole::Cout("FadeInAudio: Attempted to fade in a nullptr channel.");
+        ImGuiConsole::Cout("FadeInAudio: Attempted to fade in an invalid channel.");
     }
 }
 
@@ -672,16 +878,16 @@ void AudioManager::SetChannelVolume(int audioID, float volume) {
     if (audio->GetType() == AudioType::BGM) {
         bgmRawOverride = volume;
         if (bgmChannel) {
-            bgmChannel->setVolume(bgmVolume * volume);
+            backend->SetVolume(bgmChannel, bgmVolume * volume);
         }
     }
     else {
         sfxRawVolumes[audioID] = volume;
         auto it = audioChannels.find(audioID);
         if (it != audioChannels.end()) {
-            for (FMOD::Channel* channel : it->second) {
+            for (AudioBackend::ChannelID channel : it->second) {
                 if (channel) {
-                    channel->setVolume(sfxVolume * volume);
+                    backend->SetVolume(channel, GetSFXChannelVolume(channel, audioID));
                 }
             }
         }
@@ -690,41 +896,23 @@ void AudioManager::SetChannelVolume(int audioID, float volume) {
 
 
 // Applies a smooth low-pass filter to the specified audio channel over a given duration.
-void AudioManager::ApplyLowPassFilterSmooth(FMOD::Channel* channel, float targetFrequency, float duration) {
+void AudioManager::ApplyLowPassFilterSmooth(AudioBackend::ChannelID channel, float targetFrequency, float duration) {
     if (!channel) return;
 
     targetFrequency = std::clamp(targetFrequency, 1500.0f, 20000.0f);
 
-    if (!lowPassDSP) {
-        audioSystem->createDSPByType(FMOD_DSP_TYPE_LOWPASS, &lowPassDSP);
-    }
-
-    int numDSPs = 0;
-    channel->getNumDSPs(&numDSPs);
-    bool alreadyAttached = false;
-
-    for (int i = 0; i < numDSPs; ++i) {
-        FMOD::DSP* existingDSP = nullptr;
-        channel->getDSP(i, &existingDSP);
-        if (existingDSP == lowPassDSP) {
-            alreadyAttached = true;
-            break;
-        }
-    }
-
-    if (!alreadyAttached) {
-        channel->addDSP(0, lowPassDSP);
-
-        lowPassDSP->setParameterFloat(FMOD_DSP_LOWPASS_CUTOFF, 20000.0f);
+    // Callers ask every frame; restarting the sweep each time would tie its length to the frame rate
+    if (lpTransition.channel == channel && lpTransition.targetFrequency == targetFrequency &&
+        (lpTransition.active || backend->GetLowPass(channel) == targetFrequency)) {
+        return;
     }
 
-    float currentFreq = 0.0f;
-    FMOD_RESULT result = lowPassDSP->getParameterFloat(FMOD_DSP_LOWPASS_CUTOFF, &currentFreq, nullptr, 0);
-
-    if (result != FMOD_OK || currentFreq < 100.0f) {
+    // The backend reports LowPassOff for a channel without a filter, so the transition starts from full clarity
+    float currentFreq = backend->GetLowPass(channel);
+    if (currentFreq < 100.0f) {
         currentFreq = 20000.0f;
-        lowPassDSP->setParameterFloat(FMOD_DSP_LOWPASS_CUTOFF, currentFreq);
     }
+    backend->SetLowPass(channel, std::min(currentFreq, AudioBackend::LowPassOff - 1.0f));
 
     lpTransition = {
         channel,
@@ -734,27 +922,20 @@ void AudioManager::ApplyLowPassFilterSmooth(FMOD::Channel* channel, float target
         duration,
         true
     };
-
-#ifdef _IMGUI
-#endif
 }
 
 //  Smoothly removes the low-pass filter from the specified audio channel over a given duration.
-void AudioManager::RemoveLowPassFilterSmooth(FMOD::Channel* channel, float duration) {
-    if (!channel || !lowPassDSP) return;
+void AudioManager::RemoveLowPassFilterSmooth(AudioBackend::ChannelID channel, float duration) {
+    if (!channel || backend->GetLowPass(channel) >= AudioBackend::LowPassOff) return;
     ApplyLowPassFilterSmooth(channel, 20000.0f, duration);  // Fade to full clarity
 }
 
 // Immediately removes the low-pass filter from the specified audio channel.
-void AudioManager::RemoveLowPassFilter(FMOD::Channel* channel) {
-    if (!channel || !lowPassDSP) return;
+void AudioManager::RemoveLowPassFilter(AudioBackend::ChannelID channel) {
+    if (!channel || backend->GetLowPass(channel) >= AudioBackend::LowPassOff) return;
 
-    bool isActive = false;
-    lowPassDSP->getActive(&isActive);
-    if (isActive) {
-        channel->removeDSP(lowPassDSP);
+    backend->SetLowPass(channel, AudioBackend::LowPassOff);
 #ifdef _IMGUI
-        ImGuiConsole::Cout("Low-pass filter removed.");
+    ImGuiConsole::Cout("Low-pass filter removed.");
 #endif
-    }
 }
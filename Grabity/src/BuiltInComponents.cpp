@@ -0,0 +1,226 @@
+/*!****************************************************************
+\file: BuiltInComponents.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Registers the components the engine ships with in the
+        ComponentRegistry: the Lua sub-table of each component, how it
+        is created when an object loads and, for the components whose
+        saved values change during play, how RestartScene restores it.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "ComponentRegistry.h"
+#include "GameObject.h"
+#include "PlayerControllerComponent.h"
+#include "ButtonComponent.h"
+#include "UIComponent.h"
+#include "ParticleSystem.h"
+
+namespace {
+
+    /**
+     * \brief Deserializes a freshly constructed component and adds it to its object.
+     * \tparam ComponentType The type of the component.
+     * \param object The object to add the component to.
+     * \param type The component type.
+     * \param component The constructed component.
+     * \param luaFilePath The path of the Lua file.
+     * \param tableName The object's table in the Lua file.
+     */
+    template<typename ComponentType>
+    void AddDeserialized(GameObject* object, TypeOfComponent type, std::unique_ptr<ComponentType> component, const std::string& luaFilePath, const std::string& tableName) {
+        component->Deserialize(luaFilePath, tableName);
+        object->AddComponent<ComponentType>(type, std::move(component));
+    }
+
+    /**
+     * \brief Restores an existing component on restart by deserializing its table into it again.
+     *        Only for components whose Deserialize assigns every field it reads, so reading the
+     *        table twice leaves the component as a fresh load would.
+     * \tparam ComponentType The type of the component.
+     * \param type The component type.
+     * \return The reset function.
+     */
+    template<typename ComponentType>
+    ComponentRegistry::LoadFunction ReloadInPlace(TypeOfComponent type) {
+        return [type](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            if (ComponentType* component = object->GetComponent<ComponentType>(type)) {
+                component->Deserialize(luaFilePath, tableName);
+            }
+        };
+    }
+}
+
+/**
+ * \brief Registers every component the engine ships with.
+ *
+ *        Components without a reset keep their runtime state on RestartScene:
+ *        - Sprite, SpriteUI, ParticleSystem and Animator: Deserialize replaces the sprite
+ *          animations and controllers that other systems still point into.
+ *        - Collider: the collider sizes are not changed during play.
+ *        - Audio: LuaReadFromAudioClips appends, so reading again would duplicate clips.
+ *        - PlayerController: only the move speed is saved and it does not change in play.
+ *        - AIState: its target is looked up by id while objects are still being restored.
+ *        - Canvas, ButtonComponent and UIComponent: layout and actions, not play state.
+ *        - SliderComponent: the value is the player's volume setting.
+ *        - Video: restarting a level does not replay its cutscene.
+ *        - PauseMenuButton and VfxFollowComponent: nothing is read from Lua.
+ */
+void ComponentRegistry::RegisterBuiltInComponents() {
+    Register("Transform", TypeOfComponent::TRANSFORM,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::TRANSFORM, std::make_unique<TransformComponent>(object), luaFilePath, tableName);
+        },
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            TransformComponent* transform = object->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM);
+            if (!transform) {
+                return;
+            }
+            std::unique_ptr<TransformComponent> transformComponent = std::make_unique<TransformComponent>(object);
+            transformComponent->Deserialize(luaFilePath, tableName);
+            transform->SetPosition(transformComponent->GetPosition());
+            transform->SetScale(transformComponent->GetScale());
+            transform->SetRotation(transformComponent->GetRotation());
+            transform->SetLocalPosition(transformComponent->GetLocalPosition());
+            transform->SetLocalScale(transformComponent->GetLocalScale());
+            transform->SetLocalRotation(transformComponent->GetLocalRotation());
+        });
+
+    Register("Sprite", TypeOfComponent::SPRITE,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::SPRITE, std::make_unique<SpriteComponent>(), luaFilePath, tableName);
+        });
+
+    Register("RigidBody", TypeOfComponent::RIGIDBODY,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::RIGIDBODY, std::make_unique<RigidBodyComponent>(), luaFilePath, tableName);
+        },
+        ReloadInPlace<RigidBodyComponent>(TypeOfComponent::RIGIDBODY));
+
+    // Needs the RigidBody registered above
+    Register("Collider", TypeOfComponent::RECTCOLLIDER,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::RECTCOLLIDER,
+                std::make_unique<RectColliderComponent>(object, object->GetComponent<RigidBodyComponent>(TypeOfComponent::RIGIDBODY)), luaFilePath, tableName);
+        });
+
+    Register("Audio", TypeOfComponent::AUDIO,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::AUDIO, std::make_unique<AudioComponent>(), luaFilePath, tableName);
+        });
+
+    // Needs the RigidBody and Sprite registered above
+    Register("PlayerController", TypeOfComponent::PLAYER,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            std::unique_ptr<PlayerControllerComponent> playerControllerComponent = std::make_unique<PlayerControllerComponent>();
+            playerControllerComponent->Deserialize(luaFilePath, tableName);
+
+            object->AddComponent<PlayerControllerComponent>(
+                TypeOfComponent::PLAYER,
+                playerControllerComponent->GetMoveSpd(),
+                object->GetComponent<RigidBodyComponent>(TypeOfComponent::RIGIDBODY),
+                object->GetComponent<SpriteComponent>(TypeOfComponent::SPRITE)
+            );
+        });
+
+    Register("AIState", TypeOfComponent::AISTATE,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::AISTATE, std::make_unique<AIStateMachineComponent>(object), luaFilePath, tableName);
+        });
+
+    Register("Text", TypeOfComponent::TEXT,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::TEXT, std::make_unique<TextComponent>(), luaFilePath, tableName);
+        },
+        ReloadInPlace<TextComponent>(TypeOfComponent::TEXT));
+
+    Register("TextUI", TypeOfComponent::TEXT_UI,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::TEXT_UI, std::make_unique<UITextComponent>(), luaFilePath, tableName);
+        },
+        ReloadInPlace<UITextComponent>(TypeOfComponent::TEXT_UI));
+
+    Register("Spawner", TypeOfComponent::SPAWNER,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::SPAWNER, std::make_unique<SpawnerComponent>(object), luaFilePath, tableName);
+        },
+        ReloadInPlace<SpawnerComponent>(TypeOfComponent::SPAWNER));
+
+    Register("Canvas", TypeOfComponent::CANVAS_UI,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::CANVAS_UI, std::make_unique<CanvasComponent>(), luaFilePath, tableName);
+        });
+
+    Register("SpriteUI", TypeOfComponent::SPRITE_UI,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::SPRITE_UI, std::make_unique<UISpriteComponent>(), luaFilePath, tableName);
+        });
+
+    Register("ButtonComponent", TypeOfComponent::BUTTON,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::BUTTON, std::make_unique<ButtonComponent>(), luaFilePath, tableName);
+        });
+
+    Register("UIComponent", TypeOfComponent::UI,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::UI, std::make_unique<UIComponent>(), luaFilePath, tableName);
+        });
+
+    Register("Health", TypeOfComponent::HEALTH,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::HEALTH, std::make_unique<HealthComponent>(object), luaFilePath, tableName);
+        },
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            HealthComponent* health = object->GetComponent<HealthComponent>(TypeOfComponent::HEALTH);
+            if (!health) {
+                return;
+            }
+            std::unique_ptr<HealthComponent> healthComponent = std::make_unique<HealthComponent>();
+            healthComponent->Deserialize(luaFilePath, tableName);
+            health->SetHealth(healthComponent->GetHealth());
+        });
+
+    Register("Explosion", TypeOfComponent::EXPLOSION,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::EXPLOSION, std::make_unique<ExplosionComponent>(object), luaFilePath, tableName);
+        },
+        ReloadInPlace<ExplosionComponent>(TypeOfComponent::EXPLOSION));
+
+    Register("PauseMenuButton", TypeOfComponent::PAUSEMENUBUTTON,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::PAUSEMENUBUTTON, std::make_unique<PauseMenuButton>(object), luaFilePath, tableName);
+        });
+
+    Register("Animator", TypeOfComponent::ANIMATOR,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::ANIMATOR, std::make_unique<AnimatorComponent>(object), luaFilePath, tableName);
+        });
+
+    Register("SliderComponent", TypeOfComponent::SLIDER,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::SLIDER, std::make_unique<SliderComponent>(object), luaFilePath, tableName);
+        });
+
+    Register("ParticleSystem", TypeOfComponent::PARTICLE,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::PARTICLE, std::make_unique<ParticleSystem>(object), luaFilePath, tableName);
+        });
+
+    Register("Splitting", TypeOfComponent::SPLITTING,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::SPLITTING, std::make_unique<SplittingComponent>(object), luaFilePath, tableName);
+        },
+        ReloadInPlace<SplittingComponent>(TypeOfComponent::SPLITTING));
+
+    Register("Video", TypeOfComponent::VIDEO,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::VIDEO, std::make_unique<VideoComponent>(object), luaFilePath, tableName);
+        });
+
+    Register("VfxFollowComponent", TypeOfComponent::VFX_FOLLOW,
+        [](GameObject* object, const std::string& luaFilePath, const std::string& tableName) {
+            AddDeserialized(object, TypeOfComponent::VFX_FOLLOW, std::make_unique<VfxFollowComponent>(object), luaFilePath, tableName);
+        });
+}
@@ -0,0 +1,137 @@
+/*!****************************************************************
+\file: ComponentRegistry.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Table-driven registry of the components that can be loaded
+        from Lua. Each component registers the name of its Lua
+        sub-table, a create function (construct, Deserialize and add to
+        the object) and an optional reset function used by
+        RestartScene. Loading an object only visits the sub-tables the
+        object actually has, instead of probing every component type.
+        The built-in components are registered in BuiltInComponents.cpp.
+
+        Saving still goes through the virtual Component::Serialize.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "ComponentRegistry.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+
+/**
+ * \brief Retrieves the registry, registering the built-in components on first use.
+ * \return Reference to the registry.
+ */
+ComponentRegistry& ComponentRegistry::GetInstance() {
+    static ComponentRegistry instance;
+    return instance;
+}
+
+/**
+ * \brief Creates the registry and registers the built-in components.
+ */
+ComponentRegistry::ComponentRegistry() {
+    RegisterBuiltInComponents();
+    for (TypeOfComponent type : GetUnregisteredTypes()) {
+        ImGuiConsole::Cout("ComponentRegistry: component type %d is saved to Lua but cannot be loaded back", static_cast<int>(type));
+    }
+}
+
+/**
+ * \brief Registers a component type. Components are created in registration order, so a
+ *        component must be registered after the components its constructor looks up.
+ * \param tableName The name of the component's Lua sub-table.
+ * \param type The component type.
+ * \param create Constructs, deserializes and adds the component.
+ * \param reset Restores an existing component on restart, may be empty.
+ */
+void ComponentRegistry::Register(const std::string& tableName, TypeOfComponent type, LoadFunction create, LoadFunction reset) {
+    auto [it, inserted] = tableLookup.try_emplace(tableName, entries.size());
+    if (!inserted) {
+        // Re-registering replaces the functions but keeps the original creation order
+        entries[it->second] = { tableName, type, std::move(create), std::move(reset) };
+        return;
+    }
+    entries.push_back({ tableName, type, std::move(create), std::move(reset) });
+}
+
+/**
+ * \brief Finds a component by its Lua sub-table name.
+ * \param tableName The sub-table name.
+ * \return The entry, or nullptr if no component uses the table.
+ */
+const ComponentRegistry::Entry* ComponentRegistry::Find(const std::string& tableName) const {
+    auto it = tableLookup.find(tableName);
+    return it != tableLookup.end() ? &entries[it->second] : nullptr;
+}
+
+/**
+ * \brief Finds a component by its type.
+ * \param type The component type.
+ * \return The entry, or nullptr if the type cannot be loaded from Lua.
+ */
+const ComponentRegistry::Entry* ComponentRegistry::Find(TypeOfComponent type) const {
+    for (const Entry& entry : entries) {
+        if (entry.type == type) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \brief Maps the sub-tables of an object to components, in registration order.
+ *        Tables that are not component tables (e.g. "Name") are skipped.
+ * \param tableNames The sub-tables present in the object's Lua table.
+ * \return The entries of the components to load.
+ */
+std::vector<const ComponentRegistry::Entry*> ComponentRegistry::GetEntriesFor(const std::vector<std::string>& tableNames) const {
+    std::vector<size_t> indices;
+    indices.reserve(tableNames.size());
+    for (const std::string& tableName : tableNames) {
+        auto it = tableLookup.find(tableName);
+        if (it != tableLookup.end()) {
+            indices.push_back(it->second);
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+
+    std::vector<const Entry*> result;
+    result.reserve(indices.size());
+    for (size_t index : indices) {
+        result.push_back(&entries[index]);
+    }
+    return result;
+}
+
+/**
+ * \brief Whether a component type is saved to and loaded from Lua.
+ * \param type The component type.
+ * \return False for the components that are only created at runtime.
+ */
+bool ComponentRegistry::IsSavedToLua(TypeOfComponent type) {
+    // GRAVITY has no component class and FLOATUP is added to damage numbers as they spawn
+    return type != TypeOfComponent::GRAVITY && type != TypeOfComponent::FLOATUP;
+}
+
+/**
+ * \brief Checks that every component type saved to Lua loads back through the registry:
+ *        Find(type) gives an entry whose table name finds the same entry.
+ * \return The types that do not round-trip, empty when the registry is complete.
+ */
+std::vector<TypeOfComponent> ComponentRegistry::GetUnregisteredTypes() const {
+    std::vector<TypeOfComponent> unregistered;
+    for (int index = 0; index < TypeOfComponent::COMPONENT_COUNT; ++index) {
+        const TypeOfComponent type = static_cast<TypeOfComponent>(index);
+        if (!IsSavedToLua(type)) {
+            continue;
+        }
+        const Entry* entry = Find(type);
+        if (!entry || Find(entry->tableName) != entry || !entry->create) {
+            unregistered.push_back(type);
+        }
+    }
+    return unregistered;
+}
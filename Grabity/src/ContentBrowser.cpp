@@ -346,7 +346,7 @@ void ContentBrowserPanel::OnImGuiRender()
             textureName = std::filesystem::path(filenameString).stem().string();
             std::unique_ptr<SpriteAnimation> sprite;
 
-            if (!assetManager.IsTextureLoaded(textureName)) {
+            if (!assetManager.IsTextureRegistered(textureName)) {
                 assetManager.LoadTexture(pathString, textureName, 1.0f, 1.0f, 0.0f);
             }
 
@@ -0,0 +1,646 @@
+/*!****************************************************************
+\file: CookedScene.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Binary cooked form of Lua scene and prefab files. The baker
+        executes a Lua file once and flattens its object tables into a
+        versioned binary image (string table, object records, table
+        records and typed fields). The loader memory-maps that image and
+        answers LuaManager reads from it without a Lua state.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "CookedScene.h"
+#include "ImGuiConsole.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+#include <cstring>
+
+#define SOL_ALL_SAFETIES_ON 1
+#include <sol/sol.hpp>
+
+namespace {
+
+    /**
+     * \brief Appends the raw bytes of a record array to an image.
+     * \param image The image being laid out.
+     * \param records The records to append.
+     */
+    template<typename Record>
+    void AppendRecords(std::vector<unsigned char>& image, const std::vector<Record>& records) {
+        if (!records.empty()) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(records.data());
+            image.insert(image.end(), bytes, bytes + records.size() * sizeof(Record));
+        }
+    }
+}
+
+/**
+ * \brief Builds the path of the cooked file that belongs to a Lua file.
+ * \param luaFilePath The path to the Lua file.
+ * \return The Lua path with its extension replaced by ".cooked".
+ */
+std::string CookedScene::GetCookedPath(const std::string& luaFilePath) {
+    std::filesystem::path path(luaFilePath);
+    path.replace_extension(Extension);
+    return path.string();
+}
+
+/**
+ * \brief Checks if a Lua file has a cooked file that is at least as new as the source.
+ * \param luaFilePath The path to the Lua file.
+ * \return True if the cooked file can be used instead of the Lua file.
+ */
+bool CookedScene::IsUpToDate(const std::string& luaFilePath) {
+    std::error_code error;
+    const std::string cookedPath = GetCookedPath(luaFilePath);
+    if (!std::filesystem::exists(cookedPath, error)) {
+        return false;
+    }
+
+    auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+    if (error) {
+        return false;
+    }
+    auto sourceTime = std::filesystem::last_write_time(luaFilePath, error);
+    if (error) {
+        // Shipping builds may only contain the cooked file
+        return true;
+    }
+    return cookedTime >= sourceTime;
+}
+
+/**
+ * \brief Executes a Lua file and writes its object tables as a cooked file.
+ * \param luaFilePath The path to the Lua source file.
+ * \param cookedFilePath The path of the cooked file to write.
+ * \return True if the file was baked, false otherwise.
+ */
+bool CookedScene::Bake(const std::string& luaFilePath, const std::string& cookedFilePath) {
+    std::optional<std::vector<unsigned char>> image = BakeImage(luaFilePath);
+    if (!image) {
+        return false;
+    }
+
+    // Write beside the target and rename, so a failed cook never leaves a truncated file behind
+    const std::string tempPath = cookedFilePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            ImGuiConsole::Cout("Cook failed: could not open %s", tempPath.c_str());
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(image->data()), static_cast<std::streamsize>(image->size()));
+        if (!out.good()) {
+            ImGuiConsole::Cout("Cook failed: could not write %s", tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cookedFilePath, error);
+    if (error) {
+        std::filesystem::remove(cookedFilePath, error);
+        std::filesystem::rename(tempPath, cookedFilePath, error);
+    }
+    if (error) {
+        ImGuiConsole::Cout("Cook failed: could not replace %s", cookedFilePath.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Executes a Lua file in a private state and lays out its object tables as a cooked image.
+ *        Safe to call from any thread.
+ * \param luaFilePath The path to the Lua source file.
+ * \return The image, or std::nullopt if the file could not be executed.
+ */
+std::optional<std::vector<unsigned char>> CookedScene::BakeImage(const std::string& luaFilePath) {
+    sol::state lua;
+    lua.open_libraries(sol::lib::base);
+    try {
+        lua.safe_script_file(luaFilePath);
+    }
+    catch (const sol::error& e) {
+        ImGuiConsole::Cout("Cook failed for %s: %s", luaFilePath.c_str(), e.what());
+        return std::nullopt;
+    }
+
+    // List of names to ignore (standard Lua globals)
+    std::unordered_set<std::string> ignoredGlobals = { "_G", "base", "package", "coroutine", "string", "table", "math", "io", "os", "debug", "utf8", "jit", "bit32" };
+
+    // Sort object tables by name so the same source always bakes to the same bytes
+    std::vector<std::pair<std::string, sol::table>> objectTables;
+    for (const auto& pair : lua.globals()) {
+        if (pair.second.is<sol::table>() && pair.first.is<std::string>()) {
+            std::string objectName = pair.first.as<std::string>();
+            if (ignoredGlobals.find(objectName) == ignoredGlobals.end()) {
+                objectTables.emplace_back(objectName, pair.second.as<sol::table>());
+            }
+        }
+    }
+    std::sort(objectTables.begin(), objectTables.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    Builder builder;
+
+    // Adds the scalar fields of a Lua table to the current table of the builder
+    auto appendFields = [&builder](const sol::table& table) {
+        for (const auto& entry : table) {
+            if (!entry.first.is<std::string>()) {
+                continue;
+            }
+
+            const std::string key = entry.first.as<std::string>();
+            switch (entry.second.get_type()) {
+            case sol::type::number:
+                builder.AddNumber(key, entry.second.as<double>());
+                break;
+            case sol::type::string:
+                builder.AddString(key, entry.second.as<std::string>());
+                break;
+            case sol::type::boolean:
+                builder.AddBoolean(key, entry.second.as<bool>());
+                break;
+            default:
+                break; // Nested tables are handled by the caller, anything else is not read by LuaManager
+            }
+        }
+    };
+
+    for (const auto& [objectName, objectTable] : objectTables) {
+        int parentID = -1;
+        sol::optional<sol::table> nameTable = objectTable["Name"];
+        if (nameTable) {
+            sol::optional<int> storedParentID = nameTable.value()["parentID"];
+            if (storedParentID) {
+                parentID = storedParentID.value();
+            }
+        }
+
+        builder.BeginObject(objectName, parentID);
+        appendFields(objectTable);
+
+        for (const auto& entry : objectTable) {
+            if (!entry.first.is<std::string>() || !entry.second.is<sol::table>()) {
+                continue;
+            }
+
+            const std::string subTableName = entry.first.as<std::string>();
+            builder.BeginTable(subTableName);
+            appendFields(entry.second.as<sol::table>());
+
+            for (const auto& nested : entry.second.as<sol::table>()) {
+                if (nested.second.is<sol::table>()) {
+                    ImGuiConsole::Cout("Cook: skipped nested table under %s.%s", objectName.c_str(), subTableName.c_str());
+                    break;
+                }
+            }
+        }
+    }
+    return builder.Finish();
+}
+
+/**
+ * \brief Bakes every Lua file in a directory next to its source.
+ * \param directory The directory containing Lua scenes or prefabs.
+ * \return The number of files baked.
+ */
+int CookedScene::BakeDirectory(const std::string& directory) {
+    int bakedCount = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == ".lua") {
+            const std::string luaPath = entry.path().string();
+            if (Bake(luaPath, GetCookedPath(luaPath))) {
+                ++bakedCount;
+            }
+        }
+    }
+    return bakedCount;
+}
+
+/**
+ * \brief Memory-maps a cooked file and indexes its object records.
+ * \param cookedFilePath The path of the cooked file.
+ * \return True if the file was mapped and has a valid header, false otherwise.
+ */
+bool CookedScene::Load(const std::string& cookedFilePath) {
+    header = nullptr;
+    objectIndex.clear();
+    memory.clear();
+    if (!file.Open(cookedFilePath)) {
+        return false;
+    }
+    if (!Index(file.GetData(), file.GetSize(), cookedFilePath)) {
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Takes ownership of a cooked image built in memory and indexes its object records.
+ * \param image The bytes produced by Builder::Finish.
+ * \return True if the image has a valid header, false otherwise.
+ */
+bool CookedScene::LoadFromMemory(std::vector<unsigned char> image) {
+    header = nullptr;
+    objectIndex.clear();
+    file.Close();
+    memory = std::move(image);
+    if (!Index(memory.data(), memory.size(), "<memory>")) {
+        memory.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Validates an image and points the record arrays into it.
+ * \param base The first byte of the image.
+ * \param size The size of the image.
+ * \param sourceName The file name used in log messages.
+ * \return True if the image is valid, false otherwise.
+ */
+bool CookedScene::Index(const unsigned char* base, size_t size, const std::string& sourceName) {
+    if (size < sizeof(Header)) {
+        ImGuiConsole::Cout("Cooked file %s is truncated, ignoring it", sourceName.c_str());
+        return false;
+    }
+
+    const Header* imageHeader = reinterpret_cast<const Header*>(base);
+    if (imageHeader->magic != Magic || imageHeader->version != Version) {
+        ImGuiConsole::Cout("Cooked file %s has an unknown version, ignoring it", sourceName.c_str());
+        return false;
+    }
+
+    // Offsets follow the padding written by Builder::Finish. The counts are 32 bit,
+    // so 64 bit sums cannot wrap however the header was damaged.
+    uint64_t offset = sizeof(Header);
+    const uint64_t stringOffset = offset;
+    offset += (static_cast<uint64_t>(imageHeader->stringCount) + imageHeader->stringCount % 2) * sizeof(StringRecord);
+    const uint64_t objectOffset = offset;
+    offset += static_cast<uint64_t>(imageHeader->objectCount) * sizeof(ObjectRecord) + (imageHeader->objectCount % 2) * 8;
+    const uint64_t tableOffset = offset;
+    offset += static_cast<uint64_t>(imageHeader->tableCount) * sizeof(TableRecord);
+    const uint64_t fieldOffset = offset;
+    offset += static_cast<uint64_t>(imageHeader->fieldCount) * sizeof(FieldRecord);
+    const uint64_t bytesOffset = offset;
+    offset += imageHeader->stringBytes;
+
+    if (offset > size) {
+        ImGuiConsole::Cout("Cooked file %s is truncated, ignoring it", sourceName.c_str());
+        return false;
+    }
+
+    const StringRecord* imageStrings = reinterpret_cast<const StringRecord*>(base + stringOffset);
+    const ObjectRecord* imageObjects = reinterpret_cast<const ObjectRecord*>(base + objectOffset);
+    const TableRecord* imageTables = reinterpret_cast<const TableRecord*>(base + tableOffset);
+    const FieldRecord* imageFields = reinterpret_cast<const FieldRecord*>(base + fieldOffset);
+
+    // Every index the readers follow is checked once here, so lookups can stay unchecked.
+    // String 0 must exist because it names the object-level tables.
+    bool valid = imageHeader->stringCount > 0;
+    for (uint32_t i = 0; valid && i < imageHeader->stringCount; ++i) {
+        valid = static_cast<uint64_t>(imageStrings[i].offset) + imageStrings[i].length <= imageHeader->stringBytes;
+    }
+    for (uint32_t i = 0; valid && i < imageHeader->objectCount; ++i) {
+        const ObjectRecord& object = imageObjects[i];
+        valid = object.name < imageHeader->stringCount
+            && static_cast<uint64_t>(object.firstTable) + object.tableCount <= imageHeader->tableCount;
+    }
+    for (uint32_t i = 0; valid && i < imageHeader->tableCount; ++i) {
+        const TableRecord& table = imageTables[i];
+        valid = table.name < imageHeader->stringCount
+            && static_cast<uint64_t>(table.firstField) + table.fieldCount <= imageHeader->fieldCount;
+    }
+    for (uint32_t i = 0; valid && i < imageHeader->fieldCount; ++i) {
+        const FieldRecord& field = imageFields[i];
+        switch (field.type) {
+        case FieldType::NUMBER:
+        case FieldType::BOOLEAN:
+            valid = field.key < imageHeader->stringCount;
+            break;
+        case FieldType::STRING:
+            valid = field.key < imageHeader->stringCount && field.stringIndex < imageHeader->stringCount;
+            break;
+        default:
+            valid = false;
+            break;
+        }
+    }
+    if (!valid) {
+        ImGuiConsole::Cout("Cooked file %s is damaged, ignoring it", sourceName.c_str());
+        return false;
+    }
+
+    header = imageHeader;
+    strings = imageStrings;
+    objects = imageObjects;
+    tables = imageTables;
+    fields = imageFields;
+    stringBytes = reinterpret_cast<const char*>(base + bytesOffset);
+
+    objectIndex.reserve(header->objectCount);
+    for (uint32_t i = 0; i < header->objectCount; ++i) {
+        objectIndex.emplace(GetString(objects[i].name), i);
+    }
+    return true;
+}
+
+/**
+ * \brief Checks if an object table contains a sub-table.
+ * \param objectTable The name of the object table.
+ * \param subTable The name of the sub-table to check.
+ * \return True if the sub-table exists, false otherwise.
+ */
+bool CookedScene::HasTable(const std::string& objectTable, const std::string& subTable) const {
+    return !subTable.empty() && FindTable(objectTable, subTable) != nullptr;
+}
+
+/**
+ * \brief Lists the sub-tables of an object table.
+ * \param objectTable The name of the object table.
+ * \return The sub-table names, in file order. Empty if the object does not exist.
+ */
+std::vector<std::string> CookedScene::GetTableNames(const std::string& objectTable) const {
+    std::vector<std::string> names;
+    auto it = objectIndex.find(objectTable);
+    if (it == objectIndex.end()) {
+        return names;
+    }
+
+    const ObjectRecord& object = objects[it->second];
+    names.reserve(object.tableCount);
+    for (uint32_t i = 0; i < object.tableCount; ++i) {
+        const TableRecord& table = tables[object.firstTable + i];
+        if (table.name != 0) {
+            names.emplace_back(GetString(table.name));
+        }
+    }
+    return names;
+}
+
+/**
+ * \brief Collects the string values of every field whose key starts with a prefix.
+ * \param keyPrefix The start of the keys to match.
+ * \return The distinct values, in file order.
+ */
+std::vector<std::string> CookedScene::GetStringValues(std::string_view keyPrefix) const {
+    std::vector<std::string> values;
+    if (!header) {
+        return values;
+    }
+
+    std::unordered_set<std::string_view> seen;
+    for (uint32_t i = 0; i < header->fieldCount; ++i) {
+        const FieldRecord& field = fields[i];
+        if (field.type != FieldType::STRING || GetString(field.key).substr(0, keyPrefix.size()) != keyPrefix) {
+            continue;
+        }
+        const std::string_view value = GetString(field.stringIndex);
+        if (seen.insert(value).second) {
+            values.emplace_back(value);
+        }
+    }
+    return values;
+}
+
+/**
+ * \brief Finds a table of an object by name.
+ * \param objectTable The name of the object table.
+ * \param tableName The name of the sub-table, "" for fields on the object itself.
+ * \return The table record, or nullptr if not found.
+ */
+const CookedScene::TableRecord* CookedScene::FindTable(const std::string& objectTable, std::string_view tableName) const {
+    auto it = objectIndex.find(objectTable);
+    if (it == objectIndex.end()) {
+        return nullptr;
+    }
+
+    const ObjectRecord& object = objects[it->second];
+    for (uint32_t i = 0; i < object.tableCount; ++i) {
+        const TableRecord& table = tables[object.firstTable + i];
+        if (GetString(table.name) == tableName) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \brief Resolves a LuaRead style key path to a field.
+ * \param objectTable The name of the object table.
+ * \param keys Either { field } or { subTable, field }.
+ * \return The field record, or nullptr if not found.
+ */
+const CookedScene::FieldRecord* CookedScene::FindField(const std::string& objectTable, const std::vector<std::string>& keys) const {
+    if (!header || keys.empty() || keys.size() > 2) {
+        return nullptr;
+    }
+
+    const TableRecord* table = FindTable(objectTable, keys.size() == 2 ? std::string_view(keys[0]) : std::string_view());
+    if (!table) {
+        return nullptr;
+    }
+
+    const std::string_view key = keys.back();
+    for (uint32_t i = 0; i < table->fieldCount; ++i) {
+        const FieldRecord& field = fields[table->firstField + i];
+        if (GetString(field.key) == key) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \brief Creates an empty builder. String 0 is always "", the name of the object-level table.
+ */
+CookedScene::Builder::Builder() {
+    Intern("");
+}
+
+/**
+ * \brief Starts a new object table. Its id is taken from the numeric suffix of the name.
+ * \param objectTable The Lua global name of the object table, e.g. "Player_3".
+ * \param parentID The parent id stored in the object's Name table, -1 for none.
+ */
+void CookedScene::Builder::BeginObject(const std::string& objectTable, int parentID) {
+    DropEmptyObjectTable();
+
+    ObjectRecord objectRecord{};
+    objectRecord.name = Intern(objectTable);
+    objectRecord.id = ParseObjectID(objectTable);
+    objectRecord.parentID = parentID;
+    objectRecord.firstTable = static_cast<uint32_t>(tableRecords.size());
+    objectRecords.push_back(objectRecord);
+
+    // Fields added before the first BeginTable belong to the object itself
+    tableRecords.push_back({ 0, static_cast<uint32_t>(fieldRecords.size()), 0, 0 });
+    ++objectRecords.back().tableCount;
+}
+
+/**
+ * \brief Starts a sub-table of the current object. Fields added before the first
+ *        BeginTable are stored directly on the object.
+ * \param tableName The name of the sub-table.
+ */
+void CookedScene::Builder::BeginTable(const std::string& tableName) {
+    if (objectRecords.empty()) {
+        return;
+    }
+    DropEmptyObjectTable();
+    tableRecords.push_back({ Intern(tableName), static_cast<uint32_t>(fieldRecords.size()), 0, 0 });
+    ++objectRecords.back().tableCount;
+}
+
+/**
+ * \brief Adds a number field to the current table.
+ * \param key The field name.
+ * \param value The value.
+ */
+void CookedScene::Builder::AddNumber(const std::string& key, double value) {
+    FieldRecord field{};
+    field.key = Intern(key);
+    field.type = FieldType::NUMBER;
+    field.number = value;
+    AddField(field);
+}
+
+/**
+ * \brief Adds a string field to the current table.
+ * \param key The field name.
+ * \param value The value.
+ */
+void CookedScene::Builder::AddString(const std::string& key, const std::string& value) {
+    FieldRecord field{};
+    field.key = Intern(key);
+    field.type = FieldType::STRING;
+    field.stringIndex = Intern(value);
+    AddField(field);
+}
+
+/**
+ * \brief Adds a boolean field to the current table.
+ * \param key The field name.
+ * \param value The value.
+ */
+void CookedScene::Builder::AddBoolean(const std::string& key, bool value) {
+    FieldRecord field{};
+    field.key = Intern(key);
+    field.type = FieldType::BOOLEAN;
+    field.boolean = value ? 1u : 0u;
+    AddField(field);
+}
+
+/**
+ * \brief Lays out everything added so far as a cooked image.
+ * \return The bytes of the image, the same bytes Bake writes to disk.
+ */
+std::vector<unsigned char> CookedScene::Builder::Finish() {
+    DropEmptyObjectTable();
+
+    std::vector<StringRecord> stringRecords;
+    std::string stringBlob;
+    stringRecords.reserve(strings.size());
+    for (const std::string& value : strings) {
+        stringRecords.push_back({ static_cast<uint32_t>(stringBlob.size()), static_cast<uint32_t>(value.size()) });
+        stringBlob += value;
+    }
+
+    Header imageHeader{};
+    imageHeader.magic = Magic;
+    imageHeader.version = Version;
+    imageHeader.stringCount = static_cast<uint32_t>(stringRecords.size());
+    imageHeader.objectCount = static_cast<uint32_t>(objectRecords.size());
+    imageHeader.tableCount = static_cast<uint32_t>(tableRecords.size());
+    imageHeader.fieldCount = static_cast<uint32_t>(fieldRecords.size());
+    imageHeader.stringBytes = static_cast<uint32_t>(stringBlob.size());
+
+    std::vector<unsigned char> image;
+    image.reserve(sizeof(Header) + (stringRecords.size() + 1) * sizeof(StringRecord) + (objectRecords.size() + 1) * sizeof(ObjectRecord)
+        + tableRecords.size() * sizeof(TableRecord) + fieldRecords.size() * sizeof(FieldRecord) + stringBlob.size());
+
+    const unsigned char* headerBytes = reinterpret_cast<const unsigned char*>(&imageHeader);
+    image.insert(image.end(), headerBytes, headerBytes + sizeof(Header));
+    AppendRecords(image, stringRecords);
+    if (stringRecords.size() % 2 != 0) {
+        image.insert(image.end(), sizeof(StringRecord), 0); // Keep the following records 16 byte aligned
+    }
+    AppendRecords(image, objectRecords);
+    if (objectRecords.size() % 2 != 0) {
+        image.insert(image.end(), 8, 0);
+    }
+    AppendRecords(image, tableRecords);
+    AppendRecords(image, fieldRecords);
+    image.insert(image.end(), stringBlob.begin(), stringBlob.end());
+    return image;
+}
+
+/**
+ * \brief Adds a string to the string table once.
+ * \param value The string to add.
+ * \return The index of the string.
+ */
+uint32_t CookedScene::Builder::Intern(const std::string& value) {
+    auto it = stringLookup.find(value);
+    if (it != stringLookup.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(strings.size());
+    strings.push_back(value);
+    stringLookup.emplace(value, index);
+    return index;
+}
+
+/**
+ * \brief Appends a field to the current table, opening the object-level table if needed.
+ * \param field The field record with its key already interned.
+ */
+void CookedScene::Builder::AddField(const FieldRecord& field) {
+    if (objectRecords.empty()) {
+        return;
+    }
+    fieldRecords.push_back(field);
+    ++tableRecords.back().fieldCount;
+}
+
+/**
+ * \brief Removes the object-level table of the current object if it stayed empty.
+ */
+void CookedScene::Builder::DropEmptyObjectTable() {
+    if (objectRecords.empty() || tableRecords.empty()) {
+        return;
+    }
+    const TableRecord& last = tableRecords.back();
+    if (last.name == 0 && last.fieldCount == 0 && tableRecords.size() - 1 >= objectRecords.back().firstTable) {
+        tableRecords.pop_back();
+        --objectRecords.back().tableCount;
+    }
+}
+
+/**
+ * \brief Extracts the id from an object table name the same way
+ *        LuaManager::extractNamesWithParentIDs does.
+ * \param objectTable The name of the object table, e.g. "Player_3".
+ * \return The id, or -1 if the name has no numeric suffix.
+ */
+int CookedScene::ParseObjectID(const std::string& objectTable) {
+    size_t underscorePos = objectTable.find_last_of('_');
+    if (underscorePos == std::string::npos) {
+        return -1;
+    }
+    try {
+        return std::stoi(objectTable.substr(underscorePos + 1));
+    }
+    catch (const std::exception&) {
+        return -1;
+    }
+}
@@ -1,2 +1,42 @@
 #include "DespawnManager.h"
 #include "GameObjectFactory.h"
+
+DespawnManager::DespawnManager() {
+    channel = TimerService::GetInstance().RegisterChannel("Despawn", [this](const std::vector<uint64_t>& payloads) {
+        DespawnExpired(payloads);
+    });
+}
+
+void DespawnManager::ScheduleDespawn(GameObject* obj, float delay) {
+    if (!obj) {
+        return;
+    }
+    DespawnManager& manager = GetInstance();
+    TimerService& timers = TimerService::GetInstance();
+    auto it = manager.pendingDespawns.find(obj);
+    if (it != manager.pendingDespawns.end()) {
+        timers.Cancel(it->second);
+    }
+    manager.pendingDespawns[obj] = timers.Schedule(delay, manager.channel, reinterpret_cast<uintptr_t>(obj));
+}
+
+void DespawnManager::Cancel(GameObject* obj) {
+    auto it = pendingDespawns.find(obj);
+    if (it == pendingDespawns.end()) {
+        return;
+    }
+    TimerService::GetInstance().Cancel(it->second);
+    pendingDespawns.erase(it);
+}
+
+void DespawnManager::DespawnExpired(const std::vector<uint64_t>& payloads) {
+    GameObjectFactory& factory = GameObjectFactory::GetInstance();
+    for (uint64_t payload : payloads) {
+        GameObject* object = reinterpret_cast<GameObject*>(static_cast<uintptr_t>(payload));
+        // Gone already if an earlier despawn in this batch took it with its parent
+        if (pendingDespawns.erase(object) == 0) {
+            continue;
+        }
+        factory.Despawn(object);
+    }
+}
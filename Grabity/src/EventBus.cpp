@@ -0,0 +1,92 @@
+/*!****************************************************************
+\file: EventBus.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the parts of the EventBus that are not per event
+        type: the channel list, unsubscribing, dispatching a phase
+        and the counters. Channels are only ever added, so the list
+        is a fixed array that dispatching reads without a lock.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "EventBus.h"
+#include "ImGuiConsole.h"
+#include <stdexcept>
+
+/**
+ * \brief Retrieves the event bus instance.
+ * \return Reference to the event bus.
+ */
+EventBus& EventBus::GetInstance() {
+    static EventBus instance;
+    return instance;
+}
+
+/**
+ * \brief Removes a subscriber. Main thread only, and safe from inside a handler.
+ * \param subscription The subscriber. Cleared so it refers to nothing.
+ */
+void EventBus::Unsubscribe(Subscription& subscription) {
+    if (subscription.type < channelCount.load(std::memory_order_acquire)) {
+        channels[subscription.type].load(std::memory_order_acquire)->Remove(subscription.id);
+    }
+    subscription = Subscription{};
+}
+
+/**
+ * \brief Hands the queued events of a phase to their subscribers. Main thread only.
+ * \param phase The phase.
+ * \return The number of events dispatched.
+ */
+size_t EventBus::Dispatch(Phase phase) {
+    size_t total = 0;
+    for (int round = 0; round < MaxRounds; ++round) {
+        size_t delivered = 0;
+        // Read every round, since a handler may post a type that was never used before
+        const uint32_t count = channelCount.load(std::memory_order_acquire);
+        for (uint32_t type = 0; type < count; ++type) {
+            ChannelBase* channel = channels[type].load(std::memory_order_acquire);
+            if (channel->phase == phase) {
+                delivered += channel->Deliver();
+            }
+        }
+        if (delivered == 0) {
+            return total;
+        }
+        total += delivered;
+    }
+#ifdef _LOGGING
+    ImGuiConsole::Cout("EventBus: handlers were still posting after %d rounds, the rest waits for the next frame", MaxRounds);
+#endif
+    return total;
+}
+
+/**
+ * \brief Retrieves the counters of every event type used so far.
+ * \return The counters, in the order the types were first used.
+ */
+std::vector<EventBus::ChannelStats> EventBus::GetStats() const {
+    std::vector<ChannelStats> stats(channelCount.load(std::memory_order_acquire));
+    for (size_t type = 0; type < stats.size(); ++type) {
+        channels[type].load(std::memory_order_acquire)->FillStats(stats[type]);
+    }
+    return stats;
+}
+
+/**
+ * \brief Records a new channel so dispatching finds it.
+ * \param channel The channel.
+ * \return The channel's type number.
+ */
+uint32_t EventBus::Register(ChannelBase* channel) {
+    std::lock_guard<std::mutex> lock(registerMutex);
+    const uint32_t type = channelCount.load(std::memory_order_relaxed);
+    if (type >= MaxEventTypes) {
+        throw std::runtime_error("EventBus: more event types than MaxEventTypes");
+    }
+    channels[type].store(channel, std::memory_order_release);
+    channelCount.store(type + 1, std::memory_order_release);
+    return type;
+}
@@ -1,11 +1,13 @@
 /*!****************************************************************
 \file: EventSystem.cpp
 \author: Ridhwan Afandi (mohamedridhwan.b)
+\co-author: Goh Jun Jie, g.junjie, 2301293
 \brief  Contains the implementation of the EventSystem class, which
-        manages game events via GameEventComponent on a separate thread.
-        The worker thread starts automatically upon instantiation and
-        continuously processes events in the background. This file also
-        provides functions to add, save, and load events.
+        manages game events via GameEventComponent. Waves are spawned
+        on the main thread from Update, at the fixed step they fall
+        due in on the simulation clock. This file also provides
+        functions to add, save, and load events. Missions count the
+        EnemyKilledEvents posted on the EventBus.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -31,21 +33,32 @@ void EventSystem::ShutDown() {
 }
 
 EventSystem::EventSystem() {
-    workerThread = std::thread([this] {
-        ProcessEvents();
-        });
+    enemyKilledSubscription = EventBus::GetInstance().Subscribe<EnemyKilledEvent>([this](const EnemyKilledEvent& event) {
+        OnEnemyKilled(event);
+    });
 }
 
-void EventSystem::AddEvent(const GameEventComponent& event) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        eventQueue.push(event);
+void EventSystem::Update() {
+    Engine& engine = Engine::GetInstance();
+    if (!engine.isInGameScene || engine.isPaused) {
+        return;
     }
-    cv.notify_all(); // wake up the worker thread if it is waiting
+    scheduler.Advance(engine.fixedDT, engine.currentNumberOfSteps, [this](const GameEventComponent& event, double lateness) {
+#ifdef _LOGGING
+        ImGuiConsole::Cout("Processing event: %d enemies to spawn, %.1f ms after it was due", event.numEnemies, lateness * 1000.0);
+#else
+        (void)lateness;
+#endif
+        SpawnWave(event);
+    });
+}
+
+void EventSystem::AddEvent(const GameEventComponent& event) {
+    // startTime is read off the countdown timer, the clock counts up from the start of the game
+    scheduler.Schedule(static_cast<double>(Engine::GetInstance().maxTime) - event.startTime, event);
 }
 
 void EventSystem::SaveEvents(const std::string& filename) {
-    std::lock_guard<std::mutex> lock(queueMutex);
     std::ofstream ofs(filename, std::ios::binary);
     if (!ofs) {
 #ifdef _LOGGING
@@ -53,14 +66,12 @@ void EventSystem::SaveEvents(const std::string& filename) {
 #endif
         return;
     }
-	int size = static_cast<int>(eventQueue.size()) + static_cast<int>(missionVector.size());
+	int size = static_cast<int>(scheduler.GetPendingCount()) + static_cast<int>(missionVector.size());
     ofs.write(reinterpret_cast<char*>(&size), sizeof(int));
 
-    // Copy the queue to iterate without modifying the original
-    auto copy = eventQueue;
-    while (!copy.empty()) {
-        GameEventComponent event = copy.top();
-        copy.pop();
+    // Earliest first, the order the old event queue was written in
+    for (const auto& pending : scheduler.GetPending()) {
+        GameEventComponent event = pending.event;
         int typeInt = static_cast<int>(event.eventType);
         int enemyTypeInt = static_cast<int>(event.enemyType);
         ofs.write(reinterpret_cast<char*>(&typeInt), sizeof(int));
@@ -78,8 +89,6 @@ void EventSystem::SaveEvents(const std::string& filename) {
 }
 
 void EventSystem::LoadEvents(const std::string& filename) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-
 	WinCondition = false;
 
     if (!std::filesystem::exists(filename) || std::filesystem::is_empty(filename)) {
@@ -99,10 +108,8 @@ void EventSystem::LoadEvents(const std::string& filename) {
     int size = 0;
     ifs.read(reinterpret_cast<char*>(&size), sizeof(int));
 
-    // Clear current events before loading new ones
-    while (!eventQueue.empty()) {
-        eventQueue.pop();
-    }
+    // Clear current events before loading new ones, and start the clock again with the game
+    scheduler.Reset();
     missionVector.clear();
 
 
@@ -126,17 +133,13 @@ void EventSystem::LoadEvents(const std::string& filename) {
             ifs.read(reinterpret_cast<char*>(&numEnemies), sizeof(int));
             ifs.read(reinterpret_cast<char*>(&startTime), sizeof(float));
             GameEventComponent event(static_cast<EnemyType>(enemyTypeInt), numEnemies, startTime);
-            eventQueue.push(event);
+            AddEvent(event);
         }
     }
-    cv.notify_all(); // wake up the processing thread if necessary
 }
 
 void EventSystem::ClearEvents() {
-    while (!eventQueue.empty())
-    {
-        eventQueue.pop();
-    }
+    scheduler.Clear();
 }
 
 void EventSystem::ClearMissions() {
@@ -145,64 +148,36 @@ void EventSystem::ClearMissions() {
 
 
 void EventSystem::AddMission(const GameMissionComponent& mission) {
-	{
-		std::lock_guard<std::mutex> lock(queueMutex);
-		missionVector.push_back(mission);
-	}
-	cv.notify_all(); // wake up the worker thread if it is waiting
+	missionVector.push_back(mission);
 }
 
-void EventSystem::AddDeathEvent(const GameObject& GO) {
-    if (GO.GetName() == "Heavy_Enemy") {
-        for (auto& mission : missionVector) {
-            if (mission.enemyType == EnemyType::Heavy) {
-                --mission.numEnemies;
-                TextChange(mission.totalEnemies - mission.numEnemies, "TextChangeSkeleton", mission.totalEnemies);
-                if (mission.numEnemies <= 0) {
-                    mission.isCompleted = true;
-                    // popup message
-                    SetGreen(EnemyType::Heavy);
-                }
-            }
-        }
+bool EventSystem::GetEnemyType(const std::string& name, EnemyType& type) {
+    if (name == "Heavy_Enemy") {
+        type = EnemyType::Heavy;
     }
-    else if (GO.GetName() == "Light_Enemy") {
-        for (auto& mission : missionVector) {
-            if (mission.enemyType == EnemyType::Light) {
-                --mission.numEnemies;
-                TextChange( mission.totalEnemies - mission.numEnemies, "TextChangeSlime", mission.totalEnemies);
-                if (mission.numEnemies <= 0) {
-                    mission.isCompleted = true;
-                    // popup message
-                    SetGreen(EnemyType::Light);
-                }
-            }
-        }
+    else if (name == "Light_Enemy" || name.compare(0, 9, "BabyEnemy") == 0) {
+        type = EnemyType::Light;
     }
-    else if (GO.GetName().starts_with("BabyEnemy"))
-    {
-        for (auto& mission : missionVector) {
-            if (mission.enemyType == EnemyType::Light) {
-                --mission.numEnemies;
-                TextChange(mission.totalEnemies - mission.numEnemies, "TextChangeSlime", mission.totalEnemies);
-                if (mission.numEnemies <= 0) {
-                    mission.isCompleted = true;
-                    // popup message
-                    SetGreen(EnemyType::Light);
-                }
-            }
-        }
+    else if (name == "Bomb_Enemy" || name == "ExplosionVFX") {
+        type = EnemyType::Bomb;
     }
-    else if (GO.GetName() == "Bomb_Enemy" || GO.GetName() == "ExplosionVFX") {
-        for (auto& mission : missionVector) {
-            if (mission.enemyType == EnemyType::Bomb) {
-                --mission.numEnemies;
-                TextChange(mission.totalEnemies - mission.numEnemies, "TextChangeBomb", mission.totalEnemies);
-                if (mission.numEnemies <= 0) {
-                    mission.isCompleted = true;
-                    // popup message
-                    SetGreen(EnemyType::Bomb);
-                }
+    else {
+        return false;
+    }
+    return true;
+}
+
+void EventSystem::OnEnemyKilled(const EnemyKilledEvent& event) {
+    const char* counterTag = event.enemyType == EnemyType::Heavy ? "TextChangeSkeleton"
+        : event.enemyType == EnemyType::Light ? "TextChangeSlime" : "TextChangeBomb";
+    for (auto& mission : missionVector) {
+        if (mission.enemyType == event.enemyType) {
+            --mission.numEnemies;
+            TextChange(mission.totalEnemies - mission.numEnemies, counterTag, mission.totalEnemies);
+            if (mission.numEnemies <= 0) {
+                mission.isCompleted = true;
+                // popup message
+                SetGreen(event.enemyType);
             }
         }
     }
@@ -212,129 +187,100 @@ void EventSystem::AddDeathEvent(const GameObject& GO) {
             return;
     }
 	// If all missions are completed
-	WinCondition = true;
+	SetWinCondition(true);
+}
+
+void EventSystem::SetWinCondition(bool state) {
+    if (state && !WinCondition) {
+        EventBus::GetInstance().Post(MissionsCompletedEvent{});
+    }
+    WinCondition = state;
 }
 
 
 const std::priority_queue<GameEventComponent, std::vector<GameEventComponent>, EventCompare> EventSystem::GetEventQueue() {
-    std::lock_guard<std::mutex> lock(queueMutex);
+    std::priority_queue<GameEventComponent, std::vector<GameEventComponent>, EventCompare> eventQueue;
+    for (const auto& pending : scheduler.GetPending()) {
+        eventQueue.push(pending.event);
+    }
     return eventQueue;
 }
 
 const std::vector<GameMissionComponent>& EventSystem::GetMissionVector() {
-	std::lock_guard<std::mutex> lock(queueMutex);
 	return missionVector;
 }
 
 EventSystem::~EventSystem() {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        running = false;
-        cv.notify_all();
-    }
-    if (workerThread.joinable())
-        workerThread.join();
+    EventBus::GetInstance().Unsubscribe(enemyKilledSubscription);
 }
 
-void EventSystem::ProcessEvents() {
-    std::unique_lock<std::mutex> lock(queueMutex);
-    while (running) {
-
-        // If engine is not in the game scene or is paused, wait a while.
-        if (eventQueue.empty() || !Engine::GetInstance().isInGameScene || Engine::GetInstance().isPaused) {
-			cv.wait_for(lock, std::chrono::seconds(1));
-            continue; // Recheck conditions after the wait
-        }
-
-        // Get the event at the top (earliest scheduled)
-        const GameEventComponent& nextEvent = eventQueue.top();
-        float currTime = Engine::GetInstance().time;
-
+void EventSystem::SpawnWave(const GameEventComponent& e) {
+    GameObjectFactory& factory = GameObjectFactory::GetInstance();
+    GameObject* player = factory.GetPlayerObject();
+    if (!player) {
+        return;
+    }
+	Vector2 playerPos = player->GetComponent<TransformComponent>(TRANSFORM)->GetLocalPosition();
+
+	// Check if player is on the right or left side of the screen
+    float rightBorder = 1997.0f;
+    float leftBorder = -848.f;
+    float distRight = rightBorder - playerPos.x;
+	float distLeft = playerPos.x - leftBorder;
+
+	// Spawn enemies on the side opposite to the player
+	Vector2 spawnPosition;
+	if (abs(distRight) < abs(distLeft)) {
+		spawnPosition = Vector2{ leftBorder , 0.f };
+	}
+	else {
+		spawnPosition = Vector2{ rightBorder , 0.f };
+	}
 
-        // If the event is not due yet, wait abit
-        if (currTime > nextEvent.startTime) {
-			float waitTime = currTime - nextEvent.startTime;
-			cv.wait_for(lock, std::chrono::seconds(static_cast<int>(waitTime)));
-            continue; // Recheck conditions after the wait
-        }
-        else {
-            //TriggerUpDown();
-            GameEventComponent e = nextEvent;
-            eventQueue.pop();
-            lock.unlock();
-#ifdef _LOGGING
-            ImGuiConsole::Cout("Processing event: %d enemies to spawn", e.numEnemies);
-#endif
-            GameObjectFactory& factory = GameObjectFactory::GetInstance();
-            auto gameObjects = factory.GetAllGameObjects();
-            GameObject* player = factory.GetPlayerObject();
-			Vector2 playerPos = player->GetComponent<TransformComponent>(TRANSFORM)->GetLocalPosition();
-
-			// Check if player is on the right or left side of the screen
-            float rightBorder = 1997.0f;
-            float leftBorder = -848.f;
-            float distRight = rightBorder - playerPos.x;
-			float distLeft = playerPos.x - leftBorder;
-
-			// Spawn enemies on the side opposite to the player
-			Vector2 spawnPosition;
-			if (abs(distRight) < abs(distLeft)) {
-				spawnPosition = Vector2{ leftBorder , 0.f };
-			}
-			else {
-				spawnPosition = Vector2{ rightBorder , 0.f };
-			}
-
-            // check type here
-			if (e.enemyType == EnemyType::Light) {
-				for (int i = 0; i < e.numEnemies; i++)
-				{
-					GameObject* GO = factory.CreateFromLua("Assets/Lua/Prefabs/Light_Enemy.lua", "Light_Enemy_0");
-					GO->GetComponent<TransformComponent>(TRANSFORM)->SetLocalPosition(spawnPosition);
-                    GO->GetComponent<AIStateMachineComponent>(AISTATE)->SetState("CHASE");
-				}
-			}
-            else if (e.enemyType == EnemyType::Heavy) {
-                for (int i = 0; i < e.numEnemies; i++)
-                {
-                    GameObject* GO = factory.CreateFromLua("Assets/Lua/Prefabs/Heavy_Enemy.lua", "Heavy_Enemy_0");
-                    // Get the player object to set as the chase target
-                    GameObject* playerOBJ = factory.GetPlayerObject();
-
-                    // Configure AI behavior
-                    if (playerOBJ && GO) {
-                        AIStateMachineComponent* aiComponent = GO->GetComponent<AIStateMachineComponent>(TypeOfComponent::AISTATE);
-                        GO->GetComponent<TransformComponent>(TRANSFORM)->SetLocalPosition(spawnPosition);
-                        if (aiComponent) {
-                            aiComponent->SetState("CHASE");
-                            aiComponent->SetChaseTarget(playerOBJ);
-                            aiComponent->SetMoveSpeed(100.0f);
-                        }
-                    }
+    // check type here
+	if (e.enemyType == EnemyType::Light) {
+		for (int i = 0; i < e.numEnemies; i++)
+		{
+			GameObject* GO = factory.CreateFromLua("Assets/Lua/Prefabs/Light_Enemy.lua", "Light_Enemy_0");
+			GO->GetComponent<TransformComponent>(TRANSFORM)->SetLocalPosition(spawnPosition);
+            GO->GetComponent<AIStateMachineComponent>(AISTATE)->SetState("CHASE");
+		}
+	}
+    else if (e.enemyType == EnemyType::Heavy) {
+        for (int i = 0; i < e.numEnemies; i++)
+        {
+            GameObject* GO = factory.CreateFromLua("Assets/Lua/Prefabs/Heavy_Enemy.lua", "Heavy_Enemy_0");
+            // Get the player object to set as the chase target
+            GameObject* playerOBJ = factory.GetPlayerObject();
+
+            // Configure AI behavior
+            if (playerOBJ && GO) {
+                AIStateMachineComponent* aiComponent = GO->GetComponent<AIStateMachineComponent>(TypeOfComponent::AISTATE);
+                GO->GetComponent<TransformComponent>(TRANSFORM)->SetLocalPosition(spawnPosition);
+                if (aiComponent) {
+                    aiComponent->SetState("CHASE");
+                    aiComponent->SetChaseTarget(playerOBJ);
+                    aiComponent->SetMoveSpeed(100.0f);
                 }
-			}
-			else if (e.enemyType == EnemyType::Bomb) {
-				for (int i = 0; i < e.numEnemies; i++)
-				{
-					GameObject* GO = factory.CreateFromLua("Assets/Lua/Prefabs/Bomb_Enemy.lua", "Bomb_Enemy_0");
-                    // Get the player object to set as the chase target
-                    GameObject* playerOBJ = factory.GetPlayerObject();
-
-                    // Configure AI behavior
-                    if (playerOBJ && GO) {
-                        AIStateMachineComponent* aiComponent = GO->GetComponent<AIStateMachineComponent>(TypeOfComponent::AISTATE);
-                        GO->GetComponent<TransformComponent>(TRANSFORM)->SetLocalPosition(spawnPosition);
-                        if (aiComponent) {
-                            aiComponent->SetState("CHASE");
-                            aiComponent->SetChaseTarget(playerOBJ);
-                        }
-                    }
-				}
-			}
-
-
-            lock.lock();
+            }
         }
-
-    }
+	}
+	else if (e.enemyType == EnemyType::Bomb) {
+		for (int i = 0; i < e.numEnemies; i++)
+		{
+			GameObject* GO = factory.CreateFromLua("Assets/Lua/Prefabs/Bomb_Enemy.lua", "Bomb_Enemy_0");
+            // Get the player object to set as the chase target
+            GameObject* playerOBJ = factory.GetPlayerObject();
+
+            // Configure AI behavior
+            if (playerOBJ && GO) {
+                AIStateMachineComponent* aiComponent = GO->GetComponent<AIStateMachineComponent>(TypeOfComponent::AISTATE);
+                GO->GetComponent<TransformComponent>(TRANSFORM)->SetLocalPosition(spawnPosition);
+                if (aiComponent) {
+                    aiComponent->SetState("CHASE");
+                    aiComponent->SetChaseTarget(playerOBJ);
+                }
+            }
+		}
+	}
 }
@@ -68,8 +68,8 @@ void ExplosionComponent::Update() {
         blinkTimer -= blinkInterval;  // Maintain accuracy by subtracting, not resetting
 
         if (!explodingSFX) {
-            AudioManager::GetInstance().PlayAudio(14);
-            AudioManager::GetInstance().SetChannelVolume(14, 0.5f);  // Make this audio softer
+            AudioManager::GetInstance().PostPlay(14);
+            AudioManager::GetInstance().PostChannelVolume(14, 0.5f);  // Make this audio softer
             explodingSFX = true;
 
         }
@@ -186,8 +186,8 @@ void ExplosionComponent::DisplayBlastRadius(const Vector2& center, float radius)
                 float scale = 300 * (radius / (textureWidth / 2.0f));
                 transformComponent->SetLocalScale(Vector2(scale, scale));
                 ImGuiConsole::Cout( "Blast radius object scaled to: %f",scale);
-                AudioManager::GetInstance().PlayAudio(13);
-                AudioManager::GetInstance().SetChannelVolume(13, 1.f);  // Make this audio louder
+                AudioManager::GetInstance().PostPlay(13);
+                AudioManager::GetInstance().PostChannelVolume(13, 1.f);  // Make this audio louder
 
             }
             else {
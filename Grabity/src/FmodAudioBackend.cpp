@@ -0,0 +1,427 @@
+/*!****************************************************************
+\file: FmodAudioBackend.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the FMOD implementation of AudioBackend. Sound and
+        channel IDs map to FMOD sounds and channels; channels that
+        finished are forgotten on Update. FMOD channel handles turn
+        invalid when FMOD steals or reuses the channel, which reads
+        as "not playing".
+
+        Streamed sounds read their files through FMOD's file callbacks,
+        which hand the reads to the StreamingBufferManager so streams
+        share its buffers and can come from the asset pack. FMOD plays
+        one channel of a stream at a time; playing it again restarts
+        it, which suits the music it is used for.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#ifndef _NO_FMOD
+#include "FmodAudioBackend.h"
+#include "StreamingBufferManager.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+
+namespace {
+    constexpr unsigned int StreamDecodeMilliseconds = 400;  // FMOD's default decode buffer
+
+    // FMOD file callbacks, run on FMOD's stream thread
+    FMOD_RESULT F_CALL OpenStreamFile(const char* name, unsigned int* fileSize, void** handle, void*) {
+        StreamingBufferManager& streaming = StreamingBufferManager::GetInstance();
+        StreamingBufferManager::Stream* stream = streaming.Open(name);
+        if (!stream) {
+            return FMOD_ERR_FILE_NOTFOUND;
+        }
+        *fileSize = static_cast<unsigned int>(streaming.GetSize(stream));
+        *handle = stream;
+        return FMOD_OK;
+    }
+
+    FMOD_RESULT F_CALL CloseStreamFile(void* handle, void*) {
+        StreamingBufferManager::GetInstance().Close(static_cast<StreamingBufferManager::Stream*>(handle));
+        return FMOD_OK;
+    }
+
+    FMOD_RESULT F_CALL ReadStreamFile(void* handle, void* buffer, unsigned int bytes, unsigned int* bytesRead, void*) {
+        *bytesRead = static_cast<unsigned int>(StreamingBufferManager::GetInstance().Read(static_cast<StreamingBufferManager::Stream*>(handle), buffer, bytes));
+        return *bytesRead < bytes ? FMOD_ERR_FILE_EOF : FMOD_OK;
+    }
+
+    FMOD_RESULT F_CALL SeekStreamFile(void* handle, unsigned int position, void*) {
+        return StreamingBufferManager::GetInstance().Seek(static_cast<StreamingBufferManager::Stream*>(handle), position) ? FMOD_OK : FMOD_ERR_FILE_COULDNOTSEEK;
+    }
+}
+
+// Starts FMOD.
+bool FmodAudioBackend::Init(int maxChannels) {
+    FMOD_RESULT result = FMOD::System_Create(&system);
+    if (result != FMOD_OK) {
+        ImGuiConsole::Cout("FMOD System creation failure");
+        system = nullptr;
+        return false;
+    }
+
+    // The output format and buffer size only take effect before init
+    system->setSoftwareFormat(0, FMOD_SPEAKERMODE_DEFAULT, 0);
+    system->setDSPBufferSize(1024, 4); // Smaller buffer for responsiveness
+
+    // Silent channels stop costing mixing time; the voice manager mutes the ones it makes virtual
+    result = system->init(maxChannels, FMOD_INIT_NORMAL | FMOD_INIT_VOL0_BECOMES_VIRTUAL, nullptr);
+    if (result != FMOD_OK) {
+        ImGuiConsole::Cout("FMOD System init failure: %d", result);
+        return false;
+    }
+    system->getSoftwareFormat(&outputRate, nullptr, nullptr);
+    return true;
+}
+
+// Stops every channel and releases FMOD.
+void FmodAudioBackend::Release() {
+    if (!system) {
+        return;
+    }
+    while (!channels.empty()) {
+        channels.begin()->second.channel->stop();
+        Forget(channels.begin());
+    }
+    {
+        std::lock_guard<std::mutex> lock(soundMutex);
+        for (auto& [id, sound] : sounds) {
+            sound->release();
+        }
+        sounds.clear();
+        soundMemory.clear();
+    }
+    system->close();
+    system->release();
+    system = nullptr;
+}
+
+// Updates FMOD and forgets channels that finished.
+void FmodAudioBackend::Update() {
+    if (!system) {
+        return;
+    }
+    system->update();
+    for (auto it = channels.begin(); it != channels.end(); ) {
+        bool isPlaying = false;
+        if (it->second.channel->isPlaying(&isPlaying) != FMOD_OK || !isPlaying) {
+            auto finished = it++;
+            Forget(finished);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+// Creates a sound from an encoded audio file in memory. FMOD_OPENMEMORY copies the data;
+// a compressed sample keeps it encoded and decodes it as channels play.
+AudioBackend::SoundID FmodAudioBackend::CreateSound(const void* data, size_t size, bool loop, LoadMode loadMode) {
+    if (!system || !data || size == 0) {
+        return InvalidID;
+    }
+    FMOD_CREATESOUNDEXINFO info{};
+    info.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    info.length = static_cast<unsigned int>(size);
+    FMOD::Sound* sound = nullptr;
+    loadMode = loadMode == LoadMode::COMPRESSED ? LoadMode::COMPRESSED : LoadMode::DECOMPRESSED;
+    FMOD_MODE mode = (loop ? FMOD_LOOP_NORMAL : FMOD_DEFAULT) | FMOD_OPENMEMORY |
+        (loadMode == LoadMode::COMPRESSED ? FMOD_CREATECOMPRESSEDSAMPLE : FMOD_CREATESAMPLE);
+    if (system->createSound(static_cast<const char*>(data), mode, &info, &sound) != FMOD_OK) {
+        return InvalidID;
+    }
+    return AddSound(sound, loadMode, size);
+}
+
+// Creates a sound streamed from its file through the StreamingBufferManager.
+AudioBackend::SoundID FmodAudioBackend::CreateStream(const std::string& path, bool loop) {
+    if (!system) {
+        return InvalidID;
+    }
+    FMOD_CREATESOUNDEXINFO info{};
+    info.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    info.decodebuffersize = StreamDecodeMilliseconds;
+    info.fileuseropen = OpenStreamFile;
+    info.fileuserclose = CloseStreamFile;
+    info.fileuserread = ReadStreamFile;
+    info.fileuserseek = SeekStreamFile;
+    FMOD::Sound* sound = nullptr;
+    FMOD_MODE mode = (loop ? FMOD_LOOP_NORMAL : FMOD_DEFAULT) | FMOD_CREATESTREAM;
+    if (system->createSound(path.c_str(), mode, &info, &sound) != FMOD_OK) {
+        ImGuiConsole::Cout("FMOD could not open %s to stream", path.c_str());
+        return InvalidID;
+    }
+    return AddSound(sound, LoadMode::STREAMED, 0);
+}
+
+// Adds a created sound and works out the memory it takes.
+AudioBackend::SoundID FmodAudioBackend::AddSound(FMOD::Sound* sound, LoadMode mode, size_t fileSize) {
+    SoundMemory memory;
+    unsigned int pcmBytes = 0;
+    sound->getLength(&pcmBytes, FMOD_TIMEUNIT_PCMBYTES);
+    memory.decoded = pcmBytes;
+
+    FMOD_SOUND_FORMAT format = FMOD_SOUND_FORMAT_NONE;
+    int channelCount = 0;
+    int bits = 0;
+    float frequency = 0.0f;
+    sound->getFormat(nullptr, &format, &channelCount, &bits);
+    sound->getDefaults(&frequency, nullptr);
+    switch (mode) {
+    case LoadMode::COMPRESSED:
+        // Formats FMOD cannot decode on the fly, e.g. PCM WAV, are loaded as plain samples
+        memory.resident = format == FMOD_SOUND_FORMAT_BITSTREAM ? fileSize : pcmBytes;
+        break;
+    case LoadMode::STREAMED:
+        // FMOD's decode buffer; the file buffer is counted by the StreamingBufferManager
+        memory.resident = static_cast<size_t>(frequency * StreamDecodeMilliseconds / 1000.0f) * channelCount * sizeof(int16_t);
+        break;
+    default:
+        memory.resident = pcmBytes;
+        break;
+    }
+
+    std::lock_guard<std::mutex> lock(soundMutex);
+    SoundID id = nextSound++;
+    sounds.emplace(id, sound);
+    soundMemory.emplace(id, memory);
+    return id;
+}
+
+// Releases a sound. FMOD stops the channels still playing it.
+void FmodAudioBackend::ReleaseSound(SoundID sound) {
+    FMOD::Sound* released = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(soundMutex);
+        auto it = sounds.find(sound);
+        if (it == sounds.end()) {
+            return;
+        }
+        released = it->second;
+        sounds.erase(it);
+        soundMemory.erase(sound);
+    }
+    released->release();
+}
+
+// Retrieves the memory a sound takes in its load mode, and decoded to PCM.
+AudioBackend::SoundMemory FmodAudioBackend::GetSoundMemory(SoundID sound) const {
+    std::lock_guard<std::mutex> lock(soundMutex);
+    auto it = soundMemory.find(sound);
+    return it != soundMemory.end() ? it->second : SoundMemory{};
+}
+
+// Starts a channel playing a sound.
+AudioBackend::ChannelID FmodAudioBackend::Play(SoundID sound, bool paused) {
+    FMOD::Sound* fmodSound = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(soundMutex);
+        auto it = sounds.find(sound);
+        if (it == sounds.end()) {
+            return InvalidID;
+        }
+        fmodSound = it->second;
+    }
+
+    FMOD::Channel* channel = nullptr;
+    if (system->playSound(fmodSound, nullptr, paused, &channel) != FMOD_OK || !channel) {
+        return InvalidID;
+    }
+    ChannelID id = nextChannel++;
+    if (nextChannel == InvalidID) {
+        ++nextChannel;
+    }
+    channels[id] = { channel, sound, nullptr };
+    return id;
+}
+
+// Stops a channel.
+void FmodAudioBackend::Stop(ChannelID channel) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.channel->stop();
+        Forget(it);
+    }
+}
+
+// Checks if a channel is still playing, paused channels included.
+bool FmodAudioBackend::IsPlaying(ChannelID channel) const {
+    FMOD::Channel* fmodChannel = Find(channel);
+    bool isPlaying = false;
+    return fmodChannel && fmodChannel->isPlaying(&isPlaying) == FMOD_OK && isPlaying;
+}
+
+// Retrieves the sound a channel plays.
+AudioBackend::SoundID FmodAudioBackend::GetSound(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() && IsPlaying(channel) ? it->second.sound : InvalidID;
+}
+
+void FmodAudioBackend::SetPaused(ChannelID channel, bool paused) {
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->setPaused(paused);
+    }
+}
+
+bool FmodAudioBackend::IsPaused(ChannelID channel) const {
+    bool paused = false;
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->getPaused(&paused);
+    }
+    return paused;
+}
+
+void FmodAudioBackend::SetVolume(ChannelID channel, float volume) {
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->setVolume(volume);
+    }
+}
+
+float FmodAudioBackend::GetVolume(ChannelID channel) const {
+    float volume = 0.0f;
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->getVolume(&volume);
+    }
+    return volume;
+}
+
+void FmodAudioBackend::SetMute(ChannelID channel, bool mute) {
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->setMute(mute);
+    }
+}
+
+void FmodAudioBackend::SetPriority(ChannelID channel, int priority) {
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->setPriority(priority);
+    }
+}
+
+void FmodAudioBackend::SetLooping(ChannelID channel, bool loop) {
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->setMode((loop ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF) | FMOD_2D);
+    }
+}
+
+unsigned int FmodAudioBackend::GetPosition(ChannelID channel) const {
+    unsigned int position = 0;
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->getPosition(&position, FMOD_TIMEUNIT_MS);
+    }
+    return position;
+}
+
+void FmodAudioBackend::SetPosition(ChannelID channel, unsigned int milliseconds) {
+    if (FMOD::Channel* fmodChannel = Find(channel)) {
+        fmodChannel->setPosition(milliseconds, FMOD_TIMEUNIT_MS);
+    }
+}
+
+// Sets the cutoff of the channel's low-pass filter, adding or removing the DSP as needed.
+void FmodAudioBackend::SetLowPass(ChannelID channel, float cutoff) {
+    auto it = channels.find(channel);
+    if (it == channels.end()) {
+        return;
+    }
+    PlayingChannel& playing = it->second;
+    if (cutoff >= LowPassOff) {
+        if (playing.lowPass) {
+            playing.channel->removeDSP(playing.lowPass);
+            playing.lowPass->release();
+            playing.lowPass = nullptr;
+        }
+        return;
+    }
+    if (!playing.lowPass) {
+        if (system->createDSPByType(FMOD_DSP_TYPE_LOWPASS, &playing.lowPass) != FMOD_OK) {
+            playing.lowPass = nullptr;
+            return;
+        }
+        playing.channel->addDSP(0, playing.lowPass);
+    }
+    playing.lowPass->setParameterFloat(FMOD_DSP_LOWPASS_CUTOFF, cutoff);
+}
+
+float FmodAudioBackend::GetLowPass(ChannelID channel) const {
+    auto it = channels.find(channel);
+    float cutoff = LowPassOff;
+    if (it != channels.end() && it->second.lowPass) {
+        it->second.lowPass->getParameterFloat(FMOD_DSP_LOWPASS_CUTOFF, &cutoff, nullptr, 0);
+    }
+    return cutoff;
+}
+
+// Ramps the channel's fade gain with FMOD fade points, which the mixer interpolates per sample.
+void FmodAudioBackend::FadeTo(ChannelID channel, float target, float seconds, bool stopAtEnd) {
+    auto it = channels.find(channel);
+    if (it == channels.end()) {
+        return;
+    }
+    PlayingChannel& playing = it->second;
+    unsigned long long now = 0;
+    if (playing.channel->getDSPClock(nullptr, &now) != FMOD_OK) {
+        return;
+    }
+
+    playing.fadeFrom = GetFadeAt(playing, now);
+    playing.fadeTarget = target;
+    playing.fadeStart = now;
+    playing.fadeEnd = now + static_cast<unsigned long long>(std::max(seconds, 0.0f) * outputRate);
+    playing.channel->removeFadePoints(0, ~0ull);
+    playing.channel->addFadePoint(playing.fadeStart, playing.fadeFrom);
+    playing.channel->addFadePoint(playing.fadeEnd, playing.fadeTarget);
+
+    // The delay end stops the channel on the exact sample, rather than on the next Update
+    if (stopAtEnd || playing.stopAtFadeEnd) {
+        playing.channel->setDelay(0, stopAtEnd ? playing.fadeEnd : 0, stopAtEnd);
+    }
+    playing.stopAtFadeEnd = stopAtEnd;
+}
+
+float FmodAudioBackend::GetFade(ChannelID channel) const {
+    auto it = channels.find(channel);
+    unsigned long long now = 0;
+    if (it == channels.end() || it->second.channel->getDSPClock(nullptr, &now) != FMOD_OK) {
+        return 1.0f;
+    }
+    return GetFadeAt(it->second, now);
+}
+
+int FmodAudioBackend::GetChannelsPlaying() const {
+    int playing = 0;
+    if (system) {
+        system->getChannelsPlaying(&playing, nullptr);
+    }
+    return playing;
+}
+
+// Retrieves the FMOD channel of an ID.
+FMOD::Channel* FmodAudioBackend::Find(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() ? it->second.channel : nullptr;
+}
+
+// Retrieves the fade gain of a channel at a parent DSP clock.
+float FmodAudioBackend::GetFadeAt(const PlayingChannel& playing, unsigned long long clock) {
+    if (clock >= playing.fadeEnd) {
+        return playing.fadeTarget;
+    }
+    if (clock <= playing.fadeStart) {
+        return playing.fadeFrom;
+    }
+    const float t = static_cast<float>(clock - playing.fadeStart) / static_cast<float>(playing.fadeEnd - playing.fadeStart);
+    return playing.fadeFrom + (playing.fadeTarget - playing.fadeFrom) * t;
+}
+
+// Forgets a channel and releases its low-pass filter.
+void FmodAudioBackend::Forget(std::unordered_map<ChannelID, PlayingChannel>::iterator it) {
+    if (it->second.lowPass) {
+        it->second.channel->removeDSP(it->second.lowPass);
+        it->second.lowPass->release();
+    }
+    channels.erase(it);
+}
+#endif // !_NO_FMOD
@@ -14,6 +14,8 @@ Technology is prohibited.
 #include "Font.h"
 #include <glhelper.h>
 #include <ImGuiConsole.h>
+#include "VirtualFileSystem.h"
+#include <algorithm>
 
 #ifdef _IMGUI
 #include <iostream>
@@ -22,6 +24,15 @@ Technology is prohibited.
 //loading of font based on the path to the path and the pixel to be extracted
 void Font::LoadFont(std::string fontPath, FT_UInt pixelSize)
 {
+    RasterizeFont(fontPath, pixelSize);
+    UploadGlyphs();
+}
+
+// rasterize the glyphs of the font into memory, does not touch OpenGL so it can run on any thread
+bool Font::RasterizeFont(const std::string& fontPath, FT_UInt pixelSize)
+{
+    pendingGlyphs.clear();
+
     FT_Library ft;
 
     // All functions return a value different than 0 whenever an error occurred
@@ -30,78 +41,112 @@ void Font::LoadFont(std::string fontPath, FT_UInt pixelSize)
 #ifdef _LOGGING
         ImGuiConsole::Cout("ERROR::FREETYPE: Could not init FreeType Library");
 #endif // _LOGGING
+        return false;
     }
 
-    // load font as face
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) 
+    // load font as face from memory, the file has to stay alive until FT_Done_Face
+    VirtualFile fontFile = VirtualFileSystem::GetInstance().Open(fontPath);
+    FT_Face face = nullptr;
+    if (!fontFile || FT_New_Memory_Face(ft, fontFile.GetData(), static_cast<FT_Long>(fontFile.GetSize()), 0, &face)) 
     {
 #ifdef _LOGGING
         ImGuiConsole::Cout("ERROR::FREETYPE: Failed to load font");
 #endif // _LOGGING
+        FT_Done_FreeType(ft);
+        return false;
     }
-    else 
-    {
-        // set size to load glyphs as
-        FT_Set_Pixel_Sizes(face, 0, pixelSize);
 
-        // OpenGL has a restriction requiring textures to adhere to a 4-byte alignment, therefore
-        // disable byte-alignment restriction as the texture width might not be in a multiple of 4
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // set size to load glyphs as
+    FT_Set_Pixel_Sizes(face, 0, pixelSize);
 
-        // load first 128 characters of ASCII set
-        for (unsigned char c = 0; c < 128; c++)
+    // load first 128 characters of ASCII set
+    pendingGlyphs.reserve(128);
+    for (unsigned char c = 0; c < 128; c++)
+    {
+        // Load character glyph 
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
         {
-            // Load character glyph 
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-            {
 #ifdef _LOGGING
-                ImGuiConsole::Cout("ERROR::FREETYTPE: Failed to load Glyph");
+            ImGuiConsole::Cout("ERROR::FREETYTPE: Failed to load Glyph");
 #endif // _LOGGING
-                continue;
-            }
-
-            // generate texture
-            unsigned int texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-
-            // The glyph's bitmap is a grayscale 8-bit image, with each pixel represented by a single byte.
-            // Therefore, we use GL_RED for both the internal format and format to stored data in the red channel
-            // to allows interpretation of the single-byte values as grayscale.
-            glTexImage2D(GL_TEXTURE_2D,                 // target
-                         0,                             // base image level
-                         GL_RED,                        // the number of color components in the texture
-                         face->glyph->bitmap.width,     // width
-                         face->glyph->bitmap.rows,      // height
-                         0,                             // border (must be 0)
-                         GL_RED,                        // the format of the pixel data (for RGB setting)
-                         GL_UNSIGNED_BYTE,              // the format of the pixel data
-                         face->glyph->bitmap.buffer     // pointer to the image data
-            );
-
-            // set texture options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            
-            // store character for later use
-            Character character = { texture,
-                Vector2(static_cast<float>(face->glyph->bitmap.width), static_cast<float>(face->glyph->bitmap.rows)),
-                Vector2(static_cast<float>(face->glyph->bitmap_left), static_cast<float>(face->glyph->bitmap_top)),
-                static_cast<unsigned int>(face->glyph->advance.x)
-            };
-            characters.insert(std::pair<char, Character>(c, character));
+            continue;
         }
 
-        // unbind it upon finished modifying
-        glBindTexture(GL_TEXTURE_2D, 0);
+        // keep a copy of the bitmap, FreeType reuses its buffer for the next glyph
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        RasterizedGlyph glyph;
+        glyph.character = static_cast<char>(c);
+        glyph.width = bitmap.width;
+        glyph.rows = bitmap.rows;
+        glyph.left = face->glyph->bitmap_left;
+        glyph.top = face->glyph->bitmap_top;
+        glyph.advance = static_cast<unsigned int>(face->glyph->advance.x);
+        glyph.pixels.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int row = 0; row < bitmap.rows; ++row)
+        {
+            std::copy_n(bitmap.buffer + static_cast<ptrdiff_t>(row) * bitmap.pitch, bitmap.width,
+                glyph.pixels.begin() + static_cast<ptrdiff_t>(row) * bitmap.width);
+        }
+        pendingGlyphs.push_back(std::move(glyph));
     }
 
     // destroy FreeType once finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
+    return true;
+}
+
+// create a texture for every rasterized glyph, must run on the thread that owns the OpenGL context
+void Font::UploadGlyphs()
+{
+    if (pendingGlyphs.empty())
+        return;
+
+    // OpenGL has a restriction requiring textures to adhere to a 4-byte alignment, therefore
+    // disable byte-alignment restriction as the texture width might not be in a multiple of 4
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    for (const RasterizedGlyph& glyph : pendingGlyphs)
+    {
+        // generate texture
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        // The glyph's bitmap is a grayscale 8-bit image, with each pixel represented by a single byte.
+        // Therefore, we use GL_RED for both the internal format and format to stored data in the red channel
+        // to allows interpretation of the single-byte values as grayscale.
+        glTexImage2D(GL_TEXTURE_2D,                 // target
+                     0,                             // base image level
+                     GL_RED,                        // the number of color components in the texture
+                     glyph.width,                   // width
+                     glyph.rows,                    // height
+                     0,                             // border (must be 0)
+                     GL_RED,                        // the format of the pixel data (for RGB setting)
+                     GL_UNSIGNED_BYTE,              // the format of the pixel data
+                     glyph.pixels.empty() ? nullptr : glyph.pixels.data() // pointer to the image data
+        );
+
+        // set texture options
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // store character for later use
+        Character character = { texture,
+            Vector2(static_cast<float>(glyph.width), static_cast<float>(glyph.rows)),
+            Vector2(static_cast<float>(glyph.left), static_cast<float>(glyph.top)),
+            glyph.advance
+        };
+        characters.insert(std::pair<char, Character>(glyph.character, character));
+    }
+
+    // unbind it upon finished modifying
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    pendingGlyphs.clear();
+    pendingGlyphs.shrink_to_fit();
 }
 
 // Render of the text based on its given string, coordinates, color, VAO and VBO IDs
@@ -0,0 +1,260 @@
+/*!****************************************************************
+\file: FramePacer.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the FramePacer. The wait sleeps in steps: each sleep
+        asks for the time left minus the overshoot estimate, then
+        checks again, so a sleep that woke early is followed by a
+        shorter one and only the last fraction of a millisecond is
+        spun. A frame that ends after the next one was due starts the
+        schedule over instead of rushing the frames after it, and so
+        does a wait that was interrupted.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+// Ensure APIENTRY is undefined before including Windows headers
+#ifdef APIENTRY
+#undef APIENTRY
+#endif
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+
+// Windows 10 1803 and later; older SDKs do not name it
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif // _WIN32
+
+namespace {
+    /**
+     * \brief Converts a clock duration to milliseconds.
+     * \param duration The duration.
+     * \return Milliseconds.
+     */
+    double ToMilliseconds(FramePacer::Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+/**
+ * \brief Retrieves the frame pacer instance.
+ * \return Reference to the frame pacer.
+ */
+FramePacer& FramePacer::GetInstance() {
+    static FramePacer instance;
+    return instance;
+}
+
+/**
+ * \brief Sets up the high-resolution timer, or a finer system timer where it is not available.
+ */
+FramePacer::FramePacer() {
+#ifdef _WIN32
+    waitableTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!waitableTimer) {
+        // Sleep rounds up to the system timer period, 15.6 ms unless asked for finer
+        raisedTimerResolution = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+#endif // _WIN32
+}
+
+/**
+ * \brief Releases the timer.
+ */
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    if (waitableTimer) {
+        CloseHandle(waitableTimer);
+    }
+    if (raisedTimerResolution) {
+        timeEndPeriod(1);
+    }
+#endif // _WIN32
+}
+
+/**
+ * \brief Sets the frame rate to hold the loop to. The schedule starts again from the next frame.
+ * \param framesPerSecond The target, 0 or less for no limit.
+ */
+void FramePacer::SetTargetFrameRate(double framesPerSecond) {
+    targetFrameRate = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+    period = targetFrameRate > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFrameRate))
+        : Clock::duration::zero();
+    scheduled = false;
+}
+
+/**
+ * \brief Waits until the next frame is due, then returns. Called once at the end of every frame.
+ */
+void FramePacer::WaitForNextFrame() {
+    Clock::time_point now = Clock::now();
+    FrameRecord record;
+
+    if (period > Clock::duration::zero()) {
+        deadline = scheduled ? deadline + period : now + period;
+        scheduled = true;
+
+        if (now >= deadline) {
+            // Already late: count it and carry on from here
+            record.lateness = ToMilliseconds(now - deadline);
+            ++missedFrames;
+            deadline = now;
+        }
+        else {
+            const Clock::time_point sleepStart = now;
+            bool slept = false;
+            while (!interrupted) {
+                const double estimate = overshootMean + 2.0 * std::sqrt(overshootVariance);
+                const double sleepTime = ToMilliseconds(deadline - now) - estimate - MinSpin;
+                if (sleepTime <= 0.0) {
+                    break;
+                }
+                SleepFor(sleepTime);
+                slept = true;
+                now = Clock::now();
+            }
+            record.sleep = ToMilliseconds(now - sleepStart);
+            if (!slept && ToMilliseconds(deadline - now) > MinSpin + MinSleep) {
+                DecayOvershoot();
+            }
+
+            const Clock::time_point spinStart = now;
+            while (now < deadline && !interrupted) {
+                std::this_thread::yield();
+                now = Clock::now();
+            }
+            record.spin = ToMilliseconds(now - spinStart);
+            record.lateness = std::max(ToMilliseconds(now - deadline), 0.0);
+        }
+    }
+    if (interrupted) {
+        // Cut short, so the schedule starts again from here
+        interrupted = false;
+        scheduled = false;
+    }
+
+    if (started) {
+        record.frameTime = ToMilliseconds(now - lastFrameEnd);
+        history[historyNext] = record;
+        historyNext = (historyNext + 1) % HistorySize;
+        historyCount = std::min(historyCount + 1, HistorySize);
+    }
+    lastFrameEnd = now;
+    started = true;
+}
+
+/**
+ * \brief Retrieves the pacing over the last frames.
+ * \return A copy of the stats.
+ */
+FramePacer::Stats FramePacer::GetStats() const {
+    Stats stats;
+    stats.targetFrameTime = targetFrameRate > 0.0 ? 1000.0 / targetFrameRate : 0.0;
+    stats.sleepOvershoot = overshootMean + 2.0 * std::sqrt(overshootVariance);
+    stats.missedFrames = missedFrames;
+    stats.frames = historyCount;
+    if (historyCount == 0) {
+        return stats;
+    }
+
+    for (size_t index = 0; index < historyCount; ++index) {
+        const FrameRecord& record = history[index];
+        stats.averageFrameTime += record.frameTime;
+        stats.averageLateness += record.lateness;
+        stats.averageSleep += record.sleep;
+        stats.averageSpin += record.spin;
+        stats.worstFrameTime = std::max(stats.worstFrameTime, record.frameTime);
+        stats.worstLateness = std::max(stats.worstLateness, record.lateness);
+    }
+    const double count = static_cast<double>(historyCount);
+    stats.averageFrameTime /= count;
+    stats.averageLateness /= count;
+    stats.averageSleep /= count;
+    stats.averageSpin /= count;
+
+    double variance = 0.0;
+    for (size_t index = 0; index < historyCount; ++index) {
+        const double difference = history[index].frameTime - stats.averageFrameTime;
+        variance += difference * difference;
+    }
+    stats.jitter = std::sqrt(variance / count);
+    return stats;
+}
+
+/**
+ * \brief Forgets the frame history and the missed frame count. The overshoot estimate is kept.
+ */
+void FramePacer::ResetStats() {
+    historyCount = 0;
+    historyNext = 0;
+    missedFrames = 0;
+}
+
+/**
+ * \brief Sleeps for about the time given and learns from how long it took.
+ * \param milliseconds The time to sleep.
+ */
+void FramePacer::SleepFor(double milliseconds) {
+    if (sleepFunction) {
+        sleepFunction(milliseconds);
+        return;
+    }
+    const Clock::time_point start = Clock::now();
+    double requested = milliseconds;
+#ifdef _WIN32
+    if (waitableTimer) {
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -static_cast<LONGLONG>(milliseconds * 10000.0);  // Relative, in 100 ns units
+        if (SetWaitableTimer(waitableTimer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(waitableTimer, INFINITE);
+        }
+    }
+    else {
+        // Whole milliseconds only; under one is left to the spin
+        const DWORD wholeMilliseconds = static_cast<DWORD>(milliseconds);
+        if (wholeMilliseconds == 0) {
+            std::this_thread::yield();
+            return;
+        }
+        requested = static_cast<double>(wholeMilliseconds);
+        ::Sleep(wholeMilliseconds);
+    }
+#else
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(milliseconds));
+#endif // _WIN32
+    LearnOvershoot(ToMilliseconds(Clock::now() - start) - requested);
+}
+
+/**
+ * \brief Adds how late one sleep woke up to the overshoot estimate.
+ * \param overshoot Milliseconds past the time asked for.
+ */
+void FramePacer::LearnOvershoot(double overshoot) {
+    const double difference = std::max(overshoot, 0.0) - overshootMean;
+    overshootMean += OvershootWeight * difference;
+    overshootVariance = (1.0 - OvershootWeight) * (overshootVariance + OvershootWeight * difference * difference);
+}
+
+/**
+ * \brief Lowers the overshoot estimate after a wait it kept from sleeping. Only sleeps teach the
+ *        estimate, so one wake-up delayed by a preemption could otherwise raise it past the frame
+ *        time and leave the pacer spinning from then on. Lowered, it lets a sleep through again
+ *        and learns from that whether the OS really is that late.
+ */
+void FramePacer::DecayOvershoot() {
+    overshootMean *= 1.0 - OvershootWeight;
+    overshootVariance *= (1.0 - OvershootWeight) * (1.0 - OvershootWeight);
+}
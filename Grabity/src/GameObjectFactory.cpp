@@ -21,6 +21,9 @@ Technology is prohibited.
 #include "ButtonComponent.h"
 #include "UIComponent.h"
 #include "ExplosionComponent.h"
+#include "ComponentRegistry.h"
+#include "DespawnManager.h"
+#include <chrono>
 
 /**
  * @brief Retrieves the singleton instance of the GameObjectFactory.
@@ -108,167 +111,21 @@ GameObject* GameObjectFactory::Create(const std::string& name, const std::string
  * @return A pointer to the newly created GameObject.
  */
 GameObject* GameObjectFactory::CreateFromLua(const std::string& luaFilePath, const std::string& tableName) {
+    // Parse the file once for this object unless the caller already holds a context for it,
+    // so every component Deserialize below shares one Lua state
+    std::unique_ptr<LuaSceneContext> localContext;
+    if (!LuaSceneContext::Find(luaFilePath)) {
+        localContext = std::make_unique<LuaSceneContext>(luaFilePath);
+    }
+    const LuaSceneContext* context = LuaSceneContext::Find(luaFilePath);
     LuaManager luaManager(luaFilePath);
 
     // Read the name and create the GameObject
     GameObject* object = Create(luaManager.LuaReadFromName<std::string>(tableName, "name"), luaManager.LuaReadFromName<std::string>(tableName, "tag"), luaManager.LuaReadFromName<std::string>(tableName, "layer"));
 
-
-    // Check and add TransformComponent if it exists
-    if (luaManager.TableExists(tableName, "Transform")) {
-        std::unique_ptr<TransformComponent> transformComponent = std::make_unique<TransformComponent>(object);
-        transformComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<TransformComponent>(TypeOfComponent::TRANSFORM, std::move(transformComponent));
-    }
-
-    // Check and add SpriteComponent if it exists
-    if (luaManager.TableExists(tableName, "Sprite")) {
-        std::unique_ptr<SpriteComponent> spriteComponent = std::make_unique<SpriteComponent>();
-        spriteComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<SpriteComponent>(TypeOfComponent::SPRITE, std::move(spriteComponent));
-    }
-
-    // Check and add RigidBodyComponent if it exists
-    if (luaManager.TableExists(tableName, "RigidBody")) {
-        std::unique_ptr<RigidBodyComponent> rigidBodyComponent = std::make_unique<RigidBodyComponent>();
-        rigidBodyComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<RigidBodyComponent>(TypeOfComponent::RIGIDBODY, std::move(rigidBodyComponent));
-    }
-
-    // Check and add RectColliderComponent if it exists
-    if (luaManager.TableExists(tableName, "Collider")) {
-        std::unique_ptr<RectColliderComponent> rectColliderComponent = std::make_unique<RectColliderComponent>(object, object->GetComponent<RigidBodyComponent>(TypeOfComponent::RIGIDBODY));
-        rectColliderComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<RectColliderComponent>(TypeOfComponent::RECTCOLLIDER, std::move(rectColliderComponent));
-    }
-
-    // Check and add AudioComponent if it exists
-    if (luaManager.TableExists(tableName, "Audio")) {
-        std::unique_ptr<AudioComponent> audioComponent = std::make_unique<AudioComponent>();
-        audioComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<AudioComponent>(TypeOfComponent::AUDIO, std::move(audioComponent));
-    }
-
-    if (luaManager.TableExists(tableName, "PlayerController")) {
-        std::unique_ptr<PlayerControllerComponent> playerControllerComponent = std::make_unique<PlayerControllerComponent>();
-        playerControllerComponent->Deserialize(luaFilePath, tableName);
-        
-        object->AddComponent<PlayerControllerComponent>(
-            TypeOfComponent::PLAYER,
-            playerControllerComponent->GetMoveSpd(),                
-            object->GetComponent<RigidBodyComponent>(TypeOfComponent::RIGIDBODY),
-            object->GetComponent<SpriteComponent>(TypeOfComponent::SPRITE)
-        );
-    }
-
-    // Check and add AIStateMachineComponent if it exists
-    if (luaManager.TableExists(tableName, "AIState")) {
-        std::unique_ptr<AIStateMachineComponent> aiStateComponent = std::make_unique<AIStateMachineComponent>(object);
-        aiStateComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<AIStateMachineComponent>(TypeOfComponent::AISTATE, std::move(aiStateComponent));
-    }
-
-    // Check and add TextComponent if it exists
-    if (luaManager.TableExists(tableName, "Text")) {
-        std::unique_ptr<TextComponent> textComponent = std::make_unique<TextComponent>();
-        textComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<TextComponent>(TypeOfComponent::TEXT, std::move(textComponent));
-    }
-
-    if (luaManager.TableExists(tableName, "TextUI")) {
-        std::unique_ptr<UITextComponent> textComponent = std::make_unique<UITextComponent>();
-        textComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<UITextComponent>(TypeOfComponent::TEXT_UI, std::move(textComponent));
-    }
-
-    if (luaManager.TableExists(tableName, "Spawner")) {
-        std::unique_ptr<SpawnerComponent> spawnerComponent = std::make_unique<SpawnerComponent>(object);
-        spawnerComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<SpawnerComponent>(TypeOfComponent::SPAWNER, std::move(spawnerComponent));
-
-    }
-    // Check and add CanvasComponent if it exists
-    if (luaManager.TableExists(tableName, "Canvas")) {
-        std::unique_ptr<CanvasComponent> canvasComponent = std::make_unique<CanvasComponent>();
-        canvasComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<CanvasComponent>(TypeOfComponent::CANVAS_UI, std::move(canvasComponent));
-    }
-
-    // Check and add SpriteUIComponent if it exists
-    if (luaManager.TableExists(tableName, "SpriteUI")) {
-        std::unique_ptr<UISpriteComponent> spriteUIComponent = std::make_unique<UISpriteComponent>();
-        spriteUIComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<UISpriteComponent>(TypeOfComponent::SPRITE_UI, std::move(spriteUIComponent));
-    }
-
-	// Check and add ButtonComponent if it exists
-	if (luaManager.TableExists(tableName, "ButtonComponent")) {
-		std::unique_ptr<ButtonComponent> buttonComponent = std::make_unique<ButtonComponent>();
-		buttonComponent->Deserialize(luaFilePath, tableName);
-		object->AddComponent<ButtonComponent>(TypeOfComponent::BUTTON, std::move(buttonComponent));
-	}
-
-	// Check and add UIComponent if it exists
-	if (luaManager.TableExists(tableName, "UIComponent")) {
-		std::unique_ptr<UIComponent> uiComponent = std::make_unique<UIComponent>();
-		uiComponent->Deserialize(luaFilePath, tableName);
-		object->AddComponent<UIComponent>(TypeOfComponent::UI, std::move(uiComponent));
-	}
-    if (luaManager.TableExists(tableName, "Health")) {
-        std::unique_ptr<HealthComponent> healthComponent = std::make_unique<HealthComponent>(object);
-        healthComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<HealthComponent>(TypeOfComponent::HEALTH, std::move(healthComponent));
-    }
-
-    if (luaManager.TableExists(tableName, "Explosion")) {
-        std::unique_ptr<ExplosionComponent> explosionComponent = std::make_unique<ExplosionComponent>(object);
-        explosionComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<ExplosionComponent>(TypeOfComponent::EXPLOSION, std::move(explosionComponent));
-    }
-
-    if (luaManager.TableExists(tableName, "PauseMenuButton")) {
-        std::unique_ptr<PauseMenuButton> PauseMenuButtonComponent = std::make_unique<PauseMenuButton>(object);
-        PauseMenuButtonComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<PauseMenuButton>(TypeOfComponent::PAUSEMENUBUTTON, std::move(PauseMenuButtonComponent));
-    }
-
-    if (luaManager.TableExists(tableName, "Animator")) {
-        std::unique_ptr<AnimatorComponent> animComponent = std::make_unique<AnimatorComponent>(object);
-        animComponent->Deserialize(luaFilePath, tableName);
-        object->AddComponent<AnimatorComponent>(TypeOfComponent::ANIMATOR, std::move(animComponent));
-    }
-    // Check and add SliderComponent if it exists
-    if (luaManager.TableExists(tableName, "SliderComponent")) {
-        std::unique_ptr<SliderComponent> slider = std::make_unique<SliderComponent>(object);
-        slider->Deserialize(luaFilePath, tableName);
-        object->AddComponent<SliderComponent>(TypeOfComponent::SLIDER, std::move(slider));
-    }
-    // Check and add SliderComponent if it exists
-    if (luaManager.TableExists(tableName, "ParticleSystem")) {
-        std::unique_ptr<ParticleSystem> slider = std::make_unique<ParticleSystem>(object);
-        slider->Deserialize(luaFilePath, tableName);
-        object->AddComponent<ParticleSystem>(TypeOfComponent::PARTICLE, std::move(slider));
-    }
-
-    if (luaManager.TableExists(tableName, "Splitting")) {
-        std::unique_ptr<SplittingComponent> splitting = std::make_unique<SplittingComponent>(object);
-        splitting->Deserialize(luaFilePath, tableName);
-        object->AddComponent<SplittingComponent>(TypeOfComponent::SPLITTING, std::move(splitting));
-
-    }
-
-    if (luaManager.TableExists(tableName, "Video"))
-    {
-        std::unique_ptr<VideoComponent> videoCom = std::make_unique<VideoComponent>(object);
-        videoCom->Deserialize(luaFilePath, tableName);
-        object->AddComponent<VideoComponent>(TypeOfComponent::VIDEO, std::move(videoCom));
-    }
-
-    if (luaManager.TableExists(tableName, "VfxFollowComponent"))
-    {
-        std::unique_ptr<VfxFollowComponent> vfxFollowScript = std::make_unique<VfxFollowComponent>(object);
-        vfxFollowScript->Deserialize(luaFilePath, tableName);
-        object->AddComponent<VfxFollowComponent>(TypeOfComponent::VFX_FOLLOW, std::move(vfxFollowScript));
+    // Only the component tables the object actually has are visited, in registration order
+    for (const ComponentRegistry::Entry* entry : ComponentRegistry::GetInstance().GetEntriesFor(context->GetTableNames(tableName))) {
+        entry->create(object, luaFilePath, tableName);
     }
     return object;
 }
@@ -277,29 +134,19 @@ GameObject* GameObjectFactory::CreateFromLua(const std::string& luaFilePath, con
 
 int GameObjectFactory::ResetObjectFromLua(const std::string& luaFilePath, const std::string& tableName, GameObject* gObject) {
     // Reset the GameObject with data from the Lua file
-    // For now only updates the transform and health components
-    LuaManager luaManager(luaFilePath);
+    // Only components that register a reset function are restored, see RegisterBuiltInComponents
+    std::unique_ptr<LuaSceneContext> localContext;
+    if (!LuaSceneContext::Find(luaFilePath)) {
+        localContext = std::make_unique<LuaSceneContext>(luaFilePath);
+    }
+    const LuaSceneContext* context = LuaSceneContext::Find(luaFilePath);
     try
     {
-        // Check and add TransformComponent if it exists
-        if (luaManager.TableExists(tableName, "Transform")) {
-            std::unique_ptr<TransformComponent> transformComponent = std::make_unique<TransformComponent>(gObject);
-            transformComponent->Deserialize(luaFilePath, tableName);
-            gObject->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM)->SetPosition(transformComponent->GetPosition());
-            gObject->GetComponent <TransformComponent>(TypeOfComponent::TRANSFORM)->SetScale(transformComponent->GetScale());
-            gObject->GetComponent <TransformComponent>(TypeOfComponent::TRANSFORM)->SetRotation(transformComponent->GetRotation());
-            gObject->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM)->SetLocalPosition(transformComponent->GetLocalPosition());
-            gObject->GetComponent <TransformComponent>(TypeOfComponent::TRANSFORM)->SetLocalScale(transformComponent->GetLocalScale());
-            gObject->GetComponent <TransformComponent>(TypeOfComponent::TRANSFORM)->SetLocalRotation(transformComponent->GetLocalRotation());
-        }
-        if (luaManager.TableExists(tableName, "Health")) {
-            std::unique_ptr<HealthComponent> healthComponent = std::make_unique<HealthComponent>();
-            healthComponent->Deserialize(luaFilePath, tableName);
-            gObject->GetComponent<HealthComponent>(TypeOfComponent::HEALTH)->SetHealth(healthComponent->GetHealth());
+        for (const ComponentRegistry::Entry* entry : ComponentRegistry::GetInstance().GetEntriesFor(context->GetTableNames(tableName))) {
+            if (entry->reset) {
+                entry->reset(gObject, luaFilePath, tableName);
+            }
         }
-        //if (luaManager.TableExists(tableName, "PauseMenuButton")) {
-        //    gObject->GetComponent<PauseMenuButton>(TypeOfComponent::PAUSEMENUBUTTON)->RestartGame();
-        //}
     }
     catch (const std::exception& e)
     {
@@ -343,6 +190,9 @@ void GameObjectFactory::Despawn(GameObject* object) {
         parentChildren.erase(std::remove(parentChildren.begin(), parentChildren.end(), object), parentChildren.end());
     }
 
+    // Drop any delayed despawn so its timer does not fire on a recycled object
+    DespawnManager::GetInstance().Cancel(object);
+
     // Proceed with despawning the object
     int objectId = object->GetId();
     object->ClearComponents();
@@ -383,11 +233,40 @@ void GameObjectFactory::QueueDespawn(GameObject* object) {
  */
 void GameObjectFactory::SerializeAllGameObjects(const std::string& newFileName)
 {        
-    //Create new luafile
-    LuaManager luaManager(newFileName);
-    luaManager.SaveNewScene(newFileName, "-- Lua Level file");
-    //luaManager.ClearLuaFile();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Collect every LuaWrite in memory and write the file once at the end
+    LuaSceneWriter sceneWriter(newFileName, "-- Lua Level file");
+    WriteAllGameObjects(newFileName);
 
+    if (sceneWriter.Commit()) {
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        ImGuiConsole::Cout("Saved %s (%zu objects, %zu bytes) in %f seconds", newFileName.c_str(), gameObjectMaps.size(), sceneWriter.GetBytesWritten(), elapsed.count());
+    }
+}
+/**
+ * @brief Serializes all GameObjects and writes only the objects that changed since the
+ *        last save of the file. Falls back to a full save when there is nothing to diff against.
+ * @param newFileName The name of the file to serialize to.
+ */
+void GameObjectFactory::SaveChangedGameObjects(const std::string& newFileName)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    LuaSceneWriter sceneWriter(newFileName, "-- Lua Level file");
+    WriteAllGameObjects(newFileName);
+
+    if (sceneWriter.CommitChanges()) {
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        ImGuiConsole::Cout("Saved %s (%zu of %zu objects, %zu bytes) in %f seconds", newFileName.c_str(), sceneWriter.GetTablesWritten(), gameObjectMaps.size(), sceneWriter.GetBytesWritten(), elapsed.count());
+    }
+}
+/**
+ * @brief Serializes all GameObjects through the LuaSceneWriter active for a path.
+ * @param newFileName The path the active LuaSceneWriter was opened with.
+ */
+void GameObjectFactory::WriteAllGameObjects(const std::string& newFileName)
+{
     //loop all gameobjects and call each serialize
     for (std::unordered_map<int, GameObject*>::iterator it = gameObjectMaps.begin(); it != gameObjectMaps.end(); ++it) {
         GameObject* object = it->second;
@@ -430,9 +309,8 @@ void GameObjectFactory::SerializeGameObjectHierarchy(const std::string& newFileN
 
     (void)children;
 
-    // Create or clear the Lua file
-    LuaManager luaManager(newFileName);
-    luaManager.SaveNewScene(newFileName, "-- Lua Level file");
+    // Collect every LuaWrite in memory and write the file once at the end
+    LuaSceneWriter sceneWriter(newFileName, "-- Lua Level file");
 
     int currentID = 0;
 
@@ -469,6 +347,7 @@ void GameObjectFactory::SerializeGameObjectHierarchy(const std::string& newFileN
 
     // Start serialization with the parent object
     serializeHierarchy(parentObject, currentID);
+    sceneWriter.Commit();
 }
 
 /**
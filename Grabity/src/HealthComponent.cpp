@@ -3,6 +3,7 @@
 \author: Jeremy Lim Ting Jie, jeremytingjie.lim, 2301370
 \co-author: Johny Yong Jun Siang, j.yong, 2301301
             Teng Shi Heng, shiheng.teng,  2301269
+            Goh Jun Jie, g.junjie, 2301293
 \brief: This file implements the `HealthComponent` class, which 
         manages the health of a game object in the game engine. 
 
@@ -27,6 +28,7 @@ Technology is prohibited.
 *******************************************************************!*/
 #include "HealthComponent.h"
 #include "EventSystem.h"
+#include "GameplayEvents.h"
 #include "DespawnManager.h"
 #include "FloatUpComponent.h"
 
@@ -118,8 +120,15 @@ void HealthComponent::TakeDamage(int damage) {
 
         if (damageSFX != -1)
         {
-            AudioManager::GetInstance().PlayAudio(damageSFX);
-            AudioManager::GetInstance().SetChannelVolume(damageSFX, audioControl);
+            // Positional, so hits far off screen fade out and give up their voice
+            auto* parentTransform = parent->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM);
+            if (parentTransform) {
+                AudioManager::GetInstance().PostPlayAt(damageSFX, parentTransform->GetPosition());
+            }
+            else {
+                AudioManager::GetInstance().PostPlay(damageSFX);
+            }
+            AudioManager::GetInstance().PostChannelVolume(damageSFX, audioControl);
         }
     }
 
@@ -178,10 +187,10 @@ void HealthComponent::SpawnDamagePopup(int damage)
     if (!parent) return;
     if (damage <= 0) return;
 
-    AudioManager::GetInstance().PlayAudio(4); //EnemyHit
-    AudioManager::GetInstance().SetChannelVolume(4, 0.5f);
-
     Vector2 collisionPoint = parent->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM)->GetLocalPosition();
+
+    AudioManager::GetInstance().PostPlayAt(4, collisionPoint); //EnemyHit
+    AudioManager::GetInstance().PostChannelVolume(4, 0.5f);
     GameObjectFactory& factory = GameObjectFactory::GetInstance();
 
     GameObject* damageText = factory.CreateFromLua("Assets/Lua/Prefabs/GameDmgIndicatorText.lua", "GameDmgIndicatorText_0");
@@ -242,7 +251,11 @@ void HealthComponent::Update() {
 
     if (health <= 0 && !isDespawned) {
         isDespawned = true;  // Ensure despawn happens only once
-		EventSystem::GetInstance().AddDeathEvent(*GetParentGameObject());
+        // Missions hear about it once every component has updated
+        EnemyType enemyType;
+        if (EventSystem::GetEnemyType(GetParentGameObject()->GetName(), enemyType)) {
+            EventBus::GetInstance().Post(EnemyKilledEvent{ enemyType, GetParentGameObject()->GetId() });
+        }
 
         if (onDeathCallback) {
             onDeathCallback();  // Trigger death callback first
@@ -329,8 +342,14 @@ void HealthComponent::TriggerDespawn() {
 
         if (deathSFX != -1)
         {
-            AudioManager::GetInstance().PlayAudio(deathSFX);
-            AudioManager::GetInstance().SetChannelVolume(deathSFX, sfxControl);
+            auto* parentTransform = parent->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM);
+            if (parentTransform) {
+                AudioManager::GetInstance().PostPlayAt(deathSFX, parentTransform->GetPosition());
+            }
+            else {
+                AudioManager::GetInstance().PostPlay(deathSFX);
+            }
+            AudioManager::GetInstance().PostChannelVolume(deathSFX, sfxControl);
         }
     }
 }
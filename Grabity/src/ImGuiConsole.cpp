@@ -12,6 +12,7 @@ Technology is prohibited.
 *******************************************************************!*/
 
 #include "ImGuiConsole.h"
+#include <mutex>
 
 
 
@@ -26,6 +27,7 @@ namespace ImGuiConsole {
     ImGuiTextFilter Filter;
     ImVector<int> LineOffsets;
     bool ScrollToBottom = true;
+    std::mutex BufMutex;    // Startup tasks and preloads log from worker threads
 
 /*!****************************************************************
 \func Cout
@@ -36,6 +38,7 @@ namespace ImGuiConsole {
 #ifdef _LOGGING
         va_list args;
         va_start(args, fmt);
+        std::lock_guard<std::mutex> lock(BufMutex);
 		Buf.appendf("[%02d:%02d] ", (int)ImGui::GetTime() / 60, (int)ImGui::GetTime() % 60);
         Buf.appendfv(fmt, args);
         Buf.append("\n");
@@ -53,6 +56,7 @@ namespace ImGuiConsole {
 	Clears the console in ImGui.
 *******************************************************************/
     void Clear() {
+        std::lock_guard<std::mutex> lock(BufMutex);
         Buf.clear();
         LineOffsets.clear();
     }
@@ -84,6 +88,7 @@ namespace ImGuiConsole {
         if (copy_to_clipboard)
             ImGui::LogToClipboard();
 
+        std::unique_lock<std::mutex> lock(BufMutex);
         if (Filter.IsActive()) {
             const char* buf_begin = Buf.begin();
             const char* line = buf_begin;
@@ -97,6 +102,7 @@ namespace ImGuiConsole {
         else {
             ImGui::TextUnformatted(Buf.begin());
         }
+        lock.unlock();
 
         if (ScrollToBottom)
             ImGui::SetScrollHereY(1.0f);
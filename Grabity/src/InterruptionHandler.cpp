@@ -1,11 +1,14 @@
 /*!****************************************************************
 \file: InterruptionHandler.cpp
 \author: Jeremy Lim Ting Jie, jeremytingjie.lim, 2301370
+\co-author: Goh Jun Jie, g.junjie, 2301293
 \brief: This file implements the `InterruptionHandler` class, which 
         manages interruptions to the game caused by window focus loss, 
         minimization, or restoration. It handles pausing and resuming 
         the game state, audio playback, and input handling to ensure 
         a seamless user experience when the game window state changes. 
+        In the background the loop is throttled through the FramePacer
+        and the game and audio follow the background policy.
 
 Copyright (C) 2024 DigiPen Institute of Technology.
 Reproduction or disclosure of this file or its contents
@@ -13,6 +16,8 @@ without the prior written consent of DigiPen Institute of
 Technology is prohibited.
 *******************************************************************!*/
 #include "InterruptionHandler.h"
+#include "FramePacer.h"
+#include "LuaConfig.h"
 
 #ifdef _IMGUI
 #include <iostream>
@@ -22,6 +27,22 @@ Technology is prohibited.
 static std::unordered_map<int, bool> keyStates;  // Stores key states (pressed/released)
 static bool isInputEnabled = true;              // Tracks if input is currently enabled
 
+static InterruptionHandler::BackgroundPolicy backgroundPolicy;
+static InterruptionHandler::WindowState windowState = InterruptionHandler::WindowState::FOCUSED;
+static double foregroundFrameRate = 0.0;        // The pacer's target before the window left the foreground
+static bool isSimulationPausedByFocus = false;  // Unpaused on return only if the background paused it
+static bool isAudioMuted = false;
+static float mutedMasterVolume = 1.0f;          // Master volume to restore after muting
+
+/**
+ * @brief Sleeps while throttled, waking early for window events such as getting focus back.
+ *
+ * @param milliseconds The longest time to sleep.
+ */
+static void WaitForWindowEvents(double milliseconds) {
+    glfwWaitEventsTimeout(milliseconds / 1000.0);
+}
+
 /**
  * @brief Handles the change in window focus state.
  *
@@ -32,57 +53,43 @@ static bool isInputEnabled = true;              // Tracks if input is currently
  * @param focused The focus state of the window (1 for focused, 0 for unfocused).
  */
 void InterruptionHandler::FocusCallback(GLFWwindow* window, int focused) {
-    UNUSED(window);
     if (focused) {
-        Engine& engine = Engine::GetInstance();
 #ifdef _LOGGING
         ImGuiConsole::Cout("Window regained focus.");
 #endif // _LOGGING
-        engine.isPaused = false;
-        if (isAudioPaused) {
-            ResumeAudio();
-            isAudioPaused = false;
-        }
-        RestoreInputState();
+        ChangeWindowState(WindowState::FOCUSED);
     }
     else {
-        Engine& engine = Engine::GetInstance();
 #ifdef _LOGGING
         ImGuiConsole::Cout("Window lost focus.");
 #endif // _LOGGING
-        engine.isPaused = true;
-        if (!isAudioPaused) {
-            PauseAudio();
-            isAudioPaused = true;
+        if (windowState == WindowState::FOCUSED) {
+            ChangeWindowState(WindowState::UNFOCUSED);
         }
-        ProcessInputOnFocusLoss();
 
         //minimize window
-        glfwIconifyWindow(window);
+        if (backgroundPolicy.minimiseOnFocusLoss) {
+            glfwIconifyWindow(window);
+        }
     }
 }
 
 /**
  * @brief Handles changes in window iconification (minimization/restoration) state.
  *
- * This method is called when the window is minimized or restored. It pauses the audio
- * when the window is minimized and restores it when the window is restored.
+ * This method is called when the window is minimized or restored. Minimizing throttles the
+ * loop further and stops drawing; restoring returns to the foreground if the window has focus.
  *
  * @param window The GLFW window that triggered the callback.
  * @param iconified The iconification state of the window (1 for minimized, 0 for restored).
  */
 void InterruptionHandler::IconifyCallback(GLFWwindow* window, int iconified) {
-    UNUSED(window);
     if (iconified) {
 #ifdef _LOGGING
         ImGuiConsole::Cout("Window minimized.");
 #endif // _LOGGING
         isWindowIconified = true;
-        if (!isAudioPaused) {
-            PauseAudio();
-            isAudioPaused = true;
-        }
-        ProcessInputOnFocusLoss();
+        ChangeWindowState(WindowState::MINIMISED);
     }
     else {
 #ifdef _LOGGING
@@ -90,13 +97,71 @@ void InterruptionHandler::IconifyCallback(GLFWwindow* window, int iconified) {
 #endif // _LOGGING
         if (isWindowIconified) {
             isWindowIconified = false;
-            if (isAudioPaused) {
-                ResumeAudio();
-                isAudioPaused = false;
-            }
-            RestoreInputState();
+            ChangeWindowState(glfwGetWindowAttrib(window, GLFW_FOCUSED) ? WindowState::FOCUSED : WindowState::UNFOCUSED);
+        }
+    }
+}
+
+/**
+ * @brief Moves the window to a new state, throttling the loop and applying the background policy
+ *        when it leaves the foreground and undoing both when it returns.
+ *
+ * @param state The new state.
+ */
+void InterruptionHandler::ChangeWindowState(WindowState state) {
+    if (state == windowState) {
+        return;
+    }
+    const bool wasFocused = windowState == WindowState::FOCUSED;
+    windowState = state;
+    FramePacer& pacer = FramePacer::GetInstance();
+
+    if (state == WindowState::FOCUSED) {
+        Engine& engine = Engine::GetInstance();
+        if (isSimulationPausedByFocus) {
+            engine.isPaused = false;
+            isSimulationPausedByFocus = false;
+        }
+        if (isAudioPaused) {
+            ResumeAudio();
+            isAudioPaused = false;
+        }
+        if (isAudioMuted) {
+            AudioManager::GetInstance().SetMasterVolume(mutedMasterVolume);
+            isAudioMuted = false;
+        }
+        RestoreInputState();
+
+        // Back to full rate, and out of the throttled sleep this callback may be running in
+        pacer.SetSleepFunction(nullptr);
+        pacer.SetTargetFrameRate(foregroundFrameRate);
+        pacer.Interrupt();
+        return;
+    }
+
+    if (wasFocused) {
+        foregroundFrameRate = pacer.GetTargetFrameRate();
+
+        Engine& engine = Engine::GetInstance();
+        if (backgroundPolicy.pauseSimulation && !engine.isPaused) {
+            engine.isPaused = true;
+            isSimulationPausedByFocus = true;
         }
+        if (backgroundPolicy.audio == BackgroundPolicy::Audio::PAUSE && !isAudioPaused) {
+            PauseAudio();
+            isAudioPaused = true;
+        }
+        else if (backgroundPolicy.audio == BackgroundPolicy::Audio::MUTE && !isAudioMuted) {
+            mutedMasterVolume = AudioManager::GetInstance().GetMasterVolume();
+            AudioManager::GetInstance().SetMasterVolume(0.0f);
+            isAudioMuted = true;
+        }
+        ProcessInputOnFocusLoss();
     }
+
+    pacer.SetSleepFunction(WaitForWindowEvents);
+    pacer.SetTargetFrameRate(state == WindowState::MINIMISED
+        ? backgroundPolicy.minimisedFrameRate : backgroundPolicy.unfocusedFrameRate);
 }
 
 /**
@@ -185,7 +250,64 @@ void InterruptionHandler::RestoreInputState() {
  * @param window The GLFW window for which the callbacks are being set.
  */
 void InterruptionHandler::Init(GLFWwindow* window) {
+    LoadBackgroundPolicy();
+    foregroundFrameRate = FramePacer::GetInstance().GetTargetFrameRate();
+
     // Set GLFW callbacks
     glfwSetWindowFocusCallback(window, FocusCallback);
     glfwSetWindowIconifyCallback(window, IconifyCallback);
 }
+
+/**
+ * @brief Replaces the background policy. Takes effect the next time the window leaves the foreground.
+ *
+ * @param policy The policy.
+ */
+void InterruptionHandler::SetBackgroundPolicy(const BackgroundPolicy& policy) {
+    backgroundPolicy = policy;
+}
+
+/**
+ * @brief Retrieves the background policy.
+ *
+ * @return The policy.
+ */
+const InterruptionHandler::BackgroundPolicy& InterruptionHandler::GetBackgroundPolicy() {
+    return backgroundPolicy;
+}
+
+/**
+ * @brief Retrieves whether the window is focused, unfocused or minimised.
+ *
+ * @return The window's state.
+ */
+InterruptionHandler::WindowState InterruptionHandler::GetWindowState() {
+    return windowState;
+}
+
+/**
+ * @brief Checks if the frame should be drawn. Nothing is drawn while minimised.
+ *
+ * @return False while the window is minimised.
+ */
+bool InterruptionHandler::ShouldRender() {
+    return windowState != WindowState::MINIMISED;
+}
+
+/**
+ * @brief Reads the background policy from config.lua, keeping the defaults for tables that are not there.
+ */
+void InterruptionHandler::LoadBackgroundPolicy() {
+    LuaManager luaManager("Assets/Lua/config.lua");
+    if (luaManager.TableExists("Background", "Unfocused")) {
+        backgroundPolicy.unfocusedFrameRate = luaManager.LuaRead<int>("Background", { "Unfocused", "Framerate" });
+        backgroundPolicy.pauseSimulation = luaManager.LuaRead<std::string>("Background", { "Unfocused", "Simulation" }) != "Run";
+        const std::string audio = luaManager.LuaRead<std::string>("Background", { "Unfocused", "Audio" });
+        backgroundPolicy.audio = audio == "Keep" ? BackgroundPolicy::Audio::KEEP
+            : audio == "Mute" ? BackgroundPolicy::Audio::MUTE : BackgroundPolicy::Audio::PAUSE;
+        backgroundPolicy.minimiseOnFocusLoss = luaManager.LuaRead<bool>("Background", { "Unfocused", "Minimise" });
+    }
+    if (luaManager.TableExists("Background", "Minimised")) {
+        backgroundPolicy.minimisedFrameRate = luaManager.LuaRead<int>("Background", { "Minimised", "Framerate" });
+    }
+}
@@ -0,0 +1,410 @@
+/*!****************************************************************
+\file: JobSystem.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the JobSystem. Workers pop their own deque from the
+        back, so the job they queued last, whose data is still in
+        their cache, runs first; thieves take the oldest job from the
+        front. Idle workers sleep on a condition variable and are
+        only woken when a job is queued while one of them sleeps.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "JobSystem.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+    thread_local int workerIndex = -1;  // Index of the worker running on this thread, -1 on other threads
+}
+
+struct JobSystem::Job {
+    std::function<void()> work;
+    Counter* counter = nullptr;
+    Affinity affinity = Affinity::ANY_THREAD;
+    const char* name = nullptr;
+};
+
+/**
+ * \brief Retrieves the job system instance.
+ * \return Reference to the job system.
+ */
+JobSystem& JobSystem::GetInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+/**
+ * \brief Starts the worker threads. The calling thread becomes the main thread.
+ * \param workerCount Worker threads to start. 0 uses one less than the hardware threads, at least one.
+ */
+void JobSystem::Init(unsigned int workerCount) {
+    if (!workers.empty()) {
+        return;
+    }
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    mainThread = std::this_thread::get_id();
+    stopping = false;
+
+    queues.reserve(workerCount);
+    for (unsigned int index = 0; index < workerCount; ++index) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers.reserve(workerCount);
+    for (unsigned int index = 0; index < workerCount; ++index) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, index);
+    }
+#ifdef _LOGGING
+    ImGuiConsole::Cout("Job system: %u worker threads", workerCount);
+#endif // _LOGGING
+}
+
+/**
+ * \brief Stops the worker threads after the jobs they are running. Jobs still queued are dropped.
+ */
+void JobSystem::Shutdown() {
+    if (workers.empty()) {
+        return;
+    }
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    for (std::unique_ptr<WorkerQueue>& queue : queues) {
+        for (Job* job : queue->jobs) {
+            delete job;
+        }
+    }
+    queues.clear();
+    queuedJobs = 0;
+    {
+        std::lock_guard<std::mutex> lock(mainMutex);
+        for (Job* job : mainJobs) {
+            delete job;
+        }
+        mainJobs.clear();
+    }
+}
+
+/**
+ * \brief Queues a job. Without workers, jobs that may run anywhere run straight away.
+ * \param job The work to do.
+ * \param counter Counted up now and down when the job finishes, may be nullptr.
+ * \param affinity Where the job may run.
+ * \param name Shown by the profiler, must outlive the job.
+ */
+void JobSystem::Run(std::function<void()> job, Counter* counter, Affinity affinity, const char* name) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    Schedule(new Job{ std::move(job), counter, affinity, name });
+}
+
+/**
+ * \brief Queues a job once every job of another counter has finished.
+ * \param dependency The counter to wait for. It must not be counted up again until the job is queued.
+ * \param job The work to do.
+ * \param counter Counted up now and down when the job finishes, may be nullptr.
+ * \param affinity Where the job may run.
+ * \param name Shown by the profiler, must outlive the job.
+ */
+void JobSystem::RunAfter(Counter& dependency, std::function<void()> job, Counter* counter, Affinity affinity, const char* name) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    Job* held = new Job{ std::move(job), counter, affinity, name };
+    {
+        // The last job of the dependency takes the waiting list under the same lock, so the job is never missed
+        std::lock_guard<std::mutex> lock(dependency.waitingMutex);
+        if (dependency.pending.load(std::memory_order_acquire) != 0) {
+            dependency.waiting.push_back(held);
+            return;
+        }
+    }
+    Schedule(held);
+}
+
+/**
+ * \brief Runs other jobs until every job of a counter has finished.
+ * \param counter The counter.
+ */
+void JobSystem::Wait(Counter& counter) {
+    const bool onMainThread = IsMainThread();
+    while (!counter.IsDone()) {
+        Job* job = onMainThread ? TakeMainThreadJob() : nullptr;
+        if (!job) {
+            job = TakeJob();
+        }
+        if (job) {
+            Execute(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    // The thread that finished the last job may still hold the lock; the counter can go once it lets go
+    std::lock_guard<std::mutex> lock(counter.waitingMutex);
+}
+
+/**
+ * \brief Splits an index range into chunks, runs them in parallel and waits for all of them.
+ *        The calling thread runs chunks too.
+ * \param begin The first index.
+ * \param end One past the last index.
+ * \param grain The most indices in one chunk. 0 picks a few chunks per thread.
+ * \param body Called with the first and one past the last index of each chunk.
+ * \param name Shown by the profiler.
+ */
+void JobSystem::ParallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body, const char* name) {
+    if (end <= begin) {
+        return;
+    }
+    const size_t count = end - begin;
+    if (grain == 0) {
+        // A few chunks per thread, so a thread that finishes early can steal from a slow one
+        const size_t chunks = (workers.size() + 1) * 4;
+        grain = std::max<size_t>(1, (count + chunks - 1) / chunks);
+    }
+    if (count <= grain) {
+        body(begin, end);
+        return;
+    }
+    if (workers.empty()) {
+        // Same chunks as with workers, so bodies can rely on the grain
+        for (size_t first = begin; first < end; first += grain) {
+            body(first, std::min(end, first + grain));
+        }
+        return;
+    }
+
+    Counter counter;
+    for (size_t first = begin; first < end; first += grain) {
+        const size_t last = std::min(end, first + grain);
+        Run([&body, first, last]() { body(first, last); }, &counter, Affinity::ANY_THREAD, name);
+    }
+    Wait(counter);
+}
+
+/**
+ * \brief Runs the jobs queued for the main thread. Called once per frame from the main thread.
+ * \return The number of jobs run.
+ */
+int JobSystem::RunMainThreadJobs() {
+    int count = 0;
+    while (Job* job = TakeMainThreadJob()) {
+        Execute(job);
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * \brief Retrieves which thread the caller is, numbered as in JobTiming.
+ * \return 0 on the main thread, 1 and up on workers, -1 on any other thread.
+ */
+int JobSystem::GetThreadIndex() const {
+    if (IsMainThread()) {
+        return 0;
+    }
+    return workerIndex >= 0 ? workerIndex + 1 : -1;
+}
+
+/**
+ * \brief Sets the function told about every job as it finishes, or clears it. Only set it while
+ *        no jobs are running; the hook is called from every thread.
+ * \param hook The profiler hook, or nullptr.
+ */
+void JobSystem::SetProfilerHook(std::function<void(const JobTiming&)> hook) {
+    profilerHook = std::move(hook);
+}
+
+/**
+ * \brief Retrieves the counters.
+ * \return A copy of the counters.
+ */
+JobSystem::Stats JobSystem::GetStats() const {
+    Stats stats;
+    stats.jobs = jobsRun.load();
+    stats.mainThreadJobs = mainThreadJobsRun.load();
+    stats.steals = steals.load();
+    return stats;
+}
+
+/**
+ * \brief Clears the counters.
+ */
+void JobSystem::ResetStats() {
+    jobsRun = 0;
+    mainThreadJobsRun = 0;
+    steals = 0;
+}
+
+/**
+ * \brief Queues a job that is ready to run.
+ * \param job The job.
+ */
+void JobSystem::Schedule(Job* job) {
+    if (job->affinity == Affinity::MAIN_THREAD) {
+        if (workers.empty() && IsMainThread()) {
+            Execute(job);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mainMutex);
+        mainJobs.push_back(job);
+        return;
+    }
+    if (workers.empty()) {
+        Execute(job);
+        return;
+    }
+
+    // Workers keep what they queue; other threads spread their jobs over the workers
+    const size_t index = workerIndex >= 0 ? static_cast<size_t>(workerIndex) : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->jobs.push_back(job);
+    }
+    queuedJobs.fetch_add(1);
+    if (sleepingWorkers.load() > 0) {
+        // Taking the lock orders this against a worker that is about to sleep, so the wake-up is not lost
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleepCondition.notify_one();
+    }
+}
+
+/**
+ * \brief Runs a job, counts its counter down and releases the jobs waiting on it.
+ * \param job The job, deleted afterwards.
+ */
+void JobSystem::Execute(Job* job) {
+    JobTiming timing;
+    if (profilerHook) {
+        timing.name = job->name;
+        timing.thread = GetThreadIndex();
+        timing.start = std::chrono::steady_clock::now();
+    }
+    try {
+        if (job->work) {
+            job->work();
+        }
+    }
+    catch (const std::exception& e) {
+        ImGuiConsole::Cout("Job %s failed: %s", job->name ? job->name : "", e.what());
+    }
+    if (profilerHook) {
+        timing.end = std::chrono::steady_clock::now();
+        profilerHook(timing);
+    }
+
+    ++jobsRun;
+    if (job->affinity == Affinity::MAIN_THREAD) {
+        ++mainThreadJobsRun;
+    }
+    Counter* counter = job->counter;
+    delete job;
+    if (!counter) {
+        return;
+    }
+
+    std::vector<Job*> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->waitingMutex);
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            released.swap(counter->waiting);
+        }
+    }
+    for (Job* ready : released) {
+        Schedule(ready);
+    }
+}
+
+/**
+ * \brief Takes a job for the calling thread: its own first, then stolen from the others.
+ * \return The job, or nullptr if every deque is empty.
+ */
+JobSystem::Job* JobSystem::TakeJob() {
+    const size_t count = queues.size();
+    if (count == 0 || queuedJobs.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    if (workerIndex >= 0) {
+        WorkerQueue& own = *queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            Job* job = own.jobs.back();
+            own.jobs.pop_back();
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Start after this thread's own deque so thieves spread over the victims
+    const size_t start = workerIndex >= 0 ? static_cast<size_t>(workerIndex) + 1 : 0;
+    for (size_t offset = 0; offset < count; ++offset) {
+        const size_t victim = (start + offset) % count;
+        if (static_cast<int>(victim) == workerIndex) {
+            continue;
+        }
+        WorkerQueue& queue = *queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            Job* job = queue.jobs.front();
+            queue.jobs.pop_front();
+            queuedJobs.fetch_sub(1);
+            ++steals;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \brief Takes one job queued for the main thread.
+ * \return The job, or nullptr if there is none.
+ */
+JobSystem::Job* JobSystem::TakeMainThreadJob() {
+    std::lock_guard<std::mutex> lock(mainMutex);
+    if (mainJobs.empty()) {
+        return nullptr;
+    }
+    Job* job = mainJobs.front();
+    mainJobs.pop_front();
+    return job;
+}
+
+/**
+ * \brief The loop each worker thread runs until Shutdown.
+ * \param index The worker's index.
+ */
+void JobSystem::WorkerLoop(unsigned int index) {
+    workerIndex = static_cast<int>(index);
+    while (!stopping.load()) {
+        if (Job* job = TakeJob()) {
+            Execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepingWorkers.fetch_add(1);
+        sleepCondition.wait(lock, [this]() { return queuedJobs.load() > 0 || stopping.load(); });
+        sleepingWorkers.fetch_sub(1);
+    }
+    workerIndex = -1;
+}
@@ -0,0 +1,280 @@
+/*!****************************************************************
+\file: LuaBytecodeCache.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: On-disk cache of precompiled Lua chunks. Each Lua file can have
+        a ".luac" file next to it holding the output of lua_dump and a
+        hash of the source it was compiled from. Loading a file uses the
+        bytecode while the hash matches and compiles the source (and
+        refreshes the cache) otherwise.
+
+        The cook step compiles every Lua file under a directory ahead of
+        time so that the first run of a build does not pay for parsing.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "LuaBytecodeCache.h"
+#include "VirtualFileSystem.h"
+#include "ImGuiConsole.h"
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <thread>
+
+thread_local LuaBytecodeCache::LoadStats LuaBytecodeCache::lastLoadStats;
+
+namespace {
+
+    /**
+     * \brief Reads a whole file into a string, from the asset pack if it is mounted.
+     * \param filePath The path of the file.
+     * \param content Receives the file bytes.
+     * \return True if the file was read, false otherwise.
+     */
+    bool ReadSource(const std::string& filePath, std::string& content) {
+        VirtualFile file = VirtualFileSystem::GetInstance().Open(filePath);
+        if (!file) {
+            return false;
+        }
+        content = file.ToString();
+        return true;
+    }
+
+    /**
+     * \brief lua_Writer that appends the dumped chunk to a string.
+     * \param data The next block of bytecode.
+     * \param size The size of the block.
+     * \param userData The std::string to append to.
+     * \return 0, appending cannot fail.
+     */
+    int AppendBytecode(lua_State*, const void* data, size_t size, void* userData) {
+        static_cast<std::string*>(userData)->append(static_cast<const char*>(data), size);
+        return 0;
+    }
+}
+
+/**
+ * \brief Builds the path of the bytecode file that belongs to a Lua file.
+ * \param luaFilePath The path to the Lua file.
+ * \return The Lua path with its extension replaced by ".luac".
+ */
+std::string LuaBytecodeCache::GetBytecodePath(const std::string& luaFilePath) {
+    std::filesystem::path path(luaFilePath);
+    path.replace_extension(Extension);
+    return path.string();
+}
+
+/**
+ * \brief Loads a Lua file into a state, from bytecode if the cache matches the source,
+ *        and executes it. A stale or missing cache is rewritten from the source.
+ * \param lua The state to execute the file in.
+ * \param luaFilePath The path to the Lua file.
+ * \return True if the file was loaded and executed without errors, false otherwise.
+ */
+bool LuaBytecodeCache::RunFile(sol::state& lua, const std::string& luaFilePath) {
+    lastLoadStats = LoadStats();
+    lastLoadStats.filePath = luaFilePath;
+
+    std::string source;
+    const bool hasSource = ReadSource(luaFilePath, source);
+    const uint64_t sourceHash = hasSource ? HashSource(source.data(), source.size()) : 0;
+
+    sol::protected_function chunk;
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        VirtualFile cache = VirtualFileSystem::GetInstance().Open(GetBytecodePath(luaFilePath));
+        if (cache && cache.GetSize() >= sizeof(Header)) {
+            const Header* header = reinterpret_cast<const Header*>(cache.GetData());
+            bool matches = header->magic == Magic && header->version == Version && header->luaVersion == LUA_VERSION_NUM
+                && header->bytecodeSize <= cache.GetSize() - sizeof(Header);
+            // Shipping builds may only contain the bytecode
+            if (hasSource) {
+                matches = matches && header->sourceHash == sourceHash && header->sourceSize == source.size();
+            }
+
+            if (matches) {
+                // lua_load copies everything it needs, so the file can be closed right after
+                sol::load_result loaded = lua.load_buffer(reinterpret_cast<const char*>(cache.GetData() + sizeof(Header)),
+                    header->bytecodeSize, "@" + luaFilePath, sol::load_mode::binary);
+                if (loaded.valid()) {
+                    chunk = loaded.get<sol::protected_function>();
+                    lastLoadStats.fromBytecode = true;
+                    lastLoadStats.compileSeconds = static_cast<double>(header->compileMicroseconds) / 1000000.0;
+                }
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    lastLoadStats.loadSeconds = elapsed.count();
+
+    if (!lastLoadStats.fromBytecode) {
+        if (!hasSource) {
+#ifdef _LOGGING
+            ImGuiConsole::Cout("Lua error: could not read %s", luaFilePath.c_str());
+#endif // _LOGGING
+            return false;
+        }
+
+        double compileSeconds = 0.0;
+        if (!Compile(lua, luaFilePath, source, chunk, compileSeconds)) {
+            return false;
+        }
+        lastLoadStats.loadSeconds = compileSeconds;
+        lastLoadStats.compileSeconds = compileSeconds;
+        // The pack is read-only, a packed file is not given a loose cache next to it
+        if (!VirtualFileSystem::GetInstance().IsPacked(luaFilePath)) {
+            Store(luaFilePath, source, chunk, compileSeconds);
+        }
+    }
+
+    sol::protected_function_result result = chunk();
+    if (!result.valid()) {
+        sol::error error = result;
+#ifdef _LOGGING
+        ImGuiConsole::Cout("Lua error: %s", error.what());
+#else
+        (void)error;
+#endif // _LOGGING
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Compiles a Lua file and writes its bytecode file, without executing it.
+ * \param luaFilePath The path to the Lua file.
+ * \return True if the bytecode file was written, false otherwise.
+ */
+bool LuaBytecodeCache::Cook(const std::string& luaFilePath) {
+    std::string source;
+    if (!ReadSource(luaFilePath, source)) {
+        return false;
+    }
+
+    sol::state lua;
+    sol::protected_function chunk;
+    double compileSeconds = 0.0;
+    if (!Compile(lua, luaFilePath, source, chunk, compileSeconds)) {
+        return false;
+    }
+    return Store(luaFilePath, source, chunk, compileSeconds);
+}
+
+/**
+ * \brief Compiles every Lua file in a directory and its sub-directories.
+ * \param directory The directory to cook, e.g. "Assets/Lua".
+ * \return The number of files compiled.
+ */
+int LuaBytecodeCache::CookDirectory(const std::string& directory) {
+    int cookedCount = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".lua") {
+            if (Cook(entry.path().string())) {
+                ++cookedCount;
+            }
+        }
+    }
+    return cookedCount;
+}
+
+/**
+ * \brief Hashes the bytes of a Lua source file.
+ * \param data The source bytes.
+ * \param size The number of bytes.
+ * \return The 64-bit FNV-1a hash.
+ */
+uint64_t LuaBytecodeCache::HashSource(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * \brief Compiles source text without executing it.
+ * \param lua The state to compile in.
+ * \param luaFilePath The path to the Lua file, used for the chunk name.
+ * \param source The source text.
+ * \param chunk Receives the compiled function.
+ * \param compileSeconds Receives the time the compilation took.
+ * \return True if the source compiled, false otherwise.
+ */
+bool LuaBytecodeCache::Compile(sol::state& lua, const std::string& luaFilePath, const std::string& source, sol::protected_function& chunk, double& compileSeconds) {
+    auto start = std::chrono::high_resolution_clock::now();
+    sol::load_result loaded = lua.load_buffer(source.data(), source.size(), "@" + luaFilePath, sol::load_mode::text);
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    compileSeconds = elapsed.count();
+
+    if (!loaded.valid()) {
+        sol::error error = loaded;
+#ifdef _LOGGING
+        ImGuiConsole::Cout("Lua error: %s", error.what());
+#else
+        (void)error;
+#endif // _LOGGING
+        return false;
+    }
+    chunk = loaded.get<sol::protected_function>();
+    return true;
+}
+
+/**
+ * \brief Dumps a compiled chunk and replaces the bytecode file of a Lua file with it.
+ * \param luaFilePath The path to the Lua file.
+ * \param source The source text the chunk was compiled from.
+ * \param chunk The compiled function.
+ * \param compileSeconds The time the compilation took, kept to report the time saved.
+ * \return True if the bytecode file was written, false otherwise.
+ */
+bool LuaBytecodeCache::Store(const std::string& luaFilePath, const std::string& source, const sol::protected_function& chunk, double compileSeconds) {
+    std::string bytecode;
+    // Debug info is kept so errors still report file and line
+    if (chunk.dump(static_cast<lua_Writer>(&AppendBytecode), &bytecode, false) != 0 || bytecode.empty()) {
+        return false;
+    }
+
+    Header header{};
+    header.magic = Magic;
+    header.version = Version;
+    header.luaVersion = LUA_VERSION_NUM;
+    header.bytecodeSize = static_cast<uint32_t>(bytecode.size());
+    header.sourceHash = HashSource(source.data(), source.size());
+    header.sourceSize = source.size();
+    header.compileMicroseconds = static_cast<uint64_t>(compileSeconds * 1000000.0);
+
+    // Startup graph workers and the ScenePreloader can refresh the same file, so each thread writes its own temp file
+    const std::string bytecodePath = GetBytecodePath(luaFilePath);
+    const std::string tempPath = bytecodePath + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            return false;
+        }
+        outFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        outFile.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+        if (!outFile.good()) {
+            outFile.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, bytecodePath, error);
+    if (error) {
+        // Some platforms refuse to rename over an existing file
+        std::filesystem::remove(bytecodePath, error);
+        std::filesystem::rename(tempPath, bytecodePath, error);
+    }
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
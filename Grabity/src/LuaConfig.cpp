@@ -11,7 +11,12 @@ Technology is prohibited.
 *******************************************************************!*/
 
 #include "LuaConfig.h"
-#include "GameObjectFactory.h"
+#include "LuaBytecodeCache.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <filesystem>
+#include <charconv>
+#include <cmath>
 
 //namespace LuaUtilities {
 
@@ -104,17 +109,599 @@ Technology is prohibited.
 
 
 
+thread_local LuaSceneContext* LuaSceneContext::active = nullptr;
+thread_local LuaSceneWriter* LuaSceneWriter::active = nullptr;
+std::unordered_map<std::string, LuaSceneWriter::SaveState> LuaSceneWriter::saveStates;
+std::mutex LuaSceneWriter::saveStateMutex;
+
+namespace {
+
+    /**
+     * \brief Retrieves an empty Lua state for LuaManagers that never execute their file.
+     * \return Shared pointer to the empty state.
+     */
+    const std::shared_ptr<sol::state>& GetDetachedState() {
+        static std::shared_ptr<sol::state> detachedState = LuaStateCache::CreateState();
+        return detachedState;
+    }
+}
+
+std::atomic<unsigned long long> LuaStateCache::statesCreated{ 0 };
+std::atomic<unsigned long long> LuaStateCache::cacheHits{ 0 };
+std::atomic<unsigned long long> LuaStateCache::cacheMisses{ 0 };
+std::atomic<unsigned long long> LuaStateCache::generation{ 0 };
+
+/**
+ * \brief Retrieves the cache of the calling thread.
+ * \return Reference to the cache.
+ */
+LuaStateCache& LuaStateCache::GetInstance() {
+    static thread_local LuaStateCache instance;
+    return instance;
+}
+
+/**
+ * \brief Returns the executed state of a file, running the file only if it is not
+ *        cached yet or has changed since it was cached.
+ * \param luaFilePath The path to the Lua file.
+ * \return Shared pointer to the Lua state. Missing files get a fresh, uncached state.
+ */
+std::shared_ptr<sol::state> LuaStateCache::Acquire(const std::string& luaFilePath) {
+    std::error_code error;
+    std::filesystem::file_time_type writeTime{};
+    std::uintmax_t fileSize = 0;
+    uint64_t packedSize = 0;
+    if (VirtualFileSystem::GetInstance().GetPackedSize(luaFilePath, packedSize)) {
+        // The mounted pack does not change, its size is enough to tell files apart
+        fileSize = packedSize;
+    }
+    else {
+        writeTime = std::filesystem::last_write_time(luaFilePath, error);
+        fileSize = error ? 0 : std::filesystem::file_size(luaFilePath, error);
+    }
+    if (error) {
+        // Nothing to cache yet, e.g. a LuaManager opened to create a new file
+        entries.erase(luaFilePath);
+        return CreateState();
+    }
+
+    const unsigned long long currentGeneration = generation.load(std::memory_order_acquire);
+    auto it = entries.find(luaFilePath);
+    if (it != entries.end() && it->second.writeTime == writeTime && it->second.fileSize == fileSize
+        && it->second.generation == currentGeneration) {
+        cacheHits.fetch_add(1, std::memory_order_relaxed);
+        return it->second.lua;
+    }
+
+    cacheMisses.fetch_add(1, std::memory_order_relaxed);
+    Entry entry;
+    entry.lua = CreateState();
+    entry.writeTime = writeTime;
+    entry.fileSize = fileSize;
+    entry.generation = currentGeneration;
+    if (!LuaBytecodeCache::RunFile(*entry.lua, luaFilePath)) {
+        // Do not keep a half-executed file around, the next Acquire retries it
+        entries.erase(luaFilePath);
+        return entry.lua;
+    }
+
+    std::shared_ptr<sol::state> lua = entry.lua;
+    entries[luaFilePath] = std::move(entry);
+    return lua;
+}
+
+/**
+ * \brief Drops a file from the caches of all threads. Call after writing the file.
+ * \param luaFilePath The path to the Lua file.
+ */
+void LuaStateCache::Invalidate(const std::string& luaFilePath) {
+    GetInstance().entries.erase(luaFilePath);
+    // Other threads cannot be touched from here, so they revalidate every entry on their next Acquire
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * \brief Drops every cached state of the calling thread.
+ */
+void LuaStateCache::Clear() {
+    entries.clear();
+}
+
+/**
+ * \brief Creates a new Lua state with the base library opened and counts it.
+ * \return Shared pointer to the new state.
+ */
+std::shared_ptr<sol::state> LuaStateCache::CreateState() {
+    statesCreated.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<sol::state> lua = std::make_shared<sol::state>();
+    lua->open_libraries(sol::lib::base);
+    return lua;
+}
+
+/**
+ * \brief Parses the Lua file and indexes the sub-tables of every object table.
+ * \param luaFilePath The path to the Lua file to parse.
+ */
+LuaSceneContext::LuaSceneContext(const std::string& luaFilePath)
+    : filePath(luaFilePath), previous(active) {
+    // Prefer the memory-mapped cooked image when it is newer than the source
+    if (CookedScene::IsUpToDate(luaFilePath)) {
+        std::shared_ptr<CookedScene> cookedFile = std::make_shared<CookedScene>();
+        if (cookedFile->Load(CookedScene::GetCookedPath(luaFilePath))) {
+            cooked = std::move(cookedFile);
+            // LuaManagers still bind a state, but a cooked context never executes anything in it
+            lua = GetDetachedState();
+            active = this;
+            return;
+        }
+    }
+
+    lua = LuaStateCache::GetInstance().Acquire(luaFilePath);
+
+    // List of names to ignore (standard Lua globals)
+    std::unordered_set<std::string> ignoredGlobals = { "_G", "base", "package", "coroutine", "string", "table", "math", "io", "os", "debug", "utf8", "jit", "bit32" };
+
+    // One pass over the globals replaces a TableExists probe per component type per object
+    for (const auto& pair : lua->globals()) {
+        if (!pair.second.is<sol::table>() || !pair.first.is<std::string>()) {
+            continue;
+        }
+
+        std::string objectName = pair.first.as<std::string>();
+        if (ignoredGlobals.find(objectName) != ignoredGlobals.end()) {
+            continue;
+        }
+
+        std::unordered_set<std::string>& names = subTables[objectName];
+        for (const auto& entry : pair.second.as<sol::table>()) {
+            if (entry.second.is<sol::table>() && entry.first.is<std::string>()) {
+                names.insert(entry.first.as<std::string>());
+            }
+        }
+    }
+
+    active = this;
+}
+
+/**
+ * \brief Serves reads for a path from a cooked image that is already in memory,
+ *        e.g. a world snapshot. Neither the file nor Lua is touched.
+ * \param luaFilePath The path LuaManagers will be opened with.
+ * \param image The cooked image to read from.
+ */
+LuaSceneContext::LuaSceneContext(const std::string& luaFilePath, std::shared_ptr<const CookedScene> image)
+    : lua(GetDetachedState()), cooked(std::move(image)), filePath(luaFilePath), previous(active) {
+    active = this;
+}
+
+/**
+ * \brief Removes the context from the active context chain of this thread.
+ */
+LuaSceneContext::~LuaSceneContext() {
+    active = previous;
+}
+
+/**
+ * \brief Finds the innermost active context of this thread for a file.
+ * \param luaFilePath The path to the Lua file.
+ * \return The context, or nullptr if the file is not being loaded through one.
+ */
+LuaSceneContext* LuaSceneContext::Find(const std::string& luaFilePath) {
+    for (LuaSceneContext* context = active; context; context = context->previous) {
+        if (context->filePath == luaFilePath) {
+            return context;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \brief Checks if an object table contains a sub-table, using the pre-built index.
+ * \param objectTable The name of the object table.
+ * \param subTable The name of the sub-table to check.
+ * \return True if the sub-table exists, false otherwise.
+ */
+bool LuaSceneContext::HasTable(const std::string& objectTable, const std::string& subTable) const {
+    if (cooked) {
+        return cooked->HasTable(objectTable, subTable);
+    }
+    auto it = subTables.find(objectTable);
+    return it != subTables.end() && it->second.count(subTable) > 0;
+}
+
+/**
+ * \brief Lists the sub-tables of an object table, using the pre-built index.
+ * \param objectTable The name of the object table.
+ * \return The sub-table names. Empty if the object does not exist.
+ */
+std::vector<std::string> LuaSceneContext::GetTableNames(const std::string& objectTable) const {
+    if (cooked) {
+        return cooked->GetTableNames(objectTable);
+    }
+    auto it = subTables.find(objectTable);
+    if (it == subTables.end()) {
+        return {};
+    }
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+
+
 /**
  * \brief Constructs a LuaManager and initializes the Lua state with a specified file.
+ *        If a LuaSceneContext is active for the file, its already executed state is reused,
+ *        otherwise the state is shared through LuaStateCache until the file changes.
  * \param luaFilePath The path to the Lua file to be managed.
  */
-LuaManager::LuaManager(const std::string& luaFilePath) {
-    lua.open_libraries(sol::lib::base);
-    LuaLoadFile(luaFilePath);
+LuaManager::LuaManager(const std::string& luaFilePath)
+    : luaState(AcquireState(luaFilePath)), lua(*luaState) {
+    if (LuaSceneContext* context = LuaSceneContext::Find(luaFilePath)) {
+        cooked = context->GetCookedScene();
+    }
+    else if (LuaSceneWriter* activeWriter = LuaSceneWriter::Find(luaFilePath)) {
+        // Writes are forwarded to the writer, so the old file is never executed or read
+        writer = activeWriter;
+    }
     currentLuaFilePath = luaFilePath;
+}
+
+/**
+ * \brief Returns the Lua state of the active LuaSceneContext for a file, or the cached
+ *        state of the file from LuaStateCache.
+ * \param luaFilePath The path to the Lua file.
+ * \return Shared pointer to the Lua state.
+ */
+std::shared_ptr<sol::state> LuaManager::AcquireState(const std::string& luaFilePath) {
+    if (LuaSceneContext* context = LuaSceneContext::Find(luaFilePath)) {
+        return context->GetState();
+    }
+    if (LuaSceneWriter::Find(luaFilePath)) {
+        return GetDetachedState();
+    }
+    return LuaStateCache::GetInstance().Acquire(luaFilePath);
+}
+
+/**
+ * \brief Starts collecting writes for a file.
+ * \param luaFilePath The path of the Lua file to produce.
+ * \param headerComment The first line of the file.
+ */
+LuaSceneWriter::LuaSceneWriter(const std::string& luaFilePath, const std::string& headerComment)
+    : filePath(luaFilePath), header(headerComment), previous(active) {
+    active = this;
+}
+
+/**
+ * \brief Stops collecting writes. Anything not committed is discarded.
+ */
+LuaSceneWriter::~LuaSceneWriter() {
+    active = previous;
+}
+
+/**
+ * \brief Finds the innermost active writer of this thread for a file.
+ * \param luaFilePath The path to the Lua file.
+ * \return The writer, or nullptr if the file is not being saved through one.
+ */
+LuaSceneWriter* LuaSceneWriter::Find(const std::string& luaFilePath) {
+    for (LuaSceneWriter* writer = active; writer; writer = writer->previous) {
+        if (writer->filePath == luaFilePath) {
+            return writer;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * \brief Records values in a nested table, with the same update-or-add rules as LuaManager::LuaWrite.
+ * \param tableName The name of the main table.
+ * \param values A container of values to write.
+ * \param keys A vector of keys corresponding to the values.
+ * \param nestedTableName The name of the nested table to update or create.
+ */
+void LuaSceneWriter::Write(const std::string& tableName, const LuaManager::LuaValueContainer& values, const std::vector<std::string>& keys, const std::string& nestedTableName) {
+    auto [lookupIt, inserted] = tableLookup.try_emplace(tableName, tables.size());
+    if (inserted) {
+        tables.push_back({ tableName, {} });
+    }
+    MainTable& mainTable = tables[lookupIt->second];
+
+    auto nestedIt = std::find_if(mainTable.nestedTables.begin(), mainTable.nestedTables.end(),
+        [&nestedTableName](const NestedTable& nested) { return nested.name == nestedTableName; });
+    if (nestedIt == mainTable.nestedTables.end()) {
+        mainTable.nestedTables.push_back({ nestedTableName, {} });
+        nestedIt = std::prev(mainTable.nestedTables.end());
+    }
+
+    for (size_t index = 0; index < values.size() && index < keys.size(); ++index) {
+        auto entryIt = std::find_if(nestedIt->entries.begin(), nestedIt->entries.end(),
+            [&keys, index](const auto& entry) { return entry.first == keys[index]; });
+        if (entryIt != nestedIt->entries.end()) {
+            entryIt->second = values[index];
+        }
+        else {
+            nestedIt->entries.emplace_back(keys[index], values[index]);
+        }
+    }
+}
+
+/**
+ * \brief Writes all collected tables to the file and replaces it atomically.
+ * \return True if the file was written, false otherwise.
+ */
+bool LuaSceneWriter::Commit() {
+    constexpr size_t flushThreshold = 64 * 1024;
+    const std::string tempPath = filePath + ".tmp";
+    bytesWritten = 0;
+    tablesWritten = 0;
+    SaveState state;
+
+    {
+        std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            ImGuiConsole::Cout("Error: Could not create or open the file %s", tempPath.c_str());
+            return false;
+        }
+
+        std::string buffer;
+        buffer.reserve(flushThreshold + 4096);
+        buffer += header;
+        buffer += "\n";
+
+        std::string tableText;
+        for (const MainTable& mainTable : tables) {
+            tableText.clear();
+            RenderTable(tableText, mainTable);
+            state.tableHashes[mainTable.name] = HashTable(tableText);
+            buffer += tableText;
+
+            if (buffer.size() >= flushThreshold) {
+                outFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                bytesWritten += buffer.size();
+                buffer.clear();
+            }
+        }
+        outFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        bytesWritten += buffer.size();
+        tablesWritten = tables.size();
+
+        if (!outFile.good()) {
+            ImGuiConsole::Cout("Error: Could not write the file %s", tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error) {
+        // Some platforms refuse to rename over an existing file
+        std::filesystem::remove(filePath, error);
+        std::filesystem::rename(tempPath, filePath, error);
+    }
+    LuaStateCache::Invalidate(filePath);
+
+    std::lock_guard<std::mutex> lock(saveStateMutex);
+    if (error) {
+        saveStates.erase(filePath);
+        ImGuiConsole::Cout("Error: Could not replace the file %s", filePath.c_str());
+        return false;
+    }
+
+    state.baseBytes = bytesWritten;
+    if (StampSaveState(state)) {
+        saveStates[filePath] = std::move(state);
+    }
+    else {
+        saveStates.erase(filePath);
+    }
+    return true;
+}
+
+/**
+ * \brief Writes only the tables that changed since the last save of this file.
+ * \return True if the file is up to date, false otherwise.
+ */
+bool LuaSceneWriter::CommitChanges() {
+    bytesWritten = 0;
+    tablesWritten = 0;
+
+    std::string journal;
+    {
+        std::lock_guard<std::mutex> lock(saveStateMutex);
+        auto stateIt = saveStates.find(filePath);
+        if (stateIt != saveStates.end()) {
+            // Anything else that wrote the file (LuaWrite, SaveNewScene, a text editor) invalidates the hashes
+            SaveState onDisk;
+            if (!StampSaveState(onDisk) || onDisk.writeTime != stateIt->second.writeTime || onDisk.fileSize != stateIt->second.fileSize) {
+                saveStates.erase(stateIt);
+                stateIt = saveStates.end();
+            }
+        }
+
+        if (stateIt != saveStates.end()) {
+            SaveState& state = stateIt->second;
+            std::unordered_map<std::string, uint64_t> changedHashes;
+            std::string tableText;
+            for (const MainTable& mainTable : tables) {
+                tableText.clear();
+                RenderTable(tableText, mainTable);
+                const uint64_t hash = HashTable(tableText);
+                auto hashIt = state.tableHashes.find(mainTable.name);
+                if (hashIt == state.tableHashes.end() || hashIt->second != hash) {
+                    journal += tableText;
+                    changedHashes[mainTable.name] = hash;
+                    ++tablesWritten;
+                }
+            }
+
+            std::vector<std::string> removedTables;
+            for (const auto& [tableName, hash] : state.tableHashes) {
+                if (tableLookup.find(tableName) == tableLookup.end()) {
+                    journal += tableName;
+                    journal += " = nil\n";
+                    removedTables.push_back(tableName);
+                    ++tablesWritten;
+                }
+            }
 
-    // Load the file content into memory once during initialization
-    fileContent = readFile(luaFilePath);
+            if (journal.empty()) {
+                return true;
+            }
+
+            // Compact once replaying the journal costs more than half a full load
+            if (state.journalBytes + journal.size() <= state.baseBytes / 2) {
+                journal.insert(0, "-- Journal\n");
+                {
+                    std::ofstream outFile(filePath, std::ios::binary | std::ios::app);
+                    if (outFile.is_open()) {
+                        outFile.write(journal.data(), static_cast<std::streamsize>(journal.size()));
+                    }
+                    if (!outFile.good()) {
+                        saveStates.erase(stateIt);
+                        LuaStateCache::Invalidate(filePath);
+                        ImGuiConsole::Cout("Error: Could not append to the file %s", filePath.c_str());
+                        return false;
+                    }
+                }
+                LuaStateCache::Invalidate(filePath);
+
+                for (auto& [tableName, hash] : changedHashes) {
+                    state.tableHashes[tableName] = hash;
+                }
+                for (const std::string& tableName : removedTables) {
+                    state.tableHashes.erase(tableName);
+                }
+                state.journalBytes += journal.size();
+                bytesWritten = journal.size();
+                if (!StampSaveState(state)) {
+                    saveStates.erase(stateIt);
+                }
+                return true;
+            }
+        }
+    }
+
+    return Commit();
+}
+
+/**
+ * \brief Appends a main table in the layout LuaManager::LuaWrite produces.
+ * \param buffer The text to append to.
+ * \param mainTable The table to render.
+ */
+void LuaSceneWriter::RenderTable(std::string& buffer, const MainTable& mainTable) {
+    // Same layout LuaManager::LuaWrite produces, so the loader and later LuaWrite calls can read it
+    buffer += mainTable.name;
+    buffer += " = {\n";
+    for (const NestedTable& nested : mainTable.nestedTables) {
+        buffer += "    ";
+        buffer += nested.name;
+        buffer += " = {\n";
+        for (const auto& [key, value] : nested.entries) {
+            buffer += "        ";
+            buffer += key;
+            buffer += " = ";
+            LuaManager::FindType(buffer, value);
+            buffer += ",\n";
+        }
+        buffer += "    },\n";
+    }
+    buffer += "}\n";
+}
+
+/**
+ * \brief Hashes the rendered text of a table.
+ * \param text The rendered table.
+ * \return The 64-bit FNV-1a hash.
+ */
+uint64_t LuaSceneWriter::HashTable(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char character : text) {
+        hash ^= character;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * \brief Records the size and modification time the file has after a save.
+ * \param state The save state to update.
+ * \return True if the file could be inspected, false otherwise.
+ */
+bool LuaSceneWriter::StampSaveState(SaveState& state) const {
+    std::error_code error;
+    state.writeTime = std::filesystem::last_write_time(filePath, error);
+    if (error) {
+        return false;
+    }
+    state.fileSize = std::filesystem::file_size(filePath, error);
+    return !error;
+}
+
+/**
+ * \brief Lays out all collected tables as a cooked image instead of Lua text.
+ * \return The image, ready for CookedScene::LoadFromMemory.
+ */
+std::vector<unsigned char> LuaSceneWriter::BuildCookedImage() const {
+    CookedScene::Builder builder;
+    for (const MainTable& mainTable : tables) {
+        // The parent id is part of the object record, so it has to be known up front
+        int parentID = -1;
+        for (const NestedTable& nested : mainTable.nestedTables) {
+            if (nested.name != "Name") {
+                continue;
+            }
+            for (const auto& [key, value] : nested.entries) {
+                if (key != "parentID") {
+                    continue;
+                }
+                // A whole float is written as an integer, which is how the Lua loader reads it back
+                std::visit([&parentID](const auto& entry) {
+                    using T = std::decay_t<decltype(entry)>;
+                    if constexpr (std::is_same_v<T, int>) {
+                        parentID = entry;
+                    }
+                    else if constexpr (std::is_floating_point_v<T>) {
+                        if (std::isfinite(entry) && std::trunc(entry) == entry && std::fabs(entry) <= static_cast<T>(1 << 24)) {
+                            parentID = static_cast<int>(entry);
+                        }
+                    }
+                }, value);
+            }
+        }
+
+        builder.BeginObject(mainTable.name, parentID);
+        for (const NestedTable& nested : mainTable.nestedTables) {
+            builder.BeginTable(nested.name);
+            for (const auto& [key, value] : nested.entries) {
+                std::visit([&builder, &key](const auto& entry) {
+                    using ValueType = std::decay_t<decltype(entry)>;
+                    if constexpr (std::is_same_v<ValueType, std::string>) {
+                        builder.AddString(key, entry);
+                    }
+                    else if constexpr (std::is_same_v<ValueType, bool>) {
+                        builder.AddBoolean(key, entry);
+                    }
+                    else {
+                        builder.AddNumber(key, static_cast<double>(entry));
+                    }
+                }, value);
+            }
+        }
+    }
+    return builder.Finish();
+}
+
+/**
+ * \brief Reads the file into fileContent the first time it is needed for writing.
+ */
+void LuaManager::LoadFileContent() {
+    if (fileContentLoaded) {
+        return;
+    }
+    fileContentLoaded = true;
+
+    fileContent = readFile(currentLuaFilePath);
     if (fileContent.empty()) {
 #ifdef _LOGGING
         ImGuiConsole::Cout("Failed to read Lua file or file is empty.");
@@ -129,16 +716,8 @@ LuaManager::LuaManager(const std::string& luaFilePath) {
  * \param luaFilePath The path to the Lua file to load.
  */
 void LuaManager::LuaLoadFile(const std::string& luaFilePath) {
-    try {
-        lua.safe_script_file(luaFilePath); // Load file
-    }
-    catch (const sol::error& e) {
-#ifdef _LOGGING
-		ImGuiConsole::Cout("Lua error: %s", e.what());
-#else
-        (void)e;
-#endif // _LOGGING
-    }
+    // Uses the precompiled chunk when it matches the file, errors are logged by the cache
+    LuaBytecodeCache::RunFile(lua, luaFilePath);
 }
 
 
@@ -148,6 +727,17 @@ void LuaManager::LuaLoadFile(const std::string& luaFilePath) {
  * \param audioClipIDs A reference to a vector to store the retrieved audio clip IDs.
  */
 void LuaManager::LuaReadFromAudioClips(const std::string& tableName, std::vector<int>& audioClipIDs) {
+    if (cooked) {
+        for (int index = 0; ; ++index) {
+            std::optional<int> audioID = cooked->Read<int>(tableName, { "Audio", "audioClip" + std::to_string(index) });
+            if (!audioID) {
+                break;
+            }
+            audioClipIDs.push_back(audioID.value());
+        }
+        return;
+    }
+
     lua_getglobal(lua, tableName.c_str());  // Push the main table onto the stack
     if (lua_istable(lua, -1)) {
         lua_getfield(lua, -1, "Audio");  // Push the Audio table onto the stack
@@ -190,6 +780,62 @@ std::string trimWhitespace(const std::string& str) {
 
 
 
+LuaManager::NumberFormat LuaManager::numberFormat = LuaManager::NumberFormat::ROUND_TRIP;
+
+namespace {
+
+    /**
+     * \brief Appends a float or double as a Lua number literal without going through iostreams.
+     *
+     * ROUND_TRIP writes the shortest digits that parse back to the same value. Lua parses
+     * literals as doubles, so floats are checked by parsing the short form back and, in
+     * the rare case the double to float rounding disagrees, written with double precision.
+     * Infinities and NaN are written as expressions because Lua has no literal for them.
+     *
+     * \param entry The string to append to.
+     * \param value The value to write.
+     * \param format The number format to use.
+     */
+    template<typename T>
+    void AppendLuaNumber(std::string& entry, T value, LuaManager::NumberFormat format) {
+        if (std::isnan(value)) {
+            entry += "(0/0)";
+            return;
+        }
+        if (std::isinf(value)) {
+            entry += value > 0 ? "(1/0)" : "(-1/0)";
+            return;
+        }
+        if (value == 0 && std::signbit(value)) {
+            entry += "-0.0"; // "-0" would be read back as the integer 0
+            return;
+        }
+
+        char buffer[64];
+        std::to_chars_result result;
+        if (format == LuaManager::NumberFormat::FIXED_2) {
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 2);
+        }
+        else {
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            if constexpr (std::is_same_v<T, float>) {
+                double parsed = 0.0;
+                std::from_chars(buffer, result.ptr, parsed);
+                if (static_cast<float>(parsed) != value) {
+                    result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(value));
+                }
+            }
+        }
+
+        if (result.ec == std::errc()) {
+            entry.append(buffer, result.ptr);
+        }
+        else {
+            entry += "0";
+        }
+    }
+}
+
 /**
  * \brief Determines the Lua type for a value and appends it to the entry string.
  * \param entry The Lua key-value entry being created.
@@ -200,16 +846,10 @@ void LuaManager::FindType(std::string& entry, const LuaValue& value) {
         entry += std::to_string(std::get<int>(value));
     }
     else if (std::holds_alternative<float>(value)) {
-        std::stringstream stream;
-        stream.precision(2);
-        stream << std::fixed << std::get<float>(value); 
-        entry += stream.str();
+        AppendLuaNumber(entry, std::get<float>(value), numberFormat);
     }
     else if (std::holds_alternative<double>(value)) {  // Added handling for double
-        std::stringstream stream;
-        stream.precision(2);
-        stream << std::fixed << std::get<double>(value);  
-        entry += stream.str();
+        AppendLuaNumber(entry, std::get<double>(value), numberFormat);
     }
     else if (std::holds_alternative<bool>(value)) {
         entry += std::get<bool>(value) ? "true" : "false";
@@ -266,6 +906,7 @@ bool LuaManager::writeFile(const std::string& luaFilePath, const std::vector<std
     }
 
     outFile.close();
+    LuaStateCache::Invalidate(luaFilePath);
     return true;
 }
 
@@ -289,6 +930,7 @@ void LuaManager::SaveNewScene(const std::string& filename, const std::string& lu
 
     // Close the file stream
     luaFile.close();
+    LuaStateCache::Invalidate(filename);
 
     //ImGuiConsole::Cout("Data saved to " << filename);
 }
@@ -299,8 +941,15 @@ void LuaManager::SaveNewScene(const std::string& filename, const std::string& lu
  * \return A map where keys are object IDs and values are their names.
  */
 std::unordered_map<int, std::string> LuaManager::extractNames() {
-    sol::table globals = lua.globals();
     std::unordered_map<int, std::string> idNameMap;
+    if (cooked) {
+        for (auto& [id, data] : extractNamesWithParentIDs()) {
+            idNameMap[id] = data.first;
+        }
+        return idNameMap;
+    }
+
+    sol::table globals = lua.globals();
 
     // List of names to ignore (standard Lua globals)
     std::unordered_set<std::string> ignoredGlobals = { "_G", "base", "package", "coroutine", "string", "table", "math", "io", "os", "debug", "utf8", "jit", "bit32" };
@@ -343,6 +992,11 @@ std::unordered_map<int, std::string> LuaManager::extractNames() {
  * \return True if the sub-table exists, false otherwise.
  */
 bool LuaManager::TableExists(const std::string& parentTable, const std::string& subTable) {
+    // Answer from the pre-built index while the file is being loaded through a context
+    if (LuaSceneContext* context = LuaSceneContext::Find(currentLuaFilePath)) {
+        return context->HasTable(parentTable, subTable);
+    }
+
     // Access the Lua state and load the specified parent table
     sol::optional<sol::table> tableOpt = lua[parentTable];
 
@@ -362,6 +1016,10 @@ bool LuaManager::TableExists(const std::string& parentTable, const std::string&
  * \return The number of non-standard tables in the Lua globals.
  */
 int LuaManager::countTables() {
+    if (cooked) {
+        return static_cast<int>(cooked->GetObjectCount());
+    }
+
     sol::table globals = lua.globals();
     int tableCount = 0;
 
@@ -395,6 +1053,7 @@ int LuaManager::countTables() {
  */
 void LuaManager::ClearLuaFile() {
     // Clear the fileContent vector which holds the Lua file's content
+    fileContentLoaded = true;
     fileContent.clear();
     fileContent.push_back("--config file");
 
@@ -417,8 +1076,20 @@ void LuaManager::ClearLuaFile() {
  * \return A map where keys are object IDs and values are pairs of object names and parent IDs.
  */
 std::unordered_map<int, std::pair<std::string, int>> LuaManager::extractNamesWithParentIDs() {
-    sol::table globals = lua.globals();
     std::unordered_map<int, std::pair<std::string, int>> idDataMap;
+    if (cooked) {
+        for (size_t i = 0; i < cooked->GetObjectCount(); ++i) {
+            const std::string tableName(cooked->GetObjectTableName(i));
+            if (!cooked->HasTable(tableName, "Name") || cooked->GetObjectID(i) < 0) {
+                continue;
+            }
+            std::string name = cooked->Read<std::string>(tableName, { "Name", "name" }).value_or("");
+            idDataMap[cooked->GetObjectID(i)] = { name + "_" + std::to_string(cooked->GetObjectID(i)), cooked->GetParentID(i) };
+        }
+        return idDataMap;
+    }
+
+    sol::table globals = lua.globals();
 
     // List of names to ignore (standard Lua globals)
     std::unordered_set<std::string> ignoredGlobals = { "_G", "base", "package", "coroutine", "string", "table", "math", "io", "os", "debug", "utf8", "jit", "bit32" };
@@ -0,0 +1,162 @@
+/*!****************************************************************
+\file: MappedFile.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Read-only memory-mapped view of a file. Used by binary asset
+        formats that are read in place instead of being parsed into
+        separate buffers.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+// Ensure APIENTRY is undefined before including Windows headers
+#ifdef APIENTRY
+#undef APIENTRY
+#endif
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * \brief Unmaps the file if it is still open.
+ */
+MappedFile::~MappedFile() {
+    Close();
+}
+
+/**
+ * \brief Transfers ownership of a mapping.
+ * \param other The mapping to move from. It is left closed.
+ */
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+/**
+ * \brief Transfers ownership of a mapping, closing the current one first.
+ * \param other The mapping to move from. It is left closed.
+ * \return Reference to this mapping.
+ */
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data = other.data;
+        size = other.size;
+#ifdef _WIN32
+        fileHandle = other.fileHandle;
+        mappingHandle = other.mappingHandle;
+        other.fileHandle = nullptr;
+        other.mappingHandle = nullptr;
+#else
+        fileDescriptor = other.fileDescriptor;
+        other.fileDescriptor = -1;
+#endif // _WIN32
+        other.data = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+/**
+ * \brief Maps the whole file read-only.
+ * \param filePath The path of the file to map.
+ * \return True if the file was mapped, false otherwise. Empty files cannot be mapped.
+ */
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    fileDescriptor = fd;
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(fileStat.st_size);
+#endif // _WIN32
+
+    return true;
+}
+
+/**
+ * \brief Unmaps the file and releases its handles.
+ */
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+    }
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (data) {
+        munmap(const_cast<unsigned char*>(data), size);
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+    }
+    fileDescriptor = -1;
+#endif // _WIN32
+    data = nullptr;
+    size = 0;
+}
@@ -200,8 +200,8 @@ void PlayerControllerComponent::Update() {
             // Play a footstep sound at intervals while moving
             if (footstepTimer >= footstepInterval) {
                 randomFootstepID = 20 + (std::rand() % 10); // Pick a random footstep SFX (20-29)
-                AudioManager::GetInstance().PlayAudio(randomFootstepID);
-                AudioManager::GetInstance().SetChannelVolume(randomFootstepID, 0.3f);
+                AudioManager::GetInstance().PostPlay(randomFootstepID);
+                AudioManager::GetInstance().PostChannelVolume(randomFootstepID, 0.3f);
                 footstepTimer = 0.0f; // Reset timer for next step
             }
         }
@@ -449,7 +449,7 @@ void PlayerControllerComponent::Update() {
                         }
                         aiComponent->isProjectile = true;
                         aiComponent->projectileTimer = 0.f;
-                        AudioManager::GetInstance().PlayAudio(0);
+                        AudioManager::GetInstance().PostPlay(0);
                         Vector2 shootDirection = mousePosition - playerTransform->GetPosition();
                         float magnitude = std::sqrt(shootDirection.x * shootDirection.x + shootDirection.y * shootDirection.y);
 
@@ -561,7 +561,7 @@ void PlayerControllerComponent::Update() {
 
                     if (!suctionSoundPlaying)
                     {
-                        AudioManager::GetInstance().PlayAudio(2);
+                        AudioManager::GetInstance().PostPlay(2);
                         suctionSoundPlaying = true;
                     }
 
@@ -628,8 +628,8 @@ void PlayerControllerComponent::Update() {
                                 playerHandTransform->SetLocalPosition(targetPosition);
                                 grabbingBack = false;
                                 heldObject = draggingObject;
-                                AudioManager::GetInstance().PlayAudio(68);
-                                AudioManager::GetInstance().SetChannelVolume(68, 0.3f);
+                                AudioManager::GetInstance().PostPlay(68);
+                                AudioManager::GetInstance().PostChannelVolume(68, 0.3f);
                                 //ImGuiConsole::Cout("Suction Time: %s: %f", draggingObject->GetName(), suctionTime);
                                 draggingObject = nullptr;
                                 collidedObject = nullptr;
@@ -639,7 +639,7 @@ void PlayerControllerComponent::Update() {
 #endif // _LOGGING
                                 heldObject->SetParent(GetParentGameObject());//Set this object as the player's child now
                                 collider->SetCurrentlyColliding(nullptr);
-                                AudioManager::GetInstance().StopAudio(2);
+                                AudioManager::GetInstance().PostStop(2);
                                 suctionSoundPlaying = false;
                                 Engine::GetInstance().cameraManager.GetPlayerCamera().HandleShake(false, false);    //camera shake stops
                                 suctionTime = 0.0f; // Reset suction acceleration when suction stops
@@ -780,7 +780,7 @@ void PlayerControllerComponent::Update() {
                         collidedObject = nullptr;
 
                         collider->SetCurrentlyColliding(nullptr);
-                        AudioManager::GetInstance().StopAudio(2);
+                        AudioManager::GetInstance().PostStop(2);
                         suctionSoundPlaying = false;
 
                         if (collider->GetCurrentlyColliding())
@@ -821,43 +821,16 @@ void PlayerControllerComponent::Update() {
     {
         //ImGuiConsole::Cout("BGM is playing\n");
 
-        float volume = 0.0f;
-        bool isPlaying = false;
-        float isAudible = false;
-
         if (AudioManager::GetInstance().bgmChannel) {
-            AudioManager::GetInstance().bgmChannel->getVolume(&volume);
-            AudioManager::GetInstance().bgmChannel->isPlaying(&isPlaying);
-            AudioManager::GetInstance().bgmChannel->getAudibility(&isAudible);
-
-
-
-            unsigned int position = 0;
-            AudioManager::GetInstance().bgmChannel->getPosition(&position, FMOD_TIMEUNIT_MS);
+            AudioBackend& audioBackend = AudioManager::GetInstance().GetBackend();
+            unsigned int position = audioBackend.GetPosition(AudioManager::GetInstance().bgmChannel);
 
             if (position == 0) {
                 //ImGuiConsole::Cout("BGM is stuck at position 0! Advancing...");
-                AudioManager::GetInstance().bgmChannel->setPosition(100, FMOD_TIMEUNIT_MS);
-            }
-
-            FMOD_MODE mode;
-            AudioManager::GetInstance().bgmChannel->getMode(&mode);
-
-            if (mode & FMOD_VIRTUAL_PLAYFROMSTART) {
-                //ImGuiConsole::Cout("BGM is in virtual mode. Forcing playback...");
-                AudioManager::GetInstance().bgmChannel->setMode(mode & ~FMOD_VIRTUAL_PLAYFROMSTART);
+                audioBackend.SetPosition(AudioManager::GetInstance().bgmChannel, 100);
             }
 
-            FMOD_OUTPUTTYPE outputType;
-            AudioManager::GetInstance().GetSystem()->getOutput(&outputType);
-
-            std::string outputDebug = "Current FMOD Output Mode: " + std::to_string(outputType);
-            //ImGuiConsole::Cout(outputDebug.c_str());
-
-            int channelsPlaying = 0;
-            AudioManager::GetInstance().GetSystem()->getChannelsPlaying(&channelsPlaying, nullptr);
-
-            std::string channelDebug = "FMOD Active Channels: " + std::to_string(channelsPlaying);
+            std::string channelDebug = std::string(audioBackend.GetName()) + " Active Channels: " + std::to_string(audioBackend.GetChannelsPlaying());
             //ImGuiConsole::Cout(channelDebug.c_str());
 
         }
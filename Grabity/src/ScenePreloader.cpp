@@ -0,0 +1,193 @@
+/*!****************************************************************
+\file: ScenePreloader.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Prepares scenes on a background thread before they are loaded.
+        A preload executes the scene's Lua file in a private state (or
+        maps its cooked file), keeps the result as a cooked image in
+        memory and decodes the textures the scene names that are not
+        resident yet. When the scene is loaded later, LoadSceneFromLua
+        takes the image and uploads the decoded pixels instead of
+        parsing and decoding on the main thread.
+
+        Game objects are still created on the main thread when the scene
+        is loaded: components create OpenGL resources and register with
+        the singleton systems when they are deserialized, so there is no
+        second world to build them in and swap.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "ScenePreloader.h"
+#include "ImGuiConsole.h"
+#include "assetmanager.h"
+#include <chrono>
+#include <algorithm>
+
+/**
+ * \brief Retrieves the preloader instance.
+ * \return Reference to the preloader.
+ */
+ScenePreloader& ScenePreloader::GetInstance() {
+    static ScenePreloader instance;
+    return instance;
+}
+
+/**
+ * \brief Waits for any preload that is still running.
+ */
+ScenePreloader::~ScenePreloader() {
+    Clear();
+}
+
+/**
+ * \brief Starts preparing a scene on a background thread. Does nothing if the scene
+ *        is already being prepared or is ready.
+ * \param scenePath The path to the scene's Lua file.
+ */
+void ScenePreloader::Preload(const std::string& scenePath) {
+    ReleaseFinished();
+    if (scenePath.empty() || pending.find(scenePath) != pending.end()) {
+        return;
+    }
+
+    // The worker gets its own copy of the texture table, resident textures need no decode
+    AssetManager& assetManager = AssetManager::GetInstance();
+    std::unordered_map<std::string, std::string> texturePaths = assetManager.GetTexturePaths();
+    for (const auto& [name, texture] : assetManager.GetTextures()) {
+        texturePaths.erase(name);
+    }
+
+    PendingScene scene;
+    scene.writeTime = GetWriteTime(scenePath);
+    scene.prepared = std::async(std::launch::async, &ScenePreloader::Prepare, scenePath, std::move(texturePaths));
+    pending.emplace(scenePath, std::move(scene));
+}
+
+/**
+ * \brief Drops the preloads of every scene not in a set.
+ * \param scenePaths The scenes that can still be loaded next.
+ */
+void ScenePreloader::Retain(const std::unordered_set<std::string>& scenePaths) {
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (scenePaths.find(it->first) == scenePaths.end()) {
+            dropped.push_back(std::move(it->second.prepared));
+            it = pending.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    ReleaseFinished();
+}
+
+/**
+ * \brief Checks if a scene has been requested and has finished preparing.
+ * \param scenePath The path to the scene's Lua file.
+ * \return True if Take would return without waiting.
+ */
+bool ScenePreloader::IsReady(const std::string& scenePath) const {
+    auto it = pending.find(scenePath);
+    return it != pending.end() && it->second.prepared.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/**
+ * \brief Hands over a prepared scene, waiting for it if the preload is still running.
+ *        The scene is forgotten afterwards.
+ * \param scenePath The path to the scene's Lua file.
+ * \return The scene image and decoded textures. The image is nullptr if the scene was
+ *         never requested, failed, or the file changed after the preload started.
+ */
+ScenePreloader::PreparedScene ScenePreloader::Take(const std::string& scenePath) {
+    auto it = pending.find(scenePath);
+    if (it == pending.end()) {
+        return PreparedScene();
+    }
+
+    PendingScene scene = std::move(it->second);
+    pending.erase(it);
+
+    PreparedScene prepared = scene.prepared.get();
+    if (!prepared.error.empty()) {
+        ImGuiConsole::Cout("Preload failed for %s: %s", scenePath.c_str(), prepared.error.c_str());
+    }
+    if (prepared.image && GetWriteTime(scenePath) != scene.writeTime) {
+        // Saved from the editor while the preload was waiting, the image is stale
+        prepared.image.reset();
+    }
+    return prepared;
+}
+
+/**
+ * \brief Drops every prepared scene, waiting for running preloads first.
+ */
+void ScenePreloader::Clear() {
+    for (auto& [scenePath, scene] : pending) {
+        if (scene.prepared.valid()) {
+            scene.prepared.wait();
+        }
+    }
+    pending.clear();
+    for (std::future<PreparedScene>& prepared : dropped) {
+        if (prepared.valid()) {
+            prepared.wait();
+        }
+    }
+    dropped.clear();
+}
+
+/**
+ * \brief Frees dropped preloads that have finished.
+ */
+void ScenePreloader::ReleaseFinished() {
+    dropped.erase(std::remove_if(dropped.begin(), dropped.end(), [](const std::future<PreparedScene>& prepared) {
+        return !prepared.valid() || prepared.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), dropped.end());
+}
+
+/**
+ * \brief Prepares a scene. Runs on a background thread.
+ * \param scenePath The path to the scene's Lua file.
+ * \param texturePaths Files of the registered textures that are not resident, by name.
+ * \return The scene image and decoded textures, or an error.
+ */
+ScenePreloader::PreparedScene ScenePreloader::Prepare(const std::string& scenePath, const std::unordered_map<std::string, std::string>& texturePaths) {
+    PreparedScene prepared;
+    std::shared_ptr<CookedScene> image = std::make_shared<CookedScene>();
+
+    // A current cooked file only needs to be mapped
+    if (!(CookedScene::IsUpToDate(scenePath) && image->Load(CookedScene::GetCookedPath(scenePath)))) {
+        std::optional<std::vector<unsigned char>> bytes = CookedScene::BakeImage(scenePath);
+        if (!bytes || !image->LoadFromMemory(std::move(*bytes))) {
+            prepared.error = "the scene could not be parsed";
+            return prepared;
+        }
+    }
+
+    // Sprite, UI sprite and particle components all name their texture under a SpritePathName key
+    for (const std::string& textureName : image->GetStringValues("SpritePathName")) {
+        auto pathIt = texturePaths.find(textureName);
+        if (pathIt == texturePaths.end()) {
+            continue;
+        }
+        Texture::DecodedImage decoded;
+        if (Texture::Decode(pathIt->second, decoded)) {
+            prepared.textures.emplace_back(textureName, std::move(decoded));
+        }
+    }
+
+    prepared.image = std::move(image);
+    return prepared;
+}
+
+/**
+ * \brief Reads the write time of a scene file.
+ * \param scenePath The path to the scene's Lua file.
+ * \return The write time, or file_time_type::min() if the file does not exist.
+ */
+std::filesystem::file_time_type ScenePreloader::GetWriteTime(const std::string& scenePath) {
+    std::error_code error;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(scenePath, error);
+    return error ? std::filesystem::file_time_type::min() : writeTime;
+}
@@ -14,6 +14,7 @@ Technology is prohibited.
 *******************************************************************!*/
 
 #include "Shader.h"
+#include "VirtualFileSystem.h"
 
 
 #ifdef _IMGUI
@@ -50,7 +51,8 @@ Shader::~Shader()
 ShaderProgramSource Shader::ParseShader(const std::string& filepath)
 {
 	//RIDHWAN: Modified to ifstream to read the shader file
-    std::ifstream stream(filepath);
+    // Read through the virtual file system so shaders can come from the asset pack
+    std::istringstream stream(VirtualFileSystem::GetInstance().Open(filepath).ToString());
 
     std::string line;
     std::stringstream ss[2];
@@ -0,0 +1,686 @@
+/*!****************************************************************
+\file: SoftwareAudioBackend.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines a software mixer implementation of AudioBackend
+        that needs neither FMOD nor a sound device. Sounds are decoded
+        to float PCM when created, or kept as the WAV's own samples or
+        streamed from the file and converted a block at a time as they
+        play. Channels are resampled to the
+        output rate with linear interpolation and mixed with SSE where
+        available. The mix goes to a sink: nowhere, for running and
+        profiling the game headless, or a 16-bit stereo WAV file.
+
+        Only WAV is decoded. The OGG and MP3 assets need a decoder
+        library, so they fail to load in this backend; each failure
+        names the file's format and the engine lists every sound that
+        failed at startup. WAV
+        has no compression of its own, so a compressed sound keeps
+        the samples as the file stores them and converts them as it
+        plays.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "SoftwareAudioBackend.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIX_USE_SSE 1
+#endif
+
+namespace {
+    constexpr uint64_t FixedOne = 1ull << 32;
+    constexpr double Pi = 3.14159265358979323846;
+
+    uint16_t ReadU16(const unsigned char* bytes) {
+        return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    uint32_t ReadU32(const unsigned char* bytes) {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+            (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    void WriteU16(std::ofstream& file, uint16_t value) {
+        const char bytes[2] = { static_cast<char>(value & 0xFF), static_cast<char>(value >> 8) };
+        file.write(bytes, 2);
+    }
+
+    void WriteU32(std::ofstream& file, uint32_t value) {
+        const char bytes[4] = { static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+            static_cast<char>((value >> 16) & 0xFF), static_cast<char>(value >> 24) };
+        file.write(bytes, 4);
+    }
+
+    // dst += src * gain
+    void MixInto(float* dst, const float* src, size_t count, float gain) {
+        size_t i = 0;
+#ifdef MIX_USE_SSE
+        const __m128 gains = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), gains)));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] += src[i] * gain;
+        }
+    }
+
+    // dst += src * gain for interleaved stereo, the gain changing by step every frame
+    void MixRampInto(float* dst, const float* src, size_t frames, float gain, float step) {
+        size_t frame = 0;
+#ifdef MIX_USE_SSE
+        __m128 gains = _mm_setr_ps(gain, gain, gain + step, gain + step);
+        const __m128 steps = _mm_set1_ps(2.0f * step);
+        for (; frame + 2 <= frames; frame += 2) {
+            float* out = dst + frame * 2;
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_loadu_ps(src + frame * 2), gains)));
+            gains = _mm_add_ps(gains, steps);
+        }
+#endif
+        for (; frame < frames; ++frame) {
+            const float frameGain = gain + step * static_cast<float>(frame);
+            dst[frame * 2] += src[frame * 2] * frameGain;
+            dst[frame * 2 + 1] += src[frame * 2 + 1] * frameGain;
+        }
+    }
+
+    // Clips the mix to [-1, 1] and converts it to 16-bit samples
+    void ConvertToPCM16(const float* src, int16_t* dst, size_t count) {
+        size_t i = 0;
+#ifdef MIX_USE_SSE
+        const __m128 low = _mm_set1_ps(-1.0f);
+        const __m128 high = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        for (; i + 8 <= count; i += 8) {
+            __m128 first = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), low), high), scale);
+            __m128 second = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), low), high), scale);
+            __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(first), _mm_cvtps_epi32(second));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] = static_cast<int16_t>(std::lrint(std::clamp(src[i], -1.0f, 1.0f) * 32767.0f));
+        }
+    }
+}
+
+// Creates a software mixer.
+SoftwareAudioBackend::SoftwareAudioBackend(Sink outputSink, const std::string& path, int rate)
+    : sink(outputSink), outputPath(path), sampleRate(rate > 0 ? rate : 48000) {
+}
+
+SoftwareAudioBackend::~SoftwareAudioBackend() {
+    Release();
+}
+
+// Starts the mixer and opens the WAV file.
+bool SoftwareAudioBackend::Init(int channelCount) {
+    maxChannels = channelCount > 0 ? channelCount : 1;
+    if (sink == Sink::WAV_FILE) {
+        wavFile.open(outputPath, std::ios::binary | std::ios::trunc);
+        if (!wavFile) {
+            ImGuiConsole::Cout("Software audio could not open %s, mixing to nowhere instead", outputPath.c_str());
+            sink = Sink::NONE;
+        }
+        else {
+            wavFrames = 0;
+            WriteWavHeader();
+        }
+    }
+    lastUpdate = std::chrono::steady_clock::now();
+    pendingFrames = 0.0;
+    return true;
+}
+
+// Stops every channel, releases the sounds and finishes the WAV file.
+void SoftwareAudioBackend::Release() {
+    channels.clear();
+    {
+        std::lock_guard<std::mutex> lock(soundMutex);
+        sounds.clear();
+    }
+    if (wavFile.is_open()) {
+        WriteWavHeader();
+        wavFile.close();
+    }
+}
+
+// Mixes as much audio as real time has passed since the last update.
+void SoftwareAudioBackend::Update() {
+    const auto now = std::chrono::steady_clock::now();
+    pendingFrames += std::chrono::duration<double>(now - lastUpdate).count() * sampleRate;
+    lastUpdate = now;
+
+    // A long hitch, e.g. a breakpoint, is dropped rather than mixed in one go
+    pendingFrames = std::min(pendingFrames, sampleRate * 0.25);
+    const size_t frames = static_cast<size_t>(pendingFrames);
+    if (frames > 0) {
+        pendingFrames -= static_cast<double>(frames);
+        Render(frames);
+    }
+}
+
+// Keeps a WAV file as float PCM, or as its own samples when compressed is asked for.
+AudioBackend::SoundID SoftwareAudioBackend::CreateSound(const void* data, size_t size, bool loop, LoadMode mode) {
+    auto sound = std::make_shared<Sound>();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    if (!ParseWav(bytes, size, size, sound->format)) {
+        ImGuiConsole::Cout("Software audio cannot decode a %s file, only PCM and float WAV", GetFileFormatName(data, size));
+        return InvalidID;
+    }
+    sound->mode = mode == LoadMode::COMPRESSED ? LoadMode::COMPRESSED : LoadMode::DECOMPRESSED;
+    sound->channels = sound->format.fileChannels > 1 ? 2 : 1;
+    sound->sampleRate = sound->format.sampleRate;
+    sound->frames = sound->format.dataBytes / sound->format.FrameBytes();
+    sound->loop = loop;
+
+    const unsigned char* pcm = bytes + sound->format.dataOffset;
+    if (sound->mode == LoadMode::COMPRESSED) {
+        // WAV has no compression of its own, so this keeps the samples as stored, 16-bit ones at half the size of floats
+        sound->encoded.assign(pcm, pcm + sound->frames * sound->format.FrameBytes());
+    }
+    else {
+        sound->samples.resize(sound->frames * sound->channels);
+        ConvertFrames(pcm, sound->frames, sound->format, sound->samples.data(), sound->channels);
+    }
+    return AddSound(std::move(sound));
+}
+
+// Reads the header of a WAV file; its samples are read from the file by each channel as it plays.
+AudioBackend::SoundID SoftwareAudioBackend::CreateStream(const std::string& path, bool loop) {
+    StreamingBufferManager& streaming = StreamingBufferManager::GetInstance();
+    std::shared_ptr<StreamingBufferManager::Stream> stream = streaming.OpenShared(path);
+    if (!stream) {
+        ImGuiConsole::Cout("Software audio could not open %s to stream", path.c_str());
+        return InvalidID;
+    }
+
+    // The format and data chunks come before the samples in any WAV file worth streaming
+    std::vector<unsigned char> header(static_cast<size_t>(std::min<uint64_t>(streaming.GetSize(stream.get()), 4096)));
+    header.resize(streaming.Read(stream.get(), header.data(), header.size()));
+
+    auto sound = std::make_shared<Sound>();
+    if (!ParseWav(header.data(), header.size(), static_cast<size_t>(streaming.GetSize(stream.get())), sound->format)) {
+        ImGuiConsole::Cout("Software audio cannot stream %s, a %s file, only PCM and float WAV", path.c_str(),
+            GetFileFormatName(header.data(), header.size()));
+        return InvalidID;
+    }
+    sound->mode = LoadMode::STREAMED;
+    sound->path = path;
+    sound->channels = sound->format.fileChannels > 1 ? 2 : 1;
+    sound->sampleRate = sound->format.sampleRate;
+    sound->frames = sound->format.dataBytes / sound->format.FrameBytes();
+    sound->loop = loop;
+    return AddSound(std::move(sound));
+}
+
+// Adds a created sound.
+AudioBackend::SoundID SoftwareAudioBackend::AddSound(std::shared_ptr<Sound> sound) {
+    std::lock_guard<std::mutex> lock(soundMutex);
+    SoundID id = nextSound++;
+    sounds.emplace(id, std::move(sound));
+    return id;
+}
+
+// Releases a sound and stops the channels playing it.
+void SoftwareAudioBackend::ReleaseSound(SoundID sound) {
+    {
+        std::lock_guard<std::mutex> lock(soundMutex);
+        sounds.erase(sound);
+    }
+    for (auto it = channels.begin(); it != channels.end(); ) {
+        it = it->second.soundID == sound ? channels.erase(it) : std::next(it);
+    }
+}
+
+// A streamed sound holds nothing itself; its buffers are counted by the StreamingBufferManager.
+AudioBackend::SoundMemory SoftwareAudioBackend::GetSoundMemory(SoundID sound) const {
+    std::lock_guard<std::mutex> lock(soundMutex);
+    SoundMemory memory;
+    auto it = sounds.find(sound);
+    if (it != sounds.end()) {
+        const Sound& found = *it->second;
+        memory.decoded = found.frames * found.channels * sizeof(float);
+        memory.resident = found.samples.size() * sizeof(float) + found.encoded.size();
+    }
+    return memory;
+}
+
+// Starts a channel, stealing the least important one if all are busy.
+AudioBackend::ChannelID SoftwareAudioBackend::Play(SoundID sound, bool paused) {
+    Channel channel;
+    {
+        std::lock_guard<std::mutex> lock(soundMutex);
+        auto it = sounds.find(sound);
+        if (it == sounds.end()) {
+            return InvalidID;
+        }
+        channel.sound = it->second;
+    }
+    if (channel.sound->mode == LoadMode::STREAMED) {
+        channel.stream = StreamingBufferManager::GetInstance().OpenShared(channel.sound->path);
+        if (!channel.stream) {
+            return InvalidID;
+        }
+    }
+    channel.soundID = sound;
+    channel.loop = channel.sound->loop;
+    channel.paused = paused;
+    channel.step = ((static_cast<uint64_t>(channel.sound->sampleRate) << 32) + sampleRate / 2) / static_cast<uint64_t>(sampleRate);
+
+    if (static_cast<int>(channels.size()) >= maxChannels) {
+        auto victim = std::max_element(channels.begin(), channels.end(), [](const auto& left, const auto& right) {
+            return left.second.priority != right.second.priority ? left.second.priority < right.second.priority : left.first > right.first;
+        });
+        channels.erase(victim);
+    }
+
+    ChannelID id = nextChannel++;
+    if (nextChannel == InvalidID) {
+        ++nextChannel;
+    }
+    channels.emplace(id, std::move(channel));
+    return id;
+}
+
+void SoftwareAudioBackend::Stop(ChannelID channel) {
+    channels.erase(channel);
+}
+
+bool SoftwareAudioBackend::IsPlaying(ChannelID channel) const {
+    return channels.find(channel) != channels.end();
+}
+
+AudioBackend::SoundID SoftwareAudioBackend::GetSound(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() ? it->second.soundID : InvalidID;
+}
+
+void SoftwareAudioBackend::SetPaused(ChannelID channel, bool paused) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.paused = paused;
+    }
+}
+
+bool SoftwareAudioBackend::IsPaused(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() && it->second.paused;
+}
+
+void SoftwareAudioBackend::SetVolume(ChannelID channel, float volume) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.volume = volume;
+    }
+}
+
+float SoftwareAudioBackend::GetVolume(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() ? it->second.volume : 0.0f;
+}
+
+void SoftwareAudioBackend::SetMute(ChannelID channel, bool mute) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.muted = mute;
+    }
+}
+
+void SoftwareAudioBackend::SetPriority(ChannelID channel, int priority) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.priority = priority;
+    }
+}
+
+void SoftwareAudioBackend::SetLooping(ChannelID channel, bool loop) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.loop = loop;
+    }
+}
+
+unsigned int SoftwareAudioBackend::GetPosition(ChannelID channel) const {
+    auto it = channels.find(channel);
+    if (it == channels.end()) {
+        return 0;
+    }
+    return static_cast<unsigned int>((it->second.position >> 32) * 1000 / static_cast<uint64_t>(it->second.sound->sampleRate));
+}
+
+void SoftwareAudioBackend::SetPosition(ChannelID channel, unsigned int milliseconds) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        uint64_t frame = static_cast<uint64_t>(milliseconds) * static_cast<uint64_t>(it->second.sound->sampleRate) / 1000;
+        it->second.position = std::min<uint64_t>(frame, it->second.sound->frames) << 32;
+    }
+}
+
+void SoftwareAudioBackend::SetLowPass(ChannelID channel, float cutoff) {
+    auto it = channels.find(channel);
+    if (it != channels.end()) {
+        it->second.lowPassCutoff = std::min(cutoff, LowPassOff);
+    }
+}
+
+float SoftwareAudioBackend::GetLowPass(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() ? it->second.lowPassCutoff : LowPassOff;
+}
+
+// Ramps the channel's fade gain one output frame at a time.
+void SoftwareAudioBackend::FadeTo(ChannelID channel, float target, float seconds, bool stopAtEnd) {
+    auto it = channels.find(channel);
+    if (it == channels.end()) {
+        return;
+    }
+    Channel& playing = it->second;
+    const size_t frames = static_cast<size_t>(std::llround(std::max(seconds, 0.0f) * static_cast<double>(sampleRate)));
+    if (frames == 0) {
+        if (stopAtEnd) {
+            channels.erase(it);
+            return;
+        }
+        playing.fade = target;
+    }
+    playing.fadeTarget = target;
+    playing.fadeFrames = frames;
+    playing.fadeStep = frames > 0 ? (target - playing.fade) / static_cast<float>(frames) : 0.0f;
+    playing.stopAtFadeEnd = stopAtEnd;
+}
+
+float SoftwareAudioBackend::GetFade(ChannelID channel) const {
+    auto it = channels.find(channel);
+    return it != channels.end() ? it->second.fade : 1.0f;
+}
+
+int SoftwareAudioBackend::GetChannelsPlaying() const {
+    return static_cast<int>(channels.size());
+}
+
+// Mixes an exact number of frames and sends them to the sink.
+const std::vector<float>& SoftwareAudioBackend::Render(size_t frames) {
+    const auto start = std::chrono::steady_clock::now();
+    mixBuffer.assign(frames * 2, 0.0f);
+
+    for (auto it = channels.begin(); it != channels.end(); ) {
+        Channel& channel = it->second;
+        if (channel.paused) {
+            ++it;
+            continue;
+        }
+
+        // A fade that stops the channel ends it on its last frame, not at the end of the block
+        const bool fadeEnds = channel.stopAtFadeEnd && channel.fadeFrames <= frames;
+        const size_t channelFrames = fadeEnds ? channel.fadeFrames : frames;
+        const size_t rampFrames = std::min(channel.fadeFrames, channelFrames);
+
+        bool playing = true;
+        const float gain = channel.muted ? 0.0f : channel.volume;
+        if (gain <= 0.0f || (rampFrames == 0 && channel.fade <= 0.0f)) {
+            // Virtual: keep time without resampling or mixing
+            playing = SkipChannel(channel, channelFrames);
+        }
+        else {
+            playing = ResampleChannel(channel, channelFrames);
+            MixRampInto(mixBuffer.data(), voiceBuffer.data(), rampFrames, gain * channel.fade, gain * channel.fadeStep);
+            MixInto(mixBuffer.data() + rampFrames * 2, voiceBuffer.data() + rampFrames * 2, (channelFrames - rampFrames) * 2,
+                gain * (rampFrames > 0 ? channel.fadeTarget : channel.fade));
+            stats.channelFrames += channelFrames;
+        }
+
+        channel.fadeFrames -= rampFrames;
+        channel.fade = channel.fadeFrames == 0 ? channel.fadeTarget : channel.fade + channel.fadeStep * static_cast<float>(rampFrames);
+
+        it = playing && !fadeEnds ? std::next(it) : channels.erase(it);
+    }
+
+    if (sink == Sink::WAV_FILE && wavFile.is_open()) {
+        outputBuffer.resize(frames * 2);
+        ConvertToPCM16(mixBuffer.data(), outputBuffer.data(), frames * 2);
+        wavFile.write(reinterpret_cast<const char*>(outputBuffer.data()), static_cast<std::streamsize>(outputBuffer.size() * sizeof(int16_t)));
+        wavFrames += frames;
+    }
+
+    stats.frames += frames;
+    stats.microseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    return mixBuffer;
+}
+
+// Resamples one channel into the voice buffer with linear interpolation and advances it.
+bool SoftwareAudioBackend::ResampleChannel(Channel& channel, size_t frames) {
+    voiceBuffer.assign(frames * 2, 0.0f);
+    const Sound& sound = *channel.sound;
+    if (sound.frames == 0) {
+        return false;
+    }
+    const uint64_t end = static_cast<uint64_t>(sound.frames) << 32;
+    const size_t right = sound.channels > 1 ? 1 : 0;
+    if (frames == 0) {
+        return channel.loop || channel.position < end;
+    }
+
+    // Fetch every source frame the block interpolates between, then walk them without wrapping
+    const size_t first = static_cast<size_t>(channel.position >> 32);
+    uint64_t offset = channel.position & (FixedOne - 1);
+    const size_t count = static_cast<size_t>((offset + channel.step * (frames - 1)) >> 32) + 2;
+    const float* samples = FetchFrames(channel, first, count);
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const size_t index = static_cast<size_t>(offset >> 32);
+        if (!channel.loop && first + index >= sound.frames) {
+            channel.position = end;
+            return false;
+        }
+        const float fraction = static_cast<float>(offset & (FixedOne - 1)) * (1.0f / 4294967296.0f);
+        const float* current = samples + index * sound.channels;
+        const float* following = current + sound.channels;
+        voiceBuffer[frame * 2] = current[0] + (following[0] - current[0]) * fraction;
+        voiceBuffer[frame * 2 + 1] = current[right] + (following[right] - current[right]) * fraction;
+        offset += channel.step;
+    }
+    channel.position = (static_cast<uint64_t>(first) << 32) + offset;
+    if (channel.loop && channel.position >= end) {
+        channel.position %= end;
+    }
+
+    if (channel.lowPassCutoff < LowPassOff) {
+        // One-pole low-pass, enough for the muffled music under the player's ability
+        const float alpha = 1.0f - static_cast<float>(std::exp(-2.0 * Pi * channel.lowPassCutoff / sampleRate));
+        for (size_t frame = 0; frame < frames; ++frame) {
+            for (size_t side = 0; side < 2; ++side) {
+                float& state = channel.lowPassState[side];
+                state += alpha * (voiceBuffer[frame * 2 + side] - state);
+                voiceBuffer[frame * 2 + side] = state;
+            }
+        }
+    }
+    return channel.loop || channel.position < end;
+}
+
+// Moves a channel's position on without mixing it, for silent channels.
+bool SoftwareAudioBackend::SkipChannel(Channel& channel, size_t frames) {
+    channel.position += channel.step * frames;
+    const uint64_t end = static_cast<uint64_t>(channel.sound->frames) << 32;
+    if (channel.position >= end) {
+        if (!channel.loop || end == 0) {
+            return false;
+        }
+        channel.position %= end;
+    }
+    return true;
+}
+
+// Retrieves consecutive source frames as float PCM, straight from a decoded sound when they do not wrap.
+const float* SoftwareAudioBackend::FetchFrames(Channel& channel, size_t first, size_t count) {
+    const Sound& sound = *channel.sound;
+    const size_t stride = static_cast<size_t>(sound.channels);
+    if (sound.mode == LoadMode::DECOMPRESSED && first + count <= sound.frames) {
+        return sound.samples.data() + first * stride;
+    }
+
+    sourceBuffer.resize(count * stride);
+    float* out = sourceBuffer.data();
+    for (size_t done = 0; done < count; ) {
+        size_t frame = first + done;
+        if (frame >= sound.frames) {
+            if (!channel.loop) {
+                // Past the end the last frame holds, as it does when interpolating towards the end
+                DecodeFrames(channel, sound.frames - 1, 1, out + done * stride);
+                for (size_t copy = done + 1; copy < count; ++copy) {
+                    std::copy_n(out + done * stride, stride, out + copy * stride);
+                }
+                break;
+            }
+            frame %= sound.frames;
+        }
+        const size_t run = std::min(count - done, sound.frames - frame);
+        DecodeFrames(channel, frame, run, out + done * stride);
+        done += run;
+    }
+    return sourceBuffer.data();
+}
+
+// Converts source frames that lie within the sound to float PCM.
+void SoftwareAudioBackend::DecodeFrames(Channel& channel, size_t first, size_t count, float* out) {
+    const Sound& sound = *channel.sound;
+    const size_t frameBytes = sound.format.FrameBytes();
+    switch (sound.mode) {
+    case LoadMode::DECOMPRESSED:
+        std::copy_n(sound.samples.data() + first * sound.channels, count * sound.channels, out);
+        break;
+    case LoadMode::COMPRESSED:
+        ConvertFrames(sound.encoded.data() + first * frameBytes, count, sound.format, out, sound.channels);
+        break;
+    case LoadMode::STREAMED: {
+        // Sequential blocks read on from where the last one stopped, so the stream's buffer is refilled only now and then
+        StreamingBufferManager& streaming = StreamingBufferManager::GetInstance();
+        streamBuffer.resize(count * frameBytes);
+        streaming.Seek(channel.stream.get(), sound.format.dataOffset + first * frameBytes);
+        const size_t read = streaming.Read(channel.stream.get(), streamBuffer.data(), streamBuffer.size()) / frameBytes;
+        ConvertFrames(streamBuffer.data(), read, sound.format, out, sound.channels);
+        std::fill(out + read * sound.channels, out + count * sound.channels, 0.0f);
+        break;
+    }
+    }
+}
+
+// Writes the WAV header, or patches its sizes once the length is known.
+void SoftwareAudioBackend::WriteWavHeader() {
+    const uint32_t dataBytes = static_cast<uint32_t>(std::min<uint64_t>(wavFrames * 4, 0xFFFFFFFFull - 36));
+    const std::streampos end = wavFile.tellp();
+    wavFile.seekp(0);
+    wavFile.write("RIFF", 4);
+    WriteU32(wavFile, 36 + dataBytes);
+    wavFile.write("WAVEfmt ", 8);
+    WriteU32(wavFile, 16);
+    WriteU16(wavFile, 1);                                       // PCM
+    WriteU16(wavFile, 2);                                       // Stereo
+    WriteU32(wavFile, static_cast<uint32_t>(sampleRate));
+    WriteU32(wavFile, static_cast<uint32_t>(sampleRate) * 4);   // Bytes per second
+    WriteU16(wavFile, 4);                                       // Bytes per frame
+    WriteU16(wavFile, 16);                                      // Bits per sample
+    wavFile.write("data", 4);
+    WriteU32(wavFile, dataBytes);
+    if (end > std::streampos(44)) {
+        wavFile.seekp(end);
+    }
+}
+
+// Decodes a PCM or float WAV file to interleaved float samples, keeping at most two channels.
+bool SoftwareAudioBackend::DecodeWav(const void* data, size_t size, std::vector<float>& samples, int& channels, int& rate) {
+    WavFormat format;
+    if (!ParseWav(static_cast<const unsigned char*>(data), size, size, format)) {
+        return false;
+    }
+    const size_t frames = format.dataBytes / format.FrameBytes();
+    channels = format.fileChannels > 1 ? 2 : 1;
+    rate = format.sampleRate;
+    samples.resize(frames * channels);
+    ConvertFrames(static_cast<const unsigned char*>(data) + format.dataOffset, frames, format, samples.data(), channels);
+    return true;
+}
+
+// Finds the format and data chunk of a WAV file from the bytes of it in memory.
+bool SoftwareAudioBackend::ParseWav(const unsigned char* bytes, size_t available, size_t size, WavFormat& result) {
+    if (!bytes || available < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    uint16_t format = 0, fileChannels = 0, bits = 0;
+    uint32_t fileRate = 0;
+    size_t dataOffset = 0;
+    size_t dataBytes = 0;
+    for (size_t offset = 12; offset + 8 <= available; ) {
+        const uint32_t chunkSize = ReadU32(bytes + offset + 4);
+        const unsigned char* chunk = bytes + offset + 8;
+        const size_t chunkBytes = std::min<size_t>(chunkSize, available - offset - 8);
+        if (std::memcmp(bytes + offset, "fmt ", 4) == 0 && chunkBytes >= 16) {
+            format = ReadU16(chunk);
+            fileChannels = ReadU16(chunk + 2);
+            fileRate = ReadU32(chunk + 4);
+            bits = ReadU16(chunk + 14);
+            if (format == 0xFFFE && chunkBytes >= 26) {
+                format = ReadU16(chunk + 24);   // WAVE_FORMAT_EXTENSIBLE keeps the real format in its sub-format
+            }
+        }
+        else if (std::memcmp(bytes + offset, "data", 4) == 0) {
+            // Measured against the whole file, as only the start of a streamed one is in memory
+            dataOffset = offset + 8;
+            dataBytes = std::min<size_t>(chunkSize, size - std::min(size, dataOffset));
+        }
+        offset += 8 + static_cast<size_t>(chunkSize) + (chunkSize & 1);
+    }
+
+    const bool isFloat = format == 3 && bits == 32;
+    const bool isInteger = format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    if (dataOffset == 0 || fileChannels == 0 || fileRate == 0 || (!isFloat && !isInteger)) {
+        return false;
+    }
+    result.fileChannels = fileChannels;
+    result.bits = bits;
+    result.isFloat = isFloat;
+    result.sampleRate = static_cast<int>(fileRate);
+    result.dataOffset = dataOffset;
+    result.dataBytes = dataBytes;
+    return true;
+}
+
+// Converts WAV samples to interleaved float samples, keeping at most two channels.
+void SoftwareAudioBackend::ConvertFrames(const unsigned char* pcm, size_t frames, const WavFormat& format, float* out, int outChannels) {
+    const size_t sampleBytes = static_cast<size_t>(format.bits / 8);
+    const size_t frameBytes = format.FrameBytes();
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (int side = 0; side < outChannels; ++side) {
+            const unsigned char* sample = pcm + frame * frameBytes + side * sampleBytes;
+            float value = 0.0f;
+            if (format.isFloat) {
+                uint32_t raw = ReadU32(sample);
+                std::memcpy(&value, &raw, sizeof(value));
+            }
+            else if (format.bits == 8) {
+                value = (static_cast<int>(sample[0]) - 128) / 128.0f;
+            }
+            else if (format.bits == 16) {
+                value = static_cast<int16_t>(ReadU16(sample)) / 32768.0f;
+            }
+            else if (format.bits == 24) {
+                int32_t raw = static_cast<int32_t>(static_cast<uint32_t>(sample[0] << 8) | (static_cast<uint32_t>(sample[1]) << 16) |
+                    (static_cast<uint32_t>(sample[2]) << 24)) >> 8;
+                value = raw / 8388608.0f;
+            }
+            else {
+                value = static_cast<float>(static_cast<int32_t>(ReadU32(sample)) / 2147483648.0);
+            }
+            out[frame * outChannels + side] = value;
+        }
+    }
+}
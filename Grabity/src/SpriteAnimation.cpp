@@ -28,7 +28,7 @@ currFrames(0)
 SpriteAnimation::SpriteAnimation(std::string codename, std::string spritePath, float numFrameX, float numFrameY, float numframePS)
 {
     // load the texture
-    if (AssetManager::GetInstance().IsTextureLoaded(codename))
+    if (AssetManager::GetInstance().IsTextureResident(codename))
         AssetManager::GetInstance().LoadTexture(codename, spritePath, numFrameX, numFrameY, numframePS);
 
     sprite = AssetManager::GetInstance().GetSprite(codename);
@@ -57,7 +57,7 @@ SpriteAnimation::SpriteAnimation(const SpriteAnimation& other)
 void SpriteAnimation::Init(std::string codename, std::string spritePath, float numFrameX, float numFrameY, float numframePS)
 {
     // load the texture
-    if (AssetManager::GetInstance().IsTextureLoaded(codename))
+    if (AssetManager::GetInstance().IsTextureResident(codename))
         AssetManager::GetInstance().LoadTexture(codename, spritePath, numFrameX, numFrameY, numframePS);
 
     sprite = AssetManager::GetInstance().GetSprite(codename);
@@ -0,0 +1,238 @@
+/*!****************************************************************
+\file: StartupGraph.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Runs engine initialisation as a small graph of named tasks.
+        Each task lists the tasks it depends on and starts as soon
+        as they have finished. Tasks that only use the CPU, such as
+        reading Lua files, loading audio or rasterising fonts, run
+        on a pool of worker threads. Tasks that touch OpenGL or GLFW
+        are pinned to the thread that calls Run, which owns the
+        context.
+
+        Every task is timed, so the startup timeline can be printed
+        to see what the first frame is waiting on.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "StartupGraph.h"
+#include "ImGuiConsole.h"
+#include <unordered_map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+
+/**
+ * \brief Adds a task to the graph.
+ * \param name Unique name of the task, used by dependencies and the report.
+ * \param task The work to do.
+ * \param dependencies Names of tasks that have to finish first. They may be added later.
+ * \param affinity Where the task may run.
+ */
+void StartupGraph::AddTask(const std::string& name, std::function<void()> task,
+    std::vector<std::string> dependencies, Affinity affinity) {
+    Task added;
+    added.name = name;
+    added.work = std::move(task);
+    added.dependencyNames = std::move(dependencies);
+    added.affinity = affinity;
+    tasks.push_back(std::move(added));
+}
+
+/**
+ * \brief Resolves dependency names and checks that every task can eventually run.
+ * \return True if the graph is complete and acyclic, false otherwise.
+ */
+bool StartupGraph::Resolve() {
+    std::unordered_map<std::string, size_t> indices;
+    for (size_t index = 0; index < tasks.size(); ++index) {
+        tasks[index].dependents.clear();
+        tasks[index].remainingDependencies = 0;
+        if (!indices.emplace(tasks[index].name, index).second) {
+            ImGuiConsole::Cout("Startup task %s is added twice", tasks[index].name.c_str());
+            return false;
+        }
+    }
+
+    for (size_t index = 0; index < tasks.size(); ++index) {
+        for (const std::string& dependency : tasks[index].dependencyNames) {
+            auto it = indices.find(dependency);
+            if (it == indices.end()) {
+                ImGuiConsole::Cout("Startup task %s depends on missing task %s", tasks[index].name.c_str(), dependency.c_str());
+                return false;
+            }
+            tasks[it->second].dependents.push_back(index);
+            ++tasks[index].remainingDependencies;
+        }
+    }
+
+    // Every task has to be reachable by repeatedly removing tasks without dependencies
+    std::vector<int> remaining(tasks.size());
+    std::vector<size_t> ready;
+    for (size_t index = 0; index < tasks.size(); ++index) {
+        remaining[index] = tasks[index].remainingDependencies;
+        if (remaining[index] == 0) {
+            ready.push_back(index);
+        }
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t index = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (size_t dependent : tasks[index].dependents) {
+            if (--remaining[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (visited != tasks.size()) {
+        ImGuiConsole::Cout("Startup tasks depend on each other in a cycle");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Runs every task, in parallel where the dependencies allow it, and returns
+ *        once all have finished. Must be called from the thread that owns the OpenGL context.
+ * \param workerCount Worker threads to start, at least one. 0 uses one less than the hardware threads.
+ * \return False if a dependency is missing or the graph has a cycle, in which case nothing runs.
+ */
+bool StartupGraph::Run(unsigned int workerCount) {
+    timeline.clear();
+    totalMilliseconds = 0.0;
+    if (!Resolve()) {
+        return false;
+    }
+
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    std::mutex mutex;
+    std::condition_variable readyCondition;
+    std::deque<size_t> mainQueue;
+    std::deque<size_t> workerQueue;
+    size_t finished = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsedMilliseconds = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto enqueue = [&](size_t index) {
+        (tasks[index].affinity == Affinity::MAIN_THREAD ? mainQueue : workerQueue).push_back(index);
+    };
+
+    // Runs one task outside the lock, then releases the tasks waiting on it
+    auto execute = [&](size_t index, int thread) {
+        Task& task = tasks[index];
+        task.timing.name = task.name;
+        task.timing.thread = thread;
+        task.timing.startMilliseconds = elapsedMilliseconds();
+        try {
+            if (task.work) {
+                task.work();
+            }
+        }
+        catch (const std::exception& e) {
+            ImGuiConsole::Cout("Startup task %s failed: %s", task.name.c_str(), e.what());
+        }
+        task.timing.endMilliseconds = elapsedMilliseconds();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t dependent : task.dependents) {
+            if (--tasks[dependent].remainingDependencies == 0) {
+                enqueue(dependent);
+            }
+        }
+        ++finished;
+        readyCondition.notify_all();
+    };
+
+    for (size_t index = 0; index < tasks.size(); ++index) {
+        if (tasks[index].remainingDependencies == 0) {
+            enqueue(index);
+        }
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (unsigned int worker = 0; worker < workerCount; ++worker) {
+        workers.emplace_back([&, worker]() {
+            for (;;) {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    readyCondition.wait(lock, [&]() { return !workerQueue.empty() || finished == tasks.size(); });
+                    if (workerQueue.empty()) {
+                        return;
+                    }
+                    index = workerQueue.front();
+                    workerQueue.pop_front();
+                }
+                execute(index, static_cast<int>(worker) + 1);
+            }
+        });
+    }
+
+    // The main thread only runs its pinned tasks, so a long worker task never delays the OpenGL work
+    for (;;) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            readyCondition.wait(lock, [&]() { return !mainQueue.empty() || finished == tasks.size(); });
+            if (mainQueue.empty()) {
+                break;
+            }
+            index = mainQueue.front();
+            mainQueue.pop_front();
+        }
+        execute(index, 0);
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    totalMilliseconds = elapsedMilliseconds();
+
+    timeline.reserve(tasks.size());
+    for (const Task& task : tasks) {
+        timeline.push_back(task.timing);
+    }
+    std::sort(timeline.begin(), timeline.end(),
+        [](const TaskTiming& left, const TaskTiming& right) { return left.startMilliseconds < right.startMilliseconds; });
+    tasks.clear();
+    return true;
+}
+
+/**
+ * \brief Prints the timeline of the last Run to the console.
+ * \param title Printed above the timeline.
+ */
+void StartupGraph::Report(const char* title) const {
+    double serialMilliseconds = 0.0;
+    for (const TaskTiming& timing : timeline) {
+        serialMilliseconds += timing.endMilliseconds - timing.startMilliseconds;
+    }
+    ImGuiConsole::Cout("%s: %.1f ms for %zu tasks, %.1f ms if run one after another",
+        title, totalMilliseconds, timeline.size(), serialMilliseconds);
+    for (const TaskTiming& timing : timeline) {
+        const double duration = timing.endMilliseconds - timing.startMilliseconds;
+        if (timing.thread == 0) {
+            ImGuiConsole::Cout("  %-20s %8.1f -> %8.1f ms (%6.1f ms) on main", timing.name.c_str(),
+                timing.startMilliseconds, timing.endMilliseconds, duration);
+        }
+        else {
+            ImGuiConsole::Cout("  %-20s %8.1f -> %8.1f ms (%6.1f ms) on worker %d", timing.name.c_str(),
+                timing.startMilliseconds, timing.endMilliseconds, duration, timing.thread);
+        }
+    }
+}
@@ -0,0 +1,233 @@
+/*!****************************************************************
+\file: StreamingBufferManager.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the StreamingBufferManager, which serves the files
+        of streamed sounds a little at a time: loose files through a
+        pooled read buffer, files stored in the asset pack straight
+        from its mapping.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "StreamingBufferManager.h"
+#include "VirtualFileSystem.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * \brief Retrieves the streaming buffer manager instance.
+ * \return Reference to the manager.
+ */
+StreamingBufferManager& StreamingBufferManager::GetInstance() {
+    static StreamingBufferManager instance;
+    return instance;
+}
+
+StreamingBufferManager::~StreamingBufferManager() = default;
+
+/**
+ * \brief Opens a file for streaming, from the mounted pack or from disk.
+ * \param path The path of the file.
+ * \return The stream, or nullptr if the file does not exist.
+ */
+StreamingBufferManager::Stream* StreamingBufferManager::Open(const std::string& path) {
+    auto stream = std::make_unique<Stream>();
+    VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+
+    if (vfs.FindStored(path, stream->mapped, stream->size)) {
+        // Read from the mapping as it plays, no buffer needed
+    }
+    else if (vfs.IsPacked(path)) {
+        // A compressed entry cannot be read from the middle, so it is streamed from a full copy
+        VirtualFile whole = vfs.Open(path);
+        if (!whole) {
+            return nullptr;
+        }
+        stream->buffer.assign(whole.GetData(), whole.GetData() + whole.GetSize());
+        stream->mapped = stream->buffer.data();
+        stream->size = stream->buffer.size();
+#ifdef _LOGGING
+        ImGuiConsole::Cout("Streaming %s from memory, it is compressed in the asset pack", path.c_str());
+#endif // _LOGGING
+    }
+    else {
+        stream->file.open(path, std::ios::binary | std::ios::ate);
+        if (!stream->file.is_open()) {
+            return nullptr;
+        }
+        stream->size = static_cast<uint64_t>(std::max<std::streamoff>(stream->file.tellg(), 0));
+        stream->buffer = AcquireBuffer();
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    ++openStreams;
+    peakStreams = std::max(peakStreams, openStreams);
+    return stream.release();
+}
+
+/**
+ * \brief Closes a stream and returns its buffer to the pool.
+ * \param stream The stream. nullptr is ignored.
+ */
+void StreamingBufferManager::Close(Stream* stream) {
+    if (!stream) {
+        return;
+    }
+    std::unique_ptr<Stream> closing(stream);
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (closing->file.is_open()) {
+        if (closing->buffer.size() == bufferSize) {
+            freeBuffers.push_back(std::move(closing->buffer));
+        }
+        else {
+            pooledBytes -= closing->buffer.size();  // Sized before SetBufferSize, not worth keeping
+        }
+    }
+    --openStreams;
+}
+
+/**
+ * \brief Opens a stream that closes itself when the last copy of the pointer goes.
+ * \param path The path of the file.
+ * \return The stream, or nullptr if the file does not exist.
+ */
+std::shared_ptr<StreamingBufferManager::Stream> StreamingBufferManager::OpenShared(const std::string& path) {
+    Stream* stream = Open(path);
+    if (!stream) {
+        return nullptr;
+    }
+    return std::shared_ptr<Stream>(stream, [this](Stream* closing) { Close(closing); });
+}
+
+/**
+ * \brief Retrieves the size of a stream's file.
+ * \param stream The stream.
+ * \return The size in bytes.
+ */
+uint64_t StreamingBufferManager::GetSize(const Stream* stream) const {
+    return stream ? stream->size : 0;
+}
+
+/**
+ * \brief Reads from the stream's position and advances it.
+ * \param stream The stream.
+ * \param destination Receives the bytes.
+ * \param bytes The number of bytes wanted.
+ * \return The number of bytes read, less than wanted only at the end of the file.
+ */
+size_t StreamingBufferManager::Read(Stream* stream, void* destination, size_t bytes) {
+    if (!stream) {
+        return 0;
+    }
+    unsigned char* out = static_cast<unsigned char*>(destination);
+    size_t total = 0;
+    bytes = static_cast<size_t>(std::min<uint64_t>(bytes, stream->size - std::min(stream->position, stream->size)));
+
+    if (stream->mapped) {
+        std::memcpy(out, stream->mapped + stream->position, bytes);
+        total = bytes;
+        stream->position += total;
+    }
+    else {
+        while (total < bytes) {
+            const bool buffered = stream->position >= stream->bufferStart && stream->position < stream->bufferStart + stream->bufferFilled;
+            if (!buffered) {
+                // Refill from the position, so sequential playback reads the file once in buffer-sized pieces
+                const size_t wanted = static_cast<size_t>(std::min<uint64_t>(stream->buffer.size(), stream->size - stream->position));
+                stream->file.clear();
+                stream->file.seekg(static_cast<std::streamoff>(stream->position));
+                stream->file.read(reinterpret_cast<char*>(stream->buffer.data()), static_cast<std::streamsize>(wanted));
+                stream->bufferStart = stream->position;
+                stream->bufferFilled = static_cast<size_t>(stream->file.gcount());
+                ++refills;
+                diskBytes += stream->bufferFilled;
+                if (stream->bufferFilled == 0) {
+                    break;
+                }
+            }
+            const size_t offset = static_cast<size_t>(stream->position - stream->bufferStart);
+            const size_t count = std::min(bytes - total, stream->bufferFilled - offset);
+            std::memcpy(out + total, stream->buffer.data() + offset, count);
+            total += count;
+            stream->position += count;
+        }
+    }
+    bytesRead += total;
+    return total;
+}
+
+/**
+ * \brief Moves the stream's position.
+ * \param stream The stream.
+ * \param position The position in bytes from the start of the file.
+ * \return False if the position is past the end of the file.
+ */
+bool StreamingBufferManager::Seek(Stream* stream, uint64_t position) {
+    if (!stream || position > stream->size) {
+        return false;
+    }
+    stream->position = position;
+    return true;
+}
+
+/**
+ * \brief Sets the size of the buffer each loose-file stream reads through.
+ * \param bytes The buffer size in bytes.
+ */
+void StreamingBufferManager::SetBufferSize(size_t bytes) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    bufferSize = std::max<size_t>(bytes, 4096);
+    for (const std::vector<unsigned char>& buffer : freeBuffers) {
+        pooledBytes -= buffer.size();
+    }
+    freeBuffers.clear();
+}
+
+/**
+ * \brief Retrieves the counters.
+ * \return A copy of the counters.
+ */
+StreamingBufferManager::Stats StreamingBufferManager::GetStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stats.openStreams = openStreams;
+        stats.peakStreams = peakStreams;
+        stats.bufferBytes = pooledBytes;
+    }
+    stats.bytesRead = bytesRead.load();
+    stats.diskBytes = diskBytes.load();
+    stats.refills = refills.load();
+    return stats;
+}
+
+/**
+ * \brief Clears the read counters and the peak stream count.
+ */
+void StreamingBufferManager::ResetStats() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        peakStreams = openStreams;
+    }
+    bytesRead = 0;
+    diskBytes = 0;
+    refills = 0;
+}
+
+/**
+ * \brief Takes a buffer from the pool, allocating one if the pool is empty.
+ * \return The buffer.
+ */
+std::vector<unsigned char> StreamingBufferManager::AcquireBuffer() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (!freeBuffers.empty()) {
+        std::vector<unsigned char> buffer = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+        return buffer;
+    }
+    pooledBytes += bufferSize;
+    return std::vector<unsigned char>(bufferSize);
+}
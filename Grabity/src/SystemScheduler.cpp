@@ -0,0 +1,169 @@
+/*!****************************************************************
+\file: SystemScheduler.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the SystemScheduler. Each system counts down the
+        systems waiting on it when it finishes, and the last one to
+        finish queues the waiting system, so a system starts as soon
+        as everything it conflicts with is done. The main thread
+        waits for the frame by running jobs itself.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "SystemScheduler.h"
+#include "ImGuiConsole.h"
+#include <algorithm>
+#include <exception>
+
+#ifdef _LOGGING
+#include "SystemLogging.h"
+#endif // _LOGGING
+
+/**
+ * \brief Retrieves the scheduler instance.
+ * \return Reference to the scheduler.
+ */
+SystemScheduler& SystemScheduler::GetInstance() {
+    static SystemScheduler instance;
+    return instance;
+}
+
+/**
+ * \brief Adds a system the caller keeps alive. Systems run in the order they are added
+ *        wherever they conflict.
+ * \param system The system.
+ */
+void SystemScheduler::Add(System& system) {
+    systems.push_back(&system);
+    remaining = std::make_unique<std::atomic<int>[]>(systems.size());
+}
+
+/**
+ * \brief Adds a system the scheduler owns.
+ * \param system The system.
+ * \return The system.
+ */
+System& SystemScheduler::Add(std::unique_ptr<System> system) {
+    System& added = *system;
+    ownedSystems.push_back(std::move(system));
+    systems.push_back(&added);
+    remaining = std::make_unique<std::atomic<int>[]>(systems.size());
+    return added;
+}
+
+/**
+ * \brief Removes every system.
+ */
+void SystemScheduler::Clear() {
+    systems.clear();
+    ownedSystems.clear();
+    dependents.clear();
+    remaining.reset();
+    timeline.clear();
+    frameTime = 0.0;
+}
+
+/**
+ * \brief Runs every system once and returns when all of them have finished.
+ *        Called from the main thread.
+ */
+void SystemScheduler::Run() {
+    JobSystem& jobs = JobSystem::GetInstance();
+    BuildGraph();
+    lastSerial = serial || jobs.GetWorkerCount() == 0;
+    frameStart = std::chrono::steady_clock::now();
+
+    if (lastSerial) {
+        for (size_t index = 0; index < systems.size(); ++index) {
+            UpdateSystem(index);
+        }
+    }
+    else {
+        JobSystem::Counter frame;
+        frameCounter = &frame;
+        for (size_t index = 0; index < systems.size(); ++index) {
+            if (remaining[index].load(std::memory_order_relaxed) == 0) {
+                Queue(index);
+            }
+        }
+        jobs.Wait(frame);
+        frameCounter = nullptr;
+    }
+
+    frameTime = 0.0;
+    for (const SystemTiming& timing : timeline) {
+        frameTime = std::max(frameTime, timing.end);
+    }
+#ifdef _LOGGING
+    // The log is not thread-safe, so the times go in once every system is done
+    for (const SystemTiming& timing : timeline) {
+        SystemLogManager::GetInstance().SetAverage(timing.name, timing.end - timing.start);
+    }
+#endif // _LOGGING
+}
+
+/**
+ * \brief Finds the earlier systems each system conflicts with.
+ */
+void SystemScheduler::BuildGraph() {
+    const size_t count = systems.size();
+    dependents.resize(count);
+    timeline.resize(count);
+
+    for (size_t index = 0; index < count; ++index) {
+        dependents[index].clear();
+        SystemTiming& timing = timeline[index];
+        timing.name = systems[index]->GetName();
+        timing.dependencies.clear();
+    }
+    for (size_t later = 0; later < count; ++later) {
+        const System::Access& access = systems[later]->GetAccess();
+        for (size_t earlier = 0; earlier < later; ++earlier) {
+            if (access.ConflictsWith(systems[earlier]->GetAccess())) {
+                dependents[earlier].push_back(later);
+                timeline[later].dependencies.push_back(earlier);
+            }
+        }
+        remaining[later].store(static_cast<int>(timeline[later].dependencies.size()), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * \brief Runs one system and records its timing.
+ * \param index The system's index.
+ */
+void SystemScheduler::UpdateSystem(size_t index) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    SystemTiming& timing = timeline[index];
+    timing.thread = JobSystem::GetInstance().GetThreadIndex();
+    timing.start = Milliseconds(std::chrono::steady_clock::now() - frameStart).count();
+    try {
+        systems[index]->Update();
+    }
+    catch (const std::exception& e) {
+        // Caught here so the systems waiting on this one still run
+        ImGuiConsole::Cout("System %s failed: %s", timing.name, e.what());
+    }
+    timing.end = Milliseconds(std::chrono::steady_clock::now() - frameStart).count();
+}
+
+/**
+ * \brief Queues a system whose dependencies have finished.
+ * \param index The system's index.
+ */
+void SystemScheduler::Queue(size_t index) {
+    const JobSystem::Affinity affinity = systems[index]->GetAccess().mainThread
+        ? JobSystem::Affinity::MAIN_THREAD : JobSystem::Affinity::ANY_THREAD;
+
+    JobSystem::GetInstance().Run([this, index]() {
+        UpdateSystem(index);
+        // Queued before this job counts the frame down, so the frame cannot finish early
+        for (size_t later : dependents[index]) {
+            if (remaining[later].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Queue(later);
+            }
+        }
+    }, frameCounter, affinity, systems[index]->GetName());
+}
@@ -15,6 +15,7 @@ Technology is prohibited.
 #include "Texture.h"
 #include "glhelper.h"
 #include "External Lib/stb_image.h"
+#include "VirtualFileSystem.h"
 
 #ifdef _IMGUI
 #include <iostream>
@@ -73,8 +74,10 @@ Texture::Texture(std::string codename, const std::string& path, float numFrameX,
 	// flip the image upon loading to match OpenGL's coordinate system
 	stbi_set_flip_vertically_on_load(1);
 
-	// load the image data into the local buffer
-	mLocalBuffer = stbi_load(path.c_str(), &mWidth, &mHeight, &mBPP, 4);
+	// load the image data into the local buffer, from the asset pack if it is mounted
+	VirtualFile file = VirtualFileSystem::GetInstance().Open(path);
+	if (file && file.GetSize() > 0)
+		mLocalBuffer = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &mWidth, &mHeight, &mBPP, 4);
 
 	glBindTexture(GL_TEXTURE_2D, mRendererID);
 
@@ -98,6 +101,70 @@ Texture::Texture(std::string codename, const std::string& path, float numFrameX,
 	texSlot = totalTexType;
 }
 
+// constructor for an image decoded ahead of time, e.g. by a scene preload
+Texture::Texture(std::string codename, const std::string& path, const DecodedImage& image, float numFrameX, float numFrameY, float numframePS)
+{
+	codeName = codename;
+	nxFrames = numFrameX;
+	nyFrames = numFrameY;
+	framePS = numframePS;
+	totalFrames = numFrameX * numFrameY;
+	isAnimtation = (totalFrames == 1) ? false : true;
+
+	mFilePath = path;
+	mLocalBuffer = nullptr;
+	mWidth = 0;
+	mHeight = 0;
+	mBPP = 0;
+	mRendererID = 0;
+
+	glGenTextures(1, &mRendererID);
+	Upload(image);
+
+	totalTexType += 1;
+	texSlot = totalTexType;
+}
+
+// frees pixels allocated by stb_image
+void Texture::PixelDeleter::operator()(unsigned char* pixels) const
+{
+	stbi_image_free(pixels);
+}
+
+// decode an image file into RGBA8 pixels without touching OpenGL
+bool Texture::Decode(const std::string& path, DecodedImage& image)
+{
+	// the flip setting is per thread, so workers do not race with the main thread's loads
+	stbi_set_flip_vertically_on_load_thread(1);
+
+	int bpp = 0;
+	VirtualFile file = VirtualFileSystem::GetInstance().Open(path);
+	if (file && file.GetSize() > 0)
+		image.pixels.reset(stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &image.width, &image.height, &bpp, 4));
+	return image.pixels != nullptr;
+}
+
+// upload decoded pixels into this texture, keeping its id so everything holding it sees the new image
+void Texture::Upload(const DecodedImage& image)
+{
+	mWidth = image.pixels ? image.width : 0;
+	mHeight = image.pixels ? image.height : 0;
+	mBPP = 4;
+
+	glBindTexture(GL_TEXTURE_2D, mRendererID);
+
+	// set texture options
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.get());
+
+	// unbind it upon finished modifying
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 // load the texture data based on the file path
 void Texture::Init(const std::string& path)
 {
@@ -113,8 +180,10 @@ void Texture::Init(const std::string& path)
 	// flip the image upon loading to match OpenGL's coordinate system
 	stbi_set_flip_vertically_on_load(1);
 
-	// load the image data into the local buffer
-	mLocalBuffer = stbi_load(path.c_str(), &mWidth, &mHeight, &mBPP, 4);
+	// load the image data into the local buffer, from the asset pack if it is mounted
+	VirtualFile file = VirtualFileSystem::GetInstance().Open(path);
+	if (file && file.GetSize() > 0)
+		mLocalBuffer = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &mWidth, &mHeight, &mBPP, 4);
 
 	glBindTexture(GL_TEXTURE_2D, mRendererID);
 
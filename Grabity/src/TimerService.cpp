@@ -0,0 +1,386 @@
+/*!****************************************************************
+\file: TimerService.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Defines the TimerService. Timers are kept in one vector and
+        chained into their slot through indices, so a slot is a pair
+        of indices and a cancelled timer unlinks itself without a
+        search. Expired timers are released before any callback runs,
+        so callbacks are free to schedule and cancel.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TimerService.h"
+#include <cmath>
+
+/**
+ * \brief Retrieves the timer service instance.
+ * \return Reference to the timer service.
+ */
+TimerService& TimerService::GetInstance() {
+    static TimerService instance;
+    return instance;
+}
+
+/**
+ * \brief Sets the length of one tick. Timers already scheduled keep their tick.
+ * \param seconds The fixed step in seconds.
+ */
+void TimerService::SetTickLength(double seconds) {
+    if (seconds > 0.0) {
+        tickLength = seconds;
+    }
+}
+
+/**
+ * \brief Registers a callback for a kind of timer.
+ * \param name Shown in the editor.
+ * \param callback Called with the payloads of every timer of the channel that expired in a tick.
+ * \return The channel.
+ */
+TimerService::ChannelID TimerService::RegisterChannel(const std::string& name, BatchCallback callback) {
+    channels.push_back(Channel{ name, std::move(callback), {} });
+    return static_cast<ChannelID>(channels.size() - 1);
+}
+
+/**
+ * \brief Schedules a timer that hands a payload to a channel.
+ * \param delay Seconds from now, rounded up to whole ticks, at least one.
+ * \param channel The channel.
+ * \param payload Passed to the channel's callback.
+ * \return The timer's handle.
+ */
+TimerService::Handle TimerService::Schedule(double delay, ChannelID channel, uint64_t payload) {
+    return ScheduleTicks(ToTicks(delay), channel, payload);
+}
+
+/**
+ * \brief Schedules a timer that calls a function.
+ * \param delay Seconds from now, rounded up to whole ticks, at least one.
+ * \param action Called when the timer expires.
+ * \return The timer's handle.
+ */
+TimerService::Handle TimerService::Schedule(double delay, std::function<void()> action) {
+    const uint32_t index = Allocate(ToTicks(delay));
+    timers[index].action = std::move(action);
+    Insert(index);
+    return Handle{ index, timers[index].generation };
+}
+
+/**
+ * \brief Schedules a timer that hands a payload to a channel, in ticks.
+ * \param ticks Ticks from now, at least one.
+ * \param channel The channel.
+ * \param payload Passed to the channel's callback.
+ * \return The timer's handle.
+ */
+TimerService::Handle TimerService::ScheduleTicks(uint64_t ticks, ChannelID channel, uint64_t payload) {
+    const uint32_t index = Allocate(ticks);
+    timers[index].channel = channel;
+    timers[index].payload = payload;
+    Insert(index);
+    return Handle{ index, timers[index].generation };
+}
+
+/**
+ * \brief Stops a timer from expiring. A timer that already expired in the tick being
+ *        dispatched still reaches its callback.
+ * \param handle The timer. Cleared so it refers to nothing.
+ * \return True if the timer was pending.
+ */
+bool TimerService::Cancel(Handle& handle) {
+    const bool pending = IsPending(handle);
+    if (pending) {
+        Unlink(handle.index);
+        Release(handle.index);
+        ++stats.cancelled;
+    }
+    handle = Handle{};
+    return pending;
+}
+
+/**
+ * \brief Cancels every timer of a channel.
+ * \param channel The channel.
+ * \return The number of timers cancelled.
+ */
+size_t TimerService::CancelChannel(ChannelID channel) {
+    size_t count = 0;
+    for (uint32_t index = 0; index < static_cast<uint32_t>(timers.size()); ++index) {
+        if (timers[index].slot != None && timers[index].channel == channel) {
+            Unlink(index);
+            Release(index);
+            ++count;
+        }
+    }
+    stats.cancelled += count;
+    return count;
+}
+
+/**
+ * \brief Checks if a timer has yet to expire.
+ * \param handle The timer.
+ * \return True while it is pending.
+ */
+bool TimerService::IsPending(Handle handle) const {
+    return handle.index < timers.size()
+        && timers[handle.index].generation == handle.generation
+        && timers[handle.index].slot != None;
+}
+
+/**
+ * \brief Retrieves the time left on a timer.
+ * \param handle The timer.
+ * \return Seconds until it expires, 0 if it is not pending.
+ */
+double TimerService::GetRemaining(Handle handle) const {
+    if (!IsPending(handle)) {
+        return 0.0;
+    }
+    return static_cast<double>(timers[handle.index].expires - currentTick) * tickLength;
+}
+
+/**
+ * \brief Moves time on and expires the timers that are due, one tick at a time.
+ * \param ticks The number of ticks, normally the frame's fixed steps.
+ */
+void TimerService::Advance(int ticks) {
+    for (int tick = 0; tick < ticks; ++tick) {
+        ++currentTick;
+
+        // Bring down the upper-level slots whose span starts now, so their timers reach level 0 in time.
+        // Lowest level first: a timer from higher up was scheduled before those from lower levels due on
+        // the same tick, and going in last puts it in front of them. None land in a slot emptied this
+        // tick, as a timer due within 256 ticks goes straight to level 0
+        for (int level = 1; level < Levels; ++level) {
+            const uint64_t span = uint64_t(1) << (LevelBits * level);
+            if ((currentTick & (span - 1)) == 0) {
+                Cascade(level, static_cast<uint32_t>((currentTick >> (LevelBits * level)) & (SlotsPerLevel - 1)));
+            }
+        }
+
+        Slot& due = slots[currentTick & (SlotsPerLevel - 1)];
+        if (due.head == None) {
+            continue;
+        }
+        expiring.clear();
+        for (uint32_t index = due.head; index != None; index = timers[index].next) {
+            expiring.push_back(index);
+        }
+        due = Slot{};
+
+        for (uint32_t index : expiring) {
+            Timer& timer = timers[index];
+            if (timer.channel != NoChannel && timer.channel < channels.size()) {
+                channels[timer.channel].batch.push_back(timer.payload);
+            }
+            else if (timer.action) {
+                actions.push_back(std::move(timer.action));
+            }
+            Release(index);
+        }
+        stats.expired += expiring.size();
+
+        // Everything expiring is released, so the callbacks may schedule and cancel freely
+        std::vector<std::function<void()>> running;
+        running.swap(actions);
+        for (std::function<void()>& action : running) {
+            action();
+        }
+        running.clear();
+        if (actions.empty()) {
+            actions.swap(running);  // Keep the capacity
+        }
+
+        std::vector<uint64_t> payloads;
+        for (size_t channel = 0; channel < channels.size(); ++channel) {
+            if (channels[channel].batch.empty()) {
+                continue;
+            }
+            payloads.swap(channels[channel].batch);
+            ++stats.batches;
+            if (channels[channel].callback) {
+                channels[channel].callback(payloads);
+            }
+            payloads.clear();
+            if (channels[channel].batch.empty()) {
+                channels[channel].batch.swap(payloads);
+            }
+        }
+    }
+}
+
+/**
+ * \brief Retrieves the name of a channel.
+ * \param channel The channel.
+ * \return The name, empty for an unknown channel.
+ */
+const std::string& TimerService::GetChannelName(ChannelID channel) const {
+    static const std::string unknown;
+    return channel < channels.size() ? channels[channel].name : unknown;
+}
+
+/**
+ * \brief Retrieves the counters.
+ * \return A copy of the counters.
+ */
+TimerService::Stats TimerService::GetStats() const {
+    return stats;
+}
+
+/**
+ * \brief Clears the counters.
+ */
+void TimerService::ResetStats() {
+    const size_t pending = stats.pending;
+    stats = Stats{};
+    stats.pending = pending;
+}
+
+/**
+ * \brief Takes a free timer and sets its expiry.
+ * \param ticks Ticks from now, at least one.
+ * \return The timer's index.
+ */
+uint32_t TimerService::Allocate(uint64_t ticks) {
+    uint32_t index = freeList;
+    if (index != None) {
+        freeList = timers[index].next;
+    }
+    else {
+        index = static_cast<uint32_t>(timers.size());
+        timers.emplace_back();
+    }
+    Timer& timer = timers[index];
+    timer.expires = currentTick + (ticks > 0 ? ticks : 1);
+    timer.channel = NoChannel;
+    timer.payload = 0;
+    timer.prev = None;
+    timer.next = None;
+    ++stats.scheduled;
+    ++stats.pending;
+    return index;
+}
+
+/**
+ * \brief Returns a timer to the free list, which invalidates its handles.
+ * \param index The timer.
+ */
+void TimerService::Release(uint32_t index) {
+    Timer& timer = timers[index];
+    timer.action = nullptr;
+    timer.slot = None;
+    timer.prev = None;
+    ++timer.generation;
+    timer.next = freeList;
+    freeList = index;
+    --stats.pending;
+}
+
+/**
+ * \brief Puts a timer in the slot for its expiry.
+ * \param index The timer.
+ * \param atFront Put it before the timers already in the slot instead of after them.
+ */
+void TimerService::Insert(uint32_t index, bool atFront) {
+    Timer& timer = timers[index];
+    uint64_t delta = timer.expires - currentTick;
+    const uint64_t reach = uint64_t(1) << (LevelBits * Levels);
+    if (delta >= reach) {
+        // Past the top level: wait as long as it reaches, which is over two years at 60 ticks a second
+        delta = reach - 1;
+        timer.expires = currentTick + delta;
+    }
+
+    int level = 0;
+    while (level < Levels - 1 && delta >= (uint64_t(1) << (LevelBits * (level + 1)))) {
+        ++level;
+    }
+    timer.slot = static_cast<uint32_t>(level) * SlotsPerLevel
+        + static_cast<uint32_t>((timer.expires >> (LevelBits * level)) & (SlotsPerLevel - 1));
+
+    // Appended, so timers due on the same tick expire in the order they were scheduled
+    Slot& slot = slots[timer.slot];
+    if (atFront) {
+        timer.prev = None;
+        timer.next = slot.head;
+        if (slot.head != None) {
+            timers[slot.head].prev = index;
+        }
+        else {
+            slot.tail = index;
+        }
+        slot.head = index;
+        return;
+    }
+    timer.prev = slot.tail;
+    timer.next = None;
+    if (slot.tail != None) {
+        timers[slot.tail].next = index;
+    }
+    else {
+        slot.head = index;
+    }
+    slot.tail = index;
+}
+
+/**
+ * \brief Takes a timer out of its slot.
+ * \param index The timer.
+ */
+void TimerService::Unlink(uint32_t index) {
+    Timer& timer = timers[index];
+    Slot& slot = slots[timer.slot];
+    if (timer.prev != None) {
+        timers[timer.prev].next = timer.next;
+    }
+    else {
+        slot.head = timer.next;
+    }
+    if (timer.next != None) {
+        timers[timer.next].prev = timer.prev;
+    }
+    else {
+        slot.tail = timer.prev;
+    }
+    timer.prev = None;
+    timer.next = None;
+}
+
+/**
+ * \brief Moves the timers of an upper-level slot down to the levels below.
+ * \param level The level.
+ * \param slot The slot within the level.
+ */
+void TimerService::Cascade(int level, uint32_t slot) {
+    // A timer this far up was scheduled before any timer that went straight into a lower slot for
+    // the same tick, so it goes in front of them. Walking from the back keeps the cascaded ones in order.
+    Slot& source = slots[static_cast<uint32_t>(level) * SlotsPerLevel + slot];
+    uint32_t index = source.tail;
+    source = Slot{};
+    while (index != None) {
+        const uint32_t prev = timers[index].prev;
+        Insert(index, true);
+        ++stats.cascaded;
+        index = prev;
+    }
+}
+
+/**
+ * \brief Converts a delay to ticks.
+ * \param delay Seconds.
+ * \return Ticks, at least one.
+ */
+uint64_t TimerService::ToTicks(double delay) const {
+    if (!(delay > 0.0)) {
+        return 1;
+    }
+    // Slack so a delay of a whole number of ticks is not rounded up to the next one
+    const double ticks = std::ceil(delay / tickLength - 1e-6);
+    if (ticks >= 4294967296.0) {
+        return uint64_t(1) << 32;   // Past the top level anyway, Insert clamps it
+    }
+    return ticks < 1.0 ? 1 : static_cast<uint64_t>(ticks);
+}
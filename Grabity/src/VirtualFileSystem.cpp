@@ -0,0 +1,195 @@
+/*!****************************************************************
+\file: VirtualFileSystem.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: One place for asset loaders to read files from. A path is
+        looked up in the mounted asset pack first and read from disk
+        otherwise, so the same loader code works with loose files in
+        the editor and with Assets.pak in a shipped build.
+
+        Every read is counted, which gives the file count, bytes and
+        time spent on file I/O during startup in either mode.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "VirtualFileSystem.h"
+#include "ImGuiConsole.h"
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+/**
+ * \brief Retrieves the virtual file system instance.
+ * \return Reference to the virtual file system.
+ */
+VirtualFileSystem& VirtualFileSystem::GetInstance() {
+    static VirtualFileSystem instance;
+    return instance;
+}
+
+/**
+ * \brief Mounts an asset pack. Files in it take precedence over loose files.
+ *        Mount before any asset is loaded and do not remount while loaders are running.
+ * \param packPath The path of the pack, e.g. "Assets.pak".
+ * \return True if the pack was mounted, false if it is missing or invalid.
+ */
+bool VirtualFileSystem::Mount(const std::string& packPath) {
+    std::error_code error;
+    if (!std::filesystem::exists(packPath, error)) {
+        return false;
+    }
+    if (!pack.Open(packPath)) {
+        return false;
+    }
+#ifdef _LOGGING
+    ImGuiConsole::Cout("Mounted %s with %zu files", packPath.c_str(), pack.GetEntryCount());
+#endif // _LOGGING
+    return true;
+}
+
+/**
+ * \brief Unmounts the asset pack. Files are read from disk afterwards.
+ */
+void VirtualFileSystem::Unmount() {
+    pack.Close();
+}
+
+/**
+ * \brief Reads a file from the mounted pack or from disk.
+ * \param path The path of the file, e.g. "Assets/Textures/Player.png".
+ * \return The file. Check IsValid before using it.
+ */
+VirtualFile VirtualFileSystem::Open(const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    VirtualFile file;
+
+    AssetPack::EntryView entry;
+    if (pack.IsOpen() && pack.Find(AssetPack::NormalizePath(path), entry)) {
+        if (entry.storedSize == entry.size) {
+            // Stored entries are used straight from the mapping
+            file.data = entry.data;
+            file.size = static_cast<size_t>(entry.size);
+            file.valid = true;
+        }
+        else if (AssetPack::Extract(entry, file.buffer)) {
+            file.data = file.buffer.data();
+            file.size = file.buffer.size();
+            file.valid = true;
+        }
+        else {
+            ImGuiConsole::Cout("Error: %s is damaged in the asset pack", path.c_str());
+        }
+        file.packed = file.valid;
+    }
+    else {
+        // Loose files are read in full so the counters measure the same work the pack saves
+        std::ifstream inFile(path, std::ios::binary | std::ios::ate);
+        if (inFile.is_open()) {
+            std::streamsize size = inFile.tellg();
+            file.buffer.resize(static_cast<size_t>(std::max<std::streamsize>(size, 0)));
+            inFile.seekg(0, std::ios::beg);
+            file.valid = size <= 0 || static_cast<bool>(inFile.read(reinterpret_cast<char*>(file.buffer.data()), size));
+            file.data = file.buffer.data();
+            file.size = file.buffer.size();
+        }
+    }
+
+    if (file.valid) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        Record(file.size, static_cast<uint64_t>(elapsed.count()), file.packed);
+    }
+    return file;
+}
+
+/**
+ * \brief Checks if a file is in the mounted pack.
+ * \param path The path of the file.
+ * \return True if packed, false otherwise.
+ */
+bool VirtualFileSystem::IsPacked(const std::string& path) const {
+    AssetPack::EntryView entry;
+    return pack.IsOpen() && pack.Find(AssetPack::NormalizePath(path), entry);
+}
+
+/**
+ * \brief Checks if a file can be opened from the pack or from disk.
+ * \param path The path of the file.
+ * \return True if it exists, false otherwise.
+ */
+bool VirtualFileSystem::Exists(const std::string& path) const {
+    std::error_code error;
+    return IsPacked(path) || std::filesystem::is_regular_file(path, error);
+}
+
+/**
+ * \brief Retrieves the original size of a packed file.
+ * \param path The path of the file.
+ * \param size Receives the size.
+ * \return True if the file is in the mounted pack, false otherwise.
+ */
+bool VirtualFileSystem::GetPackedSize(const std::string& path, uint64_t& size) const {
+    AssetPack::EntryView entry;
+    if (!pack.IsOpen() || !pack.Find(AssetPack::NormalizePath(path), entry)) {
+        return false;
+    }
+    size = entry.size;
+    return true;
+}
+
+/**
+ * \brief Retrieves a packed file that is stored uncompressed, as a range of the mapping.
+ * \param path The path of the file.
+ * \param data Receives the start of the file in the mapping.
+ * \param size Receives the size.
+ * \return True if the file is in the mounted pack and stored uncompressed, false otherwise.
+ */
+bool VirtualFileSystem::FindStored(const std::string& path, const unsigned char*& data, uint64_t& size) const {
+    AssetPack::EntryView entry;
+    if (!pack.IsOpen() || !pack.Find(AssetPack::NormalizePath(path), entry) || entry.storedSize != entry.size) {
+        return false;
+    }
+    data = entry.data;
+    size = entry.size;
+    return true;
+}
+
+/**
+ * \brief Retrieves the I/O counted so far.
+ * \return A copy of the counters.
+ */
+VirtualFileSystem::Stats VirtualFileSystem::GetStats() const {
+    Stats stats;
+    stats.files = fileCount.load(std::memory_order_relaxed);
+    stats.bytes = byteCount.load(std::memory_order_relaxed);
+    stats.microseconds = microsecondCount.load(std::memory_order_relaxed);
+    stats.packedFiles = packedCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * \brief Clears the I/O counters.
+ */
+void VirtualFileSystem::ResetStats() {
+    fileCount = 0;
+    byteCount = 0;
+    microsecondCount = 0;
+    packedCount = 0;
+}
+
+/**
+ * \brief Adds one read to the counters.
+ * \param bytes The size of the file.
+ * \param microseconds The time spent reading it.
+ * \param packed True if read from the pack.
+ */
+void VirtualFileSystem::Record(uint64_t bytes, uint64_t microseconds, bool packed) {
+    fileCount.fetch_add(1, std::memory_order_relaxed);
+    byteCount.fetch_add(bytes, std::memory_order_relaxed);
+    microsecondCount.fetch_add(microseconds, std::memory_order_relaxed);
+    if (packed) {
+        packedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
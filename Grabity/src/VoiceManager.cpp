@@ -0,0 +1,246 @@
+/*!****************************************************************
+\file: VoiceManager.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Decides which sound effect voices may play. Every play
+        request is checked against the sound's retrigger cooldown and
+        its maximum number of instances, stealing an existing voice
+        or rejecting the new one when the limit is reached. Of the
+        voices that are playing, only the most important and audible
+        ones stay real; the rest are made virtual so they keep their
+        place in the sound but cost nothing to mix.
+
+        The manager only keeps book, it never talks to FMOD. The
+        AudioManager applies its decisions to channels, which also
+        lets it run against no audio device at all.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "VoiceManager.h"
+#include <algorithm>
+
+/**
+ * \brief Retrieves the limits of a sound.
+ * \param soundID The audio ID.
+ * \return The sound's limits, or the default limits if none were set.
+ */
+VoiceManager::Limits VoiceManager::GetLimits(int soundID) const {
+    auto it = soundLimits.find(soundID);
+    return it != soundLimits.end() ? it->second : defaultLimits;
+}
+
+/**
+ * \brief Asks to start a voice of a sound.
+ * \param soundID The audio ID.
+ * \param priority The sound's priority, 0 is the most important like FMOD channels.
+ * \param audibility Volume times distance attenuation, 0 to 1.
+ * \return The new voice and any voices that were stolen for it.
+ */
+VoiceManager::Admission VoiceManager::Request(int soundID, int priority, float audibility) {
+    Admission admission;
+    ++stats.requested;
+    const Limits limits = GetLimits(soundID);
+
+    // A crowd hit on the same frame is heard as one sound anyway
+    auto last = lastStart.find(soundID);
+    if (limits.cooldown > 0.0 && last != lastStart.end() && clock - last->second < limits.cooldown) {
+        ++stats.suppressed;
+        return admission;
+    }
+
+    std::vector<VoiceHandle>& instances = soundVoices[soundID];
+    if (limits.maxInstances > 0 && static_cast<int>(instances.size()) >= limits.maxInstances) {
+        if (limits.steal == StealPolicy::REJECT_NEW) {
+            ++stats.rejected;
+            return admission;
+        }
+        while (static_cast<int>(instances.size()) >= limits.maxInstances) {
+            VoiceHandle victim = PickVictim(soundID, limits.steal);
+            if (victim == InvalidVoice) {
+                break;
+            }
+            admission.stolen.push_back(victim);
+            ++stats.stolen;
+            Release(victim);
+        }
+    }
+
+    Voice voice;
+    voice.soundID = soundID;
+    voice.priority = priority;
+    voice.audibility = audibility;
+    voice.startTime = clock;
+    admission.voice = nextVoice++;
+    if (nextVoice == InvalidVoice) {
+        ++nextVoice;
+    }
+    voices.emplace(admission.voice, voice);
+    soundVoices[soundID].push_back(admission.voice);
+    lastStart[soundID] = clock;
+    ++stats.started;
+    CountVoices();
+    return admission;
+}
+
+/**
+ * \brief Forgets a voice that finished or was stopped.
+ * \param voice The voice.
+ */
+void VoiceManager::Release(VoiceHandle voice) {
+    auto it = voices.find(voice);
+    if (it == voices.end()) {
+        return;
+    }
+    auto instances = soundVoices.find(it->second.soundID);
+    if (instances != soundVoices.end()) {
+        instances->second.erase(std::remove(instances->second.begin(), instances->second.end(), voice), instances->second.end());
+        if (instances->second.empty()) {
+            soundVoices.erase(instances);
+        }
+    }
+    voices.erase(it);
+    CountVoices();
+}
+
+/**
+ * \brief Forgets every voice, e.g. after all audio was stopped.
+ */
+void VoiceManager::ReleaseAll() {
+    voices.clear();
+    soundVoices.clear();
+    CountVoices();
+}
+
+/**
+ * \brief Updates how audible a voice is after a volume or position change.
+ * \param voice The voice.
+ * \param audibility Volume times distance attenuation, 0 to 1.
+ */
+void VoiceManager::SetAudibility(VoiceHandle voice, float audibility) {
+    auto it = voices.find(voice);
+    if (it != voices.end()) {
+        it->second.audibility = audibility;
+    }
+}
+
+/**
+ * \brief Ranks the playing voices and reports the ones that have to change between real and virtual.
+ * \param becameReal Receives the voices that have to be heard again.
+ * \param becameVirtual Receives the voices that have to be silenced.
+ */
+void VoiceManager::UpdateVirtualisation(std::vector<VoiceHandle>& becameReal, std::vector<VoiceHandle>& becameVirtual) {
+    becameReal.clear();
+    becameVirtual.clear();
+
+    std::vector<std::pair<VoiceHandle, const Voice*>> ranked;
+    ranked.reserve(voices.size());
+    for (const auto& [handle, voice] : voices) {
+        ranked.emplace_back(handle, &voice);
+    }
+    // Most important first, then loudest, then newest so a fresh sound is not cut by an old tail
+    std::sort(ranked.begin(), ranked.end(), [](const auto& left, const auto& right) {
+        if (left.second->priority != right.second->priority) {
+            return left.second->priority < right.second->priority;
+        }
+        if (left.second->audibility != right.second->audibility) {
+            return left.second->audibility > right.second->audibility;
+        }
+        if (left.second->startTime != right.second->startTime) {
+            return left.second->startTime > right.second->startTime;
+        }
+        return left.first > right.first;
+    });
+
+    int realVoices = 0;
+    for (const auto& [handle, ranking] : ranked) {
+        Voice& voice = voices[handle];
+        // Silent voices are never worth a real voice, and do not take one from an audible voice
+        const bool shouldBeVirtual = realVoices >= maxRealVoices || voice.audibility <= 0.0f;
+        if (!shouldBeVirtual) {
+            ++realVoices;
+        }
+        if (shouldBeVirtual != voice.isVirtual) {
+            voice.isVirtual = shouldBeVirtual;
+            if (shouldBeVirtual) {
+                becameVirtual.push_back(handle);
+                ++stats.virtualised;
+            }
+            else {
+                becameReal.push_back(handle);
+            }
+        }
+    }
+    CountVoices();
+}
+
+/**
+ * \brief Checks if a voice is currently virtual.
+ * \param voice The voice.
+ * \return True if virtual, false if real or unknown.
+ */
+bool VoiceManager::IsVirtual(VoiceHandle voice) const {
+    auto it = voices.find(voice);
+    return it != voices.end() && it->second.isVirtual;
+}
+
+/**
+ * \brief Clears the counters, keeping the current voice counts.
+ */
+void VoiceManager::ResetStats() {
+    stats = Stats();
+    CountVoices();
+    stats.peakPlaying = stats.playing;
+}
+
+/**
+ * \brief Picks the voice of a sound to steal.
+ * \param soundID The audio ID.
+ * \param policy How to pick.
+ * \return The voice, or InvalidVoice if the sound has none playing.
+ */
+VoiceManager::VoiceHandle VoiceManager::PickVictim(int soundID, StealPolicy policy) const {
+    auto instances = soundVoices.find(soundID);
+    if (instances == soundVoices.end() || instances->second.empty()) {
+        return InvalidVoice;
+    }
+
+    // Instances are kept oldest first, so strict comparisons prefer the oldest on ties
+    VoiceHandle victim = instances->second.front();
+    const Voice* chosen = &voices.at(victim);
+    for (VoiceHandle handle : instances->second) {
+        const Voice& voice = voices.at(handle);
+        bool better = false;
+        switch (policy) {
+        case StealPolicy::STEAL_QUIETEST:
+            better = voice.audibility < chosen->audibility;
+            break;
+        case StealPolicy::STEAL_LOWEST_PRIORITY:
+            better = voice.priority > chosen->priority;
+            break;
+        default:
+            break;
+        }
+        if (better) {
+            victim = handle;
+            chosen = &voice;
+        }
+    }
+    return victim;
+}
+
+/**
+ * \brief Recounts the playing, real and virtual voices.
+ */
+void VoiceManager::CountVoices() {
+    stats.playing = static_cast<int>(voices.size());
+    stats.virtualVoices = 0;
+    for (const auto& [handle, voice] : voices) {
+        if (voice.isVirtual) {
+            ++stats.virtualVoices;
+        }
+    }
+    stats.real = stats.playing - stats.virtualVoices;
+    stats.peakPlaying = std::max(stats.peakPlaying, stats.playing);
+}
@@ -0,0 +1,80 @@
+/*!****************************************************************
+\file: WorldSnapshot.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: In-memory image of every game object and its component state,
+        captured right after a scene finishes loading. Restarting the
+        scene restores from the image through a LuaSceneContext, so the
+        per-component reads never touch the scene file or a Lua state.
+
+        The image uses the cooked scene layout (see CookedScene) and is
+        produced by the same Serialize calls that save a scene.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "WorldSnapshot.h"
+#include "GameObjectFactory.h"
+#include "LuaConfig.h"
+
+/**
+ * \brief Serializes every game object of the factory into an in-memory image.
+ * \param sourceScenePath The scene the objects were loaded from.
+ * \return True if the image was built, false otherwise.
+ */
+bool WorldSnapshot::Capture(const std::string& sourceScenePath) {
+    Clear();
+
+    // Never a real file, so a writer or context on it cannot collide with the scene itself
+    const std::string capturePath = "snapshot:" + sourceScenePath;
+    std::vector<unsigned char> bytes;
+    {
+        LuaSceneWriter writer(capturePath, "");
+        GameObjectFactory::GetInstance().WriteAllGameObjects(capturePath);
+        bytes = writer.BuildCookedImage();
+    }
+
+    std::shared_ptr<CookedScene> capturedImage = std::make_shared<CookedScene>();
+    if (!capturedImage->LoadFromMemory(std::move(bytes))) {
+        return false;
+    }
+
+    std::error_code error;
+    sceneWriteTime = std::filesystem::last_write_time(sourceScenePath, error);
+    if (error) {
+        sceneWriteTime = std::filesystem::file_time_type::min();
+    }
+    scenePath = sourceScenePath;
+    snapshotPath = capturePath;
+    image = std::move(capturedImage);
+    return true;
+}
+
+/**
+ * \brief Drops the captured image.
+ */
+void WorldSnapshot::Clear() {
+    image.reset();
+    scenePath.clear();
+    snapshotPath.clear();
+}
+
+/**
+ * \brief Checks if the snapshot can stand in for a scene file. A snapshot goes stale
+ *        once the scene file is saved again after the capture.
+ * \param targetScenePath The scene about to be restarted.
+ * \return True if the snapshot belongs to the scene and is still current.
+ */
+bool WorldSnapshot::IsValidFor(const std::string& targetScenePath) const {
+    if (!image || targetScenePath != scenePath) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(targetScenePath, error);
+    if (error) {
+        writeTime = std::filesystem::file_time_type::min();
+    }
+    return writeTime == sceneWriteTime;
+}
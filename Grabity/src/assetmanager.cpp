@@ -22,6 +22,7 @@ Technology is prohibited.
 #include "assetmanager.h"
 #include "AudioManager.h"
 #include "Font.h"
+#include <algorithm>
 
 #ifdef _IMGUI
 #include <iostream>
@@ -96,6 +97,14 @@ AssetManager::AssetManager()
     ++totalTextureLoaded;
 
 
+    // Editor icons are drawn every frame and are never unloaded
+    for (const auto& [name, texture] : m_Textures) {
+        TextureRecord& record = textureRecords[name];
+        record.pinned = true;
+        record.bytes = static_cast<size_t>(texture->GetWidth()) * static_cast<size_t>(texture->GetHeight()) * 4;
+        residentTextureBytes += record.bytes;
+    }
+
     PreloadLuaFiles();
     PreloadPrefabs();
 
@@ -107,20 +116,116 @@ AssetManager::AssetManager()
  * @param filePath The path to the audio file.
  * @param type The type of the audio (e.g., sound effect, music).
  * @param priority The priority of the audio.
+ * @param mode How the sound is held while loaded.
  * @return The ID of the loaded audio, or the existing ID if already loaded.
  */
-int AssetManager::LoadAudio(const std::string& audioName, const std::string& filePath, AudioType type, int priority)
+int AssetManager::LoadAudio(const std::string& audioName, const std::string& filePath, AudioType type, int priority, AudioBackend::LoadMode mode)
 {
     if (audioNameToID.find(audioName) == audioNameToID.end())
     {
         int newID = audioID++;
-        audioObjects[newID] = new Audio(audioName, filePath, type, priority);
+        Audio* audio = new Audio(audioName, filePath, type, priority, mode);
+        audioObjects[newID] = audio;
         audioNameToID[audioName] = newID;
+        audioRecords[newID] = AudioRecord{};
+        MakeAudioResident(newID, *audio);
+        audioRecords[newID].failed = !audio->IsLoaded();
         return newID;
     }
     return audioNameToID[audioName];
 }
 
+/**
+ * @brief Lists the audio the backend could not load, e.g. formats it has no decoder for
+ * @return "name (path)" of each, sorted
+ */
+std::vector<std::string> AssetManager::GetFailedAudio() const {
+    std::vector<std::string> failed;
+    for (const auto& [id, record] : audioRecords) {
+        auto it = audioObjects.find(id);
+        if (record.failed && it != audioObjects.end() && it->second) {
+            failed.push_back(it->second->GetAudioName() + " (" + it->second->GetFilePath() + ")");
+        }
+    }
+    std::sort(failed.begin(), failed.end());
+    return failed;
+}
+
+/**
+ * @brief Gets an audio to play, loading it again if it was unloaded
+ * @param id The ID of the audio
+ * @return The audio, nullptr if the ID is unknown
+ */
+Audio* AssetManager::GetAudio(int id) {
+    auto it = audioObjects.find(id);
+    if (it == audioObjects.end() || !it->second) {
+        return nullptr;
+    }
+    Audio* audio = it->second;
+    AudioRecord& record = audioRecords[id];
+    if (!audio->IsLoaded() && !record.failed) {
+        // A file the backend could not load is not read again on every play
+        record.failed = !audio->Load();
+        MakeAudioResident(id, *audio);
+    }
+
+    record.lastUsed = ++useClock;
+    if (!residentScene.empty() && record.scene != sceneGeneration) {
+        record.scene = sceneGeneration;
+        sceneAudio[residentScene].insert(id);
+    }
+    return audio;
+}
+
+/**
+ * @brief Updates the record of an audio that has just been loaded
+ * @param id The ID of the audio
+ * @param audio The loaded audio
+ */
+void AssetManager::MakeAudioResident(int id, const Audio& audio) {
+    if (!audio.IsLoaded()) {
+        return;
+    }
+    AudioRecord& record = audioRecords[id];
+    record.bytes = AudioManager::GetInstance().GetBackend().GetSoundMemory(audio.GetAudio()).resident;
+    record.lastUsed = ++useClock;
+    residentAudioBytes += record.bytes;
+}
+
+/**
+ * @brief Checks if a loaded audio may be unloaded
+ * @param id The ID of the audio
+ * @param audio The loaded audio
+ * @return true if no channel is playing it and the current scene has not played it
+ */
+bool AssetManager::CanEvictAudio(int id, const Audio& audio) const {
+    if (!audio.IsLoaded()) {
+        return false;
+    }
+    if (AudioManager::GetInstance().GetPlayingChannelCount(id) > 0) {
+        return false;
+    }
+    auto sceneIt = sceneAudio.find(residentScene);
+    return sceneIt == sceneAudio.end() || sceneIt->second.find(id) == sceneIt->second.end();
+}
+
+/**
+ * @brief Unloads an audio, keeping it registered so it can be loaded again
+ * @param id The ID of the audio
+ */
+void AssetManager::EvictAudio(int id) {
+    auto it = audioObjects.find(id);
+    if (it == audioObjects.end() || !it->second || !it->second->IsLoaded()) {
+        return;
+    }
+    // Finished channels still refer to the sound
+    AudioManager::GetInstance().StopAudio(id);
+    it->second->Unload();
+    AudioRecord& record = audioRecords[id];
+    residentAudioBytes -= std::min(residentAudioBytes, record.bytes);
+    record.bytes = 0;
+}
+
 /**
  * @brief Initialize graphics-related assets
  *
@@ -147,10 +252,12 @@ void AssetManager::InitializeGraphicsAssets()
     shader[Graphics::S_GEOMETRY].Bind();
     shader[Graphics::S_GEOMETRY].Unbind();
 
-    // Initialize fonts
-    font[Graphics::F_SLEEPYSANS].LoadFont("Assets/Fonts/sleepySans.ttf", 64);
-    font[Graphics::F_ARIAL].LoadFont("Assets/Fonts/arial.ttf", 48);
-    font[Graphics::F_TIMER].LoadFont("Assets/Fonts/SquadaOne-Regular.ttf", 64);
+    // Initialize fonts, rasterizing them here unless startup already did it on a worker thread
+    if (!fontsRasterized)
+        RasterizeFonts();
+    for (Font& loadedFont : font)
+        loadedFont.UploadGlyphs();
+    fontsRasterized = false;
 
     // Initialize particles
     shader[Graphics::S_PARTICLE].SetShader("Assets/Shaders/Particle.shader");
@@ -160,6 +267,22 @@ void AssetManager::InitializeGraphicsAssets()
 }
 
 
+/**
+ * @brief Rasterizes the glyphs of all fonts
+ *
+ * @details Only uses FreeType and memory, so it can run on a worker thread
+ *          while the main thread does OpenGL work. The glyphs are turned
+ *          into textures by InitializeGraphicsAssets.
+ */
+void AssetManager::RasterizeFonts()
+{
+    font[Graphics::F_SLEEPYSANS].RasterizeFont("Assets/Fonts/sleepySans.ttf", 64);
+    font[Graphics::F_ARIAL].RasterizeFont("Assets/Fonts/arial.ttf", 48);
+    font[Graphics::F_TIMER].RasterizeFont("Assets/Fonts/SquadaOne-Regular.ttf", 64);
+    fontsRasterized = true;
+}
+
+
 /**
  * @brief Preload all required Lua script files
  *
@@ -343,12 +466,14 @@ bool AssetManager::IsPrefabLoaded(const std::string& name) const
 
 
 /**
- * @brief Load a texture into the asset manager
+ * @brief Create a texture, applying the frame layouts of the known animations
  * @param pathName The file path to the texture
  * @param fileName The name to identify the texture
  * @param frameX Number of frames in X direction for animation
  * @param frameY Number of frames in Y direction for animation
  * @param animationFrame Animation frame rate
+ * @param decoded Pixels decoded ahead of time, or nullptr to decode the file now
+ * @return The texture
  * @details Special handling for predefined animations:
  *          - Animation_Ame: 6x5 frames at 30fps
  *          - Animation_Ina: 3x2 frames at 30fps
@@ -356,64 +481,411 @@ bool AssetManager::IsPrefabLoaded(const std::string& name) const
  *          - Animation_Heavy_Enemy: 2x1 frames at 10fps
  *          - Animation_Light_Enemy: 2x1 frames at 10fps
  */
-void AssetManager::LoadTexture(const std::string& pathName, const std::string& fileName, const float& frameX, const float& frameY, const float& animationFrame) {
+std::shared_ptr<Texture> AssetManager::CreateTexture(const std::string& pathName, const std::string& fileName, float frameX, float frameY, float animationFrame, const Texture::DecodedImage* decoded) {
+    std::shared_ptr<Texture> texture;
+
+    // Uses the pixels a scene preload decoded when there are some, otherwise decodes the file here
+    auto makeTexture = [&](float layoutX, float layoutY, float framesPerSecond) {
+        return decoded
+            ? std::make_shared<Texture>(fileName, pathName, *decoded, layoutX, layoutY, framesPerSecond)
+            : std::make_shared<Texture>(fileName, pathName, layoutX, layoutY, framesPerSecond);
+    };
 
     if (fileName == "Animation_Ame") {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 6.0f, 5.0f, 30.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(6.0f, 5.0f, 30.f);
     }
     else if (fileName == "Animation_Ina") {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 3.0f, 2.0f, 30.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(3.0f, 2.0f, 30.f);
     }
     else if (fileName == "Animation_PlayerWalk")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 4.0f, 2.0f, 8.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(4.0f, 2.0f, 8.f);
     }
     else if (fileName == "Animation_Heavy_Enemy")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 2.0f, 3.0f, 6.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(2.0f, 3.0f, 6.f);
     }
     else if (fileName == "Animation_Light_Enemy")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 2.0f, 3.0f, 5.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(2.0f, 3.0f, 5.f);
     }
     else if (fileName == "Animation_Bomb_Enemy")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 3.0f, 1.0f, 3.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(3.0f, 1.0f, 3.f);
     }
     else if (fileName == "explosin")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 1.0f, 1.0f, 10.f);
-        ++totalTextureLoaded;
-
+        texture = makeTexture(1.0f, 1.0f, 10.f);
     }
     else if (fileName == "Animation_GrabityTitle")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 2.0f, 3.0f, 10.f);
-        m_Textures[fileName]->SetTotalFrames(5);
-        ++totalTextureLoaded;
-
+        texture = makeTexture(2.0f, 3.0f, 10.f);
+        texture->SetTotalFrames(5);
     }
     else if (fileName == "Animation_Particle_Plant_B")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 2.0f, 1.0f, 1.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(2.0f, 1.0f, 1.f);
     }
     else if (fileName == "Animation_hitVFX")
     {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, 2.0f, 3.0f, 6.f);
-        ++totalTextureLoaded;
+        texture = makeTexture(2.0f, 3.0f, 6.f);
     }
     else {
-        m_Textures[fileName] = std::make_shared<Texture>(fileName, pathName, frameX, frameY, animationFrame);
-        ++totalTextureLoaded;
+        texture = makeTexture(frameX, frameY, animationFrame);
     }
+    return texture;
+}
+
 
+/**
+ * @brief Load a texture into the asset manager
+ * @param pathName The file path to the texture
+ * @param fileName The name to identify the texture
+ * @param frameX Number of frames in X direction for animation
+ * @param frameY Number of frames in Y direction for animation
+ * @param animationFrame Animation frame rate
+ */
+void AssetManager::LoadTexture(const std::string& pathName, const std::string& fileName, const float& frameX, const float& frameY, const float& animationFrame) {
+    RegisterTexture(pathName, fileName, frameX, frameY, animationFrame);
+
+    // Loading a texture again replaces it, the old one lives on in whatever still holds it
+    if (m_Textures.find(fileName) != m_Textures.end()) {
+        Evict(fileName);
+    }
+    TextureRecord& record = textureRecords[fileName];
+    MakeResident(fileName, record, CreateTexture(pathName, fileName, frameX, frameY, animationFrame));
+}
+
+/**
+ * @brief Make a texture known without loading it. It is loaded by the first GetSprite
+ * @param pathName The file path to the texture
+ * @param fileName The name to identify the texture
+ * @param frameX Number of frames in X direction for animation
+ * @param frameY Number of frames in Y direction for animation
+ * @param animationFrame Animation frame rate
+ */
+void AssetManager::RegisterTexture(const std::string& pathName, const std::string& fileName, float frameX, float frameY, float animationFrame) {
+    TextureRecord& record = textureRecords[fileName];
+    record.path = pathName;
+    record.frameX = frameX;
+    record.frameY = frameY;
+    record.framePS = animationFrame;
+}
+
+/**
+ * @brief Reload a texture from its file in place, keeping the Texture object that sprites hold
+ * @param pathName The file path to the texture
+ * @param fileName The name the texture was loaded with
+ * @return True if the texture was known. If it is not resident the next GetSprite reads the new file
+ */
+bool AssetManager::ReloadTexture(const std::string& pathName, const std::string& fileName) {
+    auto recordIt = textureRecords.find(fileName);
+    if (recordIt == textureRecords.end()) {
+        return false;
+    }
+    TextureRecord& record = recordIt->second;
+    record.path = pathName;
+
+    auto textureIt = m_Textures.find(fileName);
+    if (textureIt == m_Textures.end()) {
+        return true;
+    }
+
+    // A new Texture would leave every SpriteAnimation drawing the old one, so the pixels are replaced instead
+    Texture::DecodedImage decoded;
+    if (!Texture::Decode(pathName, decoded)) {
+        ImGuiConsole::Cout("Error: Could not decode %s, keeping the old texture", pathName.c_str());
+        return true;
+    }
+    textureIt->second->Upload(decoded);
+
+    residentTextureBytes -= std::min(residentTextureBytes, record.bytes);
+    record.bytes = static_cast<size_t>(decoded.width) * static_cast<size_t>(decoded.height) * 4;
+    residentTextureBytes += record.bytes;
+    return true;
+}
+
+/**
+ * @brief Lists every registered texture, resident or not
+ * @return The texture names, sorted
+ */
+std::vector<std::string> AssetManager::GetTextureNames() const {
+    std::vector<std::string> names;
+    names.reserve(textureRecords.size());
+    for (const auto& [name, record] : textureRecords) {
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+ * @brief Lists the file of every registered texture, for loaders that run off the main thread
+ * @return Texture name to file path
+ */
+std::unordered_map<std::string, std::string> AssetManager::GetTexturePaths() const {
+    std::unordered_map<std::string, std::string> paths;
+    for (const auto& [name, record] : textureRecords) {
+        if (!record.path.empty()) {
+            paths.emplace(name, record.path);
+        }
+    }
+    return paths;
+}
+
+/**
+ * @brief Makes a texture resident from pixels decoded ahead of time, e.g. by a scene preload
+ * @param name The name of the texture
+ * @param decoded The decoded pixels
+ * @return true if the texture was uploaded, false if it is unknown or already resident
+ */
+bool AssetManager::AdoptDecodedTexture(const std::string& name, const Texture::DecodedImage& decoded) {
+    auto recordIt = textureRecords.find(name);
+    if (recordIt == textureRecords.end() || recordIt->second.path.empty() || !decoded.pixels || m_Textures.find(name) != m_Textures.end()) {
+        return false;
+    }
+    TextureRecord& record = recordIt->second;
+    MakeResident(name, record, CreateTexture(record.path, name, record.frameX, record.frameY, record.framePS, &decoded));
+    return true;
+}
+
+/**
+ * @brief Gets a sprite animation by its identifier, loading it if it was registered or unloaded
+ * @param id The identifier of the sprite to retrieve
+ * @return Shared pointer to the requested sprite animation, nullptr if the name is unknown
+ */
+std::shared_ptr<Texture> AssetManager::GetSprite(const std::string& id) {
+    auto recordIt = textureRecords.find(id);
+    if (recordIt == textureRecords.end()) {
+        return nullptr;
+    }
+    TextureRecord& record = recordIt->second;
+
+    std::shared_ptr<Texture> texture;
+    auto textureIt = m_Textures.find(id);
+    if (textureIt != m_Textures.end()) {
+        texture = textureIt->second;
+    }
+    else if (!record.path.empty()) {
+        texture = CreateTexture(record.path, id, record.frameX, record.frameY, record.framePS);
+        MakeResident(id, record, texture);
+    }
+
+    // Runs for every draw, so the scene's set is only touched the first time in a scene
+    record.lastUsed = ++useClock;
+    RecordSceneTexture(id, record);
+    return texture;
+}
+
+/**
+ * @brief Adds a texture to the current scene's set the first time the scene uses it
+ * @param name The name of the texture
+ * @param record The record of the texture
+ */
+void AssetManager::RecordSceneTexture(const std::string& name, TextureRecord& record) {
+    if (residentScene.empty() || record.scene == sceneGeneration) {
+        return;
+    }
+    record.scene = sceneGeneration;
+    sceneTextures[residentScene].insert(name);
+}
+
+/**
+ * @brief Makes a texture resident and updates the counters
+ * @param name The name of the texture
+ * @param record The record of the texture
+ * @param texture The loaded texture
+ */
+void AssetManager::MakeResident(const std::string& name, TextureRecord& record, std::shared_ptr<Texture> texture) {
+    // Textures are uploaded as RGBA8
+    record.bytes = static_cast<size_t>(texture->GetWidth()) * static_cast<size_t>(texture->GetHeight()) * 4;
+    record.lastUsed = ++useClock;
+    residentTextureBytes += record.bytes;
+    m_Textures[name] = std::move(texture);
+    ++totalTextureLoaded;
+    RecordSceneTexture(name, record);
+}
+
+/**
+ * @brief Checks if a resident texture may be unloaded
+ * @param name The name of the texture
+ * @param texture The resident texture
+ * @return true if nothing but the asset manager holds it and the current scene does not use it
+ */
+bool AssetManager::CanEvict(const std::string& name, const std::shared_ptr<Texture>& texture) const {
+    auto recordIt = textureRecords.find(name);
+    if (recordIt == textureRecords.end() || recordIt->second.pinned || recordIt->second.path.empty()) {
+        return false;
+    }
+    if (texture.use_count() > 1) {
+        return false;
+    }
+    auto sceneIt = sceneTextures.find(residentScene);
+    return sceneIt == sceneTextures.end() || sceneIt->second.find(name) == sceneIt->second.end();
+}
+
+/**
+ * @brief Unloads a resident texture, keeping its record so it can be loaded again
+ * @param name The name of the texture
+ */
+void AssetManager::Evict(const std::string& name) {
+    auto it = m_Textures.find(name);
+    if (it == m_Textures.end()) {
+        return;
+    }
+    auto recordIt = textureRecords.find(name);
+    if (recordIt != textureRecords.end()) {
+        residentTextureBytes -= std::min(residentTextureBytes, recordIt->second.bytes);
+    }
+    m_Textures.erase(it);
+    --totalTextureLoaded;
+}
+
+/**
+ * @brief Start tracking the textures and audio a scene uses. They stay resident while it is current
+ * @param scenePath The path of the scene being loaded
+ */
+void AssetManager::BeginSceneResidency(const std::string& scenePath) {
+    residentScene = scenePath;
+    ++sceneGeneration;
+    sceneTextures[scenePath].clear();
+    sceneAudio[scenePath].clear();
+}
+
+/**
+ * @brief Unload least recently used textures that nothing holds until the budget is met
+ * @return Number of textures unloaded
+ */
+int AssetManager::TrimTexturesToBudget() {
+    if (residentTextureBytes <= textureBudgetBytes) {
+        return 0;
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    for (const auto& [name, texture] : m_Textures) {
+        if (CanEvict(name, texture)) {
+            candidates.emplace_back(textureRecords[name].lastUsed, name);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    int unloaded = 0;
+    for (const auto& [lastUsed, name] : candidates) {
+        if (residentTextureBytes <= textureBudgetBytes) {
+            break;
+        }
+        Evict(name);
+        ++unloaded;
+    }
+#ifdef _LOGGING
+    if (residentTextureBytes > textureBudgetBytes) {
+        ImGuiConsole::Cout("Texture budget exceeded: %zu of %zu bytes resident are in use", residentTextureBytes, textureBudgetBytes);
+    }
+#endif // _LOGGING
+    return unloaded;
+}
+
+/**
+ * @brief Unload every texture that nothing holds and the current scene does not use
+ * @return Number of textures unloaded
+ */
+int AssetManager::UnloadUnusedTextures() {
+    std::vector<std::string> unused;
+    for (const auto& [name, texture] : m_Textures) {
+        if (CanEvict(name, texture)) {
+            unused.push_back(name);
+        }
+    }
+    for (const std::string& name : unused) {
+        Evict(name);
+    }
+    return static_cast<int>(unused.size());
+}
+
+/**
+ * @brief Unload least recently played audio that is not playing until the budget is met
+ * @return Number of sounds unloaded
+ */
+int AssetManager::TrimAudioToBudget() {
+    if (residentAudioBytes <= audioBudgetBytes) {
+        return 0;
+    }
+
+    std::vector<std::pair<uint64_t, int>> candidates;
+    for (const auto& [id, audio] : audioObjects) {
+        if (audio && CanEvictAudio(id, *audio)) {
+            candidates.emplace_back(audioRecords[id].lastUsed, id);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    int unloaded = 0;
+    for (const auto& [lastUsed, id] : candidates) {
+        if (residentAudioBytes <= audioBudgetBytes) {
+            break;
+        }
+        EvictAudio(id);
+        ++unloaded;
+    }
+#ifdef _LOGGING
+    if (residentAudioBytes > audioBudgetBytes) {
+        ImGuiConsole::Cout("Audio budget exceeded: %zu of %zu bytes resident are in use", residentAudioBytes, audioBudgetBytes);
+    }
+#endif // _LOGGING
+    return unloaded;
+}
+
+/**
+ * @brief Unload every audio that is not playing and the current scene has not played
+ * @return Number of sounds unloaded
+ */
+int AssetManager::UnloadUnusedAudio() {
+    std::vector<int> unused;
+    for (const auto& [id, audio] : audioObjects) {
+        if (audio && CanEvictAudio(id, *audio)) {
+            unused.push_back(id);
+        }
+    }
+    for (int id : unused) {
+        EvictAudio(id);
+    }
+    return static_cast<int>(unused.size());
+}
+
+/**
+ * @brief List every known texture and audio with its size and state
+ * @return The report, largest assets first
+ */
+std::vector<ResidencyInfo> AssetManager::GetResidencyReport() const {
+    std::vector<ResidencyInfo> report;
+    report.reserve(textureRecords.size() + audioObjects.size());
+
+    auto sceneIt = sceneTextures.find(residentScene);
+    for (const auto& [name, record] : textureRecords) {
+        auto textureIt = m_Textures.find(name);
+        const bool resident = textureIt != m_Textures.end();
+        report.push_back({ name, "Texture", record.path, resident ? record.bytes : 0,
+            resident ? textureIt->second.use_count() - 1 : 0, resident, record.pinned,
+            sceneIt != sceneTextures.end() && sceneIt->second.find(name) != sceneIt->second.end(), record.lastUsed });
+    }
+
+    AudioManager& audioManager = AudioManager::GetInstance();
+    auto sceneAudioIt = sceneAudio.find(residentScene);
+    for (const auto& [id, audio] : audioObjects) {
+        if (!audio) {
+            continue;
+        }
+        auto recordIt = audioRecords.find(id);
+        const AudioRecord record = recordIt != audioRecords.end() ? recordIt->second : AudioRecord{};
+        const bool resident = audio->IsLoaded();
+        const long playing = audioManager.GetPlayingChannelCount(id);
+        report.push_back({ audio->GetAudioName(), std::string("Audio (") + AudioBackend::GetLoadModeName(audio->GetLoadMode()) + ")",
+            audio->GetFilePath(), resident ? record.bytes : 0, playing, resident, false,
+            sceneAudioIt != sceneAudio.end() && sceneAudioIt->second.find(id) != sceneAudioIt->second.end(), record.lastUsed });
+    }
+
+    std::sort(report.begin(), report.end(), [](const ResidencyInfo& left, const ResidencyInfo& right) { return left.bytes > right.bytes; });
+    return report;
 }
 
 
@@ -423,10 +895,41 @@ void AssetManager::LoadTexture(const std::string& pathName, const std::string& f
  * @param fileName The name to identify the audio
  * @param audioType The type of audio (as an integer)
  * @param priority The priority level for the audio
+ * @param loadMode "decompressed", "compressed" or "streamed"; empty for the audio type's default
  */
-void AssetManager::LoadAudios(const std::string& pathName, const std::string& fileName, const int& audioType, const int& priority) {
+void AssetManager::LoadAudios(const std::string& pathName, const std::string& fileName, const int& audioType, const int& priority, const std::string& loadMode) {
+    AudioType type = static_cast<AudioType>(audioType);
+    LoadAudio(fileName, pathName, type, priority, AudioBackend::ParseLoadMode(loadMode, Audio::GetDefaultLoadMode(type)));
+}
+
+
+/**
+ * @brief Reload a loaded audio from its file, keeping its ID, type, priority and load mode
+ * @param pathName The file path to the audio
+ * @param fileName The name the audio was loaded with
+ * @return True if the audio was loaded before and has been reloaded
+ */
+bool AssetManager::ReloadAudio(const std::string& pathName, const std::string& fileName) {
+    auto nameIt = audioNameToID.find(fileName);
+    if (nameIt == audioNameToID.end()) {
+        return false;
+    }
+    auto it = audioObjects.find(nameIt->second);
+    if (it == audioObjects.end()) {
+        return false;
+    }
 
-    LoadAudio(fileName, pathName, static_cast<AudioType>(audioType), priority);
+    // Channels still playing the old sound have to stop before it is released
+    AudioManager::GetInstance().StopAudio(it->first);
+    AudioType type = it->second->GetType();
+    int priority = it->second->GetPriority();
+    AudioBackend::LoadMode mode = it->second->GetLoadMode();
+    EvictAudio(it->first);
+    delete it->second;
+    it->second = new Audio(fileName, pathName, type, priority, mode);
+    MakeAudioResident(it->first, *it->second);
+    audioRecords[it->first].failed = !it->second->IsLoaded();
+    return true;
 }
 
 
@@ -435,8 +938,7 @@ void AssetManager::LoadAudios(const std::string& pathName, const std::string& fi
  * @param textureName The name of the texture to remove
  */
 void AssetManager::RemoveTexture(const std::string& textureName) {
-    auto it = m_Textures.find(textureName);
-    if (it != m_Textures.end()) {
+    if (textureRecords.find(textureName) != textureRecords.end()) {
         // First update all GameObjects using this texture
         GameObjectFactory& factory = GameObjectFactory::GetInstance();
         for (const auto& [id, gameObj] : factory.GetAllGameObjects()) {
@@ -448,8 +950,8 @@ void AssetManager::RemoveTexture(const std::string& textureName) {
         }
 
         // Then remove the texture from the asset manager
-        m_Textures.erase(it);
-        --totalTextureLoaded;
+        Evict(textureName);
+        textureRecords.erase(textureName);
 #ifdef _LOGGING
         ImGuiConsole::Cout("Texture \"%s\" removed successfully.", textureName.c_str());
 #endif // _LOGGING
@@ -465,6 +967,8 @@ void AssetManager::RemoveSound(const int& id) {
     // Map to store audio objects, indexed by their IDs.
     auto it = audioObjects.find(id);
     if (it != audioObjects.end()) {
+        EvictAudio(id);
+        audioRecords.erase(id);
         audioObjects.erase(it);
 #ifdef _LOGGING
         ImGuiConsole::Cout("Audio ID:  \"%d\" removed successfully.", id);
@@ -41,6 +41,7 @@ Technology is prohibited.
 #include <imgui.h>
 #include "ContentBrowser.h"
 #include "FrameBuffer.h"
+#include "AssetWatcher.h"
 #endif // _IMGUI
 #include "ImGuiConsole.h"
 
@@ -65,7 +66,17 @@ Technology is prohibited.
 #include "PlayerSceneControls.h"
 
 #include "AnimationController.h"
-#include "DespawnManager.h"
+#include "TimerService.h"
+#include "GameplayEvents.h"
+#include "FramePacer.h"
+#include "LuaBytecodeCache.h"
+#include "WorldSnapshot.h"
+#include "ScenePreloader.h"
+#include "AssetPack.h"
+#include "StartupGraph.h"
+#include "StreamingBufferManager.h"
+#include "JobSystem.h"
+#include "SystemScheduler.h"
 
 
 
@@ -108,6 +119,7 @@ FrameBuffer frameBuffer;
 //constexpr float targetFPS = 60.f;
 //constexpr float frameDuration = 1000.0f / targetFPS;
 std::string currentScene;
+WorldSnapshot sceneSnapshot;
 double accumulatedTime = (0.0);
 double oldTime = glfwGetTime();
 
@@ -568,6 +580,20 @@ namespace Utilities {
         throw std::invalid_argument("No valid numeric prefix found before underscore!");
     }
 
+    /**
+     * @brief Reads the optional load mode of a sound asset, e.g. Loading = { Mode = "streamed" }.
+     *
+     * @param luaManager The manager of sounds.lua.
+     * @param tableName The asset's table.
+     * @return "decompressed", "compressed" or "streamed", empty if the asset has no Loading table.
+     */
+    std::string ReadSoundLoadMode(LuaManager& luaManager, const std::string& tableName) {
+        if (!luaManager.TableExists(tableName, "Loading")) {
+            return "";
+        }
+        return luaManager.LuaRead<std::string>(tableName, { "Loading", "Mode" });
+    }
+
 #ifdef _IMGUI
     /**
      * @brief Updates texture assets based on changes from a new list of textures.
@@ -768,6 +794,20 @@ namespace Utilities {
         std::vector<std::string> sortedHolder = holder;
         SortByIndex(sortedHolder);
 
+        // Load modes set by hand in sounds.lua survive the rewrite, matched by path
+        std::unordered_map<std::string, std::string> loadModes;
+        {
+            LuaManager previous("Assets/Lua/sounds.lua");
+            int numOfSounds = previous.countTables();
+            for (int i = 0; i < numOfSounds; ++i) {
+                std::string tableName = "Asset_" + std::to_string(i);
+                std::string mode = ReadSoundLoadMode(previous, tableName);
+                if (!mode.empty()) {
+                    loadModes[previous.LuaRead<std::string>(tableName, { "Sound", "SoundPathName" })] = mode;
+                }
+            }
+        }
+
         // Update Lua file with new assets
         LuaManager luaManager("Assets/Lua/sounds.lua");
         luaManager.ClearLuaFile();
@@ -794,6 +834,11 @@ namespace Utilities {
 
 
             luaManager.LuaWrite(tableName, values, keys, "Sound");
+
+            auto mode = loadModes.find(filePath);
+            if (mode != loadModes.end()) {
+                luaManager.LuaWrite(tableName, { mode->second }, { "Mode" }, "Loading");
+            }
         }
 
     }
@@ -854,14 +899,81 @@ namespace Utilities {
                 std::string fileName = luaManager.LuaRead<std::string>(tableName, { "Sound", "SoundFileName" });
                 int audioType = luaManager.LuaRead<int>(tableName, { "Sound", "SoundType" });
                 int priority = luaManager.LuaRead<int>(tableName, { "Sound", "Priority" });
+                std::string loadMode = ReadSoundLoadMode(luaManager, tableName);
 
-                AssetManager::GetInstance().LoadAudios(pathName, fileName, audioType, priority);
+                AssetManager::GetInstance().LoadAudios(pathName, fileName, audioType, priority, loadMode);
             }
             catch (const std::exception& e) {
 				ImGuiConsole::Cout("Error reading table %s: %s\n", tableName.c_str(), e.what());
             }
         }
     }
+
+    /**
+     * @brief Applies a batch of texture file changes reported by the AssetWatcher.
+     *
+     * Only the textures that changed are loaded, reloaded or removed. A modified texture
+     * keeps its Texture object, so the sprites already drawing it show the new pixels.
+     * textures.lua numbers its tables by position, so it is rewritten from the directory
+     * when a texture is added or removed. Each added texture is loaded and each removed one
+     * dropped here, which is what SyncTextureAssetsWithLua used to do for the whole list.
+     *
+     * @param changes The files that changed in Assets/Textures/.
+     */
+    void ApplyTextureChanges(const std::vector<AssetWatcher::FileChange>& changes) {
+        bool listingChanged = false;
+        for (const AssetWatcher::FileChange& change : changes) {
+            std::string fileName = Utilities::extractFileName(change.path);
+            if (change.type == AssetWatcher::ChangeType::REMOVED) {
+                AssetManager::GetInstance().RemoveTexture(fileName);
+            }
+            else if (change.type == AssetWatcher::ChangeType::ADDED ||
+                !AssetManager::GetInstance().ReloadTexture(change.path, fileName)) {
+                AssetManager::GetInstance().LoadTexture(change.path, fileName, 1.0f, 1.0f, 1.0f);
+            }
+            listingChanged = listingChanged || change.type != AssetWatcher::ChangeType::MODIFIED;
+            ImGuiConsole::Cout("Texture %s %s", fileName.c_str(),
+                change.type == AssetWatcher::ChangeType::ADDED ? "added" : change.type == AssetWatcher::ChangeType::REMOVED ? "removed" : "reloaded");
+        }
+
+        if (listingChanged) {
+            UpdateTextureAssetChanges(getAssetFiles("Assets/Textures/"), {}, 0);
+        }
+    }
+
+    /**
+     * @brief Applies a batch of sound file changes reported by the AssetWatcher.
+     *
+     * Only the sounds that changed are loaded, reloaded or removed. sounds.lua numbers its
+     * tables by position, so it is rewritten when a sound is added or removed.
+     *
+     * @param changes The files that changed in Assets/sounds/.
+     */
+    void ApplySoundChanges(const std::vector<AssetWatcher::FileChange>& changes) {
+        bool listingChanged = false;
+        for (const AssetWatcher::FileChange& change : changes) {
+            try {
+                std::string fileName = Utilities::extractSoundName(change.path);
+                if (change.type == AssetWatcher::ChangeType::REMOVED) {
+                    AssetManager::GetInstance().RemoveSound(Utilities::extractIndex(Utilities::extractFileName(change.path)));
+                }
+                else if (change.type == AssetWatcher::ChangeType::ADDED ||
+                    !AssetManager::GetInstance().ReloadAudio(change.path, fileName)) {
+                    AssetManager::GetInstance().LoadAudios(change.path, fileName, Utilities::extractSoundType(fileName), 0);
+                }
+                listingChanged = listingChanged || change.type != AssetWatcher::ChangeType::MODIFIED;
+                ImGuiConsole::Cout("Sound %s %s", fileName.c_str(),
+                    change.type == AssetWatcher::ChangeType::ADDED ? "added" : change.type == AssetWatcher::ChangeType::REMOVED ? "removed" : "reloaded");
+            }
+            catch (const std::exception& e) {
+                ImGuiConsole::Cout("Error applying change to %s: %s\n", change.path.c_str(), e.what());
+            }
+        }
+
+        if (listingChanged) {
+            UpdateSoundAssetChanges(getAssetFiles("Assets/sounds/"), {}, 0);
+        }
+    }
 #endif // _IMGUI
     /**
  * @brief Loads texture assets from a Lua table file.
@@ -888,7 +1000,8 @@ namespace Utilities {
                 float frameX = 1.0f;
                 float frameY = 1.0f;
 
-                AssetManager::GetInstance().LoadTexture(pathName, fileName, frameX, frameY, animationFrame);
+                // Loaded by the first GetSprite, so scenes only pay for the textures they use
+                AssetManager::GetInstance().RegisterTexture(pathName, fileName, frameX, frameY, animationFrame);
             }
             catch (const std::exception& e) {
 				ImGuiConsole::Cout("Error reading table %s: %s\n", tableName.c_str(), e.what());
@@ -919,13 +1032,26 @@ namespace Utilities {
                 std::string fileName = luaManager.LuaRead<std::string>(tableName, { "Sound", "SoundFileName" });
                 int audioType = luaManager.LuaRead<int>(tableName, { "Sound", "SoundType" });
                 int priority = luaManager.LuaRead<int>(tableName, { "Sound", "Priority" });
+                std::string loadMode = ReadSoundLoadMode(luaManager, tableName);
 
-                AssetManager::GetInstance().LoadAudios(pathName, fileName, audioType, priority);
+                AssetManager::GetInstance().LoadAudios(pathName, fileName, audioType, priority, loadMode);
             }
             catch (const std::exception& e) {
 				ImGuiConsole::Cout("Error reading table %s: %s\n", tableName.c_str(), e.what());
             }
         }
+
+        // A backend without a decoder for a format leaves its sounds silent, which is easy to miss in play
+        std::vector<std::string> failed = AssetManager::GetInstance().GetFailedAudio();
+        if (!failed.empty()) {
+            const char* backendName = AudioManager::GetInstance().GetBackend().GetName();
+            ImGuiConsole::Cout("ERROR: %zu sounds could not be loaded by the %s audio backend and will not play:", failed.size(), backendName);
+            std::cerr << "ERROR: " << failed.size() << " sounds could not be loaded by the " << backendName << " audio backend and will not play:\n";
+            for (const std::string& sound : failed) {
+                ImGuiConsole::Cout("  %s", sound.c_str());
+                std::cerr << "  " << sound << "\n";
+            }
+        }
     }
 
 }
@@ -2634,9 +2760,41 @@ namespace EngineImGuiWindows {
             }
             else {
                 for (int i = 0; i < assetManager.audioObjects.size(); i++) {
-                    ImGui::Text("Audio Name: %s", assetManager.audioObjects.at(i)->GetAudioName().c_str());
+                    Audio* audio = assetManager.audioObjects.at(i);
+                    ImGui::Text("Audio Name: %s (%s%s)", audio->GetAudioName().c_str(), AudioBackend::GetLoadModeName(audio->GetLoadMode()),
+                        audio->IsLoaded() ? "" : ", unloaded");
                 }
             }
+            AudioMemoryReport memory = AudioManager::GetInstance().GetMemoryReport();
+            StreamingBufferManager::Stats streams = StreamingBufferManager::GetInstance().GetStats();
+            ImGui::Separator();
+            ImGui::Text("Sounds: %d decompressed, %d compressed, %d streamed", memory.sounds[0], memory.sounds[1], memory.sounds[2]);
+            ImGui::Text("Memory: %.1f KB resident, %.1f KB stream buffers", memory.residentBytes / 1024.0, memory.streamBufferBytes / 1024.0);
+            ImGui::Text("All decompressed: %.1f KB", memory.decodedBytes / 1024.0);
+            ImGui::Text("Resident: %.1f MB of %.1f MB budget", assetManager.GetResidentAudioBytes() / (1024.0 * 1024.0), assetManager.GetAudioBudget() / (1024.0 * 1024.0));
+            int audioBudgetMB = static_cast<int>(assetManager.GetAudioBudget() / (1024 * 1024));
+            if (ImGui::SliderInt("Audio Budget (MB)", &audioBudgetMB, 4, 512)) {
+                assetManager.SetAudioBudget(static_cast<size_t>(audioBudgetMB) * 1024 * 1024);
+            }
+            if (ImGui::Button("Unload Unused Audio")) {
+                ImGuiConsole::Cout("Unloaded %d sounds", assetManager.UnloadUnusedAudio());
+            }
+            ImGui::Text("Streams: %d open, peak %d, %llu buffer refills", streams.openStreams, streams.peakStreams, static_cast<unsigned long long>(streams.refills));
+            ImGui::TreePop();
+        }
+
+        // Voice section
+        if (ImGui::TreeNode("Voices")) {
+            VoiceManager::Stats voiceStats = AudioManager::GetInstance().GetVoiceStats();
+            ImGui::Text("Playing: %d (%d real, %d virtual), peak %d", voiceStats.playing, voiceStats.real, voiceStats.virtualVoices, voiceStats.peakPlaying);
+            ImGui::Text("Requested: %llu, started: %llu", static_cast<unsigned long long>(voiceStats.requested), static_cast<unsigned long long>(voiceStats.started));
+            ImGui::Text("Suppressed by cooldown: %llu", static_cast<unsigned long long>(voiceStats.suppressed));
+            ImGui::Text("Rejected: %llu, stolen: %llu", static_cast<unsigned long long>(voiceStats.rejected), static_cast<unsigned long long>(voiceStats.stolen));
+            ImGui::Text("Virtualised: %llu", static_cast<unsigned long long>(voiceStats.virtualised));
+            ImGui::Text("Commands dropped: %llu", static_cast<unsigned long long>(AudioManager::GetInstance().GetDroppedCommands()));
+            if (ImGui::Button("Reset Voice Stats")) {
+                AudioManager::GetInstance().ResetVoiceStats();
+            }
             ImGui::TreePop();
         }
 
@@ -2670,20 +2828,41 @@ namespace EngineImGuiWindows {
         }
         // Textures section
         if (ImGui::TreeNode("Textures")) {
+            // Every registered texture is listed; most are only loaded once a scene uses them
+            const std::vector<std::string> textureNames = assetManager.GetTextureNames();
             const auto& textures = assetManager.GetTextures();
 
-            if (textures.empty()) {
-                ImGui::Text("No textures loaded.");
+            if (textureNames.empty()) {
+                ImGui::Text("No textures registered.");
             }
             else {
-                ImGui::Text("Total Textures Loaded: %d", assetManager.GetTotalTextureLoaded());
+                ImGui::Text("Textures: %zu registered, %d resident", textureNames.size(), assetManager.GetTotalTextureLoaded());
+                ImGui::Text("Resident: %.1f MB of %.1f MB budget", assetManager.GetResidentTextureBytes() / (1024.0 * 1024.0), assetManager.GetTextureBudget() / (1024.0 * 1024.0));
+                int budgetMB = static_cast<int>(assetManager.GetTextureBudget() / (1024 * 1024));
+                if (ImGui::SliderInt("Budget (MB)", &budgetMB, 16, 2048)) {
+                    assetManager.SetTextureBudget(static_cast<size_t>(budgetMB) * 1024 * 1024);
+                }
+                if (ImGui::Button("Unload Unused")) {
+                    ImGuiConsole::Cout("Unloaded %d textures", assetManager.UnloadUnusedTextures());
+                }
                 ImGui::Separator();
 
-                for (const auto& [name, texture] : textures) {
-                    if (ImGui::TreeNode(name.c_str())) {
-                        // Display texture preview if it's available
+                for (const std::string& name : textureNames) {
+                    auto textureIt = textures.find(name);
+                    const bool resident = textureIt != textures.end();
+                    if (ImGui::TreeNode(name.c_str(), "%s%s", name.c_str(), resident ? "" : " (not loaded)")) {
                         ImGui::Text("Name: %s", name.c_str());
 
+                        if (!resident) {
+                            ImGui::Text("Loaded on first use");
+                            if (ImGui::Button("Load")) {
+                                assetManager.GetSprite(name);
+                            }
+                            ImGui::TreePop();
+                            continue;
+                        }
+                        const std::shared_ptr<Texture>& texture = textureIt->second;
+
                         // Get texture ID and display a preview
                         unsigned int textureID = texture->GetTextureID();
                         ImVec2 previewSize(64, 64); // Adjust size as needed
@@ -2716,6 +2895,31 @@ namespace EngineImGuiWindows {
             ImGui::TreePop();
         }
 
+        // Residency section
+        if (ImGui::TreeNode("Residency")) {
+            std::vector<ResidencyInfo> report = assetManager.GetResidencyReport();
+            if (ImGui::BeginTable("ResidencyTable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, 300))) {
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Type");
+                ImGui::TableSetupColumn("KB");
+                ImGui::TableSetupColumn("Refs");
+                ImGui::TableSetupColumn("State");
+                ImGui::TableSetupColumn("Last Used");
+                ImGui::TableHeadersRow();
+                for (const ResidencyInfo& info : report) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("%s", info.name.c_str());
+                    ImGui::TableNextColumn(); ImGui::Text("%s", info.type.c_str());
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f", info.bytes / 1024.0);
+                    ImGui::TableNextColumn(); ImGui::Text("%ld", info.references);
+                    ImGui::TableNextColumn(); ImGui::Text("%s", !info.resident ? "unloaded" : info.pinned ? "pinned" : info.inScene ? "scene" : "cached");
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(info.lastUsed));
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+
         // Font section
         if (ImGui::TreeNode("Fonts")) {
             auto fontInfos = assetManager.GetFontInfo();
@@ -2831,11 +3035,114 @@ namespace EngineImGuiWindows {
         ImGui::End();
     }
 
+    // display when and on which thread each system ran in the last frame
+    void FrameTimelineWindow()
+    {
+        SystemScheduler& scheduler = SystemScheduler::GetInstance();
+        static bool frozen = false;
+        static std::vector<SystemScheduler::SystemTiming> shown;
+        static double shownTime = 0.0;
+        static bool shownSerial = false;
+        if (!frozen || shown.empty()) {
+            shown = scheduler.GetTimeline();
+            shownTime = scheduler.GetFrameTime();
+            shownSerial = scheduler.WasSerial();
+        }
+
+        ImGui::Begin("Frame Timeline");
+        bool serialMode = scheduler.IsSerial();
+        if (ImGui::Checkbox("Serial", &serialMode)) {
+            scheduler.SetSerial(serialMode);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Freeze", &frozen);
+
+        // Busy time above the frame time is what running systems side by side saved
+        double busyTime = 0.0;
+        int rows = 1;
+        for (const SystemScheduler::SystemTiming& timing : shown) {
+            busyTime += timing.end - timing.start;
+            rows = std::max(rows, timing.thread + 1);
+        }
+        ImGui::Text("%s: %.3f ms, %.3f ms of system work, %u workers", shownSerial ? "Serial" : "Parallel",
+            shownTime, busyTime, JobSystem::GetInstance().GetWorkerCount());
+
+        // One row per thread, the main thread at the top
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing() + 4.0f;
+        const float labelWidth = ImGui::CalcTextSize("Worker 00").x + 8.0f;
+        const float width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 1.0f);
+        const double scale = shownTime > 0.0 ? width / shownTime : 0.0;
+        for (int row = 0; row < rows; ++row) {
+            std::string label = row == 0 ? "Main" : "Worker " + std::to_string(row);
+            drawList->AddText(ImVec2(origin.x, origin.y + row * rowHeight + 2.0f), ImGui::GetColorU32(ImGuiCol_Text), label.c_str());
+        }
+
+        const ImVec2 mouse = ImGui::GetMousePos();
+        int hovered = -1;
+        for (size_t index = 0; index < shown.size(); ++index) {
+            const SystemScheduler::SystemTiming& timing = shown[index];
+            const float top = origin.y + std::max(timing.thread, 0) * rowHeight;
+            const ImVec2 min(origin.x + labelWidth + static_cast<float>(timing.start * scale), top);
+            const ImVec2 max(std::max(min.x + 2.0f, origin.x + labelWidth + static_cast<float>(timing.end * scale)), top + rowHeight - 2.0f);
+            drawList->AddRectFilled(min, max, ImColor::HSV(static_cast<float>(index) / shown.size(), 0.6f, 0.8f));
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), timing.name);
+            drawList->PopClipRect();
+            if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+                hovered = static_cast<int>(index);
+            }
+        }
+        ImGui::Dummy(ImVec2(labelWidth + width, rows * rowHeight));
+
+        if (hovered >= 0 && ImGui::IsWindowHovered()) {
+            const SystemScheduler::SystemTiming& timing = shown[hovered];
+            ImGui::BeginTooltip();
+            ImGui::Text("%s", timing.name);
+            ImGui::Text("%.3f ms, from %.3f to %.3f ms", timing.end - timing.start, timing.start, timing.end);
+            std::string after;
+            for (size_t dependency : timing.dependencies) {
+                after += after.empty() ? "" : ", ";
+                after += shown[dependency].name;
+            }
+            ImGui::Text("After: %s", after.empty() ? "nothing" : after.c_str());
+            ImGui::EndTooltip();
+        }
+        ImGui::End();
+    }
+
     // display the fps
     void FPSWindow()
     {
         ImGui::Begin("FPS", nullptr, ImGuiWindowFlags_NoMove);
         ImGui::Text("Game is running at %.1f FPS", ImGui::GetIO().Framerate);
+
+        // Frame pacing over the last few seconds
+        const FramePacer::Stats pacing = FramePacer::GetInstance().GetStats();
+        ImGui::Text("Frame time: %.2f ms (target %.2f), jitter %.3f ms, worst %.2f ms",
+            pacing.averageFrameTime, pacing.targetFrameTime, pacing.jitter, pacing.worstFrameTime);
+        ImGui::Text("Wait: %.2f ms asleep, %.3f ms spinning, overshoot estimate %.3f ms",
+            pacing.averageSleep, pacing.averageSpin, pacing.sleepOvershoot);
+        ImGui::Text("Late: %.3f ms average, %.3f ms worst, %llu missed frames",
+            pacing.averageLateness, pacing.worstLateness, static_cast<unsigned long long>(pacing.missedFrames));
+
+        // Lua states created per second, sampled once a second
+        static unsigned long long lastStatesCreated = LuaStateCache::GetStatesCreated();
+        static double lastSampleTime = glfwGetTime();
+        static double statesPerSecond = 0.0;
+        double now = glfwGetTime();
+        if (now - lastSampleTime >= 1.0) {
+            unsigned long long statesCreated = LuaStateCache::GetStatesCreated();
+            statesPerSecond = static_cast<double>(statesCreated - lastStatesCreated) / (now - lastSampleTime);
+            lastStatesCreated = statesCreated;
+            lastSampleTime = now;
+        }
+        ImGui::Text("Lua states created: %llu (%.1f/s)", LuaStateCache::GetStatesCreated(), statesPerSecond);
+        const unsigned long long cacheHits = LuaStateCache::GetCacheHits();
+        const unsigned long long cacheLookups = cacheHits + LuaStateCache::GetCacheMisses();
+        ImGui::Text("Lua state cache: %llu of %llu hits (%.1f%%)", cacheHits, cacheLookups,
+            cacheLookups > 0 ? 100.0 * static_cast<double>(cacheHits) / static_cast<double>(cacheLookups) : 0.0);
         ImGui::End();
     }
 
@@ -2856,7 +3163,7 @@ namespace EngineImGuiWindows {
 
         // Buttons for other functionalities
         if (ImGui::Button("Save Scene")) {
-            factory.SerializeAllGameObjects(saveFilePath);
+            factory.SaveChangedGameObjects(saveFilePath);
         }
 #pragma endregion SaveScene
 
@@ -2909,6 +3216,25 @@ namespace EngineImGuiWindows {
             Engine::GetInstance().LoadSceneFromLua(loadFilePath);
         }
 
+        // Bake every scene and prefab into the binary format the loader maps when it is up to date
+        if (ImGui::Button("Cook Scenes")) {
+            int cookedScenes = CookedScene::BakeDirectory("Assets/Lua/Scenes");
+            int cookedPrefabs = CookedScene::BakeDirectory("Assets/Lua/Prefabs");
+            int compiledFiles = LuaBytecodeCache::CookDirectory("Assets/Lua");
+            ImGuiConsole::Cout("Cooked %d scenes and %d prefabs, compiled %d Lua files", cookedScenes, cookedPrefabs, compiledFiles);
+        }
+
+        // Pack the whole Assets directory into the archive shipping builds mount at startup
+        ImGui::SameLine();
+        if (ImGui::Button("Pack Assets")) {
+            auto packStart = std::chrono::high_resolution_clock::now();
+            int packedFiles = AssetPack::Build("Assets", "Assets.pak");
+            std::chrono::duration<double, std::milli> packElapsed = std::chrono::high_resolution_clock::now() - packStart;
+            if (packedFiles >= 0) {
+                ImGuiConsole::Cout("Packed %d files into Assets.pak in %.1f ms", packedFiles, packElapsed.count());
+            }
+        }
+
         //auto end = std::chrono::high_resolution_clock::now();
         //std::chrono::duration<double> elapsed = end - start;
         //ImGuiConsole::Cout("Elapsed RUN time: " << elapsed.count() << " seconds\n";
@@ -3090,6 +3416,12 @@ namespace EngineImGuiWindows {
             ImGui::Separator();
             ImGui::Text("Current Events:");
 
+            ImGui::Text("Simulation Time: %.3f s", EventSystem::GetInstance().GetSimulationTime());
+            for (const auto& dispatch : EventSystem::GetInstance().GetDispatchLog()) {
+                ImGui::Text("Dispatched: Event %llu at step %llu, %.2f ms after it was due",
+                    static_cast<unsigned long long>(dispatch.sequence), static_cast<unsigned long long>(dispatch.step), dispatch.lateness * 1000.0);
+            }
+
             auto eventsCopy = EventSystem::GetInstance().GetEventQueue();
             auto missionsCopy = EventSystem::GetInstance().GetMissionVector();
             if (eventsCopy.empty()) {
@@ -3112,6 +3444,15 @@ namespace EngineImGuiWindows {
                         static_cast<int>(mission.enemyType), mission.numEnemies, mission.isCompleted);
                 }
             }
+
+            ImGui::Separator();
+            ImGui::Text("Event Bus:");
+            for (const auto& channel : EventBus::GetInstance().GetStats()) {
+                ImGui::Text("%s: Phase %d, %zu subscribers, %zu queued, %llu dispatched in %llu batches, %llu overflowed",
+                    channel.name, static_cast<int>(channel.phase), channel.subscribers, channel.queued,
+                    static_cast<unsigned long long>(channel.dispatched), static_cast<unsigned long long>(channel.batches),
+                    static_cast<unsigned long long>(channel.overflowed));
+            }
         }
 
 
@@ -3159,146 +3500,197 @@ void Engine::Init(GLint width, GLint height) {
 	   fixedDT= 1.0 / TargetFrameRate;
 	   fixedDeltaTimeMilli = fixedDT * 1000.0;
     }
+    // Timers count fixed steps, so delays are the same at any frame rate
+    TimerService::GetInstance().SetTickLength(fixedDT);
 
-    Graphics::GraphicsManager& gMan = Graphics::GraphicsManager::GetInstance();
-    (void)gMan;
     (void)height;
     (void)width;
 
-    TagManager::GetInstance().PreloadTags(); //Preload tags
-    LayerManager::GetInstance().PreloadLayers(); //Preload layers
+    // Worker threads for frame work; this thread stays the one that owns OpenGL
+    JobSystem::GetInstance().Init();
+
+    // Systems = { Scheduler = { Serial = true } } runs the frame's systems one after another
+    if (luaManager.TableExists("Systems", "Scheduler")) {
+        SystemScheduler::GetInstance().SetSerial(luaManager.LuaRead<bool>("Systems", { "Scheduler", "Serial" }));
+    }
+    RegisterSystems();
+    missionsCompletedSubscription = EventBus::GetInstance().Subscribe<MissionsCompletedEvent>([this](const MissionsCompletedEvent&) {
+        OnMissionsCompleted();
+    });
+
+    // Startup runs as a dependency graph. CPU work goes to worker threads,
+    // anything that touches OpenGL or GLFW is pinned to this thread.
+    StartupGraph startup;
+    using Affinity = StartupGraph::Affinity;
+    const std::string nameofFile = "Assets/Lua/Scenes/OpeningScene.lua";
+
+    startup.AddTask("Tags", []() { TagManager::GetInstance().PreloadTags(); });
+    startup.AddTask("Layers", []() { LayerManager::GetInstance().PreloadLayers(); });
+    startup.AddTask("RasterizeFonts", []() { AssetManager::GetInstance().RasterizeFonts(); });
+    startup.AddTask("Graphics", []() { Graphics::GraphicsManager::GetInstance(); },
+        { "RasterizeFonts" }, Affinity::MAIN_THREAD);
 
 #ifdef _IMGUI
-    InitializeGLWrappers();
-    ImGui::GetIO().ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+    startup.AddTask("EditorGL", [this, &luaManager, width, height]() {
+        InitializeGLWrappers();
+        ImGui::GetIO().ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 
-    //gMan.Init();
-    if (luaManager.LuaReadFromWindow<bool>("Fullscreen")) {
-        // Get the primary monitor
-        GLFWmonitor* primaryMonitor = glfwGetPrimaryMonitor();
-        const GLFWvidmode* mode = glfwGetVideoMode(primaryMonitor);
+        //gMan.Init();
+        if (luaManager.LuaReadFromWindow<bool>("Fullscreen")) {
+            // Get the primary monitor
+            GLFWmonitor* primaryMonitor = glfwGetPrimaryMonitor();
+            const GLFWvidmode* mode = glfwGetVideoMode(primaryMonitor);
 
-        frameBuffer.Init(mode->width, mode->height);
-    }
-    else
-        frameBuffer.Init(width, height);
+            frameBuffer.Init(mode->width, mode->height);
+        }
+        else
+            frameBuffer.Init(width, height);
+    }, { "Graphics" }, Affinity::MAIN_THREAD);
+
+    startup.AddTask("TextureList", [this]() {
 #pragma region InitTextures
 
 
-    //Extract filepaths from directory
-    std::vector<std::string> holder = Utilities::getAssetFiles("Assets/Textures/");
+        //Extract filepaths from directory
+        std::vector<std::string> holder = Utilities::getAssetFiles("Assets/Textures/");
 
 
 
-    // Check if there�s a change in the number of files then enter the if loop
-    if (holder.size() != previousFrameHolderSize) {
+        // Check if there�s a change in the number of files then enter the if loop
+        if (holder.size() != previousFrameHolderSize) {
 
-        std::vector<std::string> keys;
-        LuaManager::LuaValueContainer values;
-        LuaManager luaManagerTmp("Assets/Lua/textures.lua");
-        luaManagerTmp.ClearLuaFile();
+            std::vector<std::string> keys;
+            LuaManager::LuaValueContainer values;
+            LuaManager luaManagerTmp("Assets/Lua/textures.lua");
+            luaManagerTmp.ClearLuaFile();
 
-        // Update Lua 
-        for (size_t i = 0; i < holder.size(); ++i) {
+            // Update Lua 
+            for (size_t i = 0; i < holder.size(); ++i) {
 
-            std::string tableName = "Asset_" + std::to_string(i);
+                std::string tableName = "Asset_" + std::to_string(i);
 
-            // Extract the file path
-            std::string filePath = holder[i];
-            keys.push_back("SpritePathName");
-            values.push_back(filePath);
+                // Extract the file path
+                std::string filePath = holder[i];
+                keys.push_back("SpritePathName");
+                values.push_back(filePath);
 
-            // Extract the file name
-            std::string fileName = Utilities::extractFileName(holder[i]);
-            keys.push_back("SpriteFileName");
-            values.push_back(fileName);
+                // Extract the file name
+                std::string fileName = Utilities::extractFileName(holder[i]);
+                keys.push_back("SpriteFileName");
+                values.push_back(fileName);
 
-            // Write to Lua with the correct file path and file name
-            luaManagerTmp.LuaWrite(tableName, values, keys, "Texture");
+                // Write to Lua with the correct file path and file name
+                luaManagerTmp.LuaWrite(tableName, values, keys, "Texture");
 
-            keys.clear();
-            values.clear();  // Clear for the next table
-        }
+                keys.clear();
+                values.clear();  // Clear for the next table
+            }
 
 
-        int numOfTextures = luaManagerTmp.countTables();
-        //AssetManager* assetManag = AssetManager::GetInstance();
+            int numOfTextures = luaManagerTmp.countTables();
+            //AssetManager* assetManag = AssetManager::GetInstance();
 
-        for (int i = 0; i < numOfTextures; ++i) {
-            // Construct the table name dynamically
-            std::string tableName = "Asset_" + std::to_string(i);
+            for (int i = 0; i < numOfTextures; ++i) {
+                // Construct the table name dynamically
+                std::string tableName = "Asset_" + std::to_string(i);
 
-            try {
-                // Read properties from the Lua table
-                std::string pathName = luaManagerTmp.LuaRead<std::string>(tableName, { "Texture", "SpritePathName" });
-                std::string fileName = luaManagerTmp.LuaRead<std::string>(tableName, { "Texture" , "SpriteFileName" });
-                float animationFrame = 1.0f;
-                float frameX = 1.0f;
-                float frameY = 1.0f;
+                try {
+                    // Read properties from the Lua table
+                    std::string pathName = luaManagerTmp.LuaRead<std::string>(tableName, { "Texture", "SpritePathName" });
+                    std::string fileName = luaManagerTmp.LuaRead<std::string>(tableName, { "Texture" , "SpriteFileName" });
+                    float animationFrame = 1.0f;
+                    float frameX = 1.0f;
+                    float frameY = 1.0f;
 
-                AssetManager::GetInstance().LoadTexture(pathName, fileName, frameX, frameY, animationFrame);
+                    // Loaded by the first GetSprite, so scenes only pay for the textures they use
+                    AssetManager::GetInstance().RegisterTexture(pathName, fileName, frameX, frameY, animationFrame);
 
 
+                }
+                catch (const std::exception& e) {
+    				ImGuiConsole::Cout("Error reading table %s: %s\n", tableName.c_str(), e.what());
+                }
             }
-            catch (const std::exception& e) {
-				ImGuiConsole::Cout("Error reading table %s: %s\n", tableName.c_str(), e.what());
-            }
-        }
 
 
-        // Update previous holder size after writing to Lua
-        previousFrameHolderSize = holder.size();
-    }
+            // Update previous holder size after writing to Lua
+            previousFrameHolderSize = holder.size();
+        }
 #pragma endregion InitTextures
+    });
 
-
+    startup.AddTask("SoundList", []() {
 #pragma region InitSounds
-    static size_t previousSoundHolderSize = 0;
-    static std::vector<std::string> soundPrevholder = Utilities::getAssetFiles("Assets/sounds/");
-    // Extract filepaths from directory
-    std::vector<std::string> soundHolder = Utilities::getAssetFiles("Assets/sounds/");
+        static size_t previousSoundHolderSize = 0;
+        static std::vector<std::string> soundPrevholder = Utilities::getAssetFiles("Assets/sounds/");
+        // Extract filepaths from directory
+        std::vector<std::string> soundHolder = Utilities::getAssetFiles("Assets/sounds/");
 
-    if (soundHolder.size() != previousSoundHolderSize) {
-		ImGuiConsole::Cout("CHANGE DETECTED!!!");
-        // Update asset changes if needed
-        Utilities::UpdateSoundAssetChanges(soundHolder, soundPrevholder, previousSoundHolderSize);
+        if (soundHolder.size() != previousSoundHolderSize) {
+    		ImGuiConsole::Cout("CHANGE DETECTED!!!");
+            // Update asset changes if needed
+            Utilities::UpdateSoundAssetChanges(soundHolder, soundPrevholder, previousSoundHolderSize);
 
-        // Sync assets with Lua and load textures
-        Utilities::SyncSoundAssetsWithLua(soundHolder);
+            // Sync assets with Lua and load textures
+            Utilities::SyncSoundAssetsWithLua(soundHolder);
 
-        // Update the state for the next frame
-        soundPrevholder = soundHolder;
-        previousSoundHolderSize = holder.size();
+            // Update the state for the next frame
+            soundPrevholder = soundHolder;
+            previousSoundHolderSize = soundHolder.size();
 
-    }
+        }
 #pragma endregion InitSounds
-#else
+    });
 
-#endif // _IMGUI
-    Utilities::LoadSoundAssetsWithLua("Assets/Lua/sounds.lua");
-    Utilities::LoadTextureAssetsWithLua("Assets/Lua/textures.lua");
+    // Later additions, edits and removals are picked up without listing the directories every frame
+    startup.AddTask("AssetWatch", []() {
+        AssetWatcher::GetInstance().Watch("Assets/Textures/", Utilities::ApplyTextureChanges);
+        AssetWatcher::GetInstance().Watch("Assets/sounds/", Utilities::ApplySoundChanges);
+    }, { "TextureList", "SoundList" }, Affinity::MAIN_THREAD);
 
+    const std::vector<std::string> textureDependencies{ "TextureList" };
+    const std::vector<std::string> soundDependencies{ "SoundList" };
+#else
+    const std::vector<std::string> textureDependencies;
+    const std::vector<std::string> soundDependencies;
+#endif // _IMGUI
+    // Audio backends create sounds thread-safely, so sounds can be created off the main thread
+    startup.AddTask("Sounds", []() { Utilities::LoadSoundAssetsWithLua("Assets/Lua/sounds.lua"); }, soundDependencies);
+    startup.AddTask("Textures", []() { Utilities::LoadTextureAssetsWithLua("Assets/Lua/textures.lua"); }, textureDependencies);
 
-    TagManager::GetInstance().PreloadTags(); //Preload tags
-    LayerManager::GetInstance().PreloadLayers(); //Preload layers
-    GameObjectFactory& factory = GameObjectFactory::GetInstance();
-    (void)factory;
+    // The scene image and its textures are prepared on the preloader's own thread while everything
+    // else loads. The preload looks textures up by name, so it waits for them to be registered
+    startup.AddTask("PreloadScene", [&nameofFile]() { ScenePreloader::GetInstance().Preload(nameofFile); },
+        { "Textures" }, Affinity::MAIN_THREAD);
 
 #pragma region InitScene
 
     //Create from scene1
-    std::string nameofFile = "Assets/Lua/Scenes/OpeningScene.lua";  // Use the inputted file path
-    LoadSceneFromLua(nameofFile);
-    //Utilities::SpawnGrassObjects(factory, 20);
-#pragma endregion InitScene
+    startup.AddTask("Scene", [this, &nameofFile]() {
+        GameObjectFactory& factory = GameObjectFactory::GetInstance();
+        (void)factory;
+        LoadSceneFromLua(nameofFile);
+        //Utilities::SpawnGrassObjects(factory, 20);
+    }, { "PreloadScene", "Tags", "Layers", "Graphics", "Sounds", "Textures"
 #ifdef _IMGUI
-#else
-#endif
+        , "EditorGL"
+#endif // _IMGUI
+    }, Affinity::MAIN_THREAD);
+#pragma endregion InitScene
 
+    startup.Run();
+#ifdef _LOGGING
+    startup.Report("Engine startup");
+    AudioMemoryReport audioMemory = AudioManager::GetInstance().GetMemoryReport();
+    ImGuiConsole::Cout("Audio memory: %zu KB resident + %zu KB stream buffers, %zu KB if all decompressed",
+        audioMemory.residentBytes / 1024, audioMemory.streamBufferBytes / 1024, audioMemory.decodedBytes / 1024);
+#endif // _LOGGING
 }
 
 // Updates the engine (e.g., handles input, updates game logic).
 void Engine::Update() {
+    // Jobs that had to wait for the OpenGL thread
+    JobSystem::GetInstance().RunMainThreadJobs();
 
     if (!showCursor) {
         glfwSetInputMode(InputManager::ptrWindow, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
@@ -3345,13 +3737,145 @@ void Engine::Update() {
         LoadSceneFromLua("Assets/Lua/Scenes/CutScene.lua");
     }
     
-    AudioManager::GetInstance().Update();
+    // Positional sound effects are heard from the player
+    if (GameObject* listener = GameObjectFactory::GetInstance().GetPlayerObject()) {
+        if (auto* listenerTransform = listener->GetComponent<TransformComponent>(TypeOfComponent::TRANSFORM)) {
+            AudioManager::GetInstance().SetListenerPosition(listenerTransform->GetPosition());
+        }
+    }
 	UpdateFixedTimeStep(glfwGetTime());
 
-    // In your game's update loop
-    DespawnManager::GetInstance().Update();
+    // Timers, frame start events, game flow, game objects, gameplay events, wave events, collision, physics,
+    // audio, camera, UI and end of frame events. They run in the order registered in RegisterSystems wherever
+    // they conflict, at the same time elsewhere.
+    SystemScheduler::GetInstance().Run();
+#ifdef PARTICLES
+   
+#endif // PARTICLES
+}
+
+// Adds the frame's systems to the scheduler, with what each of them reads and writes.
+void Engine::RegisterSystems() {
+    SystemScheduler& scheduler = SystemScheduler::GetInstance();
+    scheduler.Clear();
+    using Resource = System::Resource;
+
+    // Expired timers run their actions, delayed despawns among them, once per fixed step of the frame
+    auto timers = std::make_unique<FunctionSystem>("Timer System", [this]() {
+        TimerService::GetInstance().Advance(currentNumberOfSteps);
+    });
+    timers->WritesEverything();
+    timers->RunsOnMainThread();
+    scheduler.Add(std::move(timers));
+
+    // Events for the start of the frame, e.g. winning, which changes scenes
+    auto frameStartEvents = std::make_unique<FunctionSystem>("Frame Start Events", []() {
+        EventBus::GetInstance().Dispatch(EventBus::Phase::FRAME_START);
+    });
+    frameStartEvents->WritesEverything();
+    frameStartEvents->RunsOnMainThread();
+    scheduler.Add(std::move(frameStartEvents));
+
+    // Pausing, cheats and scene changes can touch anything
+    auto gameFlow = std::make_unique<FunctionSystem>("Game Flow System", [this]() { UpdateGameFlow(); });
+    gameFlow->WritesEverything();
+    gameFlow->RunsOnMainThread();
+    scheduler.Add(std::move(gameFlow));
+
+    // Components run game code that reads input, spawns objects and plays sounds
+    auto gameObjects = std::make_unique<FunctionSystem>("Game Object Update System", []() {
+        GameObjectFactory::GetInstance().UpdateAllGameObjects();
+    });
+    gameObjects->WritesEverything();
+    gameObjects->RunsOnMainThread();
+    scheduler.Add(std::move(gameObjects));
+
+    // Deaths and other notifications from the components' updates
+    auto gameplayEvents = std::make_unique<FunctionSystem>("Gameplay Events", []() {
+        EventBus::GetInstance().Dispatch(EventBus::Phase::AFTER_GAME_OBJECTS);
+    });
+    gameplayEvents->WritesEverything();
+    gameplayEvents->RunsOnMainThread();
+    scheduler.Add(std::move(gameplayEvents));
+
+    // Waves are spawned at the fixed step they fall due in, before collision sees them
+    auto events = std::make_unique<FunctionSystem>("Event System", []() { EventSystem::GetInstance().Update(); });
+    events->Reads(Resource::GAME_STATE);
+    events->Writes(TypeOfComponent::TRANSFORM);
+    events->Writes(TypeOfComponent::AISTATE);
+    events->Writes(Resource::SCENE);
+    events->Writes(Resource::EVENTS);
+    events->RunsOnMainThread();
+    scheduler.Add(std::move(events));
+
+    // Hits spawn damage text and effects, which load their sprites and fonts, and damage
+    // plays sounds and raises death events
+    auto collision = std::make_unique<FunctionSystem>("Collision System", [this]() {
+        if (isInGameScene && !isPaused)
+            CollisionUpdate();
+    });
+    collision->Reads(Resource::GAME_STATE);
+    collision->Reads(TypeOfComponent::RECTCOLLIDER);
+    collision->Reads(TypeOfComponent::PLAYER);
+    collision->Writes(TypeOfComponent::TRANSFORM);
+    collision->Writes(TypeOfComponent::RIGIDBODY);
+    collision->Writes(TypeOfComponent::HEALTH);
+    collision->Writes(TypeOfComponent::AISTATE);
+    collision->Writes(TypeOfComponent::ANIMATOR);
+    collision->Writes(TypeOfComponent::FLOATUP);
+    collision->Writes(TypeOfComponent::TEXT);
+    collision->Writes(TypeOfComponent::PARTICLE);
+    collision->Writes(Resource::SCENE);
+    collision->Writes(Resource::AUDIO);
+    collision->Writes(Resource::EVENTS);
+    collision->RunsOnMainThread();
+    scheduler.Add(std::move(collision));
+
+    scheduler.Add(physicsSystem);
+
+    // Flushes the sound commands of this frame's game code. Touches nothing but the audio
+    // backend, so it runs on a worker alongside physics and the camera.
+    auto audio = std::make_unique<FunctionSystem>("Audio System", []() { AudioManager::GetInstance().Update(); });
+    audio->Writes(Resource::AUDIO);
+    scheduler.Add(std::move(audio));
+
+    // The player camera follows the cursor and the editor camera reads the keyboard
+    auto camera = std::make_unique<FunctionSystem>("Camera System", [this]() { UpdateCamera(); });
+    camera->Reads(Resource::SCENE);
+    camera->Reads(TypeOfComponent::TRANSFORM);
+    camera->Writes(Resource::CAMERA);
+    camera->RunsOnMainThread();
+    scheduler.Add(std::move(camera));
+
+    // UI will be updated regardless of pause state. Buttons change scenes and play sounds.
+    auto ui = std::make_unique<FunctionSystem>("UI Update System", []() { UpdateUI(); });
+    ui->WritesEverything();
+    ui->RunsOnMainThread();
+    scheduler.Add(std::move(ui));
+
+    // Events posted by systems on the workers, heard once they have all finished
+    auto endOfFrameEvents = std::make_unique<FunctionSystem>("End Of Frame Events", []() {
+        EventBus::GetInstance().Dispatch(EventBus::Phase::END_OF_FRAME);
+    });
+    endOfFrameEvents->WritesEverything();
+    endOfFrameEvents->RunsOnMainThread();
+    scheduler.Add(std::move(endOfFrameEvents));
+}
 
+// Shows the victory screen once every mission of the level is complete.
+void Engine::OnMissionsCompleted() {
+    // Posted by a game that has since been lost or left
+    if (!EventSystem::GetInstance().GetWinCondition()) {
+        return;
+    }
+    showCursor = true;
+    cameraManager.GetCurrentCamera()->SetCenter(Vector2(0.0f, 0.0f));
+    EventSystem::GetInstance().ShutDown();
+    LoadSceneFromLua("Assets/Lua/Scenes/VictoryScene.lua");
+}
 
+// Pauses and unpauses, checks for losing, and runs the editor's autosave and asset reloads.
+void Engine::UpdateGameFlow() {
     static std::unordered_map<GameObject*, Vector2> enemyStoredVelocities;
 
     if (isInGameScene && InputManager::IsKeyReleased(GLFW_KEY_ESCAPE))
@@ -3429,66 +3953,34 @@ void Engine::Update() {
         }
     }
 
-	if (EventSystem::GetInstance().GetWinCondition())
-	{
-        showCursor = true;
-		cameraManager.GetCurrentCamera()->SetCenter(Vector2(0.0f, 0.0f));
-		EventSystem::GetInstance().ShutDown();
-        LoadSceneFromLua("Assets/Lua/Scenes/VictoryScene.lua");
-	}
 #ifdef _IMGUI
-    
-#pragma region updateTextureluainRunTime
-
-    static std::vector<std::string> prevholder = Utilities::getAssetFiles("Assets/Textures/");
-    // Extract filepaths from directory
-    std::vector<std::string> holder = Utilities::getAssetFiles("Assets/Textures/");
-
-    if (holder.size() != previousFrameHolderSize) {
-		ImGuiConsole::Cout("CHANGE DETECTED!!!");
-        // Update asset changes if needed
-        Utilities::UpdateTextureAssetChanges(holder, prevholder, previousFrameHolderSize);
-
-        // Sync assets with Lua and load textures
-        Utilities::SyncTextureAssetsWithLua(holder);
-
-        // Update the state for the next frame
-        prevholder = holder;
-        previousFrameHolderSize = holder.size();
-
-    }
-#pragma endregion updateTextureluainRunTime
-
-
-
-#pragma region updateSoundluaInRunTime
-    static size_t previousSoundHolderSize = 0;
-    static std::vector<std::string> soundPrevholder = Utilities::getAssetFiles("Assets/sounds/");
-    // Extract filepaths from directory
-    std::vector<std::string> soundHolder = Utilities::getAssetFiles("Assets/sounds/");
-
-    if (soundHolder.size() != previousSoundHolderSize) {
-		ImGuiConsole::Cout("CHANGE DETECTED!!!");
-        // Update asset changes if needed
-        Utilities::UpdateSoundAssetChanges(soundHolder, soundPrevholder, previousSoundHolderSize);
-
-        // Sync assets with Lua and load textures
-        Utilities::SyncSoundAssetsWithLua(soundHolder);
-
-        // Update the state for the next frame
-        soundPrevholder = soundHolder;
-        previousSoundHolderSize = soundHolder.size();
 
+#pragma region autosave
+    // Only the edited scene is worth keeping, not the state of a running game
+    static double autosaveTimer = 0.0;
+    if (!isInGameScene) {
+        autosaveTimer += InputManager::GetDeltaTime();
+        if (autosaveTimer >= autosaveInterval) {
+            autosaveTimer = 0.0;
+            GameObjectFactory::GetInstance().SaveChangedGameObjects(autosaveFile);
+        }
     }
-
-#pragma endregion updateSoundluaInRunTime
+#pragma endregion autosave
+    
+#pragma region updateAssetsInRunTime
+    // Texture and sound changes arrive from the watcher registered in Init
+    AssetWatcher::GetInstance().Update(InputManager::GetDeltaTime());
+#pragma endregion updateAssetsInRunTime
 
 
 
 
 
 #endif // _IMGUI
+}
 
+// Moves the player camera, or the editor camera from the mouse and keyboard.
+void Engine::UpdateCamera() {
     // Get the GLFW window
     GLFWwindow* window = InputManager::ptrWindow;
     (void)window;
@@ -3496,37 +3988,7 @@ void Engine::Update() {
     // (Ridhwan: commented due to leveleditor camera enabling when game is paused or stopped)
     //cameraManager.HandleCameraToggleInput(window);
 
-
-#ifdef _LOGGING
-    std::unique_ptr<SystemLog> logMovement = std::make_unique<SystemLog>("Game Object Update System");
-#endif
-    // Player Movement
-    GameObjectFactory& factory = GameObjectFactory::GetInstance();
-    factory.UpdateAllGameObjects();
-
-#ifdef _LOGGING
-    logMovement.reset();
-    std::unique_ptr<SystemLog> logCollision = std::make_unique<SystemLog>("Collision System");
-#endif 
-
-    if (isInGameScene && !isPaused)
-        CollisionUpdate();
-
-#ifdef _LOGGING
-    logCollision.reset();
-    std::unique_ptr<SystemLog> logPhysics = std::make_unique<SystemLog>("Physics System");
-#endif
-       physicsSystem.Update();
-
-#ifdef _LOGGING
-    logPhysics.reset();
-#endif
-    //playerRigidBody->SetVelocity(velocity);
-    //playerRigidBody->Update();// called in physics system
-
-
 #ifdef _LOGGING
-    std::unique_ptr<SystemLog> logCamera = std::make_unique<SystemLog>("Camera System");
     //float zoomSpeed = 1.0f * static_cast<float>(InputManager::deltaTime);
     //float rotateSpeed = 50.0f * static_cast<float>(InputManager::deltaTime);
     float zoomSpeed = 1.0f * static_cast<float>(fixedDT * currentNumberOfSteps);
@@ -3602,14 +4064,6 @@ void Engine::Update() {
         cameraManager.GetEditorCamera().UpdateViewMatrix(static_cast<float>(fixedDT * currentNumberOfSteps));
     }
 #endif // _IMGUI
-#ifdef _LOGGING
-    logCamera.reset();
-#endif
-	// UI will be updated regardless of puase state
-    UpdateUI();
-#ifdef PARTICLES
-   
-#endif // PARTICLES
 }
 
 // Draws the current scene.
@@ -3673,6 +4127,7 @@ void Engine::Draw() {
     EngineImGuiWindows::GizmoConfigurationsWindow();
     EngineImGuiWindows::FPSWindow();
     EngineImGuiWindows::SystemProcessTimeWindow();
+    EngineImGuiWindows::FrameTimelineWindow();
     EngineImGuiWindows::FilesWindow();
     EngineImGuiWindows::ConsoleWindow();
 	EngineImGuiWindows::EventWindow();
@@ -3710,7 +4165,7 @@ void Engine::Draw() {
 void Engine::SaveStateToLua()
 {
 	GameObjectFactory& factory = GameObjectFactory::GetInstance();
-    factory.SerializeAllGameObjects(stateFile);
+    factory.SaveChangedGameObjects(stateFile);
 }
 
 
@@ -3816,6 +4271,8 @@ void Engine::LoadSceneFromLua(const std::string path) {
         AudioManager::GetInstance().PlayAudio(16);
     }
     currentScene = path;
+    bool loadedCooked = false;
+    bool loadedPreloaded = false;
 
 
     try {
@@ -3823,7 +4280,29 @@ void Engine::LoadSceneFromLua(const std::string path) {
 
         // Clear existing game objects
         factory.Clear();
+        sceneSnapshot.Clear();
+        AssetManager::GetInstance().BeginSceneResidency(path);
+
+        // Parse the scene once; every LuaManager opened on it below shares this state
+        // A scene prepared in the background only needs its objects created here
+        LuaBytecodeCache::ClearLastLoadStats();
+        ScenePreloader::PreparedScene preloadedScene = ScenePreloader::GetInstance().Take(path);
+        loadedPreloaded = preloadedScene.image != nullptr;
+
+        // Textures the preload decoded only need uploading before the sprites ask for them
+        size_t adoptedTextures = 0;
+        for (const auto& [textureName, decoded] : preloadedScene.textures) {
+            adoptedTextures += AssetManager::GetInstance().AdoptDecodedTexture(textureName, decoded) ? 1 : 0;
+        }
+        preloadedScene.textures.clear();
+        if (adoptedTextures > 0) {
+            ImGuiConsole::Cout("Uploaded %zu textures decoded by the preload", adoptedTextures);
+        }
 
+        std::unique_ptr<LuaSceneContext> sceneContext = loadedPreloaded
+            ? std::make_unique<LuaSceneContext>(path, std::move(preloadedScene.image))
+            : std::make_unique<LuaSceneContext>(path);
+        loadedCooked = sceneContext->GetCookedScene() != nullptr;
         LuaManager luaManager(path);
         // Extract id-name map along with parent IDs
         std::unordered_map<int, std::pair<std::string, int>> objectData = luaManager.extractNamesWithParentIDs();
@@ -3865,9 +4344,21 @@ void Engine::LoadSceneFromLua(const std::string path) {
             }
         }
 
+        // Keep the freshly loaded state so RestartScene can skip the file and Lua entirely
+        auto snapshotStart = std::chrono::high_resolution_clock::now();
+        if (sceneSnapshot.Capture(path)) {
+            std::chrono::duration<double> snapshotElapsed = std::chrono::high_resolution_clock::now() - snapshotStart;
+            ImGuiConsole::Cout("Captured scene snapshot (%zu bytes) in %f seconds", sceneSnapshot.GetSizeBytes(), snapshotElapsed.count());
+        }
+
         // Update all game objects
         factory.UpdateAllGameObjects();
 
+        // The previous scene's objects are gone, so textures and audio only it used can be unloaded now
+        int texturesUnloaded = AssetManager::GetInstance().TrimTexturesToBudget();
+        ImGuiConsole::Cout("Textures resident: %.1f MB, %d unloaded", AssetManager::GetInstance().GetResidentTextureBytes() / (1024.0 * 1024.0), texturesUnloaded);
+        int soundsUnloaded = AssetManager::GetInstance().TrimAudioToBudget();
+        ImGuiConsole::Cout("Audio resident: %.1f MB, %d unloaded", AssetManager::GetInstance().GetResidentAudioBytes() / (1024.0 * 1024.0), soundsUnloaded);
 
         // Check for PlayerControllerComponent and set camera mode
         bool playerFound = false;
@@ -3894,7 +4385,16 @@ void Engine::LoadSceneFromLua(const std::string path) {
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end - start;
-    ImGuiConsole::Cout("Elapsed time: %f seconds\n", elapsed.count());
+    ImGuiConsole::Cout("Loaded %s (%zu objects, %s) in %f seconds\n", path.c_str(), GameObjectFactory::GetInstance().GetNumObjects(), loadedPreloaded ? "preloaded" : (loadedCooked ? "cooked" : "lua"), elapsed.count());
+    const LuaBytecodeCache::LoadStats& chunkStats = LuaBytecodeCache::GetLastLoadStats();
+    if (chunkStats.filePath == path) {
+        if (chunkStats.fromBytecode) {
+            ImGuiConsole::Cout("Lua chunk loaded from bytecode in %.3f ms, %.3f ms of parse and compile saved", chunkStats.loadSeconds * 1000.0, (chunkStats.compileSeconds - chunkStats.loadSeconds) * 1000.0);
+        }
+        else {
+            ImGuiConsole::Cout("Lua chunk compiled from source in %.3f ms", chunkStats.loadSeconds * 1000.0);
+        }
+    }
     time = maxTime;
     // Hardcoded event loading for GameScene
     if (path == "Assets/Lua/Scenes/GameScene.lua")
@@ -3902,6 +4402,27 @@ void Engine::LoadSceneFromLua(const std::string path) {
         EventSystem::GetInstance().LoadEvents("Assets/Lua/events.dat");
     }
 
+    // Prepare the scenes this one can switch to while it is being played
+    std::unordered_set<std::string> nextScenes;
+    for (const auto& [id, obj] : GameObjectFactory::GetInstance().GetAllGameObjects()) {
+        ButtonComponent* button = obj->GetComponent<ButtonComponent>(TypeOfComponent::BUTTON);
+        if (button && !button->pathNextScene.empty() && button->pathNextScene != path) {
+            nextScenes.insert(button->pathNextScene);
+        }
+    }
+    // The cutscene switches to the game scene when the video finishes, not through a button
+    if (path == "Assets/Lua/Scenes/CutScene.lua")
+    {
+        nextScenes.insert("Assets/Lua/Scenes/GameScene.lua");
+    }
+
+    // Preloads for the buttons of the previous scene that were never pressed are dropped
+    ScenePreloader& preloader = ScenePreloader::GetInstance();
+    preloader.Retain(nextScenes);
+    for (const std::string& nextScene : nextScenes) {
+        preloader.Preload(nextScene);
+    }
+
 }
 
 
@@ -3913,7 +4434,15 @@ void Engine::LoadSceneFromLua(const std::string path) {
 * \brief Restart the current scene
 *******************************************************************/
 void Engine::RestartScene() {
-    LuaManager luaManager(currentScene);
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Restore from the snapshot taken when the scene loaded, unless the scene was saved since
+    const bool fromSnapshot = sceneSnapshot.IsValidFor(currentScene);
+    const std::string scenePath = fromSnapshot ? sceneSnapshot.GetSnapshotPath() : currentScene;
+    std::unique_ptr<LuaSceneContext> sceneContext = fromSnapshot
+        ? std::make_unique<LuaSceneContext>(scenePath, sceneSnapshot.GetImage())
+        : std::make_unique<LuaSceneContext>(currentScene);
+    LuaManager luaManager(scenePath);
     GameObjectFactory& factory = GameObjectFactory::GetInstance();
 
     // Extract id-name map along with parent IDs
@@ -3934,11 +4463,11 @@ void Engine::RestartScene() {
         const std::string objectName = luaManager.LuaReadFromName<std::string>(tableName, "name");
 
         if (existingObject && existingObject->GetName() == objectName) {
-            factory.ResetObjectFromLua(currentScene, tableName, existingObject);
+            factory.ResetObjectFromLua(scenePath, tableName, existingObject);
             createdObjects[objectId] = existingObject;
         }
         else {
-            GameObject* newObject = factory.CreateFromLua(currentScene, tableName);
+            GameObject* newObject = factory.CreateFromLua(scenePath, tableName);
             createdObjects[objectId] = newObject;
         }
     }
@@ -3988,6 +4517,9 @@ void Engine::RestartScene() {
         }
 #endif // !_IMGUI
     }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    ImGuiConsole::Cout("Restarted %s (%s) in %f seconds", currentScene.c_str(), fromSnapshot ? "snapshot" : "lua", elapsed.count());
 }
 
 
@@ -3997,6 +4529,10 @@ void Engine::RestartScene() {
 *******************************************************************/
 void Engine::Exit() {
     EventSystem::GetInstance().ShutDown();
+    SystemScheduler::GetInstance().Clear();
+    EventBus::GetInstance().Unsubscribe(missionsCompletedSubscription);
+    JobSystem::GetInstance().Shutdown();
+    ScenePreloader::GetInstance().Clear();
 	glfwSetWindowShouldClose(InputManager::ptrWindow, GLFW_TRUE);
 }
 
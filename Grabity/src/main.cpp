@@ -1,6 +1,7 @@
 /*!****************************************************************
 \file:      main.cpp
 \author:    Ridhwan Mohamed Afandi, mohamedridhwan.b, 2301367
+\co-author: Goh Jun Jie, g.junjie, 2301293
 \brief:     Entry point for the application. Initializes the
             OpenGL context, engine, and handles the game loop.
 \details:   This file sets up the application by reading
@@ -27,6 +28,8 @@ Technology is prohibited.
 #include <engine.h>
 #include <LuaConfig.h>
 #include <InterruptionHandler.h>  // Include the header for InterruptionHandler
+#include <VirtualFileSystem.h>
+#include <FramePacer.h>
 #ifdef _IMGUI
 #include <imguimanager.h>
 #endif // _IMGUI
@@ -42,35 +45,55 @@ int main() {
     _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF); //Memory Leak
 
 
+#ifndef _IMGUI
+    // Shipping builds read assets from the pack when it is present, the editor always uses loose files
+    VirtualFileSystem::GetInstance().Mount("Assets.pak");
+#endif // _IMGUI
+
     auto initStart = std::chrono::high_resolution_clock::now();
     LuaManager luaManager("Assets/Lua/config.lua");
     Init(   luaManager.LuaReadFromWindow<int>("Width"),
             luaManager.LuaReadFromWindow<int>("Height"),
             luaManager.LuaReadFromWindow<std::string>("Name"));
 
-    int targetFPS = luaManager.LuaReadFromWindow<int>("TargetFramerate");
-    const double frameDuration = 1000.0 / targetFPS;
-    
+#ifdef _LOGGING
+    // Cold start I/O, compare a run with Assets.pak against one with loose files
+    VirtualFileSystem::Stats startupIO = VirtualFileSystem::GetInstance().GetStats();
+    ImGuiConsole::Cout("Startup file I/O: %llu files (%llu packed), %.2f MB in %.2f ms",
+        static_cast<unsigned long long>(startupIO.files), static_cast<unsigned long long>(startupIO.packedFiles),
+        static_cast<double>(startupIO.bytes) / (1024.0 * 1024.0), static_cast<double>(startupIO.microseconds) / 1000.0);
+#endif // _LOGGING
+
+    // Sleeps out the rest of each frame instead of spinning through it
+    FramePacer::GetInstance().SetTargetFrameRate(luaManager.LuaReadFromWindow<int>("TargetFramerate"));
 
     // Initialize the interruption handler with the GLFW window
     InterruptionHandler::Init(InputManager::ptrWindow);  // Pass the GLFW window to the handler
 
+#ifdef _LOGGING
+    bool firstFrame = true;
+#endif // _LOGGING
     while (!glfwWindowShouldClose(InputManager::ptrWindow)) {
-        auto frameStart = std::chrono::high_resolution_clock::now();
         InputManager::Update();
 
         Update();
 
-        Draw();
-
-        auto frameEnd = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> elapsed = frameEnd - frameStart;
+        // Nothing to see while minimised
+        if (InterruptionHandler::ShouldRender()) {
+            Draw();
+        }
 
-		// sleep if the frame was rendered too quickly
-        while (elapsed.count() < frameDuration) {
-            frameEnd = std::chrono::high_resolution_clock::now();
-            elapsed = frameEnd - frameStart;
+#ifdef _LOGGING
+        // Tracked alongside the startup timeline Engine::Init prints
+        if (firstFrame) {
+            std::chrono::duration<double, std::milli> firstFrameElapsed = std::chrono::high_resolution_clock::now() - initStart;
+            ImGuiConsole::Cout("Time to first frame: %.1f ms", firstFrameElapsed.count());
+            firstFrame = false;
         }
+#endif // _LOGGING
+
+        // wait if the frame was rendered too quickly
+        FramePacer::GetInstance().WaitForNextFrame();
 
         auto initEnd = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> initElapsed = initEnd - initStart;
@@ -1,3 +1,4 @@
+#ifndef _NO_FMOD
 #include <soundmanager.h>
 
 // SoundManager Implementation
@@ -80,3 +81,4 @@ void Sound::stop() {
         channel->stop();
     }
 }
+#endif // !_NO_FMOD
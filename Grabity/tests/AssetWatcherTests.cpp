@@ -0,0 +1,110 @@
+/*!****************************************************************
+\file: AssetWatcherTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for AssetWatcher on a temporary directory, with native
+        file events and with the polling fallback: added, modified and
+        removed files are reported once the directory settles, and
+        files that come and go in between are not reported.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "AssetWatcher.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+    struct WatchedTemp {
+        std::string directory;
+        AssetWatcher watcher;
+        std::vector<std::vector<AssetWatcher::FileChange>> batches;
+
+        WatchedTemp(const std::string& name, bool native) {
+            directory = (std::filesystem::temp_directory_path() / "GrabityTests" / name).string() + "/";
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+            WriteFile("Player.png", "first");
+            WriteFile("README", "no extension");
+
+            watcher.SetNativeWatches(native);
+            watcher.SetPollInterval(0.1);
+            watcher.SetDebounce(0.25);
+            watcher.Watch(directory, [this](const std::vector<AssetWatcher::FileChange>& changes) { batches.push_back(changes); });
+        }
+
+        void WriteFile(const std::string& file, const std::string& contents) {
+            std::ofstream out(directory + file, std::ios::binary | std::ios::trunc);
+            out << contents;
+        }
+
+        // Runs the watcher for a second of 0.1 s frames, long enough for either backend to settle
+        void Settle() {
+            for (int frame = 0; frame < 10; ++frame) {
+                watcher.Update(0.1);
+            }
+        }
+
+        bool Reported(const std::vector<AssetWatcher::FileChange>& expected) const {
+            if (batches.size() != 1 || batches.front().size() != expected.size()) {
+                return false;
+            }
+            for (size_t index = 0; index < expected.size(); ++index) {
+                if (batches.front()[index].path != directory + expected[index].path || batches.front()[index].type != expected[index].type) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /**
+     * \brief Adds, modifies, removes and briefly creates files and checks what is reported.
+     * \param name Names the temporary directory.
+     * \param native Whether to watch with native events.
+     */
+    void CheckWatcher(const std::string& name, bool native) {
+        WatchedTemp temp(name, native);
+#ifdef __linux__
+        CHECK_EQ(temp.watcher.IsNative(temp.directory), native);
+#endif
+
+        // Nothing is reported while the directory has not been quiet long enough
+        temp.WriteFile("Enemy.png", "added");
+        temp.WriteFile("Player.png", "modified, longer");
+        temp.WriteFile("NOTES", "ignored");
+        temp.watcher.Update(0.1);
+        temp.watcher.Update(0.1);
+        CHECK(temp.batches.empty());
+        temp.Settle();
+        CHECK(temp.Reported({ { "Enemy.png", AssetWatcher::ChangeType::ADDED }, { "Player.png", AssetWatcher::ChangeType::MODIFIED } }));
+
+        temp.batches.clear();
+        std::filesystem::remove(temp.directory + "Enemy.png");
+        temp.Settle();
+        CHECK(temp.Reported({ { "Enemy.png", AssetWatcher::ChangeType::REMOVED } }));
+
+        // A file created and deleted before the directory settles is never seen by the callback
+        temp.batches.clear();
+        temp.WriteFile("Temp.png", "short lived");
+        temp.watcher.Update(0.1);
+        std::filesystem::remove(temp.directory + "Temp.png");
+        temp.Settle();
+        CHECK(temp.batches.empty());
+
+        // Quiet directories report nothing
+        temp.Settle();
+        CHECK(temp.batches.empty());
+    }
+}
+
+TEST_CASE(AssetWatcher_NativeEventsReportSettledChanges) {
+    CheckWatcher("WatcherNative", true);
+}
+
+TEST_CASE(AssetWatcher_PollingReportsSettledChanges) {
+    CheckWatcher("WatcherPolled", false);
+}
@@ -0,0 +1,142 @@
+/*!****************************************************************
+\file: AudioFadeTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Fades on the software mixer, driven in game frames of 30, 60
+        and 240 FPS the way AudioManager::Update drives the backend.
+        A fade is counted in output samples, so it has to start, pass
+        its midpoint and end on the same sample at every frame rate,
+        including when it ends in the middle of a frame.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "AudioFixtures.h"
+#include "SoftwareAudioBackend.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    constexpr int frameRates[] = { 30, 60, 240 };
+    constexpr size_t fadeStart = AudioFixtures::SampleRate / 10;   // A whole number of game frames at every rate
+
+    struct FadeRun {
+        std::vector<float> left;    // Left channel of every mixed sample
+        int channelsPlaying = 0;    // After the last frame
+    };
+
+    /**
+     * \brief Plays a constant sound for a second of game frames and starts a fade on the
+     *        first frame at or after a sample, as AudioManager does when it posts one.
+     * \param frameRate The game frames per second; each frame mixes 1/frameRate seconds.
+     * \param startSample The sample the fade starts on.
+     * \param target The fade gain to reach.
+     * \param seconds The fade duration.
+     * \param stopAtEnd Whether the channel stops when the fade ends.
+     * \param fadeIn Whether to start from silence, as AudioManager::FadeInAudio does.
+     * \return The mixed samples.
+     */
+    FadeRun RenderFade(int frameRate, size_t startSample, float target, float seconds, bool stopAtEnd, bool fadeIn) {
+        SoftwareAudioBackend mixer;
+        mixer.Init(8);
+        const std::vector<unsigned char> wav = AudioFixtures::MakeConstantWav(AudioFixtures::SampleRate, 16384);
+        const AudioBackend::SoundID sound = mixer.CreateSound(wav.data(), wav.size(), true, AudioBackend::LoadMode::DECOMPRESSED);
+        const AudioBackend::ChannelID channel = mixer.Play(sound, false);
+
+        FadeRun run;
+        const size_t frameSamples = static_cast<size_t>(AudioFixtures::SampleRate / frameRate);
+        bool started = false;
+        while (run.left.size() < static_cast<size_t>(AudioFixtures::SampleRate)) {
+            if (!started && run.left.size() >= startSample) {
+                if (fadeIn) {
+                    mixer.FadeTo(channel, 0.0f, 0.0f, false);
+                }
+                mixer.FadeTo(channel, target, seconds, stopAtEnd);
+                started = true;
+            }
+            const std::vector<float>& mix = mixer.Render(frameSamples);
+            for (size_t frame = 0; frame < frameSamples; ++frame) {
+                run.left.push_back(mix[frame * 2]);
+            }
+        }
+        run.channelsPlaying = mixer.GetChannelsPlaying();
+        mixer.Release();
+        return run;
+    }
+
+    bool IsNear(float value, float expected, float tolerance) {
+        return std::fabs(value - expected) <= tolerance;
+    }
+}
+
+TEST_CASE(AudioFade_FadeOutEndsOnTheSameSampleAtEveryFrameRate) {
+    // 0.51 s does not end on a frame boundary at any of the rates
+    const size_t fadeSamples = 24480;
+    const FadeRun reference = RenderFade(60, fadeStart, 0.0f, 0.51f, true, false);
+    const float full = reference.left[0];
+    CHECK(full > 0.0f);
+
+    for (int frameRate : frameRates) {
+        const FadeRun run = RenderFade(frameRate, fadeStart, 0.0f, 0.51f, true, false);
+        CHECK_EQ(run.left[fadeStart - 1], full);
+        CHECK_EQ(run.left[fadeStart], full);
+        CHECK(IsNear(run.left[fadeStart + fadeSamples / 2], full * 0.5f, full * 1e-3f));
+        CHECK(run.left[fadeStart + fadeSamples - 10] > 0.0f);
+
+        // The channel stops on the fade's last sample, not at the end of the frame
+        size_t firstSilent = run.left.size();
+        for (size_t sample = fadeStart; sample < run.left.size(); ++sample) {
+            if (run.left[sample] <= 0.0f) {
+                firstSilent = sample;
+                break;
+            }
+        }
+        CHECK_EQ(firstSilent, fadeStart + fadeSamples);
+        bool silentAfter = true;
+        for (size_t sample = firstSilent; sample < run.left.size(); ++sample) {
+            silentAfter = silentAfter && run.left[sample] == 0.0f;
+        }
+        CHECK(silentAfter);
+        CHECK_EQ(run.channelsPlaying, 0);
+
+        // Frame size only changes where the ramp is restarted, not its shape
+        float largestDifference = 0.0f;
+        for (size_t sample = 0; sample < run.left.size(); ++sample) {
+            largestDifference = std::max(largestDifference, std::fabs(run.left[sample] - reference.left[sample]));
+        }
+        CHECK(largestDifference <= full * 1e-5f);
+    }
+}
+
+TEST_CASE(AudioFade_FadeInReachesFullVolumeOnTheSameSampleAtEveryFrameRate) {
+    const size_t fadeSamples = 12000;
+    for (int frameRate : frameRates) {
+        const FadeRun unfaded = RenderFade(frameRate, AudioFixtures::SampleRate, 1.0f, 0.0f, false, false);
+        const float full = unfaded.left[0];
+        const FadeRun run = RenderFade(frameRate, 0, 1.0f, 0.25f, false, true);
+
+        // Starts from a silent sample, so there is no click
+        CHECK_EQ(run.left[0], 0.0f);
+        CHECK(run.left[1] > 0.0f);
+        CHECK(IsNear(run.left[fadeSamples / 2], full * 0.5f, full * 1e-3f));
+        CHECK(run.left[fadeSamples - 1] < full);
+        CHECK_EQ(run.left[fadeSamples], full);
+        CHECK_EQ(run.left.back(), full);
+        CHECK_EQ(run.channelsPlaying, 1);
+    }
+}
+
+TEST_CASE(AudioFade_PartialFadeHoldsItsTarget) {
+    const size_t fadeSamples = 9600;
+    for (int frameRate : frameRates) {
+        const FadeRun run = RenderFade(frameRate, fadeStart, 0.25f, 0.2f, false, false);
+        const float full = run.left[0];
+        CHECK(IsNear(run.left[fadeStart + fadeSamples / 2], full * 0.625f, full * 1e-3f));
+        CHECK_EQ(run.left[fadeStart + fadeSamples], full * 0.25f);
+        CHECK_EQ(run.left.back(), full * 0.25f);
+        CHECK_EQ(run.channelsPlaying, 1);
+    }
+}
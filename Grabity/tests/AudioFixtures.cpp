@@ -0,0 +1,76 @@
+/*!****************************************************************
+\file: AudioFixtures.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Sounds shared by the audio tests.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "AudioFixtures.h"
+#include <cmath>
+
+namespace AudioFixtures {
+
+    namespace {
+        void Put16(std::vector<unsigned char>& out, uint16_t value) {
+            out.push_back(static_cast<unsigned char>(value));
+            out.push_back(static_cast<unsigned char>(value >> 8));
+        }
+
+        void Put32(std::vector<unsigned char>& out, uint32_t value) {
+            Put16(out, static_cast<uint16_t>(value));
+            Put16(out, static_cast<uint16_t>(value >> 16));
+        }
+    }
+
+    /**
+     * \brief Builds a mono 16-bit WAV file.
+     * \param samples The samples.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeWav(const std::vector<int16_t>& samples) {
+        std::vector<unsigned char> wav;
+        const uint32_t dataBytes = static_cast<uint32_t>(samples.size() * 2);
+        wav.insert(wav.end(), { 'R', 'I', 'F', 'F' });
+        Put32(wav, 36 + dataBytes);
+        wav.insert(wav.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+        Put32(wav, 16);
+        Put16(wav, 1);              // PCM
+        Put16(wav, 1);              // Mono
+        Put32(wav, SampleRate);
+        Put32(wav, SampleRate * 2);
+        Put16(wav, 2);
+        Put16(wav, 16);
+        wav.insert(wav.end(), { 'd', 'a', 't', 'a' });
+        Put32(wav, dataBytes);
+        for (int16_t sample : samples) {
+            Put16(wav, static_cast<uint16_t>(sample));
+        }
+        return wav;
+    }
+
+    /**
+     * \brief Builds a mono 16-bit WAV file of a sine tone.
+     * \param frames The length in frames.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeToneWav(uint32_t frames) {
+        std::vector<int16_t> samples(frames);
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            samples[frame] = static_cast<int16_t>(8000.0 * std::sin(frame * 0.05));
+        }
+        return MakeWav(samples);
+    }
+
+    /**
+     * \brief Builds a mono 16-bit WAV file holding one value.
+     * \param frames The length in frames.
+     * \param value The sample value.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeConstantWav(uint32_t frames, int16_t value) {
+        return MakeWav(std::vector<int16_t>(frames, value));
+    }
+}
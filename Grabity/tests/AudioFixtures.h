@@ -0,0 +1,42 @@
+/*!****************************************************************
+\file: AudioFixtures.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Sounds shared by the audio tests. They are built in memory
+        as WAV files, so the tests need no audio assets and run on
+        the software mixer's null sink.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace AudioFixtures {
+
+    constexpr int SampleRate = 48000;   // Of the sounds and of the mixer, so no resampling
+
+    /**
+     * \brief Builds a mono 16-bit WAV file.
+     * \param samples The samples.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeWav(const std::vector<int16_t>& samples);
+
+    /**
+     * \brief Builds a mono 16-bit WAV file of a sine tone.
+     * \param frames The length in frames.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeToneWav(uint32_t frames);
+
+    /**
+     * \brief Builds a mono 16-bit WAV file holding one value, which makes the gain of every mixed frame readable.
+     * \param frames The length in frames.
+     * \param value The sample value.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeConstantWav(uint32_t frames, int16_t value);
+}
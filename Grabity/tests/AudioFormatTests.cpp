@@ -0,0 +1,65 @@
+/*!****************************************************************
+\file: AudioFormatTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Sound files the software mixer has no decoder for. Their
+        format is named from the first bytes, and creating a sound
+        from one fails instead of giving a silent sound, so the
+        engine can list them at startup.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "AudioFixtures.h"
+#include "SoftwareAudioBackend.h"
+#include <string>
+
+namespace {
+
+    /**
+     * \brief Builds the start of a file: a signature followed by zeros.
+     * \param signature The first bytes.
+     * \return The file contents.
+     */
+    std::vector<unsigned char> MakeFile(std::initializer_list<unsigned char> signature) {
+        std::vector<unsigned char> file(signature);
+        file.resize(256, 0);
+        return file;
+    }
+}
+
+TEST_CASE(AudioFormat_NamesTheFormatFromTheFirstBytes) {
+    const std::vector<unsigned char> wav = AudioFixtures::MakeToneWav(64);
+    const std::vector<unsigned char> ogg = MakeFile({ 'O', 'g', 'g', 'S' });
+    const std::vector<unsigned char> taggedMp3 = MakeFile({ 'I', 'D', '3', 4 });
+    const std::vector<unsigned char> mp3 = MakeFile({ 0xFF, 0xFB, 0x90, 0x64 });
+    const std::vector<unsigned char> flac = MakeFile({ 'f', 'L', 'a', 'C' });
+    const std::vector<unsigned char> text = MakeFile({ 'n', 'o', 'p', 'e' });
+
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(wav.data(), wav.size())), std::string("WAV"));
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(ogg.data(), ogg.size())), std::string("OGG"));
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(taggedMp3.data(), taggedMp3.size())), std::string("MP3"));
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(mp3.data(), mp3.size())), std::string("MP3"));
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(flac.data(), flac.size())), std::string("FLAC"));
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(text.data(), text.size())), std::string("unknown"));
+    CHECK_EQ(std::string(AudioBackend::GetFileFormatName(ogg.data(), 2)), std::string("unknown"));
+}
+
+TEST_CASE(AudioFormat_UndecodableFilesFailToLoad) {
+    SoftwareAudioBackend mixer;
+    mixer.Init(8);
+    const std::vector<unsigned char> ogg = MakeFile({ 'O', 'g', 'g', 'S' });
+    const std::vector<unsigned char> mp3 = MakeFile({ 'I', 'D', '3', 4 });
+    const AudioBackend::LoadMode modes[] = { AudioBackend::LoadMode::DECOMPRESSED, AudioBackend::LoadMode::COMPRESSED };
+    for (AudioBackend::LoadMode mode : modes) {
+        CHECK_EQ(mixer.CreateSound(ogg.data(), ogg.size(), false, mode), AudioBackend::InvalidID);
+        CHECK_EQ(mixer.CreateSound(mp3.data(), mp3.size(), false, mode), AudioBackend::InvalidID);
+    }
+
+    // WAV still loads alongside them
+    const std::vector<unsigned char> wav = AudioFixtures::MakeToneWav(AudioFixtures::SampleRate / 10);
+    CHECK(mixer.CreateSound(wav.data(), wav.size(), false, AudioBackend::LoadMode::DECOMPRESSED) != AudioBackend::InvalidID);
+    mixer.Release();
+}
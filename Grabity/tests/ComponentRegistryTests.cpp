@@ -0,0 +1,80 @@
+/*!****************************************************************
+\file: ComponentRegistryTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for ComponentRegistry: every component type that is
+        saved to Lua maps to a sub-table and back, objects load their
+        components in registration order, and restarts only call the
+        components that register a reset.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "TestComponents.h"
+#include "SceneFixtures.h"
+#include "ComponentRegistry.h"
+#include "LuaConfig.h"
+#include <set>
+
+TEST_CASE(ComponentRegistry_EveryTypeRoundTrips) {
+    const ComponentRegistry& registry = ComponentRegistry::GetInstance();
+    std::set<std::string> tableNames;
+    size_t savedTypes = 0;
+    for (int index = 0; index < TypeOfComponent::COMPONENT_COUNT; ++index) {
+        const TypeOfComponent type = static_cast<TypeOfComponent>(index);
+        const ComponentRegistry::Entry* entry = registry.Find(type);
+        if (!ComponentRegistry::IsSavedToLua(type)) {
+            CHECK(entry == nullptr);
+            continue;
+        }
+        ++savedTypes;
+        CHECK(entry != nullptr);
+        if (entry) {
+            CHECK_EQ(static_cast<int>(entry->type), index);
+            CHECK(registry.Find(entry->tableName) == entry);
+            tableNames.insert(entry->tableName);
+        }
+    }
+    CHECK_EQ(tableNames.size(), savedTypes);
+    CHECK_EQ(registry.GetEntries().size(), savedTypes);
+    CHECK(registry.GetUnregisteredTypes().empty());
+}
+
+TEST_CASE(ComponentRegistry_ReportsATypeThatCannotLoad) {
+    ComponentRegistry& registry = ComponentRegistry::GetInstance();
+    const ComponentRegistry::Entry original = *registry.Find(TypeOfComponent::HEALTH);
+
+    registry.Register("Health", TypeOfComponent::HEALTH, nullptr);
+    CHECK(registry.GetUnregisteredTypes() == std::vector<TypeOfComponent>{ TypeOfComponent::HEALTH });
+
+    // Re-registering keeps the creation order
+    registry.Register(original.tableName, original.type, original.create, original.reset);
+    CHECK(registry.GetUnregisteredTypes().empty());
+    CHECK(&registry.GetEntries()[14] == registry.Find(TypeOfComponent::HEALTH));
+}
+
+TEST_CASE(ComponentRegistry_LoadsSavedTablesInRegistrationOrder) {
+    const std::string path = SceneFixtures::MakeTempDirectory("RegistryLoad") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 4);
+    LuaSceneContext context(path);
+
+    // Object 1 has every table the fixtures write: Name, Transform, Sprite, RigidBody, Collider, Health, Audio
+    TestComponents::GetCreatedTables().clear();
+    for (const ComponentRegistry::Entry* entry : ComponentRegistry::GetInstance().GetEntriesFor(context.GetTableNames(SceneFixtures::GetObjectTableName(1)))) {
+        entry->create(nullptr, path, SceneFixtures::GetObjectTableName(1));
+    }
+    CHECK(TestComponents::GetCreatedTables() == (std::vector<std::string>{ "Transform", "Sprite", "RigidBody", "Collider", "Audio", "Health" }));
+}
+
+TEST_CASE(ComponentRegistry_RestartOnlyResetsRegisteredComponents) {
+    TestComponents::GetResetTables().clear();
+    const std::vector<std::string> tableNames = { "Name", "Health", "Sprite", "Transform", "RigidBody", "Audio", "Spawner" };
+    for (const ComponentRegistry::Entry* entry : ComponentRegistry::GetInstance().GetEntriesFor(tableNames)) {
+        if (entry->reset) {
+            entry->reset(nullptr, "", "");
+        }
+    }
+    CHECK(TestComponents::GetResetTables() == (std::vector<std::string>{ "Transform", "RigidBody", "Spawner", "Health" }));
+}
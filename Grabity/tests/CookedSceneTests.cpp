@@ -0,0 +1,240 @@
+/*!****************************************************************
+\file: CookedSceneTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for CookedScene: a baked scene reads back the values
+        of its Lua source, and damaged, truncated or foreign images
+        are rejected when they are loaded instead of being read out
+        of bounds later.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "CookedScene.h"
+#include "LuaConfig.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+    // Layout written by CookedScene::Builder::Finish
+    constexpr size_t headerSize = 32;
+    constexpr size_t stringRecordSize = 8;
+    constexpr size_t objectRecordSize = 24;
+    constexpr size_t tableRecordSize = 16;
+    constexpr size_t fieldRecordSize = 16;
+
+    struct ImageLayout {
+        uint32_t stringCount, objectCount, tableCount, fieldCount, stringBytes;
+        size_t strings, objects, tables, fields, bytes;
+    };
+
+    uint32_t ReadWord(const std::vector<unsigned char>& image, size_t offset) {
+        uint32_t value = 0;
+        std::memcpy(&value, image.data() + offset, sizeof(value));
+        return value;
+    }
+
+    void WriteWord(std::vector<unsigned char>& image, size_t offset, uint32_t value) {
+        std::memcpy(image.data() + offset, &value, sizeof(value));
+    }
+
+    ImageLayout GetLayout(const std::vector<unsigned char>& image) {
+        ImageLayout layout{};
+        layout.stringCount = ReadWord(image, 8);
+        layout.objectCount = ReadWord(image, 12);
+        layout.tableCount = ReadWord(image, 16);
+        layout.fieldCount = ReadWord(image, 20);
+        layout.stringBytes = ReadWord(image, 24);
+        layout.strings = headerSize;
+        layout.objects = layout.strings + (layout.stringCount + layout.stringCount % 2) * stringRecordSize;
+        layout.tables = layout.objects + layout.objectCount * objectRecordSize + (layout.objectCount % 2) * 8;
+        layout.fields = layout.tables + layout.tableCount * tableRecordSize;
+        layout.bytes = layout.fields + layout.fieldCount * fieldRecordSize;
+        return layout;
+    }
+
+    std::vector<unsigned char> BuildSmallImage() {
+        CookedScene::Builder builder;
+        builder.BeginObject("Player_0", -1);
+        builder.BeginTable("Name");
+        builder.AddString("name", "Player");
+        builder.BeginTable("Transform");
+        builder.AddNumber("positionX", 12.5);
+        builder.AddBoolean("locked", true);
+        builder.BeginObject("Enemy_1", 0);
+        builder.BeginTable("Health");
+        builder.AddNumber("health", 40.0);
+        return builder.Finish();
+    }
+
+    bool Loads(std::vector<unsigned char> image) {
+        CookedScene scene;
+        return scene.LoadFromMemory(std::move(image));
+    }
+}
+
+TEST_CASE(CookedScene_BakedSceneReadsLikeTheSource) {
+    const std::string path = SceneFixtures::MakeTempDirectory("CookedBake") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 20);
+    const SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+    CHECK(CookedScene::Bake(path, CookedScene::GetCookedPath(path)));
+    CHECK(CookedScene::IsUpToDate(path));
+
+    CookedScene scene;
+    CHECK(scene.Load(CookedScene::GetCookedPath(path)));
+    CHECK_EQ(scene.GetObjectCount(), dump.size());
+    for (const auto& [objectName, subTables] : dump) {
+        for (const auto& [subTable, fields] : subTables) {
+            CHECK(scene.HasTable(objectName, subTable));
+            for (const auto& [key, text] : fields) {
+                if (text.front() == '"') {
+                    CHECK_EQ(scene.Read<std::string>(objectName, { subTable, key }).value_or("?"), text.substr(1, text.size() - 2));
+                }
+                else if (text == "true" || text == "false") {
+                    CHECK_EQ(scene.Read<bool>(objectName, { subTable, key }).value_or(text != "true"), text == "true");
+                }
+                else {
+                    CHECK_EQ(scene.Read<double>(objectName, { subTable, key }).value_or(-1.0), std::stod(text));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(CookedScene_AcceptsAnIntactImage) {
+    CookedScene scene;
+    CHECK(scene.LoadFromMemory(BuildSmallImage()));
+    CHECK_EQ(scene.Read<std::string>("Player_0", { "Name", "name" }).value_or(""), std::string("Player"));
+    CHECK_EQ(scene.Read<double>("Player_0", { "Transform", "positionX" }).value_or(0.0), 12.5);
+    CHECK_EQ(scene.GetParentID(1), 0);
+    CHECK(scene.GetTableNames("Enemy_1") == std::vector<std::string>{ "Health" });
+}
+
+TEST_CASE(CookedScene_RejectsTruncatedImages) {
+    const std::vector<unsigned char> image = BuildSmallImage();
+    for (size_t size : { size_t(0), size_t(16), headerSize, image.size() / 2, image.size() - 1 }) {
+        CHECK(!Loads(std::vector<unsigned char>(image.begin(), image.begin() + size)));
+    }
+}
+
+TEST_CASE(CookedScene_RejectsOtherVersions) {
+    std::vector<unsigned char> image = BuildSmallImage();
+    WriteWord(image, 4, CookedScene::Version + 1);
+    CHECK(!Loads(image));
+
+    image = BuildSmallImage();
+    WriteWord(image, 0, 0);
+    CHECK(!Loads(image));
+}
+
+TEST_CASE(CookedScene_RejectsCountsThatWouldOverflow) {
+    std::vector<unsigned char> image = BuildSmallImage();
+    WriteWord(image, 8, 0xFFFFFFFFu);   // stringCount
+    CHECK(!Loads(image));
+
+    image = BuildSmallImage();
+    WriteWord(image, 20, 0xFFFFFFFFu);  // fieldCount
+    CHECK(!Loads(image));
+}
+
+TEST_CASE(CookedScene_RejectsRecordsOutOfRange) {
+    const std::vector<unsigned char> intact = BuildSmallImage();
+    const ImageLayout layout = GetLayout(intact);
+
+    // Object tables past the table records
+    std::vector<unsigned char> image = intact;
+    WriteWord(image, layout.objects + 16, layout.tableCount + 1);
+    CHECK(!Loads(image));
+
+    image = intact;
+    WriteWord(image, layout.objects + 12, 0xFFFFFFFFu);
+    CHECK(!Loads(image));
+
+    // Object name not in the string table
+    image = intact;
+    WriteWord(image, layout.objects, layout.stringCount);
+    CHECK(!Loads(image));
+
+    // Table fields past the field records
+    image = intact;
+    WriteWord(image, layout.tables + 8, layout.fieldCount + 1);
+    CHECK(!Loads(image));
+
+    // Table name not in the string table
+    image = intact;
+    WriteWord(image, layout.tables, 0x7FFFFFFFu);
+    CHECK(!Loads(image));
+
+    // Field key, string value and type
+    image = intact;
+    WriteWord(image, layout.fields, layout.stringCount);
+    CHECK(!Loads(image));
+
+    image = intact;
+    WriteWord(image, layout.fields + 4, 7);
+    CHECK(!Loads(image));
+
+    // The first field is the string "name" = "Player"
+    image = intact;
+    CHECK_EQ(ReadWord(image, layout.fields + 4), static_cast<uint32_t>(CookedScene::FieldType::STRING));
+    WriteWord(image, layout.fields + 8, layout.stringCount + 3);
+    CHECK(!Loads(image));
+
+    // String bytes outside the string blob
+    image = intact;
+    WriteWord(image, layout.strings + stringRecordSize, layout.stringBytes);
+    CHECK(!Loads(image));
+
+    image = intact;
+    WriteWord(image, layout.strings + stringRecordSize + 4, 0xFFFFFFF0u);
+    CHECK(!Loads(image));
+}
+
+TEST_CASE(CookedScene_DamagedFileFallsBackToLua) {
+    const std::string path = SceneFixtures::MakeTempDirectory("CookedDamaged") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 4);
+    const std::string cookedPath = CookedScene::GetCookedPath(path);
+    CHECK(CookedScene::Bake(path, cookedPath));
+
+    // Point the first object past the table records, as a stale or hand-edited file might
+    std::vector<unsigned char> image;
+    {
+        std::ifstream in(cookedPath, std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const ImageLayout layout = GetLayout(image);
+    WriteWord(image, layout.objects + 12, layout.tableCount);
+    {
+        std::ofstream out(cookedPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+
+    LuaSceneContext context(path);
+    CHECK(context.GetCookedScene() == nullptr);
+    LuaManager luaManager(path);
+    CHECK_EQ(luaManager.LuaReadFromTransform<float>(SceneFixtures::GetObjectTableName(0), "scaleY"), 1.25f);
+}
+
+TEST_CASE(CookedScene_ListsTheTexturesASceneNames) {
+    CookedScene::Builder builder;
+    builder.BeginObject("Player_0", -1);
+    builder.BeginTable("Sprite");
+    builder.AddString("SpritePathName_0", "PlayerSheet");
+    builder.AddString("SpriteName", "NotATexture");
+    builder.BeginObject("Enemy_1", -1);
+    builder.BeginTable("SpriteUI");
+    builder.AddString("SpritePathName", "Button");
+    builder.BeginTable("ParticleSystem");
+    builder.AddString("SpritePathName_0", "PlayerSheet");
+    builder.AddNumber("SpritePathNameCount", 1.0);
+
+    CookedScene scene;
+    CHECK(scene.LoadFromMemory(builder.Finish()));
+    CHECK(scene.GetStringValues("SpritePathName") == (std::vector<std::string>{ "PlayerSheet", "Button" }));
+    CHECK(scene.GetStringValues("NoSuchKey").empty());
+}
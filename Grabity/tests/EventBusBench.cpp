@@ -0,0 +1,221 @@
+/*!****************************************************************
+\file: EventBusBench.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Measures the EventBus with 0, 1, 4 and 16 subscribers and 1,
+        2 and 4 threads posting, while the main thread dispatches the
+        way the frame does. Each benchmark is selected by name on the
+        command line, e.g. "EventBusBench contended"; without an
+        argument every one runs.
+
+        Producers on more threads than the machine has cores take
+        turns instead of contending, so those rows are marked.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "EventBus.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    const size_t subscriberCounts[] = { 0, 1, 4, 16 };
+    const unsigned int producerCounts[] = { 1, 2, 4 };
+    constexpr size_t eventsPerRun = 400000;
+
+    // About the size of the gameplay events, e.g. EnemyKilledEvent
+    struct BenchEvent {
+        static constexpr EventBus::Phase phase = EventBus::Phase::END_OF_FRAME;
+        uint32_t kind = 0;
+        uint32_t object = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    std::atomic<uint64_t> sink{ 0 };    // Keeps the handlers' work from being optimised out
+
+    double ToNanoseconds(Clock::duration duration) {
+        return std::chrono::duration<double, std::nano>(duration).count();
+    }
+
+    /**
+     * \brief Subscribes handlers that do a little work with each event, and unsubscribes them at the end of a run.
+     */
+    struct Subscribers {
+        std::vector<EventBus::Subscription> subscriptions;
+        uint64_t sum = 0;
+
+        explicit Subscribers(size_t count) {
+            for (size_t index = 0; index < count; ++index) {
+                subscriptions.push_back(EventBus::GetInstance().Subscribe<BenchEvent>([this](const BenchEvent& event) {
+                    sum += event.kind + event.object;
+                }));
+            }
+        }
+
+        ~Subscribers() {
+            sink += sum;
+            for (EventBus::Subscription& subscription : subscriptions) {
+                EventBus::GetInstance().Unsubscribe(subscription);
+            }
+        }
+    };
+
+    struct RunResult {
+        double total = 0.0;     // Nanoseconds per event, posting to the last handler
+        double post = 0.0;      // Nanoseconds per Post on the producer threads
+        double overflow = 0.0;  // Share of posts that found the ring full
+    };
+
+    uint64_t Overflowed() {
+        for (const EventBus::ChannelStats& stats : EventBus::GetInstance().GetStats()) {
+            if (std::strcmp(stats.name, typeid(BenchEvent).name()) == 0) {
+                return stats.overflowed;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * \brief Posts events from threads while the main thread dispatches until all of them are delivered.
+     * \param subscriberCount Handlers for the event.
+     * \param producers Threads posting.
+     * \param dispatchEvery Rest between dispatches, as the frame does; zero dispatches as fast as it can.
+     * \return What was measured.
+     */
+    RunResult Run(size_t subscriberCount, unsigned int producers, std::chrono::microseconds dispatchEvery) {
+        EventBus& bus = EventBus::GetInstance();
+        Subscribers subscribers(subscriberCount);
+        const uint64_t overflowedBefore = Overflowed();
+        const size_t perThread = eventsPerRun / producers;
+
+        std::atomic<bool> go{ false };
+        std::atomic<uint64_t> postTime{ 0 };
+        std::vector<std::thread> threads;
+        for (unsigned int producer = 0; producer < producers; ++producer) {
+            threads.emplace_back([&, producer]() {
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                const Clock::time_point start = Clock::now();
+                for (size_t index = 0; index < perThread; ++index) {
+                    bus.Post(BenchEvent{ producer, static_cast<uint32_t>(index), 1.0f, 2.0f });
+                }
+                postTime += static_cast<uint64_t>(ToNanoseconds(Clock::now() - start));
+            });
+        }
+
+        const size_t expected = perThread * producers;
+        size_t delivered = 0;
+        const Clock::time_point start = Clock::now();
+        go = true;
+        while (delivered < expected) {
+            delivered += bus.Dispatch(EventBus::Phase::END_OF_FRAME);
+            if (dispatchEvery.count() > 0) {
+                std::this_thread::sleep_for(dispatchEvery);
+            }
+        }
+        const double elapsed = ToNanoseconds(Clock::now() - start);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        RunResult result;
+        result.total = elapsed / expected;
+        result.post = static_cast<double>(postTime.load()) / expected;
+        result.overflow = 100.0 * static_cast<double>(Overflowed() - overflowedBefore) / expected;
+        return result;
+    }
+
+    /**
+     * \brief Prints one table of every subscriber and producer count.
+     * \param title Printed above the table.
+     * \param dispatchEvery Rest between dispatches.
+     */
+    void PrintTable(const char* title, std::chrono::microseconds dispatchEvery) {
+        const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        std::printf("%s\n", title);
+        std::printf("  %11s %9s %12s %12s %9s\n", "subscribers", "producers", "ns/event", "ns/post", "overflow");
+        for (size_t subscriberCount : subscriberCounts) {
+            for (unsigned int producers : producerCounts) {
+                const RunResult result = Run(subscriberCount, producers, dispatchEvery);
+                std::printf("  %11zu %9u %12.1f %12.1f %8.1f%%%s\n", subscriberCount, producers, result.total, result.post,
+                    result.overflow, producers + 1 > cores ? "  (more threads than cores)" : "");
+            }
+        }
+    }
+
+    /**
+     * \brief The main thread dispatches as fast as it can, so producers and the consumer contend for the ring.
+     */
+    void BenchContended() {
+        PrintTable("Dispatching continuously", std::chrono::microseconds(0));
+    }
+
+    /**
+     * \brief The main thread dispatches once a millisecond, so the ring fills between dispatches and
+     *        most posts past the capacity take the overflow lock.
+     */
+    void BenchFrames() {
+        PrintTable("Dispatching every millisecond", std::chrono::microseconds(1000));
+    }
+
+    /**
+     * \brief Events posted and dispatched on the main thread alone, the cost of delivery without contention.
+     */
+    void BenchDelivery() {
+        EventBus& bus = EventBus::GetInstance();
+        constexpr size_t batch = EventBus::QueueCapacity;   // As many as fit without overflowing
+        constexpr int batches = 400;
+        std::printf("Single thread, %zu events posted then dispatched, %d times\n", batch, batches);
+        std::printf("  %11s %12s %12s\n", "subscribers", "ns/post", "ns/dispatch");
+        for (size_t subscriberCount : subscriberCounts) {
+            Subscribers subscribers(subscriberCount);
+            double post = 0.0;
+            double dispatch = 0.0;
+            for (int run = 0; run < batches; ++run) {
+                const Clock::time_point start = Clock::now();
+                for (size_t index = 0; index < batch; ++index) {
+                    bus.Post(BenchEvent{ 0, static_cast<uint32_t>(index), 1.0f, 2.0f });
+                }
+                const Clock::time_point posted = Clock::now();
+                bus.Dispatch(EventBus::Phase::END_OF_FRAME);
+                post += ToNanoseconds(posted - start);
+                dispatch += ToNanoseconds(Clock::now() - posted);
+            }
+            std::printf("  %11zu %12.1f %12.1f\n", subscriberCount, post / (batch * batches), dispatch / (batch * batches));
+        }
+    }
+
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+}
+
+int main(int argc, char** argv) {
+    const Benchmark benchmarks[] = {
+        { "delivery", BenchDelivery },
+        { "contended", BenchContended },
+        { "frames", BenchFrames },
+    };
+
+    std::printf("%zu events per run, ring of %zu, %u hardware threads\n\n", eventsPerRun, EventBus::QueueCapacity,
+        std::thread::hardware_concurrency());
+    for (const Benchmark& benchmark : benchmarks) {
+        if (argc < 2 || std::strcmp(argv[1], benchmark.name) == 0) {
+            benchmark.run();
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+/*!****************************************************************
+\file: EventBusTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for the EventBus queues: producers on many threads lose
+        and duplicate nothing while the main thread dispatches, a full
+        ring spills into the overflow list and keeps every event, one
+        thread's events arrive in the order it posted them, handlers
+        can subscribe and unsubscribe while a batch is delivered, and
+        handlers that keep posting are cut off after MaxRounds. Each
+        test has its own event types, as every type's queue and
+        subscribers live as long as the program. Build with
+        -fsanitize=thread to have the same runs checked for data races.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "EventBus.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // An event that says which thread posted it and how many it had posted before
+    template <int Test>
+    struct SequencedEvent {
+        static constexpr EventBus::Phase phase = EventBus::Phase::END_OF_FRAME;
+        uint32_t thread = 0;
+        uint32_t sequence = 0;
+    };
+
+    /**
+     * \brief The counters of an event type.
+     * \return Its counters, empty if it was never used.
+     */
+    template <typename Event>
+    EventBus::ChannelStats StatsOf() {
+        for (const EventBus::ChannelStats& stats : EventBus::GetInstance().GetStats()) {
+            if (std::strcmp(stats.name, typeid(Event).name()) == 0) {
+                return stats;
+            }
+        }
+        return EventBus::ChannelStats{};
+    }
+
+    /**
+     * \brief Records every event of a type that reaches a subscriber, and unsubscribes at the end of a test.
+     */
+    template <typename Event>
+    struct Recorder {
+        std::vector<Event> received;
+        EventBus::Subscription subscription;
+
+        Recorder() {
+            subscription = EventBus::GetInstance().Subscribe<Event>([this](const Event& event) { received.push_back(event); });
+        }
+        ~Recorder() { EventBus::GetInstance().Unsubscribe(subscription); }
+
+        /**
+         * \brief Checks each thread's events arrived in the order it posted them.
+         * \param threads The number of posting threads.
+         * \return True if they did.
+         */
+        bool InThreadOrder(uint32_t threads) const {
+            std::vector<uint32_t> next(threads, 0);
+            for (const Event& event : received) {
+                if (event.thread >= threads || event.sequence != next[event.thread]) {
+                    return false;
+                }
+                ++next[event.thread];
+            }
+            return true;
+        }
+    };
+}
+
+TEST_CASE(EventBus_ProducersLoseAndDuplicateNothing) {
+    using Event = SequencedEvent<0>;
+    constexpr uint32_t perThread = 20000;
+    const uint32_t threadCounts[] = { 1, 2, 4, 8 };
+    for (uint32_t threads : threadCounts) {
+        Recorder<Event> recorder;
+        const uint64_t overflowedBefore = StatsOf<Event>().overflowed;
+
+        std::atomic<uint32_t> running{ threads };
+        std::vector<std::thread> producers;
+        for (uint32_t thread = 0; thread < threads; ++thread) {
+            producers.emplace_back([thread, &running]() {
+                for (uint32_t sequence = 0; sequence < perThread; ++sequence) {
+                    EventBus::GetInstance().Post(Event{ thread, sequence });
+                }
+                --running;
+            });
+        }
+        // The main thread dispatches as it would each frame while the workers post
+        while (running.load() > 0) {
+            EventBus::GetInstance().Dispatch(EventBus::Phase::END_OF_FRAME);
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        EventBus::GetInstance().Dispatch(EventBus::Phase::END_OF_FRAME);
+
+        CHECK_EQ(recorder.received.size(), size_t(threads) * perThread);
+        std::vector<std::vector<int>> seen(threads, std::vector<int>(perThread, 0));
+        int wrong = 0;
+        for (const Event& event : recorder.received) {
+            if (event.thread < threads && event.sequence < perThread) {
+                ++seen[event.thread][event.sequence];
+            }
+            else {
+                ++wrong;
+            }
+        }
+        for (const std::vector<int>& thread : seen) {
+            for (int count : thread) {
+                wrong += count != 1;
+            }
+        }
+        CHECK_EQ(wrong, 0);
+        // Order only holds for what went through the ring
+        if (StatsOf<Event>().overflowed == overflowedBefore) {
+            CHECK(recorder.InThreadOrder(threads));
+        }
+        CHECK_EQ(StatsOf<Event>().queued, size_t(0));
+    }
+}
+
+TEST_CASE(EventBus_FullRingSpillsIntoOverflow) {
+    using Event = SequencedEvent<1>;
+    Recorder<Event> recorder;
+    constexpr uint32_t extra = 300;
+
+    // Twice, so the second time the ring has wrapped and its cells are reused
+    for (int pass = 0; pass < 2; ++pass) {
+        recorder.received.clear();
+        const uint64_t overflowedBefore = StatsOf<Event>().overflowed;
+        for (uint32_t sequence = 0; sequence < EventBus::QueueCapacity + extra; ++sequence) {
+            EventBus::GetInstance().Post(Event{ 0, sequence });
+        }
+        const EventBus::ChannelStats full = StatsOf<Event>();
+        CHECK_EQ(full.queued, EventBus::QueueCapacity);
+        CHECK_EQ(full.overflowed - overflowedBefore, uint64_t(extra));
+
+        // The ring is delivered before the overflow, so one thread's events stay in order
+        CHECK_EQ(EventBus::GetInstance().Dispatch(EventBus::Phase::END_OF_FRAME), EventBus::QueueCapacity + extra);
+        CHECK_EQ(recorder.received.size(), EventBus::QueueCapacity + extra);
+        CHECK(recorder.InThreadOrder(1));
+        CHECK_EQ(StatsOf<Event>().queued, size_t(0));
+
+        // Nothing is left to hand out again
+        CHECK_EQ(EventBus::GetInstance().Dispatch(EventBus::Phase::END_OF_FRAME), size_t(0));
+    }
+}
+
+TEST_CASE(EventBus_EachThreadsEventsKeepTheirOrder) {
+    using Event = SequencedEvent<2>;
+    constexpr uint32_t threads = 4;
+    constexpr uint32_t perThread = EventBus::QueueCapacity / threads;   // Fills the ring without overflowing
+    Recorder<Event> recorder;
+
+    for (int frame = 0; frame < 20; ++frame) {
+        recorder.received.clear();
+        std::vector<std::thread> producers;
+        for (uint32_t thread = 0; thread < threads; ++thread) {
+            producers.emplace_back([thread]() {
+                for (uint32_t sequence = 0; sequence < perThread; ++sequence) {
+                    EventBus::GetInstance().Post(Event{ thread, sequence });
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        EventBus::GetInstance().Dispatch(EventBus::Phase::END_OF_FRAME);
+        CHECK_EQ(recorder.received.size(), size_t(threads * perThread));
+        CHECK(recorder.InThreadOrder(threads));
+    }
+    CHECK_EQ(StatsOf<Event>().overflowed, uint64_t(0));
+}
+
+TEST_CASE(EventBus_HandlersCanSubscribeAndUnsubscribe) {
+    using Event = SequencedEvent<3>;
+    EventBus& bus = EventBus::GetInstance();
+    std::vector<int> calls;
+
+    // First: unsubscribes itself on its second event. Second: unsubscribes the third on its first
+    // event and subscribes a fourth. Third: never hears anything, it was removed before its turn.
+    EventBus::Subscription first, second, third, fourth;
+    first = bus.Subscribe<Event>([&](const Event& event) {
+        calls.push_back(1);
+        if (event.sequence == 1) {
+            bus.Unsubscribe(first);
+        }
+    });
+    second = bus.Subscribe<Event>([&](const Event& event) {
+        calls.push_back(2);
+        if (event.sequence == 0) {
+            bus.Unsubscribe(third);
+            fourth = bus.Subscribe<Event>([&](const Event&) { calls.push_back(4); });
+        }
+    });
+    third = bus.Subscribe<Event>([&](const Event&) { calls.push_back(3); });
+
+    for (uint32_t sequence = 0; sequence < 3; ++sequence) {
+        bus.Post(Event{ 0, sequence });
+    }
+    bus.Dispatch(EventBus::Phase::END_OF_FRAME);
+    // The first stops after its second event, the fourth waits for the next batch
+    CHECK((calls == std::vector<int>{ 1, 1, 2, 2, 2 }));
+    CHECK_EQ(StatsOf<Event>().subscribers, size_t(2));
+
+    calls.clear();
+    bus.Post(Event{ 0, 3 });
+    bus.Dispatch(EventBus::Phase::END_OF_FRAME);
+    CHECK((calls == std::vector<int>{ 2, 4 }));
+
+    // Unsubscribing twice, or a subscription that was cleared, does nothing
+    bus.Unsubscribe(first);
+    bus.Unsubscribe(third);
+    bus.Unsubscribe(second);
+    bus.Unsubscribe(fourth);
+    bus.Unsubscribe(fourth);
+    CHECK_EQ(StatsOf<Event>().subscribers, size_t(0));
+}
+
+TEST_CASE(EventBus_RepostsAreCappedAtMaxRounds) {
+    using Repost = SequencedEvent<4>;
+    using Chained = SequencedEvent<5>;
+    EventBus& bus = EventBus::GetInstance();
+
+    // Posting the next type in a handler is delivered in the same dispatch
+    Recorder<Chained> chained;
+    EventBus::Subscription chain = bus.Subscribe<Repost>([&](const Repost& event) {
+        if (event.sequence == 0) {
+            bus.Post(Chained{ 0, 0 });
+        }
+    });
+    bus.Post(Repost{ 0, 0 });
+    CHECK_EQ(bus.Dispatch(EventBus::Phase::END_OF_FRAME), size_t(2));
+    CHECK_EQ(chained.received.size(), size_t(1));
+    bus.Unsubscribe(chain);
+
+    // A handler that always posts again is stopped after MaxRounds, and the rest waits for the next dispatch
+    uint32_t handled = 0;
+    EventBus::Subscription loop = bus.Subscribe<Repost>([&](const Repost& event) {
+        ++handled;
+        bus.Post(Repost{ 0, event.sequence + 1 });
+    });
+    bus.Post(Repost{ 0, 0 });
+    CHECK_EQ(bus.Dispatch(EventBus::Phase::END_OF_FRAME), size_t(EventBus::MaxRounds));
+    CHECK_EQ(handled, uint32_t(EventBus::MaxRounds));
+    CHECK_EQ(StatsOf<Repost>().queued, size_t(1));
+
+    CHECK_EQ(bus.Dispatch(EventBus::Phase::END_OF_FRAME), size_t(EventBus::MaxRounds));
+    CHECK_EQ(handled, uint32_t(2 * EventBus::MaxRounds));
+
+    // Other phases do not deliver it
+    CHECK_EQ(bus.Dispatch(EventBus::Phase::FRAME_START), size_t(0));
+    bus.Unsubscribe(loop);
+    bus.Dispatch(EventBus::Phase::END_OF_FRAME);
+    CHECK_EQ(StatsOf<Repost>().queued, size_t(0));
+}
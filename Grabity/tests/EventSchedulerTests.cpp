@@ -0,0 +1,218 @@
+/*!****************************************************************
+\file: EventSchedulerTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for EventScheduler: events go out on the step they fall
+        due in and never more than one step late, events due together
+        keep their scheduling order, a paused clock holds every event
+        back, and the same schedule replays the same dispatches however
+        the steps are spread over frames.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "EventScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+    constexpr double fixedStep = 1.0 / 60.0;    // Engine::fixedDT
+
+    using Scheduler = EventScheduler<int>;
+
+    /**
+     * \brief Schedules the same wave-like events every time: a few waves, some due together,
+     *        at times that are and are not whole steps.
+     * \param scheduler The scheduler to fill.
+     */
+    void ScheduleWaves(Scheduler& scheduler) {
+        std::mt19937 random(20241017);
+        std::uniform_real_distribution<double> dueTimes(0.0, 30.0);
+        for (int event = 0; event < 500; ++event) {
+            scheduler.Schedule(event % 5 == 0 ? std::floor(dueTimes(random)) : dueTimes(random), event);
+        }
+    }
+
+    bool SameLog(const std::vector<Scheduler::Dispatch>& a, const std::vector<Scheduler::Dispatch>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t index = 0; index < a.size(); ++index) {
+            if (a[index].sequence != b[index].sequence || a[index].step != b[index].step
+                || a[index].due != b[index].due || a[index].lateness != b[index].lateness) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(EventScheduler_DispatchesOnTheExactStep) {
+    Scheduler scheduler;
+    // Due on every step for ten seconds, times that are not exact in binary
+    for (int step = 1; step <= 600; ++step) {
+        scheduler.Schedule(step * fixedStep, step);
+    }
+    // 0.5 s is the end of step 30, a little after it is step 31
+    scheduler.Schedule(0.5, 1000);
+    scheduler.Schedule(0.5 + 1e-4, 1001);
+
+    std::vector<std::pair<int, uint64_t>> dispatched;
+    for (int frame = 0; frame < 600; ++frame) {
+        scheduler.Advance(fixedStep, 1, [&](const int& event, double) { dispatched.push_back({ event, scheduler.GetStep() }); });
+    }
+
+    CHECK_EQ(dispatched.size(), size_t(602));
+    int wrongStep = 0;
+    for (const auto& [event, step] : dispatched) {
+        const uint64_t expected = event == 1000 ? 30 : event == 1001 ? 31 : static_cast<uint64_t>(event);
+        wrongStep += step != expected;
+    }
+    CHECK_EQ(wrongStep, 0);
+    CHECK_EQ(scheduler.GetTime(), 10.0);
+}
+
+TEST_CASE(EventScheduler_LatenessIsUnderOneStep) {
+    Scheduler scheduler;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> dueTimes(0.0, 20.0);
+    for (int event = 0; event < 5000; ++event) {
+        scheduler.Schedule(dueTimes(random), event);
+    }
+
+    double latest = 0.0;
+    int early = 0;
+    scheduler.Advance(fixedStep, 1200, [&](const int&, double lateness) {
+        latest = std::max(latest, lateness);
+    });
+    for (const Scheduler::Dispatch& dispatch : scheduler.GetLog()) {
+        // Never before the step it is due in
+        early += dispatch.step < static_cast<uint64_t>(std::ceil(dispatch.due / fixedStep - 1e-6));
+    }
+    CHECK_EQ(scheduler.GetLog().size(), size_t(5000));
+    CHECK_EQ(scheduler.GetPendingCount(), size_t(0));
+    CHECK_EQ(early, 0);
+    CHECK(latest <= fixedStep);
+
+    // An event due before the clock goes out on the next step, late by the gap
+    scheduler.Schedule(scheduler.GetTime() - 2.0, 1);
+    double lateness = -1.0;
+    scheduler.Advance(fixedStep, 1, [&](const int&, double late) { lateness = late; });
+    CHECK(std::fabs(lateness - (2.0 + fixedStep)) < 1e-9);
+}
+
+TEST_CASE(EventScheduler_EventsDueTogetherKeepTheirOrder) {
+    Scheduler scheduler;
+    // Due together, scheduled among earlier and later ones
+    for (int event = 0; event < 100; ++event) {
+        scheduler.Schedule(1.0, event);
+        scheduler.Schedule(0.5, 1000 + event);
+        scheduler.Schedule(1.5, 2000 + event);
+    }
+
+    std::vector<int> order;
+    scheduler.Advance(fixedStep, 120, [&](const int& event, double) { order.push_back(event); });
+
+    CHECK_EQ(order.size(), size_t(300));
+    bool inOrder = true;
+    for (int event = 0; event < 100; ++event) {
+        inOrder = inOrder && order[event] == 1000 + event && order[100 + event] == event && order[200 + event] == 2000 + event;
+    }
+    CHECK(inOrder);
+
+    // An event scheduled while dispatching that is due within the step goes out in it, after its scheduler
+    Scheduler chained;
+    chained.Schedule(0.25, 1);
+    std::vector<std::pair<int, uint64_t>> chainedOrder;
+    chained.Advance(fixedStep, 30, [&](const int& event, double) {
+        chainedOrder.push_back({ event, chained.GetStep() });
+        if (event == 1) {
+            chained.Schedule(0.25, 2);
+        }
+    });
+    CHECK_EQ(chainedOrder.size(), size_t(2));
+    CHECK(chainedOrder[1].first == 2 && chainedOrder[1].second == chainedOrder[0].second);
+}
+
+TEST_CASE(EventScheduler_PausedClockHoldsEventsBack) {
+    Scheduler scheduler;
+    scheduler.Schedule(1.0, 1);
+    int dispatched = 0;
+    auto count = [&](const int&, double) { ++dispatched; };
+
+    scheduler.Advance(fixedStep, 30, count);
+    // EventSystem::Update does not advance while paused, however many frames pass
+    const double pausedAt = scheduler.GetTime();
+    for (int frame = 0; frame < 1000; ++frame) {
+        scheduler.Advance(fixedStep, 0, count);
+    }
+    CHECK_EQ(scheduler.GetTime(), pausedAt);
+    CHECK_EQ(dispatched, 0);
+
+    scheduler.Advance(fixedStep, 29, count);
+    CHECK_EQ(dispatched, 0);
+    scheduler.Advance(fixedStep, 1, count);
+    CHECK_EQ(dispatched, 1);
+    CHECK_EQ(scheduler.GetLog().back().step, uint64_t(60));
+}
+
+TEST_CASE(EventScheduler_ReplaysIdenticallyAcrossFrameRates) {
+    // One step per frame, as at 60 FPS
+    Scheduler reference;
+    ScheduleWaves(reference);
+    for (int frame = 0; frame < 1800; ++frame) {
+        reference.Advance(fixedStep, 1, nullptr);
+    }
+    CHECK_EQ(reference.GetLog().size(), size_t(500));
+
+    // The same steps from an accumulator at 30, 144 and 240 FPS, and from frames of random length with hitches
+    const double frameRates[] = { 30.0, 144.0, 240.0 };
+    for (double frameRate : frameRates) {
+        Scheduler replay;
+        ScheduleWaves(replay);
+        double accumulator = 0.0;
+        while (replay.GetStep() < 1800) {
+            accumulator += 1.0 / frameRate;
+            int steps = 0;
+            while (accumulator >= fixedStep && replay.GetStep() + steps < 1800) {
+                accumulator -= fixedStep;
+                ++steps;
+            }
+            replay.Advance(fixedStep, steps, nullptr);
+        }
+        CHECK(SameLog(replay.GetLog(), reference.GetLog()));
+    }
+
+    Scheduler uneven;
+    ScheduleWaves(uneven);
+    std::mt19937 random(99);
+    std::uniform_int_distribution<int> stepsPerFrame(0, 12);
+    while (uneven.GetStep() < 1800) {
+        uneven.Advance(fixedStep, std::min<int>(stepsPerFrame(random), static_cast<int>(1800 - uneven.GetStep())), nullptr);
+    }
+    CHECK(SameLog(uneven.GetLog(), reference.GetLog()));
+    CHECK_EQ(uneven.GetTime(), reference.GetTime());
+
+    // Reset starts a run over from nothing
+    uneven.Reset();
+    CHECK_EQ(uneven.GetStep(), uint64_t(0));
+    CHECK(uneven.GetLog().empty());
+    ScheduleWaves(uneven);
+    uneven.Advance(fixedStep, 1800, nullptr);
+    CHECK(SameLog(uneven.GetLog(), reference.GetLog()));
+}
+
+TEST_CASE(EventScheduler_StepLengthChangeKeepsTheClock) {
+    Scheduler scheduler;
+    scheduler.Schedule(1.5, 1);
+    scheduler.Advance(1.0 / 60.0, 60, nullptr);
+    CHECK_EQ(scheduler.GetTime(), 1.0);
+    scheduler.Advance(1.0 / 30.0, 30, nullptr);
+    CHECK(std::fabs(scheduler.GetTime() - 2.0) < 1e-12);
+    CHECK_EQ(scheduler.GetLog().size(), size_t(1));
+    CHECK_EQ(scheduler.GetLog().front().step, uint64_t(75));
+}
@@ -0,0 +1,403 @@
+/*!****************************************************************
+\file: FramePacerBench.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Headless harness for the FramePacer. Runs a loop of synthetic
+        frames, burning a set amount of CPU in each like Update and
+        the draw would, and measures how close to the target the
+        frames come and how much CPU the main thread uses. The old
+        busy-wait loop from main.cpp runs alongside for comparison.
+        Each benchmark is selected by name on the command line, e.g.
+        "FramePacerBench pacing"; without an argument every one runs.
+        The states benchmark drives the pacer through the focused,
+        unfocused and minimised rates the InterruptionHandler sets,
+        with a stand-in for the window's event wait.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "FramePacer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr double secondsPerRun = 2.0;
+
+    double ToMilliseconds(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    /**
+     * \brief Retrieves the CPU time the calling thread has used.
+     * \return User and kernel time in milliseconds.
+     */
+    double GetThreadCpuMilliseconds() {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+        auto toMilliseconds = [](const FILETIME& time) {
+            return static_cast<double>((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10000.0;
+        };
+        return toMilliseconds(kernel) + toMilliseconds(user);
+#elif defined(__linux__)
+        rusage usage{};
+        getrusage(RUSAGE_THREAD, &usage);
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+#else
+        return 0.0;
+#endif
+    }
+
+    // Keeps the CPU busy for a time, standing in for a frame's work
+    void Work(double milliseconds) {
+        const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(milliseconds));
+        while (Clock::now() < end) {
+        }
+    }
+
+    /**
+     * \brief The main loop's wait before FramePacer: spin until the frame time has passed since the frame started.
+     */
+    struct BusyWait {
+        Clock::time_point frameStart = Clock::now();
+
+        void Wait(double frameMilliseconds) {
+            while (ToMilliseconds(Clock::now() - frameStart) < frameMilliseconds) {
+            }
+            frameStart = Clock::now();
+        }
+    };
+
+    struct RunResult {
+        double average = 0.0;
+        double jitter = 0.0;
+        double p99 = 0.0;
+        double worst = 0.0;
+        int late = 0;           // Frames more than 1 ms over the target
+        double cpu = 0.0;       // Main thread CPU time over wall time
+        double sleep = 0.0;     // Per frame, pacer only
+        double spin = 0.0;      // Per frame, pacer only
+        double overshoot = 0.0; // The pacer's estimate at the end
+    };
+
+    /**
+     * \brief Runs frames for a few seconds and measures them.
+     * \param framesPerSecond The target frame rate.
+     * \param workTime Called for each frame's work in milliseconds.
+     * \param usePacer FramePacer if true, the old busy-wait otherwise.
+     * \return What was measured.
+     */
+    RunResult RunFrames(double framesPerSecond, const std::function<double()>& workTime, bool usePacer) {
+        const double target = 1000.0 / framesPerSecond;
+        const int frameCount = static_cast<int>(secondsPerRun * framesPerSecond);
+        FramePacer& pacer = FramePacer::GetInstance();
+        pacer.SetTargetFrameRate(framesPerSecond);
+        pacer.ResetStats();
+        BusyWait busyWait;
+
+        std::vector<double> frameTimes;
+        frameTimes.reserve(frameCount);
+        const double cpuStart = GetThreadCpuMilliseconds();
+        const Clock::time_point start = Clock::now();
+        Clock::time_point last = start;
+        for (int frame = 0; frame < frameCount; ++frame) {
+            Work(workTime());
+            if (usePacer) {
+                pacer.WaitForNextFrame();
+            }
+            else {
+                busyWait.Wait(target);
+            }
+            const Clock::time_point now = Clock::now();
+            frameTimes.push_back(ToMilliseconds(now - last));
+            last = now;
+        }
+        const double wall = ToMilliseconds(Clock::now() - start);
+        const double cpu = GetThreadCpuMilliseconds() - cpuStart;
+
+        RunResult result;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        for (double frameTime : frameTimes) {
+            sum += frameTime;
+            sumSquares += frameTime * frameTime;
+            result.late += frameTime > target + 1.0;
+        }
+        result.average = sum / frameTimes.size();
+        result.jitter = std::sqrt(std::max(0.0, sumSquares / frameTimes.size() - result.average * result.average));
+        std::sort(frameTimes.begin(), frameTimes.end());
+        result.p99 = frameTimes[frameTimes.size() * 99 / 100];
+        result.worst = frameTimes.back();
+        result.cpu = 100.0 * cpu / wall;
+        if (usePacer) {
+            const FramePacer::Stats stats = pacer.GetStats();
+            result.sleep = stats.averageSleep;
+            result.spin = stats.averageSpin;
+            result.overshoot = stats.sleepOvershoot;
+        }
+        return result;
+    }
+
+    void PrintHeader() {
+        std::printf("  %-10s %8s %8s %8s %8s %8s %5s %6s %8s %8s %9s\n",
+            "wait", "target", "avg", "jitter", "p99", "worst", "late", "cpu", "sleep", "spin", "overshoot");
+    }
+
+    void PrintRow(const char* name, double framesPerSecond, const RunResult& result) {
+        std::printf("  %-10s %8.3f %8.3f %8.3f %8.3f %8.3f %5d %5.0f%% %8.3f %8.3f %9.3f\n", name, 1000.0 / framesPerSecond,
+            result.average, result.jitter, result.p99, result.worst, result.late, result.cpu, result.sleep, result.spin, result.overshoot);
+    }
+
+    /**
+     * \brief Steady work per frame at the usual targets, pacer against busy-wait.
+     */
+    void BenchPacing() {
+        const double frameRates[] = { 60.0, 144.0, 240.0 };
+        const double workTimes[] = { 2.0, 8.0 };
+        std::printf("Steady work, milliseconds per frame\n");
+        for (double workTime : workTimes) {
+            for (double frameRate : frameRates) {
+                if (workTime >= 1000.0 / frameRate) {
+                    continue;
+                }
+                std::printf("%.0f FPS, %.0f ms of work\n", frameRate, workTime);
+                PrintHeader();
+                PrintRow("pacer", frameRate, RunFrames(frameRate, [workTime]() { return workTime; }, true));
+                PrintRow("busy-wait", frameRate, RunFrames(frameRate, [workTime]() { return workTime; }, false));
+            }
+        }
+    }
+
+    /**
+     * \brief Work that varies from frame to frame with an occasional frame over budget, where the
+     *        pacer's fixed schedule should keep the average on target.
+     */
+    void BenchUneven() {
+        const double frameRate = 60.0;
+        std::printf("60 FPS, 1 to 12 ms of work, every 50th frame 25 ms\n");
+        PrintHeader();
+        for (bool usePacer : { true, false }) {
+            std::mt19937 random(20241017);
+            std::uniform_real_distribution<double> workTimes(1.0, 12.0);
+            int frame = 0;
+            PrintRow(usePacer ? "pacer" : "busy-wait", frameRate, RunFrames(frameRate, [&]() {
+                return ++frame % 50 == 0 ? 25.0 : workTimes(random);
+            }, usePacer));
+        }
+    }
+
+    /**
+     * \brief Steady work while another thread keeps a core busy, which makes the OS wake sleeping
+     *        threads later; the pacer's overshoot estimate has to follow it.
+     */
+    void BenchBackground() {
+        const double frameRate = 60.0;
+        std::atomic<bool> stop{ false };
+        std::thread background([&stop]() {
+            while (!stop) {
+                Work(1.0);
+            }
+        });
+        std::printf("60 FPS, 4 ms of work, one background thread spinning\n");
+        PrintHeader();
+        PrintRow("pacer", frameRate, RunFrames(frameRate, []() { return 4.0; }, true));
+        PrintRow("busy-wait", frameRate, RunFrames(frameRate, []() { return 4.0; }, false));
+        stop = true;
+        background.join();
+    }
+
+    /**
+     * \brief Stands in for the window's event queue. The throttled states sleep in it the way
+     *        WaitForWindowEvents sleeps in glfwWaitEventsTimeout, and a focus event posted from
+     *        another thread wakes the wait and runs the focus callback on the main thread.
+     */
+    struct WindowEvents {
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool focusPending = false;
+        Clock::time_point postedAt;
+        bool interruptOnFocus = true;
+        double foregroundFrameRate = 60.0;
+        int waits = 0;
+    };
+    WindowEvents windowEvents;
+
+    /**
+     * \brief The pacer's sleep function in the throttled states. On a focus event it does what
+     *        InterruptionHandler::ChangeWindowState does on regaining focus.
+     * \param milliseconds The longest to wait for an event.
+     */
+    void WaitForWindowEvents(double milliseconds) {
+        std::unique_lock<std::mutex> lock(windowEvents.mutex);
+        ++windowEvents.waits;
+        windowEvents.wake.wait_for(lock, std::chrono::duration<double, std::milli>(milliseconds),
+            []() { return windowEvents.focusPending; });
+        if (!windowEvents.focusPending) {
+            return;
+        }
+        windowEvents.focusPending = false;
+        lock.unlock();
+
+        FramePacer& pacer = FramePacer::GetInstance();
+        pacer.SetSleepFunction(nullptr);
+        pacer.SetTargetFrameRate(windowEvents.foregroundFrameRate);
+        if (windowEvents.interruptOnFocus) {
+            pacer.Interrupt();
+        }
+    }
+
+    // Posts a focus event from the calling thread, as the OS would deliver one to the window
+    void PostFocusEvent() {
+        std::lock_guard<std::mutex> lock(windowEvents.mutex);
+        windowEvents.focusPending = true;
+        windowEvents.postedAt = Clock::now();
+        windowEvents.wake.notify_one();
+    }
+
+    // The rates and work of each window state. The throttled rates are BackgroundPolicy's defaults,
+    // and a minimised window does not draw, so only the update's share of the work is left.
+    struct WindowState {
+        const char* name;
+        double framesPerSecond;
+        double workTime;
+        bool waitForEvents;
+    };
+    const WindowState windowStates[] = {
+        { "focused", 60.0, 4.0, false },
+        { "unfocused", 15.0, 4.0, true },
+        { "minimised", 5.0, 0.5, true },
+    };
+
+    /**
+     * \brief Runs a few seconds in each window state and prints the CPU the main thread used in it.
+     */
+    void RunWindowStates() {
+        FramePacer& pacer = FramePacer::GetInstance();
+        std::printf("  %-10s %8s %8s %6s %8s %8s %11s\n", "state", "target", "avg", "cpu", "sleep", "spin", "waits/frame");
+        for (const WindowState& state : windowStates) {
+            const int frameCount = static_cast<int>(secondsPerRun * state.framesPerSecond);
+            pacer.SetSleepFunction(state.waitForEvents ? WaitForWindowEvents : nullptr);
+            pacer.SetTargetFrameRate(state.framesPerSecond);
+            pacer.WaitForNextFrame();
+            pacer.ResetStats();
+            windowEvents.waits = 0;
+
+            const double cpuStart = GetThreadCpuMilliseconds();
+            const Clock::time_point start = Clock::now();
+            for (int frame = 0; frame < frameCount; ++frame) {
+                Work(state.workTime);
+                pacer.WaitForNextFrame();
+            }
+            const double wall = ToMilliseconds(Clock::now() - start);
+            const double cpu = GetThreadCpuMilliseconds() - cpuStart;
+
+            const FramePacer::Stats stats = pacer.GetStats();
+            std::printf("  %-10s %8.3f %8.3f %5.1f%% %8.3f %8.3f", state.name, 1000.0 / state.framesPerSecond,
+                stats.averageFrameTime, 100.0 * cpu / wall, stats.averageSleep, stats.averageSpin);
+            if (state.waitForEvents) {
+                std::printf(" %11.2f\n", static_cast<double>(windowEvents.waits) / frameCount);
+            }
+            else {
+                std::printf(" %11s\n", "-");
+            }
+        }
+        pacer.SetSleepFunction(nullptr);
+    }
+
+    /**
+     * \brief Minimises, then has another thread post a focus event at a random point in the frame,
+     *        and measures how long the main thread takes to come out of its wait.
+     * \param interrupt Whether the focus callback interrupts the wait, as ChangeWindowState does.
+     */
+    void RunFocusWakes(bool interrupt) {
+        constexpr int trials = 10;
+        FramePacer& pacer = FramePacer::GetInstance();
+        const WindowState& minimised = windowStates[2];
+        std::mt19937 random(20241017);
+        std::uniform_real_distribution<double> postDelays(20.0, 1000.0 / minimised.framesPerSecond - 20.0);
+        windowEvents.interruptOnFocus = interrupt;
+        windowEvents.foregroundFrameRate = windowStates[0].framesPerSecond;
+
+        double sum = 0.0;
+        double worst = 0.0;
+        for (int trial = 0; trial < trials; ++trial) {
+            pacer.SetSleepFunction(WaitForWindowEvents);
+            pacer.SetTargetFrameRate(minimised.framesPerSecond);
+            pacer.WaitForNextFrame();
+
+            const double postDelay = postDelays(random);
+            std::thread window([postDelay]() {
+                std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(postDelay));
+                PostFocusEvent();
+            });
+            while (pacer.GetTargetFrameRate() != windowEvents.foregroundFrameRate) {
+                Work(minimised.workTime);
+                pacer.WaitForNextFrame();
+            }
+            window.join();
+            const double latency = ToMilliseconds(Clock::now() - windowEvents.postedAt);
+            sum += latency;
+            worst = std::max(worst, latency);
+        }
+        std::printf("  %-10s %8.3f %8.3f\n", interrupt ? "interrupt" : "none", sum / trials, worst);
+        windowEvents.interruptOnFocus = true;
+        pacer.SetSleepFunction(nullptr);
+    }
+
+    /**
+     * \brief The rates the window states throttle the loop to, and how quickly regaining focus
+     *        gets the loop back to full rate from the minimised wait.
+     */
+    void BenchStates() {
+        std::printf("Window states, event waits standing in for glfwWaitEventsTimeout\n");
+        RunWindowStates();
+        std::printf("Focus event while minimised, milliseconds from the event to the end of the wait\n");
+        std::printf("  %-10s %8s %8s\n", "on focus", "avg", "worst");
+        RunFocusWakes(true);
+        RunFocusWakes(false);
+    }
+
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+}
+
+int main(int argc, char** argv) {
+    const Benchmark benchmarks[] = {
+        { "pacing", BenchPacing },
+        { "uneven", BenchUneven },
+        { "background", BenchBackground },
+        { "states", BenchStates },
+    };
+
+    std::printf("Times in milliseconds, cpu is the main thread's CPU time over wall time, %u hardware threads\n\n",
+        std::thread::hardware_concurrency());
+    for (const Benchmark& benchmark : benchmarks) {
+        if (argc < 2 || std::strcmp(argv[1], benchmark.name) == 0) {
+            benchmark.run();
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
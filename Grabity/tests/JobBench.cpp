@@ -0,0 +1,188 @@
+/*!****************************************************************
+\file: JobBench.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Measures how the JobSystem scales from 1 to 16 threads. Each
+        benchmark is selected by name on the command line, e.g.
+        "JobBench scaling"; without an argument every benchmark runs.
+        A thread count is the main thread plus its workers, and one
+        thread means no workers, where jobs run inline.
+
+        Speed-up only means something up to the number of cores the
+        machine has. Rows past it are marked, since they measure the
+        cost of oversubscription instead.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    const unsigned int threadCounts[] = { 1, 2, 4, 6, 8, 12, 16 };
+    constexpr int repeats = 5;
+
+    /**
+     * \brief Times a function a few times after a warm-up run.
+     * \param run The function to time.
+     * \return The median time in milliseconds.
+     */
+    double MedianMilliseconds(const std::function<void()>& run) {
+        run();
+        std::vector<double> times;
+        for (int repeat = 0; repeat < repeats; ++repeat) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    /**
+     * \brief Runs a workload at every thread count and prints its time and speed-up over one thread.
+     * \param title Printed above the table.
+     * \param workload The work of one timed run, using JobSystem::GetInstance().
+     */
+    void PrintScaling(const char* title, const std::function<void()>& workload) {
+        const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        std::printf("%s\n", title);
+        std::printf("  %7s %10s %9s %11s %8s\n", "threads", "ms", "speed-up", "efficiency", "steals");
+        double single = 0.0;
+        for (unsigned int threads : threadCounts) {
+            JobSystem& jobs = JobSystem::GetInstance();
+            if (threads > 1) {
+                jobs.Init(threads - 1);
+            }
+            jobs.ResetStats();
+            const double milliseconds = MedianMilliseconds(workload);
+            const uint64_t steals = jobs.GetStats().steals / (repeats + 1);
+            jobs.Shutdown();
+
+            if (threads == 1) {
+                single = milliseconds;
+            }
+            const double speedUp = single / milliseconds;
+            std::printf("  %7u %10.2f %8.2fx %10.0f%% %8llu%s\n", threads, milliseconds, speedUp, 100.0 * speedUp / threads,
+                static_cast<unsigned long long>(steals), threads > cores ? "  (more threads than cores)" : "");
+        }
+    }
+
+    // Work with no memory traffic, so only the cores limit it
+    double Spin(size_t index, int iterations) {
+        double value = static_cast<double>(index);
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            value = std::sin(value) * 0.5 + 1.0;
+        }
+        return value;
+    }
+
+    /**
+     * \brief A ParallelFor over particles, like ParticleSystem updates: light work on
+     *        a lot of memory.
+     */
+    void BenchParticles() {
+        struct Particle {
+            float x, y, velocityX, velocityY, life;
+        };
+        std::vector<Particle> particles(1 << 20, Particle{ 0.0f, 0.0f, 1.0f, 2.0f, 5.0f });
+        PrintScaling("ParallelFor, 1M particles, grain 4096", [&]() {
+            JobSystem::GetInstance().ParallelFor(0, particles.size(), 4096, [&](size_t first, size_t last) {
+                for (size_t index = first; index < last; ++index) {
+                    Particle& particle = particles[index];
+                    particle.velocityY -= 9.8f * 0.016f;
+                    particle.x += particle.velocityX * 0.016f;
+                    particle.y += particle.velocityY * 0.016f;
+                    particle.life -= 0.016f;
+                }
+            });
+        });
+    }
+
+    /**
+     * \brief A ParallelFor of compute-bound chunks, the best case for scaling.
+     */
+    void BenchCompute() {
+        std::vector<double> results(4096);
+        PrintScaling("ParallelFor, 4096 compute-bound items, default grain", [&]() {
+            JobSystem::GetInstance().ParallelFor(0, results.size(), 0, [&](size_t first, size_t last) {
+                for (size_t index = first; index < last; ++index) {
+                    results[index] = Spin(index, 2000);
+                }
+            });
+        });
+    }
+
+    /**
+     * \brief Independent jobs of uneven length, which only balance out through stealing.
+     */
+    void BenchUneven() {
+        std::vector<double> results(512);
+        PrintScaling("512 jobs of 1x to 8x length, queued from the main thread", [&]() {
+            JobSystem& jobs = JobSystem::GetInstance();
+            JobSystem::Counter counter;
+            for (size_t index = 0; index < results.size(); ++index) {
+                jobs.Run([&results, index]() { results[index] = Spin(index, 1000 * static_cast<int>(1 + index % 8)); }, &counter);
+            }
+            jobs.Wait(counter);
+        });
+    }
+
+    /**
+     * \brief Empty jobs, which leave only the cost of queueing, taking and counting one.
+     */
+    void BenchOverhead() {
+        constexpr int jobCount = 100000;
+        const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        std::printf("Overhead, %d empty jobs\n", jobCount);
+        std::printf("  %7s %12s\n", "threads", "us per job");
+        for (unsigned int threads : threadCounts) {
+            JobSystem& jobs = JobSystem::GetInstance();
+            if (threads > 1) {
+                jobs.Init(threads - 1);
+            }
+            const double milliseconds = MedianMilliseconds([&]() {
+                JobSystem::Counter counter;
+                for (int index = 0; index < jobCount; ++index) {
+                    jobs.Run([]() {}, &counter);
+                }
+                jobs.Wait(counter);
+            });
+            jobs.Shutdown();
+            std::printf("  %7u %12.3f%s\n", threads, milliseconds * 1000.0 / jobCount,
+                threads > cores ? "  (more threads than cores)" : "");
+        }
+    }
+
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+}
+
+int main(int argc, char** argv) {
+    const Benchmark benchmarks[] = {
+        { "overhead", BenchOverhead },
+        { "scaling", BenchCompute },
+        { "uneven", BenchUneven },
+        { "particles", BenchParticles },
+    };
+
+    std::printf("%u hardware threads\n\n", std::thread::hardware_concurrency());
+    for (const Benchmark& benchmark : benchmarks) {
+        if (argc < 2 || std::strcmp(argv[1], benchmark.name) == 0) {
+            benchmark.run();
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,295 @@
+/*!****************************************************************
+\file: JobSystemTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Stress and correctness tests for the JobSystem: every job
+        runs exactly once whatever the worker count, nested jobs,
+        dependency chains that alternate worker and main-thread jobs,
+        fan-in, ParallelFor over many grain sizes, failing jobs and
+        repeated start and stop. Build with -fsanitize=thread to have
+        the same runs checked for data races.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Includes no workers, where jobs run inline, and more workers than the machine has cores
+    const unsigned int workerCounts[] = { 0, 1, 3, 7 };
+
+    /**
+     * \brief Starts the job system for a test and stops it again, even if a check fails.
+     *        With no workers it is left stopped, which Init cannot do.
+     */
+    struct JobSystemScope {
+        explicit JobSystemScope(unsigned int workerCount) {
+            if (workerCount > 0) {
+                JobSystem::GetInstance().Init(workerCount);
+            }
+            JobSystem::GetInstance().ResetStats();
+        }
+        ~JobSystemScope() { JobSystem::GetInstance().Shutdown(); }
+    };
+
+    /**
+     * \brief Queues a job that queues its children until a depth is reached.
+     * \param depth Levels left below this job.
+     * \param fanOut Children per job.
+     * \param counter Counts every job of the tree.
+     * \param runs Counts the jobs that ran.
+     */
+    void SpawnTree(int depth, int fanOut, JobSystem::Counter& counter, std::atomic<int>& runs) {
+        JobSystem::GetInstance().Run([depth, fanOut, &counter, &runs]() {
+            ++runs;
+            if (depth > 0) {
+                for (int child = 0; child < fanOut; ++child) {
+                    SpawnTree(depth - 1, fanOut, counter, runs);
+                }
+            }
+        }, &counter, JobSystem::Affinity::ANY_THREAD, "Tree");
+    }
+}
+
+TEST_CASE(JobSystem_RunsEveryJobExactlyOnce) {
+    constexpr int jobCount = 20000;
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        JobSystem& jobs = JobSystem::GetInstance();
+        CHECK_EQ(jobs.GetWorkerCount(), workerCount);
+
+        std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[jobCount]);
+        for (int index = 0; index < jobCount; ++index) {
+            runs[index] = 0;
+        }
+        JobSystem::Counter counter;
+        for (int index = 0; index < jobCount; ++index) {
+            jobs.Run([&runs, index]() { ++runs[index]; }, &counter);
+        }
+        jobs.Wait(counter);
+
+        CHECK(counter.IsDone());
+        int wrong = 0;
+        for (int index = 0; index < jobCount; ++index) {
+            wrong += runs[index] != 1;
+        }
+        CHECK_EQ(wrong, 0);
+        CHECK_EQ(jobs.GetStats().jobs, uint64_t(jobCount));
+    }
+}
+
+TEST_CASE(JobSystem_NestedJobsAreWaitedFor) {
+    // 1 + 4 + 16 + 64 + 256 + 1024 jobs, each queued by its parent while it runs
+    constexpr int expected = 1365;
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        JobSystem::Counter counter;
+        std::atomic<int> runs{ 0 };
+        SpawnTree(5, 4, counter, runs);
+        JobSystem::GetInstance().Wait(counter);
+        CHECK_EQ(runs.load(), expected);
+        CHECK_EQ(counter.GetPending(), 0);
+    }
+}
+
+TEST_CASE(JobSystem_ChainAlternatesWorkerAndMainThreadJobs) {
+    constexpr int links = 200;
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        JobSystem& jobs = JobSystem::GetInstance();
+
+        // Each link waits on the counter of the one before, so they run one after another
+        std::vector<std::unique_ptr<JobSystem::Counter>> counters;
+        std::vector<int> order;
+        std::atomic<int> wrongThread{ 0 };
+        for (int link = 0; link < links; ++link) {
+            counters.push_back(std::make_unique<JobSystem::Counter>());
+            const JobSystem::Affinity affinity = link % 2 ? JobSystem::Affinity::MAIN_THREAD : JobSystem::Affinity::ANY_THREAD;
+            auto work = [&order, &wrongThread, &jobs, link, affinity]() {
+                if (affinity == JobSystem::Affinity::MAIN_THREAD && !jobs.IsMainThread()) {
+                    ++wrongThread;
+                }
+                order.push_back(link);
+            };
+            if (link == 0) {
+                jobs.Run(work, counters[link].get(), affinity, "Link");
+            }
+            else {
+                jobs.RunAfter(*counters[link - 1], work, counters[link].get(), affinity, "Link");
+            }
+        }
+        jobs.Wait(*counters.back());
+
+        CHECK_EQ(wrongThread.load(), 0);
+        CHECK_EQ(order.size(), size_t(links));
+        bool inOrder = true;
+        for (int link = 0; link < static_cast<int>(order.size()); ++link) {
+            inOrder = inOrder && order[link] == link;
+        }
+        CHECK(inOrder);
+        CHECK_EQ(jobs.GetStats().mainThreadJobs, uint64_t(links / 2));
+    }
+}
+
+TEST_CASE(JobSystem_FanInRunsAfterEveryDependency) {
+    constexpr int producers = 64;
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        JobSystem& jobs = JobSystem::GetInstance();
+
+        JobSystem::Counter produced;
+        JobSystem::Counter consumed;
+        std::vector<int> values(producers, 0);
+        int sum = -1;
+        int finishedWhenConsumed = -1;
+        std::atomic<int> finished{ 0 };
+        for (int index = 0; index < producers; ++index) {
+            jobs.Run([&values, &finished, index]() {
+                values[index] = index + 1;
+                ++finished;
+            }, &produced);
+        }
+        jobs.RunAfter(produced, [&]() {
+            finishedWhenConsumed = finished.load();
+            sum = 0;
+            for (int value : values) {
+                sum += value;
+            }
+        }, &consumed);
+        jobs.Wait(consumed);
+
+        CHECK_EQ(finishedWhenConsumed, producers);
+        CHECK_EQ(sum, producers * (producers + 1) / 2);
+    }
+}
+
+TEST_CASE(JobSystem_ParallelForCoversEveryIndexOnce) {
+    constexpr size_t count = 10007;     // Prime, so no grain divides it
+    const size_t grains[] = { 0, 1, 7, 64, 1000, count, count * 2 };
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        for (size_t grain : grains) {
+            std::vector<std::atomic<int>> hits(count);
+            std::atomic<int> oversized{ 0 };
+            JobSystem::GetInstance().ParallelFor(0, count, grain, [&](size_t first, size_t last) {
+                if (grain > 0 && last - first > grain) {
+                    ++oversized;
+                }
+                for (size_t index = first; index < last; ++index) {
+                    ++hits[index];
+                }
+            });
+            int wrong = 0;
+            for (const std::atomic<int>& hit : hits) {
+                wrong += hit != 1;
+            }
+            CHECK_EQ(wrong, 0);
+            CHECK_EQ(oversized.load(), 0);
+        }
+
+        // Empty ranges call nothing
+        bool called = false;
+        JobSystem::GetInstance().ParallelFor(5, 5, 1, [&](size_t, size_t) { called = true; });
+        CHECK(!called);
+    }
+}
+
+TEST_CASE(JobSystem_NestedParallelForDoesNotDeadlock) {
+    constexpr size_t rows = 64;
+    constexpr size_t columns = 257;
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        JobSystem& jobs = JobSystem::GetInstance();
+        std::vector<std::atomic<int>> cells(rows * columns);
+        jobs.ParallelFor(0, rows, 4, [&](size_t firstRow, size_t lastRow) {
+            for (size_t row = firstRow; row < lastRow; ++row) {
+                jobs.ParallelFor(0, columns, 16, [&, row](size_t first, size_t last) {
+                    for (size_t column = first; column < last; ++column) {
+                        ++cells[row * columns + column];
+                    }
+                });
+            }
+        });
+        int wrong = 0;
+        for (const std::atomic<int>& cell : cells) {
+            wrong += cell != 1;
+        }
+        CHECK_EQ(wrong, 0);
+    }
+}
+
+TEST_CASE(JobSystem_FailingJobStillCountsDown) {
+    for (unsigned int workerCount : workerCounts) {
+        JobSystemScope scope(workerCount);
+        JobSystem& jobs = JobSystem::GetInstance();
+        JobSystem::Counter counter;
+        std::atomic<int> runs{ 0 };
+        for (int index = 0; index < 100; ++index) {
+            jobs.Run([&runs, index]() {
+                ++runs;
+                if (index % 10 == 0) {
+                    throw std::runtime_error("test failure");
+                }
+            }, &counter, JobSystem::Affinity::ANY_THREAD, "Failing");
+        }
+        jobs.Wait(counter);
+        CHECK_EQ(runs.load(), 100);
+
+        // The workers survive and keep running jobs
+        std::atomic<int> afterRuns{ 0 };
+        jobs.ParallelFor(0, 1000, 10, [&](size_t first, size_t last) { afterRuns += static_cast<int>(last - first); });
+        CHECK_EQ(afterRuns.load(), 1000);
+    }
+}
+
+TEST_CASE(JobSystem_RestartsCleanly) {
+    for (int round = 0; round < 20; ++round) {
+        for (unsigned int workerCount = 1; workerCount <= 7; ++workerCount) {
+            JobSystemScope scope(workerCount);
+            JobSystem& jobs = JobSystem::GetInstance();
+            CHECK_EQ(jobs.GetWorkerCount(), workerCount);
+            JobSystem::Counter counter;
+            std::atomic<int> runs{ 0 };
+            for (int index = 0; index < 50; ++index) {
+                jobs.Run([&runs]() { ++runs; }, &counter);
+            }
+            jobs.Wait(counter);
+            CHECK_EQ(runs.load(), 50);
+        }
+    }
+    CHECK_EQ(JobSystem::GetInstance().GetWorkerCount(), 0u);
+}
+
+TEST_CASE(JobSystem_ProfilerHookSeesEveryJob) {
+    JobSystemScope scope(3);
+    JobSystem& jobs = JobSystem::GetInstance();
+    std::mutex timingsMutex;
+    std::vector<JobSystem::JobTiming> timings;
+    jobs.SetProfilerHook([&](const JobSystem::JobTiming& timing) {
+        std::lock_guard<std::mutex> lock(timingsMutex);
+        timings.push_back(timing);
+    });
+
+    JobSystem::Counter counter;
+    for (int index = 0; index < 40; ++index) {
+        jobs.Run([]() {}, &counter, index % 4 ? JobSystem::Affinity::ANY_THREAD : JobSystem::Affinity::MAIN_THREAD, "Profiled");
+    }
+    jobs.Wait(counter);
+    jobs.SetProfilerHook(nullptr);
+
+    CHECK_EQ(timings.size(), size_t(40));
+    int wrong = 0;
+    for (const JobSystem::JobTiming& timing : timings) {
+        wrong += std::string(timing.name) != "Profiled" || timing.thread < 0 || timing.thread > 3 || timing.end < timing.start;
+    }
+    CHECK_EQ(wrong, 0);
+}
@@ -0,0 +1,66 @@
+/*!****************************************************************
+\file: LuaBytecodeCacheTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for LuaBytecodeCache: the second run of a file loads the
+        .luac written by the first and gives the same values, and an
+        edited source is compiled again instead of running stale code.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+#include "LuaBytecodeCache.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+    float ReadScaleY(const std::string& path, bool& fromBytecode) {
+        std::shared_ptr<sol::state> lua = LuaStateCache::CreateState();
+        if (!LuaBytecodeCache::RunFile(*lua, path)) {
+            return -1.0f;
+        }
+        fromBytecode = LuaBytecodeCache::GetLastLoadStats().fromBytecode;
+        return (*lua)[SceneFixtures::GetObjectTableName(0)]["Transform"]["scaleY"].get_or(-1.0f);
+    }
+}
+
+TEST_CASE(LuaBytecodeCache_SecondRunLoadsTheBytecode) {
+    const std::string path = SceneFixtures::MakeTempDirectory("BytecodeReuse") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 8);
+    std::error_code error;
+    std::filesystem::remove(LuaBytecodeCache::GetBytecodePath(path), error);
+
+    bool fromBytecode = true;
+    CHECK_EQ(ReadScaleY(path, fromBytecode), 1.25f);
+    CHECK(!fromBytecode);
+    CHECK(std::filesystem::exists(LuaBytecodeCache::GetBytecodePath(path)));
+
+    CHECK_EQ(ReadScaleY(path, fromBytecode), 1.25f);
+    CHECK(fromBytecode);
+}
+
+TEST_CASE(LuaBytecodeCache_EditedSourceIsCompiledAgain) {
+    const std::string path = SceneFixtures::MakeTempDirectory("BytecodeStale") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 8);
+    bool fromBytecode = false;
+    ReadScaleY(path, fromBytecode);
+    ReadScaleY(path, fromBytecode);
+    CHECK(fromBytecode);
+
+    // Same size and possibly the same timestamp, only the hash tells the files apart
+    std::ifstream in(path, std::ios::binary);
+    std::string source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    const size_t at = source.find("scaleY = 1.25");
+    CHECK(at != std::string::npos);
+    source.replace(at, 13, "scaleY = 4.75");
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << source;
+
+    CHECK_EQ(ReadScaleY(path, fromBytecode), 4.75f);
+    CHECK(!fromBytecode);
+}
@@ -0,0 +1,56 @@
+/*!****************************************************************
+\file: LuaSceneContextTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for LuaSceneContext: a scene is executed once per load
+        however many LuaManagers read it, and the sub-table index
+        answers the same as probing the Lua state.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+#include <algorithm>
+
+TEST_CASE(LuaSceneContext_ExecutesTheSceneOnce) {
+    const std::string path = SceneFixtures::MakeTempDirectory("ContextOnce") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 40);
+    LuaStateCache::GetInstance().Clear();
+
+    const unsigned long long statesBefore = LuaStateCache::GetStatesCreated();
+    {
+        LuaSceneContext context(path);
+        for (int id = 0; id < 40; ++id) {
+            const std::string tableName = SceneFixtures::GetObjectTableName(id);
+            for (const std::string& subTable : context.GetTableNames(tableName)) {
+                LuaManager luaManager(path);
+                CHECK(luaManager.TableExists(tableName, subTable));
+            }
+            LuaManager luaManager(path);
+            CHECK_EQ(luaManager.LuaReadFromTransform<float>(tableName, "scaleY"), 1.25f);
+        }
+    }
+    CHECK_EQ(LuaStateCache::GetStatesCreated() - statesBefore, 1ull);
+}
+
+TEST_CASE(LuaSceneContext_IndexMatchesTheLuaState) {
+    const std::string path = SceneFixtures::MakeTempDirectory("ContextIndex") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 12);
+    const SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+
+    LuaSceneContext context(path);
+    for (const auto& [objectName, subTables] : dump) {
+        std::vector<std::string> names = context.GetTableNames(objectName);
+        std::sort(names.begin(), names.end());
+        std::vector<std::string> expected;
+        for (const auto& [subTable, fields] : subTables) {
+            expected.push_back(subTable);
+        }
+        CHECK(names == expected);
+        CHECK(!context.HasTable(objectName, "NoSuchComponent"));
+    }
+    CHECK(context.GetTableNames("NoSuchObject_99").empty());
+}
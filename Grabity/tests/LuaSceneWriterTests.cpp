@@ -0,0 +1,150 @@
+/*!****************************************************************
+\file: LuaSceneWriterTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for LuaSceneWriter: a scene saved in one streaming pass
+        loads back to the same objects and values as the same scene
+        saved through the per-call LuaManager::LuaWrite path.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+#include <filesystem>
+
+TEST_CASE(LuaSceneWriter_ReloadsLikeTheLuaWritePath) {
+    const std::string directory = SceneFixtures::MakeTempDirectory("WriterRoundTrip");
+    const std::string writerPath = directory + "Writer.lua";
+    const std::string luaWritePath = directory + "LuaWrite.lua";
+    SceneFixtures::WriteScene(writerPath, 30);
+    SceneFixtures::WriteSceneWithoutWriter(luaWritePath, 30);
+
+    const SceneFixtures::SceneDump written = SceneFixtures::DumpScene(writerPath);
+    const SceneFixtures::SceneDump expected = SceneFixtures::DumpScene(luaWritePath);
+    CHECK_EQ(written.size(), size_t(30));
+    CHECK(written == expected);
+}
+
+TEST_CASE(LuaSceneWriter_LaterWritesUpdateEarlierOnes) {
+    const std::string path = SceneFixtures::MakeTempDirectory("WriterUpdate") + "Scene.lua";
+    {
+        LuaSceneWriter sceneWriter(path);
+        LuaManager first(path);
+        first.LuaWrite("Box_1", { 1.0f, 2.0f }, { "positionX", "positionY" }, "Transform");
+        LuaManager second(path);
+        second.LuaWrite("Box_1", { 5.5f, std::string("extra") }, { "positionY", "note" }, "Transform");
+        CHECK(sceneWriter.Commit());
+        CHECK_EQ(sceneWriter.GetTablesWritten(), size_t(1));
+    }
+
+    SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+    CHECK_EQ(dump["Box_1"]["Transform"]["positionX"], std::string("1"));
+    CHECK_EQ(dump["Box_1"]["Transform"]["positionY"], std::string("5.5"));
+    CHECK_EQ(dump["Box_1"]["Transform"]["note"], std::string("\"extra\""));
+
+    // The file the writer leaves is still editable by LuaWrite
+    LuaManager editor(path);
+    editor.LuaWrite("Box_1", { 9.0f }, { "positionX" }, "Transform");
+    dump = SceneFixtures::DumpScene(path);
+    CHECK_EQ(dump["Box_1"]["Transform"]["positionX"], std::string("9"));
+    CHECK_EQ(dump["Box_1"]["Transform"]["positionY"], std::string("5.5"));
+}
+
+TEST_CASE(LuaSceneWriter_UncommittedWriterLeavesTheFile) {
+    const std::string path = SceneFixtures::MakeTempDirectory("WriterDiscard") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 3);
+    const SceneFixtures::SceneDump before = SceneFixtures::DumpScene(path);
+    {
+        LuaSceneWriter sceneWriter(path);
+        SceneFixtures::WriteObject(path, 0, 7);
+    }
+    CHECK(SceneFixtures::DumpScene(path) == before);
+    CHECK(!std::filesystem::exists(path + ".tmp"));
+}
+
+TEST_CASE(LuaSceneWriter_LuaWriteEditsOnlyItsOwnTable) {
+    const std::string path = SceneFixtures::MakeTempDirectory("WriterLuaWriteTarget") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 12);
+    SceneFixtures::SceneDump expected = SceneFixtures::DumpScene(path);
+
+    // Every later object has a Transform table too; the edit must land in Enemy_1's
+    LuaManager editor(path);
+    editor.LuaWrite(SceneFixtures::GetObjectTableName(1), { 4.5f }, { "scaleY" }, "Transform");
+    expected[SceneFixtures::GetObjectTableName(1)]["Transform"]["scaleY"] = "4.5";
+    CHECK(SceneFixtures::DumpScene(path) == expected);
+}
+
+TEST_CASE(LuaSceneWriter_EditsBetweenJournalSavesAreKept) {
+    const std::string directory = SceneFixtures::MakeTempDirectory("WriterJournalEdit");
+    const std::string path = directory + "Scene.lua";
+    const std::string referencePath = directory + "Reference.lua";
+    const int objectCount = 20;
+    const std::string edited = SceneFixtures::GetObjectTableName(5);
+
+    // Writes a full save of the scene with the given variants, like a fresh load of the saved scene
+    auto saveReference = [&](int changedID) {
+        LuaSceneWriter sceneWriter(referencePath);
+        for (int id = 0; id < objectCount; ++id) {
+            SceneFixtures::WriteObject(referencePath, id, id == changedID ? 1 : 0);
+        }
+        sceneWriter.Commit();
+    };
+
+    // Save, then save one changed object as a journal
+    SceneFixtures::WriteScene(path, objectCount);
+    {
+        LuaSceneWriter sceneWriter(path);
+        for (int id = 0; id < objectCount; ++id) {
+            SceneFixtures::WriteObject(path, id, id == 5 ? 1 : 0);
+        }
+        CHECK(sceneWriter.CommitChanges());
+        CHECK_EQ(sceneWriter.GetTablesWritten(), size_t(1));
+    }
+
+    // Edit the object the journal redefined, as the editor's single-value writes do
+    LuaManager(path).LuaWrite(edited, { 123.0f }, { "positionX" }, "Transform");
+    LuaManager(path).LuaWrite(edited, { std::string("Edited") }, { "note" }, "Name");
+    saveReference(5);
+    LuaManager(referencePath).LuaWrite(edited, { 123.0f }, { "positionX" }, "Transform");
+    LuaManager(referencePath).LuaWrite(edited, { std::string("Edited") }, { "note" }, "Name");
+    SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+    CHECK_EQ(dump[edited]["Transform"]["positionX"], std::string("123"));
+    CHECK_EQ(dump[edited]["Name"]["note"], std::string("\"Edited\""));
+    CHECK(dump == SceneFixtures::DumpScene(referencePath));
+
+    // Save again: the edit changed the file, so this is a full save, then reload
+    {
+        LuaSceneWriter sceneWriter(path);
+        for (int id = 0; id < objectCount; ++id) {
+            SceneFixtures::WriteObject(path, id, id == 7 ? 1 : 0);
+        }
+        CHECK(sceneWriter.CommitChanges());
+        CHECK_EQ(sceneWriter.GetTablesWritten(), size_t(objectCount));
+    }
+    saveReference(7);
+    CHECK(SceneFixtures::DumpScene(path) == SceneFixtures::DumpScene(referencePath));
+}
+
+TEST_CASE(LuaSceneWriter_LuaWriteRecreatesATableTheJournalRemoved) {
+    const std::string path = SceneFixtures::MakeTempDirectory("WriterJournalRemoved") + "Scene.lua";
+    const std::string removed = SceneFixtures::GetObjectTableName(3);
+    SceneFixtures::WriteScene(path, 8);
+    {
+        LuaSceneWriter sceneWriter(path);
+        for (int id = 0; id < 8; ++id) {
+            if (id != 3) {
+                SceneFixtures::WriteObject(path, id);
+            }
+        }
+        CHECK(sceneWriter.CommitChanges());
+    }
+    CHECK_EQ(SceneFixtures::DumpScene(path).count(removed), size_t(0));
+
+    LuaManager(path).LuaWrite(removed, { 2.0f }, { "positionX" }, "Transform");
+    SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+    CHECK_EQ(dump[removed].size(), size_t(1));
+    CHECK_EQ(dump[removed]["Transform"]["positionX"], std::string("2"));
+}
@@ -0,0 +1,57 @@
+/*!****************************************************************
+\file: LuaStateCacheTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for LuaStateCache: repeated LuaManagers on an unchanged
+        file share one executed state and count as hits, and writing
+        the file makes the next LuaManager execute it again.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+
+TEST_CASE(LuaStateCache_RepeatedOpensHitTheCache) {
+    const std::string path = SceneFixtures::MakeTempDirectory("StateCacheHits") + "Config.lua";
+    SceneFixtures::WriteScene(path, 4);
+    LuaStateCache::GetInstance().Clear();
+
+    const unsigned long long hitsBefore = LuaStateCache::GetCacheHits();
+    const unsigned long long missesBefore = LuaStateCache::GetCacheMisses();
+    const unsigned long long statesBefore = LuaStateCache::GetStatesCreated();
+    for (int open = 0; open < 50; ++open) {
+        LuaManager luaManager(path);
+        CHECK_EQ(luaManager.LuaReadFromTransform<float>(SceneFixtures::GetObjectTableName(0), "scaleY"), 1.25f);
+    }
+    CHECK_EQ(LuaStateCache::GetCacheMisses() - missesBefore, 1ull);
+    CHECK_EQ(LuaStateCache::GetCacheHits() - hitsBefore, 49ull);
+    CHECK_EQ(LuaStateCache::GetStatesCreated() - statesBefore, 1ull);
+}
+
+TEST_CASE(LuaStateCache_WritingTheFileMissesOnce) {
+    const std::string path = SceneFixtures::MakeTempDirectory("StateCacheWrite") + "Config.lua";
+    SceneFixtures::WriteScene(path, 4);
+    const std::string tableName = SceneFixtures::GetObjectTableName(3);
+    LuaStateCache::GetInstance().Clear();
+    {
+        LuaManager luaManager(path);
+        (void)luaManager.LuaReadFromTransform<float>(tableName, "scaleY");
+    }
+
+    // LuaWrite goes through writeFile, which invalidates the cached state
+    {
+        LuaManager editor(path);
+        editor.LuaWrite(tableName, { 3.5f }, { "scaleY" }, "Transform");
+    }
+    const unsigned long long missesBefore = LuaStateCache::GetCacheMisses();
+    const unsigned long long hitsBefore = LuaStateCache::GetCacheHits();
+    for (int open = 0; open < 3; ++open) {
+        LuaManager luaManager(path);
+        CHECK_EQ(luaManager.LuaReadFromTransform<float>(tableName, "scaleY"), 3.5f);
+    }
+    CHECK_EQ(LuaStateCache::GetCacheMisses() - missesBefore, 1ull);
+    CHECK_EQ(LuaStateCache::GetCacheHits() - hitsBefore, 2ull);
+}
@@ -0,0 +1,144 @@
+/*!****************************************************************
+\file: NumberFormatTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Bit-exact round trip of the numbers LuaManager writes. Values
+        are saved through LuaSceneWriter, executed by Lua and read back
+        through LuaManager, the same path a scene save and load takes,
+        and must come back with the same bits.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+namespace {
+
+    template<typename T>
+    auto GetBits(T value) {
+        std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t> bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        return bits;
+    }
+
+    /**
+     * \brief Saves values, loads them back and counts those that changed bits.
+     * \param values The values to round trip.
+     * \param name Names the scene file.
+     * \return The number of values that came back different. NaN only has to stay NaN.
+     */
+    template<typename T>
+    size_t CountRoundTripMismatches(const std::vector<T>& values, const std::string& name) {
+        const std::string path = SceneFixtures::MakeTempDirectory("NumberFormat" + name) + "Numbers.lua";
+        constexpr size_t valuesPerTable = 1000;
+        {
+            LuaSceneWriter sceneWriter(path);
+            LuaManager luaManager(path);
+            for (size_t first = 0; first < values.size(); first += valuesPerTable) {
+                LuaManager::LuaValueContainer container;
+                std::vector<std::string> keys;
+                for (size_t index = first; index < values.size() && index < first + valuesPerTable; ++index) {
+                    container.push_back(values[index]);
+                    keys.push_back("v" + std::to_string(index));
+                }
+                luaManager.LuaWrite("Numbers_" + std::to_string(first / valuesPerTable), container, keys, "Values");
+            }
+            sceneWriter.Commit();
+        }
+
+        LuaStateCache::GetInstance().Clear();
+        LuaSceneContext context(path);
+        LuaManager luaManager(path);
+        size_t mismatches = 0;
+        for (size_t index = 0; index < values.size(); ++index) {
+            const T loaded = luaManager.LuaRead<T>("Numbers_" + std::to_string(index / valuesPerTable), { "Values", "v" + std::to_string(index) });
+            const bool same = std::isnan(values[index]) ? std::isnan(loaded) : GetBits(loaded) == GetBits(values[index]);
+            if (!same) {
+                if (mismatches < 5) {
+                    std::printf("    %s %.9g (0x%llx) read back as %.9g\n", name.c_str(), static_cast<double>(values[index]),
+                        static_cast<unsigned long long>(GetBits(values[index])), static_cast<double>(loaded));
+                }
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    template<typename T>
+    std::vector<T> GetSpecialValues() {
+        using Limits = std::numeric_limits<T>;
+        std::vector<T> values = {
+            T(0), -T(0), T(1), T(-1), T(0.1), T(1) / T(3), T(100.25), T(-2.5),
+            Limits::min(), -Limits::min(), Limits::max(), Limits::lowest(),
+            Limits::denorm_min(), -Limits::denorm_min(), Limits::min() / T(3), Limits::min() - Limits::denorm_min(),
+            Limits::epsilon(), T(1) + Limits::epsilon(), T(1) - Limits::epsilon() / T(2),
+            Limits::infinity(), -Limits::infinity(), Limits::quiet_NaN(),
+            T(16777216), T(16777217), T(9007199254740992.0), T(1e-30), T(3.4e38), T(123456.789)
+        };
+        // Every power of two covers each exponent once
+        for (int exponent = Limits::min_exponent - Limits::digits; exponent < Limits::max_exponent; ++exponent) {
+            values.push_back(std::ldexp(T(1), exponent));
+            values.push_back(std::nextafter(std::ldexp(T(1), exponent), T(0)));
+        }
+        return values;
+    }
+}
+
+TEST_CASE(NumberFormat_FloatSpecialValuesRoundTrip) {
+    CHECK_EQ(CountRoundTripMismatches(GetSpecialValues<float>(), "FloatSpecial"), size_t(0));
+}
+
+TEST_CASE(NumberFormat_DoubleSpecialValuesRoundTrip) {
+    CHECK_EQ(CountRoundTripMismatches(GetSpecialValues<double>(), "DoubleSpecial"), size_t(0));
+}
+
+TEST_CASE(NumberFormat_RandomFloatBitsRoundTrip) {
+    std::mt19937 random(20241017);
+    std::vector<float> values;
+    while (values.size() < 50000) {
+        const uint32_t bits = static_cast<uint32_t>(random());
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isnan(value)) {
+            values.push_back(value);
+        }
+    }
+    CHECK_EQ(CountRoundTripMismatches(values, "FloatRandom"), size_t(0));
+}
+
+TEST_CASE(NumberFormat_RandomDoubleBitsRoundTrip) {
+    std::mt19937_64 random(20241017);
+    std::vector<double> values;
+    while (values.size() < 50000) {
+        const uint64_t bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isnan(value)) {
+            values.push_back(value);
+        }
+    }
+    CHECK_EQ(CountRoundTripMismatches(values, "DoubleRandom"), size_t(0));
+}
+
+TEST_CASE(NumberFormat_Fixed2KeepsTheOldOutput) {
+    const std::string path = SceneFixtures::MakeTempDirectory("NumberFormatFixed") + "Numbers.lua";
+    LuaManager::SetNumberFormat(LuaManager::NumberFormat::FIXED_2);
+    {
+        LuaSceneWriter sceneWriter(path);
+        LuaManager luaManager(path);
+        luaManager.LuaWrite("Numbers_0", { 1.0f / 3.0f, 2.5 }, { "third", "half" }, "Values");
+        sceneWriter.Commit();
+    }
+    LuaManager::SetNumberFormat(LuaManager::NumberFormat::ROUND_TRIP);
+
+    SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+    CHECK_EQ(dump["Numbers_0"]["Values"]["third"], std::string("0.33000000000000002"));
+    CHECK_EQ(dump["Numbers_0"]["Values"]["half"], std::string("2.5"));
+}
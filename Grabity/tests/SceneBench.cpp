@@ -0,0 +1,548 @@
+/*!****************************************************************
+\file: SceneBench.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Times scene loading and saving on synthetic scenes. Each
+        benchmark is selected by name on the command line, e.g.
+        "SceneBench load"; without an argument every benchmark runs.
+        Scenes are written to the system temp directory.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+#include "LuaBytecodeCache.h"
+#include "ComponentRegistry.h"
+#include "VirtualFileSystem.h"
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const int sceneSizes[] = { 100, 1000, 5000 };
+
+    /**
+     * \brief Reads every value of a scene through LuaManager, one LuaManager per object
+     *        table like the component Deserialize functions open them.
+     * \param luaFilePath The scene file.
+     * \param dump The values to read, from SceneFixtures::DumpScene.
+     * \param clearCacheEachTime Drops the cached state before every LuaManager, which is
+     *        how LuaManager behaved before LuaSceneContext: one execution per instance.
+     */
+    void ReadScene(const std::string& luaFilePath, const SceneFixtures::SceneDump& dump, bool clearCacheEachTime) {
+        for (const auto& [objectName, subTables] : dump) {
+            for (const auto& [subTable, fields] : subTables) {
+                if (clearCacheEachTime) {
+                    LuaStateCache::GetInstance().Clear();
+                }
+                LuaManager luaManager(luaFilePath);
+                if (!luaManager.TableExists(objectName, subTable)) {
+                    continue;
+                }
+                for (const auto& [key, text] : fields) {
+                    if (text.front() == '"') {
+                        (void)luaManager.LuaRead<std::string>(objectName, { subTable, key });
+                    }
+                    else if (text == "true" || text == "false") {
+                        (void)luaManager.LuaRead<bool>(objectName, { subTable, key });
+                    }
+                    else {
+                        (void)luaManager.LuaRead<float>(objectName, { subTable, key });
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Scene load before and after LuaSceneContext: Lua executions and time per load.
+     */
+    void BenchLoad() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchLoad");
+        std::printf("load: reading every value of a scene, one LuaManager per object table\n");
+        std::printf("%8s %22s %22s\n", "objects", "per-LuaManager parse", "LuaSceneContext");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            SceneFixtures::WriteScene(path, objectCount);
+            const SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+
+            // The per-LuaManager path is quadratic, so it only runs once and not on the largest scene
+            double separateMs = 0.0;
+            unsigned long long separateParses = 0;
+            if (objectCount <= 1000) {
+                const int runs = objectCount >= 1000 ? 1 : 5;
+                const unsigned long long statesBefore = LuaStateCache::GetStatesCreated();
+                separateMs = SceneFixtures::TimeMilliseconds(runs, [&] { ReadScene(path, dump, true); });
+                separateParses = (LuaStateCache::GetStatesCreated() - statesBefore) / runs;
+            }
+
+            const unsigned long long statesBefore = LuaStateCache::GetStatesCreated();
+            const double contextMs = SceneFixtures::TimeMilliseconds(5, [&] {
+                LuaStateCache::GetInstance().Clear();
+                LuaSceneContext context(path);
+                ReadScene(path, dump, false);
+            });
+            const unsigned long long contextParses = (LuaStateCache::GetStatesCreated() - statesBefore) / 5;
+
+            if (objectCount <= 1000) {
+                std::printf("%8d %9llu parses %7.1f ms %9llu parses %7.1f ms\n", objectCount, separateParses, separateMs, contextParses, contextMs);
+            }
+            else {
+                std::printf("%8d %22s %9llu parses %7.1f ms\n", objectCount, "not run", contextParses, contextMs);
+            }
+        }
+    }
+
+    /**
+     * \brief Drops a file from the OS page cache so the next read comes from the disk.
+     * \param filePath The file to evict.
+     * \return True if the file was evicted, false where that is not supported.
+     */
+    bool EvictFromPageCache(const std::string& filePath) {
+#ifdef __linux__
+        int descriptor = open(filePath.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        fdatasync(descriptor);
+        const bool evicted = posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(descriptor);
+        return evicted;
+#else
+        (void)filePath;
+        return false;
+#endif
+    }
+
+    /**
+     * \brief Loads a scene through LuaSceneContext and reads every value, from a cold
+     *        or a warm page cache.
+     * \param path The scene file.
+     * \param dump The values to read.
+     * \param cold Evicts the scene, its bytecode and its cooked file before every load.
+     * \return The average time per load in milliseconds.
+     */
+    double TimeContextLoad(const std::string& path, const SceneFixtures::SceneDump& dump, bool cold) {
+        const int runs = 5;
+        double total = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            LuaStateCache::GetInstance().Clear();
+            if (cold) {
+                EvictFromPageCache(path);
+                EvictFromPageCache(LuaBytecodeCache::GetBytecodePath(path));
+                EvictFromPageCache(CookedScene::GetCookedPath(path));
+            }
+            total += SceneFixtures::TimeMilliseconds(1, [&] {
+                LuaSceneContext context(path);
+                ReadScene(path, dump, false);
+            });
+        }
+        return total / runs;
+    }
+
+    /**
+     * \brief Scene load from Lua against the memory-mapped cooked image, cold and warm.
+     */
+    void BenchCooked() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchCooked");
+        std::printf("cooked: LuaSceneContext load and read of every value, per load\n");
+        std::printf("%8s %12s %12s %12s %12s %12s\n", "objects", "lua cold", "lua warm", "cooked cold", "cooked warm", "cooked size");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            SceneFixtures::WriteScene(path, objectCount);
+            const SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+
+            std::error_code error;
+            std::filesystem::remove(CookedScene::GetCookedPath(path), error);
+            const double luaCold = TimeContextLoad(path, dump, true);
+            const double luaWarm = TimeContextLoad(path, dump, false);
+
+            CookedScene::Bake(path, CookedScene::GetCookedPath(path));
+            const double cookedCold = TimeContextLoad(path, dump, true);
+            const double cookedWarm = TimeContextLoad(path, dump, false);
+            const uintmax_t cookedBytes = std::filesystem::file_size(CookedScene::GetCookedPath(path), error);
+
+            std::printf("%8d %9.2f ms %9.2f ms %9.2f ms %9.2f ms %9.1f KB\n", objectCount, luaCold, luaWarm, cookedCold, cookedWarm, cookedBytes / 1024.0);
+        }
+    }
+
+    /**
+     * \brief Full scene save through LuaSceneWriter against one LuaWrite per table.
+     */
+    void BenchSave() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchSave");
+        std::printf("save: full save of a synthetic scene\n");
+        std::printf("%8s %16s %16s %12s\n", "objects", "LuaWrite path", "LuaSceneWriter", "file size");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            const double writerMs = SceneFixtures::TimeMilliseconds(3, [&] { SceneFixtures::WriteScene(path, objectCount); });
+            std::error_code error;
+            const uintmax_t bytes = std::filesystem::file_size(path, error);
+
+            // Every LuaWrite rewrites the whole file, so the old path is not run on the largest scene
+            if (objectCount <= 1000) {
+                const double luaWriteMs = SceneFixtures::TimeMilliseconds(1, [&] { SceneFixtures::WriteSceneWithoutWriter(path, objectCount); });
+                std::printf("%8d %13.1f ms %13.2f ms %9.1f KB\n", objectCount, luaWriteMs, writerMs, bytes / 1024.0);
+            }
+            else {
+                std::printf("%8d %16s %13.2f ms %9.1f KB\n", objectCount, "not run", writerMs, bytes / 1024.0);
+            }
+        }
+    }
+
+    /**
+     * \brief Saving a scene with one changed object: a full Commit against CommitChanges,
+     *        which appends the changed table as a journal, and a LuaWrite edit afterwards,
+     *        which has to find the journal's definition of the table.
+     */
+    void BenchJournal() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchJournal");
+        const int runs = 5;
+        std::printf("journal: saving a scene with one changed object, average of %d saves\n", runs);
+        std::printf("%8s %12s %12s %14s %14s %14s\n", "objects", "full save", "full bytes", "changes save", "changes bytes", "LuaWrite edit");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            int changes = 0;
+            size_t fullBytes = 0;
+            size_t journalBytes = 0;
+            auto save = [&](bool onlyChanges) {
+                // Each save moves a different object, like dragging one object between saves
+                ++changes;
+                LuaSceneWriter sceneWriter(path);
+                for (int id = 0; id < objectCount; ++id) {
+                    SceneFixtures::WriteObject(path, id, id == changes % objectCount ? changes : 0);
+                }
+                if (onlyChanges) {
+                    sceneWriter.CommitChanges();
+                    journalBytes = sceneWriter.GetBytesWritten();
+                }
+                else {
+                    sceneWriter.Commit();
+                    fullBytes = sceneWriter.GetBytesWritten();
+                }
+            };
+
+            const double fullMs = SceneFixtures::TimeMilliseconds(runs, [&] { save(false); });
+            save(false);
+            const double changesMs = SceneFixtures::TimeMilliseconds(runs, [&] { save(true); });
+            const std::string edited = SceneFixtures::GetObjectTableName(changes % objectCount);
+            const double editMs = SceneFixtures::TimeMilliseconds(1, [&] {
+                LuaManager(path).LuaWrite(edited, { 1.0f }, { "positionX" }, "Transform");
+            });
+
+            std::printf("%8d %9.2f ms %9.1f KB %11.2f ms %11.1f KB %11.2f ms\n", objectCount, fullMs, fullBytes / 1024.0,
+                changesMs, journalBytes / 1024.0, editMs);
+        }
+    }
+
+    /**
+     * \brief Gameplay-style config lookups: every frame opens a LuaManager on each of a
+     *        few small files and reads one value, with and without LuaStateCache.
+     */
+    void BenchStateCache() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchStateCache");
+        const int fileCount = 8;
+        const int frames = 600;
+        std::vector<std::string> paths;
+        for (int file = 0; file < fileCount; ++file) {
+            paths.push_back(directory + "Config" + std::to_string(file) + ".lua");
+            SceneFixtures::WriteScene(paths.back(), 4 + file * 4);
+        }
+        const std::string tableName = SceneFixtures::GetObjectTableName(0);
+        auto runFrames = [&](bool clearCacheEachTime) {
+            for (int frame = 0; frame < frames; ++frame) {
+                for (const std::string& path : paths) {
+                    if (clearCacheEachTime) {
+                        LuaStateCache::GetInstance().Clear();
+                    }
+                    LuaManager luaManager(path);
+                    (void)luaManager.LuaReadFromTransform<float>(tableName, "scaleY");
+                }
+            }
+        };
+
+        std::printf("cache: %d frames, %d LuaManager opens per frame on %d config files\n", frames, fileCount, fileCount);
+        std::printf("%10s %10s %10s %10s %12s %12s\n", "cache", "lookups", "hit rate", "states", "total", "per frame");
+        for (bool clearCacheEachTime : { true, false }) {
+            LuaStateCache::GetInstance().Clear();
+            const unsigned long long hitsBefore = LuaStateCache::GetCacheHits();
+            const unsigned long long missesBefore = LuaStateCache::GetCacheMisses();
+            const unsigned long long statesBefore = LuaStateCache::GetStatesCreated();
+            const double totalMs = SceneFixtures::TimeMilliseconds(1, [&] { runFrames(clearCacheEachTime); });
+            const unsigned long long hits = LuaStateCache::GetCacheHits() - hitsBefore;
+            const unsigned long long lookups = hits + LuaStateCache::GetCacheMisses() - missesBefore;
+            std::printf("%10s %10llu %9.1f%% %10llu %9.1f ms %9.3f ms\n", clearCacheEachTime ? "off" : "on", lookups,
+                100.0 * static_cast<double>(hits) / static_cast<double>(lookups),
+                LuaStateCache::GetStatesCreated() - statesBefore, totalMs, totalMs / frames);
+        }
+    }
+
+    /**
+     * \brief Turning a scene file into a Lua function from source against the .luac cache,
+     *        and the whole RunFile including executing the chunk.
+     */
+    void BenchBytecode() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchBytecode");
+        const int runs = 5;
+        std::printf("bytecode: LuaBytecodeCache::RunFile into a fresh state, average of %d runs\n", runs);
+        std::printf("%8s %14s %14s %14s %14s %12s\n", "objects", "source load", ".luac load", "source run", ".luac run", "load saved");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            SceneFixtures::WriteScene(path, objectCount);
+            const std::string bytecodePath = LuaBytecodeCache::GetBytecodePath(path);
+
+            double sourceLoadMs = 0.0, bytecodeLoadMs = 0.0, sourceRunMs = 0.0, bytecodeRunMs = 0.0;
+            for (bool fromBytecode : { false, true }) {
+                for (int run = 0; run < runs; ++run) {
+                    std::error_code error;
+                    if (!fromBytecode) {
+                        std::filesystem::remove(bytecodePath, error);
+                    }
+                    std::shared_ptr<sol::state> lua = LuaStateCache::CreateState();
+                    const double runMs = SceneFixtures::TimeMilliseconds(1, [&] { LuaBytecodeCache::RunFile(*lua, path); });
+                    const LuaBytecodeCache::LoadStats& stats = LuaBytecodeCache::GetLastLoadStats();
+                    if (stats.fromBytecode != fromBytecode) {
+                        std::printf("%8d unexpected %s load\n", objectCount, stats.fromBytecode ? "bytecode" : "source");
+                    }
+                    (fromBytecode ? bytecodeLoadMs : sourceLoadMs) += stats.loadSeconds * 1000.0 / runs;
+                    (fromBytecode ? bytecodeRunMs : sourceRunMs) += runMs / runs;
+                }
+            }
+            std::printf("%8d %11.2f ms %11.2f ms %11.2f ms %11.2f ms %10.0f%%\n", objectCount, sourceLoadMs, bytecodeLoadMs,
+                sourceRunMs, bytecodeRunMs, 100.0 * (sourceLoadMs - bytecodeLoadMs) / sourceLoadMs);
+        }
+    }
+
+    /**
+     * \brief Restarting a scene: reading every object from the Lua file, from the cooked
+     *        file and from the in-memory snapshot, plus the time the capture takes.
+     */
+    void BenchRestart() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchRestart");
+        const int runs = 5;
+        std::printf("restart: object list and every value read, average of %d restarts\n", runs);
+        std::printf("%8s %12s %12s %12s %12s %12s\n", "objects", "lua file", "cooked file", "snapshot", "capture", "image size");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            SceneFixtures::WriteScene(path, objectCount);
+            const SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+            const std::string snapshotPath = "snapshot:" + path;
+
+            // The context is only taken to keep the scene cached for the call
+            auto restart = [&](const std::string& scenePath, std::unique_ptr<LuaSceneContext>) {
+                LuaManager luaManager(scenePath);
+                (void)luaManager.extractNamesWithParentIDs();
+                ReadScene(scenePath, dump, false);
+            };
+
+            std::error_code error;
+            std::filesystem::remove(CookedScene::GetCookedPath(path), error);
+            const double luaMs = SceneFixtures::TimeMilliseconds(runs, [&] {
+                LuaStateCache::GetInstance().Clear();
+                restart(path, std::make_unique<LuaSceneContext>(path));
+            });
+
+            CookedScene::Bake(path, CookedScene::GetCookedPath(path));
+            const double cookedMs = SceneFixtures::TimeMilliseconds(runs, [&] {
+                restart(path, std::make_unique<LuaSceneContext>(path));
+            });
+            std::filesystem::remove(CookedScene::GetCookedPath(path), error);
+
+            // The capture column is what WorldSnapshot::Capture pays: Serialize writes into a writer and the image build
+            const double captureMs = SceneFixtures::TimeMilliseconds(runs, [&] {
+                LuaSceneWriter writer(snapshotPath, "");
+                for (int id = 0; id < objectCount; ++id) {
+                    SceneFixtures::WriteObject(snapshotPath, id);
+                }
+                CookedScene captured;
+                captured.LoadFromMemory(writer.BuildCookedImage());
+            });
+            std::shared_ptr<const CookedScene> image = SceneFixtures::CaptureSnapshot(path, snapshotPath);
+            const double snapshotMs = SceneFixtures::TimeMilliseconds(runs, [&] {
+                restart(snapshotPath, std::make_unique<LuaSceneContext>(snapshotPath, image));
+            });
+
+            std::printf("%8d %9.2f ms %9.2f ms %9.2f ms %9.2f ms %9.1f KB\n", objectCount, luaMs, cookedMs, snapshotMs, captureMs,
+                image ? image->GetSizeBytes() / 1024.0 : 0.0);
+        }
+    }
+
+    /**
+     * \brief Finding the components of every object: one TableExists probe per component
+     *        type, as objects loaded before ComponentRegistry, against the registry lookup
+     *        of the tables the object has. Both run under a LuaSceneContext and a cooked file.
+     */
+    void BenchRegistry() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchRegistry");
+        const ComponentRegistry& registry = ComponentRegistry::GetInstance();
+        const int runs = 5;
+        std::printf("registry: finding the components of every object, average of %d loads\n", runs);
+        std::printf("%8s %10s %14s %14s %14s %14s\n", "objects", "found", "probe lua", "registry lua", "probe cooked", "registry cooked");
+        for (int objectCount : sceneSizes) {
+            const std::string path = directory + "Scene" + std::to_string(objectCount) + ".lua";
+            SceneFixtures::WriteScene(path, objectCount);
+
+            size_t found = 0;
+            auto probe = [&] {
+                LuaSceneContext context(path);
+                found = 0;
+                for (int id = 0; id < objectCount; ++id) {
+                    LuaManager luaManager(path);
+                    for (const ComponentRegistry::Entry& entry : registry.GetEntries()) {
+                        found += luaManager.TableExists(SceneFixtures::GetObjectTableName(id), entry.tableName) ? 1 : 0;
+                    }
+                }
+            };
+            auto lookUp = [&] {
+                LuaSceneContext context(path);
+                found = 0;
+                for (int id = 0; id < objectCount; ++id) {
+                    found += registry.GetEntriesFor(context.GetTableNames(SceneFixtures::GetObjectTableName(id))).size();
+                }
+            };
+
+            std::error_code error;
+            std::filesystem::remove(CookedScene::GetCookedPath(path), error);
+            LuaStateCache::GetInstance().Clear();
+            const double probeLuaMs = SceneFixtures::TimeMilliseconds(runs, [&] { LuaStateCache::GetInstance().Clear(); probe(); });
+            const double lookUpLuaMs = SceneFixtures::TimeMilliseconds(runs, [&] { LuaStateCache::GetInstance().Clear(); lookUp(); });
+
+            CookedScene::Bake(path, CookedScene::GetCookedPath(path));
+            const double probeCookedMs = SceneFixtures::TimeMilliseconds(runs, probe);
+            const double lookUpCookedMs = SceneFixtures::TimeMilliseconds(runs, lookUp);
+            std::filesystem::remove(CookedScene::GetCookedPath(path), error);
+
+            std::printf("%8d %10zu %11.2f ms %11.2f ms %11.2f ms %11.2f ms\n", objectCount, found, probeLuaMs, lookUpLuaMs, probeCookedMs, lookUpCookedMs);
+        }
+    }
+
+    /**
+     * \brief Startup asset I/O through the VirtualFileSystem: every file of a synthetic asset
+     *        tree read loose from disk and from the mounted pack, cold and warm. Cold runs
+     *        drop the files and the pack from the page cache first; the pack time includes
+     *        mounting it.
+     */
+    void BenchVfs() {
+        const std::string directory = SceneFixtures::MakeTempDirectory("BenchVfs");
+        VirtualFileSystem& vfs = VirtualFileSystem::GetInstance();
+        const int runs = 3;
+        std::printf("vfs: reading every file of an asset tree, 60%% 32 KB images and 40%% 8 KB Lua, average of %d starts\n", runs);
+        std::printf("%8s %10s %10s %12s %12s %12s %12s\n", "files", "loose", "pack", "loose cold", "pack cold", "loose warm", "pack warm");
+        for (int fileCount : { 200, 1000, 3000 }) {
+            const std::string root = directory + "Assets" + std::to_string(fileCount);
+            const std::string packPath = directory + "Assets" + std::to_string(fileCount) + AssetPack::Extension;
+            std::filesystem::create_directories(root + "/Textures");
+            std::filesystem::create_directories(root + "/Lua");
+
+            std::vector<std::string> paths;
+            std::mt19937 random(static_cast<unsigned>(fileCount));
+            for (int index = 0; index < fileCount; ++index) {
+                const bool image = index % 5 < 3;
+                paths.push_back(root + (image ? "/Textures/Image" : "/Lua/Script") + std::to_string(index) + (image ? ".png" : ".lua"));
+                std::string content;
+                if (image) {
+                    // Already compressed data does not shrink, so the pack stores it as is
+                    content.resize(32 * 1024);
+                    for (char& byte : content) {
+                        byte = static_cast<char>(random());
+                    }
+                }
+                else {
+                    while (content.size() < 8 * 1024) {
+                        content += "Object_" + std::to_string(content.size()) + " = { Transform = { positionX = 1.5, positionY = 2.5 } }\n";
+                    }
+                }
+                std::ofstream out(paths.back(), std::ios::binary | std::ios::trunc);
+                out.write(content.data(), static_cast<std::streamsize>(content.size()));
+            }
+            AssetPack::Build(root, packPath);
+
+            std::error_code error;
+            uintmax_t looseBytes = 0;
+            for (const std::string& path : paths) {
+                looseBytes += std::filesystem::file_size(path, error);
+            }
+            const uintmax_t packBytes = std::filesystem::file_size(packPath, error);
+
+            bool evicted = true;
+            volatile unsigned touched = 0;
+            auto start = [&](bool packed, bool cold) {
+                if (cold) {
+                    for (const std::string& path : paths) {
+                        evicted = EvictFromPageCache(path) && evicted;
+                    }
+                    evicted = EvictFromPageCache(packPath) && evicted;
+                }
+                return SceneFixtures::TimeMilliseconds(1, [&] {
+                    if (packed) {
+                        vfs.Mount(packPath);
+                    }
+                    for (const std::string& path : paths) {
+                        VirtualFile file = vfs.Open(path);
+                        if (!file.IsValid() || file.IsPacked() != packed) {
+                            std::printf("    %s was not read from the %s\n", path.c_str(), packed ? "pack" : "disk");
+                        }
+                        // Stored pack entries are only mapped, so touch every page like a decoder would
+                        for (size_t offset = 0; offset < file.GetSize(); offset += 4096) {
+                            touched += file.GetData()[offset];
+                        }
+                    }
+                    vfs.Unmount();
+                });
+            };
+            auto average = [&](bool packed, bool cold) {
+                double total = 0.0;
+                for (int run = 0; run < runs; ++run) {
+                    total += start(packed, cold);
+                }
+                return total / runs;
+            };
+
+            const double looseCold = average(false, true);
+            const double packCold = average(true, true);
+            const double looseWarm = average(false, false);
+            const double packWarm = average(true, false);
+            std::printf("%8d %7.1f MB %7.1f MB %9.2f ms %9.2f ms %9.2f ms %9.2f ms%s\n", fileCount, looseBytes / (1024.0 * 1024.0),
+                packBytes / (1024.0 * 1024.0), looseCold, packCold, looseWarm, packWarm, evicted ? "" : " (page cache not dropped)");
+        }
+    }
+
+    struct Benchmark {
+        const char* name;
+        std::function<void()> run;
+    };
+}
+
+int main(int argc, char** argv) {
+    const Benchmark benchmarks[] = {
+        { "load", BenchLoad },
+        { "cooked", BenchCooked },
+        { "save", BenchSave },
+        { "journal", BenchJournal },
+        { "cache", BenchStateCache },
+        { "bytecode", BenchBytecode },
+        { "restart", BenchRestart },
+        { "registry", BenchRegistry },
+        { "vfs", BenchVfs },
+    };
+
+    for (const Benchmark& benchmark : benchmarks) {
+        if (argc < 2 || std::strcmp(argv[1], benchmark.name) == 0) {
+            benchmark.run();
+        }
+    }
+    return 0;
+}
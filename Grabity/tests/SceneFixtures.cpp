@@ -0,0 +1,222 @@
+/*!****************************************************************
+\file: SceneFixtures.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Scene files and helpers shared by the scene tests and
+        SceneBench.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "SceneFixtures.h"
+#include "LuaConfig.h"
+#include "CookedScene.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace SceneFixtures {
+
+    /**
+     * \brief Creates an empty directory under the system temp directory.
+     * \param name The name of the directory.
+     * \return The path of the directory, with a trailing separator.
+     */
+    std::string MakeTempDirectory(const std::string& name) {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "GrabityTests" / name;
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        std::filesystem::create_directories(directory, error);
+        return directory.string() + "/";
+    }
+
+    /**
+     * \brief Retrieves the Lua table name of a synthetic object.
+     * \param id The object id.
+     * \return The table name, e.g. "Enemy_12".
+     */
+    std::string GetObjectTableName(int id) {
+        static const char* names[] = { "Player", "Enemy", "Platform", "Bullet" };
+        return std::string(names[id % 4]) + "_" + std::to_string(id);
+    }
+
+    /**
+     * \brief Writes one synthetic object through LuaManager::LuaWrite.
+     * \param luaFilePath The scene file.
+     * \param id The object id. Every fourth object is the child of the one before it.
+     * \param variant Changes every float value, so the same id can be written again with other data.
+     */
+    void WriteObject(const std::string& luaFilePath, int id, int variant) {
+        const std::string tableName = GetObjectTableName(id);
+        const std::string name = tableName.substr(0, tableName.find('_'));
+        const float base = static_cast<float>(id) * 1.37f + static_cast<float>(variant) * 0.1f;
+        const int parentID = id % 4 == 3 ? id - 1 : -1;
+
+        // Same tables and keys GameObjectFactory::WriteAllGameObjects and the component
+        // Serialize functions write, one LuaManager each like the engine opens them
+        LuaManager nameWriter(luaFilePath);
+        nameWriter.LuaWrite(tableName, { name, parentID, std::string("Default"), id % 5 }, { "name", "parentID", "tag", "layer" }, "Name");
+
+        LuaManager transformWriter(luaFilePath);
+        transformWriter.LuaWrite(tableName, { base * 10.0f, base * -3.3f, 1.0f + base / 100.0f, 1.25f, base / 7.0f },
+            { "positionX", "positionY", "scaleX", "scaleY", "rotation" }, "Transform");
+
+        LuaManager spriteWriter(luaFilePath);
+        spriteWriter.LuaWrite(tableName, { 4, 2, name + "Sheet", 2, false, id % 2 == 0 },
+            { "SpriteAnimationFrameX_0", "SpriteAnimationFrameY_0", "SpritePathName_0", "Spritelayer", "SpriteFlipX", "SpriteFlipY" }, "Sprite");
+
+        LuaManager bodyWriter(luaFilePath);
+        bodyWriter.LuaWrite(tableName, { 1.5f, base * 0.01f, -9.81f, 0.05f, 0.0f, base * 0.001f },
+            { "mass", "velocityX", "velocityY", "drag", "accelerationX", "accelerationY" }, "RigidBody");
+
+        LuaManager colliderWriter(luaFilePath);
+        colliderWriter.LuaWrite(tableName, { 1, false, 64.0f, 32.5f, 0.0f, base * 0.5f },
+            { "ColliderCount", "isTrigger", "CollisionSizeX_0", "CollisionSizeY_0", "CollisionCenterX_0", "CollisionCenterY_0" }, "Collider");
+
+        if (id % 4 == 1) {
+            LuaManager healthWriter(luaFilePath);
+            healthWriter.LuaWrite(tableName, { 100.0f - base, 100.0f }, { "health", "maxHealth" }, "Health");
+
+            LuaManager audioWriter(luaFilePath);
+            audioWriter.LuaWrite(tableName, { 3, 7 }, { "audioClip0", "audioClip1" }, "Audio");
+        }
+    }
+
+    /**
+     * \brief Writes a scene of synthetic objects through a LuaSceneWriter.
+     * \param luaFilePath The scene file.
+     * \param objectCount The number of objects.
+     */
+    void WriteScene(const std::string& luaFilePath, int objectCount) {
+        LuaSceneWriter sceneWriter(luaFilePath, "-- Lua Level file");
+        for (int id = 0; id < objectCount; ++id) {
+            WriteObject(luaFilePath, id);
+        }
+        sceneWriter.Commit();
+    }
+
+    /**
+     * \brief Writes a scene of synthetic objects the way saves worked before LuaSceneWriter.
+     * \param luaFilePath The scene file.
+     * \param objectCount The number of objects.
+     */
+    void WriteSceneWithoutWriter(const std::string& luaFilePath, int objectCount) {
+        // GameObject::Serialize creates the file with a comment line before writing to it
+        {
+            std::ofstream file(luaFilePath, std::ios::trunc);
+            file << "-- Lua Level file\n";
+        }
+        LuaStateCache::Invalidate(luaFilePath);
+        for (int id = 0; id < objectCount; ++id) {
+            WriteObject(luaFilePath, id);
+        }
+    }
+
+    /**
+     * \brief Executes a scene file in a fresh Lua state and lists every value in it.
+     * \param luaFilePath The scene file.
+     * \return The values of every object table, with numbers written with 17 digits.
+     */
+    SceneDump DumpScene(const std::string& luaFilePath) {
+        SceneDump dump;
+        sol::state lua;
+        lua.open_libraries(sol::lib::base);
+        try {
+            lua.safe_script_file(luaFilePath);
+        }
+        catch (const sol::error& e) {
+            std::printf("    could not run %s: %s\n", luaFilePath.c_str(), e.what());
+            return dump;
+        }
+
+        auto describe = [](const sol::object& value) -> std::string {
+            char buffer[64];
+            switch (value.get_type()) {
+            case sol::type::number:
+                std::snprintf(buffer, sizeof(buffer), "%.17g", value.as<double>());
+                return buffer;
+            case sol::type::string:
+                return "\"" + value.as<std::string>() + "\"";
+            case sol::type::boolean:
+                return value.as<bool>() ? "true" : "false";
+            default:
+                return "<" + std::string(sol::type_name(value.lua_state(), value.get_type())) + ">";
+            }
+        };
+
+        const std::unordered_set<std::string> ignoredGlobals = { "_G", "base", "package", "coroutine", "string", "table", "math", "io", "os", "debug", "utf8", "jit", "bit32" };
+        for (const auto& global : lua.globals()) {
+            if (!global.first.is<std::string>() || !global.second.is<sol::table>()) {
+                continue;
+            }
+            const std::string objectName = global.first.as<std::string>();
+            if (ignoredGlobals.count(objectName) > 0) {
+                continue;
+            }
+
+            auto& object = dump[objectName];
+            for (const auto& entry : global.second.as<sol::table>()) {
+                const std::string key = entry.first.as<std::string>();
+                if (entry.second.is<sol::table>()) {
+                    auto& subTable = object[key];
+                    for (const auto& field : entry.second.as<sol::table>()) {
+                        subTable[field.first.as<std::string>()] = describe(field.second);
+                    }
+                }
+                else {
+                    object[""][key] = describe(entry.second);
+                }
+            }
+        }
+        return dump;
+    }
+
+    /**
+     * \brief Captures a loaded scene the way WorldSnapshot::Capture does.
+     * \param luaFilePath The scene file.
+     * \param snapshotPath The path the image is served under.
+     * \return The image, empty if it could not be built.
+     */
+    std::shared_ptr<const CookedScene> CaptureSnapshot(const std::string& luaFilePath, const std::string& snapshotPath) {
+        const SceneDump dump = DumpScene(luaFilePath);
+        std::vector<unsigned char> bytes;
+        {
+            LuaSceneContext context(luaFilePath);
+            LuaSceneWriter writer(snapshotPath, "");
+            for (const auto& [objectName, subTables] : dump) {
+                for (const auto& [subTable, fields] : subTables) {
+                    if (subTable.empty()) {
+                        continue;
+                    }
+                    // Components keep numbers as float, which is also what they serialize
+                    LuaManager scene(luaFilePath);
+                    LuaManager::LuaValueContainer values;
+                    std::vector<std::string> keys;
+                    for (const auto& [key, text] : fields) {
+                        if (text.front() == '"') {
+                            values.push_back(scene.LuaRead<std::string>(objectName, { subTable, key }));
+                        }
+                        else if (text == "true" || text == "false") {
+                            values.push_back(scene.LuaRead<bool>(objectName, { subTable, key }));
+                        }
+                        else {
+                            values.push_back(scene.LuaRead<float>(objectName, { subTable, key }));
+                        }
+                        keys.push_back(key);
+                    }
+                    LuaManager snapshot(snapshotPath);
+                    snapshot.LuaWrite(objectName, values, keys, subTable);
+                }
+            }
+            bytes = writer.BuildCookedImage();
+        }
+
+        std::shared_ptr<CookedScene> image = std::make_shared<CookedScene>();
+        if (!image->LoadFromMemory(std::move(bytes))) {
+            return nullptr;
+        }
+        return image;
+    }
+}
@@ -0,0 +1,99 @@
+/*!****************************************************************
+\file: SceneFixtures.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Scene files and helpers shared by the scene tests and
+        SceneBench. Synthetic scenes are written through LuaManager
+        with the same tables and keys the component Serialize
+        functions write, so they exercise the same load and save
+        paths as the shipped scenes without needing the engine.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+
+class CookedScene;
+
+namespace SceneFixtures {
+
+    // Object table -> sub-table -> key -> value written as text
+    using SceneDump = std::map<std::string, std::map<std::string, std::map<std::string, std::string>>>;
+
+    /**
+     * \brief Creates an empty directory under the system temp directory.
+     * \param name The name of the directory.
+     * \return The path of the directory, with a trailing separator.
+     */
+    std::string MakeTempDirectory(const std::string& name);
+
+    /**
+     * \brief Retrieves the Lua table name of a synthetic object.
+     * \param id The object id.
+     * \return The table name, e.g. "Enemy_12".
+     */
+    std::string GetObjectTableName(int id);
+
+    /**
+     * \brief Writes one synthetic object through LuaManager::LuaWrite. While a LuaSceneWriter
+     *        is active for the path the writes go to it, otherwise each one edits the file.
+     * \param luaFilePath The scene file.
+     * \param id The object id. Every fourth object is the child of the one before it.
+     * \param variant Changes every float value, so the same id can be written again with other data.
+     */
+    void WriteObject(const std::string& luaFilePath, int id, int variant = 0);
+
+    /**
+     * \brief Writes a scene of synthetic objects through a LuaSceneWriter.
+     * \param luaFilePath The scene file.
+     * \param objectCount The number of objects.
+     */
+    void WriteScene(const std::string& luaFilePath, int objectCount);
+
+    /**
+     * \brief Writes a scene of synthetic objects the way saves worked before LuaSceneWriter,
+     *        one LuaManager and one file rewrite per table.
+     * \param luaFilePath The scene file.
+     * \param objectCount The number of objects.
+     */
+    void WriteSceneWithoutWriter(const std::string& luaFilePath, int objectCount);
+
+    /**
+     * \brief Executes a scene file in a fresh Lua state and lists every value in it.
+     * \param luaFilePath The scene file.
+     * \return The values of every object table, with numbers written with 17 digits.
+     */
+    SceneDump DumpScene(const std::string& luaFilePath);
+
+    /**
+     * \brief Captures a loaded scene the way WorldSnapshot::Capture does: every value is read
+     *        from the scene as a component Deserialize would and written back through a
+     *        LuaSceneWriter on the snapshot path, which builds the in-memory image.
+     * \param luaFilePath The scene file.
+     * \param snapshotPath The path the image is served under.
+     * \return The image, empty if it could not be built.
+     */
+    std::shared_ptr<const CookedScene> CaptureSnapshot(const std::string& luaFilePath, const std::string& snapshotPath);
+
+    /**
+     * \brief Measures the average time of a function over a number of runs.
+     * \param runs The number of runs.
+     * \param function The function to time.
+     * \return The average time in milliseconds.
+     */
+    template<typename Function>
+    double TimeMilliseconds(int runs, Function&& function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < runs; ++run) {
+            function();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / runs;
+    }
+}
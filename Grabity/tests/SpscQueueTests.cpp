@@ -0,0 +1,116 @@
+/*!****************************************************************
+\file: SpscQueueTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for SpscQueue: first in first out across the wrap of
+        the ring, a full queue rejecting pushes without losing what it
+        holds, and one producer and one consumer thread passing a long
+        sequence through a small queue without losing, repeating or
+        reordering an item. Build with -fsanitize=thread to have the
+        threaded test check the memory ordering as well.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SpscQueue.h"
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+    // Shaped like an AudioManager command, larger than a word so a torn copy would show
+    struct Command {
+        uint64_t sequence = 0;
+        uint64_t check = 0;
+        int type = 0;
+    };
+
+    Command MakeCommand(uint64_t sequence) {
+        return { sequence, sequence * 0x9E3779B97F4A7C15ull, static_cast<int>(sequence % 7) };
+    }
+}
+
+TEST_CASE(SpscQueue_PopsInPushOrderAcrossTheWrap) {
+    SpscQueue<int, 4> queue;
+    int item = -1;
+    CHECK(queue.Empty());
+    CHECK(!queue.TryPop(item));
+
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 10; ++round) {
+        CHECK(queue.TryPush(next++));
+        CHECK(queue.TryPush(next++));
+        CHECK(queue.TryPush(next++));
+        CHECK_EQ(queue.Size(), size_t(3));
+        for (int popped = 0; popped < 3; ++popped) {
+            CHECK(queue.TryPop(item));
+            CHECK_EQ(item, expected++);
+        }
+        CHECK(queue.Empty());
+    }
+}
+
+TEST_CASE(SpscQueue_FullQueueRejectsAndKeepsItsItems) {
+    SpscQueue<int, 8> queue;
+    for (int value = 0; value < 8; ++value) {
+        CHECK(queue.TryPush(value));
+    }
+    CHECK(!queue.TryPush(100));
+    CHECK_EQ(queue.Size(), queue.GetCapacity());
+
+    // One pop frees exactly one slot
+    int item = -1;
+    CHECK(queue.TryPop(item));
+    CHECK_EQ(item, 0);
+    CHECK(queue.TryPush(8));
+    CHECK(!queue.TryPush(9));
+
+    for (int expected = 1; expected <= 8; ++expected) {
+        CHECK(queue.TryPop(item));
+        CHECK_EQ(item, expected);
+    }
+    CHECK(!queue.TryPop(item));
+}
+
+TEST_CASE(SpscQueue_TwoThreadsPassEveryItemInOrder) {
+    constexpr uint64_t count = 1000000;
+    SpscQueue<Command, 64> queue;
+    uint64_t rejectedPushes = 0;
+
+    std::thread producer([&]() {
+        for (uint64_t sequence = 0; sequence < count; ) {
+            if (queue.TryPush(MakeCommand(sequence))) {
+                ++sequence;
+            }
+            else {
+                ++rejectedPushes;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t received = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t torn = 0;
+    Command command;
+    while (received < count) {
+        if (!queue.TryPop(command)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const Command expected = MakeCommand(received);
+        outOfOrder += command.sequence != received;
+        torn += command.check != expected.check || command.type != expected.type;
+        ++received;
+    }
+    producer.join();
+
+    CHECK_EQ(outOfOrder, uint64_t(0));
+    CHECK_EQ(torn, uint64_t(0));
+    CHECK(queue.Empty());
+    std::printf("    %llu items, the producer found the queue full %llu times\n",
+        static_cast<unsigned long long>(count), static_cast<unsigned long long>(rejectedPushes));
+}
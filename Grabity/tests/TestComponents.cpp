@@ -0,0 +1,81 @@
+/*!****************************************************************
+\file: TestComponents.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Stands in for BuiltInComponents.cpp in the standalone tests,
+        which cannot link the component classes. Registers the same
+        sub-tables and types in the same order; the create and reset
+        functions only record the tables they were called for.
+
+        Keep this list in step with BuiltInComponents.cpp.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestComponents.h"
+#include "ComponentRegistry.h"
+
+namespace TestComponents {
+
+    std::vector<std::string>& GetCreatedTables() {
+        static std::vector<std::string> created;
+        return created;
+    }
+
+    std::vector<std::string>& GetResetTables() {
+        static std::vector<std::string> reset;
+        return reset;
+    }
+}
+
+/**
+ * \brief Registers the engine's component tables with recording create and reset functions.
+ */
+void ComponentRegistry::RegisterBuiltInComponents() {
+    struct BuiltIn {
+        const char* tableName;
+        TypeOfComponent type;
+        bool hasReset;
+    };
+    const BuiltIn builtIns[] = {
+        { "Transform", TypeOfComponent::TRANSFORM, true },
+        { "Sprite", TypeOfComponent::SPRITE, false },
+        { "RigidBody", TypeOfComponent::RIGIDBODY, true },
+        { "Collider", TypeOfComponent::RECTCOLLIDER, false },
+        { "Audio", TypeOfComponent::AUDIO, false },
+        { "PlayerController", TypeOfComponent::PLAYER, false },
+        { "AIState", TypeOfComponent::AISTATE, false },
+        { "Text", TypeOfComponent::TEXT, true },
+        { "TextUI", TypeOfComponent::TEXT_UI, true },
+        { "Spawner", TypeOfComponent::SPAWNER, true },
+        { "Canvas", TypeOfComponent::CANVAS_UI, false },
+        { "SpriteUI", TypeOfComponent::SPRITE_UI, false },
+        { "ButtonComponent", TypeOfComponent::BUTTON, false },
+        { "UIComponent", TypeOfComponent::UI, false },
+        { "Health", TypeOfComponent::HEALTH, true },
+        { "Explosion", TypeOfComponent::EXPLOSION, true },
+        { "PauseMenuButton", TypeOfComponent::PAUSEMENUBUTTON, false },
+        { "Animator", TypeOfComponent::ANIMATOR, false },
+        { "SliderComponent", TypeOfComponent::SLIDER, false },
+        { "ParticleSystem", TypeOfComponent::PARTICLE, false },
+        { "Splitting", TypeOfComponent::SPLITTING, true },
+        { "Video", TypeOfComponent::VIDEO, false },
+        { "VfxFollowComponent", TypeOfComponent::VFX_FOLLOW, false },
+    };
+
+    for (const BuiltIn& builtIn : builtIns) {
+        const std::string tableName = builtIn.tableName;
+        LoadFunction reset;
+        if (builtIn.hasReset) {
+            reset = [tableName](GameObject*, const std::string&, const std::string&) {
+                TestComponents::GetResetTables().push_back(tableName);
+            };
+        }
+        Register(tableName, builtIn.type,
+            [tableName](GameObject*, const std::string&, const std::string&) {
+                TestComponents::GetCreatedTables().push_back(tableName);
+            },
+            std::move(reset));
+    }
+}
@@ -0,0 +1,29 @@
+/*!****************************************************************
+\file: TestComponents.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: What the stand-in component registrations of the standalone
+        tests were called for, see TestComponents.cpp.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <string>
+#include <vector>
+
+namespace TestComponents {
+
+    /**
+     * \brief Retrieves the sub-tables whose create function ran, in call order.
+     * \return The table names. Tests clear it before use.
+     */
+    std::vector<std::string>& GetCreatedTables();
+
+    /**
+     * \brief Retrieves the sub-tables whose reset function ran, in call order.
+     * \return The table names. Tests clear it before use.
+     */
+    std::vector<std::string>& GetResetTables();
+}
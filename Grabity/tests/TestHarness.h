@@ -0,0 +1,127 @@
+/*!****************************************************************
+\file: TestHarness.h
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: A minimal test runner for the engine's standalone tests.
+        TEST_CASE registers a function, CHECK and CHECK_EQ record a
+        failure with its file and line and let the test carry on.
+        RunAllTests runs every registered test, or only those whose
+        name contains the first command line argument, and returns
+        the process exit code ctest reads.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sstream>
+
+namespace TestHarness {
+
+    struct TestCase {
+        const char* name;
+        void (*function)();
+    };
+
+    /**
+     * \brief Retrieves every registered test, in registration order.
+     * \return Reference to the test list.
+     */
+    inline std::vector<TestCase>& GetTests() {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    /**
+     * \brief Retrieves the number of failed checks in the running test.
+     * \return Reference to the failure count.
+     */
+    inline int& GetFailures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    /**
+     * \brief Registers a test when its static instance is constructed.
+     */
+    struct Registrar {
+        Registrar(const char* name, void (*function)()) {
+            GetTests().push_back({ name, function });
+        }
+    };
+
+    /**
+     * \brief Records a failed check.
+     * \param file The source file of the check.
+     * \param line The line of the check.
+     * \param message What was checked.
+     */
+    inline void Fail(const char* file, int line, const std::string& message) {
+        ++GetFailures();
+        std::printf("    %s:%d: %s\n", file, line, message.c_str());
+    }
+
+    /**
+     * \brief Formats a value for a failed CHECK_EQ.
+     * \param value The value to format.
+     * \return The text of the value.
+     */
+    template<typename T>
+    std::string Describe(const T& value) {
+        std::ostringstream stream;
+        stream.precision(17);
+        stream << value;
+        return stream.str();
+    }
+
+    /**
+     * \brief Runs the registered tests.
+     * \param argc The argument count of main.
+     * \param argv The arguments of main. argv[1], if given, filters tests by name.
+     * \return 0 if every test passed, 1 otherwise.
+     */
+    inline int RunAllTests(int argc, char** argv) {
+        const std::string filter = argc > 1 ? argv[1] : "";
+        int failedTests = 0;
+        int ranTests = 0;
+        for (const TestCase& test : GetTests()) {
+            if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos) {
+                continue;
+            }
+
+            GetFailures() = 0;
+            test.function();
+            ++ranTests;
+            if (GetFailures() > 0) {
+                ++failedTests;
+                std::printf("[FAIL] %s\n", test.name);
+            }
+            else {
+                std::printf("[ ok ] %s\n", test.name);
+            }
+        }
+        std::printf("%d of %d tests passed\n", ranTests - failedTests, ranTests);
+        return failedTests == 0 && ranTests > 0 ? 0 : 1;
+    }
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static TestHarness::Registrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) { TestHarness::Fail(__FILE__, __LINE__, "CHECK(" #expression ")"); } } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const auto& checkActual = (actual); \
+        const auto& checkExpected = (expected); \
+        if (!(checkActual == checkExpected)) { \
+            TestHarness::Fail(__FILE__, __LINE__, "CHECK_EQ(" #actual ", " #expected "): " \
+                + TestHarness::Describe(checkActual) + " != " + TestHarness::Describe(checkExpected)); \
+        } \
+    } while (0)
@@ -0,0 +1,16 @@
+/*!****************************************************************
+\file: TestMain.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Entry point shared by the test executables. Runs every
+        TEST_CASE linked into the executable.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+
+int main(int argc, char** argv) {
+    return TestHarness::RunAllTests(argc, argv);
+}
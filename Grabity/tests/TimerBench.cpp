@@ -0,0 +1,188 @@
+/*!****************************************************************
+\file: TimerBench.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Measures the TimerService against the loop DespawnManager
+        used before it, which kept a vector of countdowns, took the
+        fixed step off every one each frame and erased the ones that
+        ran out. Both keep 10k timers pending at 60 ticks a second.
+        Each benchmark is selected by name on the command line, e.g.
+        "TimerBench spread"; without an argument every one runs.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TimerService.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr int pendingTimers = 10000;
+    constexpr int frames = 6000;            // 100 seconds at 60 ticks a second
+    constexpr double fixedStep = 1.0 / 60.0;
+
+    /**
+     * \brief The old DespawnManager: a countdown per timer, all updated every frame.
+     */
+    struct VectorTimers {
+        struct Entry {
+            uint64_t payload;
+            float timeRemaining;
+        };
+        std::vector<Entry> pending;
+
+        void Schedule(float delay, uint64_t payload) {
+            pending.push_back(Entry{ payload, delay });
+        }
+
+        template <typename Expire>
+        void Update(Expire&& expire) {
+            const float deltaTime = static_cast<float>(fixedStep);
+            auto it = pending.begin();
+            while (it != pending.end()) {
+                it->timeRemaining -= deltaTime;
+                if (it->timeRemaining <= 0.0f) {
+                    expire(it->payload);
+                    it = pending.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+    };
+
+    struct Result {
+        double microsecondsPerFrame = 0.0;
+        uint64_t expired = 0;
+    };
+
+    /**
+     * \brief Runs 100 seconds of frames on the wheel, rescheduling every timer that expires.
+     * \param delays Gives each new timer's delay in seconds.
+     * \return The time per frame.
+     */
+    template <typename Delay>
+    Result RunWheel(Delay&& delays) {
+        TimerService& timers = TimerService::GetInstance();
+        TimerService::ChannelID channel = timers.RegisterChannel("Bench", [&](const std::vector<uint64_t>& payloads) {
+            for (uint64_t payload : payloads) {
+                timers.Schedule(delays(), channel, payload);
+            }
+        });
+        for (int timer = 0; timer < pendingTimers; ++timer) {
+            timers.Schedule(delays(), channel, static_cast<uint64_t>(timer));
+        }
+        timers.ResetStats();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            timers.Advance(1);
+        }
+        const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        Result result{ elapsed / frames, timers.GetStats().expired };
+        timers.CancelChannel(channel);
+        return result;
+    }
+
+    /**
+     * \brief Runs 100 seconds of frames on the old vector loop, rescheduling every timer that expires.
+     * \param delays Gives each new timer's delay in seconds.
+     * \return The time per frame.
+     */
+    template <typename Delay>
+    Result RunVector(Delay&& delays) {
+        VectorTimers timers;
+        for (int timer = 0; timer < pendingTimers; ++timer) {
+            timers.Schedule(static_cast<float>(delays()), static_cast<uint64_t>(timer));
+        }
+
+        Result result;
+        std::vector<uint64_t> expired;
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            expired.clear();
+            timers.Update([&](uint64_t payload) { expired.push_back(payload); });
+            for (uint64_t payload : expired) {
+                timers.Schedule(static_cast<float>(delays()), payload);
+            }
+            result.expired += expired.size();
+        }
+        const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        result.microsecondsPerFrame = elapsed / frames;
+        return result;
+    }
+
+    void PrintHeader() {
+        std::printf("  %-12s %12s %10s\n", "timers", "us/frame", "expired");
+    }
+
+    void PrintRow(const char* name, const Result& result) {
+        std::printf("  %-12s %12.3f %10llu\n", name, result.microsecondsPerFrame, static_cast<unsigned long long>(result.expired));
+    }
+
+    /**
+     * \brief Delays spread evenly over 100 seconds, so about a hundred timers expire every frame
+     *        and far ones cascade down the levels.
+     */
+    void BenchSpread() {
+        std::printf("10k timers, delays spread over 100 s, rescheduled when they expire\n");
+        PrintHeader();
+        std::mt19937 wheelRandom(20241017);
+        std::mt19937 vectorRandom(20241017);
+        std::uniform_real_distribution<double> delays(fixedStep, 100.0);
+        PrintRow("wheel", RunWheel([&]() { return delays(wheelRandom); }));
+        PrintRow("vector loop", RunVector([&]() { return delays(vectorRandom); }));
+    }
+
+    /**
+     * \brief Short despawn-like delays of a few seconds, so timers stay in the lowest levels.
+     */
+    void BenchShort() {
+        std::printf("10k timers, delays of 0.5 to 3 s, rescheduled when they expire\n");
+        PrintHeader();
+        std::mt19937 wheelRandom(7);
+        std::mt19937 vectorRandom(7);
+        std::uniform_real_distribution<double> delays(0.5, 3.0);
+        PrintRow("wheel", RunWheel([&]() { return delays(wheelRandom); }));
+        PrintRow("vector loop", RunVector([&]() { return delays(vectorRandom); }));
+    }
+
+    /**
+     * \brief Delays past the end of the run, so nothing expires and only the per-frame cost is left.
+     */
+    void BenchIdle() {
+        std::printf("10k timers, none expiring within the run\n");
+        PrintHeader();
+        PrintRow("wheel", RunWheel([]() { return 3600.0; }));
+        PrintRow("vector loop", RunVector([]() { return 3600.0; }));
+    }
+
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+}
+
+int main(int argc, char** argv) {
+    const Benchmark benchmarks[] = {
+        { "spread", BenchSpread },
+        { "short", BenchShort },
+        { "idle", BenchIdle },
+    };
+
+    std::printf("%d frames at 60 ticks a second\n\n", frames);
+    for (const Benchmark& benchmark : benchmarks) {
+        if (argc < 2 || std::strcmp(argv[1], benchmark.name) == 0) {
+            benchmark.run();
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+/*!****************************************************************
+\file: TimerServiceTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for the TimerService timing wheel: timers on either
+        side of every level boundary expire on their exact tick after
+        being cascaded down, timers due together expire in the order
+        they were scheduled whatever level they started on, callbacks
+        can schedule and cancel, and random schedules, cancels and
+        advances match a plain reference model tick for tick.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "TimerService.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using Expiry = std::pair<uint64_t, uint64_t>;   // Tick and payload
+
+    /**
+     * \brief A channel that logs the tick and payload of every timer it is handed.
+     */
+    struct LoggedChannel {
+        std::vector<Expiry> log;
+        TimerService::ChannelID channel;
+
+        LoggedChannel() {
+            channel = TimerService::GetInstance().RegisterChannel("Test", [this](const std::vector<uint64_t>& payloads) {
+                for (uint64_t payload : payloads) {
+                    log.push_back({ TimerService::GetInstance().GetTick(), payload });
+                }
+            });
+        }
+
+        // Stops the callback touching this channel's log once the test is over
+        ~LoggedChannel() { TimerService::GetInstance().CancelChannel(channel); }
+    };
+
+    // Delays just under, on and just over the span of each level, for a timer scheduled now
+    std::vector<uint64_t> BoundaryDelays() {
+        std::vector<uint64_t> delays;
+        for (uint64_t span : { uint64_t(1) << 8, uint64_t(1) << 16, uint64_t(1) << 24 }) {
+            for (uint64_t offset : { span - 1, span, span + 1 }) {
+                delays.push_back(offset);
+            }
+        }
+        return delays;
+    }
+}
+
+TEST_CASE(TimerService_CascadesOntoTheExactTick) {
+    TimerService& timers = TimerService::GetInstance();
+    LoggedChannel logged;
+
+    // From the start of a level 0 turn and from the middle of one, so cascades fall at different offsets
+    for (uint64_t misalign : { uint64_t(0), uint64_t(200) }) {
+        const uint64_t toTurn = (256 - timers.GetTick() % 256) % 256;
+        timers.Advance(static_cast<int>(toTurn + misalign));
+        logged.log.clear();
+
+        const uint64_t start = timers.GetTick();
+        std::vector<Expiry> expected;
+        for (uint64_t delay : BoundaryDelays()) {
+            timers.ScheduleTicks(delay, logged.channel, delay);
+            expected.push_back({ start + delay, delay });
+        }
+        std::sort(expected.begin(), expected.end());
+
+        timers.Advance(static_cast<int>((uint64_t(1) << 24) + 2));
+        CHECK(logged.log == expected);
+    }
+    CHECK_EQ(timers.GetStats().pending, size_t(0));
+}
+
+TEST_CASE(TimerService_TimersDueTogetherKeepTheirOrder) {
+    TimerService& timers = TimerService::GetInstance();
+    LoggedChannel logged;
+
+    // Each timer is scheduled later and closer to the same tick, so it starts a level lower or in
+    // the same level as the one before, and the early ones reach level 0 by cascading into a slot
+    // the later ones went into directly
+    const uint64_t due = timers.GetTick() + 70000;
+    uint64_t payload = 0;
+    for (uint64_t remaining : { uint64_t(70000), uint64_t(69000), uint64_t(60000), uint64_t(5000), uint64_t(300),
+        uint64_t(256), uint64_t(255), uint64_t(100), uint64_t(1) }) {
+        timers.Advance(static_cast<int>(due - remaining - timers.GetTick()));
+        timers.ScheduleTicks(remaining, logged.channel, payload++);
+        timers.ScheduleTicks(remaining, logged.channel, payload++);
+    }
+    timers.Advance(1);
+
+    CHECK_EQ(logged.log.size(), size_t(payload));
+    bool inOrder = true;
+    for (size_t index = 0; index < logged.log.size(); ++index) {
+        inOrder = inOrder && logged.log[index].first == due && logged.log[index].second == index;
+    }
+    CHECK(inOrder);
+}
+
+TEST_CASE(TimerService_CallbacksCanScheduleAndCancel) {
+    TimerService& timers = TimerService::GetInstance();
+    LoggedChannel logged;
+
+    // Due on the same tick as the action, so it has already expired when the action cancels it
+    TimerService::Handle sameTick = timers.ScheduleTicks(10, logged.channel, 1);
+    TimerService::Handle later = timers.ScheduleTicks(20, logged.channel, 2);
+    bool cancelledSameTick = true;
+    bool cancelledLater = false;
+    timers.Schedule(10 * timers.GetTickLength(), [&]() {
+        cancelledSameTick = timers.Cancel(sameTick);
+        cancelledLater = timers.Cancel(later);
+        timers.ScheduleTicks(1, logged.channel, 3);
+        timers.ScheduleTicks(300, logged.channel, 4);
+    });
+
+    const uint64_t start = timers.GetTick();
+    timers.Advance(400);
+    CHECK(!cancelledSameTick);
+    CHECK(cancelledLater);
+    const std::vector<Expiry> expected{ { start + 10, 1 }, { start + 11, 3 }, { start + 310, 4 } };
+    CHECK(logged.log == expected);
+    CHECK(!timers.IsPending(later));
+    CHECK_EQ(timers.GetStats().pending, size_t(0));
+}
+
+TEST_CASE(TimerService_MatchesReferenceModel) {
+    TimerService& timers = TimerService::GetInstance();
+    LoggedChannel logged;
+    std::mt19937_64 random(20241017);
+
+    // The model: what every pending timer is due on, by the order it was scheduled in
+    struct Pending {
+        TimerService::Handle handle;
+        uint64_t due;
+    };
+    std::map<uint64_t, Pending> model;
+    uint64_t nextPayload = 0;
+    const std::vector<uint64_t> boundaries = BoundaryDelays();
+
+    int wrong = 0;
+    for (int round = 0; round < 4000; ++round) {
+        const int scheduleCount = static_cast<int>(random() % 8);
+        for (int count = 0; count < scheduleCount; ++count) {
+            uint64_t delay = 1 + random() % 600;
+            switch (random() % 8) {
+            case 0: delay = boundaries[random() % 6]; break;    // Around the level 1 and 2 boundaries
+            case 1: delay = 256 + random() % 70000; break;
+            case 2: delay = 1 + random() % 256; break;
+            default: break;
+            }
+            const uint64_t payload = nextPayload++;
+            model[payload] = Pending{ timers.ScheduleTicks(delay, logged.channel, payload), timers.GetTick() + delay };
+        }
+
+        if (!model.empty() && random() % 3 == 0) {
+            auto it = model.begin();
+            std::advance(it, static_cast<long>(random() % model.size()));
+            wrong += !timers.Cancel(it->second.handle);
+            wrong += timers.IsPending(it->second.handle);
+            model.erase(it);
+        }
+
+        // Mostly a few frames' worth, sometimes far enough to pass a level 1 or level 2 turn
+        const uint64_t pick = random() % 100;
+        const uint64_t ticks = pick < 90 ? random() % 8 : pick < 99 ? random() % 2000 : random() % 80000;
+        const uint64_t from = timers.GetTick();
+        const uint64_t to = from + ticks;
+
+        std::vector<std::pair<uint64_t, uint64_t>> expected;
+        for (auto it = model.begin(); it != model.end(); ) {
+            if (it->second.due <= to) {
+                expected.push_back({ it->second.due, it->first });
+                it = model.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        // By tick, then by the order they were scheduled in, which payloads count
+        std::sort(expected.begin(), expected.end());
+
+        logged.log.clear();
+        timers.Advance(static_cast<int>(ticks));
+        wrong += logged.log != expected;
+        wrong += timers.GetStats().pending != model.size();
+
+        // Every timer still pending knows how long it has left
+        for (const auto& [payload, pending] : model) {
+            const uint64_t remaining = static_cast<uint64_t>(timers.GetRemaining(pending.handle) / timers.GetTickLength() + 0.5);
+            wrong += !timers.IsPending(pending.handle) || remaining != pending.due - to;
+        }
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK(timers.GetStats().cascaded > 0);
+
+    for (auto& [payload, pending] : model) {
+        timers.Cancel(pending.handle);
+    }
+    CHECK_EQ(timers.GetStats().pending, size_t(0));
+}
@@ -0,0 +1,237 @@
+/*!****************************************************************
+\file: VoiceManagerTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Tests for VoiceManager driving the null audio backend the way
+        AudioManager does: stolen voices are stopped, admitted voices
+        are played, and voices that go virtual are muted. Checks the
+        retrigger cooldown, every steal policy and virtualisation
+        against what the mixer actually plays.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "AudioFixtures.h"
+#include "VoiceManager.h"
+#include "SoftwareAudioBackend.h"
+#include <memory>
+#include <unordered_map>
+
+namespace {
+
+    /**
+     * \brief A VoiceManager applied to the null backend, as AudioManager::AdmitVoice,
+     *        TrackVoice and UpdateVoices apply it to the game's backend.
+     */
+    struct VoiceRig {
+        std::unique_ptr<AudioBackend> backend = AudioBackend::Create("null", "");
+        VoiceManager voices;
+        AudioBackend::SoundID sound = 0;
+        std::unordered_map<VoiceManager::VoiceHandle, AudioBackend::ChannelID> channels;
+
+        VoiceRig() {
+            backend->Init(64);
+            const std::vector<unsigned char> wav = AudioFixtures::MakeToneWav(AudioFixtures::SampleRate);
+            sound = backend->CreateSound(wav.data(), wav.size(), true, AudioBackend::LoadMode::DECOMPRESSED);
+        }
+
+        ~VoiceRig() {
+            backend->Release();
+        }
+
+        SoftwareAudioBackend& GetMixer() {
+            return static_cast<SoftwareAudioBackend&>(*backend);
+        }
+
+        // Requests a voice, stops what it steals and plays it. Returns InvalidVoice if dropped
+        VoiceManager::VoiceHandle Play(int soundID, int priority, float audibility) {
+            VoiceManager::Admission admission = voices.Request(soundID, priority, audibility);
+            for (VoiceManager::VoiceHandle stolen : admission.stolen) {
+                backend->Stop(channels[stolen]);
+                channels.erase(stolen);
+            }
+            if (admission.voice != VoiceManager::InvalidVoice) {
+                const AudioBackend::ChannelID channel = backend->Play(sound, false);
+                backend->SetVolume(channel, audibility);
+                channels[admission.voice] = channel;
+            }
+            return admission.voice;
+        }
+
+        // Moves the voice clock and mutes or unmutes the voices that changed
+        void Update(double seconds) {
+            voices.Advance(seconds);
+            std::vector<VoiceManager::VoiceHandle> becameReal;
+            std::vector<VoiceManager::VoiceHandle> becameVirtual;
+            voices.UpdateVirtualisation(becameReal, becameVirtual);
+            for (VoiceManager::VoiceHandle voice : becameVirtual) {
+                backend->SetMute(channels[voice], true);
+            }
+            for (VoiceManager::VoiceHandle voice : becameReal) {
+                backend->SetMute(channels[voice], false);
+            }
+        }
+
+        bool IsPlaying(VoiceManager::VoiceHandle voice) {
+            auto it = channels.find(voice);
+            return it != channels.end() && backend->IsPlaying(it->second);
+        }
+
+        // Channel frames the mixer resampled and mixed for one block, which skips muted channels
+        uint64_t MixBlock(size_t frames) {
+            const uint64_t before = GetMixer().GetMixStats().channelFrames;
+            GetMixer().Render(frames);
+            return GetMixer().GetMixStats().channelFrames - before;
+        }
+    };
+
+    /**
+     * \brief Fills sound 1's limit of two instances, then requests a third.
+     * \param rig The rig to play on.
+     * \param policy The steal policy.
+     * \param first The priority and audibility of the first voice.
+     * \param second The priority and audibility of the second voice.
+     * \param firstVoice Receives the first voice.
+     * \param secondVoice Receives the second voice.
+     * \param thirdVoice Receives the third voice, InvalidVoice if it was rejected.
+     */
+    void RequestPastTheLimit(VoiceRig& rig, VoiceManager::StealPolicy policy, std::pair<int, float> first, std::pair<int, float> second,
+        VoiceManager::VoiceHandle& firstVoice, VoiceManager::VoiceHandle& secondVoice, VoiceManager::VoiceHandle& thirdVoice) {
+        VoiceManager::Limits limits;
+        limits.maxInstances = 2;
+        limits.steal = policy;
+        rig.voices.SetLimits(1, limits);
+
+        firstVoice = rig.Play(1, first.first, first.second);
+        rig.Update(0.01);
+        secondVoice = rig.Play(1, second.first, second.second);
+        rig.Update(0.01);
+        thirdVoice = rig.Play(1, 128, 0.5f);
+    }
+}
+
+TEST_CASE(VoiceManager_CooldownSuppressesRetriggers) {
+    VoiceRig rig;
+    VoiceManager::Limits limits;
+    limits.cooldown = 0.1;
+    rig.voices.SetLimits(1, limits);
+
+    // A crowd hit on one frame starts a single voice
+    CHECK(rig.Play(1, 128, 1.0f) != VoiceManager::InvalidVoice);
+    CHECK(rig.Play(1, 128, 1.0f) == VoiceManager::InvalidVoice);
+    CHECK(rig.Play(1, 128, 1.0f) == VoiceManager::InvalidVoice);
+    CHECK_EQ(rig.backend->GetChannelsPlaying(), 1);
+
+    rig.Update(0.05);
+    CHECK(rig.Play(1, 128, 1.0f) == VoiceManager::InvalidVoice);
+
+    // Other sounds are not held back by it
+    CHECK(rig.Play(2, 128, 1.0f) != VoiceManager::InvalidVoice);
+
+    rig.Update(0.05);
+    CHECK(rig.Play(1, 128, 1.0f) != VoiceManager::InvalidVoice);
+    CHECK_EQ(rig.backend->GetChannelsPlaying(), 3);
+
+    const VoiceManager::Stats stats = rig.voices.GetStats();
+    CHECK_EQ(stats.requested, uint64_t(6));
+    CHECK_EQ(stats.started, uint64_t(3));
+    CHECK_EQ(stats.suppressed, uint64_t(3));
+}
+
+TEST_CASE(VoiceManager_RejectNewKeepsThePlayingVoices) {
+    VoiceRig rig;
+    VoiceManager::VoiceHandle first, second, third;
+    RequestPastTheLimit(rig, VoiceManager::StealPolicy::REJECT_NEW, { 128, 1.0f }, { 128, 1.0f }, first, second, third);
+    CHECK(third == VoiceManager::InvalidVoice);
+    CHECK(rig.IsPlaying(first));
+    CHECK(rig.IsPlaying(second));
+    CHECK_EQ(rig.backend->GetChannelsPlaying(), 2);
+    CHECK_EQ(rig.voices.GetStats().rejected, uint64_t(1));
+}
+
+TEST_CASE(VoiceManager_StealOldestStopsTheFirstVoice) {
+    VoiceRig rig;
+    VoiceManager::VoiceHandle first, second, third;
+    RequestPastTheLimit(rig, VoiceManager::StealPolicy::STEAL_OLDEST, { 128, 0.1f }, { 128, 1.0f }, first, second, third);
+    CHECK(third != VoiceManager::InvalidVoice);
+    CHECK(!rig.IsPlaying(first));
+    CHECK(rig.IsPlaying(second));
+    CHECK(rig.IsPlaying(third));
+    CHECK_EQ(rig.backend->GetChannelsPlaying(), 2);
+    CHECK_EQ(rig.voices.GetStats().stolen, uint64_t(1));
+}
+
+TEST_CASE(VoiceManager_StealQuietestStopsTheLeastAudibleVoice) {
+    VoiceRig rig;
+    VoiceManager::VoiceHandle first, second, third;
+    RequestPastTheLimit(rig, VoiceManager::StealPolicy::STEAL_QUIETEST, { 128, 0.9f }, { 128, 0.2f }, first, second, third);
+    CHECK(rig.IsPlaying(first));
+    CHECK(!rig.IsPlaying(second));
+    CHECK(rig.IsPlaying(third));
+    CHECK_EQ(rig.backend->GetChannelsPlaying(), 2);
+}
+
+TEST_CASE(VoiceManager_StealLowestPriorityStopsTheLeastImportantVoice) {
+    VoiceRig rig;
+    VoiceManager::VoiceHandle first, second, third;
+    // 0 is the most important, like FMOD channel priorities
+    RequestPastTheLimit(rig, VoiceManager::StealPolicy::STEAL_LOWEST_PRIORITY, { 200, 1.0f }, { 10, 0.1f }, first, second, third);
+    CHECK(!rig.IsPlaying(first));
+    CHECK(rig.IsPlaying(second));
+    CHECK(rig.IsPlaying(third));
+
+    // Ties go to the oldest
+    VoiceRig tied;
+    RequestPastTheLimit(tied, VoiceManager::StealPolicy::STEAL_LOWEST_PRIORITY, { 50, 1.0f }, { 50, 1.0f }, first, second, third);
+    CHECK(!tied.IsPlaying(first));
+    CHECK(tied.IsPlaying(second));
+}
+
+TEST_CASE(VoiceManager_VirtualVoicesAreNotMixedButKeepTheirPlace) {
+    VoiceRig rig;
+    rig.voices.SetMaxRealVoices(2);
+    const float audibilities[] = { 1.0f, 0.8f, 0.6f, 0.4f };
+    std::vector<VoiceManager::VoiceHandle> voices;
+    for (int sound = 0; sound < 4; ++sound) {
+        voices.push_back(rig.Play(sound, 128, audibilities[sound]));
+    }
+    rig.Update(0.0);
+
+    CHECK(!rig.voices.IsVirtual(voices[0]));
+    CHECK(!rig.voices.IsVirtual(voices[1]));
+    CHECK(rig.voices.IsVirtual(voices[2]));
+    CHECK(rig.voices.IsVirtual(voices[3]));
+    CHECK_EQ(rig.voices.GetStats().real, 2);
+    CHECK_EQ(rig.voices.GetStats().virtualVoices, 2);
+
+    // Only the real voices are mixed, every voice keeps playing in time
+    const size_t block = AudioFixtures::SampleRate / 10;
+    CHECK_EQ(rig.MixBlock(block), uint64_t(2 * block));
+    CHECK_EQ(rig.backend->GetChannelsPlaying(), 4);
+    for (VoiceManager::VoiceHandle voice : voices) {
+        CHECK_EQ(rig.backend->GetPosition(rig.channels[voice]), 100u);
+    }
+
+    // The quietest voice gets louder and takes a real voice from the next quietest
+    rig.voices.SetAudibility(voices[3], 0.9f);
+    rig.backend->SetVolume(rig.channels[voices[3]], 0.9f);
+    rig.Update(0.1);
+    CHECK(!rig.voices.IsVirtual(voices[3]));
+    CHECK(rig.voices.IsVirtual(voices[1]));
+    CHECK_EQ(rig.MixBlock(block), uint64_t(2 * block));
+    CHECK_EQ(rig.backend->GetPosition(rig.channels[voices[3]]), 200u);
+    CHECK_EQ(rig.voices.GetStats().virtualised, uint64_t(3));
+}
+
+TEST_CASE(VoiceManager_SilentVoicesStayVirtual) {
+    VoiceRig rig;
+    rig.voices.SetMaxRealVoices(8);
+    const VoiceManager::VoiceHandle heard = rig.Play(1, 128, 1.0f);
+    const VoiceManager::VoiceHandle silent = rig.Play(2, 0, 0.0f);
+    rig.Update(0.0);
+    CHECK(!rig.voices.IsVirtual(heard));
+    CHECK(rig.voices.IsVirtual(silent));
+    CHECK_EQ(rig.MixBlock(480), uint64_t(480));
+}
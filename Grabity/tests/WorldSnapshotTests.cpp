@@ -0,0 +1,107 @@
+/*!****************************************************************
+\file: WorldSnapshotTests.cpp
+\author: Goh Jun Jie, g.junjie, 2301293
+\brief: Restoring a scene from its in-memory snapshot must read back
+        exactly what a fresh load of the scene file reads: the same
+        objects, parents, tables and values, bit for bit. The
+        snapshot is captured like WorldSnapshot::Capture does, by
+        writing the loaded values back through a LuaSceneWriter.
+
+Copyright (C) 2024 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents
+without the prior written consent of DigiPen Institute of
+Technology is prohibited.
+*******************************************************************!*/
+#include "TestHarness.h"
+#include "SceneFixtures.h"
+#include "CookedScene.h"
+#include "LuaConfig.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    uint32_t GetBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    /**
+     * \brief Compares a fresh load of a scene against a restore from its snapshot.
+     * \param path The scene file.
+     * \return The number of values that differ.
+     */
+    size_t CountRestoreDifferences(const std::string& path) {
+        const SceneFixtures::SceneDump dump = SceneFixtures::DumpScene(path);
+        const std::string snapshotPath = "snapshot:" + path;
+        std::shared_ptr<const CookedScene> image = SceneFixtures::CaptureSnapshot(path, snapshotPath);
+        CHECK(image != nullptr);
+        if (!image) {
+            return dump.size();
+        }
+
+        LuaStateCache::GetInstance().Clear();
+        LuaSceneContext freshContext(path);
+        LuaSceneContext restoredContext(snapshotPath, image);
+        LuaManager fresh(path);
+        LuaManager restored(snapshotPath);
+
+        size_t differences = 0;
+        if (fresh.extractNamesWithParentIDs() != restored.extractNamesWithParentIDs()) {
+            std::printf("    object ids, names or parents differ\n");
+            ++differences;
+        }
+        for (const auto& [objectName, subTables] : dump) {
+            std::vector<std::string> freshTables = freshContext.GetTableNames(objectName);
+            std::vector<std::string> restoredTables = restoredContext.GetTableNames(objectName);
+            std::sort(freshTables.begin(), freshTables.end());
+            std::sort(restoredTables.begin(), restoredTables.end());
+            if (freshTables != restoredTables) {
+                std::printf("    %s has other tables after the restore\n", objectName.c_str());
+                ++differences;
+            }
+
+            for (const auto& [subTable, fields] : subTables) {
+                for (const auto& [key, text] : fields) {
+                    bool same = true;
+                    if (text.front() == '"') {
+                        same = fresh.LuaRead<std::string>(objectName, { subTable, key }) == restored.LuaRead<std::string>(objectName, { subTable, key });
+                    }
+                    else if (text == "true" || text == "false") {
+                        same = fresh.LuaRead<bool>(objectName, { subTable, key }) == restored.LuaRead<bool>(objectName, { subTable, key });
+                    }
+                    else {
+                        same = GetBits(fresh.LuaRead<float>(objectName, { subTable, key })) == GetBits(restored.LuaRead<float>(objectName, { subTable, key }));
+                        // Ids, layers and clip indices are read as int, and are always whole numbers
+                        if (text.find_first_of(".eEn") == std::string::npos) {
+                            same = same && fresh.LuaRead<int>(objectName, { subTable, key }) == restored.LuaRead<int>(objectName, { subTable, key });
+                        }
+                    }
+                    if (!same) {
+                        if (differences < 5) {
+                            std::printf("    %s.%s.%s differs after the restore\n", objectName.c_str(), subTable.c_str(), key.c_str());
+                        }
+                        ++differences;
+                    }
+                }
+            }
+        }
+        return differences;
+    }
+}
+
+TEST_CASE(WorldSnapshot_RestoreReadsLikeAFreshLoad) {
+    const std::string path = SceneFixtures::MakeTempDirectory("SnapshotRestore") + "Scene.lua";
+    SceneFixtures::WriteScene(path, 200);
+    CHECK_EQ(CountRestoreDifferences(path), size_t(0));
+}
+
+TEST_CASE(WorldSnapshot_RestoreReadsLikeAFreshLoadOfAnEditedScene) {
+    // Values written by the old per-table LuaWrite path and then edited in place
+    const std::string path = SceneFixtures::MakeTempDirectory("SnapshotRestoreEdited") + "Scene.lua";
+    SceneFixtures::WriteSceneWithoutWriter(path, 12);
+    LuaManager editor(path);
+    editor.LuaWrite(SceneFixtures::GetObjectTableName(11), { 0.1f, -0.0f, 1e-40f, 123456.789f }, { "positionX", "positionY", "scaleX", "rotation" }, "Transform");
+    CHECK_EQ(CountRestoreDifferences(path), size_t(0));
+}